@@ -0,0 +1,174 @@
+/**
+ * @file eer_crc.h
+ * @brief CRC algorithms shared by protocols and storage
+ *
+ * Each algorithm comes as a byte update, for interrupt handlers computing
+ * the CRC as bytes stream by, and a block update. Both return the finished
+ * CRC of the bytes seen so far; passing it back in continues the
+ * computation, so a message split over any number of calls gives the same
+ * result as one call. Start from the algorithm's EER_CRC*_INIT value:
+ *
+ *     uint16_t crc = EER_CRC16_MODBUS_INIT;
+ *     crc = eer_crc16_modbus(crc, header, sizeof(header));
+ *     crc = eer_crc16_modbus_update(crc, byte);
+ *
+ * The implementation is picked per build, trading flash for speed:
+ *   - EER_CRC_BITWISE: a shift loop, 8 iterations per byte, no table
+ *   - EER_CRC_NIBBLE: two lookups per byte in a 16-entry table
+ *   - EER_CRC_TABLE: one lookup per byte in a 256-entry table
+ * EER_CRC_METHOD sets all widths; EER_CRC8_METHOD, EER_CRC16_METHOD and
+ * EER_CRC32_METHOD override it per width. Tables are in flash (PROGMEM) on
+ * AVR and only those of the selected method are linked.
+ */
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @brief Implementations of the CRC algorithms
+ */
+#define EER_CRC_BITWISE 1
+#define EER_CRC_NIBBLE  2
+#define EER_CRC_TABLE   3
+
+/**
+ * @brief Implementation of every width without its own setting
+ */
+#ifndef EER_CRC_METHOD
+#define EER_CRC_METHOD EER_CRC_NIBBLE
+#endif
+
+/**
+ * @brief Implementation of the 8-bit CRCs
+ */
+#ifndef EER_CRC8_METHOD
+#define EER_CRC8_METHOD EER_CRC_METHOD
+#endif
+
+/**
+ * @brief Implementation of the 16-bit CRCs
+ */
+#ifndef EER_CRC16_METHOD
+#define EER_CRC16_METHOD EER_CRC_METHOD
+#endif
+
+/**
+ * @brief Implementation of the 32-bit CRC
+ */
+#ifndef EER_CRC32_METHOD
+#define EER_CRC32_METHOD EER_CRC_METHOD
+#endif
+
+/**
+ * @brief Start values, the CRC of no bytes
+ */
+#define EER_CRC8_DALLAS_INIT   0x00
+#define EER_CRC8_SMBUS_INIT    0x00
+#define EER_CRC16_CCITT_INIT   0xFFFF
+#define EER_CRC16_MODBUS_INIT  0xFFFF
+#define EER_CRC32_INIT         0x00000000UL
+
+/**
+ * @brief CRC-8/MAXIM of 1-Wire devices (DS18B20 scratchpad and ROM code)
+ *
+ * Polynomial 0x31 reflected, initial value 0. Over a block that ends with
+ * its own CRC the result is 0.
+ *
+ * @param crc CRC of the previous bytes
+ * @param data Next byte
+ * @return CRC including the byte
+ */
+uint8_t eer_crc8_dallas_update(uint8_t crc, uint8_t data);
+
+/**
+ * @brief CRC-8/MAXIM of a block, see eer_crc8_dallas_update()
+ * @param crc CRC of the previous bytes
+ * @param data Pointer to data
+ * @param size Size of data
+ * @return CRC including the block
+ */
+uint8_t eer_crc8_dallas(uint8_t crc, const void* data, uint16_t size);
+
+/**
+ * @brief CRC-8/SMBUS, the packet error code of SMBus and Sensirion sensors
+ *
+ * Polynomial 0x07, initial value 0. Sensirion SHT sensors differ: they
+ * use polynomial 0x31 from 0xFF, not reflected.
+ *
+ * @param crc CRC of the previous bytes
+ * @param data Next byte
+ * @return CRC including the byte
+ */
+uint8_t eer_crc8_smbus_update(uint8_t crc, uint8_t data);
+
+/**
+ * @brief CRC-8/SMBUS of a block, see eer_crc8_smbus_update()
+ * @param crc CRC of the previous bytes
+ * @param data Pointer to data
+ * @param size Size of data
+ * @return CRC including the block
+ */
+uint8_t eer_crc8_smbus(uint8_t crc, const void* data, uint16_t size);
+
+/**
+ * @brief CRC-16/CCITT-FALSE, the record CRC of the key-value store
+ *
+ * Polynomial 0x1021, initial value 0xFFFF, not reflected.
+ *
+ * @param crc CRC of the previous bytes
+ * @param data Next byte
+ * @return CRC including the byte
+ */
+uint16_t eer_crc16_ccitt_update(uint16_t crc, uint8_t data);
+
+/**
+ * @brief CRC-16/CCITT-FALSE of a block, see eer_crc16_ccitt_update()
+ * @param crc CRC of the previous bytes
+ * @param data Pointer to data
+ * @param size Size of data
+ * @return CRC including the block
+ */
+uint16_t eer_crc16_ccitt(uint16_t crc, const void* data, uint16_t size);
+
+/**
+ * @brief CRC-16/MODBUS of Modbus RTU frames
+ *
+ * Polynomial 0x8005 reflected, initial value 0xFFFF. The frame carries the
+ * low byte first; over a frame that ends with its CRC the result is 0.
+ *
+ * @param crc CRC of the previous bytes
+ * @param data Next byte
+ * @return CRC including the byte
+ */
+uint16_t eer_crc16_modbus_update(uint16_t crc, uint8_t data);
+
+/**
+ * @brief CRC-16/MODBUS of a block, see eer_crc16_modbus_update()
+ * @param crc CRC of the previous bytes
+ * @param data Pointer to data
+ * @param size Size of data
+ * @return CRC including the block
+ */
+uint16_t eer_crc16_modbus(uint16_t crc, const void* data, uint16_t size);
+
+/**
+ * @brief CRC-32 of Ethernet, zlib and PNG
+ *
+ * Polynomial 0x04C11DB7 reflected, initial value and final XOR 0xFFFFFFFF.
+ * The XORs are applied on each call, so the value passed around is always
+ * the finished CRC, as with zlib's crc32().
+ *
+ * @param crc CRC of the previous bytes
+ * @param data Next byte
+ * @return CRC including the byte
+ */
+uint32_t eer_crc32_update(uint32_t crc, uint8_t data);
+
+/**
+ * @brief CRC-32 of a block, see eer_crc32_update()
+ * @param crc CRC of the previous bytes
+ * @param data Pointer to data
+ * @param size Size of data
+ * @return CRC including the block
+ */
+uint32_t eer_crc32(uint32_t crc, const void* data, uint16_t size);
@@ -0,0 +1,192 @@
+/**
+ * @file eer_event.h
+ * @brief Priority event dispatcher between HAL callbacks and EER components
+ *
+ * HAL callbacks run in interrupt context. Instead of calling application
+ * code there, a callback posts a small event into one of the priority
+ * queues, and the main loop hands the events to their subscribers between
+ * component updates, so component state is only changed outside ISRs:
+ *
+ *     static void on_byte(const eer_event_t* event, void* user_data) {
+ *         ...
+ *     }
+ *
+ *     static eer_event_subscription_t console =
+ *         eer_event_subscription(EER_EVENT_UART_RX, on_byte, NULL);
+ *
+ *     eer_event_subscribe(&console);
+ *     eer_hal.uart->register_rx_callback(eer_event_uart_rx,
+ *                                        eer_event_route(EER_EVENT_HIGH, 0));
+ *
+ *     loop(display) {
+ *         eer_event_dispatch(EER_EVENT_BUDGET);
+ *         apply(...);
+ *     }
+ *
+ * The eer_event_* bridges below have the signatures of the HAL callbacks;
+ * registered with eer_event_route() as user data they post an event with
+ * that priority and source ID.
+ *
+ * Queues are lock-free: interrupt handlers do not nest, so a handler
+ * writes the slot and then publishes it by advancing the head, which the
+ * dispatcher alone reads against its tail. eer_event_post() from the main
+ * loop masks interrupts for the copy of one event.
+ *
+ * Latency: the dispatcher picks the highest priority queue with an event
+ * before every event, so a high priority event waits for at most the
+ * handlers of one event already being dispatched, plus the budget of
+ * component updates in one loop iteration.
+ */
+#pragma once
+
+#include "eer_hal.h"
+#include "eer_hal_errors.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Events per priority queue, a power of two up to 128
+ */
+#ifndef EER_EVENT_QUEUE_SIZE
+#define EER_EVENT_QUEUE_SIZE 8
+#endif
+
+/**
+ * @brief Suggested number of events dispatched per loop iteration
+ */
+#ifndef EER_EVENT_BUDGET
+#define EER_EVENT_BUDGET 4
+#endif
+
+/**
+ * @brief Event priorities, highest first
+ */
+typedef enum {
+    EER_EVENT_HIGH,    /*!< Dispatched before any other event */
+    EER_EVENT_NORMAL,  /*!< Default priority */
+    EER_EVENT_LOW,     /*!< Dispatched when nothing else is pending */
+    EER_EVENT_PRIORITIES
+} eer_event_priority_t;
+
+/**
+ * @brief Event types
+ */
+typedef enum {
+    EER_EVENT_ANY = 0,           /*!< Subscriptions only: every type */
+    EER_EVENT_GPIO,              /*!< Pin interrupt, data: pin */
+    EER_EVENT_ADC,               /*!< Conversion complete, value: result, data: channel */
+    EER_EVENT_UART_RX,           /*!< Byte received, value: byte, data: UART */
+    EER_EVENT_UART_TX,           /*!< Transmit complete, data: UART */
+    EER_EVENT_SPI,               /*!< Transfer complete, value: size, data: SPI */
+    EER_EVENT_I2C,               /*!< Transfer complete, value: address, data: I2C */
+    EER_EVENT_TIMER_OVERFLOW,    /*!< Timer overflow, value: count, data: timer */
+    EER_EVENT_TIMER_COMPARE,     /*!< Compare match, value: count, data: timer */
+    EER_EVENT_TIMER_CAPTURE,     /*!< Input capture, value: captured count, data: timer */
+    EER_EVENT_ASYNC,             /*!< Request complete, value: status, data: request */
+    EER_EVENT_IR,                /*!< Remote control command, value: address << 8 | command, data: decoder */
+    EER_EVENT_IR_REPEAT,         /*!< Remote control key held, value and data as EER_EVENT_IR */
+    EER_EVENT_USER = 0x80        /*!< First type free for application events */
+} eer_event_type_t;
+
+/**
+ * @brief Event, copied into the queue
+ */
+typedef struct {
+    uint8_t  type;    /*!< Event type, see eer_event_type_t */
+    uint8_t  source;  /*!< Source ID from the route, e.g. which button */
+    uint32_t value;   /*!< Type-specific value, 24 bits for extended NEC codes */
+    void*    data;    /*!< Peripheral instance or pin that raised the event */
+} eer_event_t;
+
+/**
+ * @brief Event handler of a subscription
+ * @param event Event being dispatched
+ * @param user_data User data of the subscription
+ */
+typedef void (*eer_event_handler_t)(const eer_event_t* event, void* user_data);
+
+/**
+ * @brief Subscription of a handler to one event type
+ */
+typedef struct eer_event_subscription {
+    uint8_t             type;       /*!< Event type, EER_EVENT_ANY for all */
+    eer_event_handler_t handler;    /*!< Handler called for each event */
+    void*               user_data;  /*!< User data passed to the handler */
+    struct eer_event_subscription* next; /*!< Managed by eer_event_subscribe() */
+} eer_event_subscription_t;
+
+/**
+ * @brief Initializer of a subscription
+ */
+#define eer_event_subscription(type, handler, user_data) \
+    { (type), (handler), (user_data), NULL }
+
+/**
+ * @brief User data of a bridge: priority and source ID of its events
+ */
+#define eer_event_route(priority, source) \
+    ((void*)(uintptr_t)((uint16_t)(priority) << 8 | (uint8_t)(source)))
+
+/**
+ * @brief Subscribe a handler, called in subscription order
+ * @param subscription Subscription, stays owned by the caller
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t eer_event_subscribe(eer_event_subscription_t* subscription);
+
+/**
+ * @brief Remove a subscription
+ * @param subscription Subscription
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t eer_event_unsubscribe(eer_event_subscription_t* subscription);
+
+/**
+ * @brief Post an event from an interrupt handler
+ * @param priority Queue
+ * @param event Event, copied
+ * @return EER_HAL_OK, or EER_HAL_BUSY if the queue is full and the event
+ *         was dropped
+ */
+eer_hal_status_t eer_event_post_isr(eer_event_priority_t priority, const eer_event_t* event);
+
+/**
+ * @brief Post an event from code interrupts may preempt
+ * @param priority Queue
+ * @param event Event, copied
+ * @return EER_HAL_OK, or EER_HAL_BUSY if the queue is full and the event
+ *         was dropped
+ */
+eer_hal_status_t eer_event_post(eer_event_priority_t priority, const eer_event_t* event);
+
+/**
+ * @brief Dispatch queued events to their subscribers, highest priority first
+ * @param budget Maximum number of events, 0 to empty the queues
+ * @return Number of events dispatched
+ */
+uint8_t eer_event_dispatch(uint8_t budget);
+
+/**
+ * @brief Check for queued events, e.g. before going to sleep
+ * @return true if an event waits for dispatch
+ */
+bool eer_event_pending(void);
+
+/**
+ * @brief Number of events dropped on a full queue since the last call
+ * @param priority Queue
+ * @return Dropped events, saturating at 255
+ */
+uint8_t eer_event_dropped(eer_event_priority_t priority);
+
+/*
+ * Bridges, registered as HAL callbacks with eer_event_route() as user data
+ */
+void eer_event_gpio_irq(eer_gpio_irq_t* irq);
+void eer_event_adc_conversion(eer_adc_conversion_t* conversion);
+void eer_event_uart_rx(eer_uart_rx_event_t* event);
+void eer_event_uart_tx(eer_uart_tx_event_t* event);
+void eer_event_spi_transfer(eer_spi_transfer_event_t* event);
+void eer_event_i2c_transfer(eer_i2c_transfer_event_t* event);
+void eer_event_timer(eer_timer_event_info_t* event);
+void eer_event_async(eer_async_request_t* request, void* user_data);
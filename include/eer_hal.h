@@ -21,6 +21,8 @@ typedef struct {
 #include "eer_hal_timer.h"
 #include "eer_hal_system.h"
 #include "eer_hal_power.h"
+#include "eer_hal_nvs.h"
+#include "eer_hal_async.h"
 
 // Master HAL structure that combines all peripherals
 typedef struct {
@@ -32,8 +34,30 @@ typedef struct {
     eer_timer_handler_t*   timer;
     eer_system_handler_t*  system;
     eer_power_handler_t*   power;
+    eer_nvs_handler_t*     nvs;
+    eer_uart_instance_handler_t*  uart_instance;
+    eer_timer_instance_handler_t* timer_instance;
 } eer_hal_t;
 
 
 // Global HAL instance - defined by platform implementation
 extern eer_hal_t eer_hal;
+
+/*
+ * Call a HAL operation: eer_hal_call(gpio, write, &pin, true)
+ *
+ * By default the call goes through the eer_hal table, so the handlers can
+ * be swapped at run time. Defining EER_HAL_STATIC binds the call at compile
+ * time instead: it expands to eer_<peripheral>_<operation>(), which the
+ * platform's hal_static.h maps to a direct call or an inline function the
+ * compiler can constant-fold. The eer_hal table stays available in both
+ * modes, and both can be mixed within one program.
+ */
+#ifdef EER_HAL_STATIC
+#include "hal_static.h"
+#define eer_hal_call(peripheral, operation, ...) \
+    eer_##peripheral##_##operation(__VA_ARGS__)
+#else
+#define eer_hal_call(peripheral, operation, ...) \
+    eer_hal.peripheral->operation(__VA_ARGS__)
+#endif
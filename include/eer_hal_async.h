@@ -0,0 +1,188 @@
+/**
+ * @file eer_hal_async.h
+ * @brief Asynchronous transfer requests shared by the UART, SPI and I2C
+ *
+ * A request describes one transfer on a bus: the buffers to write and
+ * read, the completion callback and the request to start after it. It is
+ * submitted with eer_async_submit() and owned by the driver until its
+ * status leaves EER_HAL_BUSY; the driver queues it behind the requests
+ * already on the bus and runs it from its interrupt handlers.
+ *
+ * On completion the driver calls the callback and submits next from the
+ * same interrupt, so a chain of requests runs as a pipeline without the
+ * main loop, across buses:
+ *
+ *     static uint8_t command[] = { 0x00 };
+ *     static uint8_t sample[2];
+ *
+ *     static eer_async_request_t report = {
+ *         .bus = EER_ASYNC_UART,
+ *         .tx_data = sample, .tx_size = sizeof(sample)
+ *     };
+ *     static eer_async_request_t measure = {
+ *         .bus = EER_ASYNC_I2C, .address = 0x48,
+ *         .tx_data = command, .tx_size = sizeof(command),
+ *         .rx_data = sample, .rx_size = sizeof(sample),
+ *         .next = &report
+ *     };
+ *
+ *     eer_async_submit(&measure);
+ *
+ * A failed request is completed with its error and cancels the rest of its
+ * pipeline: every following request completes with the same status
+ * without being started.
+ *
+ * Each bus runs the transfer in its own way:
+ *   - UART: sends tx_size bytes, then receives rx_size bytes, starting with
+ *     bytes already waiting in the receive buffer. device is the instance,
+ *     NULL for UART0. Received bytes go to the request, not to the receive
+ *     callback.
+ *   - SPI: exchanges the longer of tx_size and rx_size bytes full duplex,
+ *     sending 0xFF past tx_size and dropping bytes past rx_size. device is
+ *     an eer_spi_device_t: the bus runs at its clock with its chip select
+ *     asserted for the transfer. NULL leaves both to the caller.
+ *   - I2C: writes tx_size bytes to address, then reads rx_size bytes after
+ *     a repeated start.
+ *
+ * Constant payloads need no RAM copy: with EER_ASYNC_TX_FLASH in flags,
+ * tx_data points into program memory (PROGMEM on AVR) and the driver reads
+ * each byte from there as it goes. Platforms with a single address space
+ * read it as ordinary memory.
+ *
+ * A device that needs the bus across several requests, keeping its chip
+ * select asserted between them, reserves it with eer_async_reserve():
+ * requests of other owners are then held back until eer_async_release().
+ *
+ * Blocking calls on a bus return EER_HAL_BUSY while it runs requests.
+ * Requests start zero-initialized, with a status other than EER_HAL_BUSY,
+ * and are not submitted again while pending.
+ */
+#pragma once
+
+#include "eer_hal_errors.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Bus of a request
+ */
+typedef enum {
+    EER_ASYNC_UART,  /*!< UART instance in device */
+    EER_ASYNC_SPI,   /*!< SPI bus, eer_spi_device_t in device */
+    EER_ASYNC_I2C,   /*!< I2C bus, device at address */
+    EER_ASYNC_BUS_COUNT /*!< Number of buses */
+} eer_async_bus_t;
+
+/**
+ * @brief Options of a request, or-ed into its flags
+ */
+typedef enum {
+    EER_ASYNC_TX_FLASH = 1 << 0  /*!< tx_data is in program memory */
+} eer_async_flags_t;
+
+struct eer_async_request;
+
+/**
+ * @brief Completion handler of a request
+ *
+ * Called in interrupt context with the status already set; next is read
+ * after the handler returns, so the handler may set it.
+ *
+ * @param request Completed request
+ * @param user_data User data of the request
+ */
+typedef void (*eer_async_handler_t)(struct eer_async_request* request, void* user_data);
+
+/**
+ * @brief Asynchronous transfer request
+ */
+typedef struct eer_async_request {
+    eer_async_bus_t   bus;       /*!< Bus running the request */
+    uint8_t           flags;     /*!< eer_async_flags_t options */
+    void*             device;    /*!< UART instance or SPI device, NULL for the default */
+    uint16_t          address;   /*!< I2C device address */
+    const uint8_t*    tx_data;   /*!< Bytes to write, NULL if tx_size is 0 */
+    uint16_t          tx_size;   /*!< Number of bytes to write */
+    uint8_t*          rx_data;   /*!< Buffer for the bytes read, NULL if rx_size is 0 */
+    uint16_t          rx_size;   /*!< Number of bytes to read */
+    volatile eer_hal_status_t status; /*!< EER_HAL_BUSY until complete, then the result */
+    eer_async_handler_t handler; /*!< Completion handler, NULL for none */
+    void*             user_data; /*!< User data passed to the handler */
+    struct eer_async_request* next; /*!< Request submitted on success, NULL ends the pipeline */
+    
+    struct eer_async_request* queued; /*!< Managed by the driver */
+    uint16_t          index;     /*!< Managed by the driver: bytes transferred */
+} eer_async_request_t;
+
+/**
+ * @brief Requests waiting on one bus, the head one running
+ */
+typedef struct {
+    eer_async_request_t* head;  /*!< Running request, NULL when idle */
+    eer_async_request_t* tail;  /*!< Last request */
+} eer_async_queue_t;
+
+/**
+ * @brief Submit a request to its bus
+ * @param request Request, owned by the driver until it completes
+ * @return EER_HAL_OK if queued, EER_HAL_BUSY if it is still pending,
+ *         EER_HAL_INVALID_PARAM for a malformed request
+ */
+eer_hal_status_t eer_async_submit(eer_async_request_t* request);
+
+/**
+ * @brief Reserve a bus for the requests of one owner
+ *
+ * Requests are told apart by their user_data. Those of other owners
+ * submitted while the bus is reserved stay pending and are queued on the
+ * bus, in order, when it is released; requests queued before still run
+ * first, so the owner's first request marks when the bus is its own.
+ *
+ * @param bus Bus
+ * @param owner user_data of the owner's requests, not NULL
+ * @return EER_HAL_OK, EER_HAL_BUSY if another owner holds the bus
+ */
+eer_hal_status_t eer_async_reserve(eer_async_bus_t bus, void* owner);
+
+/**
+ * @brief End a reservation and submit the requests held back
+ * @param bus Bus
+ * @param owner Owner given to eer_async_reserve(), nothing happens for another
+ */
+void eer_async_release(eer_async_bus_t bus, void* owner);
+
+/*
+ * Driver side. Queues are modified with the bus interrupt masked.
+ */
+
+/**
+ * @brief Check a request and mark it pending
+ * @param request Request
+ * @return EER_HAL_OK if it can be queued
+ */
+eer_hal_status_t eer_async_prepare(eer_async_request_t* request);
+
+/**
+ * @brief Append a prepared request to a queue
+ * @return true if the bus was idle and the driver has to start it
+ */
+bool eer_async_enqueue(eer_async_queue_t* queue, eer_async_request_t* request);
+
+/**
+ * @brief Remove the running request
+ * @return Next request to start, NULL if the bus is idle
+ */
+eer_async_request_t* eer_async_dequeue(eer_async_queue_t* queue);
+
+/**
+ * @brief Finish a request dequeued from its bus
+ *
+ * Sets the status, calls the callback and submits next on success, or
+ * cancels the rest of the pipeline on failure.
+ */
+void eer_async_complete(eer_async_request_t* request, eer_hal_status_t status);
+
+/**
+ * @brief Complete every queued request with a status, e.g. on deinit
+ */
+void eer_async_cancel(eer_async_queue_t* queue, eer_hal_status_t status);
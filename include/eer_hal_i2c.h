@@ -56,6 +56,9 @@ typedef struct {
  */
 typedef void (*eer_i2c_transfer_handler_t)(eer_i2c_transfer_event_t* event);
 
+// Asynchronous request, defined in eer_hal_async.h
+struct eer_async_request;
+
 /**
  * @brief I2C hardware abstraction layer interface
  * 
@@ -140,4 +143,11 @@ typedef struct {
      * @return Status code indicating success or failure
      */
     eer_hal_status_t (*unregister_callback)(void);
+    
+    /**
+     * @brief Queue an asynchronous request, see eer_hal_async.h
+     * @param request Request to the device at request->address
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*submit)(struct eer_async_request* request);
 } eer_i2c_handler_t;
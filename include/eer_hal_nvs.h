@@ -0,0 +1,118 @@
+/**
+ * @file eer_hal_nvs.h
+ * @brief Non-volatile storage hardware abstraction layer interface for the EER Framework
+ *
+ * This file defines the interface for non-volatile storage (EEPROM or Flash)
+ * operations across all supported platforms. Platform-specific implementations
+ * will implement these functions.
+ */
+#pragma once
+
+#include "eer_hal_errors.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Value of an erased storage byte
+ */
+#define EER_NVS_ERASED_BYTE 0xFF
+
+/**
+ * @brief NVS write complete event information
+ */
+typedef struct {
+    void*     nvs;        /*!< NVS instance that finished programming */
+    void*     user_data;  /*!< User data passed during registration */
+} eer_nvs_event_t;
+
+/**
+ * @brief NVS write complete callback function type
+ * @param event Information about the write complete event
+ */
+typedef void (*eer_nvs_write_handler_t)(eer_nvs_event_t* event);
+
+/**
+ * @brief Non-volatile storage hardware abstraction layer interface
+ *
+ * This structure provides a consistent interface for non-volatile storage
+ * operations across different hardware platforms. Writes may be programmed
+ * in the background; reads always return the most recently written data.
+ */
+typedef struct {
+    /**
+     * @brief Initialize the storage hardware
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*init)(void);
+    
+    /**
+     * @brief Deinitialize the storage hardware, finishing pending writes
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*deinit)(void);
+    
+    /**
+     * @brief Read data from storage
+     * @param address Storage address to read from
+     * @param data Pointer to buffer for read data
+     * @param size Size of data to read
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*read)(uint32_t address, uint8_t* data, uint16_t size);
+    
+    /**
+     * @brief Write data to storage
+     * @param address Storage address to write to
+     * @param data Pointer to data to write
+     * @param size Size of data to write
+     * @param timeout Timeout in milliseconds (0 for non-blocking)
+     * @return Status code indicating success or failure, EER_HAL_BUSY if the
+     *         write could not be accepted without blocking
+     */
+    eer_hal_status_t (*write)(uint32_t address, const uint8_t* data, uint16_t size, uint32_t timeout);
+    
+    /**
+     * @brief Erase a storage range to EER_NVS_ERASED_BYTE
+     * @param address Storage address of the range
+     * @param size Size of the range
+     * @param timeout Timeout in milliseconds (0 for non-blocking)
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*erase)(uint32_t address, uint16_t size, uint32_t timeout);
+    
+    /**
+     * @brief Wait until all accepted writes are programmed
+     * @param timeout Timeout in milliseconds (0 for non-blocking)
+     * @return Status code indicating success or failure, EER_HAL_BUSY if
+     *         writes are still pending
+     */
+    eer_hal_status_t (*flush)(uint32_t timeout);
+    
+    /**
+     * @brief Check if writes are pending
+     * @param busy Pointer to store busy status
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*is_busy)(bool* busy);
+    
+    /**
+     * @brief Get the storage capacity
+     * @param[out] size Pointer to store the size in bytes
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*get_size)(uint32_t* size);
+    
+    /**
+     * @brief Register a callback for write complete events
+     * @param handler Callback function, called once all pending writes are programmed
+     * @param user_data User data to pass to the callback
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*register_callback)(eer_nvs_write_handler_t handler, void* user_data);
+    
+    /**
+     * @brief Unregister a write complete callback
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*unregister_callback)(void);
+} eer_nvs_handler_t;
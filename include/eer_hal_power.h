@@ -28,7 +28,8 @@ typedef enum {
     EER_WAKEUP_PIN,           /*!< External pin wakeup */
     EER_WAKEUP_RTC,           /*!< RTC alarm wakeup */
     EER_WAKEUP_TIMER,         /*!< Timer wakeup */
-    EER_WAKEUP_WATCHDOG       /*!< Watchdog timer wakeup */
+    EER_WAKEUP_WATCHDOG,      /*!< Watchdog timer wakeup */
+    EER_WAKEUP_UART           /*!< Serial receive activity wakeup */
 } eer_wakeup_source_t;
 
 /**
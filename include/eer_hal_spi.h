@@ -77,6 +77,17 @@ typedef struct {
     bool                master;     /*!< Master mode (true) or slave mode (false) */
 } eer_spi_config_t;
 
+/**
+ * @brief Device on the SPI bus
+ *
+ * Devices sharing the bus each keep their own clock, applied whenever the
+ * device is selected; see eer_spi_device.h.
+ */
+typedef struct {
+    void*               cs;         /*!< Chip select pin */
+    eer_spi_prescaler_t prescaler;  /*!< Clock while selected */
+} eer_spi_device_t;
+
 /**
  * @brief SPI transfer complete event information
  */
@@ -94,6 +105,9 @@ typedef struct {
  */
 typedef void (*eer_spi_transfer_handler_t)(eer_spi_transfer_event_t* event);
 
+// Asynchronous request, defined in eer_hal_async.h
+struct eer_async_request;
+
 /**
  * @brief SPI hardware abstraction layer interface
  * 
@@ -157,6 +171,14 @@ typedef struct {
      */
     eer_hal_status_t (*chip_select)(void* pin, bool state);
     
+    /**
+     * @brief Change the clock, keeping the rest of the configuration
+     * @param prescaler Clock prescaler
+     * @return Status code indicating success or failure, EER_HAL_BUSY while
+     *         requests run
+     */
+    eer_hal_status_t (*set_prescaler)(eer_spi_prescaler_t prescaler);
+    
     /**
      * @brief Register a callback for SPI transfer complete events
      * @param handler Callback function
@@ -170,4 +192,11 @@ typedef struct {
      * @return Status code indicating success or failure
      */
     eer_hal_status_t (*unregister_callback)(void);
+    
+    /**
+     * @brief Queue an asynchronous request, see eer_hal_async.h
+     * @param request Request, with its eer_spi_device_t in request->device
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*submit)(struct eer_async_request* request);
 } eer_spi_handler_t;
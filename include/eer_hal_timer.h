@@ -151,4 +151,136 @@ typedef struct {
      * @return Status code indicating success or failure
      */
     eer_hal_status_t (*unregister_callback)(eer_timer_event_t event, uint8_t channel);
+    
+    /**
+     * @brief Select the edge of the capture input that latches the counter
+     * @param rising true for rising edges, false for falling edges
+     * @return Status code indicating success or failure, EER_HAL_NOT_SUPPORTED
+     *         without a capture input
+     */
+    eer_hal_status_t (*set_capture_edge)(bool rising);
 } eer_timer_handler_t;
+
+/**
+ * @brief Timer interface on explicit instances
+ *
+ * Same operations as eer_timer_handler_t, each taking an instance handle
+ * as first argument: a pointer to the platform's eer_timer_t, created with
+ * its eer_hal_timerN() macro. The structure is the per-instance state
+ * block holding registers, configuration and callbacks, so one driver
+ * serves every timer of its kind. eer_timer_handler_t operates on the
+ * platform's default timer.
+ */
+typedef struct {
+    /**
+     * @brief Initialize a timer instance
+     * @param timer Instance handle
+     * @param config Configuration parameters
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*init)(void* timer, eer_timer_config_t* config);
+    
+    /**
+     * @brief Deinitialize a timer instance
+     * @param timer Instance handle
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*deinit)(void* timer);
+    
+    /**
+     * @brief Start the timer
+     * @param timer Instance handle
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*start)(void* timer);
+    
+    /**
+     * @brief Stop the timer
+     * @param timer Instance handle
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*stop)(void* timer);
+    
+    /**
+     * @brief Set the timer period
+     * @param timer Instance handle
+     * @param period Timer period in ticks
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*set_period)(void* timer, uint32_t period);
+    
+    /**
+     * @brief Get the current timer value
+     * @param timer Instance handle
+     * @param[out] value Pointer to store the timer value
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*get_value)(void* timer, uint32_t* value);
+    
+    /**
+     * @brief Set the timer compare value
+     * @param timer Instance handle
+     * @param channel Compare channel (if applicable)
+     * @param value Compare value
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*set_compare)(void* timer, uint8_t channel, uint32_t value);
+    
+    /**
+     * @brief Set the PWM duty cycle
+     * @param timer Instance handle
+     * @param channel PWM channel
+     * @param duty_cycle Duty cycle value (0-100%)
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*set_pwm_duty_cycle)(void* timer, uint8_t channel, uint8_t duty_cycle);
+    
+    /**
+     * @brief Convert time in microseconds to ticks of the timer
+     * @param timer Instance handle
+     * @param us Time in microseconds
+     * @return Equivalent timer ticks
+     */
+    uint32_t (*us_to_ticks)(void* timer, uint32_t us);
+    
+    /**
+     * @brief Convert ticks of the timer to time in microseconds
+     * @param timer Instance handle
+     * @param ticks Timer ticks
+     * @return Equivalent time in microseconds
+     */
+    uint32_t (*ticks_to_us)(void* timer, uint32_t ticks);
+    
+    /**
+     * @brief Register a callback for events of the timer
+     * @param timer Instance handle
+     * @param event Event type
+     * @param channel Channel (if applicable)
+     * @param handler Callback function
+     * @param user_data User data to pass to the callback
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*register_callback)(void* timer,
+                                         eer_timer_event_t event,
+                                         uint8_t channel,
+                                         eer_timer_event_handler_t handler,
+                                         void* user_data);
+    
+    /**
+     * @brief Unregister an event callback of the timer
+     * @param timer Instance handle
+     * @param event Event type
+     * @param channel Channel (if applicable)
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*unregister_callback)(void* timer, eer_timer_event_t event, uint8_t channel);
+    
+    /**
+     * @brief Select the edge of the capture input that latches the counter
+     * @param timer Instance handle
+     * @param rising true for rising edges, false for falling edges
+     * @return Status code indicating success or failure, EER_HAL_NOT_SUPPORTED
+     *         without a capture input
+     */
+    eer_hal_status_t (*set_capture_edge)(void* timer, bool rising);
+} eer_timer_instance_handler_t;
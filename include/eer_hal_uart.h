@@ -80,6 +80,9 @@ typedef void (*eer_uart_rx_handler_t)(eer_uart_rx_event_t* event);
  */
 typedef void (*eer_uart_tx_handler_t)(eer_uart_tx_event_t* event);
 
+// Asynchronous request, defined in eer_hal_async.h
+struct eer_async_request;
+
 /**
  * @brief UART hardware abstraction layer interface
  * 
@@ -159,4 +162,105 @@ typedef struct {
      * @return Status code indicating success or failure
      */
     eer_hal_status_t (*unregister_tx_callback)(void);
+    
+    /**
+     * @brief Queue an asynchronous request, see eer_hal_async.h
+     * @param request Request on the instance in request->device, UART0 if NULL
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*submit)(struct eer_async_request* request);
 } eer_uart_handler_t;
+
+/**
+ * @brief UART interface on explicit instances
+ *
+ * Same operations as eer_uart_handler_t, each taking an instance handle as
+ * first argument: a pointer to the platform's eer_uart_t, created with its
+ * eer_hal_uartN() macro. The structure is the per-instance state block
+ * holding registers, receive buffer and callbacks, so one driver serves
+ * every UART of the chip. eer_uart_handler_t operates on UART0.
+ */
+typedef struct {
+    /**
+     * @brief Initialize a UART instance
+     * @param uart Instance handle
+     * @param config Configuration parameters
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*init)(void* uart, eer_uart_config_t* config);
+    
+    /**
+     * @brief Deinitialize a UART instance
+     * @param uart Instance handle
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*deinit)(void* uart);
+    
+    /**
+     * @brief Transmit data
+     * @param uart Instance handle
+     * @param data Pointer to data buffer
+     * @param size Size of data to transmit
+     * @param timeout Timeout in milliseconds (0 for non-blocking)
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*transmit)(void* uart, const uint8_t* data, uint16_t size, uint32_t timeout);
+    
+    /**
+     * @brief Receive data
+     * @param uart Instance handle
+     * @param data Pointer to data buffer
+     * @param size Size of data to receive
+     * @param timeout Timeout in milliseconds (0 for non-blocking)
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*receive)(void* uart, uint8_t* data, uint16_t size, uint32_t timeout);
+    
+    /**
+     * @brief Check if the instance is ready to transmit
+     * @param uart Instance handle
+     * @param ready Pointer to store ready status
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*is_tx_ready)(void* uart, bool* ready);
+    
+    /**
+     * @brief Check if the instance has received data
+     * @param uart Instance handle
+     * @param ready Pointer to store ready status
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*is_rx_ready)(void* uart, bool* ready);
+    
+    /**
+     * @brief Register a callback for receive events of the instance
+     * @param uart Instance handle
+     * @param handler Callback function
+     * @param user_data User data to pass to the callback
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*register_rx_callback)(void* uart, eer_uart_rx_handler_t handler, void* user_data);
+    
+    /**
+     * @brief Unregister the receive callback of the instance
+     * @param uart Instance handle
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*unregister_rx_callback)(void* uart);
+    
+    /**
+     * @brief Register a callback for transmit complete events of the instance
+     * @param uart Instance handle
+     * @param handler Callback function
+     * @param user_data User data to pass to the callback
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*register_tx_callback)(void* uart, eer_uart_tx_handler_t handler, void* user_data);
+    
+    /**
+     * @brief Unregister the transmit complete callback of the instance
+     * @param uart Instance handle
+     * @return Status code indicating success or failure
+     */
+    eer_hal_status_t (*unregister_tx_callback)(void* uart);
+} eer_uart_instance_handler_t;
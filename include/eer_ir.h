@@ -0,0 +1,130 @@
+/**
+ * @file eer_ir.h
+ * @brief Infrared remote decoder on the input capture unit of a HAL timer
+ *
+ * The output of a demodulating IR receiver goes to the capture input of a
+ * free-running timer (ICP1 for Timer1 on AVR). Every edge latches the
+ * counter, and the capture callback flips the edge it waits for, so the
+ * difference between two captures is the length of one mark or space.
+ * The callback classifies each length against tolerance windows computed
+ * once at init and steps the NEC and RC5 decoders with it; it only
+ * compares integers. While the line is idle no interrupt fires at all.
+ *
+ * A decoded command is posted to the event dispatcher as EER_EVENT_IR. A
+ * held key posts EER_EVENT_IR_REPEAT: NEC remotes send repeat codes for
+ * it, RC5 remotes send the frame again with an unchanged toggle bit. Both
+ * carry the command in the low byte of the value and the address in the
+ * bytes above it, and the decoder as data:
+ *
+ *     static eer_timer_t ir_timer = eer_hal_timer1();
+ *     static eer_ir_t remote = { .timer = &ir_timer, .priority = EER_EVENT_NORMAL };
+ *
+ *     static void on_key(const eer_event_t* event, void* user_data) {
+ *         uint8_t command = event->value & 0xFF;
+ *         ...
+ *     }
+ *
+ *     static eer_event_subscription_t keys = eer_event_subscription(EER_EVENT_IR, on_key, NULL);
+ *
+ *     eer_event_subscribe(&keys);
+ *     eer_ir_init(&remote);
+ *
+ * Receivers such as the TSOP38238 pull their output low while they see
+ * the carrier, so a mark is low and the line idles high.
+ */
+#pragma once
+
+#include "eer_hal.h"
+#include "eer_event.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Frequency of the capture timer in Hz, where the platform lets it be set
+ */
+#ifndef EER_IR_TIMER_FREQUENCY
+#define EER_IR_TIMER_FREQUENCY 1000000UL
+#endif
+
+/**
+ * @brief Deviation from the nominal length a pulse may have, in percent
+ */
+#ifndef EER_IR_TOLERANCE_PERCENT
+#define EER_IR_TOLERANCE_PERCENT 25
+#endif
+
+/**
+ * @brief Line idle time in milliseconds after which the next edge starts a frame
+ *
+ * Longer than any pulse of a frame and shorter than a lap of the counter.
+ */
+#ifndef EER_IR_IDLE_MS
+#define EER_IR_IDLE_MS 20
+#endif
+
+/**
+ * @brief Time in milliseconds from a frame or repeat within which the next
+ *        one counts as the key being held
+ */
+#ifndef EER_IR_REPEAT_MS
+#define EER_IR_REPEAT_MS 150
+#endif
+
+/**
+ * @brief Protocols
+ */
+typedef enum {
+    EER_IR_NEC = 1 << 0,       /*!< NEC and extended NEC, pulse distance coding */
+    EER_IR_RC5 = 1 << 1        /*!< Philips RC5 and RC5X, Manchester coding */
+} eer_ir_protocol_t;
+
+/**
+ * @brief Decoder instance
+ *
+ * The last frame describes the code the latest event was posted for. NEC
+ * addresses are 8 bits, or 16 bits in extended NEC; RC5 addresses are 5
+ * bits and commands 7 bits including the field bit.
+ */
+typedef struct {
+    void*             timer;        /*!< Timer instance with a capture input */
+    uint8_t           protocols;    /*!< eer_ir_protocol_t decoded, 0 for all */
+    eer_event_priority_t priority;  /*!< Queue of the posted events */
+    uint8_t           source;       /*!< Source ID of the posted events */
+    
+    volatile uint8_t  protocol;     /*!< Protocol of the last frame, 0 before the first */
+    volatile uint16_t address;      /*!< Address of the last frame */
+    volatile uint8_t  command;      /*!< Command of the last frame */
+    volatile bool     toggle;       /*!< Toggle bit of the last RC5 frame */
+    volatile uint8_t  errors;       /*!< Frames rejected by a check or an unexpected pulse, saturating */
+    bool              rising;       /*!< Managed by the driver: edge being waited for */
+    uint16_t          capture;      /*!< Managed by the driver: counter value of the last edge */
+    uint32_t          edge_ms;      /*!< Managed by the driver: system tick of the last edge */
+    uint32_t          frame_ms;     /*!< Managed by the driver: system tick of the last frame or repeat */
+    uint8_t           nec_state;    /*!< Managed by the driver */
+    uint8_t           nec_bits;     /*!< Managed by the driver */
+    uint32_t          nec_data;     /*!< Managed by the driver */
+    uint8_t           rc5_bits;     /*!< Managed by the driver: 0 while idle */
+    bool              rc5_mid;      /*!< Managed by the driver: at the middle of a bit */
+    uint16_t          rc5_data;     /*!< Managed by the driver */
+    uint16_t          window[7][2]; /*!< Managed by the driver: shortest and longest pulse lengths in ticks */
+} eer_ir_t;
+
+/**
+ * @brief Start decoding
+ *
+ * Initializes the timer free-running at EER_IR_TIMER_FREQUENCY and waits
+ * for the falling edge of the first mark.
+ *
+ * @param ir Decoder instance with the timer set
+ * @return Status code indicating success or failure, EER_HAL_NOT_SUPPORTED
+ *         if the timer has no capture input, EER_HAL_INVALID_PARAM if the
+ *         counter laps within EER_IR_IDLE_MS
+ */
+eer_hal_status_t eer_ir_init(eer_ir_t* ir);
+
+/**
+ * @brief Stop decoding and release the timer
+ * @param ir Decoder instance
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t eer_ir_deinit(eer_ir_t* ir);
@@ -0,0 +1,117 @@
+/**
+ * @file eer_kv.h
+ * @brief Wear-leveled key-value store on non-volatile storage for the EER Framework
+ *
+ * Values are appended as CRC-protected records to a circular log of
+ * fixed-size slots, so every slot of the storage region is written once
+ * per lap instead of rewriting the same cells. A RAM index built by a
+ * single scan at init maps each key to the slot holding its latest value.
+ *
+ * A new value never overwrites the previous one: after power loss mid-write
+ * the partial record fails its CRC and the scan falls back to the previous
+ * record. Compaction copies live records from the tail of the log to the
+ * head, one record per step, and can be run from the idle loop.
+ */
+#pragma once
+
+#include "eer_hal_errors.h"
+#include "eer_hal_nvs.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Number of keys (0 to EER_KV_MAX_KEYS - 1), two bytes of RAM each
+ */
+#ifndef EER_KV_MAX_KEYS
+#define EER_KV_MAX_KEYS 16
+#endif
+
+/**
+ * @brief Size of one record slot in bytes
+ */
+#ifndef EER_KV_SLOT_SIZE
+#define EER_KV_SLOT_SIZE 16
+#endif
+
+/**
+ * @brief Free slots eer_kv_compact() keeps ahead of the log head
+ */
+#ifndef EER_KV_RESERVE
+#define EER_KV_RESERVE 4
+#endif
+
+/**
+ * @brief Record header: key, length and 16-bit sequence number
+ */
+#define EER_KV_HEADER_SIZE 4
+
+/**
+ * @brief Largest value a record holds (header and CRC take six bytes)
+ */
+#define EER_KV_VALUE_MAX (EER_KV_SLOT_SIZE - EER_KV_HEADER_SIZE - 2)
+
+/**
+ * @brief Index entry of a key without a stored value
+ */
+#define EER_KV_NO_SLOT 0xFFFF
+
+/**
+ * @brief Key-value store instance
+ */
+typedef struct {
+    eer_nvs_handler_t* nvs;             /*!< Storage holding the log */
+    uint32_t           base;            /*!< Storage address of slot 0 */
+    uint16_t           slots;           /*!< Number of slots in the log */
+    uint16_t           head;            /*!< Slot the next record is written to */
+    uint16_t           free;            /*!< Reusable slots starting at head */
+    uint16_t           seq;             /*!< Sequence number of the next record */
+    uint16_t           index[EER_KV_MAX_KEYS]; /*!< Slot of each key's latest record */
+} eer_kv_t;
+
+/**
+ * @brief Mount a store and build its index with one scan of the region
+ * @param kv Store instance
+ * @param nvs Initialized storage handler (e.g. eer_hal.nvs)
+ * @param base Storage address of the region
+ * @param size Size of the region, at least EER_KV_MAX_KEYS + 2 slots
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t eer_kv_init(eer_kv_t* kv, eer_nvs_handler_t* nvs, uint32_t base, uint32_t size);
+
+/**
+ * @brief Read the latest value of a key
+ * @param kv Store instance
+ * @param key Key identifier
+ * @param data Pointer to buffer for the value
+ * @param size Size of the buffer
+ * @param[out] length Pointer to store the value length
+ * @return Status code indicating success or failure, EER_HAL_ERROR if the
+ *         key has no value
+ */
+eer_hal_status_t eer_kv_get(eer_kv_t* kv, uint8_t key, uint8_t* data, uint8_t size, uint8_t* length);
+
+/**
+ * @brief Store a new value for a key
+ *
+ * Values equal to the stored one are not written. Runs compaction steps
+ * first when fewer than two slots are free.
+ *
+ * @param kv Store instance
+ * @param key Key identifier
+ * @param data Pointer to the value
+ * @param length Value length, up to EER_KV_VALUE_MAX
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t eer_kv_set(eer_kv_t* kv, uint8_t key, const uint8_t* data, uint8_t length);
+
+/**
+ * @brief Run incremental compaction
+ *
+ * Each step copies at most one live record, and stops once
+ * EER_KV_RESERVE slots are free.
+ *
+ * @param kv Store instance
+ * @param steps Maximum number of records to copy
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t eer_kv_compact(eer_kv_t* kv, uint8_t steps);
@@ -0,0 +1,186 @@
+/**
+ * @file eer_mcp2515.h
+ * @brief Interrupt-driven MCP2515 CAN controller on the HAL SPI bus
+ *
+ * The controller pulls its INT line low when a frame arrives or a
+ * transmission ends. The falling edge starts a chain of asynchronous SPI
+ * requests from the pin interrupt: READ STATUS, then READ RX BUFFER for
+ * each full receive buffer, which also clears its flag, then READ STATUS
+ * again until nothing is left. Received frames go into a ring that the
+ * main loop drains with eer_mcp2515_receive(); the CPU never polls the
+ * controller, and no SPI time is spent while the bus is quiet.
+ *
+ * Frames are sent through the three transmit buffers of the chip. Each
+ * frame carries a priority from 0 to 3; with several buffers loaded, the
+ * controller sends the highest priority first.
+ *
+ * Acceptance filtering is done by the controller, so frames nobody listens
+ * to never cost an interrupt. Receive buffer 0 matches mask 0 against
+ * filters 0 and 1 and rolls over into buffer 1; buffer 1 matches mask 1
+ * against filters 2 to 5:
+ *
+ *     static eer_mcp2515_t can = {
+ *         .device = { .cs = &can_cs }, .interrupt = &can_int,
+ *         .config = {
+ *             .oscillator = 8000000UL, .bitrate = 500000UL,
+ *             .filter = true,
+ *             .masks = { { 0x7F0 }, { 0x7FF } },
+ *             .filters = { { 0x120 }, { 0x120 }, { 0x7DF }, { 0x7DF }, { 0x7DF }, { 0x7DF } }
+ *         }
+ *     };
+ *
+ * accepts standard IDs 0x120 to 0x12F and 0x7DF.
+ */
+#pragma once
+
+#include "eer_hal.h"
+#include "eer_hal_async.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Frames in the receive ring, a power of two up to 128
+ */
+#ifndef EER_MCP2515_RX_QUEUE_SIZE
+#define EER_MCP2515_RX_QUEUE_SIZE 8
+#endif
+
+/**
+ * @brief Frame options
+ */
+typedef enum {
+    EER_CAN_EXTENDED = 1 << 0,  /*!< 29-bit identifier */
+    EER_CAN_RTR = 1 << 1        /*!< Remote transmission request */
+} eer_can_flags_t;
+
+/**
+ * @brief CAN frame
+ */
+typedef struct {
+    uint32_t          id;        /*!< 11-bit or, with EER_CAN_EXTENDED, 29-bit identifier */
+    uint8_t           flags;     /*!< eer_can_flags_t options */
+    uint8_t           dlc;       /*!< Number of data bytes, up to 8 */
+    uint8_t           data[8];   /*!< Data bytes */
+} eer_can_frame_t;
+
+/**
+ * @brief Operating modes
+ */
+typedef enum {
+    EER_MCP2515_NORMAL = 0x00,    /*!< Send and receive on the bus */
+    EER_MCP2515_LOOPBACK = 0x40,  /*!< Frames sent are received internally only */
+    EER_MCP2515_LISTEN = 0x60     /*!< Receive without acknowledging */
+} eer_mcp2515_mode_t;
+
+/**
+ * @brief Acceptance mask or filter
+ */
+typedef struct {
+    uint32_t          id;        /*!< Identifier bits; for a mask, the bits compared */
+    bool              extended;  /*!< 29-bit identifier; for a filter, matches extended frames only */
+} eer_mcp2515_filter_t;
+
+/**
+ * @brief Controller configuration
+ */
+typedef struct {
+    uint32_t          oscillator; /*!< Crystal frequency in Hz */
+    uint32_t          bitrate;    /*!< Bus bit rate in bit/s */
+    eer_mcp2515_mode_t mode;      /*!< Operating mode */
+    bool              filter;     /*!< Apply masks and filters; false receives every frame */
+    eer_mcp2515_filter_t masks[2];   /*!< Masks of receive buffers 0 and 1 */
+    eer_mcp2515_filter_t filters[6]; /*!< Filters 0 and 1 of buffer 0, 2 to 5 of buffer 1 */
+} eer_mcp2515_config_t;
+
+struct eer_mcp2515;
+
+/**
+ * @brief Notification of a received frame, called in interrupt context
+ * @param can Controller that queued the frame
+ * @param user_data User data of the controller
+ */
+typedef void (*eer_mcp2515_handler_t)(struct eer_mcp2515* can, void* user_data);
+
+/**
+ * @brief Controller instance
+ */
+typedef struct eer_mcp2515 {
+    eer_spi_device_t  device;       /*!< Chip select pin and clock, at most 10 MHz */
+    void*             interrupt;    /*!< Pin on the INT output */
+    eer_mcp2515_config_t config;    /*!< Configuration applied by eer_mcp2515_init() */
+    eer_mcp2515_handler_t on_receive; /*!< Called for each frame queued, NULL for none */
+    void*             user_data;    /*!< User data passed to on_receive */
+    
+    volatile uint8_t  head;         /*!< Managed by the driver: next slot written by the interrupt */
+    volatile uint8_t  tail;         /*!< Managed by the driver: next slot read */
+    volatile uint8_t  dropped;      /*!< Frames lost to a full ring, saturating */
+    volatile uint8_t  tx_busy;      /*!< Managed by the driver: transmit buffers loaded, one bit each */
+    volatile bool     servicing;    /*!< Managed by the driver: interrupt chain running */
+    volatile bool     again;        /*!< Managed by the driver: INT fell during the chain */
+    uint8_t           pending;      /*!< Managed by the driver: receive buffers left to read */
+    uint8_t           status[2];    /*!< Managed by the driver */
+    uint8_t           rx[14];       /*!< Managed by the driver: received byte, then the buffer registers */
+    uint8_t           flags[4];     /*!< Managed by the driver */
+    uint8_t           tx[3][14];    /*!< Managed by the driver */
+    uint8_t           tx_control[3][3]; /*!< Managed by the driver */
+    eer_async_request_t status_request; /*!< Managed by the driver */
+    eer_async_request_t rx_request;     /*!< Managed by the driver */
+    eer_async_request_t flags_request;  /*!< Managed by the driver */
+    eer_async_request_t tx_request[3];  /*!< Managed by the driver */
+    eer_async_request_t tx_control_request[3]; /*!< Managed by the driver */
+    eer_can_frame_t   frames[EER_MCP2515_RX_QUEUE_SIZE]; /*!< Managed by the driver */
+} eer_mcp2515_t;
+
+/**
+ * @brief Reset and configure the controller and start the INT interrupt
+ *
+ * Blocks for the reset and the register writes. The INT pin is configured
+ * as an input with pull-up, interrupting on its falling edge.
+ *
+ * @param can Controller instance with the pins and config set
+ * @return Status code indicating success or failure, EER_HAL_TIMEOUT if
+ *         the controller did not answer, EER_HAL_NOT_SUPPORTED if no bit
+ *         timing fits the oscillator and bit rate
+ */
+eer_hal_status_t eer_mcp2515_init(eer_mcp2515_t* can);
+
+/**
+ * @brief Stop the INT interrupt and put the controller in configuration mode
+ * @param can Controller instance
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t eer_mcp2515_deinit(eer_mcp2515_t* can);
+
+/**
+ * @brief Queue a frame in a free transmit buffer
+ * @param can Controller instance
+ * @param frame Frame, copied
+ * @param priority Transmit priority from 0 (lowest) to 3
+ * @return EER_HAL_OK if loaded, EER_HAL_BUSY if all three buffers are in use
+ */
+eer_hal_status_t eer_mcp2515_send(eer_mcp2515_t* can, const eer_can_frame_t* frame, uint8_t priority);
+
+/**
+ * @brief Take the oldest received frame
+ * @param can Controller instance
+ * @param frame Set to the frame
+ * @return true if a frame was taken, false if the ring is empty
+ */
+bool eer_mcp2515_receive(eer_mcp2515_t* can, eer_can_frame_t* frame);
+
+/**
+ * @brief Replace the acceptance masks and filters
+ *
+ * Passes through configuration mode, blocking, so frames on the bus are
+ * missed meanwhile. Returns EER_HAL_BUSY while the interrupt chain or a
+ * transmission is running.
+ *
+ * @param can Controller instance
+ * @param filter Apply the masks and filters; false receives every frame
+ * @param masks Masks of receive buffers 0 and 1
+ * @param filters Filters 0 to 5
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t eer_mcp2515_set_filters(eer_mcp2515_t* can, bool filter,
+                                         const eer_mcp2515_filter_t masks[2],
+                                         const eer_mcp2515_filter_t filters[6]);
@@ -0,0 +1,136 @@
+/**
+ * @file eer_modbus.h
+ * @brief Modbus RTU slave on a HAL UART and timer
+ *
+ * Frames are delimited by timing, as RTU requires: every received byte
+ * moves compare channel 0 of a free-running timer 3.5 character times
+ * ahead, so its match marks the silence that ends the frame. The receive
+ * callback stores the byte and adds it to the CRC; the compare callback
+ * then checks the finished CRC, runs the request against the user's tables
+ * and starts the response as an asynchronous UART request, all in
+ * interrupt context, so the reply follows the request by the minimum
+ * silence.
+ *
+ * The tables are plain arrays the application owns:
+ *
+ *     static uint16_t registers[8];
+ *     static uint8_t coils[2];
+ *     static eer_uart_t rs485 = eer_hal_uart0();
+ *     static eer_timer_t frame_timer = eer_hal_timer1();
+ *
+ *     static eer_modbus_t slave = {
+ *         .address = 17,
+ *         .uart = &rs485, .timer = &frame_timer,
+ *         .holding_registers = registers, .holding_register_count = 8,
+ *         .coils = coils, .coil_count = 16
+ *     };
+ *
+ *     eer_modbus_init(&slave, &uart_config);
+ *
+ * Writes by the master land in the tables from the interrupt; on_write
+ * reports them, e.g. to post an event. The main loop reads 16-bit
+ * registers with interrupts masked where that is not atomic.
+ *
+ * Supported functions: read coils (1), read discrete inputs (2), read
+ * holding registers (3), read input registers (4), write single coil (5),
+ * write single register (6), write multiple coils (15) and write multiple
+ * registers (16). Broadcasts (address 0) are executed without a response.
+ */
+#pragma once
+
+#include "eer_hal.h"
+#include "eer_hal_async.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Size of the frame buffer in bytes, 256 for any RTU frame
+ *
+ * Requests longer than the buffer are dropped; reads whose response does
+ * not fit are answered with EER_MODBUS_ILLEGAL_DATA_VALUE.
+ */
+#ifndef EER_MODBUS_FRAME_SIZE
+#define EER_MODBUS_FRAME_SIZE 256
+#endif
+
+/**
+ * @brief Frequency of the frame timer in Hz, where the platform lets it be set
+ */
+#ifndef EER_MODBUS_TIMER_FREQUENCY
+#define EER_MODBUS_TIMER_FREQUENCY 1000000UL
+#endif
+
+/**
+ * @brief Exception codes
+ */
+typedef enum {
+    EER_MODBUS_ILLEGAL_FUNCTION = 0x01,     /*!< Function code not supported */
+    EER_MODBUS_ILLEGAL_DATA_ADDRESS = 0x02, /*!< Range outside the table */
+    EER_MODBUS_ILLEGAL_DATA_VALUE = 0x03    /*!< Malformed quantity or value */
+} eer_modbus_exception_t;
+
+struct eer_modbus;
+
+/**
+ * @brief Write notification, called in interrupt context after the tables changed
+ * @param modbus Slave instance
+ * @param function Function code of the request
+ * @param address First coil or register written
+ * @param count Number of coils or registers written
+ * @param user_data User data of the instance
+ */
+typedef void (*eer_modbus_write_handler_t)(struct eer_modbus* modbus, uint8_t function,
+                                           uint16_t address, uint16_t count, void* user_data);
+
+/**
+ * @brief Modbus RTU slave instance
+ */
+typedef struct eer_modbus {
+    uint8_t           address;      /*!< Slave address, 1 to 247 */
+    void*             uart;         /*!< UART instance of the line */
+    void*             timer;        /*!< Timer instance; compare channel 0 delimits frames */
+    void*             de_pin;       /*!< RS-485 driver enable, high while sending, NULL for none */
+    
+    uint8_t*          coils;        /*!< Coils, eight per byte, LSB first */
+    uint16_t          coil_count;   /*!< Number of coils */
+    const uint8_t*    discrete_inputs;      /*!< Discrete inputs, eight per byte, LSB first */
+    uint16_t          discrete_input_count; /*!< Number of discrete inputs */
+    uint16_t*         holding_registers;    /*!< Holding registers */
+    uint16_t          holding_register_count; /*!< Number of holding registers */
+    const uint16_t*   input_registers;      /*!< Input registers */
+    uint16_t          input_register_count; /*!< Number of input registers */
+    eer_modbus_write_handler_t on_write;    /*!< Write notification, NULL for none */
+    void*             user_data;    /*!< User data passed to on_write */
+    
+    uint16_t          frames;       /*!< Requests answered or executed */
+    uint16_t          crc_errors;   /*!< Frames dropped for a bad CRC or length */
+    uint16_t          overruns;     /*!< Frames dropped for overflowing the buffer */
+    
+    uint8_t           frame[EER_MODBUS_FRAME_SIZE]; /*!< Managed by the driver: request, then response */
+    volatile uint16_t length;       /*!< Managed by the driver: bytes in frame */
+    volatile uint16_t crc;          /*!< Managed by the driver: CRC of the bytes received */
+    volatile uint8_t  state;        /*!< Managed by the driver */
+    uint16_t          silence;      /*!< Managed by the driver: 3.5 characters in timer ticks */
+    eer_async_request_t response;   /*!< Managed by the driver */
+} eer_modbus_t;
+
+/**
+ * @brief Start a slave
+ *
+ * Initializes the UART with the configuration and the timer as a
+ * free-running counter, registers the callbacks and drives de_pin low.
+ * The UART and timer belong to the slave until eer_modbus_deinit().
+ *
+ * @param modbus Slave instance with address, uart, timer and tables set
+ * @param config Line configuration; above 19200 baud the silence is the
+ *               fixed 1.75 ms of the specification
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t eer_modbus_init(eer_modbus_t* modbus, eer_uart_config_t* config);
+
+/**
+ * @brief Stop a slave and release its UART and timer
+ * @param modbus Slave instance
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t eer_modbus_deinit(eer_modbus_t* modbus);
@@ -0,0 +1,250 @@
+/**
+ * @file eer_nrf24.h
+ * @brief Interrupt-driven nRF24L01+ packet radio on the HAL SPI bus
+ *
+ * The radio pulls its IRQ line low when a packet arrives, a packet is
+ * acknowledged or the retries run out. The falling edge starts a chain of
+ * asynchronous SPI requests from the pin interrupt that clears the flags,
+ * drains the receive FIFO into a ring and refills the transmit FIFO from
+ * a queue in RAM, so STATUS is never polled. Every command returns STATUS
+ * as its first byte, which the chain uses instead of extra reads.
+ *
+ * Enhanced ShockBurst runs with auto-acknowledge and dynamic payloads on
+ * every pipe. Up to three packets wait in the transmit FIFO while CE stays
+ * high, so they go out back to back; when the last one is acknowledged CE
+ * drops and the radio idles in standby-I. Packets keep their slot in the
+ * queue until the radio has sent them. If a packet runs out of retries
+ * the transmit FIFO is flushed, failures counts it, and the packets that
+ * were behind it are loaded again. Payloads the receiver attaches to its
+ * acknowledgements are received on pipe 0.
+ *
+ * In a star network each node sends to its own address, and the hub
+ * listens for them on pipes 1 to 5:
+ *
+ *     static eer_nrf24_t radio = {
+ *         .device = { .cs = &radio_cs }, .ce = &radio_ce, .irq = &radio_irq,
+ *         .config = {
+ *             .channel = 76, .rate = EER_NRF24_1MBPS, .power = EER_NRF24_0DBM,
+ *             .retries = 5, .retry_delay = 1,
+ *             .address = { 0xC1, 0xE7, 0xE7, 0xE7, 0xE7 }
+ *         }
+ *     };
+ *
+ * A node spends most of its time asleep, with the radio powered down:
+ *
+ *     eer_nrf24_send(&radio, sample, sizeof(sample), 0);
+ *     while (!eer_nrf24_idle(&radio)) {}
+ *     eer_nrf24_sleep(&radio, EER_POWER_MODE_STANDBY);
+ */
+#pragma once
+
+#include "eer_hal.h"
+#include "eer_hal_async.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Packets in the receive ring, a power of two up to 128
+ */
+#ifndef EER_NRF24_RX_QUEUE_SIZE
+#define EER_NRF24_RX_QUEUE_SIZE 4
+#endif
+
+/**
+ * @brief Packets in the transmit queue, a power of two up to 128
+ *
+ * The three in the transmit FIFO count until they are sent.
+ */
+#ifndef EER_NRF24_TX_QUEUE_SIZE
+#define EER_NRF24_TX_QUEUE_SIZE 8
+#endif
+
+/**
+ * @brief Largest payload in bytes
+ */
+#define EER_NRF24_PAYLOAD_SIZE 32
+
+/**
+ * @brief Air data rates
+ */
+typedef enum {
+    EER_NRF24_1MBPS = 0x00,    /*!< 1 Mbit/s */
+    EER_NRF24_2MBPS = 0x08,    /*!< 2 Mbit/s */
+    EER_NRF24_250KBPS = 0x20   /*!< 250 kbit/s, longest range */
+} eer_nrf24_rate_t;
+
+/**
+ * @brief Transmit power
+ */
+typedef enum {
+    EER_NRF24_M18DBM = 0x00,   /*!< -18 dBm */
+    EER_NRF24_M12DBM = 0x02,   /*!< -12 dBm */
+    EER_NRF24_M6DBM = 0x04,    /*!< -6 dBm */
+    EER_NRF24_0DBM = 0x06      /*!< 0 dBm */
+} eer_nrf24_power_t;
+
+/**
+ * @brief Options of a sent packet
+ */
+typedef enum {
+    EER_NRF24_NO_ACK = 1 << 0  /*!< Send once, without asking for an acknowledgement */
+} eer_nrf24_send_flags_t;
+
+/**
+ * @brief Radio configuration
+ *
+ * Addresses are 5 bytes, least significant byte first. Pipes 2 to 5 share
+ * the upper four bytes of pipe 1 and differ in the first byte only.
+ */
+typedef struct {
+    uint8_t           channel;      /*!< RF channel, 2400 + channel MHz, up to 125 */
+    eer_nrf24_rate_t  rate;         /*!< Air data rate */
+    eer_nrf24_power_t power;        /*!< Transmit power */
+    uint8_t           retries;      /*!< Retransmissions before giving up, up to 15 */
+    uint8_t           retry_delay;  /*!< Delay between retransmissions in 250 us steps minus one, up to 15 */
+    uint8_t           address[5];   /*!< Transmit address, also received on pipe 0 for acknowledgements */
+    uint8_t           pipes;        /*!< Pipes 1 to 5 received besides pipe 0, one bit each */
+    uint8_t           pipe1[5];     /*!< Address of pipe 1 */
+    uint8_t           pipe_lsb[4];  /*!< First address byte of pipes 2 to 5 */
+} eer_nrf24_config_t;
+
+/**
+ * @brief Received packet
+ */
+typedef struct {
+    uint8_t           pipe;         /*!< Pipe it was received on */
+    uint8_t           size;         /*!< Payload size in bytes */
+    uint8_t           data[EER_NRF24_PAYLOAD_SIZE]; /*!< Payload */
+} eer_nrf24_packet_t;
+
+struct eer_nrf24;
+
+/**
+ * @brief Notification of a received packet, called in interrupt context
+ * @param radio Radio that queued the packet
+ * @param user_data User data of the radio
+ */
+typedef void (*eer_nrf24_handler_t)(struct eer_nrf24* radio, void* user_data);
+
+/**
+ * @brief Radio instance
+ */
+typedef struct eer_nrf24 {
+    eer_spi_device_t  device;       /*!< Chip select pin (CSN) and clock, at most 10 MHz */
+    void*             ce;           /*!< Chip enable pin */
+    void*             irq;          /*!< Pin on the IRQ output */
+    eer_nrf24_config_t config;      /*!< Configuration applied by eer_nrf24_init() */
+    eer_nrf24_handler_t on_receive; /*!< Called for each packet queued, NULL for none */
+    void*             user_data;    /*!< User data passed to on_receive */
+    
+    volatile uint8_t  rx_head;      /*!< Managed by the driver: next slot written by the interrupt */
+    volatile uint8_t  rx_tail;      /*!< Managed by the driver: next slot read */
+    volatile uint8_t  tx_head;      /*!< Managed by the driver: next slot queued */
+    volatile uint8_t  tx_tail;      /*!< Managed by the driver: oldest slot not yet sent */
+    volatile uint8_t  tx_load;      /*!< Managed by the driver: next slot loaded into the radio */
+    volatile uint8_t  dropped;      /*!< Packets lost to a full ring, saturating */
+    volatile uint8_t  failures;     /*!< Transmit FIFO flushes after the last retry, saturating */
+    volatile bool     servicing;    /*!< Managed by the driver: interrupt chain running */
+    volatile bool     again;        /*!< Managed by the driver: IRQ fell or work was queued during the chain */
+    volatile bool     listening;    /*!< Managed by the driver: receive while not sending */
+    uint8_t           config_register; /*!< Managed by the driver: CONFIG as last written */
+    uint8_t           step;         /*!< Managed by the driver */
+    uint8_t           flags;        /*!< Managed by the driver: interrupt flags of the round */
+    uint8_t           command[2];   /*!< Managed by the driver */
+    uint8_t           response[1 + EER_NRF24_PAYLOAD_SIZE]; /*!< Managed by the driver */
+    eer_async_request_t request;    /*!< Managed by the driver */
+    eer_nrf24_packet_t rx[EER_NRF24_RX_QUEUE_SIZE]; /*!< Managed by the driver */
+    uint8_t           tx[EER_NRF24_TX_QUEUE_SIZE][1 + EER_NRF24_PAYLOAD_SIZE]; /*!< Managed by the driver: command and payload */
+    uint8_t           tx_size[EER_NRF24_TX_QUEUE_SIZE]; /*!< Managed by the driver */
+} eer_nrf24_t;
+
+/**
+ * @brief Configure the radio and start the IRQ interrupt
+ *
+ * Blocks for the register writes and the 1.5 ms start-up, and leaves the
+ * radio in standby-I. The radio needs 100 ms after power-on before this
+ * call. The IRQ pin is configured as an input with pull-up, interrupting
+ * on its falling edge.
+ *
+ * @param radio Radio instance with the pins and config set
+ * @return Status code indicating success or failure, EER_HAL_TIMEOUT if
+ *         the radio did not answer
+ */
+eer_hal_status_t eer_nrf24_init(eer_nrf24_t* radio);
+
+/**
+ * @brief Stop the IRQ interrupt and power the radio down
+ * @param radio Radio instance
+ * @return Status code indicating success or failure, EER_HAL_BUSY while
+ *         packets are being sent
+ */
+eer_hal_status_t eer_nrf24_deinit(eer_nrf24_t* radio);
+
+/**
+ * @brief Queue a packet to the transmit address
+ * @param radio Radio instance
+ * @param data Payload, copied
+ * @param size Payload size, 1 to EER_NRF24_PAYLOAD_SIZE bytes
+ * @param flags eer_nrf24_send_flags_t options
+ * @return EER_HAL_OK if queued, EER_HAL_BUSY if the queue is full
+ */
+eer_hal_status_t eer_nrf24_send(eer_nrf24_t* radio, const uint8_t* data, uint8_t size, uint8_t flags);
+
+/**
+ * @brief Take the oldest received packet
+ * @param radio Radio instance
+ * @param packet Set to the packet
+ * @return true if a packet was taken, false if the ring is empty
+ */
+bool eer_nrf24_receive(eer_nrf24_t* radio, eer_nrf24_packet_t* packet);
+
+/**
+ * @brief Start or stop receiving
+ *
+ * A listening radio stays in RX mode with CE high, and switches to TX mode
+ * only while packets are queued.
+ *
+ * @param radio Radio instance
+ * @param listen true to receive
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t eer_nrf24_listen(eer_nrf24_t* radio, bool listen);
+
+/**
+ * @brief Check that nothing is queued, in flight or being serviced
+ * @param radio Radio instance
+ * @return true if the radio is idle
+ */
+bool eer_nrf24_idle(eer_nrf24_t* radio);
+
+/**
+ * @brief Power the radio down, blocking
+ *
+ * In power-down the radio draws about 1 uA, keeps its registers and
+ * neither sends nor receives.
+ *
+ * @param radio Radio instance
+ * @return Status code indicating success or failure, EER_HAL_BUSY unless
+ *         the radio is idle
+ */
+eer_hal_status_t eer_nrf24_power_down(eer_nrf24_t* radio);
+
+/**
+ * @brief Power the radio up, blocking for its 1.5 ms start-up
+ * @param radio Radio instance
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t eer_nrf24_power_up(eer_nrf24_t* radio);
+
+/**
+ * @brief Put the MCU to sleep with the radio in its lowest useful state
+ *
+ * A radio that is not listening is powered down for the sleep and powered
+ * up after it. A listening radio stays in RX mode, and a packet arriving
+ * wakes the MCU through the IRQ pin.
+ *
+ * @param radio Radio instance
+ * @param mode Power mode passed to the power HAL
+ * @return Status of the power HAL, EER_HAL_BUSY unless the radio is idle
+ */
+eer_hal_status_t eer_nrf24_sleep(eer_nrf24_t* radio, eer_power_mode_t mode);
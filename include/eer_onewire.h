@@ -0,0 +1,251 @@
+/**
+ * @file eer_onewire.h
+ * @brief Interrupt-driven 1-Wire master on a HAL timer and GPIO pin
+ *
+ * Every edge of a slot is placed by compare channel 0 of a free-running
+ * timer: the compare callback pulls the line low, releases it or samples
+ * it, then moves the compare to the next edge. Between edges the CPU is
+ * free, and interrupts are never held off for a slot; a phase that falls
+ * due while the callback still runs is executed at once instead of
+ * waiting for a full lap of the counter.
+ *
+ * The pin is driven like an open-drain output: configured as an output
+ * with its level low to pull the line down, and as a floating input to
+ * release it to the external pull-up.
+ *
+ * Transfers are requests, queued and chained like eer_async_request_t:
+ *
+ *     static const uint8_t convert_all[] = { EER_ONEWIRE_SKIP_ROM, EER_DS18B20_CONVERT_T };
+ *
+ *     static eer_onewire_request_t convert = {
+ *         .flags = EER_ONEWIRE_RESET,
+ *         .tx_data = convert_all, .tx_size = sizeof(convert_all),
+ *         .wait_ms = EER_DS18B20_CONVERSION_MS
+ *     };
+ *
+ *     eer_onewire_submit(&bus, &convert);
+ *
+ * On top of that, eer_onewire_search() enumerates the ROM codes on the bus
+ * one per call, and eer_onewire_convert() starts every DS18B20 at once with
+ * Skip ROM and reads them one after another when the conversion is over.
+ */
+#pragma once
+
+#include "eer_hal.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Frequency of the slot timer in Hz, where the platform lets it be set
+ */
+#ifndef EER_ONEWIRE_TIMER_FREQUENCY
+#define EER_ONEWIRE_TIMER_FREQUENCY 1000000UL
+#endif
+
+/*
+ * Slot timing in microseconds, standard speed
+ */
+#ifndef EER_ONEWIRE_WRITE1_LOW_US
+#define EER_ONEWIRE_WRITE1_LOW_US   6    /*!< Low time of a 1 and of a read slot */
+#endif
+#ifndef EER_ONEWIRE_WRITE0_LOW_US
+#define EER_ONEWIRE_WRITE0_LOW_US   60   /*!< Low time of a 0 */
+#endif
+#ifndef EER_ONEWIRE_READ_SAMPLE_US
+#define EER_ONEWIRE_READ_SAMPLE_US  15   /*!< Sample point of a read slot after its start */
+#endif
+#ifndef EER_ONEWIRE_SLOT_US
+#define EER_ONEWIRE_SLOT_US         70   /*!< Slot including recovery */
+#endif
+#ifndef EER_ONEWIRE_RESET_LOW_US
+#define EER_ONEWIRE_RESET_LOW_US    480  /*!< Reset pulse */
+#endif
+#ifndef EER_ONEWIRE_PRESENCE_US
+#define EER_ONEWIRE_PRESENCE_US     70   /*!< Presence sample after the reset pulse */
+#endif
+#ifndef EER_ONEWIRE_RESET_US
+#define EER_ONEWIRE_RESET_US        960  /*!< Reset pulse and presence window */
+#endif
+
+/*
+ * ROM commands
+ */
+#define EER_ONEWIRE_SEARCH_ROM   0xF0
+#define EER_ONEWIRE_READ_ROM     0x33
+#define EER_ONEWIRE_MATCH_ROM    0x55
+#define EER_ONEWIRE_SKIP_ROM     0xCC
+#define EER_ONEWIRE_ALARM_SEARCH 0xEC
+
+/*
+ * DS18B20 function commands
+ */
+#define EER_DS18B20_CONVERT_T       0x44
+#define EER_DS18B20_READ_SCRATCHPAD 0xBE
+
+/**
+ * @brief Conversion time of a DS18B20 at 12 bits
+ */
+#define EER_DS18B20_CONVERSION_MS   750
+
+/**
+ * @brief Temperature of a sensor that did not answer with a valid scratchpad
+ */
+#define EER_ONEWIRE_NO_TEMPERATURE  INT16_MIN
+
+/**
+ * @brief Request options
+ */
+typedef enum {
+    EER_ONEWIRE_RESET = 1 << 0,         /*!< Reset and presence pulse before the bytes */
+    EER_ONEWIRE_STRONG_PULLUP = 1 << 1, /*!< Drive the line high during wait_ms, for parasite power */
+    EER_ONEWIRE_SEARCH = 1 << 2         /*!< Managed by eer_onewire_search() */
+} eer_onewire_flags_t;
+
+struct eer_onewire_request;
+
+/**
+ * @brief Completion callback, called in interrupt context
+ * @param request Completed request, status holds the result
+ * @param user_data User data of the request
+ */
+typedef void (*eer_onewire_handler_t)(struct eer_onewire_request* request, void* user_data);
+
+/**
+ * @brief Transfer on a 1-Wire bus
+ *
+ * Writes tx_size bytes, then reads rx_size bytes, both LSB first, after a
+ * reset if EER_ONEWIRE_RESET is set, then holds the bus idle for wait_ms.
+ * Completes with EER_HAL_ERROR if no device answered the reset.
+ */
+typedef struct eer_onewire_request {
+    uint8_t           flags;     /*!< eer_onewire_flags_t options */
+    const uint8_t*    tx_data;   /*!< Bytes to write, NULL if tx_size is 0 */
+    uint16_t          tx_size;   /*!< Number of bytes to write */
+    uint8_t*          rx_data;   /*!< Buffer for the bytes read, NULL if rx_size is 0 */
+    uint16_t          rx_size;   /*!< Number of bytes to read */
+    uint16_t          wait_ms;   /*!< Time the bus stays held after the bytes, e.g. for a conversion */
+    volatile eer_hal_status_t status; /*!< EER_HAL_BUSY until complete, then the result */
+    eer_onewire_handler_t handler; /*!< Completion handler, NULL for none */
+    void*             user_data; /*!< User data passed to the handler */
+    struct eer_onewire_request* next; /*!< Request submitted on success, NULL ends the pipeline */
+    
+    struct eer_onewire_request* queued; /*!< Managed by the driver */
+    uint16_t          index;     /*!< Managed by the driver: bytes transferred */
+} eer_onewire_request_t;
+
+/**
+ * @brief 1-Wire bus instance
+ */
+typedef struct {
+    void*             pin;          /*!< Data line, with an external pull-up */
+    void*             timer;        /*!< Timer instance; compare channel 0 places the slot edges */
+    
+    eer_onewire_request_t* head;    /*!< Managed by the driver: running request */
+    eer_onewire_request_t* tail;    /*!< Managed by the driver: last request */
+    volatile uint8_t  phase;        /*!< Managed by the driver */
+    uint8_t           slot;         /*!< Managed by the driver: kind of the running slot */
+    uint8_t           bit;          /*!< Managed by the driver: bit of the current byte */
+    uint8_t           triplet;      /*!< Managed by the driver: slot of a search triplet */
+    uint8_t           sample;       /*!< Managed by the driver: bits read in a search triplet */
+    uint8_t           last_zero;    /*!< Managed by the driver: last search discrepancy taking 0 */
+    uint16_t          deadline;     /*!< Managed by the driver: counter value of the next edge */
+    uint32_t          wait;         /*!< Managed by the driver: ticks left of wait_ms */
+    uint16_t          ticks[11];    /*!< Managed by the driver: timing in timer ticks, 0 while stopped */
+} eer_onewire_t;
+
+/**
+ * @brief ROM search state, zero-initialized to start from the first device
+ */
+typedef struct {
+    uint8_t           command;      /*!< EER_ONEWIRE_SEARCH_ROM, or EER_ONEWIRE_ALARM_SEARCH; 0 for the former */
+    uint8_t           rom[8];       /*!< ROM code found by the last step, family code first */
+    bool              done;         /*!< The last device was found */
+    eer_onewire_handler_t handler;  /*!< Called when a step completes, NULL for none */
+    void*             user_data;    /*!< User data passed to the handler */
+    
+    uint8_t           last_discrepancy; /*!< Managed by the driver */
+    eer_onewire_request_t request;  /*!< Managed by the driver */
+} eer_onewire_search_t;
+
+struct eer_onewire_convert;
+
+/**
+ * @brief Conversion callback, called in interrupt context with every result in
+ * @param convert Conversion that completed
+ */
+typedef void (*eer_onewire_convert_handler_t)(struct eer_onewire_convert* convert);
+
+/**
+ * @brief Temperature conversion of a set of DS18B20 sensors
+ */
+typedef struct eer_onewire_convert {
+    const uint8_t   (*roms)[8];     /*!< ROM codes of the sensors, e.g. from eer_onewire_search() */
+    uint8_t           count;        /*!< Number of sensors */
+    int16_t*          temperatures; /*!< Results in 1/16 °C, EER_ONEWIRE_NO_TEMPERATURE for a failed read */
+    uint16_t          conversion_ms; /*!< Conversion time, 0 for EER_DS18B20_CONVERSION_MS */
+    bool              parasite;     /*!< Sensors powered from the line: strong pull-up while converting */
+    eer_onewire_convert_handler_t handler; /*!< Called when all results are in, NULL for none */
+    void*             user_data;    /*!< User data of the application */
+    
+    volatile bool     busy;         /*!< Managed by the driver: conversion or reads running */
+    eer_onewire_t*    bus;          /*!< Managed by the driver */
+    uint8_t           sensor;       /*!< Managed by the driver: sensor being read */
+    uint8_t           command[10];  /*!< Managed by the driver */
+    uint8_t           scratchpad[9]; /*!< Managed by the driver */
+    eer_onewire_request_t request;  /*!< Managed by the driver */
+} eer_onewire_convert_t;
+
+/**
+ * @brief Start a bus
+ *
+ * Initializes the timer as a free-running counter, releases the line and
+ * registers the compare callback. The timer belongs to the bus until
+ * eer_onewire_deinit().
+ *
+ * @param bus Bus instance with pin and timer set
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t eer_onewire_init(eer_onewire_t* bus);
+
+/**
+ * @brief Stop a bus, completing queued requests with EER_HAL_ERROR
+ * @param bus Bus instance
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t eer_onewire_deinit(eer_onewire_t* bus);
+
+/**
+ * @brief Queue a request on a bus
+ * @param bus Bus instance
+ * @param request Request, owned by the driver until it completes
+ * @return EER_HAL_OK if queued, EER_HAL_BUSY if it is still pending,
+ *         EER_HAL_INVALID_PARAM for a malformed request
+ */
+eer_hal_status_t eer_onewire_submit(eer_onewire_t* bus, eer_onewire_request_t* request);
+
+/**
+ * @brief Find the next device on the bus
+ *
+ * Runs one pass of the ROM search. On completion rom holds the code of the
+ * device found and the handler is called with EER_HAL_OK; EER_HAL_ERROR
+ * means no device answered or the code failed its CRC. done is set with
+ * the last device; the next call starts over from the first.
+ *
+ * @param bus Bus instance
+ * @param search Search state
+ * @return Status code of the submit
+ */
+eer_hal_status_t eer_onewire_search(eer_onewire_t* bus, eer_onewire_search_t* search);
+
+/**
+ * @brief Start a conversion on every sensor and collect the results
+ *
+ * Sends Convert T to all sensors with Skip ROM, keeps the bus idle for the
+ * conversion time, then reads the scratchpad of each sensor in roms into
+ * temperatures. busy is cleared and the handler called after the last.
+ *
+ * @param bus Bus instance
+ * @param convert Conversion with roms, count and temperatures set
+ * @return Status code of the submit, EER_HAL_BUSY while a conversion runs
+ */
+eer_hal_status_t eer_onewire_convert(eer_onewire_t* bus, eer_onewire_convert_t* convert);
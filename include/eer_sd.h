@@ -0,0 +1,194 @@
+/**
+ * @file eer_sd.h
+ * @brief SD card block device over the HAL SPI bus
+ *
+ * The card is brought up at 1/128 of the clock, below the 400 kHz the
+ * specification allows before initialization, then runs at the clock of
+ * device (1/2 by default). Standard and high capacity cards are
+ * supported; sectors are always 512 bytes.
+ *
+ * Transfers of several sectors run as one multi-block command, CMD18 or
+ * CMD25, so the card pays its command and programming overhead once per
+ * run instead of once per sector. Writes announce their length with
+ * ACMD23 so the card can pre-erase.
+ *
+ * Sectors move either with the blocking eer_sd_read() and eer_sd_write(),
+ * which exchange each block with one tight SPI transfer, or with
+ * eer_sd_submit(), which runs the same protocol as a sequence of
+ * asynchronous SPI requests from the SPI interrupt:
+ *
+ *     static uint8_t samples[4 * EER_SD_SECTOR_SIZE];
+ *     static eer_sd_request_t log_write = {
+ *         .write = true, .data = samples, .count = 4
+ *     };
+ *
+ *     log_write.sector = next_sector;
+ *     eer_sd_submit(&card, &log_write);
+ *
+ * The card keeps chip select asserted for a whole transfer, so
+ * eer_sd_submit() reserves the SPI bus: requests of other devices submitted
+ * meanwhile wait until the transfer completes. A run of blocks that fails
+ * is still ended with CMD12 or the stop token.
+ *
+ * With cache set, eer_sd_cache() keeps one sector in RAM for small reads
+ * and read-modify-write updates, written back by eer_sd_flush() or when
+ * another sector is loaded.
+ */
+#pragma once
+
+#include "eer_hal.h"
+#include "eer_hal_async.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Size of a sector in bytes
+ */
+#define EER_SD_SECTOR_SIZE 512
+
+/**
+ * @brief Bytes polled for a data token before a read fails, about 100 ms at 8 MHz
+ */
+#ifndef EER_SD_TOKEN_POLLS
+#define EER_SD_TOKEN_POLLS 100000UL
+#endif
+
+/**
+ * @brief Bytes polled while the card is busy programming, about 500 ms at 8 MHz
+ */
+#ifndef EER_SD_BUSY_POLLS
+#define EER_SD_BUSY_POLLS 500000UL
+#endif
+
+/**
+ * @brief Time the card gets to leave the idle state
+ */
+#ifndef EER_SD_INIT_TIMEOUT_MS
+#define EER_SD_INIT_TIMEOUT_MS 1000
+#endif
+
+/**
+ * @brief Card types
+ */
+typedef enum {
+    EER_SD_TYPE_NONE,  /*!< Not initialized */
+    EER_SD_TYPE_V1,    /*!< SD version 1, byte addressing */
+    EER_SD_TYPE_V2,    /*!< SD version 2 standard capacity, byte addressing */
+    EER_SD_TYPE_HC     /*!< SDHC or SDXC, sector addressing */
+} eer_sd_type_t;
+
+struct eer_sd_request;
+
+/**
+ * @brief Completion callback, called in interrupt context
+ * @param request Completed request, status holds the result
+ * @param user_data User data of the request
+ */
+typedef void (*eer_sd_handler_t)(struct eer_sd_request* request, void* user_data);
+
+/**
+ * @brief Asynchronous sector transfer
+ */
+typedef struct eer_sd_request {
+    uint32_t          sector;    /*!< First sector */
+    uint16_t          count;     /*!< Number of sectors */
+    uint8_t*          data;      /*!< count * EER_SD_SECTOR_SIZE bytes to read into or write */
+    bool              write;     /*!< Write the sectors instead of reading them */
+    volatile eer_hal_status_t status; /*!< EER_HAL_BUSY until complete, then the result */
+    eer_sd_handler_t  handler;   /*!< Completion handler, NULL for none */
+    void*             user_data; /*!< User data passed to the handler */
+} eer_sd_request_t;
+
+/**
+ * @brief SD card instance
+ */
+typedef struct {
+    eer_spi_device_t  device;       /*!< Chip select pin and clock after initialization */
+    uint8_t*          cache;        /*!< EER_SD_SECTOR_SIZE bytes for eer_sd_cache(), NULL for none */
+    
+    eer_sd_type_t     type;         /*!< Managed by the driver: card found by eer_sd_init() */
+    uint32_t          cached;       /*!< Managed by the driver: sector in cache */
+    bool              cache_valid;  /*!< Managed by the driver: cache holds cached */
+    bool              cache_dirty;  /*!< Managed by the driver: cache differs from the card */
+    
+    eer_sd_request_t* volatile request; /*!< Managed by the driver: running transfer */
+    uint8_t           step;         /*!< Managed by the driver */
+    uint16_t          block;        /*!< Managed by the driver: sectors transferred */
+    uint32_t          polls;        /*!< Managed by the driver: bytes polled in the step */
+    eer_hal_status_t  result;       /*!< Managed by the driver: first failure of the transfer */
+    uint8_t           command[6];   /*!< Managed by the driver */
+    uint8_t           response[16]; /*!< Managed by the driver */
+    eer_async_request_t spi;        /*!< Managed by the driver: command and poll bytes */
+    eer_async_request_t spi_data;   /*!< Managed by the driver: sector */
+    eer_async_request_t spi_tail;   /*!< Managed by the driver: CRC and data response */
+} eer_sd_t;
+
+/**
+ * @brief Initialize the SPI bus and the card
+ *
+ * Runs the power-up sequence (CMD0, CMD8, ACMD41, CMD58) at low speed,
+ * sets 512-byte blocks on byte-addressed cards; later transfers run at the
+ * card's clock. Blocks for up to EER_SD_INIT_TIMEOUT_MS.
+ *
+ * @param sd Card instance with device.cs set
+ * @return EER_HAL_OK, EER_HAL_TIMEOUT if no card answered or it stayed
+ *         idle, EER_HAL_NOT_SUPPORTED for an unusable card
+ */
+eer_hal_status_t eer_sd_init(eer_sd_t* sd);
+
+/**
+ * @brief Read sectors, blocking
+ * @param sd Card instance
+ * @param sector First sector
+ * @param data Buffer of count * EER_SD_SECTOR_SIZE bytes
+ * @param count Number of sectors
+ * @return Status code indicating success or failure, EER_HAL_BUSY while
+ *         a request runs on the card or the bus
+ */
+eer_hal_status_t eer_sd_read(eer_sd_t* sd, uint32_t sector, uint8_t* data, uint16_t count);
+
+/**
+ * @brief Write sectors, blocking
+ * @param sd Card instance
+ * @param sector First sector
+ * @param data count * EER_SD_SECTOR_SIZE bytes
+ * @param count Number of sectors
+ * @return Status code indicating success or failure, EER_HAL_BUSY while
+ *         a request runs on the card or the bus
+ */
+eer_hal_status_t eer_sd_write(eer_sd_t* sd, uint32_t sector, const uint8_t* data, uint16_t count);
+
+/**
+ * @brief Start an asynchronous transfer
+ *
+ * A dirty cached sector inside a read is flushed first, blocking; a cached
+ * sector inside a write is dropped.
+ *
+ * @param sd Card instance
+ * @param request Request, owned by the driver until it completes
+ * @return EER_HAL_OK if started, EER_HAL_BUSY while another one runs or
+ *         another device holds the bus
+ */
+eer_hal_status_t eer_sd_submit(eer_sd_t* sd, eer_sd_request_t* request);
+
+/**
+ * @brief Load a sector into the cache, writing back the one it held if dirty
+ * @param sd Card instance with cache set
+ * @param sector Sector
+ * @param data Set to the cached sector, valid until the next eer_sd_cache()
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t eer_sd_cache(eer_sd_t* sd, uint32_t sector, uint8_t** data);
+
+/**
+ * @brief Mark the cached sector as modified
+ * @param sd Card instance
+ */
+void eer_sd_cache_dirty(eer_sd_t* sd);
+
+/**
+ * @brief Write the cached sector back if it was modified
+ * @param sd Card instance
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t eer_sd_flush(eer_sd_t* sd);
@@ -0,0 +1,53 @@
+/**
+ * @file eer_spi_device.h
+ * @brief Devices sharing the HAL SPI bus
+ *
+ * Every device on the bus is an eer_spi_device_t with its chip select pin
+ * and its clock. eer_spi_device_init() brings up the bus and parks the
+ * chip select; the bus then switches to the device's clock for each of its
+ * transfers instead of keeping that of the last init, so a slow device
+ * does not hold back a fast one:
+ *
+ *     static eer_pin_t flash_cs = eer_hal_pin(B, 2);
+ *     static eer_spi_device_t flash = {
+ *         .cs = &flash_cs, .prescaler = EER_SPI_PRESCALER_4
+ *     };
+ *
+ *     eer_spi_device_init(&flash);
+ *
+ *     eer_spi_device_select(&flash);
+ *     eer_hal_call(spi, transfer, command, response, sizeof(command), 0);
+ *     eer_spi_device_deselect(&flash);
+ *
+ * Asynchronous requests take the device in their device field, see
+ * eer_hal_async.h.
+ */
+#pragma once
+
+#include "eer_hal.h"
+
+/**
+ * @brief Initialize the bus for a device and set up its chip select
+ *
+ * Configures the bus as master in mode 0, MSB first, and the chip select
+ * pin as an output, deasserted. Devices sharing the bus each call it.
+ *
+ * @param device Device with cs set
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t eer_spi_device_init(const eer_spi_device_t* device);
+
+/**
+ * @brief Switch the bus to the device's clock and assert its chip select
+ * @param device Device
+ * @return Status code indicating success or failure, EER_HAL_BUSY while
+ *         requests run on the bus
+ */
+eer_hal_status_t eer_spi_device_select(const eer_spi_device_t* device);
+
+/**
+ * @brief Deassert the device's chip select
+ * @param device Device
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t eer_spi_device_deselect(const eer_spi_device_t* device);
@@ -0,0 +1,239 @@
+/**
+ * @file eer_tft.h
+ * @brief Framebuffer-less drawing on ST7735-class SPI TFT panels
+ *
+ * A 160x128 RGB565 frame takes 40 KiB, more than an AVR has, so nothing is
+ * drawn into RAM. Each primitive sets the panel's address window once and
+ * streams its pixels: a run of one color, a list of run-length spans, or
+ * 1-bit glyph bitmaps expanded from program memory as they are sent.
+ *
+ * Pixels are generated into one of two small chunk buffers while the other
+ * is transmitted by an asynchronous SPI request, so producing the next
+ * chunk overlaps sending the last one. A primitive returns once its last
+ * chunk is queued; the next one waits for the bus before it moves the
+ * window.
+ *
+ * Without a framebuffer, redrawing is done by the application. With dirty
+ * rectangles it only redraws what changed:
+ *
+ *     static void draw_screen(eer_tft_t* tft, void* user_data) {
+ *         eer_tft_fill(tft, 0, 0, 160, 128, EER_TFT_BLACK);
+ *         eer_tft_text(tft, 4, 4, label, &font_5x8, EER_TFT_WHITE, EER_TFT_BLACK);
+ *     }
+ *
+ *     eer_tft_invalidate(&tft, 4, 4, 60, 8);
+ *     eer_tft_render(&tft, draw_screen, NULL);
+ *
+ * During eer_tft_render() every primitive is clipped to the bounding box of
+ * the invalidated regions, so only those pixels cross the bus.
+ */
+#pragma once
+
+#include "eer_hal.h"
+#include "eer_hal_async.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Bytes in each of the two chunk buffers, even and at most 254
+ */
+#ifndef EER_TFT_CHUNK
+#define EER_TFT_CHUNK 64
+#endif
+
+/**
+ * @brief RGB565 color from 8-bit components
+ */
+#define EER_TFT_RGB(r, g, b) \
+    ((uint16_t)((((r) & 0xF8) << 8) | (((g) & 0xFC) << 3) | ((b) >> 3)))
+
+#define EER_TFT_BLACK 0x0000
+#define EER_TFT_WHITE 0xFFFF
+#define EER_TFT_RED   0xF800
+#define EER_TFT_GREEN 0x07E0
+#define EER_TFT_BLUE  0x001F
+
+/*
+ * Panel commands
+ */
+#define EER_TFT_SWRESET 0x01
+#define EER_TFT_SLPOUT  0x11
+#define EER_TFT_DISPON  0x29
+#define EER_TFT_CASET   0x2A
+#define EER_TFT_RASET   0x2B
+#define EER_TFT_RAMWR   0x2C
+#define EER_TFT_MADCTL  0x36
+#define EER_TFT_COLMOD  0x3A
+
+/**
+ * @brief Run of pixels of one color
+ */
+typedef struct {
+    uint16_t          color;     /*!< RGB565 color */
+    uint16_t          length;    /*!< Number of pixels */
+} eer_tft_span_t;
+
+/**
+ * @brief Bitmap font in program memory (PROGMEM on AVR)
+ *
+ * Each glyph is height rows of (width + 7) / 8 bytes, leftmost pixel in the
+ * most significant bit, glyphs stored in character order from first.
+ */
+typedef struct {
+    const uint8_t*    bitmaps;   /*!< Glyphs, in program memory */
+    uint8_t           width;     /*!< Glyph width in pixels, spacing included */
+    uint8_t           height;    /*!< Glyph height in pixels */
+    uint8_t           first;     /*!< Character of the first glyph */
+    uint8_t           count;     /*!< Number of glyphs */
+} eer_tft_font_t;
+
+/**
+ * @brief Panel instance
+ */
+typedef struct {
+    eer_spi_device_t  device;       /*!< Chip select pin and clock, EER_SPI_PRESCALER_2 if zeroed */
+    void*             dc;           /*!< Data/command pin, low for commands */
+    void*             reset;        /*!< Reset pin, NULL if not connected */
+    uint16_t          width;        /*!< Width in pixels in the chosen orientation */
+    uint16_t          height;       /*!< Height in pixels in the chosen orientation */
+    uint8_t           x_offset;     /*!< First visible column of the controller */
+    uint8_t           y_offset;     /*!< First visible row of the controller */
+    uint8_t           madctl;       /*!< Memory access control: orientation and RGB/BGR order */
+    
+    uint16_t          clip_x0;      /*!< Managed by the driver: drawing limits, ends exclusive */
+    uint16_t          clip_y0;      /*!< Managed by the driver */
+    uint16_t          clip_x1;      /*!< Managed by the driver */
+    uint16_t          clip_y1;      /*!< Managed by the driver */
+    uint16_t          dirty_x0;     /*!< Managed by the driver: invalidated region, ends exclusive */
+    uint16_t          dirty_y0;     /*!< Managed by the driver */
+    uint16_t          dirty_x1;     /*!< Managed by the driver */
+    uint16_t          dirty_y1;     /*!< Managed by the driver */
+    bool              dirty;        /*!< Managed by the driver: a region is invalidated */
+    uint8_t           chunk;        /*!< Managed by the driver: buffer being filled */
+    uint8_t           fill;         /*!< Managed by the driver: bytes in that buffer */
+    eer_hal_status_t  status;       /*!< Managed by the driver: first failure of the primitive being drawn */
+    uint8_t           buffer[2][EER_TFT_CHUNK]; /*!< Managed by the driver */
+    eer_async_request_t request[2]; /*!< Managed by the driver: transmission of each buffer */
+} eer_tft_t;
+
+/**
+ * @brief Application drawing of the screen, called by eer_tft_render()
+ * @param tft Panel instance
+ * @param user_data User data passed to eer_tft_render()
+ */
+typedef void (*eer_tft_draw_t)(eer_tft_t* tft, void* user_data);
+
+/**
+ * @brief Initialize the SPI bus and the panel
+ *
+ * Resets the panel, leaves sleep, selects 16-bit color and the orientation
+ * in madctl, and turns the display on. Panel-specific settings such as gamma
+ * or inversion can follow with eer_tft_command().
+ *
+ * @param tft Panel instance with the pins and size set
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t eer_tft_init(eer_tft_t* tft);
+
+/**
+ * @brief Send a command and its parameters, blocking
+ * @param tft Panel instance
+ * @param command Command byte
+ * @param parameters Parameter bytes, NULL if size is 0
+ * @param size Number of parameter bytes
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t eer_tft_command(eer_tft_t* tft, uint8_t command, const uint8_t* parameters, uint8_t size);
+
+/**
+ * @brief Fill a rectangle with one color
+ * @param tft Panel instance
+ * @param x Left column
+ * @param y Top row
+ * @param width Width in pixels
+ * @param height Height in pixels
+ * @param color RGB565 color
+ * @return Status code indicating success or failure; a chunk the bus did
+ *         not accept is dropped and its status returned
+ */
+eer_hal_status_t eer_tft_fill(eer_tft_t* tft, uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t color);
+
+/**
+ * @brief Stream run-length spans into a rectangle, row by row
+ *
+ * Spans may cross rows; pixels past the rectangle are dropped, and pixels
+ * of the rectangle not covered by the spans are left as they were.
+ *
+ * @param tft Panel instance
+ * @param x Left column
+ * @param y Top row
+ * @param width Width in pixels
+ * @param height Height in pixels
+ * @param spans Spans in drawing order
+ * @param count Number of spans
+ * @return Status code as for eer_tft_fill()
+ */
+eer_hal_status_t eer_tft_spans(eer_tft_t* tft, uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                               const eer_tft_span_t* spans, uint16_t count);
+
+/**
+ * @brief Draw a 1-bit bitmap from program memory
+ * @param tft Panel instance
+ * @param x Left column
+ * @param y Top row
+ * @param width Width in pixels
+ * @param height Height in pixels
+ * @param bitmap Rows of (width + 7) / 8 bytes, most significant bit first
+ * @param foreground Color of set bits
+ * @param background Color of clear bits
+ * @return Status code as for eer_tft_fill()
+ */
+eer_hal_status_t eer_tft_bitmap(eer_tft_t* tft, uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                                const uint8_t* bitmap, uint16_t foreground, uint16_t background);
+
+/**
+ * @brief Draw a string through one address window
+ *
+ * Characters without a glyph in the font are drawn as background.
+ *
+ * @param tft Panel instance
+ * @param x Left column
+ * @param y Top row
+ * @param text Zero-terminated string
+ * @param font Font
+ * @param foreground Color of the glyphs
+ * @param background Color around them
+ * @return Status code as for eer_tft_fill()
+ */
+eer_hal_status_t eer_tft_text(eer_tft_t* tft, uint16_t x, uint16_t y, const char* text,
+                              const eer_tft_font_t* font, uint16_t foreground, uint16_t background);
+
+/**
+ * @brief Mark a region as changed for the next eer_tft_render()
+ * @param tft Panel instance
+ * @param x Left column
+ * @param y Top row
+ * @param width Width in pixels
+ * @param height Height in pixels
+ */
+void eer_tft_invalidate(eer_tft_t* tft, uint16_t x, uint16_t y, uint16_t width, uint16_t height);
+
+/**
+ * @brief Redraw the invalidated region
+ *
+ * Calls draw with every primitive clipped to the bounding box of the
+ * regions invalidated since the last render, then clears it. Does nothing
+ * if no region is invalidated.
+ *
+ * @param tft Panel instance
+ * @param draw Drawing of the whole screen
+ * @param user_data User data passed to draw
+ */
+void eer_tft_render(eer_tft_t* tft, eer_tft_draw_t draw, void* user_data);
+
+/**
+ * @brief Wait until every queued pixel has been sent
+ * @param tft Panel instance
+ * @return Status code of queuing the last chunk, or of the transmissions
+ */
+eer_hal_status_t eer_tft_flush(eer_tft_t* tft);
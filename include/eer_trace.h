@@ -0,0 +1,192 @@
+/**
+ * @file eer_trace.h
+ * @brief Binary event trace of the HAL drivers
+ *
+ * Drivers record an event at their API entry points and interrupt handlers
+ * into a RAM ring of fixed-size records: a 16-bit timestamp, an event ID and
+ * a 16-bit argument. Each field has its own array indexed by the 8-bit
+ * head, so a record is a few plain stores with no slot address to compute
+ * beyond the index. The ring keeps the last EER_TRACE_SIZE events, so after
+ * a fault it holds the order of interrupts and transfers that led there.
+ * eer_trace_dump() sends it over the UART in binary; tools/eer_trace.py turns
+ * the dump into a timeline.
+ *
+ * Tracing is compiled in with EER_HAL_TRACE. Without it eer_trace() and
+ * eer_trace_isr() expand to nothing, and no buffer or code is linked.
+ *
+ * eer_trace_isr(), used in interrupt handlers, claims the next slot with a
+ * plain increment, as handlers do not nest. eer_trace() claims it with
+ * interrupts masked through eer_trace_lock(), restoring the previous mask
+ * right after the increment of the slot index; it fills the record with
+ * interrupts enabled, so a handler interrupting it records into the
+ * following slot. The cost of both is measured by the bench_cycles
+ * benchmark as trace_record_isr and trace_record.
+ *
+ * Timestamp: the high byte is the system tick (1 ms) modulo 256, the low
+ * byte the position within the tick in 1/EER_TRACE_SUB_PER_TICK steps. It
+ * wraps every 256 ticks; the viewer unwraps it as long as consecutive
+ * records are less than 256 ticks apart.
+ */
+#pragma once
+
+#include "eer_hal_errors.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Number of records in the ring, a power of two up to 256
+ */
+#ifndef EER_TRACE_SIZE
+#define EER_TRACE_SIZE 64
+#endif
+
+/**
+ * @brief Trace events
+ *
+ * The values are part of the dump format; append new events, do not
+ * renumber. The viewer reads the names from this enum.
+ */
+typedef enum {
+    EER_TRACE_NONE           = 0x00, /*!< Empty slot */
+    EER_TRACE_GPIO_IRQ       = 0x01, /*!< Pin interrupt, argument: port << 8 | pin mask */
+    EER_TRACE_ADC_START      = 0x02, /*!< Conversion started, argument: channel */
+    EER_TRACE_ADC_COMPLETE   = 0x03, /*!< Conversion complete interrupt, argument: result */
+    EER_TRACE_UART_TRANSMIT  = 0x04, /*!< Transmit call, argument: size */
+    EER_TRACE_UART_RECEIVE   = 0x05, /*!< Receive call, argument: size */
+    EER_TRACE_UART_RX_IRQ    = 0x06, /*!< Byte received, argument: UART << 8 | byte */
+    EER_TRACE_UART_TX_IRQ    = 0x07, /*!< Transmit complete, argument: UART */
+    EER_TRACE_SPI_TRANSFER   = 0x08, /*!< Transfer call, argument: size */
+    EER_TRACE_SPI_IRQ        = 0x09, /*!< Transfer complete interrupt, argument: byte */
+    EER_TRACE_I2C_TRANSMIT   = 0x0A, /*!< Master transmit call, argument: address */
+    EER_TRACE_I2C_RECEIVE    = 0x0B, /*!< Master receive call, argument: address */
+    EER_TRACE_I2C_ERROR      = 0x0C, /*!< Transfer failed, argument: bus status, address on the host */
+    EER_TRACE_TIMER_START    = 0x0D, /*!< Timer started, argument: timer */
+    EER_TRACE_TIMER_STOP     = 0x0E, /*!< Timer stopped, argument: timer */
+    EER_TRACE_TIMER_OVERFLOW = 0x0F, /*!< Overflow interrupt, argument: timer */
+    EER_TRACE_TIMER_COMPARE  = 0x10, /*!< Compare interrupt, argument: timer << 8 | channel */
+    EER_TRACE_TIMER_CAPTURE  = 0x11, /*!< Capture interrupt, argument: captured count */
+    EER_TRACE_POWER_SLEEP    = 0x12, /*!< Entering sleep, argument: platform sleep mode */
+    EER_TRACE_POWER_WAKEUP   = 0x13, /*!< Wake-up event, argument: source << 8 | pin or ID */
+    EER_TRACE_NVS_READ       = 0x14, /*!< Read call, argument: address */
+    EER_TRACE_NVS_WRITE      = 0x15, /*!< Write call, argument: address */
+    EER_TRACE_NVS_READY      = 0x16, /*!< Writes complete, argument: flash page, 0 for EEPROM */
+    EER_TRACE_USER           = 0x80  /*!< First ID free for application events */
+} eer_trace_event_t;
+
+/**
+ * @brief One trace record
+ */
+typedef struct {
+    uint16_t timestamp;  /*!< Tick modulo 256 << 8 | position within the tick */
+    uint8_t  event;      /*!< Event ID, see eer_trace_event_t */
+    uint16_t argument;   /*!< Event argument */
+} eer_trace_record_t;
+
+#ifdef EER_HAL_TRACE
+
+#include "trace.h"
+
+#if EER_TRACE_SIZE > 256 || (EER_TRACE_SIZE & (EER_TRACE_SIZE - 1)) != 0
+#error "EER_TRACE_SIZE must be a power of two up to 256"
+#endif
+
+/*
+ * Ring state, one array per record field, accessed by the inline recorders
+ * only
+ */
+extern uint16_t eer_trace_timestamps[EER_TRACE_SIZE];
+extern uint8_t eer_trace_events[EER_TRACE_SIZE];
+extern uint16_t eer_trace_arguments[EER_TRACE_SIZE];
+extern volatile uint8_t eer_trace_head;
+extern volatile bool eer_trace_enabled;
+
+/**
+ * @brief Fill the record at a slot
+ */
+static inline void eer_trace_store(uint8_t index, uint8_t event, uint16_t argument) {
+    eer_trace_timestamps[index] = eer_trace_timestamp();
+    eer_trace_events[index] = event;
+    eer_trace_arguments[index] = argument;
+}
+
+/**
+ * @brief Record an event from an interrupt handler
+ */
+static inline void eer_trace_record_isr(uint8_t event, uint16_t argument) {
+    if (!eer_trace_enabled) {
+        return;
+    }
+    
+    uint8_t index = eer_trace_head;
+    eer_trace_head = (index + 1) & (EER_TRACE_SIZE - 1);
+    eer_trace_store(index, event, argument);
+}
+
+/**
+ * @brief Record an event from code interrupts may preempt
+ */
+static inline void eer_trace_record(uint8_t event, uint16_t argument) {
+    if (!eer_trace_enabled) {
+        return;
+    }
+    
+    eer_trace_lock_t lock = eer_trace_lock();
+    uint8_t index = eer_trace_head;
+    eer_trace_head = (index + 1) & (EER_TRACE_SIZE - 1);
+    eer_trace_unlock(lock);
+    
+    eer_trace_store(index, event, argument);
+}
+
+#define eer_trace(event, argument) eer_trace_record((event), (argument))
+#define eer_trace_isr(event, argument) eer_trace_record_isr((event), (argument))
+
+/**
+ * @brief Resume recording
+ */
+void eer_trace_start(void);
+
+/**
+ * @brief Stop recording, e.g. on a fault, so the ring keeps the events
+ *        that led up to it
+ */
+void eer_trace_stop(void);
+
+/**
+ * @brief Empty the ring
+ */
+void eer_trace_clear(void);
+
+/**
+ * @brief Copy the records, oldest first
+ * @param[out] records Buffer for up to EER_TRACE_SIZE records
+ * @return Number of records copied
+ */
+uint16_t eer_trace_read(eer_trace_record_t* records);
+
+/**
+ * @brief Send the ring over the UART in binary
+ *
+ * Recording is stopped while the dump is sent and resumed afterwards if
+ * it was running. The dump is a 12-byte header followed by the records,
+ * oldest first, all fields little-endian:
+ *
+ *     "EERT"        magic
+ *     uint8_t       format version, 1
+ *     uint8_t       record size, 5
+ *     uint16_t      number of records
+ *     uint16_t      tick length in microseconds
+ *     uint16_t      steps per tick of the timestamp low byte
+ *     records       uint16_t timestamp, uint8_t event, uint16_t argument
+ *
+ * @param timeout Transmit timeout in milliseconds
+ * @return Status of the UART transmit
+ */
+eer_hal_status_t eer_trace_dump(uint32_t timeout);
+
+#else
+
+#define eer_trace(event, argument) ((void)0)
+#define eer_trace_isr(event, argument) ((void)0)
+
+#endif
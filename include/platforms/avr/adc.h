@@ -1,22 +1,77 @@
 #pragma once
 
 #include "eer_hal_adc.h"
+#include "platforms/avr/mcu.h"
 #include <avr/io.h>
 
 /**
  * @brief AVR-specific ADC channel structure
  */
 typedef struct {
-    uint8_t channel;  /*!< ADC channel number (0-7) */
+    uint8_t channel;  /*!< ADC channel number (0-7, 0-15 with EER_AVR_ADC_MUX5) */
 } eer_adc_channel_t;
 
 /**
  * @brief Macro to create an AVR ADC channel
- * @param ch Channel number (0-7)
+ * @param ch Channel number (0-7, 0-15 with EER_AVR_ADC_MUX5)
  */
 #define eer_hal_adc_channel(ch) \
     { ch }
 
+/**
+ * @brief Register values of an ADC configuration
+ */
+typedef struct {
+    uint8_t admux;   /*!< Reference selection, channel 0 */
+    uint8_t adcsra;  /*!< Enable, interrupt enable and prescaler */
+} avr_adc_registers_t;
+
+/**
+ * @brief Decode a configuration into register values
+ *
+ * Always inlined: with a constant configuration the result is a pair of
+ * constants, and init compiles down to two stores.
+ */
+static inline __attribute__((always_inline))
+avr_adc_registers_t avr_adc_registers(const eer_adc_config_t* config) {
+    avr_adc_registers_t registers;
+    
+    // REFS1:0 = 00 AREF pin, 01 AVcc, 11 internal 1.1 V
+    switch (config->reference) {
+        case EER_ADC_REF_EXTERNAL: registers.admux = 0; break;
+        case EER_ADC_REF_INTERNAL: registers.admux = (1 << REFS1) | (1 << REFS0); break;
+        case EER_ADC_REF_VCC:
+        default: registers.admux = (1 << REFS0); break;
+    }
+    
+    // ADPS2:0 counts the prescaler enum from /2 = 1 to /128 = 7
+    uint8_t prescaler = config->prescaler <= EER_ADC_PRESCALER_128 ? config->prescaler + 1 : 7;
+    registers.adcsra = (1 << ADEN) | (prescaler << ADPS0);
+    
+    // The conversion complete interrupt drives continuous mode
+    if (config->mode == EER_ADC_MODE_CONTINUOUS) {
+        registers.adcsra |= (1 << ADIE);
+    }
+    
+    return registers;
+}
+
+/**
+ * @brief Initialize the ADC from register values, see avr_adc_registers()
+ */
+eer_hal_status_t avr_adc_init_registers(avr_adc_registers_t registers);
+
+// Operations of eer_avr_adc, called directly by EER_HAL_STATIC builds
+eer_hal_status_t avr_adc_init(eer_adc_config_t* config);
+eer_hal_status_t avr_adc_deinit(void);
+eer_hal_status_t avr_adc_start_conversion(void* channel);
+eer_hal_status_t avr_adc_stop_conversion(void);
+eer_hal_status_t avr_adc_is_conversion_complete(void* channel, bool* complete);
+eer_hal_status_t avr_adc_read(void* channel, uint16_t* value);
+eer_hal_status_t avr_adc_read_voltage(void* channel, float* voltage);
+eer_hal_status_t avr_adc_register_callback(void* channel, eer_adc_conversion_complete_handler_t handler, void* user_data);
+eer_hal_status_t avr_adc_unregister_callback(void* channel);
+
 /**
  * @brief AVR ADC handler structure
  * This structure contains function pointers for AVR ADC operations
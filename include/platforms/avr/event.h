@@ -0,0 +1,23 @@
+/**
+ * @file event.h
+ * @brief Event queue locking on AVR
+ *
+ * Included by src/event.c. Posting from the main loop masks interrupts
+ * while an event is copied into its slot.
+ */
+#pragma once
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+typedef uint8_t eer_event_lock_t;
+
+static inline eer_event_lock_t eer_event_lock(void) {
+    uint8_t sreg = SREG;
+    cli();
+    return sreg;
+}
+
+static inline void eer_event_unlock(eer_event_lock_t sreg) {
+    SREG = sreg;
+}
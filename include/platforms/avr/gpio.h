@@ -1,6 +1,7 @@
 #pragma once
 
 #include "eer_hal_gpio.h"
+#include "platforms/avr/mcu.h"
 #include <avr/io.h>
 
 /**
@@ -25,6 +26,18 @@ typedef struct {
         {&DDR##port, &PORT##port, &PIN##port}, pin                             \
     }
 
+// Operations of eer_avr_gpio, called directly by EER_HAL_STATIC builds
+eer_hal_status_t avr_gpio_init(void);
+eer_hal_status_t avr_gpio_deinit(void);
+eer_hal_status_t avr_gpio_configure(void *pin, eer_gpio_config_t* config);
+eer_hal_status_t avr_gpio_write(void *pin, bool state);
+eer_hal_status_t avr_gpio_read(void *pin, bool *state);
+eer_hal_status_t avr_gpio_toggle(void *pin);
+eer_hal_status_t avr_gpio_register_irq(void *pin, eer_gpio_irq_handler_t handler, void* user_data);
+eer_hal_status_t avr_gpio_unregister_irq(void *pin);
+eer_hal_status_t avr_gpio_enable_irq(void *pin);
+eer_hal_status_t avr_gpio_disable_irq(void *pin);
+
 /**
  * @brief AVR GPIO handler structure
  * This structure contains function pointers for AVR GPIO operations
@@ -0,0 +1,264 @@
+/**
+ * @file hal_static.h
+ * @brief Compile-time binding of HAL operations on AVR
+ *
+ * Included by eer_hal.h when EER_HAL_STATIC is defined. Every
+ * eer_<peripheral>_<operation> name used by eer_hal_call() resolves to the
+ * AVR implementation. Pin access is defined inline: with a const pin
+ * structure the compiler folds the register address and bit, and a write
+ * becomes a single SBI/CBI instead of a table lookup and an ICALL.
+ * Initialization decodes the configuration inline: with a constant
+ * configuration only the register stores of avr_*_init_registers() are
+ * left, and the decoding of the avr_*_init functions is not linked.
+ * The remaining operations are direct calls.
+ */
+#pragma once
+
+#include "macros.h"
+#include "platforms/avr/gpio.h"
+#include "platforms/avr/adc.h"
+#include "platforms/avr/uart.h"
+#include "platforms/avr/spi.h"
+#include "platforms/avr/i2c.h"
+#include "platforms/avr/timer.h"
+#include "platforms/avr/system.h"
+#include "platforms/avr/power.h"
+#include "platforms/avr/nvs.h"
+#include <stddef.h>
+
+static inline eer_hal_status_t eer_gpio_write(const void *pin, bool state) {
+    if (pin == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    const eer_pin_t *avr_pin = (const eer_pin_t *)pin;
+    
+    if (state) {
+        bit_set(*(avr_pin->port.port), avr_pin->number);
+    } else {
+        bit_clear(*(avr_pin->port.port), avr_pin->number);
+    }
+    
+    return EER_HAL_OK;
+}
+
+static inline eer_hal_status_t eer_gpio_read(const void *pin, bool *state) {
+    if (pin == NULL || state == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    const eer_pin_t *avr_pin = (const eer_pin_t *)pin;
+    
+    *state = bit_get(*(avr_pin->port.pin), avr_pin->number);
+    
+    return EER_HAL_OK;
+}
+
+static inline eer_hal_status_t eer_gpio_toggle(const void *pin) {
+    if (pin == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    const eer_pin_t *avr_pin = (const eer_pin_t *)pin;
+    
+    // Writing one to PINx toggles the output without a read-modify-write
+    *(avr_pin->port.pin) = (1 << avr_pin->number);
+    
+    return EER_HAL_OK;
+}
+
+static inline eer_hal_status_t eer_adc_init(eer_adc_config_t* config) {
+    if (config == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    return avr_adc_init_registers(avr_adc_registers(config));
+}
+
+static inline eer_hal_status_t eer_uart_init(eer_uart_config_t* config) {
+    if (config == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    return avr_uart_init_registers(avr_uart_registers(config));
+}
+
+static inline eer_hal_status_t eer_uart_instance_init(void* uart, eer_uart_config_t* config) {
+    if (config == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    return avr_uart_instance_init_registers(uart, avr_uart_registers(config));
+}
+
+static inline eer_hal_status_t eer_spi_init(eer_spi_config_t* config) {
+    if (config == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    return avr_spi_init_registers(avr_spi_registers(config));
+}
+
+static inline eer_hal_status_t eer_i2c_init(eer_i2c_config_t* config) {
+    if (config == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    return avr_i2c_init_registers(config, avr_i2c_registers(config));
+}
+
+static inline eer_hal_status_t eer_timer_init(eer_timer_config_t* config) {
+    if (config == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    return avr_timer_init_registers(config, avr_timer_registers(config));
+}
+
+static inline eer_hal_status_t eer_timer_instance_init(void* timer, eer_timer_config_t* config) {
+    if (config == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    return avr_timer_instance_init_registers(timer, config, avr_timer_registers(config));
+}
+
+// GPIO
+#define eer_gpio_init avr_gpio_init
+#define eer_gpio_deinit avr_gpio_deinit
+#define eer_gpio_configure avr_gpio_configure
+#define eer_gpio_register_irq avr_gpio_register_irq
+#define eer_gpio_unregister_irq avr_gpio_unregister_irq
+#define eer_gpio_enable_irq avr_gpio_enable_irq
+#define eer_gpio_disable_irq avr_gpio_disable_irq
+
+// ADC
+#define eer_adc_deinit avr_adc_deinit
+#define eer_adc_start_conversion avr_adc_start_conversion
+#define eer_adc_stop_conversion avr_adc_stop_conversion
+#define eer_adc_is_conversion_complete avr_adc_is_conversion_complete
+#define eer_adc_read avr_adc_read
+#define eer_adc_read_voltage avr_adc_read_voltage
+#define eer_adc_register_callback avr_adc_register_callback
+#define eer_adc_unregister_callback avr_adc_unregister_callback
+
+// UART
+#define eer_uart_deinit avr_uart_deinit
+#define eer_uart_transmit avr_uart_transmit
+#define eer_uart_receive avr_uart_receive
+#define eer_uart_is_tx_ready avr_uart_is_tx_ready
+#define eer_uart_is_rx_ready avr_uart_is_rx_ready
+#define eer_uart_register_rx_callback avr_uart_register_rx_callback
+#define eer_uart_unregister_rx_callback avr_uart_unregister_rx_callback
+#define eer_uart_register_tx_callback avr_uart_register_tx_callback
+#define eer_uart_unregister_tx_callback avr_uart_unregister_tx_callback
+#define eer_uart_submit avr_uart_submit
+
+// UART instances
+#define eer_uart_instance_deinit avr_uart_instance_deinit
+#define eer_uart_instance_transmit avr_uart_instance_transmit
+#define eer_uart_instance_receive avr_uart_instance_receive
+#define eer_uart_instance_is_tx_ready avr_uart_instance_is_tx_ready
+#define eer_uart_instance_is_rx_ready avr_uart_instance_is_rx_ready
+#define eer_uart_instance_register_rx_callback avr_uart_instance_register_rx_callback
+#define eer_uart_instance_unregister_rx_callback avr_uart_instance_unregister_rx_callback
+#define eer_uart_instance_register_tx_callback avr_uart_instance_register_tx_callback
+#define eer_uart_instance_unregister_tx_callback avr_uart_instance_unregister_tx_callback
+
+// SPI
+#define eer_spi_deinit avr_spi_deinit
+#define eer_spi_transfer avr_spi_transfer
+#define eer_spi_transmit avr_spi_transmit
+#define eer_spi_receive avr_spi_receive
+#define eer_spi_is_ready avr_spi_is_ready
+#define eer_spi_chip_select avr_spi_chip_select
+#define eer_spi_set_prescaler avr_spi_set_prescaler
+#define eer_spi_register_callback avr_spi_register_callback
+#define eer_spi_unregister_callback avr_spi_unregister_callback
+#define eer_spi_submit avr_spi_submit
+
+// I2C
+#define eer_i2c_deinit avr_i2c_deinit
+#define eer_i2c_master_transmit avr_i2c_master_transmit
+#define eer_i2c_master_receive avr_i2c_master_receive
+#define eer_i2c_master_transmit_receive avr_i2c_master_transmit_receive
+#define eer_i2c_is_busy avr_i2c_is_busy
+#define eer_i2c_scan avr_i2c_scan
+#define eer_i2c_register_callback avr_i2c_register_callback
+#define eer_i2c_unregister_callback avr_i2c_unregister_callback
+#define eer_i2c_submit avr_i2c_submit
+
+// Timer
+#define eer_timer_deinit avr_timer_deinit
+#define eer_timer_start avr_timer_start
+#define eer_timer_stop avr_timer_stop
+#define eer_timer_set_period avr_timer_set_period
+#define eer_timer_get_value avr_timer_get_value
+#define eer_timer_set_compare avr_timer_set_compare
+#define eer_timer_set_pwm_duty_cycle avr_timer_set_pwm_duty_cycle
+#define eer_timer_us_to_ticks avr_timer_us_to_ticks
+#define eer_timer_ticks_to_us avr_timer_ticks_to_us
+#define eer_timer_register_callback avr_timer_register_callback
+#define eer_timer_unregister_callback avr_timer_unregister_callback
+#define eer_timer_set_capture_edge avr_timer_set_capture_edge
+
+// Timer instances
+#define eer_timer_instance_deinit avr_timer_instance_deinit
+#define eer_timer_instance_start avr_timer_instance_start
+#define eer_timer_instance_stop avr_timer_instance_stop
+#define eer_timer_instance_set_period avr_timer_instance_set_period
+#define eer_timer_instance_get_value avr_timer_instance_get_value
+#define eer_timer_instance_set_compare avr_timer_instance_set_compare
+#define eer_timer_instance_set_pwm_duty_cycle avr_timer_instance_set_pwm_duty_cycle
+#define eer_timer_instance_us_to_ticks avr_timer_instance_us_to_ticks
+#define eer_timer_instance_ticks_to_us avr_timer_instance_ticks_to_us
+#define eer_timer_instance_register_callback avr_timer_instance_register_callback
+#define eer_timer_instance_unregister_callback avr_timer_instance_unregister_callback
+#define eer_timer_instance_set_capture_edge avr_timer_instance_set_capture_edge
+
+// System
+#define eer_system_init avr_system_init
+#define eer_system_deinit avr_system_deinit
+#define eer_system_reset avr_system_reset
+#define eer_system_disable_interrupts avr_system_disable_interrupts
+#define eer_system_enable_interrupts avr_system_enable_interrupts
+#define eer_system_delay_ms avr_system_delay_ms
+#define eer_system_delay_us avr_system_delay_us
+#define eer_system_get_tick avr_system_get_tick
+#define eer_system_get_uptime_ms avr_system_get_uptime_ms
+
+// Power
+#define eer_power_init avr_power_init
+#define eer_power_deinit avr_power_deinit
+#define eer_power_set_mode avr_power_set_mode
+#define eer_power_get_mode avr_power_get_mode
+#define eer_power_enable_wakeup_source avr_power_enable_wakeup_source
+#define eer_power_disable_wakeup_source avr_power_disable_wakeup_source
+#define eer_power_get_wakeup_source avr_power_get_wakeup_source
+#define eer_power_get_voltage avr_power_get_voltage
+#define eer_power_get_power_consumption avr_power_get_power_consumption
+
+// Storage
+#ifdef EER_AVR_NVS_FLASH
+#define eer_nvs_init avr_flash_nvs_init
+#define eer_nvs_deinit avr_flash_nvs_deinit
+#define eer_nvs_read avr_flash_nvs_read
+#define eer_nvs_write avr_flash_nvs_write
+#define eer_nvs_erase avr_flash_nvs_erase
+#define eer_nvs_flush avr_flash_nvs_flush
+#define eer_nvs_is_busy avr_flash_nvs_is_busy
+#define eer_nvs_get_size avr_flash_nvs_get_size
+#define eer_nvs_register_callback avr_flash_nvs_register_callback
+#define eer_nvs_unregister_callback avr_flash_nvs_unregister_callback
+#else
+#define eer_nvs_init avr_nvs_init
+#define eer_nvs_deinit avr_nvs_deinit
+#define eer_nvs_read avr_nvs_read
+#define eer_nvs_write avr_nvs_write
+#define eer_nvs_erase avr_nvs_erase
+#define eer_nvs_flush avr_nvs_flush
+#define eer_nvs_is_busy avr_nvs_is_busy
+#define eer_nvs_get_size avr_nvs_get_size
+#define eer_nvs_register_callback avr_nvs_register_callback
+#define eer_nvs_unregister_callback avr_nvs_unregister_callback
+#endif
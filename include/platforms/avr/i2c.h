@@ -1,6 +1,8 @@
 #pragma once
 
 #include "eer_hal_i2c.h"
+#include "eer_hal_async.h"
+#include "platforms/avr/mcu.h"
 #include <avr/io.h>
 
 /**
@@ -12,14 +14,76 @@ typedef struct {
     volatile uint8_t* twsr;  /*!< TWI Status Register */
     volatile uint8_t* twdr;  /*!< TWI Data Register */
     volatile uint8_t* twar;  /*!< TWI (Slave) Address Register */
-    volatile uint8_t* twamr; /*!< TWI Address Mask Register */
+    volatile uint8_t* twamr; /*!< TWI Address Mask Register, NULL if absent */
 } eer_i2c_t;
 
 /**
  * @brief Macro to create an AVR I2C structure
  */
+#if EER_AVR_TWI_TWAMR
 #define eer_hal_i2c0() \
     { &TWBR, &TWCR, &TWSR, &TWDR, &TWAR, &TWAMR }
+#else
+#define eer_hal_i2c0() \
+    { &TWBR, &TWCR, &TWSR, &TWDR, &TWAR, NULL }
+#endif
+
+/**
+ * @brief Register values of an I2C configuration
+ */
+typedef struct {
+    uint8_t twbr;  /*!< Bit rate */
+    uint8_t twps;  /*!< Prescaler bits of TWSR */
+} avr_i2c_registers_t;
+
+/**
+ * @brief Decode a configuration into register values
+ *
+ * Always inlined: with a constant configuration the 32-bit bit rate
+ * division folds away, and init compiles down to the stores of
+ * avr_i2c_init_registers().
+ */
+static inline __attribute__((always_inline))
+avr_i2c_registers_t avr_i2c_registers(const eer_i2c_config_t* config) {
+    uint32_t scl_freq;
+    
+    switch (config->speed) {
+        case EER_I2C_SPEED_FAST:      scl_freq = 400000; break;
+        case EER_I2C_SPEED_FAST_PLUS: scl_freq = 1000000; break;
+        case EER_I2C_SPEED_STANDARD:
+        default:                      scl_freq = 100000; break;
+    }
+    
+    // An explicit clock frequency overrides the speed
+    if (config->clock_hz > 0) {
+        scl_freq = config->clock_hz;
+    }
+    
+    // SCL = F_CPU / (16 + 2 * TWBR * 4^TWPS), prescaler 1
+    avr_i2c_registers_t registers = { (uint8_t)(((F_CPU) / scl_freq - 16) / 2), 0 };
+    
+    return registers;
+}
+
+/**
+ * @brief Initialize I2C from register values, see avr_i2c_registers()
+ * @param config Configuration, stored for the other operations
+ * @param registers Register values
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t avr_i2c_init_registers(const eer_i2c_config_t* config, avr_i2c_registers_t registers);
+
+// Operations of eer_avr_i2c, called directly by EER_HAL_STATIC builds
+eer_hal_status_t avr_i2c_init(eer_i2c_config_t* config);
+eer_hal_status_t avr_i2c_deinit(void);
+eer_hal_status_t avr_i2c_master_transmit(uint16_t address, const uint8_t* data, uint16_t size, uint32_t timeout);
+eer_hal_status_t avr_i2c_master_receive(uint16_t address, uint8_t* data, uint16_t size, uint32_t timeout);
+eer_hal_status_t avr_i2c_master_transmit_receive(uint16_t address, const uint8_t* tx_data, uint16_t tx_size, uint8_t* rx_data, uint16_t rx_size, uint32_t timeout);
+eer_hal_status_t avr_i2c_is_busy(bool* busy);
+eer_hal_status_t avr_i2c_scan(uint16_t* devices, uint8_t max_devices, uint8_t* found_devices);
+eer_hal_status_t avr_i2c_register_callback(eer_i2c_transfer_handler_t handler, void* user_data);
+eer_hal_status_t avr_i2c_unregister_callback(void);
+eer_hal_status_t avr_i2c_submit(eer_async_request_t* request);
 
 /**
  * @brief AVR I2C handler structure
@@ -0,0 +1,31 @@
+/**
+ * @file mcu.h
+ * @brief Selection of the descriptor of the target AVR MCU
+ *
+ * Each descriptor in platforms/avr/mcu/ lists what the drivers need to know
+ * about one device beyond <avr/io.h>: the peripheral instances present,
+ * their interrupt vectors, the SPI pins, the pin change groups, the timer
+ * of the system tick, the ADC multiplexer and the boot section. Drivers
+ * build the instances and vectors of the target from these macros, so a
+ * single source tree targets every device below without device checks in
+ * the drivers.
+ *
+ * The descriptor is picked from the device macro set by -mmcu. Builds
+ * without one, e.g. against the host mock of <avr/io.h>, get the
+ * ATmega328P.
+ */
+#pragma once
+
+#include <avr/io.h>
+
+#if defined(__AVR_ATmega2560__)
+#include "platforms/avr/mcu/atmega2560.h"
+#elif defined(__AVR_ATmega1284P__)
+#include "platforms/avr/mcu/atmega1284p.h"
+#elif defined(__AVR_ATmega32U4__)
+#include "platforms/avr/mcu/atmega32u4.h"
+#elif defined(__AVR_ATmega328P__) || !defined(__AVR_ARCH__)
+#include "platforms/avr/mcu/atmega328p.h"
+#else
+#error "No descriptor in platforms/avr/mcu/ for the target MCU"
+#endif
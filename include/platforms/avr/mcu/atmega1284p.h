@@ -0,0 +1,81 @@
+/**
+ * @file atmega1284p.h
+ * @brief Descriptor of the ATmega1284P, see platforms/avr/mcu.h
+ */
+#pragma once
+
+#define EER_AVR_MCU_NAME "ATmega1284P"
+
+/*
+ * USART: USART0 and USART1
+ */
+#define EER_AVR_UART_MASK       0x03  /*!< Bit n set: USARTn present */
+#define EER_AVR_UARTS           2     /*!< Highest USART number + 1 */
+#define EER_AVR_UART_DEFAULT    0     /*!< USART of the single-instance operations */
+#define EER_AVR_UART0_RX_vect   USART0_RX_vect
+#define EER_AVR_UART0_TX_vect   USART0_TX_vect
+#define EER_AVR_UART0_UDRE_vect USART0_UDRE_vect
+#define EER_AVR_UART1_RX_vect   USART1_RX_vect
+#define EER_AVR_UART1_TX_vect   USART1_TX_vect
+#define EER_AVR_UART1_UDRE_vect USART1_UDRE_vect
+
+/** RXD of the default USART, a pin change pin for the UART wakeup */
+#define EER_AVR_UART_RXD_PIN() eer_hal_pin(D, 0)
+
+/*
+ * 16-bit timers: Timer1 and Timer3
+ */
+#define EER_AVR_TIMER_MASK 0x0A  /*!< Bit n set: 16-bit TimerN present */
+#define EER_AVR_TIMERS     4     /*!< Highest 16-bit timer number + 1 */
+
+/*
+ * SPI: PB5 MOSI, PB6 MISO, PB7 SCK, PB4 SS
+ */
+#define EER_AVR_SPI_DDR  DDRB
+#define EER_AVR_SPI_PORT PORTB
+#define EER_AVR_SPI_PIN  PINB
+#define EER_AVR_SPI_MOSI 5
+#define EER_AVR_SPI_MISO 6
+#define EER_AVR_SPI_SCK  7
+#define EER_AVR_SPI_SS   4
+
+/*
+ * Pin change groups: PCINTn covers the port given by EER_AVR_PCINTn_PIN
+ */
+#define EER_AVR_PCINT_GROUPS 4
+#define EER_AVR_PCINT0_PIN   PINA
+#define EER_AVR_PCINT1_PIN   PINB
+#define EER_AVR_PCINT2_PIN   PINC
+#define EER_AVR_PCINT3_PIN   PIND
+
+/*
+ * System tick: Timer2 in CTC mode, clock / 64, compare A interrupt
+ */
+#define EER_AVR_TICK_TCCRA  TCCR2A
+#define EER_AVR_TICK_TCCRB  TCCR2B
+#define EER_AVR_TICK_TCNT   TCNT2
+#define EER_AVR_TICK_OCR    OCR2A
+#define EER_AVR_TICK_TIMSK  TIMSK2
+#define EER_AVR_TICK_TIFR   TIFR2
+#define EER_AVR_TICK_OCIE   OCIE2A
+#define EER_AVR_TICK_OCF    OCF2A
+#define EER_AVR_TICK_CTC    (1 << WGM21)
+#define EER_AVR_TICK_CLK64  (1 << CS22)
+#define EER_AVR_TICK_vect   TIMER2_COMPA_vect
+
+/*
+ * ADC: single-ended channels 0-7, selected by MUX2:0
+ */
+#define EER_AVR_ADC_MUX5 0  /*!< Channels 8-15 selected by MUX5 of ADCSRB */
+
+/*
+ * TWI
+ */
+#define EER_AVR_TWI_TWAMR 1  /*!< Slave address mask register present */
+
+/*
+ * Boot section at the end of flash, 512 words with BOOTSZ = 11 and doubling
+ * with each lower BOOTSZ value. Read by toolchain/generic-gcc-avr.cmake.
+ */
+#define EER_AVR_FLASH_SIZE    131072UL  /*!< FLASHEND + 1 */
+#define EER_AVR_BOOT_SIZE_MIN 1024      /*!< Bytes of the smallest boot section */
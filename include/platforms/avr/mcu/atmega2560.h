@@ -0,0 +1,86 @@
+/**
+ * @file atmega2560.h
+ * @brief Descriptor of the ATmega2560, see platforms/avr/mcu.h
+ */
+#pragma once
+
+#define EER_AVR_MCU_NAME "ATmega2560"
+
+/*
+ * USART: USART0 to USART3
+ */
+#define EER_AVR_UART_MASK       0x0F  /*!< Bit n set: USARTn present */
+#define EER_AVR_UARTS           4     /*!< Highest USART number + 1 */
+#define EER_AVR_UART_DEFAULT    0     /*!< USART of the single-instance operations */
+#define EER_AVR_UART0_RX_vect   USART0_RX_vect
+#define EER_AVR_UART0_TX_vect   USART0_TX_vect
+#define EER_AVR_UART0_UDRE_vect USART0_UDRE_vect
+#define EER_AVR_UART1_RX_vect   USART1_RX_vect
+#define EER_AVR_UART1_TX_vect   USART1_TX_vect
+#define EER_AVR_UART1_UDRE_vect USART1_UDRE_vect
+#define EER_AVR_UART2_RX_vect   USART2_RX_vect
+#define EER_AVR_UART2_TX_vect   USART2_TX_vect
+#define EER_AVR_UART2_UDRE_vect USART2_UDRE_vect
+#define EER_AVR_UART3_RX_vect   USART3_RX_vect
+#define EER_AVR_UART3_TX_vect   USART3_TX_vect
+#define EER_AVR_UART3_UDRE_vect USART3_UDRE_vect
+
+// RXD0 is PE0, outside the mapped pin change groups: no UART wakeup
+
+/*
+ * 16-bit timers: Timer1, Timer3, Timer4 and Timer5
+ */
+#define EER_AVR_TIMER_MASK 0x3A  /*!< Bit n set: 16-bit TimerN present */
+#define EER_AVR_TIMERS     6     /*!< Highest 16-bit timer number + 1 */
+
+/*
+ * SPI: PB2 MOSI, PB3 MISO, PB1 SCK, PB0 SS
+ */
+#define EER_AVR_SPI_DDR  DDRB
+#define EER_AVR_SPI_PORT PORTB
+#define EER_AVR_SPI_PIN  PINB
+#define EER_AVR_SPI_MOSI 2
+#define EER_AVR_SPI_MISO 3
+#define EER_AVR_SPI_SCK  1
+#define EER_AVR_SPI_SS   0
+
+/*
+ * Pin change groups: PCINTn covers the port given by EER_AVR_PCINTn_PIN
+ *
+ * PCINT1 mixes PE0 and PJ0-6 with shifted bits and is left unmapped
+ */
+#define EER_AVR_PCINT_GROUPS 3
+#define EER_AVR_PCINT0_PIN   PINB
+#define EER_AVR_PCINT2_PIN   PINK
+
+/*
+ * System tick: Timer2 in CTC mode, clock / 64, compare A interrupt
+ */
+#define EER_AVR_TICK_TCCRA  TCCR2A
+#define EER_AVR_TICK_TCCRB  TCCR2B
+#define EER_AVR_TICK_TCNT   TCNT2
+#define EER_AVR_TICK_OCR    OCR2A
+#define EER_AVR_TICK_TIMSK  TIMSK2
+#define EER_AVR_TICK_TIFR   TIFR2
+#define EER_AVR_TICK_OCIE   OCIE2A
+#define EER_AVR_TICK_OCF    OCF2A
+#define EER_AVR_TICK_CTC    (1 << WGM21)
+#define EER_AVR_TICK_CLK64  (1 << CS22)
+#define EER_AVR_TICK_vect   TIMER2_COMPA_vect
+
+/*
+ * ADC: single-ended channels 0-15, MUX5 selects 8-15
+ */
+#define EER_AVR_ADC_MUX5 1  /*!< Channels 8-15 selected by MUX5 of ADCSRB */
+
+/*
+ * TWI
+ */
+#define EER_AVR_TWI_TWAMR 1  /*!< Slave address mask register present */
+
+/*
+ * Boot section at the end of flash, 512 words with BOOTSZ = 11 and doubling
+ * with each lower BOOTSZ value. Read by toolchain/generic-gcc-avr.cmake.
+ */
+#define EER_AVR_FLASH_SIZE    262144UL  /*!< FLASHEND + 1 */
+#define EER_AVR_BOOT_SIZE_MIN 1024      /*!< Bytes of the smallest boot section */
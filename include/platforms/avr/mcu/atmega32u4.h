@@ -0,0 +1,95 @@
+/**
+ * @file atmega32u4.h
+ * @brief Descriptor of the ATmega32U4, see platforms/avr/mcu.h
+ */
+#pragma once
+
+#define EER_AVR_MCU_NAME "ATmega32U4"
+
+/*
+ * USART: USART1 only
+ */
+#define EER_AVR_UART_MASK       0x02  /*!< Bit n set: USARTn present */
+#define EER_AVR_UARTS           2     /*!< Highest USART number + 1 */
+#define EER_AVR_UART_DEFAULT    1     /*!< USART of the single-instance operations */
+#define EER_AVR_UART1_RX_vect   USART1_RX_vect
+#define EER_AVR_UART1_TX_vect   USART1_TX_vect
+#define EER_AVR_UART1_UDRE_vect USART1_UDRE_vect
+
+// Bit names of USART0, used by the driver for every USART
+#ifndef RXC0
+#define RXC0    RXC1
+#define TXC0    TXC1
+#define UDRE0   UDRE1
+#define FE0     FE1
+#define MPCM0   MPCM1
+#define U2X0    U2X1
+#define RXCIE0  RXCIE1
+#define TXCIE0  TXCIE1
+#define UDRIE0  UDRIE1
+#define RXEN0   RXEN1
+#define TXEN0   TXEN1
+#define USBS0   USBS1
+#define UCSZ00  UCSZ10
+#define UCSZ01  UCSZ11
+#define UCSZ02  UCSZ12
+#define UPM00   UPM10
+#define UPM01   UPM11
+#endif
+
+// RXD1 is PD2, without pin change interrupt: no UART wakeup
+
+/*
+ * 16-bit timers: Timer1 and Timer3, Timer4 is the 10-bit high speed timer
+ */
+#define EER_AVR_TIMER_MASK 0x0A  /*!< Bit n set: 16-bit TimerN present */
+#define EER_AVR_TIMERS     4     /*!< Highest 16-bit timer number + 1 */
+
+/*
+ * SPI: PB2 MOSI, PB3 MISO, PB1 SCK, PB0 SS
+ */
+#define EER_AVR_SPI_DDR  DDRB
+#define EER_AVR_SPI_PORT PORTB
+#define EER_AVR_SPI_PIN  PINB
+#define EER_AVR_SPI_MOSI 2
+#define EER_AVR_SPI_MISO 3
+#define EER_AVR_SPI_SCK  1
+#define EER_AVR_SPI_SS   0
+
+/*
+ * Pin change groups: PCINTn covers the port given by EER_AVR_PCINTn_PIN
+ */
+#define EER_AVR_PCINT_GROUPS 1
+#define EER_AVR_PCINT0_PIN   PINB
+
+/*
+ * System tick: no Timer2, Timer0 in CTC mode, clock / 64, compare A interrupt
+ */
+#define EER_AVR_TICK_TCCRA  TCCR0A
+#define EER_AVR_TICK_TCCRB  TCCR0B
+#define EER_AVR_TICK_TCNT   TCNT0
+#define EER_AVR_TICK_OCR    OCR0A
+#define EER_AVR_TICK_TIMSK  TIMSK0
+#define EER_AVR_TICK_TIFR   TIFR0
+#define EER_AVR_TICK_OCIE   OCIE0A
+#define EER_AVR_TICK_OCF    OCF0A
+#define EER_AVR_TICK_CTC    (1 << WGM01)
+#define EER_AVR_TICK_CLK64  ((1 << CS01) | (1 << CS00))
+#define EER_AVR_TICK_vect   TIMER0_COMPA_vect
+
+/*
+ * ADC: single-ended channels 0, 1, 4-13, MUX5 selects 8-13
+ */
+#define EER_AVR_ADC_MUX5 1  /*!< Channels 8-15 selected by MUX5 of ADCSRB */
+
+/*
+ * TWI
+ */
+#define EER_AVR_TWI_TWAMR 1  /*!< Slave address mask register present */
+
+/*
+ * Boot section at the end of flash, 256 words with BOOTSZ = 11 and doubling
+ * with each lower BOOTSZ value. Read by toolchain/generic-gcc-avr.cmake.
+ */
+#define EER_AVR_FLASH_SIZE    32768UL  /*!< FLASHEND + 1 */
+#define EER_AVR_BOOT_SIZE_MIN 512      /*!< Bytes of the smallest boot section */
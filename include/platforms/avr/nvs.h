@@ -0,0 +1,83 @@
+#pragma once
+
+#include "eer_hal_nvs.h"
+#include <avr/io.h>
+
+/**
+ * @brief Number of bytes the EEPROM write queue holds (power of two)
+ *
+ * Each entry takes three bytes of RAM. Writes beyond the free space block
+ * until the EE_READY interrupt has programmed enough of the queue, or
+ * return EER_HAL_TIMEOUT when their timeout passes first.
+ */
+#ifndef EER_AVR_NVS_QUEUE_SIZE
+#define EER_AVR_NVS_QUEUE_SIZE 16
+#endif
+
+// Operations of eer_avr_nvs, called directly by EER_HAL_STATIC builds
+eer_hal_status_t avr_nvs_init(void);
+eer_hal_status_t avr_nvs_deinit(void);
+eer_hal_status_t avr_nvs_read(uint32_t address, uint8_t* data, uint16_t size);
+eer_hal_status_t avr_nvs_write(uint32_t address, const uint8_t* data, uint16_t size, uint32_t timeout);
+eer_hal_status_t avr_nvs_erase(uint32_t address, uint16_t size, uint32_t timeout);
+eer_hal_status_t avr_nvs_flush(uint32_t timeout);
+eer_hal_status_t avr_nvs_is_busy(bool* busy);
+eer_hal_status_t avr_nvs_get_size(uint32_t* size);
+eer_hal_status_t avr_nvs_register_callback(eer_nvs_write_handler_t handler, void* user_data);
+eer_hal_status_t avr_nvs_unregister_callback(void);
+
+/**
+ * @brief AVR EEPROM storage handler structure
+ * This structure contains function pointers for AVR EEPROM operations
+ */
+extern eer_nvs_handler_t eer_avr_nvs;
+
+/**
+ * @brief Bytes of program memory reserved for the flash storage handler
+ *
+ * Must be a multiple of two flash pages. Each logical page is backed by two
+ * physical pages and keeps four bytes for its trailer, so the usable size
+ * is EER_AVR_FLASH_NVS_SIZE / 2 minus four bytes per page.
+ */
+#ifndef EER_AVR_FLASH_NVS_SIZE
+#define EER_AVR_FLASH_NVS_SIZE 4096
+#endif
+
+// Operations of eer_avr_flash_nvs, called directly by EER_HAL_STATIC builds
+eer_hal_status_t avr_flash_nvs_init(void);
+eer_hal_status_t avr_flash_nvs_deinit(void);
+eer_hal_status_t avr_flash_nvs_read(uint32_t address, uint8_t* data, uint16_t size);
+eer_hal_status_t avr_flash_nvs_write(uint32_t address, const uint8_t* data, uint16_t size, uint32_t timeout);
+eer_hal_status_t avr_flash_nvs_erase(uint32_t address, uint16_t size, uint32_t timeout);
+eer_hal_status_t avr_flash_nvs_flush(uint32_t timeout);
+eer_hal_status_t avr_flash_nvs_is_busy(bool* busy);
+eer_hal_status_t avr_flash_nvs_get_size(uint32_t* size);
+eer_hal_status_t avr_flash_nvs_register_callback(eer_nvs_write_handler_t handler, void* user_data);
+eer_hal_status_t avr_flash_nvs_unregister_callback(void);
+
+/**
+ * @brief AVR flash storage handler structure
+ *
+ * Same contract as eer_avr_nvs on spare program memory. Writes are merged
+ * into a RAM image of one page and programmed when another page is written
+ * or on flush. Programming goes through a routine in the boot section with
+ * interrupts disabled for about 9 ms per page; non-blocking writes must stay
+ * within the page being modified. The EER_AVR_NVS_FLASH CMake option builds
+ * it and makes it the eer_hal.nvs handler.
+ *
+ * The routine is linked at the start of the boot section that the BOOTSZ
+ * bits of H_FUSE select, so the image has to be written over ISP (e.g.
+ * PROG_TYPE usbasp, after the erase and fuses targets) with those fuses
+ * and BOOTRST unprogrammed. A serial bootloader cannot be used: it would
+ * occupy the same section and cannot program its own.
+ */
+extern eer_nvs_handler_t eer_avr_flash_nvs;
+
+/**
+ * @brief Get how often the flash page pair holding an address was programmed
+ * @param address Storage address
+ * @param[out] count Pointer to store the number of programming cycles, each
+ *                   of the two physical pages was erased about half as often
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t avr_flash_nvs_get_erase_count(uint32_t address, uint32_t* count);
@@ -3,6 +3,43 @@
 #include "eer_hal_power.h"
 #include <avr/io.h>
 
+/*
+ * Wake on UART activity
+ *
+ * enable_wakeup_source(EER_WAKEUP_UART, 0) lets EER_POWER_MODE_DEEP_SLEEP
+ * and EER_POWER_MODE_STANDBY wake on serial traffic instead of sleeping in
+ * idle mode to keep the USART clocked. On sleep entry the transmitter is
+ * drained and a falling-edge pin change interrupt is armed on RXD (PD0).
+ * The start bit wakes the MCU; once the oscillator has started the USART
+ * receives again without being reconfigured, and the interrupt disarms
+ * itself. get_wakeup_source() then reports EER_WAKEUP_UART.
+ *
+ * Bytes sent during the wake-up latency are lost, so peers must precede
+ * each command with EER_AVR_UART_WAKE_PREAMBLE(baud, wake_us) bytes of
+ * 0xFF (see platforms/avr/uart.h) and the protocol must ignore them.
+ */
+
+/**
+ * @brief Record the source of a wakeup from an interrupt owned by another driver
+ * @param source Wakeup source that fired
+ * @param pin_or_id Pin or peripheral number of the source
+ *
+ * Vectors shared with a peripheral driver (e.g. the timer overflow) stay in
+ * that driver, which reports the wakeup here.
+ */
+void avr_power_wakeup(eer_wakeup_source_t source, uint8_t pin_or_id);
+
+// Operations of eer_avr_power, called directly by EER_HAL_STATIC builds
+eer_hal_status_t avr_power_init(void);
+eer_hal_status_t avr_power_deinit(void);
+eer_hal_status_t avr_power_set_mode(eer_power_mode_t mode);
+eer_hal_status_t avr_power_get_mode(eer_power_mode_t* mode);
+eer_hal_status_t avr_power_enable_wakeup_source(eer_wakeup_source_t source, uint8_t pin_or_id);
+eer_hal_status_t avr_power_disable_wakeup_source(eer_wakeup_source_t source, uint8_t pin_or_id);
+eer_hal_status_t avr_power_get_wakeup_source(eer_wakeup_source_t* source, uint8_t* pin_or_id);
+eer_hal_status_t avr_power_get_voltage(uint16_t* voltage_mv);
+eer_hal_status_t avr_power_get_power_consumption(uint16_t* power_mw);
+
 /**
  * @brief AVR power handler structure
  * This structure contains function pointers for AVR power management operations
@@ -0,0 +1,32 @@
+/**
+ * @file progmem.h
+ * @brief Transmit data in program memory
+ *
+ * The _P transmit calls of the UART and SPI and requests with
+ * EER_ASYNC_TX_FLASH take their bytes from flash, e.g. a PROGMEM string,
+ * font or bitmap, and read each one with LPM as it is sent instead of
+ * staging the payload in SRAM. Like pgm_read_byte(), they reach the first
+ * 64 KiB of flash, where the linker places PROGMEM data.
+ */
+#pragma once
+
+#include "eer_hal_async.h"
+#include <stdbool.h>
+#include <avr/pgmspace.h>
+
+/**
+ * @brief Read one byte of transmit data
+ * @param data Data in flash or in RAM
+ * @param index Byte index
+ * @param flash true if data is in program memory
+ */
+static inline uint8_t avr_progmem_byte(const uint8_t* data, uint16_t index, bool flash) {
+    return flash ? pgm_read_byte(data + index) : data[index];
+}
+
+/**
+ * @brief Read one byte of the write part of a request
+ */
+static inline uint8_t avr_async_tx_byte(const eer_async_request_t* request, uint16_t index) {
+    return avr_progmem_byte(request->tx_data, index, request->flags & EER_ASYNC_TX_FLASH);
+}
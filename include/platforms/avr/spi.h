@@ -1,6 +1,8 @@
 #pragma once
 
 #include "eer_hal_spi.h"
+#include "eer_hal_async.h"
+#include "platforms/avr/mcu.h"
 #include <avr/io.h>
 
 /**
@@ -22,10 +24,96 @@ typedef struct {
 } eer_spi_t;
 
 /**
- * @brief Macro to create an AVR SPI structure
+ * @brief Macro to create an AVR SPI structure, pins from the MCU descriptor
  */
 #define eer_hal_spi0() \
-    { &SPCR, &SPSR, &SPDR, { &DDRB, &PORTB, &PINB, PORTB3, PORTB4, PORTB5, PORTB2 } }
+    { &SPCR, &SPSR, &SPDR, { &EER_AVR_SPI_DDR, &EER_AVR_SPI_PORT, &EER_AVR_SPI_PIN, \
+                             EER_AVR_SPI_MOSI, EER_AVR_SPI_MISO, EER_AVR_SPI_SCK, EER_AVR_SPI_SS } }
+
+/**
+ * @brief Register values of an SPI configuration
+ */
+typedef struct {
+    uint8_t spcr;  /*!< SPI Control Register, enable bit included */
+    uint8_t spsr;  /*!< SPI Status Register, SPI2X only */
+} avr_spi_registers_t;
+
+/**
+ * @brief Decode a configuration into register values
+ *
+ * Always inlined: with a constant configuration the result is a pair of
+ * constants, and init compiles down to the stores of
+ * avr_spi_init_registers().
+ */
+static inline __attribute__((always_inline))
+avr_spi_registers_t avr_spi_registers(const eer_spi_config_t* config) {
+    avr_spi_registers_t registers = { (1 << SPE), 0 };
+    
+    if (config->master) {
+        registers.spcr |= (1 << MSTR);
+    }
+    
+    if (config->bit_order == EER_SPI_BIT_ORDER_LSB) {
+        registers.spcr |= (1 << DORD);
+    }
+    
+    // CPOL and CPHA
+    switch (config->mode) {
+        case EER_SPI_MODE_1: registers.spcr |= (1 << CPHA); break;
+        case EER_SPI_MODE_2: registers.spcr |= (1 << CPOL); break;
+        case EER_SPI_MODE_3: registers.spcr |= (1 << CPOL) | (1 << CPHA); break;
+        case EER_SPI_MODE_0:
+        default: break;
+    }
+    
+    // Clock rate: SPR1:0 select /4 to /128, SPI2X halves it
+    switch (config->prescaler) {
+        case EER_SPI_PRESCALER_2:  registers.spsr = (1 << SPI2X); break;
+        case EER_SPI_PRESCALER_4:  break;
+        case EER_SPI_PRESCALER_8:  registers.spsr = (1 << SPI2X); registers.spcr |= (1 << SPR0); break;
+        case EER_SPI_PRESCALER_16: registers.spcr |= (1 << SPR0); break;
+        case EER_SPI_PRESCALER_32: registers.spsr = (1 << SPI2X); registers.spcr |= (1 << SPR1); break;
+        case EER_SPI_PRESCALER_64: registers.spcr |= (1 << SPR1); break;
+        case EER_SPI_PRESCALER_128:
+        default: registers.spcr |= (1 << SPR1) | (1 << SPR0); break;
+    }
+    
+    return registers;
+}
+
+/**
+ * @brief Initialize SPI from register values, see avr_spi_registers()
+ * @param registers Register values, MSTR selects the pin directions
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t avr_spi_init_registers(avr_spi_registers_t registers);
+
+/**
+ * @brief Send bytes from program memory
+ *
+ * Same as transmit() with data in flash, e.g. a PROGMEM font or bitmap,
+ * read with LPM as it is sent; see platforms/avr/progmem.h. The transfer
+ * callback gets the flash address in tx_data.
+ *
+ * @param data Data in program memory
+ * @param size Number of bytes
+ * @param timeout Timeout in milliseconds, 0 to wait forever
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t avr_spi_transmit_P(const uint8_t* data, uint16_t size, uint32_t timeout);
+
+// Operations of eer_avr_spi, called directly by EER_HAL_STATIC builds
+eer_hal_status_t avr_spi_init(eer_spi_config_t* config);
+eer_hal_status_t avr_spi_deinit(void);
+eer_hal_status_t avr_spi_transfer(const uint8_t* tx_data, uint8_t* rx_data, uint16_t size, uint32_t timeout);
+eer_hal_status_t avr_spi_transmit(const uint8_t* data, uint16_t size, uint32_t timeout);
+eer_hal_status_t avr_spi_receive(uint8_t* data, uint16_t size, uint32_t timeout);
+eer_hal_status_t avr_spi_is_ready(bool* ready);
+eer_hal_status_t avr_spi_chip_select(void* pin, bool state);
+eer_hal_status_t avr_spi_set_prescaler(eer_spi_prescaler_t prescaler);
+eer_hal_status_t avr_spi_register_callback(eer_spi_transfer_handler_t handler, void* user_data);
+eer_hal_status_t avr_spi_unregister_callback(void);
+eer_hal_status_t avr_spi_submit(eer_async_request_t* request);
 
 /**
  * @brief AVR SPI handler structure
@@ -1,8 +1,29 @@
 #pragma once
 
 #include "eer_hal_system.h"
+#include "platforms/avr/mcu.h"
 #include <avr/io.h>
 
+/**
+ * @brief Milliseconds since avr_system_init(), incremented by the compare
+ *        interrupt of the tick timer, see EER_AVR_TICK_vect
+ *
+ * Read through avr_system_get_tick(); a single byte may be read directly,
+ * as the trace timestamp does.
+ */
+extern volatile uint32_t avr_system_ticks;
+
+// Operations of eer_avr_system, called directly by EER_HAL_STATIC builds
+eer_hal_status_t avr_system_init(void);
+eer_hal_status_t avr_system_deinit(void);
+eer_hal_status_t avr_system_reset(eer_system_reset_type_t reset_type);
+eer_hal_status_t avr_system_disable_interrupts(void);
+eer_hal_status_t avr_system_enable_interrupts(void);
+eer_hal_status_t avr_system_delay_ms(uint32_t ms);
+eer_hal_status_t avr_system_delay_us(uint32_t us);
+eer_hal_status_t avr_system_get_tick(uint32_t* ticks);
+eer_hal_status_t avr_system_get_uptime_ms(uint32_t* uptime);
+
 /**
  * @brief AVR system handler structure
  * This structure contains function pointers for AVR system operations
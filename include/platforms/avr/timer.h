@@ -1,10 +1,11 @@
 #pragma once
 
 #include "eer_hal_timer.h"
+#include "platforms/avr/mcu.h"
 #include <avr/io.h>
 
 /**
- * @brief AVR-specific timer structure
+ * @brief AVR-specific timer structure, the state block of one 16-bit timer
  */
 typedef struct {
     volatile uint16_t* tcnt;   /*!< Timer/Counter Register */
@@ -15,16 +16,135 @@ typedef struct {
     volatile uint16_t* ocra;   /*!< Output Compare Register A */
     volatile uint16_t* ocrb;   /*!< Output Compare Register B */
     volatile uint16_t* icr;    /*!< Input Capture Register */
+    uint8_t            index;  /*!< Timer number, selects the interrupt vectors */
+    
+    eer_timer_config_t config; /*!< Current configuration */
+    eer_timer_event_handler_t overflow_handler;   /*!< Overflow callback */
+    void*              overflow_user_data;        /*!< User data of the overflow callback */
+    eer_timer_event_handler_t compare_handler[2]; /*!< Compare A and B callbacks */
+    void*              compare_user_data[2];      /*!< User data of the compare callbacks */
+    eer_timer_event_handler_t capture_handler;    /*!< Input capture callback */
+    void*              capture_user_data;         /*!< User data of the capture callback */
 } eer_timer_t;
 
 /**
  * @brief Macro to create an AVR Timer1 structure
  */
 #define eer_hal_timer1() \
-    { &TCNT1, &TCCR1A, &TCCR1B, &TIMSK1, &TIFR1, &OCR1A, &OCR1B, &ICR1 }
+    { .tcnt = &TCNT1, .tccra = &TCCR1A, .tccrb = &TCCR1B, .timsk = &TIMSK1, .tifr = &TIFR1, \
+      .ocra = &OCR1A, .ocrb = &OCR1B, .icr = &ICR1, .index = 1 }
+
+#if EER_AVR_TIMER_MASK & (1 << 3)
+/**
+ * @brief Macro to create an AVR Timer3 structure
+ */
+#define eer_hal_timer3() \
+    { .tcnt = &TCNT3, .tccra = &TCCR3A, .tccrb = &TCCR3B, .timsk = &TIMSK3, .tifr = &TIFR3, \
+      .ocra = &OCR3A, .ocrb = &OCR3B, .icr = &ICR3, .index = 3 }
+#endif
+
+#if EER_AVR_TIMER_MASK & (1 << 4)
+/**
+ * @brief Macro to create an AVR Timer4 structure
+ */
+#define eer_hal_timer4() \
+    { .tcnt = &TCNT4, .tccra = &TCCR4A, .tccrb = &TCCR4B, .timsk = &TIMSK4, .tifr = &TIFR4, \
+      .ocra = &OCR4A, .ocrb = &OCR4B, .icr = &ICR4, .index = 4 }
+#endif
+
+#if EER_AVR_TIMER_MASK & (1 << 5)
+/**
+ * @brief Macro to create an AVR Timer5 structure
+ */
+#define eer_hal_timer5() \
+    { .tcnt = &TCNT5, .tccra = &TCCR5A, .tccrb = &TCCR5B, .timsk = &TIMSK5, .tifr = &TIFR5, \
+      .ocra = &OCR5A, .ocrb = &OCR5B, .icr = &ICR5, .index = 5 }
+#endif
+
+/**
+ * @brief Register values of a timer configuration
+ */
+typedef struct {
+    uint8_t  tccra;  /*!< Waveform generation and output modes */
+    uint8_t  tccrb;  /*!< Waveform generation and clock select */
+    uint16_t icr;    /*!< TOP of the PWM mode */
+} avr_timer_registers_t;
+
+/**
+ * @brief Decode a configuration into register values
+ *
+ * Always inlined: with a constant configuration the result is constant,
+ * and init compiles down to the stores of
+ * avr_timer_instance_init_registers().
+ */
+static inline __attribute__((always_inline))
+avr_timer_registers_t avr_timer_registers(const eer_timer_config_t* config) {
+    // Fixed clk/8 prescaler
+    avr_timer_registers_t registers = { 0, (1 << CS11), 0 };
+    
+    if (config->mode == EER_TIMER_MODE_PWM) {
+        // Fast PWM with TOP in ICRn (mode 14), non-inverting outputs
+        registers.tccra = (1 << COM1A1) | (1 << COM1B1) | (1 << WGM11);
+        registers.tccrb |= (1 << WGM13) | (1 << WGM12);
+        registers.icr = (uint16_t)config->period;
+    }
+    
+    return registers;
+}
+
+/**
+ * @brief Initialize Timer1 from register values, see avr_timer_registers()
+ */
+eer_hal_status_t avr_timer_init_registers(const eer_timer_config_t* config, avr_timer_registers_t registers);
+
+/**
+ * @brief Initialize a timer from register values, see avr_timer_registers()
+ * @param timer Timer instance
+ * @param config Configuration, stored for the other operations
+ * @param registers Register values
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t avr_timer_instance_init_registers(void* timer, const eer_timer_config_t* config, avr_timer_registers_t registers);
+
+// Operations of eer_avr_timer, called directly by EER_HAL_STATIC builds
+eer_hal_status_t avr_timer_init(eer_timer_config_t* config);
+eer_hal_status_t avr_timer_deinit(void);
+eer_hal_status_t avr_timer_start(void);
+eer_hal_status_t avr_timer_stop(void);
+eer_hal_status_t avr_timer_set_period(uint32_t period);
+eer_hal_status_t avr_timer_get_value(uint32_t* value);
+eer_hal_status_t avr_timer_set_compare(uint8_t channel, uint32_t value);
+eer_hal_status_t avr_timer_set_pwm_duty_cycle(uint8_t channel, uint8_t duty_cycle);
+uint32_t avr_timer_us_to_ticks(uint32_t us);
+uint32_t avr_timer_ticks_to_us(uint32_t ticks);
+eer_hal_status_t avr_timer_register_callback(eer_timer_event_t event, uint8_t channel, eer_timer_event_handler_t handler, void* user_data);
+eer_hal_status_t avr_timer_unregister_callback(eer_timer_event_t event, uint8_t channel);
+eer_hal_status_t avr_timer_set_capture_edge(bool rising);
+
+// Operations of eer_avr_timer_instance, called directly by EER_HAL_STATIC builds
+eer_hal_status_t avr_timer_instance_init(void* timer, eer_timer_config_t* config);
+eer_hal_status_t avr_timer_instance_deinit(void* timer);
+eer_hal_status_t avr_timer_instance_start(void* timer);
+eer_hal_status_t avr_timer_instance_stop(void* timer);
+eer_hal_status_t avr_timer_instance_set_period(void* timer, uint32_t period);
+eer_hal_status_t avr_timer_instance_get_value(void* timer, uint32_t* value);
+eer_hal_status_t avr_timer_instance_set_compare(void* timer, uint8_t channel, uint32_t value);
+eer_hal_status_t avr_timer_instance_set_pwm_duty_cycle(void* timer, uint8_t channel, uint8_t duty_cycle);
+uint32_t avr_timer_instance_us_to_ticks(void* timer, uint32_t us);
+uint32_t avr_timer_instance_ticks_to_us(void* timer, uint32_t ticks);
+eer_hal_status_t avr_timer_instance_register_callback(void* timer, eer_timer_event_t event, uint8_t channel, eer_timer_event_handler_t handler, void* user_data);
+eer_hal_status_t avr_timer_instance_unregister_callback(void* timer, eer_timer_event_t event, uint8_t channel);
+eer_hal_status_t avr_timer_instance_set_capture_edge(void* timer, bool rising);
 
 /**
  * @brief AVR Timer handler structure
- * This structure contains function pointers for AVR Timer operations
+ * This structure contains function pointers for AVR Timer operations on Timer1
  */
 extern eer_timer_handler_t eer_avr_timer;
+
+/**
+ * @brief AVR Timer instance handler structure
+ * This structure contains function pointers for AVR Timer operations on any
+ * 16-bit timer
+ */
+extern eer_timer_instance_handler_t eer_avr_timer_instance;
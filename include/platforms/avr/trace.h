@@ -0,0 +1,41 @@
+/**
+ * @file trace.h
+ * @brief Trace timestamp and slot locking on AVR
+ *
+ * Included by eer_trace.h when EER_HAL_TRACE is defined. The timestamp
+ * combines the low byte of the system tick with the count of the tick
+ * timer of the MCU descriptor, which counts the tick in steps of 64 CPU
+ * clocks. An event at the very end of a tick may carry the count of the
+ * next tick before its interrupt ran.
+ *
+ * Both halves are single byte loads that land in the two bytes of the
+ * result as they are, with no shift or mask left in the code.
+ *
+ * eer_trace_lock() saves SREG and clears the global interrupt flag; the
+ * AVR has no atomic increment in RAM, so eer_trace() holds interrupts off
+ * for the load, increment and store of the slot index.
+ */
+#pragma once
+
+#include "platforms/avr/system.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#define EER_TRACE_TICK_US 1000
+#define EER_TRACE_SUB_PER_TICK (F_CPU / 64 / 1000)
+
+typedef uint8_t eer_trace_lock_t;
+
+static inline uint16_t eer_trace_timestamp(void) {
+    return ((uint16_t)*(volatile uint8_t*)&avr_system_ticks << 8) | EER_AVR_TICK_TCNT;
+}
+
+static inline eer_trace_lock_t eer_trace_lock(void) {
+    uint8_t sreg = SREG;
+    cli();
+    return sreg;
+}
+
+static inline void eer_trace_unlock(eer_trace_lock_t sreg) {
+    SREG = sreg;
+}
@@ -1,10 +1,19 @@
 #pragma once
 
 #include "eer_hal_uart.h"
+#include "eer_hal_async.h"
+#include "platforms/avr/mcu.h"
 #include <avr/io.h>
 
 /**
- * @brief AVR-specific UART structure
+ * @brief Size of the receive buffer of each UART instance in bytes
+ */
+#ifndef EER_AVR_UART_RX_SIZE
+#define EER_AVR_UART_RX_SIZE 64
+#endif
+
+/**
+ * @brief AVR-specific UART structure, the state block of one USART
  */
 typedef struct {
     volatile uint8_t* udr;   /*!< UART Data Register */
@@ -13,16 +22,206 @@ typedef struct {
     volatile uint8_t* ucsrc; /*!< UART Control and Status Register C */
     volatile uint8_t* ubrrl; /*!< UART Baud Rate Register Low */
     volatile uint8_t* ubrrh; /*!< UART Baud Rate Register High */
+    uint8_t           index; /*!< USART number, selects the interrupt vectors */
+    
+    uint8_t           rx_buffer[EER_AVR_UART_RX_SIZE]; /*!< Bytes received by the interrupt */
+    volatile uint8_t  rx_head;        /*!< Write index of rx_buffer */
+    volatile uint8_t  rx_tail;        /*!< Read index of rx_buffer */
+    volatile bool     tx_written;     /*!< A byte was loaded into the transmitter */
+    eer_uart_rx_handler_t rx_handler; /*!< Receive callback */
+    void*             rx_user_data;   /*!< User data of the receive callback */
+    eer_uart_tx_handler_t tx_handler; /*!< Transmit complete callback */
+    void*             tx_user_data;   /*!< User data of the transmit complete callback */
+    eer_async_queue_t async;          /*!< Asynchronous requests, run by the interrupts */
 } eer_uart_t;
 
+#if EER_AVR_UART_MASK & (1 << 0)
 /**
  * @brief Macro to create an AVR UART structure for UART0
  */
 #define eer_hal_uart0() \
-    { &UDR0, &UCSR0A, &UCSR0B, &UCSR0C, &UBRR0L, &UBRR0H }
+    { .udr = &UDR0, .ucsra = &UCSR0A, .ucsrb = &UCSR0B, .ucsrc = &UCSR0C, \
+      .ubrrl = &UBRR0L, .ubrrh = &UBRR0H, .index = 0 }
+#endif
+
+#if EER_AVR_UART_MASK & (1 << 1)
+/**
+ * @brief Macro to create an AVR UART structure for UART1
+ */
+#define eer_hal_uart1() \
+    { .udr = &UDR1, .ucsra = &UCSR1A, .ucsrb = &UCSR1B, .ucsrc = &UCSR1C, \
+      .ubrrl = &UBRR1L, .ubrrh = &UBRR1H, .index = 1 }
+#endif
+
+#if EER_AVR_UART_MASK & (1 << 2)
+/**
+ * @brief Macro to create an AVR UART structure for UART2
+ */
+#define eer_hal_uart2() \
+    { .udr = &UDR2, .ucsra = &UCSR2A, .ucsrb = &UCSR2B, .ucsrc = &UCSR2C, \
+      .ubrrl = &UBRR2L, .ubrrh = &UBRR2H, .index = 2 }
+#endif
+
+#if EER_AVR_UART_MASK & (1 << 3)
+/**
+ * @brief Macro to create an AVR UART structure for UART3
+ */
+#define eer_hal_uart3() \
+    { .udr = &UDR3, .ucsra = &UCSR3A, .ucsrb = &UCSR3B, .ucsrc = &UCSR3C, \
+      .ubrrl = &UBRR3L, .ubrrh = &UBRR3H, .index = 3 }
+#endif
+
+/**
+ * @brief Macro to create the AVR UART structure of the USART used by the
+ *        single-instance operations, EER_AVR_UART_DEFAULT of the MCU
+ */
+#if EER_AVR_UART_DEFAULT == 1
+#define eer_hal_uart_default() eer_hal_uart1()
+#else
+#define eer_hal_uart_default() eer_hal_uart0()
+#endif
+
+/**
+ * @brief Number of 0xFF preamble bytes a peer must send ahead of a command
+ *        to a node sleeping with the EER_WAKEUP_UART source enabled
+ * @param baud Line rate in bits per second
+ * @param wake_us Wake-up latency in microseconds (oscillator start-up time
+ *                selected by the SUT/CKSEL fuses plus the wake-up ISR)
+ *
+ * The falling edge of the first start bit wakes the MCU from power-down;
+ * bytes arriving before the USART is clocked again are lost, and the one
+ * in flight is dropped with a framing error. 0xFF carries a single falling
+ * edge (its start bit), so the receiver resynchronises on the next byte.
+ */
+#define EER_AVR_UART_WAKE_PREAMBLE(baud, wake_us) \
+    ((uint16_t)(((uint32_t)(wake_us) * ((baud) / 100UL) + 99999UL) / 100000UL) + 1)
+
+/**
+ * @brief Wait until the last byte has left the shift register of the default UART
+ *
+ * Call before stopping the system clock, otherwise the frame in the shift
+ * register is cut off.
+ *
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t avr_uart_flush(void);
+
+/**
+ * @brief Send bytes from program memory on the default UART
+ *
+ * Same as transmit() with data in flash, e.g. a PROGMEM string, read with
+ * LPM as it is sent; see platforms/avr/progmem.h.
+ *
+ * @param data Data in program memory
+ * @param size Number of bytes
+ * @param timeout Timeout in milliseconds (0 for non-blocking)
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t avr_uart_transmit_P(const uint8_t* data, uint16_t size, uint32_t timeout);
+
+/**
+ * @brief Send bytes from program memory on a USART, see avr_uart_transmit_P()
+ * @param uart UART instance
+ * @param data Data in program memory
+ * @param size Number of bytes
+ * @param timeout Timeout in milliseconds (0 for non-blocking)
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t avr_uart_instance_transmit_P(void* uart, const uint8_t* data, uint16_t size, uint32_t timeout);
+
+/**
+ * @brief Register values of a UART configuration
+ */
+typedef struct {
+    uint16_t ubrr;   /*!< Baud rate register, for double speed */
+    uint8_t  ucsrc;  /*!< Frame format */
+} avr_uart_registers_t;
+
+/**
+ * @brief Decode a configuration into register values
+ *
+ * Always inlined: with a constant configuration the baud rate division
+ * and the frame format fold to constants, and init compiles down to the
+ * stores of avr_uart_instance_init_registers().
+ */
+static inline __attribute__((always_inline))
+avr_uart_registers_t avr_uart_registers(const eer_uart_config_t* config) {
+    avr_uart_registers_t registers = {
+        .ubrr = (uint16_t)(((F_CPU) + 4UL * config->baudrate) / (8UL * config->baudrate) - 1UL),
+        .ucsrc = 0
+    };
+    
+    // Character size
+    switch (config->data_bits) {
+        case EER_UART_DATA_BITS_5: break;
+        case EER_UART_DATA_BITS_6: registers.ucsrc |= (1 << UCSZ00); break;
+        case EER_UART_DATA_BITS_7: registers.ucsrc |= (1 << UCSZ01); break;
+        case EER_UART_DATA_BITS_9: registers.ucsrc |= (1 << UCSZ02) | (1 << UCSZ01) | (1 << UCSZ00); break;
+        case EER_UART_DATA_BITS_8:
+        default: registers.ucsrc |= (1 << UCSZ01) | (1 << UCSZ00); break;
+    }
+    
+    switch (config->parity) {
+        case EER_UART_PARITY_EVEN: registers.ucsrc |= (1 << UPM01); break;
+        case EER_UART_PARITY_ODD:  registers.ucsrc |= (1 << UPM01) | (1 << UPM00); break;
+        case EER_UART_PARITY_NONE:
+        default: break;
+    }
+    
+    if (config->stop_bits == EER_UART_STOP_BITS_2) {
+        registers.ucsrc |= (1 << USBS0);
+    }
+    
+    return registers;
+}
+
+/**
+ * @brief Initialize the default UART from register values, see avr_uart_registers()
+ */
+eer_hal_status_t avr_uart_init_registers(avr_uart_registers_t registers);
+
+/**
+ * @brief Initialize a USART from register values, see avr_uart_registers()
+ * @param uart UART instance
+ * @param registers Register values
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t avr_uart_instance_init_registers(void* uart, avr_uart_registers_t registers);
+
+// Operations of eer_avr_uart, called directly by EER_HAL_STATIC builds
+eer_hal_status_t avr_uart_init(eer_uart_config_t* config);
+eer_hal_status_t avr_uart_deinit(void);
+eer_hal_status_t avr_uart_transmit(const uint8_t* data, uint16_t size, uint32_t timeout);
+eer_hal_status_t avr_uart_receive(uint8_t* data, uint16_t size, uint32_t timeout);
+eer_hal_status_t avr_uart_is_tx_ready(bool* ready);
+eer_hal_status_t avr_uart_is_rx_ready(bool* ready);
+eer_hal_status_t avr_uart_register_rx_callback(eer_uart_rx_handler_t handler, void* user_data);
+eer_hal_status_t avr_uart_unregister_rx_callback(void);
+eer_hal_status_t avr_uart_register_tx_callback(eer_uart_tx_handler_t handler, void* user_data);
+eer_hal_status_t avr_uart_unregister_tx_callback(void);
+eer_hal_status_t avr_uart_submit(eer_async_request_t* request);
+
+// Operations of eer_avr_uart_instance, called directly by EER_HAL_STATIC builds
+eer_hal_status_t avr_uart_instance_init(void* uart, eer_uart_config_t* config);
+eer_hal_status_t avr_uart_instance_deinit(void* uart);
+eer_hal_status_t avr_uart_instance_transmit(void* uart, const uint8_t* data, uint16_t size, uint32_t timeout);
+eer_hal_status_t avr_uart_instance_receive(void* uart, uint8_t* data, uint16_t size, uint32_t timeout);
+eer_hal_status_t avr_uart_instance_is_tx_ready(void* uart, bool* ready);
+eer_hal_status_t avr_uart_instance_is_rx_ready(void* uart, bool* ready);
+eer_hal_status_t avr_uart_instance_register_rx_callback(void* uart, eer_uart_rx_handler_t handler, void* user_data);
+eer_hal_status_t avr_uart_instance_unregister_rx_callback(void* uart);
+eer_hal_status_t avr_uart_instance_register_tx_callback(void* uart, eer_uart_tx_handler_t handler, void* user_data);
+eer_hal_status_t avr_uart_instance_unregister_tx_callback(void* uart);
 
 /**
  * @brief AVR UART handler structure
- * This structure contains function pointers for AVR UART operations
+ * This structure contains function pointers for AVR UART operations on the
+ * default UART, USART0 or the only USART of the MCU
  */
 extern eer_uart_handler_t eer_avr_uart;
+
+/**
+ * @brief AVR UART instance handler structure
+ * This structure contains function pointers for AVR UART operations on any USART
+ */
+extern eer_uart_instance_handler_t eer_avr_uart_instance;
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "eer_hal_adc.h"
+#include "platforms/host/host.h"
+
+/**
+ * @brief Number of simulated ADC channels
+ */
+#define EER_HOST_ADC_CHANNELS 8
+
+/**
+ * @brief Host-specific ADC channel structure
+ */
+typedef struct {
+    uint8_t channel;  /*!< ADC channel number (0-7) */
+} eer_adc_channel_t;
+
+/**
+ * @brief Macro to create a host ADC channel
+ * @param ch Channel number (0-7)
+ */
+#define eer_hal_adc_channel(ch) \
+    { ch }
+
+/**
+ * @brief Set the raw value the next conversions of a channel return
+ * @param channel Channel number
+ * @param value Raw value, clipped to the configured resolution
+ */
+void host_adc_set_value(uint8_t channel, uint16_t value);
+
+// Operations of eer_host_adc, called directly by EER_HAL_STATIC builds
+eer_hal_status_t host_adc_init(eer_adc_config_t* config);
+eer_hal_status_t host_adc_deinit(void);
+eer_hal_status_t host_adc_start_conversion(void* channel);
+eer_hal_status_t host_adc_stop_conversion(void);
+eer_hal_status_t host_adc_is_conversion_complete(void* channel, bool* complete);
+eer_hal_status_t host_adc_read(void* channel, uint16_t* value);
+eer_hal_status_t host_adc_read_voltage(void* channel, float* voltage);
+eer_hal_status_t host_adc_register_callback(void* channel, eer_adc_conversion_complete_handler_t handler, void* user_data);
+eer_hal_status_t host_adc_unregister_callback(void* channel);
+
+/**
+ * @brief Host ADC handler structure
+ * This structure contains function pointers for host ADC operations
+ */
+extern eer_adc_handler_t eer_host_adc;
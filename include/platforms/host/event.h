@@ -0,0 +1,20 @@
+/**
+ * @file event.h
+ * @brief Event queue locking on the host
+ *
+ * Included by src/event.c. Emulated interrupts run from host_poll() only,
+ * never in the middle of a post, so no lock is needed.
+ */
+#pragma once
+
+#include <stdint.h>
+
+typedef uint8_t eer_event_lock_t;
+
+static inline eer_event_lock_t eer_event_lock(void) {
+    return 0;
+}
+
+static inline void eer_event_unlock(eer_event_lock_t lock) {
+    (void)lock;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "eer_hal_gpio.h"
+#include "platforms/host/host.h"
+
+/**
+ * @brief Ports of the simulated pin table
+ */
+enum {
+    EER_HOST_PORT_A,
+    EER_HOST_PORT_B,
+    EER_HOST_PORT_C,
+    EER_HOST_PORT_D,
+    EER_HOST_PORT_E,
+    EER_HOST_PORT_F,
+    EER_HOST_PORT_G,
+    EER_HOST_PORT_H,
+    EER_HOST_PORTS
+};
+
+/**
+ * @brief Host-specific pin structure
+ */
+typedef struct {
+    unsigned char port;    /*!< Port index (EER_HOST_PORT_A to EER_HOST_PORT_H) */
+    unsigned char number;  /*!< Pin number (0-7) */
+} eer_pin_t;
+
+/**
+ * @brief Macro to create a host pin structure
+ * @param port Port letter (A to H)
+ * @param pin Pin number (0-7)
+ */
+#define eer_hal_pin(port, pin)                                                  \
+    {                                                                          \
+        EER_HOST_PORT_##port, pin                                              \
+    }
+
+/**
+ * @brief Simulated state of one pin
+ */
+typedef struct {
+    eer_gpio_mode_t    mode;        /*!< Configured mode */
+    eer_gpio_trigger_t trigger;     /*!< Configured interrupt trigger */
+    bool               output;      /*!< Level written by the firmware */
+    bool               driven;      /*!< Input level is driven externally */
+    bool               input;       /*!< Externally driven level */
+    bool               irq_enabled; /*!< Interrupt enabled */
+    bool               irq_pending; /*!< Edge waiting for dispatch */
+} host_gpio_pin_state_t;
+
+/**
+ * @brief Get the simulated state of a pin for inspection
+ * @param pin Pin identifier
+ * @return Pointer to the pin state, NULL for an invalid pin
+ */
+host_gpio_pin_state_t* host_gpio_state(void* pin);
+
+/**
+ * @brief Drive a pin from outside, as a button or another device would
+ *
+ * An edge matching the configured trigger of an enabled pin interrupt is
+ * latched and dispatched on the next host_poll().
+ *
+ * @param pin Pin identifier
+ * @param level Level to drive
+ */
+void host_gpio_drive(void* pin, bool level);
+
+/**
+ * @brief Stop driving a pin, leaving it to its pull resistor
+ * @param pin Pin identifier
+ */
+void host_gpio_release(void* pin);
+
+// Operations of eer_host_gpio, called directly by EER_HAL_STATIC builds
+eer_hal_status_t host_gpio_init(void);
+eer_hal_status_t host_gpio_deinit(void);
+eer_hal_status_t host_gpio_configure(void *pin, eer_gpio_config_t* config);
+eer_hal_status_t host_gpio_write(void *pin, bool value);
+eer_hal_status_t host_gpio_read(void *pin, bool *value);
+eer_hal_status_t host_gpio_toggle(void *pin);
+eer_hal_status_t host_gpio_register_irq(void *pin, eer_gpio_irq_handler_t handler, void* user_data);
+eer_hal_status_t host_gpio_unregister_irq(void *pin);
+eer_hal_status_t host_gpio_enable_irq(void *pin);
+eer_hal_status_t host_gpio_disable_irq(void *pin);
+
+/**
+ * @brief Host GPIO handler structure
+ * This structure contains function pointers for host GPIO operations
+ */
+extern eer_gpio_handler_t eer_host_gpio;
@@ -0,0 +1,10 @@
+#pragma once
+
+#include "eer_hal.h"
+
+/**
+ * @brief Host HAL implementation
+ *
+ * The global eer_hal variable points at the simulated peripherals of the
+ * host platform. Simulation controls are declared in platforms/host/host.h.
+ */
@@ -0,0 +1,156 @@
+/**
+ * @file hal_static.h
+ * @brief Compile-time binding of HAL operations on the host
+ *
+ * Included by eer_hal.h when EER_HAL_STATIC is defined. Every
+ * eer_<peripheral>_<operation> name used by eer_hal_call() resolves to a
+ * direct call of the host implementation.
+ */
+#pragma once
+
+#include "platforms/host/gpio.h"
+#include "platforms/host/adc.h"
+#include "platforms/host/uart.h"
+#include "platforms/host/spi.h"
+#include "platforms/host/i2c.h"
+#include "platforms/host/timer.h"
+#include "platforms/host/system.h"
+#include "platforms/host/power.h"
+#include "platforms/host/nvs.h"
+
+// GPIO
+#define eer_gpio_init host_gpio_init
+#define eer_gpio_deinit host_gpio_deinit
+#define eer_gpio_configure host_gpio_configure
+#define eer_gpio_write host_gpio_write
+#define eer_gpio_read host_gpio_read
+#define eer_gpio_toggle host_gpio_toggle
+#define eer_gpio_register_irq host_gpio_register_irq
+#define eer_gpio_unregister_irq host_gpio_unregister_irq
+#define eer_gpio_enable_irq host_gpio_enable_irq
+#define eer_gpio_disable_irq host_gpio_disable_irq
+
+// ADC
+#define eer_adc_init host_adc_init
+#define eer_adc_deinit host_adc_deinit
+#define eer_adc_start_conversion host_adc_start_conversion
+#define eer_adc_stop_conversion host_adc_stop_conversion
+#define eer_adc_is_conversion_complete host_adc_is_conversion_complete
+#define eer_adc_read host_adc_read
+#define eer_adc_read_voltage host_adc_read_voltage
+#define eer_adc_register_callback host_adc_register_callback
+#define eer_adc_unregister_callback host_adc_unregister_callback
+
+// UART
+#define eer_uart_init host_uart_init
+#define eer_uart_deinit host_uart_deinit
+#define eer_uart_transmit host_uart_transmit
+#define eer_uart_receive host_uart_receive
+#define eer_uart_is_tx_ready host_uart_is_tx_ready
+#define eer_uart_is_rx_ready host_uart_is_rx_ready
+#define eer_uart_register_rx_callback host_uart_register_rx_callback
+#define eer_uart_unregister_rx_callback host_uart_unregister_rx_callback
+#define eer_uart_register_tx_callback host_uart_register_tx_callback
+#define eer_uart_unregister_tx_callback host_uart_unregister_tx_callback
+#define eer_uart_submit host_uart_submit
+
+// UART instances
+#define eer_uart_instance_init host_uart_instance_init
+#define eer_uart_instance_deinit host_uart_instance_deinit
+#define eer_uart_instance_transmit host_uart_instance_transmit
+#define eer_uart_instance_receive host_uart_instance_receive
+#define eer_uart_instance_is_tx_ready host_uart_instance_is_tx_ready
+#define eer_uart_instance_is_rx_ready host_uart_instance_is_rx_ready
+#define eer_uart_instance_register_rx_callback host_uart_instance_register_rx_callback
+#define eer_uart_instance_unregister_rx_callback host_uart_instance_unregister_rx_callback
+#define eer_uart_instance_register_tx_callback host_uart_instance_register_tx_callback
+#define eer_uart_instance_unregister_tx_callback host_uart_instance_unregister_tx_callback
+
+// SPI
+#define eer_spi_init host_spi_init
+#define eer_spi_deinit host_spi_deinit
+#define eer_spi_transfer host_spi_transfer
+#define eer_spi_transmit host_spi_transmit
+#define eer_spi_receive host_spi_receive
+#define eer_spi_is_ready host_spi_is_ready
+#define eer_spi_chip_select host_spi_chip_select
+#define eer_spi_set_prescaler host_spi_set_prescaler
+#define eer_spi_register_callback host_spi_register_callback
+#define eer_spi_unregister_callback host_spi_unregister_callback
+#define eer_spi_submit host_spi_submit
+
+// I2C
+#define eer_i2c_init host_i2c_init
+#define eer_i2c_deinit host_i2c_deinit
+#define eer_i2c_master_transmit host_i2c_master_transmit
+#define eer_i2c_master_receive host_i2c_master_receive
+#define eer_i2c_master_transmit_receive host_i2c_master_transmit_receive
+#define eer_i2c_is_busy host_i2c_is_busy
+#define eer_i2c_scan host_i2c_scan
+#define eer_i2c_register_callback host_i2c_register_callback
+#define eer_i2c_unregister_callback host_i2c_unregister_callback
+#define eer_i2c_submit host_i2c_submit
+
+// Timer
+#define eer_timer_init host_timer_init
+#define eer_timer_deinit host_timer_deinit
+#define eer_timer_start host_timer_start
+#define eer_timer_stop host_timer_stop
+#define eer_timer_set_period host_timer_set_period
+#define eer_timer_get_value host_timer_get_value
+#define eer_timer_set_compare host_timer_set_compare
+#define eer_timer_set_pwm_duty_cycle host_timer_set_pwm_duty_cycle
+#define eer_timer_us_to_ticks host_timer_us_to_ticks
+#define eer_timer_ticks_to_us host_timer_ticks_to_us
+#define eer_timer_register_callback host_timer_register_callback
+#define eer_timer_unregister_callback host_timer_unregister_callback
+#define eer_timer_set_capture_edge host_timer_set_capture_edge
+
+// Timer instances
+#define eer_timer_instance_init host_timer_instance_init
+#define eer_timer_instance_deinit host_timer_instance_deinit
+#define eer_timer_instance_start host_timer_instance_start
+#define eer_timer_instance_stop host_timer_instance_stop
+#define eer_timer_instance_set_period host_timer_instance_set_period
+#define eer_timer_instance_get_value host_timer_instance_get_value
+#define eer_timer_instance_set_compare host_timer_instance_set_compare
+#define eer_timer_instance_set_pwm_duty_cycle host_timer_instance_set_pwm_duty_cycle
+#define eer_timer_instance_us_to_ticks host_timer_instance_us_to_ticks
+#define eer_timer_instance_ticks_to_us host_timer_instance_ticks_to_us
+#define eer_timer_instance_register_callback host_timer_instance_register_callback
+#define eer_timer_instance_unregister_callback host_timer_instance_unregister_callback
+#define eer_timer_instance_set_capture_edge host_timer_instance_set_capture_edge
+
+// System
+#define eer_system_init host_system_init
+#define eer_system_deinit host_system_deinit
+#define eer_system_reset host_system_reset
+#define eer_system_disable_interrupts host_system_disable_interrupts
+#define eer_system_enable_interrupts host_system_enable_interrupts
+#define eer_system_delay_ms host_system_delay_ms
+#define eer_system_delay_us host_system_delay_us
+#define eer_system_get_tick host_system_get_tick
+#define eer_system_get_uptime_ms host_system_get_uptime_ms
+
+// Power
+#define eer_power_init host_power_init
+#define eer_power_deinit host_power_deinit
+#define eer_power_set_mode host_power_set_mode
+#define eer_power_get_mode host_power_get_mode
+#define eer_power_enable_wakeup_source host_power_enable_wakeup_source
+#define eer_power_disable_wakeup_source host_power_disable_wakeup_source
+#define eer_power_get_wakeup_source host_power_get_wakeup_source
+#define eer_power_get_voltage host_power_get_voltage
+#define eer_power_get_power_consumption host_power_get_power_consumption
+
+// Storage
+#define eer_nvs_init host_nvs_init
+#define eer_nvs_deinit host_nvs_deinit
+#define eer_nvs_read host_nvs_read
+#define eer_nvs_write host_nvs_write
+#define eer_nvs_erase host_nvs_erase
+#define eer_nvs_flush host_nvs_flush
+#define eer_nvs_is_busy host_nvs_is_busy
+#define eer_nvs_get_size host_nvs_get_size
+#define eer_nvs_register_callback host_nvs_register_callback
+#define eer_nvs_unregister_callback host_nvs_unregister_callback
@@ -0,0 +1,122 @@
+/**
+ * @file host.h
+ * @brief Simulation control of the host platform
+ *
+ * The host platform runs the HAL as a normal Linux process. Interrupts are
+ * emulated: peripheral events (received bytes, timer matches, pin edges,
+ * completed conversions and writes) are latched as pending and dispatched
+ * by host_poll(), which the HAL calls from delays, sleeps and blocking
+ * waits. While interrupts are disabled, or while a handler runs, events
+ * stay pending like interrupt flags do on a microcontroller.
+ *
+ * Time comes from a virtual clock by default: it only advances through
+ * delays, sleeps, blocking waits and host_advance_us(), so tests run at
+ * full speed and give the same result on every run. Busy loops polling
+ * get_tick() never see time pass on the virtual clock; select the
+ * monotonic clock for firmware that waits that way.
+ */
+#pragma once
+
+#include "eer_hal_power.h"
+#include "eer_hal_system.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+struct pollfd;
+
+/**
+ * @brief Supply voltage reported by the power handler and used as the ADC
+ *        VCC reference, in millivolts
+ */
+#ifndef EER_HOST_VCC_MV
+#define EER_HOST_VCC_MV 3300
+#endif
+
+/**
+ * @brief Time value of an event that never happens
+ */
+#define HOST_TIME_NEVER UINT64_MAX
+
+/**
+ * @brief Clock sources
+ */
+typedef enum {
+    HOST_CLOCK_VIRTUAL,    /*!< Simulated time, advanced by the HAL only */
+    HOST_CLOCK_MONOTONIC   /*!< Wall-clock time of CLOCK_MONOTONIC */
+} host_clock_t;
+
+/**
+ * @brief Select the clock source and restart time at zero
+ * @param clock Clock source
+ */
+void host_clock_select(host_clock_t clock);
+
+/**
+ * @brief Get the time since the clock was started
+ * @return Time in microseconds
+ */
+uint64_t host_time_us(void);
+
+/**
+ * @brief Let time pass, dispatching every event that falls due on the way
+ *
+ * The virtual clock jumps from one timer event to the next; the monotonic
+ * clock sleeps.
+ *
+ * @param us Time in microseconds
+ */
+void host_advance_us(uint64_t us);
+
+/**
+ * @brief Wait for the next event or until a point in time
+ *
+ * Blocks on the UART input while it waits, so bytes from a pty or pipe
+ * end the wait. On the virtual clock the time spent blocked is added to
+ * the clock.
+ *
+ * @param until Time in microseconds, HOST_TIME_NEVER to wait for an event
+ * @return true if time reached until, false if an event ended the wait
+ */
+bool host_wait_until(uint64_t until);
+
+/**
+ * @brief Dispatch pending events unless interrupts are disabled
+ */
+void host_poll(void);
+
+/**
+ * @brief Check if emulated interrupts are enabled and no handler is running
+ * @return true if events are dispatched
+ */
+bool host_interrupts_enabled(void);
+
+/**
+ * @brief Set the handler run by a system reset instead of exiting
+ * @param handler Function that restarts the application, NULL to exit
+ *
+ * The handler may longjmp back into the test; if it returns, the process
+ * exits with status 0.
+ */
+void host_system_set_reset_handler(void (*handler)(eer_system_reset_type_t type));
+
+/*
+ * Peripheral hooks for the emulated interrupt controller. Each poll
+ * function dispatches the peripheral's pending events, each deadline
+ * function returns the time of its next timed event or HOST_TIME_NEVER.
+ */
+void host_gpio_poll(void);
+void host_adc_poll(void);
+void host_uart_poll(void);
+void host_timer_poll(void);
+void host_nvs_poll(void);
+void host_spi_poll(void);
+void host_i2c_poll(void);
+uint64_t host_timer_deadline(void);
+/**
+ * @brief Collect the descriptors a wait can block on for UART input
+ * @param[out] fds Poll entries to fill
+ * @param size Number of entries in fds
+ * @return Number of descriptors, which may exceed size
+ */
+int host_uart_wait_fds(struct pollfd* fds, int size);
+void host_power_wakeup(eer_wakeup_source_t source, uint8_t pin_or_id);
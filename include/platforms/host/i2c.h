@@ -0,0 +1,81 @@
+#pragma once
+
+#include "eer_hal_i2c.h"
+#include "eer_hal_async.h"
+#include "platforms/host/host.h"
+
+/**
+ * @brief Model of a device on the simulated I2C bus
+ *
+ * Transfers to an address without an attached device are not acknowledged.
+ */
+typedef struct host_i2c_device {
+    uint16_t address;                       /*!< 7-bit device address */
+    
+    /**
+     * @brief Receive the bytes of a write transfer
+     * @param device Device model
+     * @param data Bytes written by the master
+     * @param size Number of bytes
+     * @return EER_HAL_OK to acknowledge, any other status to NACK
+     */
+    eer_hal_status_t (*write)(struct host_i2c_device* device, const uint8_t* data, uint16_t size);
+    
+    /**
+     * @brief Provide the bytes of a read transfer
+     * @param device Device model
+     * @param[out] data Buffer for the bytes read by the master
+     * @param size Number of bytes
+     * @return EER_HAL_OK to acknowledge, any other status to NACK
+     */
+    eer_hal_status_t (*read)(struct host_i2c_device* device, uint8_t* data, uint16_t size);
+    
+    void* context;                          /*!< Model state */
+    struct host_i2c_device* next;           /*!< Managed by host_i2c_attach() */
+} host_i2c_device_t;
+
+/**
+ * @brief Host-specific I2C structure
+ */
+typedef struct {
+    eer_i2c_config_t   config;   /*!< Current configuration */
+    host_i2c_device_t* devices;  /*!< Attached device models */
+} eer_i2c_t;
+
+/**
+ * @brief Macro to create a host I2C structure
+ */
+#define eer_hal_i2c0() \
+    { {0}, NULL }
+
+/**
+ * @brief Attach a device model to the bus
+ * @param device Device model, stays owned by the caller
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t host_i2c_attach(host_i2c_device_t* device);
+
+/**
+ * @brief Detach a device model from the bus
+ * @param device Device model
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t host_i2c_detach(host_i2c_device_t* device);
+
+// Operations of eer_host_i2c, called directly by EER_HAL_STATIC builds
+eer_hal_status_t host_i2c_init(eer_i2c_config_t* config);
+eer_hal_status_t host_i2c_deinit(void);
+eer_hal_status_t host_i2c_master_transmit(uint16_t address, const uint8_t* data, uint16_t size, uint32_t timeout);
+eer_hal_status_t host_i2c_master_receive(uint16_t address, uint8_t* data, uint16_t size, uint32_t timeout);
+eer_hal_status_t host_i2c_master_transmit_receive(uint16_t address, const uint8_t* tx_data, uint16_t tx_size, uint8_t* rx_data, uint16_t rx_size, uint32_t timeout);
+eer_hal_status_t host_i2c_is_busy(bool* busy);
+eer_hal_status_t host_i2c_scan(uint16_t* devices, uint8_t max_devices, uint8_t* found_devices);
+eer_hal_status_t host_i2c_register_callback(eer_i2c_transfer_handler_t handler, void* user_data);
+eer_hal_status_t host_i2c_unregister_callback(void);
+eer_hal_status_t host_i2c_submit(eer_async_request_t* request);
+
+/**
+ * @brief Host I2C handler structure
+ * This structure contains function pointers for host I2C operations
+ */
+extern eer_i2c_handler_t eer_host_i2c;
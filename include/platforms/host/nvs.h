@@ -0,0 +1,44 @@
+#pragma once
+
+#include "eer_hal_nvs.h"
+#include "platforms/host/host.h"
+
+/**
+ * @brief Size of the simulated storage in bytes
+ */
+#ifndef EER_HOST_NVS_SIZE
+#define EER_HOST_NVS_SIZE 1024
+#endif
+
+/**
+ * @brief Get the simulated storage array
+ * @return EER_HOST_NVS_SIZE bytes, erased to EER_NVS_ERASED_BYTE at start
+ *
+ * Tests may inspect the contents or corrupt them to model power loss.
+ */
+uint8_t* host_nvs_memory(void);
+
+/**
+ * @brief Back the storage with a file so contents survive a restart
+ * @param path File to load from and write through to, created if missing
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t host_nvs_open(const char* path);
+
+// Operations of eer_host_nvs, called directly by EER_HAL_STATIC builds
+eer_hal_status_t host_nvs_init(void);
+eer_hal_status_t host_nvs_deinit(void);
+eer_hal_status_t host_nvs_read(uint32_t address, uint8_t* data, uint16_t size);
+eer_hal_status_t host_nvs_write(uint32_t address, const uint8_t* data, uint16_t size, uint32_t timeout);
+eer_hal_status_t host_nvs_erase(uint32_t address, uint16_t size, uint32_t timeout);
+eer_hal_status_t host_nvs_flush(uint32_t timeout);
+eer_hal_status_t host_nvs_is_busy(bool* busy);
+eer_hal_status_t host_nvs_get_size(uint32_t* size);
+eer_hal_status_t host_nvs_register_callback(eer_nvs_write_handler_t handler, void* user_data);
+eer_hal_status_t host_nvs_unregister_callback(void);
+
+/**
+ * @brief Host storage handler structure
+ * This structure contains function pointers for host storage operations
+ */
+extern eer_nvs_handler_t eer_host_nvs;
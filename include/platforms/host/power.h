@@ -0,0 +1,31 @@
+#pragma once
+
+#include "eer_hal_power.h"
+#include "platforms/host/host.h"
+
+/*
+ * Sleep on the host
+ *
+ * Sleep modes block in host_wait_until() until an event wakes the device.
+ * EER_POWER_MODE_SLEEP wakes on any event, like idle mode; the deeper modes
+ * only on sources enabled with enable_wakeup_source(). Sleeping with no
+ * event that could ever arrive (no running timer, no UART input attached)
+ * returns EER_HAL_ERROR instead of hanging the process.
+ */
+
+// Operations of eer_host_power, called directly by EER_HAL_STATIC builds
+eer_hal_status_t host_power_init(void);
+eer_hal_status_t host_power_deinit(void);
+eer_hal_status_t host_power_set_mode(eer_power_mode_t mode);
+eer_hal_status_t host_power_get_mode(eer_power_mode_t* mode);
+eer_hal_status_t host_power_enable_wakeup_source(eer_wakeup_source_t source, uint8_t pin_or_id);
+eer_hal_status_t host_power_disable_wakeup_source(eer_wakeup_source_t source, uint8_t pin_or_id);
+eer_hal_status_t host_power_get_wakeup_source(eer_wakeup_source_t* source, uint8_t* pin_or_id);
+eer_hal_status_t host_power_get_voltage(uint16_t* voltage_mv);
+eer_hal_status_t host_power_get_power_consumption(uint16_t* power_mw);
+
+/**
+ * @brief Host power handler structure
+ * This structure contains function pointers for host power management operations
+ */
+extern eer_power_handler_t eer_host_power;
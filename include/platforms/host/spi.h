@@ -0,0 +1,90 @@
+#pragma once
+
+#include "eer_hal_spi.h"
+#include "eer_hal_async.h"
+#include "platforms/host/gpio.h"
+
+/**
+ * @brief Model of a device on the simulated SPI bus
+ *
+ * A device answers while its chip select pin is asserted through
+ * chip_select(). Several devices may share the bus, each with its own pin.
+ */
+typedef struct host_spi_device {
+    eer_pin_t cs;                           /*!< Chip select pin of the device */
+    
+    /**
+     * @brief Called when the device is selected or deselected (optional)
+     * @param device Device model
+     * @param selected true on assertion, false on release
+     */
+    void (*select)(struct host_spi_device* device, bool selected);
+    
+    /**
+     * @brief Exchange one byte
+     * @param device Device model
+     * @param data Byte shifted out by the master
+     * @return Byte shifted in from the device
+     */
+    uint8_t (*exchange)(struct host_spi_device* device, uint8_t data);
+    
+    void* context;                          /*!< Model state */
+    struct host_spi_device* next;           /*!< Managed by host_spi_attach() */
+} host_spi_device_t;
+
+/**
+ * @brief Host-specific SPI structure
+ */
+typedef struct {
+    eer_spi_config_t   config;    /*!< Current configuration */
+    host_spi_device_t* devices;   /*!< Attached device models */
+    host_spi_device_t* selected;  /*!< Device answering transfers, NULL if none */
+} eer_spi_t;
+
+/**
+ * @brief Macro to create a host SPI structure
+ */
+#define eer_hal_spi0() \
+    { {0}, NULL, NULL }
+
+/**
+ * @brief Attach a device model to the bus
+ * @param device Device model, stays owned by the caller
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t host_spi_attach(host_spi_device_t* device);
+
+/**
+ * @brief Detach a device model from the bus
+ * @param device Device model
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t host_spi_detach(host_spi_device_t* device);
+
+/**
+ * @brief Current configuration of the bus
+ *
+ * Lets a device model check the clock it is driven at.
+ *
+ * @return Configuration, prescaler included
+ */
+const eer_spi_config_t* host_spi_config(void);
+
+// Operations of eer_host_spi, called directly by EER_HAL_STATIC builds
+eer_hal_status_t host_spi_init(eer_spi_config_t* config);
+eer_hal_status_t host_spi_deinit(void);
+eer_hal_status_t host_spi_transfer(const uint8_t* tx_data, uint8_t* rx_data, uint16_t size, uint32_t timeout);
+eer_hal_status_t host_spi_transmit(const uint8_t* data, uint16_t size, uint32_t timeout);
+eer_hal_status_t host_spi_receive(uint8_t* data, uint16_t size, uint32_t timeout);
+eer_hal_status_t host_spi_is_ready(bool* ready);
+eer_hal_status_t host_spi_chip_select(void* pin, bool state);
+eer_hal_status_t host_spi_set_prescaler(eer_spi_prescaler_t prescaler);
+eer_hal_status_t host_spi_register_callback(eer_spi_transfer_handler_t handler, void* user_data);
+eer_hal_status_t host_spi_unregister_callback(void);
+eer_hal_status_t host_spi_submit(eer_async_request_t* request);
+
+/**
+ * @brief Host SPI handler structure
+ * This structure contains function pointers for host SPI operations
+ */
+extern eer_spi_handler_t eer_host_spi;
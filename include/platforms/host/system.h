@@ -0,0 +1,21 @@
+#pragma once
+
+#include "eer_hal_system.h"
+#include "platforms/host/host.h"
+
+// Operations of eer_host_system, called directly by EER_HAL_STATIC builds
+eer_hal_status_t host_system_init(void);
+eer_hal_status_t host_system_deinit(void);
+eer_hal_status_t host_system_reset(eer_system_reset_type_t reset_type);
+eer_hal_status_t host_system_disable_interrupts(void);
+eer_hal_status_t host_system_enable_interrupts(void);
+eer_hal_status_t host_system_delay_ms(uint32_t ms);
+eer_hal_status_t host_system_delay_us(uint32_t us);
+eer_hal_status_t host_system_get_tick(uint32_t* ticks);
+eer_hal_status_t host_system_get_uptime_ms(uint32_t* uptime);
+
+/**
+ * @brief Host system handler structure
+ * This structure contains function pointers for host system operations
+ */
+extern eer_system_handler_t eer_host_system;
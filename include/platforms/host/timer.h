@@ -0,0 +1,123 @@
+#pragma once
+
+#include "eer_hal_timer.h"
+#include "platforms/host/host.h"
+
+/**
+ * @brief Counter clock used when the configuration leaves it at zero, the
+ *        Timer1 clock of a 16 MHz AVR with prescaler 8
+ */
+#ifndef EER_HOST_TIMER_FREQUENCY
+#define EER_HOST_TIMER_FREQUENCY 2000000UL
+#endif
+
+/**
+ * @brief Host-specific timer structure, the state block of one timer
+ *
+ * The counter is derived from the clock: it counts up at frequency from
+ * zero to period - 1 (65535 if period is 0) and wraps with an overflow
+ * event. Compare events fire when the counter reaches compare[channel].
+ * Any number of instances can be created with eer_hal_timer0().
+ */
+typedef struct eer_timer {
+    uint32_t         frequency;   /*!< Counter clock in Hz */
+    uint32_t         period;      /*!< Counter top + 1, 0 for 65536 */
+    uint32_t         compare[2];  /*!< Compare values of channels 0 and 1 */
+    uint32_t         capture;     /*!< Counter value of the last capture */
+    eer_timer_mode_t mode;        /*!< Operating mode */
+    bool             running;     /*!< Counter is clocked */
+    uint64_t         ticks;       /*!< Ticks counted before the last start */
+    uint64_t         started;     /*!< Clock time of the last start in microseconds */
+    uint64_t         dispatched;  /*!< Ticks up to which events were dispatched */
+    
+    bool             capture_pending;             /*!< Capture latched and not yet dispatched */
+    bool             capture_rising;              /*!< Capture on rising rather than falling edges */
+    bool             capture_level;               /*!< Level of the capture input */
+    eer_timer_event_handler_t overflow_handler;   /*!< Overflow callback */
+    void*            overflow_user_data;          /*!< User data of the overflow callback */
+    eer_timer_event_handler_t compare_handler[2]; /*!< Compare callbacks of channels 0 and 1 */
+    void*            compare_user_data[2];        /*!< User data of the compare callbacks */
+    eer_timer_event_handler_t capture_handler;    /*!< Capture callback */
+    void*            capture_user_data;           /*!< User data of the capture callback */
+    struct eer_timer* next;       /*!< Managed by the driver */
+} eer_timer_t;
+
+/**
+ * @brief Macro to create a stopped host timer structure
+ */
+#define eer_hal_timer0() \
+    { .frequency = EER_HOST_TIMER_FREQUENCY, .mode = EER_TIMER_MODE_CONTINUOUS }
+
+/**
+ * @brief Get the simulated state of the default timer
+ * @return Timer state, read-only
+ */
+const eer_timer_t* host_timer_state(void);
+
+/**
+ * @brief Latch the counter of the default timer as if an edge arrived on
+ *        the capture input
+ *
+ * The capture event is dispatched like an interrupt.
+ */
+void host_timer_capture(void);
+
+/**
+ * @brief Latch the counter of a timer instance as if an edge arrived on
+ *        the capture input
+ * @param timer Timer instance
+ */
+void host_timer_instance_capture(void* timer);
+
+/**
+ * @brief Drive the capture input of a timer instance
+ *
+ * A change to the level that matches the selected edge latches the counter
+ * like host_timer_instance_capture(); the other edge only changes the level.
+ *
+ * @param timer Timer instance
+ * @param level New level of the input
+ */
+void host_timer_instance_capture_input(void* timer, bool level);
+
+// Operations of eer_host_timer, called directly by EER_HAL_STATIC builds
+eer_hal_status_t host_timer_init(eer_timer_config_t* config);
+eer_hal_status_t host_timer_deinit(void);
+eer_hal_status_t host_timer_start(void);
+eer_hal_status_t host_timer_stop(void);
+eer_hal_status_t host_timer_set_period(uint32_t period);
+eer_hal_status_t host_timer_get_value(uint32_t* value);
+eer_hal_status_t host_timer_set_compare(uint8_t channel, uint32_t value);
+eer_hal_status_t host_timer_set_pwm_duty_cycle(uint8_t channel, uint8_t duty_cycle);
+uint32_t host_timer_us_to_ticks(uint32_t us);
+uint32_t host_timer_ticks_to_us(uint32_t ticks);
+eer_hal_status_t host_timer_register_callback(eer_timer_event_t event, uint8_t channel, eer_timer_event_handler_t handler, void* user_data);
+eer_hal_status_t host_timer_unregister_callback(eer_timer_event_t event, uint8_t channel);
+eer_hal_status_t host_timer_set_capture_edge(bool rising);
+
+// Operations of eer_host_timer_instance, called directly by EER_HAL_STATIC builds
+eer_hal_status_t host_timer_instance_init(void* timer, eer_timer_config_t* config);
+eer_hal_status_t host_timer_instance_deinit(void* timer);
+eer_hal_status_t host_timer_instance_start(void* timer);
+eer_hal_status_t host_timer_instance_stop(void* timer);
+eer_hal_status_t host_timer_instance_set_period(void* timer, uint32_t period);
+eer_hal_status_t host_timer_instance_get_value(void* timer, uint32_t* value);
+eer_hal_status_t host_timer_instance_set_compare(void* timer, uint8_t channel, uint32_t value);
+eer_hal_status_t host_timer_instance_set_pwm_duty_cycle(void* timer, uint8_t channel, uint8_t duty_cycle);
+uint32_t host_timer_instance_us_to_ticks(void* timer, uint32_t us);
+uint32_t host_timer_instance_ticks_to_us(void* timer, uint32_t ticks);
+eer_hal_status_t host_timer_instance_register_callback(void* timer, eer_timer_event_t event, uint8_t channel, eer_timer_event_handler_t handler, void* user_data);
+eer_hal_status_t host_timer_instance_unregister_callback(void* timer, eer_timer_event_t event, uint8_t channel);
+eer_hal_status_t host_timer_instance_set_capture_edge(void* timer, bool rising);
+
+/**
+ * @brief Host timer handler structure
+ * This structure contains function pointers for host timer operations on the default timer
+ */
+extern eer_timer_handler_t eer_host_timer;
+
+/**
+ * @brief Host timer instance handler structure
+ * This structure contains function pointers for host timer operations on any instance
+ */
+extern eer_timer_instance_handler_t eer_host_timer_instance;
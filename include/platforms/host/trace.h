@@ -0,0 +1,31 @@
+/**
+ * @file trace.h
+ * @brief Trace timestamp and slot locking on the host
+ *
+ * Included by eer_trace.h when EER_HAL_TRACE is defined. The timestamp
+ * follows the AVR format on the host clock: milliseconds modulo 256 and
+ * 4 us steps within the millisecond. Emulated interrupts run from
+ * host_poll() only, never in the middle of a record, so no lock is needed.
+ */
+#pragma once
+
+#include "platforms/host/host.h"
+
+#define EER_TRACE_TICK_US 1000
+#define EER_TRACE_SUB_PER_TICK 250
+
+typedef uint8_t eer_trace_lock_t;
+
+static inline uint16_t eer_trace_timestamp(void) {
+    uint64_t us = host_time_us();
+    
+    return (uint16_t)((us / 1000) % 256) << 8 | (uint16_t)(us % 1000 / 4);
+}
+
+static inline eer_trace_lock_t eer_trace_lock(void) {
+    return 0;
+}
+
+static inline void eer_trace_unlock(eer_trace_lock_t lock) {
+    (void)lock;
+}
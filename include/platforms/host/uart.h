@@ -0,0 +1,119 @@
+#pragma once
+
+#include "eer_hal_uart.h"
+#include "eer_hal_async.h"
+#include "platforms/host/host.h"
+#include <stddef.h>
+
+/**
+ * @brief Size of the receive buffer of each UART instance in bytes
+ */
+#ifndef EER_HOST_UART_RX_SIZE
+#define EER_HOST_UART_RX_SIZE 256
+#endif
+
+/**
+ * @brief Host-specific UART structure, the state block of one UART
+ *
+ * Any number of instances can be created with eer_hal_uart0(); each is
+ * backed by its own descriptors and polled while it is initialized or
+ * attached.
+ */
+typedef struct eer_uart {
+    int rx_fd;  /*!< Descriptor received bytes are read from, -1 if none */
+    int tx_fd;  /*!< Descriptor transmitted bytes are written to, -1 to discard */
+    
+    uint8_t  rx_buffer[EER_HOST_UART_RX_SIZE]; /*!< Bytes read and not yet received */
+    uint16_t rx_head;      /*!< Write index of rx_buffer */
+    uint16_t rx_tail;      /*!< Read index of rx_buffer */
+    uint16_t rx_reported;  /*!< Start of the bytes not yet reported to the receive callback */
+    bool     rx_closed;    /*!< End of input was reached on rx_fd */
+    bool     tx_pending;   /*!< Transmit complete event waiting for dispatch */
+    eer_uart_rx_handler_t rx_handler; /*!< Receive callback */
+    void*    rx_user_data;            /*!< User data of the receive callback */
+    eer_uart_tx_handler_t tx_handler; /*!< Transmit complete callback */
+    void*    tx_user_data;            /*!< User data of the transmit complete callback */
+    eer_async_queue_t async;          /*!< Asynchronous requests, run by the poll */
+    struct eer_uart* next; /*!< Managed by the driver */
+} eer_uart_t;
+
+/**
+ * @brief Macro to create a host UART structure without a backing descriptor
+ */
+#define eer_hal_uart0() \
+    { .rx_fd = -1, .tx_fd = -1 }
+
+/**
+ * @brief Back UART0 with a new pseudo-terminal
+ *
+ * Terminal programs and serial tools can open the slave side like a USB
+ * serial adapter. The line is raw, baud rate settings have no effect.
+ *
+ * @param[out] name Buffer for the path of the slave device
+ * @param size Size of the buffer
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t host_uart_open_pty(char* name, size_t size);
+
+/**
+ * @brief Back UART0 with existing descriptors such as pipes or stdio
+ * @param rx_fd Descriptor to read received bytes from, -1 for none
+ * @param tx_fd Descriptor to write transmitted bytes to, -1 to discard
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t host_uart_attach(int rx_fd, int tx_fd);
+
+/**
+ * @brief Back a UART instance with a new pseudo-terminal
+ * @param uart UART instance
+ * @param[out] name Buffer for the path of the slave device
+ * @param size Size of the buffer
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t host_uart_instance_open_pty(void* uart, char* name, size_t size);
+
+/**
+ * @brief Back a UART instance with existing descriptors
+ * @param uart UART instance
+ * @param rx_fd Descriptor to read received bytes from, -1 for none
+ * @param tx_fd Descriptor to write transmitted bytes to, -1 to discard
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t host_uart_instance_attach(void* uart, int rx_fd, int tx_fd);
+
+// Operations of eer_host_uart, called directly by EER_HAL_STATIC builds
+eer_hal_status_t host_uart_init(eer_uart_config_t* config);
+eer_hal_status_t host_uart_deinit(void);
+eer_hal_status_t host_uart_transmit(const uint8_t* data, uint16_t size, uint32_t timeout);
+eer_hal_status_t host_uart_receive(uint8_t* data, uint16_t size, uint32_t timeout);
+eer_hal_status_t host_uart_is_tx_ready(bool* ready);
+eer_hal_status_t host_uart_is_rx_ready(bool* ready);
+eer_hal_status_t host_uart_register_rx_callback(eer_uart_rx_handler_t handler, void* user_data);
+eer_hal_status_t host_uart_unregister_rx_callback(void);
+eer_hal_status_t host_uart_register_tx_callback(eer_uart_tx_handler_t handler, void* user_data);
+eer_hal_status_t host_uart_unregister_tx_callback(void);
+eer_hal_status_t host_uart_submit(eer_async_request_t* request);
+
+// Operations of eer_host_uart_instance, called directly by EER_HAL_STATIC builds
+eer_hal_status_t host_uart_instance_init(void* uart, eer_uart_config_t* config);
+eer_hal_status_t host_uart_instance_deinit(void* uart);
+eer_hal_status_t host_uart_instance_transmit(void* uart, const uint8_t* data, uint16_t size, uint32_t timeout);
+eer_hal_status_t host_uart_instance_receive(void* uart, uint8_t* data, uint16_t size, uint32_t timeout);
+eer_hal_status_t host_uart_instance_is_tx_ready(void* uart, bool* ready);
+eer_hal_status_t host_uart_instance_is_rx_ready(void* uart, bool* ready);
+eer_hal_status_t host_uart_instance_register_rx_callback(void* uart, eer_uart_rx_handler_t handler, void* user_data);
+eer_hal_status_t host_uart_instance_unregister_rx_callback(void* uart);
+eer_hal_status_t host_uart_instance_register_tx_callback(void* uart, eer_uart_tx_handler_t handler, void* user_data);
+eer_hal_status_t host_uart_instance_unregister_tx_callback(void* uart);
+
+/**
+ * @brief Host UART handler structure
+ * This structure contains function pointers for host UART operations on UART0
+ */
+extern eer_uart_handler_t eer_host_uart;
+
+/**
+ * @brief Host UART instance handler structure
+ * This structure contains function pointers for host UART operations on any instance
+ */
+extern eer_uart_instance_handler_t eer_host_uart_instance;
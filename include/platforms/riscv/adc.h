@@ -0,0 +1,41 @@
+#pragma once
+
+#include "eer_hal_adc.h"
+#include "platforms/riscv/riscv.h"
+
+/*
+ * The emulated machines have no ADC: every operation reports
+ * EER_HAL_NOT_SUPPORTED. Channels can still be declared, so portable code
+ * builds unchanged.
+ */
+
+/**
+ * @brief RISC-V-specific ADC channel structure
+ */
+typedef struct {
+    uint8_t channel;  /*!< ADC channel number */
+} eer_adc_channel_t;
+
+/**
+ * @brief Macro to create a RISC-V ADC channel
+ * @param ch Channel number
+ */
+#define eer_hal_adc_channel(ch) \
+    { ch }
+
+// Operations of eer_riscv_adc, called directly by EER_HAL_STATIC builds
+eer_hal_status_t riscv_adc_init(eer_adc_config_t* config);
+eer_hal_status_t riscv_adc_deinit(void);
+eer_hal_status_t riscv_adc_start_conversion(void* channel);
+eer_hal_status_t riscv_adc_stop_conversion(void);
+eer_hal_status_t riscv_adc_is_conversion_complete(void* channel, bool* complete);
+eer_hal_status_t riscv_adc_read(void* channel, uint16_t* value);
+eer_hal_status_t riscv_adc_read_voltage(void* channel, float* voltage);
+eer_hal_status_t riscv_adc_register_callback(void* channel, eer_adc_conversion_complete_handler_t handler, void* user_data);
+eer_hal_status_t riscv_adc_unregister_callback(void* channel);
+
+/**
+ * @brief RISC-V ADC handler structure
+ * This structure contains function pointers for RISC-V ADC operations
+ */
+extern eer_adc_handler_t eer_riscv_adc;
@@ -0,0 +1,20 @@
+/**
+ * @file event.h
+ * @brief Event queue locking on RISC-V
+ *
+ * Included by src/event.c. Posts may come from interrupts, so the queue is
+ * updated with machine interrupts disabled.
+ */
+#pragma once
+
+#include "platforms/riscv/riscv.h"
+
+typedef unsigned long eer_event_lock_t;
+
+static inline eer_event_lock_t eer_event_lock(void) {
+    return riscv_interrupts_lock();
+}
+
+static inline void eer_event_unlock(eer_event_lock_t lock) {
+    riscv_interrupts_restore(lock);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "eer_hal_gpio.h"
+#include "platforms/riscv/riscv.h"
+
+/**
+ * @brief Ports of eer_hal_pin(), eight pins each of the one GPIO block
+ */
+enum {
+    EER_RISCV_PORT_A,
+    EER_RISCV_PORT_B,
+    EER_RISCV_PORT_C,
+    EER_RISCV_PORT_D
+};
+
+/**
+ * @brief RISC-V-specific pin structure
+ */
+typedef struct {
+    unsigned char number;  /*!< Bit of the pin in the GPIO registers */
+} eer_pin_t;
+
+/**
+ * @brief Macro to create a RISC-V pin structure
+ * @param port Port letter (A to D), selecting pins 0-7, 8-15, 16-23 or 24-31
+ * @param pin Pin number (0-7)
+ *
+ * Machines without a GPIO block, such as virt, accept pins but every GPIO
+ * operation reports EER_HAL_NOT_SUPPORTED.
+ */
+#define eer_hal_pin(port, pin)                                                  \
+    {                                                                          \
+        EER_RISCV_PORT_##port * 8 + (pin)                                      \
+    }
+
+// Operations of eer_riscv_gpio, called directly by EER_HAL_STATIC builds
+eer_hal_status_t riscv_gpio_init(void);
+eer_hal_status_t riscv_gpio_deinit(void);
+eer_hal_status_t riscv_gpio_configure(void *pin, eer_gpio_config_t* config);
+eer_hal_status_t riscv_gpio_write(void *pin, bool value);
+eer_hal_status_t riscv_gpio_read(void *pin, bool *value);
+eer_hal_status_t riscv_gpio_toggle(void *pin);
+eer_hal_status_t riscv_gpio_register_irq(void *pin, eer_gpio_irq_handler_t handler, void* user_data);
+eer_hal_status_t riscv_gpio_unregister_irq(void *pin);
+eer_hal_status_t riscv_gpio_enable_irq(void *pin);
+eer_hal_status_t riscv_gpio_disable_irq(void *pin);
+
+/**
+ * @brief RISC-V GPIO handler structure
+ * This structure contains function pointers for RISC-V GPIO operations
+ */
+extern eer_gpio_handler_t eer_riscv_gpio;
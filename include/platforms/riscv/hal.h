@@ -0,0 +1,10 @@
+#pragma once
+
+#include "eer_hal.h"
+
+/**
+ * @brief RISC-V HAL implementation
+ *
+ * The global eer_hal variable points at the peripherals of the emulated
+ * machine selected by EER_RISCV_MACHINE, see platforms/riscv/machine.h.
+ */
@@ -0,0 +1,156 @@
+/**
+ * @file hal_static.h
+ * @brief Compile-time binding of HAL operations on RISC-V
+ *
+ * Included by eer_hal.h when EER_HAL_STATIC is defined. Every
+ * eer_<peripheral>_<operation> name used by eer_hal_call() resolves to a
+ * direct call of the RISC-V implementation.
+ */
+#pragma once
+
+#include "platforms/riscv/gpio.h"
+#include "platforms/riscv/adc.h"
+#include "platforms/riscv/uart.h"
+#include "platforms/riscv/spi.h"
+#include "platforms/riscv/i2c.h"
+#include "platforms/riscv/timer.h"
+#include "platforms/riscv/system.h"
+#include "platforms/riscv/power.h"
+#include "platforms/riscv/nvs.h"
+
+// GPIO
+#define eer_gpio_init riscv_gpio_init
+#define eer_gpio_deinit riscv_gpio_deinit
+#define eer_gpio_configure riscv_gpio_configure
+#define eer_gpio_write riscv_gpio_write
+#define eer_gpio_read riscv_gpio_read
+#define eer_gpio_toggle riscv_gpio_toggle
+#define eer_gpio_register_irq riscv_gpio_register_irq
+#define eer_gpio_unregister_irq riscv_gpio_unregister_irq
+#define eer_gpio_enable_irq riscv_gpio_enable_irq
+#define eer_gpio_disable_irq riscv_gpio_disable_irq
+
+// ADC
+#define eer_adc_init riscv_adc_init
+#define eer_adc_deinit riscv_adc_deinit
+#define eer_adc_start_conversion riscv_adc_start_conversion
+#define eer_adc_stop_conversion riscv_adc_stop_conversion
+#define eer_adc_is_conversion_complete riscv_adc_is_conversion_complete
+#define eer_adc_read riscv_adc_read
+#define eer_adc_read_voltage riscv_adc_read_voltage
+#define eer_adc_register_callback riscv_adc_register_callback
+#define eer_adc_unregister_callback riscv_adc_unregister_callback
+
+// UART
+#define eer_uart_init riscv_uart_init
+#define eer_uart_deinit riscv_uart_deinit
+#define eer_uart_transmit riscv_uart_transmit
+#define eer_uart_receive riscv_uart_receive
+#define eer_uart_is_tx_ready riscv_uart_is_tx_ready
+#define eer_uart_is_rx_ready riscv_uart_is_rx_ready
+#define eer_uart_register_rx_callback riscv_uart_register_rx_callback
+#define eer_uart_unregister_rx_callback riscv_uart_unregister_rx_callback
+#define eer_uart_register_tx_callback riscv_uart_register_tx_callback
+#define eer_uart_unregister_tx_callback riscv_uart_unregister_tx_callback
+#define eer_uart_submit riscv_uart_submit
+
+// UART instances
+#define eer_uart_instance_init riscv_uart_instance_init
+#define eer_uart_instance_deinit riscv_uart_instance_deinit
+#define eer_uart_instance_transmit riscv_uart_instance_transmit
+#define eer_uart_instance_receive riscv_uart_instance_receive
+#define eer_uart_instance_is_tx_ready riscv_uart_instance_is_tx_ready
+#define eer_uart_instance_is_rx_ready riscv_uart_instance_is_rx_ready
+#define eer_uart_instance_register_rx_callback riscv_uart_instance_register_rx_callback
+#define eer_uart_instance_unregister_rx_callback riscv_uart_instance_unregister_rx_callback
+#define eer_uart_instance_register_tx_callback riscv_uart_instance_register_tx_callback
+#define eer_uart_instance_unregister_tx_callback riscv_uart_instance_unregister_tx_callback
+
+// SPI
+#define eer_spi_init riscv_spi_init
+#define eer_spi_deinit riscv_spi_deinit
+#define eer_spi_transfer riscv_spi_transfer
+#define eer_spi_transmit riscv_spi_transmit
+#define eer_spi_receive riscv_spi_receive
+#define eer_spi_is_ready riscv_spi_is_ready
+#define eer_spi_chip_select riscv_spi_chip_select
+#define eer_spi_set_prescaler riscv_spi_set_prescaler
+#define eer_spi_register_callback riscv_spi_register_callback
+#define eer_spi_unregister_callback riscv_spi_unregister_callback
+#define eer_spi_submit riscv_spi_submit
+
+// I2C
+#define eer_i2c_init riscv_i2c_init
+#define eer_i2c_deinit riscv_i2c_deinit
+#define eer_i2c_master_transmit riscv_i2c_master_transmit
+#define eer_i2c_master_receive riscv_i2c_master_receive
+#define eer_i2c_master_transmit_receive riscv_i2c_master_transmit_receive
+#define eer_i2c_is_busy riscv_i2c_is_busy
+#define eer_i2c_scan riscv_i2c_scan
+#define eer_i2c_register_callback riscv_i2c_register_callback
+#define eer_i2c_unregister_callback riscv_i2c_unregister_callback
+#define eer_i2c_submit riscv_i2c_submit
+
+// Timer
+#define eer_timer_init riscv_timer_init
+#define eer_timer_deinit riscv_timer_deinit
+#define eer_timer_start riscv_timer_start
+#define eer_timer_stop riscv_timer_stop
+#define eer_timer_set_period riscv_timer_set_period
+#define eer_timer_get_value riscv_timer_get_value
+#define eer_timer_set_compare riscv_timer_set_compare
+#define eer_timer_set_pwm_duty_cycle riscv_timer_set_pwm_duty_cycle
+#define eer_timer_us_to_ticks riscv_timer_us_to_ticks
+#define eer_timer_ticks_to_us riscv_timer_ticks_to_us
+#define eer_timer_register_callback riscv_timer_register_callback
+#define eer_timer_unregister_callback riscv_timer_unregister_callback
+#define eer_timer_set_capture_edge riscv_timer_set_capture_edge
+
+// Timer instances
+#define eer_timer_instance_init riscv_timer_instance_init
+#define eer_timer_instance_deinit riscv_timer_instance_deinit
+#define eer_timer_instance_start riscv_timer_instance_start
+#define eer_timer_instance_stop riscv_timer_instance_stop
+#define eer_timer_instance_set_period riscv_timer_instance_set_period
+#define eer_timer_instance_get_value riscv_timer_instance_get_value
+#define eer_timer_instance_set_compare riscv_timer_instance_set_compare
+#define eer_timer_instance_set_pwm_duty_cycle riscv_timer_instance_set_pwm_duty_cycle
+#define eer_timer_instance_us_to_ticks riscv_timer_instance_us_to_ticks
+#define eer_timer_instance_ticks_to_us riscv_timer_instance_ticks_to_us
+#define eer_timer_instance_register_callback riscv_timer_instance_register_callback
+#define eer_timer_instance_unregister_callback riscv_timer_instance_unregister_callback
+#define eer_timer_instance_set_capture_edge riscv_timer_instance_set_capture_edge
+
+// System
+#define eer_system_init riscv_system_init
+#define eer_system_deinit riscv_system_deinit
+#define eer_system_reset riscv_system_reset
+#define eer_system_disable_interrupts riscv_system_disable_interrupts
+#define eer_system_enable_interrupts riscv_system_enable_interrupts
+#define eer_system_delay_ms riscv_system_delay_ms
+#define eer_system_delay_us riscv_system_delay_us
+#define eer_system_get_tick riscv_system_get_tick
+#define eer_system_get_uptime_ms riscv_system_get_uptime_ms
+
+// Power
+#define eer_power_init riscv_power_init
+#define eer_power_deinit riscv_power_deinit
+#define eer_power_set_mode riscv_power_set_mode
+#define eer_power_get_mode riscv_power_get_mode
+#define eer_power_enable_wakeup_source riscv_power_enable_wakeup_source
+#define eer_power_disable_wakeup_source riscv_power_disable_wakeup_source
+#define eer_power_get_wakeup_source riscv_power_get_wakeup_source
+#define eer_power_get_voltage riscv_power_get_voltage
+#define eer_power_get_power_consumption riscv_power_get_power_consumption
+
+// Storage
+#define eer_nvs_init riscv_nvs_init
+#define eer_nvs_deinit riscv_nvs_deinit
+#define eer_nvs_read riscv_nvs_read
+#define eer_nvs_write riscv_nvs_write
+#define eer_nvs_erase riscv_nvs_erase
+#define eer_nvs_flush riscv_nvs_flush
+#define eer_nvs_is_busy riscv_nvs_is_busy
+#define eer_nvs_get_size riscv_nvs_get_size
+#define eer_nvs_register_callback riscv_nvs_register_callback
+#define eer_nvs_unregister_callback riscv_nvs_unregister_callback
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "eer_hal_i2c.h"
+#include "eer_hal_async.h"
+#include "platforms/riscv/riscv.h"
+
+/*
+ * The emulated machines have no I2C controller: every operation reports
+ * EER_HAL_NOT_SUPPORTED, and submitted requests are rejected, which
+ * cancels the rest of their pipeline.
+ */
+
+// Operations of eer_riscv_i2c, called directly by EER_HAL_STATIC builds
+eer_hal_status_t riscv_i2c_init(eer_i2c_config_t* config);
+eer_hal_status_t riscv_i2c_deinit(void);
+eer_hal_status_t riscv_i2c_master_transmit(uint16_t address, const uint8_t* data, uint16_t size, uint32_t timeout);
+eer_hal_status_t riscv_i2c_master_receive(uint16_t address, uint8_t* data, uint16_t size, uint32_t timeout);
+eer_hal_status_t riscv_i2c_master_transmit_receive(uint16_t address, const uint8_t* tx_data, uint16_t tx_size, uint8_t* rx_data, uint16_t rx_size, uint32_t timeout);
+eer_hal_status_t riscv_i2c_is_busy(bool* busy);
+eer_hal_status_t riscv_i2c_scan(uint16_t* devices, uint8_t max_devices, uint8_t* found_devices);
+eer_hal_status_t riscv_i2c_register_callback(eer_i2c_transfer_handler_t handler, void* user_data);
+eer_hal_status_t riscv_i2c_unregister_callback(void);
+eer_hal_status_t riscv_i2c_submit(eer_async_request_t* request);
+
+/**
+ * @brief RISC-V I2C handler structure
+ * This structure contains function pointers for RISC-V I2C operations
+ */
+extern eer_i2c_handler_t eer_riscv_i2c;
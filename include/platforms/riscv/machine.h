@@ -0,0 +1,25 @@
+/**
+ * @file machine.h
+ * @brief Selection of the descriptor of the target RISC-V machine
+ *
+ * Each descriptor in platforms/riscv/machine/ gives the addresses and
+ * interrupt sources of the devices the drivers use on one machine: the
+ * CLINT timer, the PLIC, the console UART and its register layout, the
+ * GPIO block and the test device that ends a QEMU run. Drivers only use
+ * these macros, so the same sources run on every machine below.
+ *
+ * The descriptor is picked from the machine macro the toolchain file
+ * defines for MCU. It only defines one for machines with a descriptor, so
+ * a build for any other chip stops here instead of running virt addresses.
+ */
+#pragma once
+
+#if !defined(EER_RISCV_MACHINE)
+#error "EER_RISCV_MACHINE not defined: MCU has no descriptor in platforms/riscv/machine/"
+#elif defined(EER_RISCV_MACHINE_SIFIVE_E)
+#include "platforms/riscv/machine/sifive_e.h"
+#elif defined(EER_RISCV_MACHINE_VIRT)
+#include "platforms/riscv/machine/virt.h"
+#else
+#error "No descriptor in platforms/riscv/machine/ for the target machine"
+#endif
@@ -0,0 +1,43 @@
+/**
+ * @file sifive_e.h
+ * @brief Descriptor of the SiFive E31 machine (FE310, HiFive1), see
+ *        platforms/riscv/machine.h
+ *
+ * Run with: qemu-system-riscv32 -M sifive_e -nographic -kernel <elf>
+ */
+#pragma once
+
+#define EER_RISCV_MACHINE_NAME "sifive_e"
+
+/*
+ * CLINT: mtime and mtimecmp of hart 0. QEMU clocks mtime at 10 MHz, a
+ * HiFive1 board from the 32768 Hz real-time clock: build for the board
+ * with -DEER_RISCV_MTIME_FREQUENCY=32768UL
+ */
+#define EER_RISCV_CLINT_BASE 0x02000000UL
+#ifndef EER_RISCV_MTIME_FREQUENCY
+#define EER_RISCV_MTIME_FREQUENCY 10000000UL  /*!< mtime ticks per second */
+#endif
+
+/*
+ * PLIC, context 0 is machine mode of hart 0
+ */
+#define EER_RISCV_PLIC_BASE    0x0C000000UL
+#define EER_RISCV_PLIC_SOURCES 53  /*!< Highest interrupt source + 1 */
+
+/*
+ * UART: two SiFive UARTs with word-wide registers
+ */
+#define EER_RISCV_UART_SIFIVE 1
+#define EER_RISCV_UART_CLOCK  16000000UL  /*!< Bus clock after reset in Hz */
+#define EER_RISCV_UART0_BASE  0x10013000UL
+#define EER_RISCV_UART0_IRQ   3
+#define EER_RISCV_UART1_BASE  0x10023000UL
+#define EER_RISCV_UART1_IRQ   4
+
+/*
+ * GPIO: 32 pins of GPIO0, pin n on interrupt source 8 + n
+ */
+#define EER_RISCV_GPIO_BASE 0x10012000UL
+#define EER_RISCV_GPIO_PINS 32
+#define EER_RISCV_GPIO_IRQ  8
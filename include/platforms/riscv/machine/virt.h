@@ -0,0 +1,41 @@
+/**
+ * @file virt.h
+ * @brief Descriptor of the QEMU virt machine, see platforms/riscv/machine.h
+ *
+ * Run with: qemu-system-riscv32 -M virt -bios none -nographic -kernel <elf>
+ */
+#pragma once
+
+#define EER_RISCV_MACHINE_NAME "virt"
+
+/*
+ * CLINT: mtime and mtimecmp of hart 0
+ */
+#define EER_RISCV_CLINT_BASE 0x02000000UL
+#ifndef EER_RISCV_MTIME_FREQUENCY
+#define EER_RISCV_MTIME_FREQUENCY 10000000UL  /*!< mtime ticks per second */
+#endif
+
+/*
+ * PLIC, context 0 is machine mode of hart 0
+ */
+#define EER_RISCV_PLIC_BASE    0x0C000000UL
+#define EER_RISCV_PLIC_SOURCES 96  /*!< Highest interrupt source + 1 */
+
+/*
+ * UART: one NS16550A with byte-wide registers
+ */
+#define EER_RISCV_UART_NS16550 1
+#define EER_RISCV_UART_CLOCK   3686400UL  /*!< Divisor latch clock in Hz */
+#define EER_RISCV_UART0_BASE   0x10000000UL
+#define EER_RISCV_UART0_IRQ    10
+
+/*
+ * GPIO: none, the GPIO handler reports EER_HAL_NOT_SUPPORTED
+ */
+#define EER_RISCV_GPIO_PINS 0
+
+/*
+ * Test device: ends the QEMU process or resets the machine
+ */
+#define EER_RISCV_TEST_BASE 0x00100000UL
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "eer_hal_nvs.h"
+#include "platforms/riscv/riscv.h"
+
+/*
+ * The emulated machines have no non-volatile storage the driver supports:
+ * every operation reports EER_HAL_NOT_SUPPORTED.
+ */
+
+// Operations of eer_riscv_nvs, called directly by EER_HAL_STATIC builds
+eer_hal_status_t riscv_nvs_init(void);
+eer_hal_status_t riscv_nvs_deinit(void);
+eer_hal_status_t riscv_nvs_read(uint32_t address, uint8_t* data, uint16_t size);
+eer_hal_status_t riscv_nvs_write(uint32_t address, const uint8_t* data, uint16_t size, uint32_t timeout);
+eer_hal_status_t riscv_nvs_erase(uint32_t address, uint16_t size, uint32_t timeout);
+eer_hal_status_t riscv_nvs_flush(uint32_t timeout);
+eer_hal_status_t riscv_nvs_is_busy(bool* busy);
+eer_hal_status_t riscv_nvs_get_size(uint32_t* size);
+eer_hal_status_t riscv_nvs_register_callback(eer_nvs_write_handler_t handler, void* user_data);
+eer_hal_status_t riscv_nvs_unregister_callback(void);
+
+/**
+ * @brief RISC-V storage handler structure
+ * This structure contains function pointers for RISC-V storage operations
+ */
+extern eer_nvs_handler_t eer_riscv_nvs;
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "eer_hal_power.h"
+#include "platforms/riscv/riscv.h"
+
+/*
+ * Sleep on RISC-V
+ *
+ * Every sleep mode waits with wfi until an interrupt wakes the hart.
+ * EER_POWER_MODE_SLEEP returns on any event the drivers report; the deeper
+ * modes only on sources enabled with enable_wakeup_source(), and go back
+ * to wfi after other interrupts. The drivers report EER_WAKEUP_TIMER from
+ * timer events, EER_WAKEUP_PIN from pin interrupts and EER_WAKEUP_UART
+ * from received bytes. Sleeping with interrupts disabled or without any
+ * interrupt enabled returns EER_HAL_ERROR instead of hanging.
+ */
+
+/**
+ * @brief Record the source of a wakeup from an interrupt owned by another driver
+ * @param source Wakeup source that fired
+ * @param pin_or_id Pin or peripheral number of the source
+ */
+void riscv_power_wakeup(eer_wakeup_source_t source, uint8_t pin_or_id);
+
+// Operations of eer_riscv_power, called directly by EER_HAL_STATIC builds
+eer_hal_status_t riscv_power_init(void);
+eer_hal_status_t riscv_power_deinit(void);
+eer_hal_status_t riscv_power_set_mode(eer_power_mode_t mode);
+eer_hal_status_t riscv_power_get_mode(eer_power_mode_t* mode);
+eer_hal_status_t riscv_power_enable_wakeup_source(eer_wakeup_source_t source, uint8_t pin_or_id);
+eer_hal_status_t riscv_power_disable_wakeup_source(eer_wakeup_source_t source, uint8_t pin_or_id);
+eer_hal_status_t riscv_power_get_wakeup_source(eer_wakeup_source_t* source, uint8_t* pin_or_id);
+eer_hal_status_t riscv_power_get_voltage(uint16_t* voltage_mv);
+eer_hal_status_t riscv_power_get_power_consumption(uint16_t* power_mw);
+
+/**
+ * @brief RISC-V power handler structure
+ * This structure contains function pointers for RISC-V power management operations
+ */
+extern eer_power_handler_t eer_riscv_power;
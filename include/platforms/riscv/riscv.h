@@ -0,0 +1,170 @@
+/**
+ * @file riscv.h
+ * @brief Machine-mode core access shared by the RISC-V drivers
+ *
+ * Control and status registers, memory-mapped registers, the CLINT timer
+ * and the PLIC. All interrupts enter through one trap vector in start.S,
+ * which calls riscv_trap(): the machine timer interrupt goes to the system
+ * driver, external interrupts are claimed from the PLIC and passed to the
+ * handler attached to their source. Handlers run with interrupts disabled
+ * and do not nest.
+ */
+#pragma once
+
+#include "platforms/riscv/machine.h"
+#include "eer_hal_errors.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Control and status registers
+ */
+#define riscv_csr_read(csr) \
+    ({ unsigned long value_; __asm__ volatile ("csrr %0, " #csr : "=r"(value_)); value_; })
+#define riscv_csr_write(csr, value) \
+    __asm__ volatile ("csrw " #csr ", %0" :: "r"((unsigned long)(value)))
+#define riscv_csr_set(csr, bits) \
+    __asm__ volatile ("csrs " #csr ", %0" :: "r"((unsigned long)(bits)))
+#define riscv_csr_clear(csr, bits) \
+    __asm__ volatile ("csrc " #csr ", %0" :: "r"((unsigned long)(bits)))
+
+#define RISCV_MSTATUS_MIE (1UL << 3)   /*!< Machine interrupt enable */
+#define RISCV_MIE_MTIE    (1UL << 7)   /*!< Machine timer interrupt enable */
+#define RISCV_MIE_MEIE    (1UL << 11)  /*!< Machine external interrupt enable */
+
+#define RISCV_MCAUSE_INTERRUPT (1UL << (__riscv_xlen - 1))
+#define RISCV_MCAUSE_TIMER     7
+#define RISCV_MCAUSE_EXTERNAL  11
+
+/*
+ * Memory-mapped registers
+ */
+#define RISCV_REG32(base, offset) (*(volatile uint32_t*)((uintptr_t)(base) + (offset)))
+#define RISCV_REG8(base, offset)  (*(volatile uint8_t*)((uintptr_t)(base) + (offset)))
+
+/**
+ * @brief Disable interrupts
+ * @return Previous mstatus, for riscv_interrupts_restore()
+ */
+static inline unsigned long riscv_interrupts_lock(void) {
+    unsigned long mstatus;
+    __asm__ volatile ("csrrc %0, mstatus, %1" : "=r"(mstatus) : "r"(RISCV_MSTATUS_MIE) : "memory");
+    return mstatus;
+}
+
+/**
+ * @brief Enable interrupts again if they were enabled before the lock
+ */
+static inline void riscv_interrupts_restore(unsigned long mstatus) {
+    __asm__ volatile ("csrs mstatus, %0" :: "r"(mstatus & RISCV_MSTATUS_MIE) : "memory");
+}
+
+/**
+ * @brief Check if interrupts are enabled, i.e. a wait may rely on them
+ */
+static inline bool riscv_interrupts_enabled(void) {
+    return (riscv_csr_read(mstatus) & RISCV_MSTATUS_MIE) != 0;
+}
+
+/**
+ * @brief Wait for an interrupt, also when interrupts are disabled
+ */
+static inline void riscv_wfi(void) {
+    __asm__ volatile ("wfi" ::: "memory");
+}
+
+/*
+ * CLINT timer of hart 0
+ */
+#define RISCV_MTIMECMP 0x4000
+#define RISCV_MTIME    0xBFF8
+
+/**
+ * @brief Read the machine timer
+ * @return mtime, counting at EER_RISCV_MTIME_FREQUENCY
+ */
+static inline uint64_t riscv_mtime(void) {
+#if __riscv_xlen == 32
+    uint32_t high, low;
+    
+    // Read again if the low word wrapped between the two reads
+    do {
+        high = RISCV_REG32(EER_RISCV_CLINT_BASE, RISCV_MTIME + 4);
+        low = RISCV_REG32(EER_RISCV_CLINT_BASE, RISCV_MTIME);
+    } while (high != RISCV_REG32(EER_RISCV_CLINT_BASE, RISCV_MTIME + 4));
+    
+    return (uint64_t)high << 32 | low;
+#else
+    return *(volatile uint64_t*)(EER_RISCV_CLINT_BASE + RISCV_MTIME);
+#endif
+}
+
+/**
+ * @brief Set the time of the next machine timer interrupt
+ * @param time mtime value, UINT64_MAX for never
+ */
+static inline void riscv_mtimecmp_write(uint64_t time) {
+#if __riscv_xlen == 32
+    // No intermediate value may lie before the new time
+    RISCV_REG32(EER_RISCV_CLINT_BASE, RISCV_MTIMECMP) = UINT32_MAX;
+    RISCV_REG32(EER_RISCV_CLINT_BASE, RISCV_MTIMECMP + 4) = (uint32_t)(time >> 32);
+    RISCV_REG32(EER_RISCV_CLINT_BASE, RISCV_MTIMECMP) = (uint32_t)time;
+#else
+    *(volatile uint64_t*)(EER_RISCV_CLINT_BASE + RISCV_MTIMECMP) = time;
+#endif
+}
+
+/**
+ * @brief Convert microseconds to mtime ticks, rounded up
+ */
+static inline uint64_t riscv_us_to_mtime(uint64_t us) {
+    return (us * EER_RISCV_MTIME_FREQUENCY + 999999) / 1000000;
+}
+
+/**
+ * @brief Convert mtime ticks to microseconds
+ */
+static inline uint64_t riscv_mtime_to_us(uint64_t ticks) {
+    return ticks * 1000000 / EER_RISCV_MTIME_FREQUENCY;
+}
+
+/**
+ * @brief Handler of an external interrupt source
+ * @param context Context given to riscv_irq_attach()
+ */
+typedef void (*riscv_irq_handler_t)(void* context);
+
+/**
+ * @brief Route a PLIC interrupt source to a handler and enable it
+ * @param source Interrupt source, 1 to EER_RISCV_PLIC_SOURCES - 1
+ * @param handler Handler called with the source claimed
+ * @param context Passed to the handler
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t riscv_irq_attach(uint8_t source, riscv_irq_handler_t handler, void* context);
+
+/**
+ * @brief Disable a PLIC interrupt source and remove its handler
+ * @param source Interrupt source
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t riscv_irq_detach(uint8_t source);
+
+/**
+ * @brief Trap handler, called by the vector in start.S
+ * @param mcause Cause of the trap
+ */
+void riscv_trap(unsigned long mcause);
+
+/**
+ * @brief Machine timer interrupt, implemented by the system driver
+ */
+void riscv_system_timer_isr(void);
+
+/**
+ * @brief Stop the machine, ending the process under QEMU
+ * @param code Exit status, 0 for success
+ *
+ * Machines without a test device stop in a wfi loop.
+ */
+void riscv_exit(int code) __attribute__((noreturn));
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "eer_hal_spi.h"
+#include "eer_hal_async.h"
+#include "platforms/riscv/riscv.h"
+
+/*
+ * The emulated machines have no SPI controller the driver supports: every
+ * operation reports EER_HAL_NOT_SUPPORTED, and submitted requests are
+ * rejected, which cancels the rest of their pipeline.
+ */
+
+// Operations of eer_riscv_spi, called directly by EER_HAL_STATIC builds
+eer_hal_status_t riscv_spi_init(eer_spi_config_t* config);
+eer_hal_status_t riscv_spi_deinit(void);
+eer_hal_status_t riscv_spi_transfer(const uint8_t* tx_data, uint8_t* rx_data, uint16_t size, uint32_t timeout);
+eer_hal_status_t riscv_spi_transmit(const uint8_t* data, uint16_t size, uint32_t timeout);
+eer_hal_status_t riscv_spi_receive(uint8_t* data, uint16_t size, uint32_t timeout);
+eer_hal_status_t riscv_spi_is_ready(bool* ready);
+eer_hal_status_t riscv_spi_chip_select(void* pin, bool state);
+eer_hal_status_t riscv_spi_set_prescaler(eer_spi_prescaler_t prescaler);
+eer_hal_status_t riscv_spi_register_callback(eer_spi_transfer_handler_t handler, void* user_data);
+eer_hal_status_t riscv_spi_unregister_callback(void);
+eer_hal_status_t riscv_spi_submit(eer_async_request_t* request);
+
+/**
+ * @brief RISC-V SPI handler structure
+ * This structure contains function pointers for RISC-V SPI operations
+ */
+extern eer_spi_handler_t eer_riscv_spi;
@@ -0,0 +1,39 @@
+#pragma once
+
+#include "eer_hal_system.h"
+#include "platforms/riscv/riscv.h"
+
+/*
+ * Tickless system time
+ *
+ * There is no periodic tick: time is read from the CLINT mtime counter,
+ * and the machine timer interrupt is only armed for the next event, the
+ * earliest of the running timer instances and the end of a delay_ms().
+ * While nothing is due, mtimecmp stays disarmed and wfi sleeps until an
+ * external interrupt.
+ */
+
+/**
+ * @brief Arm the machine timer for the next event
+ *
+ * Called by the drivers after a change of their deadlines, see
+ * riscv_timer_deadline().
+ */
+void riscv_system_schedule(void);
+
+// Operations of eer_riscv_system, called directly by EER_HAL_STATIC builds
+eer_hal_status_t riscv_system_init(void);
+eer_hal_status_t riscv_system_deinit(void);
+eer_hal_status_t riscv_system_reset(eer_system_reset_type_t reset_type);
+eer_hal_status_t riscv_system_disable_interrupts(void);
+eer_hal_status_t riscv_system_enable_interrupts(void);
+eer_hal_status_t riscv_system_delay_ms(uint32_t ms);
+eer_hal_status_t riscv_system_delay_us(uint32_t us);
+eer_hal_status_t riscv_system_get_tick(uint32_t* ticks);
+eer_hal_status_t riscv_system_get_uptime_ms(uint32_t* uptime);
+
+/**
+ * @brief RISC-V system handler structure
+ * This structure contains function pointers for RISC-V system operations
+ */
+extern eer_system_handler_t eer_riscv_system;
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "eer_hal_timer.h"
+#include "platforms/riscv/riscv.h"
+
+/**
+ * @brief Counter clock used when the configuration leaves it at zero
+ */
+#ifndef EER_RISCV_TIMER_FREQUENCY
+#define EER_RISCV_TIMER_FREQUENCY 1000000UL
+#endif
+
+/**
+ * @brief RISC-V-specific timer structure, the state block of one timer
+ *
+ * Timers are derived from mtime: the counter counts up at frequency from
+ * zero to period - 1 (65535 if period is 0) and wraps with an overflow
+ * event. Compare events fire when the counter reaches compare[channel].
+ * The machine timer interrupt is armed for the earliest event of all
+ * running instances, so any number of instances can be created with
+ * eer_hal_timer0() without hardware timers. There is no capture input and
+ * no PWM output: EER_TIMER_MODE_PWM counts like continuous mode and the
+ * duty cycle sets the compare value, for compare callbacks that drive pins.
+ */
+typedef struct eer_timer {
+    uint32_t         frequency;   /*!< Counter clock in Hz, at most EER_RISCV_MTIME_FREQUENCY */
+    uint32_t         period;      /*!< Counter top + 1, 0 for 65536 */
+    uint32_t         compare[2];  /*!< Compare values of channels 0 and 1 */
+    eer_timer_mode_t mode;        /*!< Operating mode */
+    bool             running;     /*!< Counter is clocked */
+    uint64_t         ticks;       /*!< Ticks counted before the last start */
+    uint64_t         started;     /*!< mtime of the last start */
+    uint64_t         dispatched;  /*!< Ticks up to which events were dispatched */
+    
+    eer_timer_event_handler_t overflow_handler;   /*!< Overflow callback */
+    void*            overflow_user_data;          /*!< User data of the overflow callback */
+    eer_timer_event_handler_t compare_handler[2]; /*!< Compare callbacks of channels 0 and 1 */
+    void*            compare_user_data[2];        /*!< User data of the compare callbacks */
+    struct eer_timer* next;       /*!< Managed by the driver */
+} eer_timer_t;
+
+/**
+ * @brief Macro to create a stopped RISC-V timer structure
+ */
+#define eer_hal_timer0() \
+    { .frequency = EER_RISCV_TIMER_FREQUENCY, .mode = EER_TIMER_MODE_CONTINUOUS }
+
+/*
+ * Hooks of the system driver, called with interrupts disabled
+ */
+
+/**
+ * @brief mtime of the next event of the running timers
+ * @return mtime value, UINT64_MAX if no event has a handler
+ */
+uint64_t riscv_timer_deadline(void);
+
+/**
+ * @brief Dispatch the events of every timer that fell due
+ */
+void riscv_timer_poll(void);
+
+// Operations of eer_riscv_timer, called directly by EER_HAL_STATIC builds
+eer_hal_status_t riscv_timer_init(eer_timer_config_t* config);
+eer_hal_status_t riscv_timer_deinit(void);
+eer_hal_status_t riscv_timer_start(void);
+eer_hal_status_t riscv_timer_stop(void);
+eer_hal_status_t riscv_timer_set_period(uint32_t period);
+eer_hal_status_t riscv_timer_get_value(uint32_t* value);
+eer_hal_status_t riscv_timer_set_compare(uint8_t channel, uint32_t value);
+eer_hal_status_t riscv_timer_set_pwm_duty_cycle(uint8_t channel, uint8_t duty_cycle);
+uint32_t riscv_timer_us_to_ticks(uint32_t us);
+uint32_t riscv_timer_ticks_to_us(uint32_t ticks);
+eer_hal_status_t riscv_timer_register_callback(eer_timer_event_t event, uint8_t channel, eer_timer_event_handler_t handler, void* user_data);
+eer_hal_status_t riscv_timer_unregister_callback(eer_timer_event_t event, uint8_t channel);
+eer_hal_status_t riscv_timer_set_capture_edge(bool rising);
+
+// Operations of eer_riscv_timer_instance, called directly by EER_HAL_STATIC builds
+eer_hal_status_t riscv_timer_instance_init(void* timer, eer_timer_config_t* config);
+eer_hal_status_t riscv_timer_instance_deinit(void* timer);
+eer_hal_status_t riscv_timer_instance_start(void* timer);
+eer_hal_status_t riscv_timer_instance_stop(void* timer);
+eer_hal_status_t riscv_timer_instance_set_period(void* timer, uint32_t period);
+eer_hal_status_t riscv_timer_instance_get_value(void* timer, uint32_t* value);
+eer_hal_status_t riscv_timer_instance_set_compare(void* timer, uint8_t channel, uint32_t value);
+eer_hal_status_t riscv_timer_instance_set_pwm_duty_cycle(void* timer, uint8_t channel, uint8_t duty_cycle);
+uint32_t riscv_timer_instance_us_to_ticks(void* timer, uint32_t us);
+uint32_t riscv_timer_instance_ticks_to_us(void* timer, uint32_t ticks);
+eer_hal_status_t riscv_timer_instance_register_callback(void* timer, eer_timer_event_t event, uint8_t channel, eer_timer_event_handler_t handler, void* user_data);
+eer_hal_status_t riscv_timer_instance_unregister_callback(void* timer, eer_timer_event_t event, uint8_t channel);
+eer_hal_status_t riscv_timer_instance_set_capture_edge(void* timer, bool rising);
+
+/**
+ * @brief RISC-V timer handler structure
+ * This structure contains function pointers for RISC-V timer operations on the default timer
+ */
+extern eer_timer_handler_t eer_riscv_timer;
+
+/**
+ * @brief RISC-V timer instance handler structure
+ * This structure contains function pointers for RISC-V timer operations on any instance
+ */
+extern eer_timer_instance_handler_t eer_riscv_timer_instance;
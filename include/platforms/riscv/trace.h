@@ -0,0 +1,31 @@
+/**
+ * @file trace.h
+ * @brief Trace timestamp and slot locking on RISC-V
+ *
+ * Included by eer_trace.h when EER_HAL_TRACE is defined. The timestamp
+ * follows the AVR format on mtime: milliseconds modulo 256 and 4 us steps
+ * within the millisecond. Records may come from interrupts, so slots are
+ * claimed with machine interrupts disabled.
+ */
+#pragma once
+
+#include "platforms/riscv/riscv.h"
+
+#define EER_TRACE_TICK_US 1000
+#define EER_TRACE_SUB_PER_TICK 250
+
+typedef unsigned long eer_trace_lock_t;
+
+static inline uint16_t eer_trace_timestamp(void) {
+    uint64_t us = riscv_mtime_to_us(riscv_mtime());
+    
+    return (uint16_t)((us / 1000) % 256) << 8 | (uint16_t)(us % 1000 / 4);
+}
+
+static inline eer_trace_lock_t eer_trace_lock(void) {
+    return riscv_interrupts_lock();
+}
+
+static inline void eer_trace_unlock(eer_trace_lock_t lock) {
+    riscv_interrupts_restore(lock);
+}
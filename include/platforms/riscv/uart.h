@@ -0,0 +1,107 @@
+#pragma once
+
+#include "eer_hal_uart.h"
+#include "eer_hal_async.h"
+#include "platforms/riscv/riscv.h"
+
+/**
+ * @brief Size of the receive buffer of each UART instance in bytes
+ */
+#ifndef EER_RISCV_UART_RX_SIZE
+#define EER_RISCV_UART_RX_SIZE 64
+#endif
+
+/**
+ * @brief Size of the transmit buffer of each UART instance in bytes
+ */
+#ifndef EER_RISCV_UART_TX_SIZE
+#define EER_RISCV_UART_TX_SIZE 64
+#endif
+
+/**
+ * @brief RISC-V-specific UART structure, the state block of one UART
+ *
+ * Both directions are buffered: the interrupt of the UART moves received
+ * bytes into rx_buffer and bytes from tx_buffer into the transmitter, so
+ * transmit() returns once its bytes are buffered. Blocking calls serve the
+ * UART themselves while they wait, so they also work with interrupts
+ * disabled, e.g. printf() before eer_hal.system->init().
+ */
+typedef struct {
+    uintptr_t         base;  /*!< Register block */
+    uint8_t           irq;   /*!< PLIC interrupt source */
+    
+    uint8_t           rx_buffer[EER_RISCV_UART_RX_SIZE]; /*!< Bytes received by the interrupt */
+    volatile uint16_t rx_head;        /*!< Write index of rx_buffer */
+    volatile uint16_t rx_tail;        /*!< Read index of rx_buffer */
+    uint8_t           tx_buffer[EER_RISCV_UART_TX_SIZE]; /*!< Bytes waiting for the transmitter */
+    volatile uint16_t tx_head;        /*!< Write index of tx_buffer */
+    volatile uint16_t tx_tail;        /*!< Read index of tx_buffer */
+    volatile bool     tx_active;      /*!< Bytes were sent since the transmitter last ran dry */
+    eer_uart_rx_handler_t rx_handler; /*!< Receive callback */
+    void*             rx_user_data;   /*!< User data of the receive callback */
+    eer_uart_tx_handler_t tx_handler; /*!< Transmit complete callback, called when the buffer ran dry */
+    void*             tx_user_data;   /*!< User data of the transmit complete callback */
+    eer_async_queue_t async;          /*!< Asynchronous requests, run by the interrupt */
+} eer_uart_t;
+
+/**
+ * @brief Macro to create a RISC-V UART structure for UART0
+ */
+#define eer_hal_uart0() \
+    { .base = EER_RISCV_UART0_BASE, .irq = EER_RISCV_UART0_IRQ }
+
+#ifdef EER_RISCV_UART1_BASE
+/**
+ * @brief Macro to create a RISC-V UART structure for UART1
+ */
+#define eer_hal_uart1() \
+    { .base = EER_RISCV_UART1_BASE, .irq = EER_RISCV_UART1_IRQ }
+#endif
+
+/**
+ * @brief Wait until the buffered bytes of the default UART are in the transmitter
+ *
+ * Serves the transmitter itself, so it also drains the buffer with
+ * interrupts disabled, e.g. before riscv_exit().
+ *
+ * @return Status code indicating success or failure
+ */
+eer_hal_status_t riscv_uart_flush(void);
+
+// Operations of eer_riscv_uart, called directly by EER_HAL_STATIC builds
+eer_hal_status_t riscv_uart_init(eer_uart_config_t* config);
+eer_hal_status_t riscv_uart_deinit(void);
+eer_hal_status_t riscv_uart_transmit(const uint8_t* data, uint16_t size, uint32_t timeout);
+eer_hal_status_t riscv_uart_receive(uint8_t* data, uint16_t size, uint32_t timeout);
+eer_hal_status_t riscv_uart_is_tx_ready(bool* ready);
+eer_hal_status_t riscv_uart_is_rx_ready(bool* ready);
+eer_hal_status_t riscv_uart_register_rx_callback(eer_uart_rx_handler_t handler, void* user_data);
+eer_hal_status_t riscv_uart_unregister_rx_callback(void);
+eer_hal_status_t riscv_uart_register_tx_callback(eer_uart_tx_handler_t handler, void* user_data);
+eer_hal_status_t riscv_uart_unregister_tx_callback(void);
+eer_hal_status_t riscv_uart_submit(eer_async_request_t* request);
+
+// Operations of eer_riscv_uart_instance, called directly by EER_HAL_STATIC builds
+eer_hal_status_t riscv_uart_instance_init(void* uart, eer_uart_config_t* config);
+eer_hal_status_t riscv_uart_instance_deinit(void* uart);
+eer_hal_status_t riscv_uart_instance_transmit(void* uart, const uint8_t* data, uint16_t size, uint32_t timeout);
+eer_hal_status_t riscv_uart_instance_receive(void* uart, uint8_t* data, uint16_t size, uint32_t timeout);
+eer_hal_status_t riscv_uart_instance_is_tx_ready(void* uart, bool* ready);
+eer_hal_status_t riscv_uart_instance_is_rx_ready(void* uart, bool* ready);
+eer_hal_status_t riscv_uart_instance_register_rx_callback(void* uart, eer_uart_rx_handler_t handler, void* user_data);
+eer_hal_status_t riscv_uart_instance_unregister_rx_callback(void* uart);
+eer_hal_status_t riscv_uart_instance_register_tx_callback(void* uart, eer_uart_tx_handler_t handler, void* user_data);
+eer_hal_status_t riscv_uart_instance_unregister_tx_callback(void* uart);
+
+/**
+ * @brief RISC-V UART handler structure
+ * This structure contains function pointers for RISC-V UART operations on UART0
+ */
+extern eer_uart_handler_t eer_riscv_uart;
+
+/**
+ * @brief RISC-V UART instance handler structure
+ * This structure contains function pointers for RISC-V UART operations on any UART
+ */
+extern eer_uart_instance_handler_t eer_riscv_uart_instance;
@@ -0,0 +1,179 @@
+#include "eer_hal.h"
+#include "eer_hal_async.h"
+#include "event.h"
+#include <stddef.h>
+
+// Owner of each reserved bus, and the requests of others held back meanwhile
+static void* async_owners[EER_ASYNC_BUS_COUNT];
+static eer_async_queue_t async_held[EER_ASYNC_BUS_COUNT];
+
+static eer_hal_status_t async_dispatch(eer_async_request_t* request) {
+    switch (request->bus) {
+        case EER_ASYNC_UART:
+            return eer_hal_call(uart, submit, request);
+        case EER_ASYNC_SPI:
+            return eer_hal_call(spi, submit, request);
+        case EER_ASYNC_I2C:
+            return eer_hal_call(i2c, submit, request);
+        default:
+            return EER_HAL_INVALID_PARAM;
+    }
+}
+
+eer_hal_status_t eer_async_submit(eer_async_request_t* request) {
+    if (request == NULL || (unsigned)request->bus >= EER_ASYNC_BUS_COUNT) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_event_lock_t lock = eer_event_lock();
+    void* owner = async_owners[request->bus];
+    
+    if (owner != NULL && owner != request->user_data) {
+        eer_hal_status_t status = eer_async_prepare(request);
+        if (status == EER_HAL_OK) {
+            eer_async_enqueue(&async_held[request->bus], request);
+        }
+        
+        eer_event_unlock(lock);
+        return status;
+    }
+    
+    eer_event_unlock(lock);
+    return async_dispatch(request);
+}
+
+eer_hal_status_t eer_async_reserve(eer_async_bus_t bus, void* owner) {
+    if ((unsigned)bus >= EER_ASYNC_BUS_COUNT || owner == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_hal_status_t status = EER_HAL_BUSY;
+    eer_event_lock_t lock = eer_event_lock();
+    
+    if (async_owners[bus] == NULL || async_owners[bus] == owner) {
+        async_owners[bus] = owner;
+        status = EER_HAL_OK;
+    }
+    
+    eer_event_unlock(lock);
+    return status;
+}
+
+void eer_async_release(eer_async_bus_t bus, void* owner) {
+    if ((unsigned)bus >= EER_ASYNC_BUS_COUNT) {
+        return;
+    }
+    
+    eer_event_lock_t lock = eer_event_lock();
+    
+    if (async_owners[bus] != owner) {
+        eer_event_unlock(lock);
+        return;
+    }
+    
+    eer_async_request_t* request = async_held[bus].head;
+    async_owners[bus] = NULL;
+    async_held[bus].head = NULL;
+    async_held[bus].tail = NULL;
+    
+    eer_event_unlock(lock);
+    
+    while (request != NULL) {
+        eer_async_request_t* next = request->queued;
+        
+        // Held requests were prepared already; the driver prepares them again
+        request->status = EER_HAL_OK;
+        eer_hal_status_t status = async_dispatch(request);
+        if (status != EER_HAL_OK) {
+            eer_async_complete(request, status);
+        }
+        
+        request = next;
+    }
+}
+
+eer_hal_status_t eer_async_prepare(eer_async_request_t* request) {
+    if (request == NULL
+        || (request->tx_size == 0 && request->rx_size == 0)
+        || (request->tx_size > 0 && request->tx_data == NULL)
+        || (request->rx_size > 0 && request->rx_data == NULL)) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // A queued request must not be linked a second time
+    if (request->status == EER_HAL_BUSY) {
+        return EER_HAL_BUSY;
+    }
+    
+    request->status = EER_HAL_BUSY;
+    request->queued = NULL;
+    request->index = 0;
+    
+    return EER_HAL_OK;
+}
+
+bool eer_async_enqueue(eer_async_queue_t* queue, eer_async_request_t* request) {
+    if (queue->head == NULL) {
+        queue->head = request;
+        queue->tail = request;
+        return true;
+    }
+    
+    queue->tail->queued = request;
+    queue->tail = request;
+    
+    return false;
+}
+
+eer_async_request_t* eer_async_dequeue(eer_async_queue_t* queue) {
+    eer_async_request_t* request = queue->head;
+    
+    if (request != NULL) {
+        queue->head = request->queued;
+        if (queue->head == NULL) {
+            queue->tail = NULL;
+        }
+    }
+    
+    return queue->head;
+}
+
+void eer_async_complete(eer_async_request_t* request, eer_hal_status_t status) {
+    while (request != NULL) {
+        request->status = status;
+        
+        if (request->handler != NULL) {
+            request->handler(request, request->user_data);
+        }
+        
+        eer_async_request_t* next = request->next;
+        if (next == NULL) {
+            return;
+        }
+        
+        if (status == EER_HAL_OK) {
+            status = eer_async_submit(next);
+            
+            // Done, or next was still pending from an earlier submit and
+            // belongs to its bus
+            if (status == EER_HAL_OK || status == EER_HAL_BUSY) {
+                return;
+            }
+        }
+        
+        // A failed request cancels the rest of its pipeline, up to a
+        // request pending on a bus from an earlier submit
+        if (next->status == EER_HAL_BUSY) {
+            return;
+        }
+        request = next;
+    }
+}
+
+void eer_async_cancel(eer_async_queue_t* queue, eer_hal_status_t status) {
+    while (queue->head != NULL) {
+        eer_async_request_t* request = queue->head;
+        eer_async_dequeue(queue);
+        eer_async_complete(request, status);
+    }
+}
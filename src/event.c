@@ -0,0 +1,216 @@
+#include "eer_event.h"
+#include "event.h"
+#include <stddef.h>
+
+#if EER_EVENT_QUEUE_SIZE > 128 || (EER_EVENT_QUEUE_SIZE & (EER_EVENT_QUEUE_SIZE - 1)) != 0
+#error "EER_EVENT_QUEUE_SIZE must be a power of two up to 128"
+#endif
+
+#define EVENT_MASK (EER_EVENT_QUEUE_SIZE - 1)
+
+/**
+ * @brief Ring of one priority: producers advance head, the dispatcher tail
+ */
+typedef struct {
+    eer_event_t      events[EER_EVENT_QUEUE_SIZE];
+    volatile uint8_t head;
+    volatile uint8_t tail;
+    volatile uint8_t dropped;
+} event_queue_t;
+
+static event_queue_t event_queues[EER_EVENT_PRIORITIES];
+static eer_event_subscription_t* event_subscriptions = NULL;
+
+eer_hal_status_t eer_event_subscribe(eer_event_subscription_t* subscription) {
+    if (subscription == NULL || subscription->handler == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Append, so handlers run in subscription order
+    eer_event_subscription_t** link = &event_subscriptions;
+    while (*link != NULL) {
+        if (*link == subscription) {
+            return EER_HAL_OK;
+        }
+        link = &(*link)->next;
+    }
+    
+    subscription->next = NULL;
+    *link = subscription;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t eer_event_unsubscribe(eer_event_subscription_t* subscription) {
+    if (subscription == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    for (eer_event_subscription_t** link = &event_subscriptions; *link != NULL; link = &(*link)->next) {
+        if (*link == subscription) {
+            *link = subscription->next;
+            subscription->next = NULL;
+            return EER_HAL_OK;
+        }
+    }
+    
+    return EER_HAL_INVALID_PARAM;
+}
+
+eer_hal_status_t eer_event_post_isr(eer_event_priority_t priority, const eer_event_t* event) {
+    if (priority >= EER_EVENT_PRIORITIES || event == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    event_queue_t* queue = &event_queues[priority];
+    uint8_t head = queue->head;
+    uint8_t next = (head + 1) & EVENT_MASK;
+    
+    if (next == queue->tail) {
+        if (queue->dropped < UINT8_MAX) {
+            queue->dropped++;
+        }
+        return EER_HAL_BUSY;
+    }
+    
+    // Publish the slot only once it is complete
+    queue->events[head] = *event;
+    queue->head = next;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t eer_event_post(eer_event_priority_t priority, const eer_event_t* event) {
+    eer_event_lock_t lock = eer_event_lock();
+    eer_hal_status_t status = eer_event_post_isr(priority, event);
+    eer_event_unlock(lock);
+    
+    return status;
+}
+
+/**
+ * @brief Call the subscribers of an event
+ */
+static void event_deliver(const eer_event_t* event) {
+    eer_event_subscription_t* subscription = event_subscriptions;
+    
+    while (subscription != NULL) {
+        // A handler may unsubscribe itself
+        eer_event_subscription_t* next = subscription->next;
+        
+        if (subscription->type == EER_EVENT_ANY || subscription->type == event->type) {
+            subscription->handler(event, subscription->user_data);
+        }
+        subscription = next;
+    }
+}
+
+uint8_t eer_event_dispatch(uint8_t budget) {
+    uint8_t count = 0;
+    
+    while (budget == 0 || count < budget) {
+        // Highest priority first, checked again before every event
+        event_queue_t* queue = NULL;
+        for (uint8_t priority = 0; priority < EER_EVENT_PRIORITIES; priority++) {
+            if (event_queues[priority].tail != event_queues[priority].head) {
+                queue = &event_queues[priority];
+                break;
+            }
+        }
+        
+        if (queue == NULL) {
+            break;
+        }
+        
+        // Copy before freeing the slot for the producers
+        uint8_t tail = queue->tail;
+        eer_event_t event = queue->events[tail];
+        queue->tail = (tail + 1) & EVENT_MASK;
+        
+        event_deliver(&event);
+        
+        if (count < UINT8_MAX) {
+            count++;
+        }
+    }
+    
+    return count;
+}
+
+bool eer_event_pending(void) {
+    for (uint8_t priority = 0; priority < EER_EVENT_PRIORITIES; priority++) {
+        if (event_queues[priority].tail != event_queues[priority].head) {
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+uint8_t eer_event_dropped(eer_event_priority_t priority) {
+    if (priority >= EER_EVENT_PRIORITIES) {
+        return 0;
+    }
+    
+    eer_event_lock_t lock = eer_event_lock();
+    uint8_t dropped = event_queues[priority].dropped;
+    event_queues[priority].dropped = 0;
+    eer_event_unlock(lock);
+    
+    return dropped;
+}
+
+/**
+ * @brief Post an event from a bridge
+ * @param route User data given at registration, see eer_event_route()
+ */
+static void event_bridge(void* route, uint8_t type, uint16_t value, void* data) {
+    uint16_t bits = (uint16_t)(uintptr_t)route;
+    eer_event_t event = {
+        .type = type,
+        .source = (uint8_t)bits,
+        .value = value,
+        .data = data
+    };
+    
+    eer_event_post_isr((eer_event_priority_t)(bits >> 8), &event);
+}
+
+void eer_event_gpio_irq(eer_gpio_irq_t* irq) {
+    event_bridge(irq->user_data, EER_EVENT_GPIO, 0, irq->pin);
+}
+
+void eer_event_adc_conversion(eer_adc_conversion_t* conversion) {
+    event_bridge(conversion->user_data, EER_EVENT_ADC, conversion->value, conversion->channel);
+}
+
+void eer_event_uart_rx(eer_uart_rx_event_t* event) {
+    // One event per byte
+    for (uint16_t i = 0; i < event->size; i++) {
+        event_bridge(event->user_data, EER_EVENT_UART_RX, event->data[i], event->uart);
+    }
+}
+
+void eer_event_uart_tx(eer_uart_tx_event_t* event) {
+    event_bridge(event->user_data, EER_EVENT_UART_TX, 0, event->uart);
+}
+
+void eer_event_spi_transfer(eer_spi_transfer_event_t* event) {
+    event_bridge(event->user_data, EER_EVENT_SPI, event->size, event->spi);
+}
+
+void eer_event_i2c_transfer(eer_i2c_transfer_event_t* event) {
+    event_bridge(event->user_data, EER_EVENT_I2C, event->address, event->i2c);
+}
+
+void eer_event_timer(eer_timer_event_info_t* event) {
+    uint8_t type = event->event == EER_TIMER_EVENT_COMPARE ? EER_EVENT_TIMER_COMPARE
+                 : event->event == EER_TIMER_EVENT_CAPTURE ? EER_EVENT_TIMER_CAPTURE
+                 : EER_EVENT_TIMER_OVERFLOW;
+                 
+    event_bridge(event->user_data, type, (uint16_t)event->value, event->timer);
+}
+
+void eer_event_async(eer_async_request_t* request, void* user_data) {
+    event_bridge(user_data, EER_EVENT_ASYNC, request->status, request);
+}
@@ -0,0 +1,299 @@
+#include "eer_ir.h"
+#include <stddef.h>
+
+// Pulse lengths, indices into ir->window
+enum {
+    IR_T_NEC_LEADER,   /* Leader mark */
+    IR_T_NEC_FRAME,    /* Leader space of a frame */
+    IR_T_NEC_REPEAT,   /* Leader space of a repeat code */
+    IR_T_NEC_BIT,      /* Bit mark, space of a 0 */
+    IR_T_NEC_ONE,      /* Space of a 1 */
+    IR_T_RC5_HALF,     /* Half a bit */
+    IR_T_RC5_FULL,     /* Whole bit, both halves at one level */
+    IR_T_COUNT
+};
+
+// NEC decoder states
+#define NEC_IDLE    0  /* Waiting for a leader mark */
+#define NEC_LEADER  1  /* Leader mark seen, its space decides frame or repeat */
+#define NEC_MARK    2  /* Waiting for the mark of the next bit */
+#define NEC_SPACE   3  /* Bit mark seen, its space gives the value */
+
+// Length of a pulse longer than the line may idle within a lap of the counter
+#define IR_IDLE 0xFFFF
+
+static bool ir_match(const eer_ir_t* ir, uint8_t pulse, uint16_t length) {
+    return length >= ir->window[pulse][0] && length <= ir->window[pulse][1];
+}
+
+static void ir_error(eer_ir_t* ir) {
+    if (ir->errors != UINT8_MAX) {
+        ir->errors++;
+    }
+}
+
+/**
+ * @brief Post the code of the last frame
+ */
+static void ir_post(eer_ir_t* ir, uint8_t type, uint32_t now) {
+    eer_event_t event = {
+        .type = type,
+        .source = ir->source,
+        .value = (uint32_t)ir->address << 8 | ir->command,
+        .data = ir
+    };
+    
+    ir->frame_ms = now;
+    eer_event_post_isr(ir->priority, &event);
+}
+
+static bool ir_held(const eer_ir_t* ir, uint8_t protocol, uint32_t now) {
+    return ir->protocol == protocol && now - ir->frame_ms <= EER_IR_REPEAT_MS;
+}
+
+/**
+ * @brief Check the 32 bits of an NEC frame, LSB first: address, inverted
+ *        address or its high byte, command, inverted command
+ */
+static void ir_nec_frame(eer_ir_t* ir, uint32_t now) {
+    uint32_t data = ir->nec_data;
+    uint8_t address = (uint8_t)data;
+    uint8_t command = (uint8_t)(data >> 16);
+    
+    if ((uint8_t)(data >> 24) != (uint8_t)~command) {
+        ir_error(ir);
+        return;
+    }
+    
+    ir->protocol = EER_IR_NEC;
+    ir->address = (uint8_t)(data >> 8) == (uint8_t)~address ? address : (uint16_t)data;
+    ir->command = command;
+    ir_post(ir, EER_EVENT_IR, now);
+}
+
+static void ir_nec(eer_ir_t* ir, bool mark, uint16_t length, uint32_t now) {
+    if (mark) {
+        if (ir_match(ir, IR_T_NEC_LEADER, length)) {
+            ir->nec_state = NEC_LEADER;
+        } else if (ir->nec_state == NEC_MARK && ir_match(ir, IR_T_NEC_BIT, length)) {
+            ir->nec_state = NEC_SPACE;
+        } else {
+            if (ir->nec_state == NEC_MARK) {
+                ir_error(ir);
+            }
+            ir->nec_state = NEC_IDLE;
+        }
+        return;
+    }
+    
+    switch (ir->nec_state) {
+        case NEC_LEADER:
+            ir->nec_state = NEC_IDLE;
+            
+            if (ir_match(ir, IR_T_NEC_FRAME, length)) {
+                ir->nec_state = NEC_MARK;
+                ir->nec_bits = 0;
+                ir->nec_data = 0;
+            } else if (ir_match(ir, IR_T_NEC_REPEAT, length)) {
+                // The stop mark of the repeat code has started
+                if (ir_held(ir, EER_IR_NEC, now)) {
+                    ir_post(ir, EER_EVENT_IR_REPEAT, now);
+                }
+            }
+            break;
+            
+        case NEC_SPACE:
+            if (ir_match(ir, IR_T_NEC_ONE, length)) {
+                ir->nec_data |= 1UL << ir->nec_bits;
+            } else if (!ir_match(ir, IR_T_NEC_BIT, length)) {
+                ir_error(ir);
+                ir->nec_state = NEC_IDLE;
+                break;
+            }
+            
+            // The 32nd bit ends where the stop mark starts
+            if (++ir->nec_bits == 32) {
+                ir->nec_state = NEC_IDLE;
+                ir_nec_frame(ir, now);
+            } else {
+                ir->nec_state = NEC_MARK;
+            }
+            break;
+            
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Check the 14 bits of an RC5 frame, MSB first: start bit, field
+ *        bit, toggle bit, 5 address bits, 6 command bits
+ */
+static void ir_rc5_frame(eer_ir_t* ir, uint32_t now) {
+    uint16_t data = ir->rc5_data;
+    bool toggle = (data >> 11) & 1;
+    uint8_t address = (data >> 6) & 0x1F;
+    
+    // RC5X takes the inverted field bit as command bit 6
+    uint8_t command = (data & 0x3F) | ((data >> 12) & 1 ? 0 : 0x40);
+    
+    // A held key repeats the frame with the toggle bit unchanged
+    bool held = ir_held(ir, EER_IR_RC5, now) && ir->toggle == toggle &&
+                ir->address == address && ir->command == command;
+    
+    ir->protocol = EER_IR_RC5;
+    ir->address = address;
+    ir->command = command;
+    ir->toggle = toggle;
+    ir_post(ir, held ? EER_EVENT_IR_REPEAT : EER_EVENT_IR, now);
+}
+
+static void ir_rc5(eer_ir_t* ir, bool mark, uint16_t length, uint32_t now) {
+    if (ir->rc5_bits != 0) {
+        bool half = ir_match(ir, IR_T_RC5_HALF, length);
+        
+        // Half a bit from the middle of a bit reaches its end
+        if (half && ir->rc5_mid) {
+            ir->rc5_mid = false;
+            return;
+        }
+        
+        // Otherwise the edge is the middle of the next bit, a 1 if a mark starts there
+        if (half || (ir->rc5_mid && ir_match(ir, IR_T_RC5_FULL, length))) {
+            ir->rc5_mid = true;
+            ir->rc5_data = (uint16_t)(ir->rc5_data << 1 | !mark);
+            
+            if (++ir->rc5_bits == 14) {
+                ir->rc5_bits = 0;
+                ir_rc5_frame(ir, now);
+            }
+            return;
+        }
+        
+        // Other protocols fail on the start bits
+        if (ir->rc5_bits > 2) {
+            ir_error(ir);
+        }
+        ir->rc5_bits = 0;
+    }
+    
+    // The first edge after the line idled is the middle of the first start bit
+    if (!mark && length > ir->window[IR_T_RC5_FULL][1]) {
+        ir->rc5_bits = 1;
+        ir->rc5_data = 1;
+        ir->rc5_mid = true;
+    }
+}
+
+static void ir_capture_handler(eer_timer_event_info_t* event) {
+    eer_ir_t* ir = (eer_ir_t*)event->user_data;
+    uint16_t capture = (uint16_t)event->value;
+    uint16_t length = capture - ir->capture;
+    uint32_t now = 0;
+    
+    eer_hal_call(system, get_tick, &now);
+    
+    // The counter may have lapped since the last edge
+    if (now - ir->edge_ms >= EER_IR_IDLE_MS) {
+        length = IR_IDLE;
+    }
+    
+    // A rising edge ends a mark
+    bool mark = ir->rising;
+    
+    ir->capture = capture;
+    ir->edge_ms = now;
+    ir->rising = !ir->rising;
+    eer_hal_call(timer_instance, set_capture_edge, ir->timer, ir->rising);
+    
+    if (ir->protocols == 0 || (ir->protocols & EER_IR_NEC)) {
+        ir_nec(ir, mark, length, now);
+    }
+    if (ir->protocols == 0 || (ir->protocols & EER_IR_RC5)) {
+        ir_rc5(ir, mark, length, now);
+    }
+}
+
+eer_hal_status_t eer_ir_init(eer_ir_t* ir) {
+    if (ir == NULL || ir->timer == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_timer_config_t timer_config = {
+        .frequency = EER_IR_TIMER_FREQUENCY,
+        .mode = EER_TIMER_MODE_CONTINUOUS,
+        .period = 0
+    };
+    
+    eer_hal_status_t status = eer_hal_call(timer_instance, init, ir->timer, &timer_config);
+    if (status != EER_HAL_OK) {
+        return status;
+    }
+    
+    // Longer idle times than a lap of the counter come from the system tick
+    if (eer_hal_call(timer_instance, us_to_ticks, ir->timer, (EER_IR_IDLE_MS + 1) * 1000UL) >= IR_IDLE) {
+        eer_hal_call(timer_instance, deinit, ir->timer);
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    static const uint16_t lengths_us[IR_T_COUNT] = {
+        [IR_T_NEC_LEADER] = 9000,
+        [IR_T_NEC_FRAME] = 4500,
+        [IR_T_NEC_REPEAT] = 2250,
+        [IR_T_NEC_BIT] = 562,
+        [IR_T_NEC_ONE] = 1687,
+        [IR_T_RC5_HALF] = 889,
+        [IR_T_RC5_FULL] = 1778
+    };
+    
+    // Converted once, the capture callback only compares
+    for (uint8_t i = 0; i < IR_T_COUNT; i++) {
+        uint32_t ticks = eer_hal_call(timer_instance, us_to_ticks, ir->timer, lengths_us[i]);
+        uint32_t margin = ticks * EER_IR_TOLERANCE_PERCENT / 100;
+        
+        ir->window[i][0] = (uint16_t)(ticks - margin);
+        ir->window[i][1] = (uint16_t)(ticks + margin);
+    }
+    
+    ir->protocol = 0;
+    ir->errors = 0;
+    ir->nec_state = NEC_IDLE;
+    ir->rc5_bits = 0;
+    
+    // The line idles high; the first mark starts with a falling edge
+    uint32_t now = 0;
+    eer_hal_call(system, get_tick, &now);
+    ir->rising = false;
+    ir->capture = 0;
+    ir->edge_ms = now - EER_IR_IDLE_MS;
+    
+    status = eer_hal_call(timer_instance, set_capture_edge, ir->timer, false);
+    if (status == EER_HAL_OK) {
+        status = eer_hal_call(timer_instance, register_callback, ir->timer,
+                              EER_TIMER_EVENT_CAPTURE, 0, ir_capture_handler, ir);
+    }
+    if (status == EER_HAL_OK) {
+        status = eer_hal_call(timer_instance, start, ir->timer);
+    }
+    
+    if (status != EER_HAL_OK) {
+        eer_ir_deinit(ir);
+    }
+    
+    return status;
+}
+
+eer_hal_status_t eer_ir_deinit(eer_ir_t* ir) {
+    if (ir == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_hal_call(timer_instance, stop, ir->timer);
+    eer_hal_call(timer_instance, unregister_callback, ir->timer, EER_TIMER_EVENT_CAPTURE, 0);
+    eer_hal_call(timer_instance, deinit, ir->timer);
+    
+    ir->nec_state = NEC_IDLE;
+    ir->rc5_bits = 0;
+    
+    return EER_HAL_OK;
+}
@@ -0,0 +1,278 @@
+#include "eer_kv.h"
+#include "eer_crc.h"
+#include <stddef.h>
+#include <string.h>
+
+#if EER_KV_VALUE_MAX < 1 || EER_KV_VALUE_MAX > 250
+#error "EER_KV_SLOT_SIZE must leave room for 1 to 250 value bytes"
+#endif
+
+// Record layout within a slot
+#define KV_KEY      0
+#define KV_LENGTH   1
+#define KV_SEQ      2
+#define KV_DATA     EER_KV_HEADER_SIZE
+#define KV_CRC      (EER_KV_SLOT_SIZE - 2)
+
+// Timeout for accepting a record into the storage write path
+#define KV_TIMEOUT  1000
+
+static uint32_t kv_slot_address(eer_kv_t* kv, uint16_t slot) {
+    return kv->base + (uint32_t)slot * EER_KV_SLOT_SIZE;
+}
+
+static uint16_t kv_next(eer_kv_t* kv, uint16_t slot) {
+    return (slot + 1 == kv->slots) ? 0 : slot + 1;
+}
+
+static uint16_t kv_record_seq(const uint8_t* record) {
+    return record[KV_SEQ] | ((uint16_t)record[KV_SEQ + 1] << 8);
+}
+
+/**
+ * @brief Compare sequence numbers with wrap-around
+ * @return true if a was written after b
+ *
+ * Every slot is rewritten once per lap, so stored sequence numbers are
+ * never more than the slot count apart.
+ */
+static bool kv_seq_newer(uint16_t a, uint16_t b) {
+    return (int16_t)(a - b) > 0;
+}
+
+/**
+ * @brief Check if a slot holds the latest record of some key
+ */
+static bool kv_is_live(eer_kv_t* kv, uint16_t slot) {
+    for (uint8_t key = 0; key < EER_KV_MAX_KEYS; key++) {
+        if (kv->index[key] == slot) {
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+/**
+ * @brief Read a slot and validate the record in it
+ * @param kv Store instance
+ * @param slot Slot number
+ * @param record Buffer of EER_KV_SLOT_SIZE bytes
+ * @return true if the slot holds a complete record
+ */
+static bool kv_read_record(eer_kv_t* kv, uint16_t slot, uint8_t* record) {
+    if (kv->nvs->read(kv_slot_address(kv, slot), record, EER_KV_SLOT_SIZE) != EER_HAL_OK) {
+        return false;
+    }
+    
+    uint16_t crc = record[KV_CRC] | ((uint16_t)record[KV_CRC + 1] << 8);
+    
+    return record[KV_KEY] < EER_KV_MAX_KEYS
+        && record[KV_LENGTH] <= EER_KV_VALUE_MAX
+        && eer_crc16_ccitt(EER_CRC16_CCITT_INIT, record, KV_CRC) == crc;
+}
+
+/**
+ * @brief Extend the run of reusable slots ahead of the head
+ */
+static void kv_update_free(eer_kv_t* kv) {
+    uint16_t slot = (uint16_t)((kv->head + kv->free) % kv->slots);
+    
+    while (kv->free < kv->slots && !kv_is_live(kv, slot)) {
+        kv->free++;
+        slot = kv_next(kv, slot);
+    }
+}
+
+/**
+ * @brief Write a record to the head slot and make it the key's latest value
+ * @note Requires at least one free slot
+ */
+static eer_hal_status_t kv_append(eer_kv_t* kv, uint8_t* record) {
+    record[KV_SEQ] = (uint8_t)kv->seq;
+    record[KV_SEQ + 1] = (uint8_t)(kv->seq >> 8);
+    
+    uint16_t crc = eer_crc16_ccitt(EER_CRC16_CCITT_INIT, record, KV_CRC);
+    record[KV_CRC] = (uint8_t)crc;
+    record[KV_CRC + 1] = (uint8_t)(crc >> 8);
+    
+    eer_hal_status_t status = kv->nvs->write(kv_slot_address(kv, kv->head), record, EER_KV_SLOT_SIZE, KV_TIMEOUT);
+    if (status != EER_HAL_OK) {
+        return status;
+    }
+    
+    // The previous record of the key stays intact until the head reaches it
+    kv->index[record[KV_KEY]] = kv->head;
+    kv->head = kv_next(kv, kv->head);
+    kv->free--;
+    kv->seq++;
+    
+    return EER_HAL_OK;
+}
+
+/**
+ * @brief Copy the oldest live record to the head or reclaim a dead tail
+ * @note Requires at least one free slot
+ */
+static eer_hal_status_t kv_compact_step(eer_kv_t* kv) {
+    uint8_t record[EER_KV_SLOT_SIZE];
+    uint16_t tail = (uint16_t)((kv->head + kv->free) % kv->slots);
+    
+    // The tail record may have been superseded since the gap was measured
+    if (!kv_is_live(kv, tail)) {
+        kv_update_free(kv);
+        return EER_HAL_OK;
+    }
+    
+    if (kv_read_record(kv, tail, record)) {
+        eer_hal_status_t status = kv_append(kv, record);
+        if (status != EER_HAL_OK) {
+            return status;
+        }
+    } else {
+        // The record went bad in storage, there is nothing left to keep
+        for (uint8_t key = 0; key < EER_KV_MAX_KEYS; key++) {
+            if (kv->index[key] == tail) {
+                kv->index[key] = EER_KV_NO_SLOT;
+            }
+        }
+    }
+    
+    kv_update_free(kv);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t eer_kv_init(eer_kv_t* kv, eer_nvs_handler_t* nvs, uint32_t base, uint32_t size) {
+    if (kv == NULL || nvs == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    uint32_t slots = size / EER_KV_SLOT_SIZE;
+    
+    // Two slots beyond one per key keep compaction able to make progress
+    if (slots < EER_KV_MAX_KEYS + 2 || slots >= EER_KV_NO_SLOT) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    kv->nvs = nvs;
+    kv->base = base;
+    kv->slots = (uint16_t)slots;
+    
+    for (uint8_t key = 0; key < EER_KV_MAX_KEYS; key++) {
+        kv->index[key] = EER_KV_NO_SLOT;
+    }
+    
+    // Single scan: the newest valid record of each key wins
+    uint8_t record[EER_KV_SLOT_SIZE];
+    uint16_t key_seq[EER_KV_MAX_KEYS];
+    uint16_t newest = EER_KV_NO_SLOT;
+    uint16_t newest_seq = 0;
+    
+    for (uint16_t slot = 0; slot < kv->slots; slot++) {
+        if (!kv_read_record(kv, slot, record)) {
+            continue;
+        }
+        
+        uint8_t key = record[KV_KEY];
+        uint16_t seq = kv_record_seq(record);
+        
+        if (kv->index[key] == EER_KV_NO_SLOT || kv_seq_newer(seq, key_seq[key])) {
+            kv->index[key] = slot;
+            key_seq[key] = seq;
+        }
+        
+        if (newest == EER_KV_NO_SLOT || kv_seq_newer(seq, newest_seq)) {
+            newest = slot;
+            newest_seq = seq;
+        }
+    }
+    
+    // Continue the log after the newest record
+    kv->head = 0;
+    kv->seq = 0;
+    if (newest != EER_KV_NO_SLOT) {
+        kv->head = kv_next(kv, newest);
+        kv->seq = newest_seq + 1;
+    }
+    
+    // Skip live slots in case a lap was interrupted by a reset
+    for (uint16_t i = 0; i < kv->slots && kv_is_live(kv, kv->head); i++) {
+        kv->head = kv_next(kv, kv->head);
+    }
+    
+    kv->free = 0;
+    kv_update_free(kv);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t eer_kv_get(eer_kv_t* kv, uint8_t key, uint8_t* data, uint8_t size, uint8_t* length) {
+    if (kv == NULL || key >= EER_KV_MAX_KEYS || length == NULL || (data == NULL && size > 0)) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    uint8_t record[EER_KV_SLOT_SIZE];
+    uint16_t slot = kv->index[key];
+    
+    if (slot == EER_KV_NO_SLOT || !kv_read_record(kv, slot, record)) {
+        return EER_HAL_ERROR;
+    }
+    
+    if (record[KV_LENGTH] > size) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    memcpy(data, &record[KV_DATA], record[KV_LENGTH]);
+    *length = record[KV_LENGTH];
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t eer_kv_set(eer_kv_t* kv, uint8_t key, const uint8_t* data, uint8_t length) {
+    if (kv == NULL || key >= EER_KV_MAX_KEYS || length > EER_KV_VALUE_MAX || (data == NULL && length > 0)) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    uint8_t record[EER_KV_SLOT_SIZE];
+    
+    // Rewriting the same value costs a slot for nothing
+    if (kv->index[key] != EER_KV_NO_SLOT
+        && kv_read_record(kv, kv->index[key], record)
+        && record[KV_LENGTH] == length
+        && (length == 0 || memcmp(&record[KV_DATA], data, length) == 0)) {
+        return EER_HAL_OK;
+    }
+    
+    // Keep one slot free after this write for the next compaction step
+    while (kv->free < 2) {
+        eer_hal_status_t status = kv_compact_step(kv);
+        if (status != EER_HAL_OK) {
+            return status;
+        }
+    }
+    
+    record[KV_KEY] = key;
+    record[KV_LENGTH] = length;
+    memset(&record[KV_DATA], EER_NVS_ERASED_BYTE, EER_KV_VALUE_MAX);
+    if (length > 0) {
+        memcpy(&record[KV_DATA], data, length);
+    }
+    
+    return kv_append(kv, record);
+}
+
+eer_hal_status_t eer_kv_compact(eer_kv_t* kv, uint8_t steps) {
+    if (kv == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    while (steps-- > 0 && kv->free < EER_KV_RESERVE && kv->free < kv->slots) {
+        eer_hal_status_t status = kv_compact_step(kv);
+        if (status != EER_HAL_OK) {
+            return status;
+        }
+    }
+    
+    return EER_HAL_OK;
+}
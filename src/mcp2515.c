@@ -0,0 +1,501 @@
+#include "eer_mcp2515.h"
+#include "eer_spi_device.h"
+#include "event.h"
+#include <stddef.h>
+
+// SPI instructions
+#define MCP2515_RESET       0xC0
+#define MCP2515_READ        0x03
+#define MCP2515_WRITE       0x02
+#define MCP2515_BIT_MODIFY  0x05
+#define MCP2515_READ_STATUS 0xA0
+#define MCP2515_READ_RX     0x90  /* | buffer << 2, from RXBnSIDH; clears RXnIF */
+#define MCP2515_LOAD_TX     0x40  /* | buffer << 1, from TXBnSIDH */
+
+// Registers
+#define MCP2515_RXF0SIDH 0x00
+#define MCP2515_RXF3SIDH 0x10
+#define MCP2515_RXM0SIDH 0x20
+#define MCP2515_CANSTAT  0x0E
+#define MCP2515_CANCTRL  0x0F
+#define MCP2515_CNF3     0x28
+#define MCP2515_CANINTE  0x2B
+#define MCP2515_CANINTF  0x2C
+#define MCP2515_TXB0CTRL 0x30  /* TXBnCTRL at 0x30 + 0x10 * n */
+#define MCP2515_RXB0CTRL 0x60
+#define MCP2515_RXB1CTRL 0x70
+
+// Register bits
+#define MCP2515_MODE_MASK   0xE0
+#define MCP2515_MODE_CONFIG 0x80
+#define MCP2515_TXREQ       0x08
+#define MCP2515_RXM_ANY     0x60
+#define MCP2515_BUKT        0x04
+#define MCP2515_EXIDE       0x08  /* In SIDL */
+#define MCP2515_SRR         0x10  /* In SIDL of a received standard frame */
+#define MCP2515_RTR         0x40  /* In DLC */
+#define MCP2515_BTLMODE     0x80  /* In CNF2 */
+
+// Receive and transmit interrupts, in CANINTE and CANINTF
+#define MCP2515_RX_INTERRUPTS 0x03
+#define MCP2515_TX_INTERRUPTS 0x1C
+
+// READ STATUS bits
+#define MCP2515_STATUS_RX0IF 0x01
+#define MCP2515_STATUS_RX1IF 0x02
+#define MCP2515_STATUS_TX0IF 0x08
+#define MCP2515_STATUS_TX1IF 0x20
+#define MCP2515_STATUS_TX2IF 0x80
+
+#define MCP2515_RX_MASK (EER_MCP2515_RX_QUEUE_SIZE - 1)
+
+static const uint8_t mcp2515_read_status[1] = { MCP2515_READ_STATUS };
+static const uint8_t mcp2515_read_rx[2] = { MCP2515_READ_RX, MCP2515_READ_RX | (1 << 2) };
+
+static void mcp2515_next(eer_mcp2515_t* can);
+
+static void mcp2515_write(eer_mcp2515_t* can, uint8_t address, const uint8_t* data, uint8_t size) {
+    uint8_t header[2] = { MCP2515_WRITE, address };
+    
+    eer_spi_device_select(&can->device);
+    eer_hal_call(spi, transfer, header, NULL, sizeof(header), 0);
+    eer_hal_call(spi, transfer, data, NULL, size, 0);
+    eer_spi_device_deselect(&can->device);
+}
+
+static void mcp2515_write_register(eer_mcp2515_t* can, uint8_t address, uint8_t value) {
+    mcp2515_write(can, address, &value, 1);
+}
+
+static uint8_t mcp2515_read_register(eer_mcp2515_t* can, uint8_t address) {
+    uint8_t command[3] = { MCP2515_READ, address, 0xFF };
+    uint8_t response[3] = { 0 };
+    
+    eer_spi_device_select(&can->device);
+    eer_hal_call(spi, transfer, command, response, sizeof(command), 0);
+    eer_spi_device_deselect(&can->device);
+    
+    return response[2];
+}
+
+/**
+ * @brief Encode an identifier into SIDH, SIDL, EID8 and EID0
+ */
+static void mcp2515_encode(uint8_t* registers, uint32_t id, bool extended) {
+    if (extended) {
+        registers[0] = (uint8_t)(id >> 21);
+        registers[1] = (uint8_t)(((id >> 13) & 0xE0) | MCP2515_EXIDE | ((id >> 16) & 0x03));
+        registers[2] = (uint8_t)(id >> 8);
+        registers[3] = (uint8_t)id;
+    } else {
+        registers[0] = (uint8_t)(id >> 3);
+        registers[1] = (uint8_t)((id & 0x07) << 5);
+        registers[2] = 0;
+        registers[3] = 0;
+    }
+}
+
+/**
+ * @brief Bit timing with about 16 time quanta and the sample point near 75%
+ * @return false if no prescaler divides the oscillator into the bit rate
+ */
+static bool mcp2515_timing(uint32_t oscillator, uint32_t bitrate, uint8_t cnf[3]) {
+    if (bitrate == 0) {
+        return false;
+    }
+    
+    for (uint8_t brp = 1; brp <= 64; brp++) {
+        uint32_t divider = 2UL * brp * bitrate;
+        uint32_t quanta = oscillator / divider;
+        
+        if (quanta * divider != oscillator || quanta > 16) {
+            continue;
+        }
+        if (quanta < 8) {
+            return false;
+        }
+        
+        // Sync segment of one quantum, phase 2 a quarter, the rest split
+        uint8_t phase2 = (uint8_t)(quanta / 4);
+        uint8_t rest = (uint8_t)(quanta - 1 - phase2);
+        uint8_t propagation = rest / 2;
+        uint8_t phase1 = rest - propagation;
+        
+        cnf[0] = (uint8_t)(phase2 - 1);
+        cnf[1] = (uint8_t)(MCP2515_BTLMODE | ((phase1 - 1) << 3) | (propagation - 1));
+        cnf[2] = (uint8_t)(brp - 1);
+        return true;
+    }
+    
+    return false;
+}
+
+static bool mcp2515_set_mode(eer_mcp2515_t* can, uint8_t mode) {
+    mcp2515_write_register(can, MCP2515_CANCTRL, mode);
+    
+    for (uint8_t attempts = 0; attempts < 10; attempts++) {
+        if ((mcp2515_read_register(can, MCP2515_CANSTAT) & MCP2515_MODE_MASK) == mode) {
+            return true;
+        }
+        eer_hal_call(system, delay_ms, 1);
+    }
+    
+    return false;
+}
+
+static void mcp2515_write_filters(eer_mcp2515_t* can, bool filter,
+                                  const eer_mcp2515_filter_t masks[2],
+                                  const eer_mcp2515_filter_t filters[6]) {
+    uint8_t registers[12];
+    
+    // Filters 0 to 2, then 3 to 5 after the gap at CANSTAT and CANCTRL
+    for (uint8_t group = 0; group < 2; group++) {
+        for (uint8_t i = 0; i < 3; i++) {
+            const eer_mcp2515_filter_t* entry = &filters[group * 3 + i];
+            mcp2515_encode(&registers[i * 4], entry->id, entry->extended);
+        }
+        mcp2515_write(can, group == 0 ? MCP2515_RXF0SIDH : MCP2515_RXF3SIDH, registers, 12);
+    }
+    
+    for (uint8_t i = 0; i < 2; i++) {
+        mcp2515_encode(&registers[i * 4], masks[i].id, masks[i].extended);
+        
+        // Masks have no EXIDE bit
+        registers[i * 4 + 1] &= (uint8_t)~MCP2515_EXIDE;
+    }
+    mcp2515_write(can, MCP2515_RXM0SIDH, registers, 8);
+    
+    // Buffer 0 rolls over into buffer 1 when full
+    uint8_t mode = filter ? 0 : MCP2515_RXM_ANY;
+    mcp2515_write_register(can, MCP2515_RXB0CTRL, mode | MCP2515_BUKT);
+    mcp2515_write_register(can, MCP2515_RXB1CTRL, mode);
+}
+
+/*
+ * Interrupt chain. The pin interrupt submits READ STATUS; its completion
+ * reads the full receive buffers one by one and clears the transmit flags,
+ * then reads the status again, until it shows nothing to do.
+ */
+
+static void mcp2515_submit(eer_async_request_t* request, eer_mcp2515_t* can) {
+    if (eer_async_submit(request) != EER_HAL_OK) {
+        // The bus is stopped; the next edge starts over
+        can->servicing = false;
+    }
+}
+
+static void mcp2515_start(eer_mcp2515_t* can) {
+    can->servicing = true;
+    can->again = false;
+    mcp2515_submit(&can->status_request, can);
+}
+
+static void mcp2515_irq_handler(eer_gpio_irq_t* irq) {
+    eer_mcp2515_t* can = irq->user_data;
+    
+    if (can->servicing) {
+        can->again = true;
+    } else {
+        mcp2515_start(can);
+    }
+}
+
+static void mcp2515_status_handler(eer_async_request_t* request, void* user_data) {
+    eer_mcp2515_t* can = user_data;
+    uint8_t status = can->status[1];
+    
+    if (request->status != EER_HAL_OK) {
+        can->servicing = false;
+        return;
+    }
+    
+    uint8_t done = 0;
+    if (status & MCP2515_STATUS_TX0IF) {
+        done |= 1 << 0;
+    }
+    if (status & MCP2515_STATUS_TX1IF) {
+        done |= 1 << 1;
+    }
+    if (status & MCP2515_STATUS_TX2IF) {
+        done |= 1 << 2;
+    }
+    
+    can->pending = status & (MCP2515_STATUS_RX0IF | MCP2515_STATUS_RX1IF);
+    
+    if (done == 0 && can->pending == 0) {
+        // An edge during the chain may belong to a flag set after this status
+        if (can->again) {
+            mcp2515_start(can);
+        } else {
+            can->servicing = false;
+        }
+        return;
+    }
+    
+    if (done != 0) {
+        // TXnIF are bits 2 to 4 of CANINTF; the buffers are free once cleared
+        can->flags[2] = (uint8_t)(done << 2);
+        mcp2515_submit(&can->flags_request, can);
+        can->tx_busy &= (uint8_t)~done;
+    }
+    
+    mcp2515_next(can);
+}
+
+static void mcp2515_next(eer_mcp2515_t* can) {
+    if (can->pending & MCP2515_STATUS_RX0IF) {
+        can->rx_request.tx_data = &mcp2515_read_rx[0];
+        mcp2515_submit(&can->rx_request, can);
+    } else if (can->pending & MCP2515_STATUS_RX1IF) {
+        can->rx_request.tx_data = &mcp2515_read_rx[1];
+        mcp2515_submit(&can->rx_request, can);
+    } else {
+        mcp2515_submit(&can->status_request, can);
+    }
+}
+
+static void mcp2515_rx_handler(eer_async_request_t* request, void* user_data) {
+    eer_mcp2515_t* can = user_data;
+    const uint8_t* registers = &can->rx[1];
+    
+    if (request->status != EER_HAL_OK) {
+        can->servicing = false;
+        return;
+    }
+    
+    // rx[0] was read during the instruction, the registers follow
+    can->pending &= (uint8_t)~(request->tx_data == &mcp2515_read_rx[1] ? MCP2515_STATUS_RX1IF : MCP2515_STATUS_RX0IF);
+    
+    uint8_t head = can->head;
+    uint8_t next = (head + 1) & MCP2515_RX_MASK;
+    
+    if (next == can->tail) {
+        if (can->dropped < UINT8_MAX) {
+            can->dropped++;
+        }
+        mcp2515_next(can);
+        return;
+    }
+    
+    eer_can_frame_t* frame = &can->frames[head];
+    
+    if (registers[1] & MCP2515_EXIDE) {
+        frame->id = (uint32_t)registers[0] << 21 | (uint32_t)(registers[1] & 0xE0) << 13
+            | (uint32_t)(registers[1] & 0x03) << 16 | (uint32_t)registers[2] << 8 | registers[3];
+        frame->flags = EER_CAN_EXTENDED | (registers[4] & MCP2515_RTR ? EER_CAN_RTR : 0);
+    } else {
+        frame->id = (uint32_t)registers[0] << 3 | registers[1] >> 5;
+        frame->flags = registers[1] & MCP2515_SRR ? EER_CAN_RTR : 0;
+    }
+    
+    frame->dlc = registers[4] & 0x0F;
+    if (frame->dlc > 8) {
+        frame->dlc = 8;
+    }
+    for (uint8_t i = 0; i < 8; i++) {
+        frame->data[i] = registers[5 + i];
+    }
+    
+    // Publish the slot only once it is complete
+    can->head = next;
+    
+    if (can->on_receive != NULL) {
+        can->on_receive(can, can->user_data);
+    }
+    
+    mcp2515_next(can);
+}
+
+static void mcp2515_request(eer_async_request_t* request, eer_mcp2515_t* can, const uint8_t* tx_data,
+                            uint16_t tx_size, uint8_t* rx_data, uint16_t rx_size, eer_async_handler_t handler) {
+    request->bus = EER_ASYNC_SPI;
+    request->flags = 0;
+    request->device = &can->device;
+    request->tx_data = tx_data;
+    request->tx_size = tx_size;
+    request->rx_data = rx_data;
+    request->rx_size = rx_size;
+    request->handler = handler;
+    request->user_data = can;
+    request->next = NULL;
+    request->status = EER_HAL_OK;
+}
+
+eer_hal_status_t eer_mcp2515_init(eer_mcp2515_t* can) {
+    if (can == NULL || can->interrupt == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    uint8_t cnf[3];
+    if (!mcp2515_timing(can->config.oscillator, can->config.bitrate, cnf)) {
+        return EER_HAL_NOT_SUPPORTED;
+    }
+    
+    eer_hal_status_t status = eer_spi_device_init(&can->device);
+    if (status != EER_HAL_OK) {
+        return status;
+    }
+    
+    can->head = 0;
+    can->tail = 0;
+    can->dropped = 0;
+    can->tx_busy = 0;
+    can->servicing = false;
+    can->again = false;
+    
+    mcp2515_request(&can->status_request, can, mcp2515_read_status, 1, can->status, 2, mcp2515_status_handler);
+    mcp2515_request(&can->rx_request, can, mcp2515_read_rx, 1, can->rx, sizeof(can->rx), mcp2515_rx_handler);
+    mcp2515_request(&can->flags_request, can, can->flags, sizeof(can->flags), NULL, 0, NULL);
+    can->flags[0] = MCP2515_BIT_MODIFY;
+    can->flags[1] = MCP2515_CANINTF;
+    can->flags[3] = 0;
+    
+    for (uint8_t i = 0; i < 3; i++) {
+        mcp2515_request(&can->tx_request[i], can, can->tx[i], sizeof(can->tx[i]), NULL, 0, NULL);
+        mcp2515_request(&can->tx_control_request[i], can, can->tx_control[i], sizeof(can->tx_control[i]), NULL, 0, NULL);
+        can->tx_request[i].next = &can->tx_control_request[i];
+        can->tx[i][0] = MCP2515_LOAD_TX | (i << 1);
+        can->tx_control[i][0] = MCP2515_WRITE;
+        can->tx_control[i][1] = MCP2515_TXB0CTRL + 0x10 * i;
+    }
+    
+    // The reset leaves the controller in configuration mode
+    uint8_t reset = MCP2515_RESET;
+    eer_spi_device_select(&can->device);
+    eer_hal_call(spi, transfer, &reset, NULL, 1, 0);
+    eer_spi_device_deselect(&can->device);
+    eer_hal_call(system, delay_ms, 1);
+    
+    if ((mcp2515_read_register(can, MCP2515_CANSTAT) & MCP2515_MODE_MASK) != MCP2515_MODE_CONFIG) {
+        return EER_HAL_TIMEOUT;
+    }
+    
+    mcp2515_write(can, MCP2515_CNF3, cnf, sizeof(cnf));
+    mcp2515_write_filters(can, can->config.filter, can->config.masks, can->config.filters);
+    mcp2515_write_register(can, MCP2515_CANINTF, 0);
+    mcp2515_write_register(can, MCP2515_CANINTE, MCP2515_RX_INTERRUPTS | MCP2515_TX_INTERRUPTS);
+    
+    if (!mcp2515_set_mode(can, can->config.mode)) {
+        return EER_HAL_TIMEOUT;
+    }
+    
+    eer_gpio_config_t int_config = {
+        .mode = EER_GPIO_MODE_INPUT_PULLUP,
+        .trigger = EER_GPIO_TRIGGER_FALLING
+    };
+    
+    status = eer_hal_call(gpio, configure, can->interrupt, &int_config);
+    if (status == EER_HAL_OK) {
+        status = eer_hal_call(gpio, register_irq, can->interrupt, mcp2515_irq_handler, can);
+    }
+    if (status == EER_HAL_OK) {
+        status = eer_hal_call(gpio, enable_irq, can->interrupt);
+    }
+    
+    return status;
+}
+
+eer_hal_status_t eer_mcp2515_deinit(eer_mcp2515_t* can) {
+    if (can == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_hal_call(gpio, disable_irq, can->interrupt);
+    
+    if (can->servicing || can->tx_busy != 0) {
+        eer_hal_call(gpio, enable_irq, can->interrupt);
+        return EER_HAL_BUSY;
+    }
+    
+    eer_hal_call(gpio, unregister_irq, can->interrupt);
+    mcp2515_write_register(can, MCP2515_CANCTRL, MCP2515_MODE_CONFIG);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t eer_mcp2515_send(eer_mcp2515_t* can, const eer_can_frame_t* frame, uint8_t priority) {
+    if (can == NULL || frame == NULL || frame->dlc > 8 || priority > 3) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_event_lock_t lock = eer_event_lock();
+    
+    uint8_t buffer = 0;
+    while (buffer < 3 && (can->tx_busy & (1 << buffer))) {
+        buffer++;
+    }
+    if (buffer < 3) {
+        can->tx_busy |= 1 << buffer;
+    }
+    
+    eer_event_unlock(lock);
+    
+    if (buffer == 3) {
+        return EER_HAL_BUSY;
+    }
+    
+    uint8_t* tx = can->tx[buffer];
+    mcp2515_encode(&tx[1], frame->id, frame->flags & EER_CAN_EXTENDED);
+    tx[5] = frame->dlc | (frame->flags & EER_CAN_RTR ? MCP2515_RTR : 0);
+    for (uint8_t i = 0; i < 8; i++) {
+        tx[6 + i] = i < frame->dlc ? frame->data[i] : 0;
+    }
+    
+    // Loading the buffer, then requesting it with its priority
+    can->tx_control[buffer][2] = MCP2515_TXREQ | priority;
+    
+    eer_hal_status_t status = eer_async_submit(&can->tx_request[buffer]);
+    if (status != EER_HAL_OK) {
+        lock = eer_event_lock();
+        can->tx_busy &= (uint8_t)~(1 << buffer);
+        eer_event_unlock(lock);
+    }
+    
+    return status;
+}
+
+bool eer_mcp2515_receive(eer_mcp2515_t* can, eer_can_frame_t* frame) {
+    uint8_t tail = can->tail;
+    
+    if (tail == can->head) {
+        return false;
+    }
+    
+    *frame = can->frames[tail];
+    can->tail = (tail + 1) & MCP2515_RX_MASK;
+    
+    return true;
+}
+
+eer_hal_status_t eer_mcp2515_set_filters(eer_mcp2515_t* can, bool filter,
+                                         const eer_mcp2515_filter_t masks[2],
+                                         const eer_mcp2515_filter_t filters[6]) {
+    if (can == NULL || masks == NULL || filters == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_hal_call(gpio, disable_irq, can->interrupt);
+    
+    if (can->servicing || can->tx_busy != 0) {
+        eer_hal_call(gpio, enable_irq, can->interrupt);
+        return EER_HAL_BUSY;
+    }
+    
+    eer_hal_status_t status = EER_HAL_TIMEOUT;
+    
+    if (mcp2515_set_mode(can, MCP2515_MODE_CONFIG)) {
+        mcp2515_write_filters(can, filter, masks, filters);
+        if (mcp2515_set_mode(can, can->config.mode)) {
+            status = EER_HAL_OK;
+        }
+    }
+    
+    eer_hal_call(gpio, enable_irq, can->interrupt);
+    
+    // Frames may have come in before the filters changed
+    if (!can->servicing) {
+        mcp2515_start(can);
+    }
+    
+    return status;
+}
@@ -0,0 +1,423 @@
+#include "eer_modbus.h"
+#include "eer_crc.h"
+#include <stddef.h>
+
+// Smallest frame: address, function and CRC
+#define MODBUS_FRAME_MIN 4
+
+// Function codes
+#define MODBUS_READ_COILS              0x01
+#define MODBUS_READ_DISCRETE_INPUTS    0x02
+#define MODBUS_READ_HOLDING_REGISTERS  0x03
+#define MODBUS_READ_INPUT_REGISTERS    0x04
+#define MODBUS_WRITE_SINGLE_COIL       0x05
+#define MODBUS_WRITE_SINGLE_REGISTER   0x06
+#define MODBUS_WRITE_MULTIPLE_COILS    0x0F
+#define MODBUS_WRITE_MULTIPLE_REGISTERS 0x10
+
+// Slave states
+#define MODBUS_IDLE       0  /* Waiting for the first byte of a frame */
+#define MODBUS_RECEIVING  1  /* Frame open, the silence timer is armed */
+#define MODBUS_SENDING    2  /* Response on the line, received bytes are dropped */
+
+// Silence above 19200 baud, fixed by the specification
+#define MODBUS_SILENCE_FAST_US 1750
+
+static uint16_t modbus_get16(const uint8_t* data) {
+    return (uint16_t)data[0] << 8 | data[1];
+}
+
+static void modbus_put16(uint8_t* data, uint16_t value) {
+    data[0] = (uint8_t)(value >> 8);
+    data[1] = (uint8_t)value;
+}
+
+static bool modbus_get_bit(const uint8_t* bits, uint16_t index) {
+    return (bits[index >> 3] >> (index & 7)) & 1;
+}
+
+static void modbus_put_bit(uint8_t* bits, uint16_t index, bool value) {
+    if (value) {
+        bits[index >> 3] |= (uint8_t)(1 << (index & 7));
+    } else {
+        bits[index >> 3] &= (uint8_t)~(1 << (index & 7));
+    }
+}
+
+/**
+ * @brief Drop the frame and wait for the next one
+ */
+static void modbus_reset(eer_modbus_t* modbus) {
+    modbus->length = 0;
+    modbus->crc = EER_CRC16_MODBUS_INIT;
+    modbus->state = MODBUS_IDLE;
+}
+
+/**
+ * @brief Turn the request in the frame into an exception response
+ * @return Length of the response without CRC
+ */
+static uint16_t modbus_exception(eer_modbus_t* modbus, eer_modbus_exception_t code) {
+    modbus->frame[1] |= 0x80;
+    modbus->frame[2] = (uint8_t)code;
+    
+    return 3;
+}
+
+/**
+ * @brief Check that a range lies within a table
+ */
+static bool modbus_in_table(uint16_t start, uint16_t count, uint16_t size) {
+    return (uint32_t)start + count <= size;
+}
+
+/**
+ * @brief Read coils or discrete inputs into the response
+ */
+static uint16_t modbus_read_bits(eer_modbus_t* modbus, const uint8_t* bits, uint16_t size) {
+    uint16_t start = modbus_get16(&modbus->frame[2]);
+    uint16_t count = modbus_get16(&modbus->frame[4]);
+    uint8_t bytes = (uint8_t)((count + 7) / 8);
+    
+    if (count == 0 || count > 2000 || 3u + bytes + 2u > EER_MODBUS_FRAME_SIZE) {
+        return modbus_exception(modbus, EER_MODBUS_ILLEGAL_DATA_VALUE);
+    }
+    
+    if (bits == NULL || !modbus_in_table(start, count, size)) {
+        return modbus_exception(modbus, EER_MODBUS_ILLEGAL_DATA_ADDRESS);
+    }
+    
+    uint8_t* data = &modbus->frame[3];
+    modbus->frame[2] = bytes;
+    
+    for (uint8_t i = 0; i < bytes; i++) {
+        data[i] = 0;
+    }
+    
+    for (uint16_t i = 0; i < count; i++) {
+        if (modbus_get_bit(bits, start + i)) {
+            data[i >> 3] |= (uint8_t)(1 << (i & 7));
+        }
+    }
+    
+    return 3 + bytes;
+}
+
+/**
+ * @brief Read holding or input registers into the response
+ */
+static uint16_t modbus_read_registers(eer_modbus_t* modbus, const uint16_t* registers, uint16_t size) {
+    uint16_t start = modbus_get16(&modbus->frame[2]);
+    uint16_t count = modbus_get16(&modbus->frame[4]);
+    
+    if (count == 0 || count > 125 || 3u + 2u * count + 2u > EER_MODBUS_FRAME_SIZE) {
+        return modbus_exception(modbus, EER_MODBUS_ILLEGAL_DATA_VALUE);
+    }
+    
+    if (registers == NULL || !modbus_in_table(start, count, size)) {
+        return modbus_exception(modbus, EER_MODBUS_ILLEGAL_DATA_ADDRESS);
+    }
+    
+    modbus->frame[2] = (uint8_t)(2 * count);
+    
+    for (uint16_t i = 0; i < count; i++) {
+        modbus_put16(&modbus->frame[3 + 2 * i], registers[start + i]);
+    }
+    
+    return 3 + 2 * count;
+}
+
+/**
+ * @brief Report a write to the application
+ */
+static void modbus_written(eer_modbus_t* modbus, uint16_t address, uint16_t count) {
+    if (modbus->on_write != NULL) {
+        modbus->on_write(modbus, modbus->frame[1], address, count, modbus->user_data);
+    }
+}
+
+/**
+ * @brief Run the request in the frame and build the response in its place
+ * @param size Length of the request without CRC
+ * @return Length of the response without CRC
+ */
+static uint16_t modbus_process(eer_modbus_t* modbus, uint16_t size) {
+    uint8_t* frame = modbus->frame;
+    
+    bool supported = (frame[1] >= MODBUS_READ_COILS && frame[1] <= MODBUS_WRITE_SINGLE_REGISTER)
+        || frame[1] == MODBUS_WRITE_MULTIPLE_COILS || frame[1] == MODBUS_WRITE_MULTIPLE_REGISTERS;
+    if (!supported) {
+        return modbus_exception(modbus, EER_MODBUS_ILLEGAL_FUNCTION);
+    }
+    
+    // Every supported request carries at least an address and a value
+    if (size < 6) {
+        return modbus_exception(modbus, EER_MODBUS_ILLEGAL_DATA_VALUE);
+    }
+    
+    uint16_t start = modbus_get16(&frame[2]);
+    uint16_t value = modbus_get16(&frame[4]);
+    
+    switch (frame[1]) {
+        case MODBUS_READ_COILS:
+            return modbus_read_bits(modbus, modbus->coils, modbus->coil_count);
+            
+        case MODBUS_READ_DISCRETE_INPUTS:
+            return modbus_read_bits(modbus, modbus->discrete_inputs, modbus->discrete_input_count);
+            
+        case MODBUS_READ_HOLDING_REGISTERS:
+            return modbus_read_registers(modbus, modbus->holding_registers, modbus->holding_register_count);
+            
+        case MODBUS_READ_INPUT_REGISTERS:
+            return modbus_read_registers(modbus, modbus->input_registers, modbus->input_register_count);
+            
+        case MODBUS_WRITE_SINGLE_COIL:
+            if (value != 0xFF00 && value != 0x0000) {
+                return modbus_exception(modbus, EER_MODBUS_ILLEGAL_DATA_VALUE);
+            }
+            if (modbus->coils == NULL || start >= modbus->coil_count) {
+                return modbus_exception(modbus, EER_MODBUS_ILLEGAL_DATA_ADDRESS);
+            }
+            modbus_put_bit(modbus->coils, start, value == 0xFF00);
+            modbus_written(modbus, start, 1);
+            
+            // The response echoes the request
+            return 6;
+            
+        case MODBUS_WRITE_SINGLE_REGISTER:
+            if (modbus->holding_registers == NULL || start >= modbus->holding_register_count) {
+                return modbus_exception(modbus, EER_MODBUS_ILLEGAL_DATA_ADDRESS);
+            }
+            modbus->holding_registers[start] = value;
+            modbus_written(modbus, start, 1);
+            return 6;
+            
+        case MODBUS_WRITE_MULTIPLE_COILS:
+            if (value == 0 || value > 1968 || size < 7 || frame[6] != (value + 7) / 8
+                || size != 7u + frame[6]) {
+                return modbus_exception(modbus, EER_MODBUS_ILLEGAL_DATA_VALUE);
+            }
+            if (modbus->coils == NULL || !modbus_in_table(start, value, modbus->coil_count)) {
+                return modbus_exception(modbus, EER_MODBUS_ILLEGAL_DATA_ADDRESS);
+            }
+            for (uint16_t i = 0; i < value; i++) {
+                modbus_put_bit(modbus->coils, start + i, modbus_get_bit(&frame[7], i));
+            }
+            modbus_written(modbus, start, value);
+            
+            // Address, function, start and quantity
+            return 6;
+            
+        case MODBUS_WRITE_MULTIPLE_REGISTERS:
+            if (value == 0 || value > 123 || size < 7 || frame[6] != 2 * value
+                || size != 7u + frame[6]) {
+                return modbus_exception(modbus, EER_MODBUS_ILLEGAL_DATA_VALUE);
+            }
+            if (modbus->holding_registers == NULL || !modbus_in_table(start, value, modbus->holding_register_count)) {
+                return modbus_exception(modbus, EER_MODBUS_ILLEGAL_DATA_ADDRESS);
+            }
+            for (uint16_t i = 0; i < value; i++) {
+                modbus->holding_registers[start + i] = modbus_get16(&frame[7 + 2 * i]);
+            }
+            modbus_written(modbus, start, value);
+            return 6;
+            
+        default:
+            return modbus_exception(modbus, EER_MODBUS_ILLEGAL_FUNCTION);
+    }
+}
+
+/**
+ * @brief Receive callback: store the byte and push the end of the frame back
+ */
+static void modbus_rx_handler(eer_uart_rx_event_t* event) {
+    eer_modbus_t* modbus = (eer_modbus_t*)event->user_data;
+    
+    if (modbus->state == MODBUS_SENDING) {
+        return;
+    }
+    
+    for (uint16_t i = 0; i < event->size; i++) {
+        if (modbus->length < EER_MODBUS_FRAME_SIZE) {
+            modbus->frame[modbus->length] = event->data[i];
+            modbus->crc = eer_crc16_modbus_update(modbus->crc, event->data[i]);
+        }
+        
+        // Counted past the buffer, so an overrun is seen at the end of the frame
+        if (modbus->length <= EER_MODBUS_FRAME_SIZE) {
+            modbus->length++;
+        }
+    }
+    
+    uint32_t now = 0;
+    eer_hal_call(timer_instance, get_value, modbus->timer, &now);
+    eer_hal_call(timer_instance, set_compare, modbus->timer, 0, (now + modbus->silence) & 0xFFFF);
+    
+    modbus->state = MODBUS_RECEIVING;
+}
+
+/**
+ * @brief Compare callback: the line was silent for 3.5 characters, the frame is complete
+ */
+static void modbus_silence_handler(eer_timer_event_info_t* event) {
+    eer_modbus_t* modbus = (eer_modbus_t*)event->user_data;
+    
+    // The counter passes the compare value once per lap while idle
+    if (modbus->state != MODBUS_RECEIVING) {
+        return;
+    }
+    
+    if (modbus->length > EER_MODBUS_FRAME_SIZE) {
+        modbus->overruns++;
+        modbus_reset(modbus);
+        return;
+    }
+    
+    // The CRC over a frame ending with its own CRC is zero
+    if (modbus->length < MODBUS_FRAME_MIN || modbus->crc != 0) {
+        modbus->crc_errors++;
+        modbus_reset(modbus);
+        return;
+    }
+    
+    uint8_t address = modbus->frame[0];
+    if (address != modbus->address && address != 0) {
+        modbus_reset(modbus);
+        return;
+    }
+    
+    uint16_t size = modbus_process(modbus, modbus->length - 2);
+    modbus->frames++;
+    
+    if (address == 0) {
+        modbus_reset(modbus);
+        return;
+    }
+    
+    uint16_t crc = eer_crc16_modbus(EER_CRC16_MODBUS_INIT, modbus->frame, size);
+    modbus->frame[size++] = (uint8_t)crc;
+    modbus->frame[size++] = (uint8_t)(crc >> 8);
+    
+    if (modbus->de_pin != NULL) {
+        eer_hal_call(gpio, write, modbus->de_pin, true);
+    }
+    
+    modbus->state = MODBUS_SENDING;
+    modbus->response = (eer_async_request_t){
+        .bus = EER_ASYNC_UART,
+        .device = modbus->uart,
+        .tx_data = modbus->frame,
+        .tx_size = size
+    };
+    
+    if (eer_async_submit(&modbus->response) != EER_HAL_OK) {
+        if (modbus->de_pin != NULL) {
+            eer_hal_call(gpio, write, modbus->de_pin, false);
+        }
+        modbus_reset(modbus);
+    }
+}
+
+/**
+ * @brief Transmit complete callback: the response left the line
+ *
+ * The shift register also empties between bytes when the data register
+ * interrupt is late, so the line is only released once the request has
+ * queued its last byte.
+ */
+static void modbus_tx_handler(eer_uart_tx_event_t* event) {
+    eer_modbus_t* modbus = (eer_modbus_t*)event->user_data;
+    
+    if (modbus->state != MODBUS_SENDING || modbus->response.status == EER_HAL_BUSY) {
+        return;
+    }
+    
+    if (modbus->de_pin != NULL) {
+        eer_hal_call(gpio, write, modbus->de_pin, false);
+    }
+    
+    modbus_reset(modbus);
+}
+
+eer_hal_status_t eer_modbus_init(eer_modbus_t* modbus, eer_uart_config_t* config) {
+    if (modbus == NULL || config == NULL || config->baudrate == 0
+        || modbus->uart == NULL || modbus->timer == NULL
+        || modbus->address == 0 || modbus->address > 247) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_timer_config_t timer_config = {
+        .frequency = EER_MODBUS_TIMER_FREQUENCY,
+        .mode = EER_TIMER_MODE_CONTINUOUS,
+        .period = 0
+    };
+    
+    eer_hal_status_t status = eer_hal_call(timer_instance, init, modbus->timer, &timer_config);
+    if (status != EER_HAL_OK) {
+        return status;
+    }
+    
+    // 3.5 characters of 11 bits
+    uint32_t silence_us = config->baudrate > 19200 ? MODBUS_SILENCE_FAST_US : 38500000UL / config->baudrate;
+    uint32_t silence = eer_hal_call(timer_instance, us_to_ticks, modbus->timer, silence_us);
+    
+    // The match has to come before the counter laps the frame start
+    if (silence == 0 || silence >= 0x8000) {
+        eer_hal_call(timer_instance, deinit, modbus->timer);
+        return EER_HAL_INVALID_PARAM;
+    }
+    modbus->silence = (uint16_t)silence;
+    
+    if (modbus->de_pin != NULL) {
+        eer_gpio_config_t de_config = { .mode = EER_GPIO_MODE_OUTPUT };
+        eer_hal_call(gpio, configure, modbus->de_pin, &de_config);
+        eer_hal_call(gpio, write, modbus->de_pin, false);
+    }
+    
+    modbus_reset(modbus);
+    modbus->frames = 0;
+    modbus->crc_errors = 0;
+    modbus->overruns = 0;
+    
+    status = eer_hal_call(uart_instance, init, modbus->uart, config);
+    if (status == EER_HAL_OK) {
+        status = eer_hal_call(uart_instance, register_rx_callback, modbus->uart, modbus_rx_handler, modbus);
+    }
+    if (status == EER_HAL_OK) {
+        status = eer_hal_call(uart_instance, register_tx_callback, modbus->uart, modbus_tx_handler, modbus);
+    }
+    if (status == EER_HAL_OK) {
+        status = eer_hal_call(timer_instance, register_callback, modbus->timer,
+                              EER_TIMER_EVENT_COMPARE, 0, modbus_silence_handler, modbus);
+    }
+    if (status == EER_HAL_OK) {
+        status = eer_hal_call(timer_instance, start, modbus->timer);
+    }
+    
+    if (status != EER_HAL_OK) {
+        eer_modbus_deinit(modbus);
+    }
+    
+    return status;
+}
+
+eer_hal_status_t eer_modbus_deinit(eer_modbus_t* modbus) {
+    if (modbus == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_hal_call(timer_instance, stop, modbus->timer);
+    eer_hal_call(timer_instance, unregister_callback, modbus->timer, EER_TIMER_EVENT_COMPARE, 0);
+    eer_hal_call(timer_instance, deinit, modbus->timer);
+    
+    // Cancels a response still on its way
+    eer_hal_call(uart_instance, deinit, modbus->uart);
+    
+    if (modbus->de_pin != NULL) {
+        eer_hal_call(gpio, write, modbus->de_pin, false);
+    }
+    
+    modbus_reset(modbus);
+    
+    return EER_HAL_OK;
+}
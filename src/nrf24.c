@@ -0,0 +1,587 @@
+#include "eer_nrf24.h"
+#include "eer_spi_device.h"
+#include "event.h"
+#include <stddef.h>
+#include <string.h>
+
+// SPI commands
+#define NRF24_R_REGISTER       0x00
+#define NRF24_W_REGISTER       0x20
+#define NRF24_R_RX_PL_WID      0x60
+#define NRF24_R_RX_PAYLOAD     0x61
+#define NRF24_W_TX_PAYLOAD     0xA0
+#define NRF24_W_TX_PAYLOAD_NOACK 0xB0
+#define NRF24_FLUSH_TX         0xE1
+#define NRF24_FLUSH_RX         0xE2
+#define NRF24_NOP              0xFF
+
+// Registers
+#define NRF24_CONFIG      0x00
+#define NRF24_EN_AA       0x01
+#define NRF24_EN_RXADDR   0x02
+#define NRF24_SETUP_AW    0x03
+#define NRF24_SETUP_RETR  0x04
+#define NRF24_RF_CH       0x05
+#define NRF24_RF_SETUP    0x06
+#define NRF24_STATUS      0x07
+#define NRF24_RX_ADDR_P0  0x0A
+#define NRF24_RX_ADDR_P1  0x0B
+#define NRF24_RX_ADDR_P2  0x0C
+#define NRF24_TX_ADDR     0x10
+#define NRF24_FIFO_STATUS 0x17
+#define NRF24_DYNPD       0x1C
+#define NRF24_FEATURE     0x1D
+
+// CONFIG bits
+#define NRF24_EN_CRC  0x08
+#define NRF24_CRCO    0x04
+#define NRF24_PWR_UP  0x02
+#define NRF24_PRIM_RX 0x01
+
+// STATUS bits
+#define NRF24_RX_DR   0x40
+#define NRF24_TX_DS   0x20
+#define NRF24_MAX_RT  0x10
+#define NRF24_INTERRUPTS (NRF24_RX_DR | NRF24_TX_DS | NRF24_MAX_RT)
+#define NRF24_RX_P_NO(status) (((status) >> 1) & 0x07)
+#define NRF24_RX_EMPTY 7
+
+// FIFO_STATUS bits
+#define NRF24_FIFO_TX_FULL  0x20
+#define NRF24_FIFO_TX_EMPTY 0x10
+
+// FEATURE bits
+#define NRF24_EN_DPL     0x04
+#define NRF24_EN_ACK_PAY 0x02
+#define NRF24_EN_DYN_ACK 0x01
+
+// Start-up from power-down with a crystal, 1.5 ms
+#define NRF24_STARTUP_MS 2
+
+#define NRF24_RX_MASK (EER_NRF24_RX_QUEUE_SIZE - 1)
+#define NRF24_TX_MASK (EER_NRF24_TX_QUEUE_SIZE - 1)
+
+// Steps of the interrupt chain
+enum {
+    NRF24_STEP_STATUS,    /* NOP for STATUS */
+    NRF24_STEP_CLEAR,     /* Interrupt flags written back */
+    NRF24_STEP_FLUSH_TX,  /* Transmit FIFO dropped after MAX_RT */
+    NRF24_STEP_WIDTH,     /* Width of the next payload, or an empty FIFO */
+    NRF24_STEP_PAYLOAD,   /* Payload read */
+    NRF24_STEP_FLUSH_RX,  /* Corrupt payload dropped */
+    NRF24_STEP_CONFIG,    /* Switch between RX and TX mode */
+    NRF24_STEP_FIFO,      /* FIFO_STATUS before loading */
+    NRF24_STEP_LOAD       /* Payload loaded into the transmit FIFO */
+};
+
+static void nrf24_write(eer_nrf24_t* radio, uint8_t reg, const uint8_t* data, uint8_t size) {
+    uint8_t command = NRF24_W_REGISTER | reg;
+    
+    // One assertion for the command and every byte of the register
+    eer_spi_device_select(&radio->device);
+    eer_hal_call(spi, transfer, &command, NULL, 1, 0);
+    eer_hal_call(spi, transfer, data, NULL, size, 0);
+    eer_spi_device_deselect(&radio->device);
+}
+
+static void nrf24_write_register(eer_nrf24_t* radio, uint8_t reg, uint8_t value) {
+    nrf24_write(radio, reg, &value, 1);
+}
+
+static uint8_t nrf24_read_register(eer_nrf24_t* radio, uint8_t reg) {
+    uint8_t command[2] = { NRF24_R_REGISTER | reg, NRF24_NOP };
+    uint8_t response[2] = { 0 };
+    
+    eer_spi_device_select(&radio->device);
+    eer_hal_call(spi, transfer, command, response, sizeof(command), 0);
+    eer_spi_device_deselect(&radio->device);
+    
+    return response[1];
+}
+
+static void nrf24_command(eer_nrf24_t* radio, uint8_t command) {
+    eer_spi_device_select(&radio->device);
+    eer_hal_call(spi, transfer, &command, NULL, 1, 0);
+    eer_spi_device_deselect(&radio->device);
+}
+
+/*
+ * Interrupt chain. One request runs each step in turn: STATUS and clearing
+ * its flags, draining the receive FIFO, then switching modes and feeding
+ * the transmit FIFO from the queue. The round ends once nothing is left,
+ * and starts over if the IRQ fell or a packet was queued meanwhile.
+ */
+
+static void nrf24_rx_next(eer_nrf24_t* radio, uint8_t status);
+static void nrf24_tx_next(eer_nrf24_t* radio);
+
+static void nrf24_submit(eer_nrf24_t* radio, uint8_t step, const uint8_t* tx_data, uint8_t tx_size, uint8_t rx_size) {
+    eer_async_request_t* request = &radio->request;
+    
+    radio->step = step;
+    request->tx_data = tx_data;
+    request->tx_size = tx_size;
+    request->rx_data = rx_size > 0 ? radio->response : NULL;
+    request->rx_size = rx_size;
+    
+    if (eer_async_submit(request) != EER_HAL_OK) {
+        // The bus is stopped; the next edge or packet starts over
+        radio->servicing = false;
+    }
+}
+
+static void nrf24_start(eer_nrf24_t* radio) {
+    radio->servicing = true;
+    radio->again = false;
+    radio->command[0] = NRF24_NOP;
+    nrf24_submit(radio, NRF24_STEP_STATUS, radio->command, 1, 1);
+}
+
+static void nrf24_end(eer_nrf24_t* radio) {
+    if (radio->again) {
+        nrf24_start(radio);
+    } else {
+        radio->servicing = false;
+    }
+}
+
+/**
+ * @brief Start the chain, or have the running one take another round
+ */
+static void nrf24_kick(eer_nrf24_t* radio) {
+    eer_event_lock_t lock = eer_event_lock();
+    bool start = !radio->servicing;
+    
+    if (start) {
+        radio->servicing = true;
+    } else {
+        radio->again = true;
+    }
+    
+    eer_event_unlock(lock);
+    
+    if (start) {
+        nrf24_start(radio);
+    }
+}
+
+static void nrf24_irq_handler(eer_gpio_irq_t* irq) {
+    eer_nrf24_t* radio = irq->user_data;
+    
+    if (radio->servicing) {
+        radio->again = true;
+    } else {
+        nrf24_start(radio);
+    }
+}
+
+static void nrf24_set_config(eer_nrf24_t* radio, uint8_t value) {
+    // Modes change with CE low
+    eer_hal_call(gpio, write, radio->ce, false);
+    
+    radio->config_register = value;
+    radio->command[0] = NRF24_W_REGISTER | NRF24_CONFIG;
+    radio->command[1] = value;
+    nrf24_submit(radio, NRF24_STEP_CONFIG, radio->command, 2, 0);
+}
+
+static void nrf24_rx_next(eer_nrf24_t* radio, uint8_t status) {
+    if (NRF24_RX_P_NO(status) == NRF24_RX_EMPTY) {
+        nrf24_tx_next(radio);
+        return;
+    }
+    
+    radio->command[0] = NRF24_R_RX_PL_WID;
+    radio->command[1] = NRF24_NOP;
+    nrf24_submit(radio, NRF24_STEP_WIDTH, radio->command, 2, 2);
+}
+
+static void nrf24_tx_next(eer_nrf24_t* radio) {
+    bool sending = radio->tx_head != radio->tx_tail;
+    
+    if (sending) {
+        if (radio->config_register & NRF24_PRIM_RX) {
+            nrf24_set_config(radio, radio->config_register & ~NRF24_PRIM_RX);
+            return;
+        }
+        
+        radio->command[0] = NRF24_R_REGISTER | NRF24_FIFO_STATUS;
+        radio->command[1] = NRF24_NOP;
+        nrf24_submit(radio, NRF24_STEP_FIFO, radio->command, 2, 2);
+        return;
+    }
+    
+    uint8_t mode = radio->listening ? NRF24_PRIM_RX : 0;
+    if ((radio->config_register & NRF24_PRIM_RX) != mode) {
+        nrf24_set_config(radio, (radio->config_register & ~NRF24_PRIM_RX) | mode);
+        return;
+    }
+    
+    // Standby-I when idle, RX mode when listening
+    eer_hal_call(gpio, write, radio->ce, radio->listening);
+    nrf24_end(radio);
+}
+
+static void nrf24_receive_payload(eer_nrf24_t* radio, uint8_t pipe, uint8_t size) {
+    uint8_t head = radio->rx_head;
+    uint8_t next = (head + 1) & NRF24_RX_MASK;
+    
+    if (next == radio->rx_tail) {
+        if (radio->dropped < UINT8_MAX) {
+            radio->dropped++;
+        }
+        return;
+    }
+    
+    eer_nrf24_packet_t* packet = &radio->rx[head];
+    packet->pipe = pipe;
+    packet->size = size;
+    memcpy(packet->data, &radio->response[1], size);
+    
+    // Publish the slot only once it is complete
+    radio->rx_head = next;
+    
+    if (radio->on_receive != NULL) {
+        radio->on_receive(radio, radio->user_data);
+    }
+}
+
+static void nrf24_handler(eer_async_request_t* request, void* user_data) {
+    eer_nrf24_t* radio = user_data;
+    uint8_t status = radio->response[0];
+    
+    if (request->status != EER_HAL_OK) {
+        radio->servicing = false;
+        return;
+    }
+    
+    switch (radio->step) {
+        case NRF24_STEP_STATUS:
+            radio->flags = status & NRF24_INTERRUPTS;
+            if (radio->flags == 0) {
+                nrf24_rx_next(radio, status);
+                break;
+            }
+            
+            // Flags clear when written as ones, which releases IRQ
+            radio->command[0] = NRF24_W_REGISTER | NRF24_STATUS;
+            radio->command[1] = radio->flags;
+            nrf24_submit(radio, NRF24_STEP_CLEAR, radio->command, 2, 1);
+            break;
+            
+        case NRF24_STEP_CLEAR:
+            // Slots are released once the radio is done with their packet
+            if ((radio->flags & NRF24_TX_DS) && radio->tx_tail != radio->tx_load) {
+                radio->tx_tail = (radio->tx_tail + 1) & NRF24_TX_MASK;
+            }
+            
+            if (radio->flags & NRF24_MAX_RT) {
+                // The packet at the head stays in the FIFO and would block the
+                // rest: it is dropped with the FIFO, the rest are loaded again
+                if (radio->failures < UINT8_MAX) {
+                    radio->failures++;
+                }
+                if (radio->tx_tail != radio->tx_load) {
+                    radio->tx_tail = (radio->tx_tail + 1) & NRF24_TX_MASK;
+                }
+                radio->tx_load = radio->tx_tail;
+                radio->command[0] = NRF24_FLUSH_TX;
+                nrf24_submit(radio, NRF24_STEP_FLUSH_TX, radio->command, 1, 1);
+                break;
+            }
+            nrf24_rx_next(radio, status);
+            break;
+            
+        case NRF24_STEP_FLUSH_TX:
+            nrf24_rx_next(radio, status);
+            break;
+            
+        case NRF24_STEP_WIDTH: {
+            uint8_t width = radio->response[1];
+            
+            if (NRF24_RX_P_NO(status) == NRF24_RX_EMPTY) {
+                nrf24_tx_next(radio);
+            } else if (width == 0 || width > EER_NRF24_PAYLOAD_SIZE) {
+                radio->command[0] = NRF24_FLUSH_RX;
+                nrf24_submit(radio, NRF24_STEP_FLUSH_RX, radio->command, 1, 0);
+            } else {
+                radio->command[0] = NRF24_R_RX_PAYLOAD;
+                nrf24_submit(radio, NRF24_STEP_PAYLOAD, radio->command, 1, 1 + width);
+            }
+            break;
+        }
+        
+        case NRF24_STEP_PAYLOAD:
+            nrf24_receive_payload(radio, NRF24_RX_P_NO(status), (uint8_t)(request->rx_size - 1));
+            
+            // The status of the next command tells if more is waiting
+            radio->command[0] = NRF24_R_RX_PL_WID;
+            radio->command[1] = NRF24_NOP;
+            nrf24_submit(radio, NRF24_STEP_WIDTH, radio->command, 2, 2);
+            break;
+            
+        case NRF24_STEP_FLUSH_RX:
+        case NRF24_STEP_CONFIG:
+            nrf24_tx_next(radio);
+            break;
+            
+        case NRF24_STEP_FIFO: {
+            uint8_t fifo = radio->response[1];
+            uint8_t load = radio->tx_load;
+            
+            // One TX_DS may stand for several packets sent between two rounds
+            if (fifo & NRF24_FIFO_TX_EMPTY) {
+                radio->tx_tail = load;
+            }
+            
+            if (load != radio->tx_head && !(fifo & NRF24_FIFO_TX_FULL)) {
+                nrf24_submit(radio, NRF24_STEP_LOAD, radio->tx[load], 1 + radio->tx_size[load], 0);
+            } else if (radio->tx_tail == radio->tx_head) {
+                nrf24_tx_next(radio);
+            } else {
+                // Sent back to back while CE stays high
+                eer_hal_call(gpio, write, radio->ce, true);
+                nrf24_end(radio);
+            }
+            break;
+        }
+        
+        case NRF24_STEP_LOAD:
+            radio->tx_load = (radio->tx_load + 1) & NRF24_TX_MASK;
+            
+            radio->command[0] = NRF24_R_REGISTER | NRF24_FIFO_STATUS;
+            radio->command[1] = NRF24_NOP;
+            nrf24_submit(radio, NRF24_STEP_FIFO, radio->command, 2, 2);
+            break;
+            
+        default:
+            radio->servicing = false;
+            break;
+    }
+}
+
+eer_hal_status_t eer_nrf24_init(eer_nrf24_t* radio) {
+    if (radio == NULL || radio->ce == NULL || radio->irq == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    const eer_nrf24_config_t* config = &radio->config;
+    if (config->channel > 125 || config->retries > 15 || config->retry_delay > 15) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_hal_status_t status = eer_spi_device_init(&radio->device);
+    if (status != EER_HAL_OK) {
+        return status;
+    }
+    
+    eer_gpio_config_t output = { .mode = EER_GPIO_MODE_OUTPUT };
+    eer_hal_call(gpio, configure, radio->ce, &output);
+    eer_hal_call(gpio, write, radio->ce, false);
+    
+    radio->rx_head = 0;
+    radio->rx_tail = 0;
+    radio->tx_head = 0;
+    radio->tx_tail = 0;
+    radio->tx_load = 0;
+    radio->dropped = 0;
+    radio->failures = 0;
+    radio->servicing = false;
+    radio->again = false;
+    radio->listening = false;
+    
+    eer_async_request_t* request = &radio->request;
+    request->bus = EER_ASYNC_SPI;
+    request->flags = 0;
+    request->device = &radio->device;
+    request->handler = nrf24_handler;
+    request->user_data = radio;
+    request->next = NULL;
+    request->status = EER_HAL_OK;
+    
+    // Powered down while configuring, with a 2-byte CRC
+    radio->config_register = NRF24_EN_CRC | NRF24_CRCO;
+    nrf24_write_register(radio, NRF24_CONFIG, radio->config_register);
+    if (nrf24_read_register(radio, NRF24_CONFIG) != radio->config_register) {
+        return EER_HAL_TIMEOUT;
+    }
+    
+    nrf24_write_register(radio, NRF24_SETUP_AW, 0x03);
+    nrf24_write_register(radio, NRF24_SETUP_RETR, (uint8_t)(config->retry_delay << 4 | config->retries));
+    nrf24_write_register(radio, NRF24_RF_CH, config->channel);
+    nrf24_write_register(radio, NRF24_RF_SETUP, (uint8_t)config->rate | (uint8_t)config->power);
+    
+    // Auto-acknowledge and dynamic payloads on every pipe
+    nrf24_write_register(radio, NRF24_EN_AA, 0x3F);
+    nrf24_write_register(radio, NRF24_EN_RXADDR, (uint8_t)((config->pipes & 0x3E) | 0x01));
+    nrf24_write_register(radio, NRF24_FEATURE, NRF24_EN_DPL | NRF24_EN_ACK_PAY | NRF24_EN_DYN_ACK);
+    nrf24_write_register(radio, NRF24_DYNPD, 0x3F);
+    
+    nrf24_write(radio, NRF24_TX_ADDR, config->address, 5);
+    nrf24_write(radio, NRF24_RX_ADDR_P0, config->address, 5);
+    nrf24_write(radio, NRF24_RX_ADDR_P1, config->pipe1, 5);
+    for (uint8_t i = 0; i < 4; i++) {
+        nrf24_write_register(radio, NRF24_RX_ADDR_P2 + i, config->pipe_lsb[i]);
+    }
+    
+    nrf24_command(radio, NRF24_FLUSH_TX);
+    nrf24_command(radio, NRF24_FLUSH_RX);
+    nrf24_write_register(radio, NRF24_STATUS, NRF24_INTERRUPTS);
+    
+    radio->config_register |= NRF24_PWR_UP;
+    nrf24_write_register(radio, NRF24_CONFIG, radio->config_register);
+    eer_hal_call(system, delay_ms, NRF24_STARTUP_MS);
+    
+    eer_gpio_config_t irq_config = {
+        .mode = EER_GPIO_MODE_INPUT_PULLUP,
+        .trigger = EER_GPIO_TRIGGER_FALLING
+    };
+    
+    status = eer_hal_call(gpio, configure, radio->irq, &irq_config);
+    if (status == EER_HAL_OK) {
+        status = eer_hal_call(gpio, register_irq, radio->irq, nrf24_irq_handler, radio);
+    }
+    if (status == EER_HAL_OK) {
+        status = eer_hal_call(gpio, enable_irq, radio->irq);
+    }
+    
+    return status;
+}
+
+eer_hal_status_t eer_nrf24_deinit(eer_nrf24_t* radio) {
+    if (radio == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    radio->listening = false;
+    
+    eer_hal_status_t status = eer_nrf24_power_down(radio);
+    if (status == EER_HAL_OK) {
+        eer_hal_call(gpio, disable_irq, radio->irq);
+        eer_hal_call(gpio, unregister_irq, radio->irq);
+    }
+    
+    return status;
+}
+
+eer_hal_status_t eer_nrf24_send(eer_nrf24_t* radio, const uint8_t* data, uint8_t size, uint8_t flags) {
+    if (radio == NULL || data == NULL || size == 0 || size > EER_NRF24_PAYLOAD_SIZE) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    uint8_t head = radio->tx_head;
+    uint8_t next = (head + 1) & NRF24_TX_MASK;
+    
+    if (next == radio->tx_tail) {
+        return EER_HAL_BUSY;
+    }
+    
+    uint8_t* slot = radio->tx[head];
+    slot[0] = flags & EER_NRF24_NO_ACK ? NRF24_W_TX_PAYLOAD_NOACK : NRF24_W_TX_PAYLOAD;
+    memcpy(&slot[1], data, size);
+    radio->tx_size[head] = size;
+    
+    radio->tx_head = next;
+    nrf24_kick(radio);
+    
+    return EER_HAL_OK;
+}
+
+bool eer_nrf24_receive(eer_nrf24_t* radio, eer_nrf24_packet_t* packet) {
+    uint8_t tail = radio->rx_tail;
+    
+    if (tail == radio->rx_head) {
+        return false;
+    }
+    
+    *packet = radio->rx[tail];
+    radio->rx_tail = (tail + 1) & NRF24_RX_MASK;
+    
+    return true;
+}
+
+eer_hal_status_t eer_nrf24_listen(eer_nrf24_t* radio, bool listen) {
+    if (radio == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    radio->listening = listen;
+    nrf24_kick(radio);
+    
+    return EER_HAL_OK;
+}
+
+bool eer_nrf24_idle(eer_nrf24_t* radio) {
+    return !radio->servicing && radio->tx_head == radio->tx_tail;
+}
+
+eer_hal_status_t eer_nrf24_power_down(eer_nrf24_t* radio) {
+    if (radio == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // No chain may start during the blocking write
+    eer_hal_call(gpio, disable_irq, radio->irq);
+    
+    if (!eer_nrf24_idle(radio)) {
+        eer_hal_call(gpio, enable_irq, radio->irq);
+        return EER_HAL_BUSY;
+    }
+    
+    eer_hal_call(gpio, write, radio->ce, false);
+    radio->config_register &= ~NRF24_PWR_UP;
+    nrf24_write_register(radio, NRF24_CONFIG, radio->config_register);
+    
+    eer_hal_call(gpio, enable_irq, radio->irq);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t eer_nrf24_power_up(eer_nrf24_t* radio) {
+    if (radio == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_hal_call(gpio, disable_irq, radio->irq);
+    
+    if (radio->servicing) {
+        eer_hal_call(gpio, enable_irq, radio->irq);
+        return EER_HAL_BUSY;
+    }
+    
+    radio->config_register |= NRF24_PWR_UP;
+    nrf24_write_register(radio, NRF24_CONFIG, radio->config_register);
+    eer_hal_call(system, delay_ms, NRF24_STARTUP_MS);
+    
+    eer_hal_call(gpio, enable_irq, radio->irq);
+    
+    // Back to RX mode if listening, and on with anything queued meanwhile
+    nrf24_kick(radio);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t eer_nrf24_sleep(eer_nrf24_t* radio, eer_power_mode_t mode) {
+    if (radio == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    bool power_down = !radio->listening;
+    
+    if (power_down) {
+        eer_hal_status_t status = eer_nrf24_power_down(radio);
+        if (status != EER_HAL_OK) {
+            return status;
+        }
+    } else if (!eer_nrf24_idle(radio)) {
+        return EER_HAL_BUSY;
+    }
+    
+    eer_hal_status_t status = eer_hal_call(power, set_mode, mode);
+    
+    if (power_down) {
+        eer_nrf24_power_up(radio);
+    }
+    
+    return status;
+}
@@ -0,0 +1,662 @@
+#include "eer_onewire.h"
+#include "eer_crc.h"
+#include "event.h"
+#include <stddef.h>
+
+// Bus phases, each run by the compare match at deadline
+#define ONEWIRE_IDLE      0  /* No request; matches of the free-running counter are ignored */
+#define ONEWIRE_START     1  /* Recovery before the first slot of a request */
+#define ONEWIRE_PRESENCE  2  /* End of the reset pulse */
+#define ONEWIRE_DETECT    3  /* Presence sample */
+#define ONEWIRE_RESET_END 4  /* End of the presence window */
+#define ONEWIRE_NEXT      5  /* End of a slot, start of the next */
+#define ONEWIRE_RELEASE   6  /* End of the low time of a 1 or a read */
+#define ONEWIRE_RECOVER   7  /* End of the low time of a 0 */
+#define ONEWIRE_SAMPLE    8  /* Sample point of a read */
+#define ONEWIRE_WAIT      9  /* Step of wait_ms */
+
+// Slot kinds
+#define ONEWIRE_SLOT_NONE   0  /* No slot left in the request */
+#define ONEWIRE_SLOT_WRITE0 1
+#define ONEWIRE_SLOT_WRITE1 2
+#define ONEWIRE_SLOT_READ   3
+#define ONEWIRE_SLOT_FAIL   4  /* No device took part in a search triplet */
+
+// Intervals in timer ticks, in bus->ticks
+enum {
+    ONEWIRE_T_RESET_LOW,     /* Reset pulse */
+    ONEWIRE_T_PRESENCE,      /* Release to presence sample */
+    ONEWIRE_T_RESET_REST,    /* Presence sample to end of the window */
+    ONEWIRE_T_LOW1,          /* Low time of a 1 or a read */
+    ONEWIRE_T_REST1,         /* Rest of a 1 */
+    ONEWIRE_T_LOW0,          /* Low time of a 0 */
+    ONEWIRE_T_REST0,         /* Recovery after a 0, and before a request */
+    ONEWIRE_T_SAMPLE,        /* Release to sample point of a read */
+    ONEWIRE_T_READ_REST,     /* Sample point to end of a read */
+    ONEWIRE_T_MS,            /* One millisecond */
+    ONEWIRE_T_MARGIN         /* Edges closer than this are run at once */
+};
+
+// Longest step of a wait, well inside one lap of the 16-bit counter
+#define ONEWIRE_WAIT_STEP 0x4000
+
+static eer_onewire_search_t* onewire_search_of(eer_onewire_request_t* request) {
+    return (eer_onewire_search_t*)((uint8_t*)request - offsetof(eer_onewire_search_t, request));
+}
+
+static void onewire_low(eer_onewire_t* bus) {
+    eer_gpio_config_t config = { .mode = EER_GPIO_MODE_OUTPUT };
+    eer_hal_call(gpio, configure, bus->pin, &config);
+}
+
+static void onewire_release(eer_onewire_t* bus) {
+    eer_gpio_config_t config = { .mode = EER_GPIO_MODE_INPUT };
+    eer_hal_call(gpio, configure, bus->pin, &config);
+}
+
+static bool onewire_level(eer_onewire_t* bus) {
+    bool level = true;
+    eer_hal_call(gpio, read, bus->pin, &level);
+    return level;
+}
+
+static uint16_t onewire_now(eer_onewire_t* bus) {
+    uint32_t now = 0;
+    eer_hal_call(timer_instance, get_value, bus->timer, &now);
+    return (uint16_t)now;
+}
+
+/**
+ * @brief Begin the head request with a recovery time on the idle line
+ */
+static void onewire_start(eer_onewire_t* bus) {
+    bus->slot = ONEWIRE_SLOT_NONE;
+    bus->bit = 0;
+    bus->triplet = 0;
+    bus->last_zero = 0;
+    bus->phase = ONEWIRE_START;
+    bus->deadline = onewire_now(bus) + bus->ticks[ONEWIRE_T_REST0];
+    
+    eer_hal_call(timer_instance, set_compare, bus->timer, 0, bus->deadline);
+}
+
+/**
+ * @brief Finish a request taken off the queue and run its pipeline
+ */
+static void onewire_finish(eer_onewire_t* bus, eer_onewire_request_t* request, eer_hal_status_t status) {
+    while (request != NULL) {
+        // A failed pass leaves nothing to continue from
+        if ((request->flags & EER_ONEWIRE_SEARCH) && status != EER_HAL_OK) {
+            onewire_search_of(request)->last_discrepancy = 0;
+            onewire_search_of(request)->done = false;
+        }
+        
+        request->status = status;
+        
+        if (request->handler != NULL) {
+            request->handler(request, request->user_data);
+        }
+        
+        eer_onewire_request_t* next = request->next;
+        if (next == NULL) {
+            return;
+        }
+        
+        if (status == EER_HAL_OK) {
+            status = eer_onewire_submit(bus, next);
+            if (status == EER_HAL_OK || status == EER_HAL_BUSY) {
+                return;
+            }
+        }
+        
+        // A failed request cancels the rest of its pipeline
+        if (next->status == EER_HAL_BUSY) {
+            return;
+        }
+        request = next;
+    }
+}
+
+/**
+ * @brief Complete the running request and start the next queued one
+ */
+static void onewire_complete(eer_onewire_t* bus, eer_hal_status_t status) {
+    eer_onewire_request_t* request = bus->head;
+    
+    bus->head = request->queued;
+    if (bus->head == NULL) {
+        bus->tail = NULL;
+        bus->phase = ONEWIRE_IDLE;
+    } else {
+        onewire_start(bus);
+    }
+    
+    onewire_finish(bus, request, status);
+}
+
+/**
+ * @brief Move past the slot that just ended
+ */
+static void onewire_advance(eer_onewire_t* bus, eer_onewire_request_t* request) {
+    // A search bit takes three slots
+    if ((request->flags & EER_ONEWIRE_SEARCH) && request->index >= request->tx_size) {
+        if (++bus->triplet < 3) {
+            return;
+        }
+        bus->triplet = 0;
+    }
+    
+    if (++bus->bit == 8) {
+        bus->bit = 0;
+        request->index++;
+    }
+}
+
+/**
+ * @brief Pick the direction of a search bit and record it in the ROM code
+ */
+static uint8_t onewire_search_slot(eer_onewire_t* bus, eer_onewire_request_t* request) {
+    eer_onewire_search_t* search = onewire_search_of(request);
+    uint8_t byte = (uint8_t)(request->index - request->tx_size);
+    uint8_t mask = (uint8_t)(1 << bus->bit);
+    uint8_t number = (uint8_t)(byte * 8 + bus->bit + 1);
+    bool id = bus->sample & 1;
+    bool complement = bus->sample & 2;
+    bool direction;
+    
+    if (id && complement) {
+        return ONEWIRE_SLOT_FAIL;
+    }
+    
+    if (id != complement) {
+        // Every device left has the same bit
+        direction = id;
+    } else {
+        // Discrepancy: the path of the last pass up to its last zero, then 1 there, 0 beyond
+        if (number < search->last_discrepancy) {
+            direction = (request->rx_data[byte] & mask) != 0;
+        } else {
+            direction = number == search->last_discrepancy;
+        }
+        
+        if (!direction) {
+            bus->last_zero = number;
+        }
+    }
+    
+    if (direction) {
+        request->rx_data[byte] |= mask;
+    } else {
+        request->rx_data[byte] &= (uint8_t)~mask;
+    }
+    
+    return direction ? ONEWIRE_SLOT_WRITE1 : ONEWIRE_SLOT_WRITE0;
+}
+
+/**
+ * @brief Kind of the next slot of a request
+ */
+static uint8_t onewire_slot(eer_onewire_t* bus, eer_onewire_request_t* request) {
+    if (request->index < request->tx_size) {
+        return (request->tx_data[request->index] >> bus->bit) & 1 ? ONEWIRE_SLOT_WRITE1 : ONEWIRE_SLOT_WRITE0;
+    }
+    
+    if (request->index - request->tx_size >= request->rx_size) {
+        return ONEWIRE_SLOT_NONE;
+    }
+    
+    // Search: read the bit, read its complement, write the direction
+    if (request->flags & EER_ONEWIRE_SEARCH) {
+        if (bus->triplet == 0) {
+            bus->sample = 0;
+        }
+        if (bus->triplet == 2) {
+            return onewire_search_slot(bus, request);
+        }
+    }
+    
+    return ONEWIRE_SLOT_READ;
+}
+
+/**
+ * @brief Hold the bus for the next step of wait_ms, or complete the request
+ */
+static void onewire_wait(eer_onewire_t* bus) {
+    if (bus->wait == 0) {
+        if (bus->head->flags & EER_ONEWIRE_STRONG_PULLUP) {
+            onewire_release(bus);
+            eer_hal_call(gpio, write, bus->pin, false);
+        }
+        onewire_complete(bus, EER_HAL_OK);
+        return;
+    }
+    
+    uint16_t step = bus->wait > ONEWIRE_WAIT_STEP ? ONEWIRE_WAIT_STEP : (uint16_t)bus->wait;
+    bus->wait -= step;
+    bus->deadline += step;
+    bus->phase = ONEWIRE_WAIT;
+}
+
+/**
+ * @brief End of the bits of a request
+ */
+static void onewire_end(eer_onewire_t* bus, eer_onewire_request_t* request) {
+    if (request->flags & EER_ONEWIRE_SEARCH) {
+        eer_onewire_search_t* search = onewire_search_of(request);
+        
+        if (eer_crc8_dallas(EER_CRC8_DALLAS_INIT, request->rx_data, 8) != 0) {
+            onewire_complete(bus, EER_HAL_ERROR);
+            return;
+        }
+        
+        search->last_discrepancy = bus->last_zero;
+        search->done = bus->last_zero == 0;
+    }
+    
+    bus->wait = (uint32_t)request->wait_ms * bus->ticks[ONEWIRE_T_MS];
+    
+    // Parasite-powered devices draw their current through the driven line
+    if (bus->wait > 0 && (request->flags & EER_ONEWIRE_STRONG_PULLUP)) {
+        eer_hal_call(gpio, write, bus->pin, true);
+        onewire_low(bus);
+    }
+    
+    onewire_wait(bus);
+}
+
+/**
+ * @brief Start the next slot: pull the line low
+ */
+static void onewire_next(eer_onewire_t* bus) {
+    eer_onewire_request_t* request = bus->head;
+    
+    if (bus->slot != ONEWIRE_SLOT_NONE) {
+        onewire_advance(bus, request);
+    }
+    
+    bus->slot = onewire_slot(bus, request);
+    
+    switch (bus->slot) {
+        case ONEWIRE_SLOT_NONE:
+            onewire_end(bus, request);
+            return;
+            
+        case ONEWIRE_SLOT_FAIL:
+            onewire_complete(bus, EER_HAL_ERROR);
+            return;
+            
+        case ONEWIRE_SLOT_WRITE0:
+            onewire_low(bus);
+            bus->deadline += bus->ticks[ONEWIRE_T_LOW0];
+            bus->phase = ONEWIRE_RECOVER;
+            return;
+            
+        default:
+            onewire_low(bus);
+            bus->deadline += bus->ticks[ONEWIRE_T_LOW1];
+            bus->phase = ONEWIRE_RELEASE;
+            return;
+    }
+}
+
+/**
+ * @brief Store the level read in a read slot
+ */
+static void onewire_sample(eer_onewire_t* bus, bool level) {
+    eer_onewire_request_t* request = bus->head;
+    uint8_t byte = (uint8_t)(request->index - request->tx_size);
+    
+    if (request->flags & EER_ONEWIRE_SEARCH) {
+        bus->sample |= (uint8_t)(level << bus->triplet);
+    } else if (level) {
+        request->rx_data[byte] |= (uint8_t)(1 << bus->bit);
+    } else {
+        request->rx_data[byte] &= (uint8_t)~(1 << bus->bit);
+    }
+}
+
+/**
+ * @brief Run the phase due at deadline and schedule the next edge
+ */
+static void onewire_step(eer_onewire_t* bus) {
+    switch (bus->phase) {
+        case ONEWIRE_START:
+            if (bus->head->flags & EER_ONEWIRE_RESET) {
+                onewire_low(bus);
+                bus->deadline += bus->ticks[ONEWIRE_T_RESET_LOW];
+                bus->phase = ONEWIRE_PRESENCE;
+            } else {
+                onewire_next(bus);
+            }
+            break;
+            
+        case ONEWIRE_PRESENCE:
+            onewire_release(bus);
+            bus->deadline += bus->ticks[ONEWIRE_T_PRESENCE];
+            bus->phase = ONEWIRE_DETECT;
+            break;
+            
+        case ONEWIRE_DETECT:
+            // Devices answer the reset by holding the line low
+            bus->sample = !onewire_level(bus);
+            bus->deadline += bus->ticks[ONEWIRE_T_RESET_REST];
+            bus->phase = ONEWIRE_RESET_END;
+            break;
+            
+        case ONEWIRE_RESET_END:
+            if (!bus->sample) {
+                onewire_complete(bus, EER_HAL_ERROR);
+            } else {
+                onewire_next(bus);
+            }
+            break;
+            
+        case ONEWIRE_RELEASE:
+            onewire_release(bus);
+            if (bus->slot == ONEWIRE_SLOT_READ) {
+                bus->deadline += bus->ticks[ONEWIRE_T_SAMPLE];
+                bus->phase = ONEWIRE_SAMPLE;
+            } else {
+                bus->deadline += bus->ticks[ONEWIRE_T_REST1];
+                bus->phase = ONEWIRE_NEXT;
+            }
+            break;
+            
+        case ONEWIRE_RECOVER:
+            onewire_release(bus);
+            bus->deadline += bus->ticks[ONEWIRE_T_REST0];
+            bus->phase = ONEWIRE_NEXT;
+            break;
+            
+        case ONEWIRE_SAMPLE:
+            onewire_sample(bus, onewire_level(bus));
+            bus->deadline += bus->ticks[ONEWIRE_T_READ_REST];
+            bus->phase = ONEWIRE_NEXT;
+            break;
+            
+        case ONEWIRE_NEXT:
+            onewire_next(bus);
+            break;
+            
+        case ONEWIRE_WAIT:
+            onewire_wait(bus);
+            break;
+            
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Compare callback: run every phase that is due, then arm the next edge
+ */
+static void onewire_compare_handler(eer_timer_event_info_t* event) {
+    eer_onewire_t* bus = (eer_onewire_t*)event->user_data;
+    
+    // Laps of the idle counter, and matches of edges already run at once
+    if (bus->phase == ONEWIRE_IDLE || (int16_t)(onewire_now(bus) - bus->deadline) < 0) {
+        return;
+    }
+    
+    while (bus->phase != ONEWIRE_IDLE) {
+        onewire_step(bus);
+        
+        if (bus->phase == ONEWIRE_IDLE) {
+            return;
+        }
+        
+        eer_hal_call(timer_instance, set_compare, bus->timer, 0, bus->deadline);
+        
+        // An edge this close could be passed before the match is armed
+        if ((int16_t)(bus->deadline - onewire_now(bus)) > (int16_t)bus->ticks[ONEWIRE_T_MARGIN]) {
+            return;
+        }
+    }
+}
+
+eer_hal_status_t eer_onewire_submit(eer_onewire_t* bus, eer_onewire_request_t* request) {
+    if (bus == NULL || request == NULL
+        || (request->tx_size == 0 && request->rx_size == 0
+            && !(request->flags & EER_ONEWIRE_RESET) && request->wait_ms == 0)
+        || (request->tx_size > 0 && request->tx_data == NULL)
+        || (request->rx_size > 0 && request->rx_data == NULL)) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // A queued request must not be linked a second time
+    if (request->status == EER_HAL_BUSY) {
+        return EER_HAL_BUSY;
+    }
+    
+    // Stopped bus
+    if (bus->ticks[ONEWIRE_T_MS] == 0) {
+        return EER_HAL_ERROR;
+    }
+    
+    request->status = EER_HAL_BUSY;
+    request->queued = NULL;
+    request->index = 0;
+    
+    eer_event_lock_t lock = eer_event_lock();
+    
+    if (bus->head == NULL) {
+        bus->head = request;
+        bus->tail = request;
+        onewire_start(bus);
+    } else {
+        bus->tail->queued = request;
+        bus->tail = request;
+    }
+    
+    eer_event_unlock(lock);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t eer_onewire_init(eer_onewire_t* bus) {
+    if (bus == NULL || bus->pin == NULL || bus->timer == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_timer_config_t timer_config = {
+        .frequency = EER_ONEWIRE_TIMER_FREQUENCY,
+        .mode = EER_TIMER_MODE_CONTINUOUS,
+        .period = 0
+    };
+    
+    eer_hal_status_t status = eer_hal_call(timer_instance, init, bus->timer, &timer_config);
+    if (status != EER_HAL_OK) {
+        return status;
+    }
+    
+    static const uint16_t intervals_us[] = {
+        [ONEWIRE_T_RESET_LOW] = EER_ONEWIRE_RESET_LOW_US,
+        [ONEWIRE_T_PRESENCE] = EER_ONEWIRE_PRESENCE_US,
+        [ONEWIRE_T_RESET_REST] = EER_ONEWIRE_RESET_US - EER_ONEWIRE_RESET_LOW_US - EER_ONEWIRE_PRESENCE_US,
+        [ONEWIRE_T_LOW1] = EER_ONEWIRE_WRITE1_LOW_US,
+        [ONEWIRE_T_REST1] = EER_ONEWIRE_SLOT_US - EER_ONEWIRE_WRITE1_LOW_US,
+        [ONEWIRE_T_LOW0] = EER_ONEWIRE_WRITE0_LOW_US,
+        [ONEWIRE_T_REST0] = EER_ONEWIRE_SLOT_US - EER_ONEWIRE_WRITE0_LOW_US,
+        [ONEWIRE_T_SAMPLE] = EER_ONEWIRE_READ_SAMPLE_US - EER_ONEWIRE_WRITE1_LOW_US,
+        [ONEWIRE_T_READ_REST] = EER_ONEWIRE_SLOT_US - EER_ONEWIRE_READ_SAMPLE_US,
+        [ONEWIRE_T_MS] = 1000,
+        [ONEWIRE_T_MARGIN] = 1
+    };
+    
+    // Converted once, the compare callback only adds
+    for (uint8_t i = 0; i < sizeof(intervals_us) / sizeof(intervals_us[0]); i++) {
+        uint32_t ticks = eer_hal_call(timer_instance, us_to_ticks, bus->timer, intervals_us[i]);
+        bus->ticks[i] = ticks == 0 ? 1 : (uint16_t)ticks;
+    }
+    
+    // The reset window has to fit in half a lap of the counter
+    if (eer_hal_call(timer_instance, us_to_ticks, bus->timer, 1000) > ONEWIRE_WAIT_STEP) {
+        eer_hal_call(timer_instance, deinit, bus->timer);
+        bus->ticks[ONEWIRE_T_MS] = 0;
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // The level stays low; the line is pulled down by switching to output
+    eer_hal_call(gpio, write, bus->pin, false);
+    onewire_release(bus);
+    
+    bus->head = NULL;
+    bus->tail = NULL;
+    bus->phase = ONEWIRE_IDLE;
+    
+    status = eer_hal_call(timer_instance, register_callback, bus->timer,
+                          EER_TIMER_EVENT_COMPARE, 0, onewire_compare_handler, bus);
+    if (status == EER_HAL_OK) {
+        status = eer_hal_call(timer_instance, start, bus->timer);
+    }
+    
+    if (status != EER_HAL_OK) {
+        eer_onewire_deinit(bus);
+    }
+    
+    return status;
+}
+
+eer_hal_status_t eer_onewire_deinit(eer_onewire_t* bus) {
+    if (bus == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_hal_call(timer_instance, stop, bus->timer);
+    eer_hal_call(timer_instance, unregister_callback, bus->timer, EER_TIMER_EVENT_COMPARE, 0);
+    eer_hal_call(timer_instance, deinit, bus->timer);
+    
+    onewire_release(bus);
+    eer_hal_call(gpio, write, bus->pin, false);
+    
+    // Submits from the handlers below fail on the stopped bus
+    bus->ticks[ONEWIRE_T_MS] = 0;
+    bus->phase = ONEWIRE_IDLE;
+    
+    eer_onewire_request_t* request = bus->head;
+    bus->head = NULL;
+    bus->tail = NULL;
+    
+    while (request != NULL) {
+        eer_onewire_request_t* queued = request->queued;
+        onewire_finish(bus, request, EER_HAL_ERROR);
+        request = queued;
+    }
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t eer_onewire_search(eer_onewire_t* bus, eer_onewire_search_t* search) {
+    if (search == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    if (search->done) {
+        search->done = false;
+        search->last_discrepancy = 0;
+    }
+    
+    if (search->command == 0) {
+        search->command = EER_ONEWIRE_SEARCH_ROM;
+    }
+    
+    search->request = (eer_onewire_request_t){
+        .flags = EER_ONEWIRE_RESET | EER_ONEWIRE_SEARCH,
+        .tx_data = &search->command,
+        .tx_size = 1,
+        .rx_data = search->rom,
+        .rx_size = sizeof(search->rom),
+        .status = search->request.status,
+        .handler = search->handler,
+        .user_data = search->user_data
+    };
+    
+    return eer_onewire_submit(bus, &search->request);
+}
+
+/**
+ * @brief Read the scratchpad of the current sensor
+ */
+static eer_hal_status_t onewire_convert_read(eer_onewire_t* bus, eer_onewire_convert_t* convert) {
+    convert->command[0] = EER_ONEWIRE_MATCH_ROM;
+    for (uint8_t i = 0; i < 8; i++) {
+        convert->command[1 + i] = convert->roms[convert->sensor][i];
+    }
+    convert->command[9] = EER_DS18B20_READ_SCRATCHPAD;
+    
+    convert->request.flags = EER_ONEWIRE_RESET;
+    convert->request.tx_data = convert->command;
+    convert->request.tx_size = sizeof(convert->command);
+    convert->request.rx_data = convert->scratchpad;
+    convert->request.rx_size = sizeof(convert->scratchpad);
+    convert->request.wait_ms = 0;
+    
+    return eer_onewire_submit(bus, &convert->request);
+}
+
+/**
+ * @brief Completion of the conversion and of each scratchpad read
+ */
+static void onewire_convert_handler(eer_onewire_request_t* request, void* user_data) {
+    eer_onewire_convert_t* convert = (eer_onewire_convert_t*)user_data;
+    eer_onewire_t* bus = convert->bus;
+    bool converting = request->rx_size == 0;
+    
+    if (!converting) {
+        const uint8_t* scratchpad = convert->scratchpad;
+        bool valid = request->status == EER_HAL_OK
+            && eer_crc8_dallas(EER_CRC8_DALLAS_INIT, scratchpad, sizeof(convert->scratchpad)) == 0;
+            
+        convert->temperatures[convert->sensor++] = valid
+            ? (int16_t)((uint16_t)scratchpad[1] << 8 | scratchpad[0])
+            : EER_ONEWIRE_NO_TEMPERATURE;
+    }
+    
+    // Sensors left unread when the bus fails keep no result
+    if ((converting && request->status != EER_HAL_OK)
+        || convert->sensor >= convert->count
+        || onewire_convert_read(bus, convert) != EER_HAL_OK) {
+        while (convert->sensor < convert->count) {
+            convert->temperatures[convert->sensor++] = EER_ONEWIRE_NO_TEMPERATURE;
+        }
+        
+        convert->busy = false;
+        if (convert->handler != NULL) {
+            convert->handler(convert);
+        }
+    }
+}
+
+eer_hal_status_t eer_onewire_convert(eer_onewire_t* bus, eer_onewire_convert_t* convert) {
+    if (bus == NULL || convert == NULL || convert->roms == NULL
+        || convert->temperatures == NULL || convert->count == 0) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    if (convert->busy) {
+        return EER_HAL_BUSY;
+    }
+    
+    convert->bus = bus;
+    convert->sensor = 0;
+    convert->command[0] = EER_ONEWIRE_SKIP_ROM;
+    convert->command[1] = EER_DS18B20_CONVERT_T;
+    
+    convert->request = (eer_onewire_request_t){
+        .flags = EER_ONEWIRE_RESET | (convert->parasite ? EER_ONEWIRE_STRONG_PULLUP : 0),
+        .tx_data = convert->command,
+        .tx_size = 2,
+        .wait_ms = convert->conversion_ms != 0 ? convert->conversion_ms : EER_DS18B20_CONVERSION_MS,
+        .handler = onewire_convert_handler,
+        .user_data = convert
+    };
+    
+    convert->busy = true;
+    
+    eer_hal_status_t status = eer_onewire_submit(bus, &convert->request);
+    if (status != EER_HAL_OK) {
+        convert->busy = false;
+    }
+    
+    return status;
+}
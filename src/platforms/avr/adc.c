@@ -1,84 +1,56 @@
 #include "platforms/avr/adc.h"
 #include "macros.h"
+#include "eer_trace.h"
 #include <stddef.h>
 #include <avr/io.h>
 #include <avr/interrupt.h>
 
+// Single-ended channels of the MCU: 0-7, 0-15 with MUX5
+#if EER_AVR_ADC_MUX5
+#define ADC_CHANNEL_MASK 0x0F
+#else
+#define ADC_CHANNEL_MASK 0x07
+#endif
+
 // Array to store interrupt handlers and user data for each ADC channel
 static struct {
     eer_adc_conversion_complete_handler_t handler;
     void* user_data;
-} adc_irq_handlers[8] = {0}; // 8 ADC channels on most AVR MCUs
+} adc_irq_handlers[ADC_CHANNEL_MASK + 1] = {0};
+
+/**
+ * @brief Select a single-ended channel in the multiplexer
+ * @param channel Channel number, masked to the channels of the MCU
+ */
+static inline void adc_select(uint8_t channel) {
+    channel &= ADC_CHANNEL_MASK;
+    ADMUX = (ADMUX & 0xF8) | (channel & 0x07);
+#if EER_AVR_ADC_MUX5
+    ADCSRB = (ADCSRB & ~(1 << MUX5)) | ((channel >> 3) << MUX5);
+#endif
+}
 
-static eer_hal_status_t avr_adc_init(eer_adc_config_t* config) {
+eer_hal_status_t avr_adc_init(eer_adc_config_t* config) {
     if (config == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
     
-    // AREF = AVcc by default
-    ADMUX = (1 << REFS0);
-    
-    // Set prescaler based on config
-    uint8_t prescaler_bits = 0;
-    switch (config->prescaler) {
-        case EER_ADC_PRESCALER_2:
-            prescaler_bits = (0 << ADPS2) | (0 << ADPS1) | (1 << ADPS0);
-            break;
-        case EER_ADC_PRESCALER_4:
-            prescaler_bits = (0 << ADPS2) | (1 << ADPS1) | (0 << ADPS0);
-            break;
-        case EER_ADC_PRESCALER_8:
-            prescaler_bits = (0 << ADPS2) | (1 << ADPS1) | (1 << ADPS0);
-            break;
-        case EER_ADC_PRESCALER_16:
-            prescaler_bits = (1 << ADPS2) | (0 << ADPS1) | (0 << ADPS0);
-            break;
-        case EER_ADC_PRESCALER_32:
-            prescaler_bits = (1 << ADPS2) | (0 << ADPS1) | (1 << ADPS0);
-            break;
-        case EER_ADC_PRESCALER_64:
-            prescaler_bits = (1 << ADPS2) | (1 << ADPS1) | (0 << ADPS0);
-            break;
-        case EER_ADC_PRESCALER_128:
-        default:
-            prescaler_bits = (1 << ADPS2) | (1 << ADPS1) | (1 << ADPS0);
-            break;
-    }
-    
-    // ADC Enable and set prescaler
-    ADCSRA = (1 << ADEN) | prescaler_bits;
-    
-    // Set reference voltage
-    switch (config->reference) {
-        case EER_ADC_REF_INTERNAL:
-            // Internal 1.1V reference
-            ADMUX |= (1 << REFS1) | (1 << REFS0);
-            break;
-        case EER_ADC_REF_EXTERNAL:
-            // External AREF pin
-            ADMUX &= ~((1 << REFS1) | (1 << REFS0));
-            break;
-        case EER_ADC_REF_VCC:
-        default:
-            // AVcc with external capacitor at AREF pin
-            ADMUX = (ADMUX & ~(1 << REFS1)) | (1 << REFS0);
-            break;
-    }
-    
-    // Enable ADC interrupt if continuous mode is requested
-    if (config->mode == EER_ADC_MODE_CONTINUOUS) {
-        ADCSRA |= (1 << ADIE);
-    }
+    return avr_adc_init_registers(avr_adc_registers(config));
+}
+
+eer_hal_status_t avr_adc_init_registers(avr_adc_registers_t registers) {
+    ADMUX = registers.admux;
+    ADCSRA = registers.adcsra;
     
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_adc_deinit(void) {
+eer_hal_status_t avr_adc_deinit(void) {
     // Disable ADC and ADC interrupt
     ADCSRA &= ~((1 << ADEN) | (1 << ADIE));
     
     // Clear all handlers
-    for (int i = 0; i < 8; i++) {
+    for (int i = 0; i <= ADC_CHANNEL_MASK; i++) {
         adc_irq_handlers[i].handler = NULL;
         adc_irq_handlers[i].user_data = NULL;
     }
@@ -86,7 +58,7 @@ static eer_hal_status_t avr_adc_deinit(void) {
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_adc_start_conversion(void* channel) {
+eer_hal_status_t avr_adc_start_conversion(void* channel) {
     if (channel == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
@@ -94,8 +66,9 @@ static eer_hal_status_t avr_adc_start_conversion(void* channel) {
     eer_adc_channel_t* adc_channel = (eer_adc_channel_t*)channel;
     
     // Select the ADC channel
-    uint8_t ch = adc_channel->channel & 0x07; // Ensure channel is 0-7
-    ADMUX = (ADMUX & 0xF8) | ch;
+    adc_select(adc_channel->channel);
+    
+    eer_trace(EER_TRACE_ADC_START, adc_channel->channel & ADC_CHANNEL_MASK);
     
     // Start conversion
     ADCSRA |= (1 << ADSC);
@@ -103,14 +76,14 @@ static eer_hal_status_t avr_adc_start_conversion(void* channel) {
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_adc_stop_conversion(void) {
+eer_hal_status_t avr_adc_stop_conversion(void) {
     // Stop any ongoing conversion
     ADCSRA &= ~(1 << ADSC);
     
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_adc_is_conversion_complete(void* channel, bool* complete) {
+eer_hal_status_t avr_adc_is_conversion_complete(void* channel, bool* complete) {
     if (channel == NULL || complete == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
@@ -121,7 +94,7 @@ static eer_hal_status_t avr_adc_is_conversion_complete(void* channel, bool* comp
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_adc_read(void* channel, uint16_t* value) {
+eer_hal_status_t avr_adc_read(void* channel, uint16_t* value) {
     if (channel == NULL || value == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
@@ -130,8 +103,9 @@ static eer_hal_status_t avr_adc_read(void* channel, uint16_t* value) {
     bool conversion_complete = false;
     
     // Select the ADC channel
-    uint8_t ch = adc_channel->channel & 0x07; // Ensure channel is 0-7
-    ADMUX = (ADMUX & 0xF8) | ch;
+    adc_select(adc_channel->channel);
+    
+    eer_trace(EER_TRACE_ADC_START, adc_channel->channel & ADC_CHANNEL_MASK);
     
     // Start conversion if not already started
     if ((ADCSRA & (1 << ADSC)) == 0) {
@@ -147,7 +121,7 @@ static eer_hal_status_t avr_adc_read(void* channel, uint16_t* value) {
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_adc_read_voltage(void* channel, float* voltage) {
+eer_hal_status_t avr_adc_read_voltage(void* channel, float* voltage) {
     if (channel == NULL || voltage == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
@@ -174,15 +148,15 @@ static eer_hal_status_t avr_adc_read_voltage(void* channel, float* voltage) {
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_adc_register_callback(void* channel, 
-                                                 eer_adc_conversion_complete_handler_t handler, 
+eer_hal_status_t avr_adc_register_callback(void* channel,
+                                                 eer_adc_conversion_complete_handler_t handler,
                                                  void* user_data) {
     if (channel == NULL || handler == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
     
     eer_adc_channel_t* adc_channel = (eer_adc_channel_t*)channel;
-    uint8_t ch = adc_channel->channel & 0x07; // Ensure channel is 0-7
+    uint8_t ch = adc_channel->channel & ADC_CHANNEL_MASK;
     
     // Store the handler and user data
     adc_irq_handlers[ch].handler = handler;
@@ -194,13 +168,13 @@ static eer_hal_status_t avr_adc_register_callback(void* channel,
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_adc_unregister_callback(void* channel) {
+eer_hal_status_t avr_adc_unregister_callback(void* channel) {
     if (channel == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
     
     eer_adc_channel_t* adc_channel = (eer_adc_channel_t*)channel;
-    uint8_t ch = adc_channel->channel & 0x07; // Ensure channel is 0-7
+    uint8_t ch = adc_channel->channel & ADC_CHANNEL_MASK;
     
     // Clear the handler and user data
     adc_irq_handlers[ch].handler = NULL;
@@ -208,7 +182,7 @@ static eer_hal_status_t avr_adc_unregister_callback(void* channel) {
     
     // Check if any handlers are still registered
     bool any_handlers = false;
-    for (int i = 0; i < 8; i++) {
+    for (int i = 0; i <= ADC_CHANNEL_MASK; i++) {
         if (adc_irq_handlers[i].handler != NULL) {
             any_handlers = true;
             break;
@@ -227,6 +201,13 @@ static eer_hal_status_t avr_adc_unregister_callback(void* channel) {
 ISR(ADC_vect) {
     // Get the current channel from ADMUX
     uint8_t channel = ADMUX & 0x07;
+#if EER_AVR_ADC_MUX5
+    if (ADCSRB & (1 << MUX5)) {
+        channel |= 0x08;
+    }
+#endif
+    
+    eer_trace_isr(EER_TRACE_ADC_COMPLETE, ADC);
     
     // Call the handler if registered
     if (adc_irq_handlers[channel].handler != NULL) {
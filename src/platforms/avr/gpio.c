@@ -1,5 +1,6 @@
 #include "platforms/avr/gpio.h"
 #include "macros.h"
+#include "eer_trace.h"
 #include <stddef.h>
 #include <avr/io.h>
 #include <avr/interrupt.h>
@@ -8,19 +9,63 @@
 static struct {
     eer_gpio_irq_handler_t handler;
     void* user_data;
-} gpio_irq_handlers[24] = {0}; // Assuming max 24 pins (3 ports * 8 pins)
+    void* pin;
+    eer_gpio_trigger_t trigger;
+} gpio_irq_handlers[EER_AVR_PCINT_GROUPS * 8] = {0};
 
-static eer_hal_status_t avr_gpio_init(void) {
+// Input and pin change mask registers of each pin change group mapped to a
+// port by the MCU descriptor
+#define GPIO_GROUP(n) [n] = { &EER_AVR_PCINT##n##_PIN, &PCMSK##n }
+
+static const struct {
+    volatile uint8_t* pin;
+    volatile uint8_t* pcmsk;
+} gpio_groups[EER_AVR_PCINT_GROUPS] = {
+#ifdef EER_AVR_PCINT0_PIN
+    GPIO_GROUP(0),
+#endif
+#ifdef EER_AVR_PCINT1_PIN
+    GPIO_GROUP(1),
+#endif
+#ifdef EER_AVR_PCINT2_PIN
+    GPIO_GROUP(2),
+#endif
+#ifdef EER_AVR_PCINT3_PIN
+    GPIO_GROUP(3),
+#endif
+};
+
+// Last sampled input state of each group, used to detect edges
+static volatile uint8_t gpio_pcint_state[EER_AVR_PCINT_GROUPS] = {0};
+
+#define GPIO_PORT_NONE 0xFF
+
+/**
+ * @brief Map a pin to its pin change interrupt group
+ * @param avr_pin Pin structure
+ * @return Group index (PCINTn) or GPIO_PORT_NONE
+ */
+static uint8_t gpio_port_index(eer_pin_t *avr_pin) {
+    for (uint8_t group = 0; group < EER_AVR_PCINT_GROUPS; group++) {
+        if (gpio_groups[group].pin != NULL && avr_pin->port.pin == gpio_groups[group].pin) {
+            return group;
+        }
+    }
+    
+    return GPIO_PORT_NONE;
+}
+
+eer_hal_status_t avr_gpio_init(void) {
     // AVR doesn't need special initialization for GPIO
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_gpio_deinit(void) {
+eer_hal_status_t avr_gpio_deinit(void) {
     // Nothing to deinitialize
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_gpio_configure(void *pin, eer_gpio_config_t* config) {
+eer_hal_status_t avr_gpio_configure(void *pin, eer_gpio_config_t* config) {
     if (pin == NULL || config == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
@@ -50,20 +95,20 @@ static eer_hal_status_t avr_gpio_configure(void *pin, eer_gpio_config_t* config)
             return EER_HAL_NOT_SUPPORTED;
     }
     
-    // Configure pin for interrupt if requested
+    // Remember the trigger for the pin change interrupt
     if (config->trigger != EER_GPIO_TRIGGER_NONE) {
-        // Note: This is a simplified implementation that assumes
-        // the pin is on PORTD and can use PCINT or INT interrupts
-        // A complete implementation would need to handle all ports
+        uint8_t port = gpio_port_index(avr_pin);
+        if (port == GPIO_PORT_NONE) {
+            return EER_HAL_NOT_SUPPORTED;
+        }
         
-        // For now, return not supported
-        return EER_HAL_NOT_SUPPORTED;
+        gpio_irq_handlers[port * 8 + avr_pin->number].trigger = config->trigger;
     }
     
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_gpio_write(void *pin, bool state) {
+eer_hal_status_t avr_gpio_write(void *pin, bool state) {
     if (pin == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
@@ -79,7 +124,7 @@ static eer_hal_status_t avr_gpio_write(void *pin, bool state) {
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_gpio_read(void *pin, bool *state) {
+eer_hal_status_t avr_gpio_read(void *pin, bool *state) {
     if (pin == NULL || state == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
@@ -91,7 +136,7 @@ static eer_hal_status_t avr_gpio_read(void *pin, bool *state) {
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_gpio_toggle(void *pin) {
+eer_hal_status_t avr_gpio_toggle(void *pin) {
     if (pin == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
@@ -103,31 +148,173 @@ static eer_hal_status_t avr_gpio_toggle(void *pin) {
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_gpio_register_irq(void *pin, 
+eer_hal_status_t avr_gpio_register_irq(void *pin, 
                                              eer_gpio_irq_handler_t handler, 
                                              void* user_data) {
-    // This is a simplified implementation
-    // A complete implementation would need to configure the appropriate
-    // interrupt registers based on the pin
+    if (pin == NULL || handler == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_pin_t *avr_pin = (eer_pin_t *)pin;
+    uint8_t port = gpio_port_index(avr_pin);
+    if (port == GPIO_PORT_NONE) {
+        return EER_HAL_NOT_SUPPORTED;
+    }
+    
+    uint8_t index = port * 8 + avr_pin->number;
+    
+    // Update the entry with the pin change interrupt masked
+    uint8_t sreg = SREG;
+    cli();
+    gpio_irq_handlers[index].handler = handler;
+    gpio_irq_handlers[index].user_data = user_data;
+    gpio_irq_handlers[index].pin = pin;
+    if (gpio_irq_handlers[index].trigger == EER_GPIO_TRIGGER_NONE) {
+        gpio_irq_handlers[index].trigger = EER_GPIO_TRIGGER_BOTH;
+    }
+    SREG = sreg;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t avr_gpio_disable_irq(void *pin);
+
+eer_hal_status_t avr_gpio_unregister_irq(void *pin) {
+    if (pin == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_pin_t *avr_pin = (eer_pin_t *)pin;
+    uint8_t port = gpio_port_index(avr_pin);
+    if (port == GPIO_PORT_NONE) {
+        return EER_HAL_NOT_SUPPORTED;
+    }
+    
+    avr_gpio_disable_irq(pin);
+    
+    uint8_t index = port * 8 + avr_pin->number;
+    gpio_irq_handlers[index].handler = NULL;
+    gpio_irq_handlers[index].user_data = NULL;
+    gpio_irq_handlers[index].pin = NULL;
+    
+    // A later registration falls back to both edges unless reconfigured
+    gpio_irq_handlers[index].trigger = EER_GPIO_TRIGGER_NONE;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t avr_gpio_enable_irq(void *pin) {
+    if (pin == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_pin_t *avr_pin = (eer_pin_t *)pin;
+    uint8_t port = gpio_port_index(avr_pin);
+    if (port == GPIO_PORT_NONE) {
+        return EER_HAL_NOT_SUPPORTED;
+    }
+    
+    uint8_t sreg = SREG;
+    cli();
+    
+    // Start edge detection from the current level of the port
+    gpio_pcint_state[port] = *(avr_pin->port.pin);
+    
+    // Unmask the pin and enable the port's pin change interrupt
+    bit_set(*gpio_groups[port].pcmsk, avr_pin->number);
+    PCIFR = (1 << port);
+    bit_set(PCICR, port);
     
-    // For now, return not supported
-    return EER_HAL_NOT_SUPPORTED;
+    SREG = sreg;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t avr_gpio_disable_irq(void *pin) {
+    if (pin == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_pin_t *avr_pin = (eer_pin_t *)pin;
+    uint8_t port = gpio_port_index(avr_pin);
+    if (port == GPIO_PORT_NONE) {
+        return EER_HAL_NOT_SUPPORTED;
+    }
+    
+    uint8_t sreg = SREG;
+    cli();
+    
+    bit_clear(*gpio_groups[port].pcmsk, avr_pin->number);
+    
+    // Turn the port interrupt off when no pin is left unmasked
+    if (*gpio_groups[port].pcmsk == 0) {
+        bit_clear(PCICR, port);
+    }
+    
+    SREG = sreg;
+    
+    return EER_HAL_OK;
+}
+
+/**
+ * @brief Dispatch a pin change interrupt to the registered pin handlers
+ * @param port Group index (PCINTn)
+ * @param state Current input state of the port
+ */
+static void gpio_pcint_dispatch(uint8_t port, uint8_t state) {
+    uint8_t changed = (state ^ gpio_pcint_state[port]) & *gpio_groups[port].pcmsk;
+    gpio_pcint_state[port] = state;
+    
+    eer_trace_isr(EER_TRACE_GPIO_IRQ, (uint16_t)port << 8 | changed);
+    
+    for (uint8_t number = 0; changed != 0; number++, changed >>= 1) {
+        if (!(changed & 0x01)) {
+            continue;
+        }
+        
+        uint8_t index = port * 8 + number;
+        bool rising = bit_get(state, number);
+        eer_gpio_trigger_t trigger = gpio_irq_handlers[index].trigger;
+        
+        if (gpio_irq_handlers[index].handler == NULL
+            || (trigger == EER_GPIO_TRIGGER_RISING && !rising)
+            || (trigger == EER_GPIO_TRIGGER_FALLING && rising)) {
+            continue;
+        }
+        
+        eer_gpio_irq_t irq = {
+            .pin = gpio_irq_handlers[index].pin,
+            .user_data = gpio_irq_handlers[index].user_data
+        };
+        
+        gpio_irq_handlers[index].handler(&irq);
+    }
+}
+
+// Pin Change Interrupt ISRs - one per mapped group
+#ifdef EER_AVR_PCINT0_PIN
+ISR(PCINT0_vect) {
+    gpio_pcint_dispatch(0, EER_AVR_PCINT0_PIN);
 }
+#endif
 
-static eer_hal_status_t avr_gpio_unregister_irq(void *pin) {
-    // For now, return not supported
-    return EER_HAL_NOT_SUPPORTED;
+#ifdef EER_AVR_PCINT1_PIN
+ISR(PCINT1_vect) {
+    gpio_pcint_dispatch(1, EER_AVR_PCINT1_PIN);
 }
+#endif
 
-static eer_hal_status_t avr_gpio_enable_irq(void *pin) {
-    // For now, return not supported
-    return EER_HAL_NOT_SUPPORTED;
+#ifdef EER_AVR_PCINT2_PIN
+ISR(PCINT2_vect) {
+    gpio_pcint_dispatch(2, EER_AVR_PCINT2_PIN);
 }
+#endif
 
-static eer_hal_status_t avr_gpio_disable_irq(void *pin) {
-    // For now, return not supported
-    return EER_HAL_NOT_SUPPORTED;
+#ifdef EER_AVR_PCINT3_PIN
+ISR(PCINT3_vect) {
+    gpio_pcint_dispatch(3, EER_AVR_PCINT3_PIN);
 }
+#endif
 
 // GPIO handler structure with function pointers
 eer_gpio_handler_t eer_avr_gpio = {
@@ -8,6 +8,7 @@
 #include "platforms/avr/timer.h"
 #include "platforms/avr/system.h"
 #include "platforms/avr/power.h"
+#include "platforms/avr/nvs.h"
 
 // Global HAL instance for AVR platform
 // Using __attribute__((used)) to prevent the linker from optimizing it out
@@ -19,5 +20,12 @@ eer_hal_t eer_hal __attribute__((used)) = {
     .i2c = &eer_avr_i2c,
     .timer = &eer_avr_timer,
     .system = &eer_avr_system,
-    .power = &eer_avr_power
+    .power = &eer_avr_power,
+#ifdef EER_AVR_NVS_FLASH
+    .nvs = &eer_avr_flash_nvs,
+#else
+    .nvs = &eer_avr_nvs,
+#endif
+    .uart_instance = &eer_avr_uart_instance,
+    .timer_instance = &eer_avr_timer_instance
 };
@@ -1,5 +1,7 @@
 #include "platforms/avr/i2c.h"
+#include "platforms/avr/progmem.h"
 #include "macros.h"
+#include "eer_trace.h"
 #include <stddef.h>
 #include <avr/io.h>
 #include <avr/interrupt.h>
@@ -17,6 +19,9 @@ static struct {
 // Current I2C configuration
 static eer_i2c_config_t current_config = {0};
 
+// Asynchronous requests, run by the TWI interrupt
+static eer_async_queue_t i2c_async = {0};
+
 // I2C status codes
 #define I2C_START_TRANSMITTED      0x08
 #define I2C_RESTART_TRANSMITTED    0x10
@@ -31,29 +36,13 @@ static eer_i2c_config_t current_config = {0};
 #define I2C_DATA_RECEIVED_NACK     0x58
 
 /**
- * @brief Calculate TWBR value for the given SCL frequency
- * @param scl_freq SCL frequency in Hz
- * @param prescaler TWI prescaler value (0-3)
- * @return TWBR value
+ * @brief Fail a bus operation that ended in an unexpected status
+ * @return EER_HAL_ERROR
  */
-static uint8_t i2c_calculate_twbr(uint32_t scl_freq, uint8_t prescaler) {
-    uint8_t twps;
-    uint32_t prescaler_value;
-    
-    switch (prescaler) {
-        case 0: prescaler_value = 1; twps = 0; break;
-        case 1: prescaler_value = 4; twps = 1; break;
-        case 2: prescaler_value = 16; twps = 2; break;
-        case 3: prescaler_value = 64; twps = 3; break;
-        default: prescaler_value = 1; twps = 0; break;
-    }
+static eer_hal_status_t i2c_error(void) {
+    eer_trace(EER_TRACE_I2C_ERROR, *i2c0.twsr & 0xF8);
     
-    uint8_t twbr = ((F_CPU / scl_freq) - 16) / (2 * prescaler_value);
-    
-    // Set prescaler bits in TWSR
-    *i2c0.twsr = (*i2c0.twsr & 0xFC) | twps;
-    
-    return twbr;
+    return EER_HAL_ERROR;
 }
 
 /**
@@ -94,7 +83,7 @@ static eer_hal_status_t i2c_start(uint32_t timeout) {
     
     // Check if START was sent successfully
     if ((*i2c0.twsr & 0xF8) != I2C_START_TRANSMITTED) {
-        return EER_HAL_ERROR;
+        return i2c_error();
     }
     
     return EER_HAL_OK;
@@ -117,7 +106,7 @@ static eer_hal_status_t i2c_restart(uint32_t timeout) {
     
     // Check if RESTART was sent successfully
     if ((*i2c0.twsr & 0xF8) != I2C_RESTART_TRANSMITTED) {
-        return EER_HAL_ERROR;
+        return i2c_error();
     }
     
     return EER_HAL_OK;
@@ -166,11 +155,11 @@ static eer_hal_status_t i2c_send_address(uint16_t address, bool read, uint32_t t
     uint8_t twsr = *i2c0.twsr & 0xF8;
     if (read) {
         if (twsr != I2C_SLA_R_ACK) {
-            return EER_HAL_ERROR;
+            return i2c_error();
         }
     } else {
         if (twsr != I2C_SLA_W_ACK) {
-            return EER_HAL_ERROR;
+            return i2c_error();
         }
     }
     
@@ -198,7 +187,7 @@ static eer_hal_status_t i2c_send_data(uint8_t data, uint32_t timeout) {
     
     // Check if data was sent successfully
     if ((*i2c0.twsr & 0xF8) != I2C_DATA_TRANSMITTED_ACK) {
-        return EER_HAL_ERROR;
+        return i2c_error();
     }
     
     return EER_HAL_OK;
@@ -233,11 +222,11 @@ static eer_hal_status_t i2c_receive_data(uint8_t* data, bool send_ack, uint32_t
     uint8_t twsr = *i2c0.twsr & 0xF8;
     if (send_ack) {
         if (twsr != I2C_DATA_RECEIVED_ACK) {
-            return EER_HAL_ERROR;
+            return i2c_error();
         }
     } else {
         if (twsr != I2C_DATA_RECEIVED_NACK) {
-            return EER_HAL_ERROR;
+            return i2c_error();
         }
     }
     
@@ -247,38 +236,25 @@ static eer_hal_status_t i2c_receive_data(uint8_t* data, bool send_ack, uint32_t
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_i2c_init(eer_i2c_config_t* config) {
+eer_hal_status_t avr_i2c_init(eer_i2c_config_t* config) {
     if (config == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
     
-    // Store the configuration
-    current_config = *config;
-    
-    // Calculate bit rate based on desired speed
-    uint32_t scl_freq;
-    switch (config->speed) {
-        case EER_I2C_SPEED_STANDARD:
-            scl_freq = 100000; // 100 kHz
-            break;
-        case EER_I2C_SPEED_FAST:
-            scl_freq = 400000; // 400 kHz
-            break;
-        case EER_I2C_SPEED_FAST_PLUS:
-            scl_freq = 1000000; // 1 MHz
-            break;
-        default:
-            scl_freq = 100000; // Default to 100 kHz
-            break;
+    return avr_i2c_init_registers(config, avr_i2c_registers(config));
+}
+
+eer_hal_status_t avr_i2c_init_registers(const eer_i2c_config_t* config, avr_i2c_registers_t registers) {
+    if (config == NULL) {
+        return EER_HAL_INVALID_PARAM;
     }
     
-    // Override with explicit clock frequency if provided
-    if (config->clock_hz > 0) {
-        scl_freq = config->clock_hz;
-    }
+    // Store the configuration
+    current_config = *config;
     
-    // Set bit rate (use prescaler 0 for now)
-    *i2c0.twbr = i2c_calculate_twbr(scl_freq, 0);
+    // Set bit rate and prescaler
+    *i2c0.twsr = (*i2c0.twsr & 0xFC) | registers.twps;
+    *i2c0.twbr = registers.twbr;
     
     // Enable TWI
     *i2c0.twcr = (1 << TWEN);
@@ -286,10 +262,12 @@ static eer_hal_status_t avr_i2c_init(eer_i2c_config_t* config) {
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_i2c_deinit(void) {
+eer_hal_status_t avr_i2c_deinit(void) {
     // Disable TWI
     *i2c0.twcr = 0;
     
+    eer_async_cancel(&i2c_async, EER_HAL_ERROR);
+    
     // Clear callback handler
     i2c_callback.handler = NULL;
     i2c_callback.user_data = NULL;
@@ -297,11 +275,17 @@ static eer_hal_status_t avr_i2c_deinit(void) {
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_i2c_master_transmit(uint16_t address, const uint8_t* data, uint16_t size, uint32_t timeout) {
+eer_hal_status_t avr_i2c_master_transmit(uint16_t address, const uint8_t* data, uint16_t size, uint32_t timeout) {
     if (data == NULL || size == 0) {
         return EER_HAL_INVALID_PARAM;
     }
     
+    if (i2c_async.head != NULL) {
+        return EER_HAL_BUSY;
+    }
+    
+    eer_trace(EER_TRACE_I2C_TRANSMIT, address);
+    
     // Send START condition
     eer_hal_status_t status = i2c_start(timeout);
     if (status != EER_HAL_OK) {
@@ -345,11 +329,17 @@ static eer_hal_status_t avr_i2c_master_transmit(uint16_t address, const uint8_t*
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_i2c_master_receive(uint16_t address, uint8_t* data, uint16_t size, uint32_t timeout) {
+eer_hal_status_t avr_i2c_master_receive(uint16_t address, uint8_t* data, uint16_t size, uint32_t timeout) {
     if (data == NULL || size == 0) {
         return EER_HAL_INVALID_PARAM;
     }
     
+    if (i2c_async.head != NULL) {
+        return EER_HAL_BUSY;
+    }
+    
+    eer_trace(EER_TRACE_I2C_RECEIVE, address);
+    
     // Send START condition
     eer_hal_status_t status = i2c_start(timeout);
     if (status != EER_HAL_OK) {
@@ -396,7 +386,7 @@ static eer_hal_status_t avr_i2c_master_receive(uint16_t address, uint8_t* data,
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_i2c_master_transmit_receive(uint16_t address, 
+eer_hal_status_t avr_i2c_master_transmit_receive(uint16_t address,
                                                       const uint8_t* tx_data, uint16_t tx_size,
                                                       uint8_t* rx_data, uint16_t rx_size,
                                                       uint32_t timeout) {
@@ -404,6 +394,12 @@ static eer_hal_status_t avr_i2c_master_transmit_receive(uint16_t address,
         return EER_HAL_INVALID_PARAM;
     }
     
+    if (i2c_async.head != NULL) {
+        return EER_HAL_BUSY;
+    }
+    
+    eer_trace(EER_TRACE_I2C_TRANSMIT, address);
+    
     // Send START condition
     eer_hal_status_t status = i2c_start(timeout);
     if (status != EER_HAL_OK) {
@@ -428,6 +424,7 @@ static eer_hal_status_t avr_i2c_master_transmit_receive(uint16_t address,
     }
     
     // Send RESTART condition
+    eer_trace(EER_TRACE_I2C_RECEIVE, address);
     status = i2c_restart(timeout);
     if (status != EER_HAL_OK) {
         i2c_stop();
@@ -473,7 +470,7 @@ static eer_hal_status_t avr_i2c_master_transmit_receive(uint16_t address,
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_i2c_is_busy(bool* busy) {
+eer_hal_status_t avr_i2c_is_busy(bool* busy) {
     if (busy == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
@@ -484,11 +481,15 @@ static eer_hal_status_t avr_i2c_is_busy(bool* busy) {
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_i2c_scan(uint16_t* devices, uint8_t max_devices, uint8_t* found_devices) {
+eer_hal_status_t avr_i2c_scan(uint16_t* devices, uint8_t max_devices, uint8_t* found_devices) {
     if (devices == NULL || found_devices == NULL || max_devices == 0) {
         return EER_HAL_INVALID_PARAM;
     }
     
+    if (i2c_async.head != NULL) {
+        return EER_HAL_BUSY;
+    }
+    
     uint8_t count = 0;
     
     // Scan all possible 7-bit addresses (0-127)
@@ -530,7 +531,7 @@ static eer_hal_status_t avr_i2c_scan(uint16_t* devices, uint8_t max_devices, uin
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_i2c_register_callback(eer_i2c_transfer_handler_t handler, void* user_data) {
+eer_hal_status_t avr_i2c_register_callback(eer_i2c_transfer_handler_t handler, void* user_data) {
     if (handler == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
@@ -542,7 +543,7 @@ static eer_hal_status_t avr_i2c_register_callback(eer_i2c_transfer_handler_t han
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_i2c_unregister_callback(void) {
+eer_hal_status_t avr_i2c_unregister_callback(void) {
     // Clear the handler and user data
     i2c_callback.handler = NULL;
     i2c_callback.user_data = NULL;
@@ -550,6 +551,124 @@ static eer_hal_status_t avr_i2c_unregister_callback(void) {
     return EER_HAL_OK;
 }
 
+/**
+ * @brief Start the request at the head of the queue with a START condition
+ *
+ * Called with interrupts disabled, from submit or from the interrupt that
+ * finished the previous request.
+ */
+static void i2c_async_start(void) {
+    if (i2c_async.head == NULL) {
+        return;
+    }
+    
+    // The STOP of the previous transfer has to be out first
+    while (*i2c0.twcr & (1 << TWSTO));
+    
+    *i2c0.twcr = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN) | (1 << TWIE);
+}
+
+/**
+ * @brief End the running request with a STOP and start the next one
+ */
+static void i2c_async_finish(eer_hal_status_t status) {
+    eer_async_request_t* request = i2c_async.head;
+    
+    if (status != EER_HAL_OK) {
+        i2c_error();
+    }
+    
+    *i2c0.twcr = (1 << TWINT) | (1 << TWSTO) | (1 << TWEN);
+    
+    eer_async_dequeue(&i2c_async);
+    i2c_async_start();
+    eer_async_complete(request, status);
+}
+
+/**
+ * @brief Acknowledge all but the last byte of the read part
+ */
+static void i2c_async_receive_next(const eer_async_request_t* request) {
+    if (request->index + 1 < request->tx_size + request->rx_size) {
+        *i2c0.twcr = (1 << TWINT) | (1 << TWEN) | (1 << TWIE) | (1 << TWEA);
+    } else {
+        *i2c0.twcr = (1 << TWINT) | (1 << TWEN) | (1 << TWIE);
+    }
+}
+
+eer_hal_status_t avr_i2c_submit(eer_async_request_t* request) {
+    // For now, only support 7-bit addressing
+    if (current_config.addr_mode == EER_I2C_ADDR_10BIT) {
+        return EER_HAL_NOT_SUPPORTED;
+    }
+    
+    eer_hal_status_t status = eer_async_prepare(request);
+    if (status != EER_HAL_OK) {
+        return status;
+    }
+    
+    eer_trace(request->tx_size > 0 ? EER_TRACE_I2C_TRANSMIT : EER_TRACE_I2C_RECEIVE, request->address);
+    
+    uint8_t sreg = SREG;
+    cli();
+    if (eer_async_enqueue(&i2c_async, request)) {
+        i2c_async_start();
+    }
+    SREG = sreg;
+    
+    return EER_HAL_OK;
+}
+
+// TWI ISR, steps the running request through the bus states
+ISR(TWI_vect) {
+    eer_async_request_t* request = i2c_async.head;
+    
+    if (request == NULL) {
+        *i2c0.twcr = (1 << TWEN);
+        return;
+    }
+    
+    switch (*i2c0.twsr & 0xF8) {
+        case I2C_START_TRANSMITTED:
+        case I2C_RESTART_TRANSMITTED:
+            // Write part first, reading once all bytes are written
+            *i2c0.twdr = (request->address << 1) | (request->index >= request->tx_size ? 1 : 0);
+            *i2c0.twcr = (1 << TWINT) | (1 << TWEN) | (1 << TWIE);
+            break;
+            
+        case I2C_SLA_W_ACK:
+        case I2C_DATA_TRANSMITTED_ACK:
+            if (request->index < request->tx_size) {
+                *i2c0.twdr = avr_async_tx_byte(request, request->index++);
+                *i2c0.twcr = (1 << TWINT) | (1 << TWEN) | (1 << TWIE);
+            } else if (request->rx_size > 0) {
+                *i2c0.twcr = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN) | (1 << TWIE);
+            } else {
+                i2c_async_finish(EER_HAL_OK);
+            }
+            break;
+            
+        case I2C_SLA_R_ACK:
+            i2c_async_receive_next(request);
+            break;
+            
+        case I2C_DATA_RECEIVED_ACK:
+            request->rx_data[request->index++ - request->tx_size] = *i2c0.twdr;
+            i2c_async_receive_next(request);
+            break;
+            
+        case I2C_DATA_RECEIVED_NACK:
+            request->rx_data[request->index++ - request->tx_size] = *i2c0.twdr;
+            i2c_async_finish(EER_HAL_OK);
+            break;
+            
+        default:
+            // Address or data not acknowledged, or arbitration lost
+            i2c_async_finish(EER_HAL_ERROR);
+            break;
+    }
+}
+
 // I2C handler structure with function pointers
 eer_i2c_handler_t eer_avr_i2c = {
     .init = avr_i2c_init,
@@ -560,5 +679,6 @@ eer_i2c_handler_t eer_avr_i2c = {
     .is_busy = avr_i2c_is_busy,
     .scan = avr_i2c_scan,
     .register_callback = avr_i2c_register_callback,
-    .unregister_callback = avr_i2c_unregister_callback
+    .unregister_callback = avr_i2c_unregister_callback,
+    .submit = avr_i2c_submit
 };
@@ -0,0 +1,335 @@
+#include "platforms/avr/nvs.h"
+#include "platforms/avr/system.h"
+#include "macros.h"
+#include "eer_trace.h"
+#include <stddef.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#if (EER_AVR_NVS_QUEUE_SIZE & (EER_AVR_NVS_QUEUE_SIZE - 1)) != 0
+#error "EER_AVR_NVS_QUEUE_SIZE must be a power of two"
+#endif
+
+#define NVS_QUEUE_MASK (EER_AVR_NVS_QUEUE_SIZE - 1)
+#define NVS_SIZE       ((uint32_t)E2END + 1)
+
+// EEPROM programming modes (EEPM1:0)
+#define NVS_MODE_ERASE_WRITE 0
+#define NVS_MODE_ERASE       (1 << EEPM0)
+#define NVS_MODE_WRITE       (1 << EEPM1)
+
+// Bytes waiting to be programmed by the EE_READY interrupt.
+// The API only advances the head, the interrupt only advances the tail.
+static struct {
+    uint16_t address;
+    uint8_t data;
+} nvs_queue[EER_AVR_NVS_QUEUE_SIZE];
+static volatile uint8_t nvs_head = 0;
+static volatile uint8_t nvs_tail = 0;
+
+// Callback handler and user data
+static struct {
+    eer_nvs_write_handler_t handler;
+    void* user_data;
+} nvs_callback = {0};
+
+/**
+ * @brief Read one byte from the EEPROM array
+ * @param address EEPROM address
+ * @return Stored byte
+ * @note EEPE must be clear and interrupts disabled
+ */
+static uint8_t nvs_read_byte(uint16_t address) {
+    EEAR = address;
+    bit_set(EECR, EERE);
+    return EEDR;
+}
+
+/**
+ * @brief Program the next queued byte that differs from the EEPROM
+ * @return true if programming was started, false if the queue is drained
+ * @note EEPE must be clear and interrupts disabled
+ */
+static bool nvs_program_next(void) {
+    while (nvs_tail != nvs_head) {
+        uint16_t address = nvs_queue[nvs_tail].address;
+        uint8_t data = nvs_queue[nvs_tail].data;
+        uint8_t stored = nvs_read_byte(address);
+        
+        nvs_tail = (nvs_tail + 1) & NVS_QUEUE_MASK;
+        
+        // Skip the write entirely when the cell already holds the value
+        if (stored == data) {
+            continue;
+        }
+        
+        // Erase only sets bits to one, write only clears bits to zero:
+        // either takes half the time of a combined erase and write
+        uint8_t mode = NVS_MODE_ERASE_WRITE;
+        if (data == EER_NVS_ERASED_BYTE) {
+            mode = NVS_MODE_ERASE;
+        } else if ((stored & data) == data) {
+            mode = NVS_MODE_WRITE;
+        }
+        
+        EEDR = data;
+        EECR = mode | (1 << EERIE) | (1 << EEMPE);
+        bit_set(EECR, EEPE);
+        
+        return true;
+    }
+    
+    return false;
+}
+
+/**
+ * @brief Make progress on the queue when the interrupt cannot run
+ *
+ * Waiting for queue space or completion with global interrupts disabled
+ * would never end, so program from the caller's context instead.
+ */
+static void nvs_poll(void) {
+    if (!(SREG & (1 << SREG_I)) && !(EECR & (1 << EEPE))) {
+        if (!nvs_program_next()) {
+            bit_clear(EECR, EERIE);
+        }
+    }
+}
+
+/**
+ * @brief Check a blocking wait against its timeout
+ *
+ * The tick stands still while interrupts are disabled, but then nvs_poll()
+ * programs from the waiting loop, so the wait still ends.
+ *
+ * @param start System tick when the wait started
+ * @param timeout Timeout in milliseconds
+ * @return true once the timeout has passed
+ */
+static bool nvs_expired(uint32_t start, uint32_t timeout) {
+    uint32_t now = 0;
+    avr_system_get_tick(&now);
+    return now - start >= timeout;
+}
+
+/**
+ * @brief Number of free queue entries
+ */
+static uint8_t nvs_queue_free(void) {
+    return NVS_QUEUE_MASK - ((nvs_head - nvs_tail) & NVS_QUEUE_MASK);
+}
+
+/**
+ * @brief Queue bytes for programming
+ * @param address EEPROM address of the first byte
+ * @param data Bytes to program, NULL to erase
+ * @param size Number of bytes
+ * @param timeout Timeout in milliseconds (0 for non-blocking)
+ * @return Status code indicating success or failure, EER_HAL_TIMEOUT if
+ *         the queue stayed full; the bytes queued before are programmed
+ */
+static eer_hal_status_t nvs_enqueue(uint32_t address, const uint8_t* data, uint16_t size, uint32_t timeout) {
+    if (size == 0 || address + size > NVS_SIZE) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_trace(EER_TRACE_NVS_WRITE, (uint16_t)address);
+    
+    // Non-blocking requests are accepted whole or not at all
+    if (timeout == 0 && size > nvs_queue_free()) {
+        return EER_HAL_BUSY;
+    }
+    
+    uint32_t start = 0;
+    avr_system_get_tick(&start);
+    
+    for (uint16_t i = 0; i < size; i++) {
+        // Wait for the interrupt to free an entry
+        while (nvs_queue_free() == 0) {
+            nvs_poll();
+            if (nvs_queue_free() == 0 && nvs_expired(start, timeout)) {
+                return EER_HAL_TIMEOUT;
+            }
+        }
+        
+        nvs_queue[nvs_head].address = (uint16_t)(address + i);
+        nvs_queue[nvs_head].data = data != NULL ? data[i] : EER_NVS_ERASED_BYTE;
+        nvs_head = (nvs_head + 1) & NVS_QUEUE_MASK;
+        
+        // The EE_READY interrupt fires as soon as EEPE is clear
+        bit_set(EECR, EERIE);
+    }
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t avr_nvs_init(void) {
+    // Wait for a write started before initialization
+    while (EECR & (1 << EEPE));
+    
+    nvs_head = 0;
+    nvs_tail = 0;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t avr_nvs_flush(uint32_t timeout);
+
+eer_hal_status_t avr_nvs_deinit(void) {
+    // Program everything that was accepted
+    avr_nvs_flush(UINT32_MAX);
+    
+    bit_clear(EECR, EERIE);
+    
+    // Clear callback handler
+    nvs_callback.handler = NULL;
+    nvs_callback.user_data = NULL;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t avr_nvs_read(uint32_t address, uint8_t* data, uint16_t size) {
+    if (data == NULL || size == 0 || address + size > NVS_SIZE) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_trace(EER_TRACE_NVS_READ, (uint16_t)address);
+    
+    for (uint16_t i = 0; i < size; i++) {
+        uint16_t byte_address = (uint16_t)(address + i);
+        uint8_t sreg = SREG;
+        
+        // Wait for programming to finish with interrupts enabled, then
+        // make sure the interrupt did not start the next byte meanwhile
+        for (;;) {
+            while (EECR & (1 << EEPE));
+            cli();
+            if (!(EECR & (1 << EEPE))) {
+                break;
+            }
+            SREG = sreg;
+        }
+        
+        uint8_t value = nvs_read_byte(byte_address);
+        
+        // Queued writes are newer than the array, the latest one wins
+        for (uint8_t index = nvs_tail; index != nvs_head; index = (index + 1) & NVS_QUEUE_MASK) {
+            if (nvs_queue[index].address == byte_address) {
+                value = nvs_queue[index].data;
+            }
+        }
+        
+        SREG = sreg;
+        
+        data[i] = value;
+    }
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t avr_nvs_write(uint32_t address, const uint8_t* data, uint16_t size, uint32_t timeout) {
+    if (data == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    return nvs_enqueue(address, data, size, timeout);
+}
+
+eer_hal_status_t avr_nvs_erase(uint32_t address, uint16_t size, uint32_t timeout) {
+    return nvs_enqueue(address, NULL, size, timeout);
+}
+
+eer_hal_status_t avr_nvs_flush(uint32_t timeout) {
+    bool busy = nvs_tail != nvs_head || (EECR & (1 << EEPE));
+    
+    if (timeout == 0) {
+        return busy ? EER_HAL_BUSY : EER_HAL_OK;
+    }
+    
+    uint32_t start = 0;
+    avr_system_get_tick(&start);
+    
+    while (nvs_tail != nvs_head || (EECR & (1 << EEPE))) {
+        if (nvs_expired(start, timeout)) {
+            return EER_HAL_TIMEOUT;
+        }
+        nvs_poll();
+    }
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t avr_nvs_is_busy(bool* busy) {
+    if (busy == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    *busy = nvs_tail != nvs_head || (EECR & (1 << EEPE));
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t avr_nvs_get_size(uint32_t* size) {
+    if (size == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    *size = NVS_SIZE;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t avr_nvs_register_callback(eer_nvs_write_handler_t handler, void* user_data) {
+    if (handler == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Store the handler and user data
+    nvs_callback.handler = handler;
+    nvs_callback.user_data = user_data;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t avr_nvs_unregister_callback(void) {
+    // Clear the handler and user data
+    nvs_callback.handler = NULL;
+    nvs_callback.user_data = NULL;
+    
+    return EER_HAL_OK;
+}
+
+// EEPROM Ready ISR - programs the write queue in the background
+ISR(EE_READY_vect) {
+    if (nvs_program_next()) {
+        return;
+    }
+    
+    // Queue drained: stop the interrupt, it fires for as long as EEPE is clear
+    bit_clear(EECR, EERIE);
+    
+    eer_trace_isr(EER_TRACE_NVS_READY, 0);
+    
+    if (nvs_callback.handler != NULL) {
+        eer_nvs_event_t event = {
+            .nvs = &eer_avr_nvs,
+            .user_data = nvs_callback.user_data
+        };
+        
+        nvs_callback.handler(&event);
+    }
+}
+
+// NVS handler structure with function pointers
+eer_nvs_handler_t eer_avr_nvs = {
+    .init = avr_nvs_init,
+    .deinit = avr_nvs_deinit,
+    .read = avr_nvs_read,
+    .write = avr_nvs_write,
+    .erase = avr_nvs_erase,
+    .flush = avr_nvs_flush,
+    .is_busy = avr_nvs_is_busy,
+    .get_size = avr_nvs_get_size,
+    .register_callback = avr_nvs_register_callback,
+    .unregister_callback = avr_nvs_unregister_callback
+};
@@ -0,0 +1,390 @@
+#include "platforms/avr/nvs.h"
+#include "platforms/avr/mcu.h"
+#include "macros.h"
+#include "eer_trace.h"
+#include <stddef.h>
+#include <string.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+#include <avr/boot.h>
+#include <util/crc16.h>
+
+// Each page ends with a trailer: programming cycle count and CRC
+#define FLASH_NVS_TRAILER 4
+#define FLASH_NVS_DATA    (SPM_PAGESIZE - FLASH_NVS_TRAILER)
+#define FLASH_NVS_PAGES   (EER_AVR_FLASH_NVS_SIZE / (2 * SPM_PAGESIZE))
+#define FLASH_NVS_SIZE    ((uint32_t)FLASH_NVS_PAGES * FLASH_NVS_DATA)
+#define FLASH_NVS_NONE    0xFF
+
+#if EER_AVR_FLASH_NVS_SIZE % (2 * SPM_PAGESIZE) != 0 || FLASH_NVS_PAGES == 0 || FLASH_NVS_PAGES >= FLASH_NVS_NONE
+#error "EER_AVR_FLASH_NVS_SIZE must be a multiple of two flash pages"
+#endif
+
+#if EER_AVR_FLASH_SIZE != FLASHEND + 1
+#error "EER_AVR_FLASH_SIZE of the MCU descriptor does not match the device"
+#endif
+
+// Storage region, copies 0 and 1 of logical page n are physical pages 2n
+// and 2n + 1. It sits with the other program memory constants below 64 KB,
+// so near reads reach it on every device.
+static const uint8_t flash_nvs_region[EER_AVR_FLASH_NVS_SIZE] PROGMEM __attribute__((aligned(SPM_PAGESIZE))) = {
+    [0 ... EER_AVR_FLASH_NVS_SIZE - 1] = EER_NVS_ERASED_BYTE
+};
+
+// Copy of each logical page that holds the current data, one bit per page
+static uint8_t flash_nvs_active[(FLASH_NVS_PAGES + 7) / 8];
+
+// RAM image of the page being modified
+static uint8_t flash_nvs_buffer[SPM_PAGESIZE];
+static uint8_t flash_nvs_staged = FLASH_NVS_NONE;
+static bool flash_nvs_dirty = false;
+
+// Callback handler and user data
+static struct {
+    eer_nvs_write_handler_t handler;
+    void* user_data;
+} flash_nvs_callback = {0};
+
+static const uint8_t* flash_nvs_page(uint8_t page, uint8_t copy) {
+    return &flash_nvs_region[((uint16_t)page * 2 + copy) * SPM_PAGESIZE];
+}
+
+static uint8_t flash_nvs_active_copy(uint8_t page) {
+    return bit_get(flash_nvs_active[page >> 3], page & 0x07);
+}
+
+/**
+ * @brief Program one flash page from a RAM image
+ * @param address Byte address of the page
+ * @param data Page image of SPM_PAGESIZE bytes
+ *
+ * SPM only executes from the boot section, so this routine is linked into
+ * .bootloader, placed at the start of the boot section by the build when
+ * EER_AVR_NVS_FLASH is on (see toolchain/generic-gcc-avr.cmake). The
+ * application section cannot be read while it is programmed, interrupt
+ * vectors included, so the routine keeps interrupts disabled until erase
+ * and write have finished.
+ */
+BOOTLOADER_SECTION __attribute__((noinline))
+static void flash_nvs_program(uintptr_t address, const uint8_t* data) {
+    uint8_t sreg = SREG;
+    cli();
+    
+    // SPM must not start while the EEPROM is being programmed
+    while (EECR & (1 << EEPE));
+    
+    boot_page_erase(address);
+    boot_spm_busy_wait();
+    
+    for (uint16_t i = 0; i < SPM_PAGESIZE; i += 2) {
+        boot_page_fill(address + i, data[i] | ((uint16_t)data[i + 1] << 8));
+    }
+    
+    boot_page_write(address);
+    boot_spm_busy_wait();
+    
+    // Make the application section readable again
+    boot_rww_enable();
+    
+    SREG = sreg;
+}
+
+/**
+ * @brief Validate a programmed page
+ * @param page Page in program memory
+ * @param[out] cycles Pointer to store the programming cycle count
+ * @return true if the page was completely programmed
+ */
+static bool flash_nvs_valid(const uint8_t* page, uint16_t* cycles) {
+    uint16_t crc = 0xFFFF;
+    
+    for (uint8_t i = 0; i < FLASH_NVS_DATA + 2; i++) {
+        crc = _crc_ccitt_update(crc, pgm_read_byte(page + i));
+    }
+    
+    *cycles = pgm_read_word(page + FLASH_NVS_DATA);
+    
+    // An erased page holds no cycle count
+    return *cycles != 0xFFFF && crc == pgm_read_word(page + FLASH_NVS_DATA + 2);
+}
+
+/**
+ * @brief Program the RAM image into the inactive copy of its page
+ *
+ * The active copy stays intact until the new one is complete, so a reset
+ * during programming leaves the previous contents readable.
+ */
+static eer_hal_status_t flash_nvs_commit(void) {
+    uint8_t page = flash_nvs_staged;
+    uint8_t copy = flash_nvs_active_copy(page);
+    uint16_t cycles;
+    
+    if (flash_nvs_valid(flash_nvs_page(page, copy), &cycles)) {
+        cycles++;
+    } else {
+        cycles = 0;
+    }
+    
+    flash_nvs_buffer[FLASH_NVS_DATA] = (uint8_t)cycles;
+    flash_nvs_buffer[FLASH_NVS_DATA + 1] = (uint8_t)(cycles >> 8);
+    
+    uint16_t crc = 0xFFFF;
+    for (uint8_t i = 0; i < FLASH_NVS_DATA + 2; i++) {
+        crc = _crc_ccitt_update(crc, flash_nvs_buffer[i]);
+    }
+    flash_nvs_buffer[FLASH_NVS_DATA + 2] = (uint8_t)crc;
+    flash_nvs_buffer[FLASH_NVS_DATA + 3] = (uint8_t)(crc >> 8);
+    
+    const uint8_t* target = flash_nvs_page(page, copy ^ 1);
+    flash_nvs_program((uintptr_t)target, flash_nvs_buffer);
+    
+    // A worn-out page keeps the previous copy current
+    if (!flash_nvs_valid(target, &cycles)) {
+        return EER_HAL_ERROR;
+    }
+    
+    bit_toggle(flash_nvs_active[page >> 3], page & 0x07);
+    flash_nvs_dirty = false;
+    
+    eer_trace(EER_TRACE_NVS_READY, page);
+    
+    if (flash_nvs_callback.handler != NULL) {
+        eer_nvs_event_t event = {
+            .nvs = &eer_avr_flash_nvs,
+            .user_data = flash_nvs_callback.user_data
+        };
+        
+        flash_nvs_callback.handler(&event);
+    }
+    
+    return EER_HAL_OK;
+}
+
+/**
+ * @brief Load a page into the RAM image, committing the previous one
+ */
+static eer_hal_status_t flash_nvs_stage(uint8_t page) {
+    if (flash_nvs_staged == page) {
+        return EER_HAL_OK;
+    }
+    
+    if (flash_nvs_dirty) {
+        eer_hal_status_t status = flash_nvs_commit();
+        if (status != EER_HAL_OK) {
+            return status;
+        }
+    }
+    
+    memcpy_P(flash_nvs_buffer, flash_nvs_page(page, flash_nvs_active_copy(page)), FLASH_NVS_DATA);
+    flash_nvs_staged = page;
+    
+    return EER_HAL_OK;
+}
+
+/**
+ * @brief Merge bytes into the page images
+ * @param address Storage address of the first byte
+ * @param data Bytes to store, NULL to erase
+ * @param size Number of bytes
+ * @param timeout Timeout in milliseconds (0 for non-blocking)
+ * @return Status code indicating success or failure
+ */
+static eer_hal_status_t flash_nvs_store(uint32_t address, const uint8_t* data, uint16_t size, uint32_t timeout) {
+    if (size == 0 || address + size > FLASH_NVS_SIZE) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_trace(EER_TRACE_NVS_WRITE, (uint16_t)address);
+    
+    uint8_t first = (uint16_t)address / FLASH_NVS_DATA;
+    uint8_t last = (uint16_t)(address + size - 1) / FLASH_NVS_DATA;
+    
+    // Non-blocking requests are accepted only if no page has to be programmed
+    if (timeout == 0 && (first != last || (flash_nvs_dirty && first != flash_nvs_staged))) {
+        return EER_HAL_BUSY;
+    }
+    
+    uint16_t offset = (uint16_t)address % FLASH_NVS_DATA;
+    
+    for (uint8_t page = first; page <= last; page++) {
+        eer_hal_status_t status = flash_nvs_stage(page);
+        if (status != EER_HAL_OK) {
+            return status;
+        }
+        
+        for (; offset < FLASH_NVS_DATA && size > 0; offset++, size--) {
+            uint8_t value = data != NULL ? *data++ : EER_NVS_ERASED_BYTE;
+            
+            if (flash_nvs_buffer[offset] != value) {
+                flash_nvs_buffer[offset] = value;
+                flash_nvs_dirty = true;
+            }
+        }
+        
+        offset = 0;
+    }
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t avr_flash_nvs_init(void) {
+    // Pick the newest completely programmed copy of each page
+    for (uint8_t page = 0; page < FLASH_NVS_PAGES; page++) {
+        uint16_t cycles[2];
+        bool valid0 = flash_nvs_valid(flash_nvs_page(page, 0), &cycles[0]);
+        bool valid1 = flash_nvs_valid(flash_nvs_page(page, 1), &cycles[1]);
+        
+        if (valid1 && (!valid0 || (int16_t)(cycles[1] - cycles[0]) > 0)) {
+            bit_set(flash_nvs_active[page >> 3], page & 0x07);
+        } else {
+            bit_clear(flash_nvs_active[page >> 3], page & 0x07);
+        }
+    }
+    
+    flash_nvs_staged = FLASH_NVS_NONE;
+    flash_nvs_dirty = false;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t avr_flash_nvs_flush(uint32_t timeout);
+
+eer_hal_status_t avr_flash_nvs_deinit(void) {
+    // Program everything that was accepted
+    eer_hal_status_t status = avr_flash_nvs_flush(1);
+    
+    // Clear callback handler
+    flash_nvs_callback.handler = NULL;
+    flash_nvs_callback.user_data = NULL;
+    
+    return status;
+}
+
+eer_hal_status_t avr_flash_nvs_read(uint32_t address, uint8_t* data, uint16_t size) {
+    if (data == NULL || size == 0 || address + size > FLASH_NVS_SIZE) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_trace(EER_TRACE_NVS_READ, (uint16_t)address);
+    
+    uint8_t page = (uint16_t)address / FLASH_NVS_DATA;
+    uint16_t offset = (uint16_t)address % FLASH_NVS_DATA;
+    
+    while (size > 0) {
+        uint16_t chunk = FLASH_NVS_DATA - offset;
+        if (chunk > size) {
+            chunk = size;
+        }
+        
+        // Only the page being modified is read from RAM
+        if (page == flash_nvs_staged) {
+            memcpy(data, &flash_nvs_buffer[offset], chunk);
+        } else {
+            memcpy_P(data, flash_nvs_page(page, flash_nvs_active_copy(page)) + offset, chunk);
+        }
+        
+        data += chunk;
+        size -= chunk;
+        page++;
+        offset = 0;
+    }
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t avr_flash_nvs_write(uint32_t address, const uint8_t* data, uint16_t size, uint32_t timeout) {
+    if (data == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    return flash_nvs_store(address, data, size, timeout);
+}
+
+eer_hal_status_t avr_flash_nvs_erase(uint32_t address, uint16_t size, uint32_t timeout) {
+    return flash_nvs_store(address, NULL, size, timeout);
+}
+
+eer_hal_status_t avr_flash_nvs_flush(uint32_t timeout) {
+    if (!flash_nvs_dirty) {
+        return EER_HAL_OK;
+    }
+    
+    if (timeout == 0) {
+        return EER_HAL_BUSY;
+    }
+    
+    return flash_nvs_commit();
+}
+
+eer_hal_status_t avr_flash_nvs_is_busy(bool* busy) {
+    if (busy == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    *busy = flash_nvs_dirty;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t avr_flash_nvs_get_size(uint32_t* size) {
+    if (size == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    *size = FLASH_NVS_SIZE;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t avr_flash_nvs_register_callback(eer_nvs_write_handler_t handler, void* user_data) {
+    if (handler == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Store the handler and user data
+    flash_nvs_callback.handler = handler;
+    flash_nvs_callback.user_data = user_data;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t avr_flash_nvs_unregister_callback(void) {
+    // Clear the handler and user data
+    flash_nvs_callback.handler = NULL;
+    flash_nvs_callback.user_data = NULL;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t avr_flash_nvs_get_erase_count(uint32_t address, uint32_t* count) {
+    if (count == NULL || address >= FLASH_NVS_SIZE) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    uint8_t page = (uint16_t)address / FLASH_NVS_DATA;
+    uint16_t cycles;
+    
+    // The active copy carries the count of the pair, a page never
+    // programmed has none
+    *count = 0;
+    if (flash_nvs_valid(flash_nvs_page(page, flash_nvs_active_copy(page)), &cycles)) {
+        *count = (uint32_t)cycles + 1;
+    }
+    
+    return EER_HAL_OK;
+}
+
+// Flash storage handler structure with function pointers
+eer_nvs_handler_t eer_avr_flash_nvs = {
+    .init = avr_flash_nvs_init,
+    .deinit = avr_flash_nvs_deinit,
+    .read = avr_flash_nvs_read,
+    .write = avr_flash_nvs_write,
+    .erase = avr_flash_nvs_erase,
+    .flush = avr_flash_nvs_flush,
+    .is_busy = avr_flash_nvs_is_busy,
+    .get_size = avr_flash_nvs_get_size,
+    .register_callback = avr_flash_nvs_register_callback,
+    .unregister_callback = avr_flash_nvs_unregister_callback
+};
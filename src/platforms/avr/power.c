@@ -1,5 +1,8 @@
 #include "platforms/avr/power.h"
+#include "platforms/avr/gpio.h"
+#include "platforms/avr/uart.h"
 #include "macros.h"
+#include "eer_trace.h"
 #include <stddef.h>
 #include <avr/io.h>
 #include <avr/interrupt.h>
@@ -10,23 +13,99 @@
 static eer_power_mode_t current_power_mode = EER_POWER_MODE_RUN;
 
 // Last wakeup source
-static struct {
+static volatile struct {
     eer_wakeup_source_t source;
     uint8_t pin_or_id;
 } last_wakeup = {0};
 
-static eer_hal_status_t avr_power_init(void) {
+// Wake on serial activity from the clock-stopping sleep modes
+static bool uart_wakeup_enabled = false;
+
+#ifdef EER_AVR_UART_RXD_PIN
+// Receive pin of the default USART, watched for a start bit while the
+// USART is unclocked
+static eer_pin_t uart_wakeup_pin = EER_AVR_UART_RXD_PIN();
+
+/**
+ * @brief Pin change handler for the UART receive pin
+ * @param irq Information about the interrupt event
+ */
+static void power_uart_wakeup_handler(eer_gpio_irq_t* irq) {
+    // The first edge is enough: stop watching RXD so the rest of the
+    // traffic costs no pin change interrupts
+    eer_avr_gpio.disable_irq(irq->pin);
+    
+    last_wakeup.source = EER_WAKEUP_UART;
+    last_wakeup.pin_or_id = 0;
+}
+
+/**
+ * @brief Arm the start bit detector on the UART receive pin
+ */
+static void power_uart_wakeup_arm(void) {
+    // Finish the pending response first
+    avr_uart_flush();
+    
+    eer_gpio_config_t config = {
+        .mode = EER_GPIO_MODE_INPUT_PULLUP,
+        .trigger = EER_GPIO_TRIGGER_FALLING
+    };
+    eer_avr_gpio.configure(&uart_wakeup_pin, &config);
+    eer_avr_gpio.register_irq(&uart_wakeup_pin, power_uart_wakeup_handler, NULL);
+    eer_avr_gpio.enable_irq(&uart_wakeup_pin);
+}
+
+/**
+ * @brief Disarm the start bit detector, in case another source woke the MCU
+ */
+static void power_uart_wakeup_disarm(void) {
+    eer_avr_gpio.unregister_irq(&uart_wakeup_pin);
+}
+#else
+// The receive pin has no pin change interrupt, EER_WAKEUP_UART is rejected
+static inline void power_uart_wakeup_arm(void) {}
+static inline void power_uart_wakeup_disarm(void) {}
+#endif
+
+/**
+ * @brief Enter a sleep mode and return after wakeup
+ * @param sleep_mode AVR sleep mode (SLEEP_MODE_*)
+ */
+static void power_sleep(uint8_t sleep_mode) {
+    // The USART keeps running in idle, the other modes stop its clock
+    bool uart_wakeup = uart_wakeup_enabled && sleep_mode != SLEEP_MODE_IDLE;
+    
+    if (uart_wakeup) {
+        power_uart_wakeup_arm();
+    }
+    
+    eer_trace(EER_TRACE_POWER_SLEEP, sleep_mode);
+    
+    set_sleep_mode(sleep_mode);
+    sleep_enable();
+    sei();
+    sleep_cpu();
+    sleep_disable();
+    
+    eer_trace(EER_TRACE_POWER_WAKEUP, (uint16_t)last_wakeup.source << 8 | last_wakeup.pin_or_id);
+    
+    if (uart_wakeup) {
+        power_uart_wakeup_disarm();
+    }
+}
+
+eer_hal_status_t avr_power_init(void) {
     // Initialize power management
     // Nothing specific needed for AVR
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_power_deinit(void) {
+eer_hal_status_t avr_power_deinit(void) {
     // Nothing to deinitialize
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_power_set_mode(eer_power_mode_t mode) {
+eer_hal_status_t avr_power_set_mode(eer_power_mode_t mode) {
     switch (mode) {
         case EER_POWER_MODE_RUN:
             // Already in run mode, nothing to do
@@ -34,29 +113,17 @@ static eer_hal_status_t avr_power_set_mode(eer_power_mode_t mode) {
             
         case EER_POWER_MODE_SLEEP:
             // Configure sleep mode as idle
-            set_sleep_mode(SLEEP_MODE_IDLE);
-            sleep_enable();
-            sei();
-            sleep_cpu();
-            sleep_disable();
+            power_sleep(SLEEP_MODE_IDLE);
             break;
             
         case EER_POWER_MODE_DEEP_SLEEP:
             // Configure sleep mode as power-save
-            set_sleep_mode(SLEEP_MODE_PWR_SAVE);
-            sleep_enable();
-            sei();
-            sleep_cpu();
-            sleep_disable();
+            power_sleep(SLEEP_MODE_PWR_SAVE);
             break;
             
         case EER_POWER_MODE_STANDBY:
             // Configure sleep mode as power-down
-            set_sleep_mode(SLEEP_MODE_PWR_DOWN);
-            sleep_enable();
-            sei();
-            sleep_cpu();
-            sleep_disable();
+            power_sleep(SLEEP_MODE_PWR_DOWN);
             break;
             
         default:
@@ -67,7 +134,7 @@ static eer_hal_status_t avr_power_set_mode(eer_power_mode_t mode) {
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_power_get_mode(eer_power_mode_t* mode) {
+eer_hal_status_t avr_power_get_mode(eer_power_mode_t* mode) {
     if (mode == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
@@ -76,7 +143,7 @@ static eer_hal_status_t avr_power_get_mode(eer_power_mode_t* mode) {
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_power_enable_wakeup_source(eer_wakeup_source_t source, uint8_t pin_or_id) {
+eer_hal_status_t avr_power_enable_wakeup_source(eer_wakeup_source_t source, uint8_t pin_or_id) {
     switch (source) {
         case EER_WAKEUP_PIN:
             // Enable external interrupt for the specified pin
@@ -102,6 +169,18 @@ static eer_hal_status_t avr_power_enable_wakeup_source(eer_wakeup_source_t sourc
             WDTCSR |= (1 << WDIE);
             break;
             
+        case EER_WAKEUP_UART:
+            // Only the default USART is available, its RXD pin is armed on
+            // sleep entry
+#ifndef EER_AVR_UART_RXD_PIN
+            return EER_HAL_NOT_SUPPORTED;
+#endif
+            if (pin_or_id != 0) {
+                return EER_HAL_INVALID_PARAM;
+            }
+            uart_wakeup_enabled = true;
+            break;
+            
         case EER_WAKEUP_RTC:
             // AVR doesn't have a built-in RTC
             return EER_HAL_NOT_SUPPORTED;
@@ -113,7 +192,7 @@ static eer_hal_status_t avr_power_enable_wakeup_source(eer_wakeup_source_t sourc
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_power_disable_wakeup_source(eer_wakeup_source_t source, uint8_t pin_or_id) {
+eer_hal_status_t avr_power_disable_wakeup_source(eer_wakeup_source_t source, uint8_t pin_or_id) {
     switch (source) {
         case EER_WAKEUP_PIN:
             // Disable external interrupt for the specified pin
@@ -138,6 +217,13 @@ static eer_hal_status_t avr_power_disable_wakeup_source(eer_wakeup_source_t sour
             WDTCSR &= ~(1 << WDIE);
             break;
             
+        case EER_WAKEUP_UART:
+            if (pin_or_id != 0) {
+                return EER_HAL_INVALID_PARAM;
+            }
+            uart_wakeup_enabled = false;
+            break;
+            
         case EER_WAKEUP_RTC:
             // AVR doesn't have a built-in RTC
             return EER_HAL_NOT_SUPPORTED;
@@ -149,7 +235,7 @@ static eer_hal_status_t avr_power_disable_wakeup_source(eer_wakeup_source_t sour
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_power_get_wakeup_source(eer_wakeup_source_t* source, uint8_t* pin_or_id) {
+eer_hal_status_t avr_power_get_wakeup_source(eer_wakeup_source_t* source, uint8_t* pin_or_id) {
     if (source == NULL || pin_or_id == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
@@ -160,7 +246,12 @@ static eer_hal_status_t avr_power_get_wakeup_source(eer_wakeup_source_t* source,
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_power_get_voltage(uint16_t* voltage_mv) {
+void avr_power_wakeup(eer_wakeup_source_t source, uint8_t pin_or_id) {
+    last_wakeup.source = source;
+    last_wakeup.pin_or_id = pin_or_id;
+}
+
+eer_hal_status_t avr_power_get_voltage(uint16_t* voltage_mv) {
     if (voltage_mv == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
@@ -173,7 +264,7 @@ static eer_hal_status_t avr_power_get_voltage(uint16_t* voltage_mv) {
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_power_get_power_consumption(uint16_t* power_mw) {
+eer_hal_status_t avr_power_get_power_consumption(uint16_t* power_mw) {
     if (power_mw == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
@@ -213,12 +304,6 @@ ISR(INT1_vect) {
     last_wakeup.pin_or_id = 1;
 }
 
-// Timer/Counter1 Overflow ISR for power management wakeup
-ISR(TIMER1_OVF_vect) {
-    last_wakeup.source = EER_WAKEUP_TIMER;
-    last_wakeup.pin_or_id = 1;
-}
-
 // Watchdog Timer ISR
 ISR(WDT_vect) {
     last_wakeup.source = EER_WAKEUP_WATCHDOG;
@@ -1,6 +1,8 @@
 #include "platforms/avr/spi.h"
 #include "platforms/avr/gpio.h"
+#include "platforms/avr/progmem.h"
 #include "macros.h"
+#include "eer_trace.h"
 #include <stddef.h>
 #include <avr/io.h>
 #include <avr/interrupt.h>
@@ -14,19 +16,20 @@ static struct {
     void* user_data;
 } spi_callback = {0};
 
-// Current SPI configuration
-static eer_spi_config_t current_config = {0};
+// Asynchronous requests, run by the transfer complete interrupt
+static eer_async_queue_t spi_async = {0};
 
-static eer_hal_status_t avr_spi_init(eer_spi_config_t* config) {
+eer_hal_status_t avr_spi_init(eer_spi_config_t* config) {
     if (config == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
     
-    // Store the configuration
-    current_config = *config;
-    
+    return avr_spi_init_registers(avr_spi_registers(config));
+}
+
+eer_hal_status_t avr_spi_init_registers(avr_spi_registers_t registers) {
     // Configure SPI pins
-    if (config->master) {
+    if (registers.spcr & (1 << MSTR)) {
         // In master mode, set MOSI, SCK, and SS as outputs
         bit_set(*(spi0.pins.ddr), spi0.pins.mosi);
         bit_set(*(spi0.pins.ddr), spi0.pins.sck);
@@ -47,79 +50,19 @@ static eer_hal_status_t avr_spi_init(eer_spi_config_t* config) {
         bit_clear(*(spi0.pins.ddr), spi0.pins.ss);
     }
     
-    // Configure SPI control register
-    uint8_t spcr_value = (1 << SPE); // SPI Enable
-    
-    // Set master/slave mode
-    if (config->master) {
-        spcr_value |= (1 << MSTR);
-    }
-    
-    // Set data order
-    if (config->bit_order == EER_SPI_BIT_ORDER_LSB) {
-        spcr_value |= (1 << DORD);
-    }
-    
-    // Set clock polarity and phase based on mode
-    switch (config->mode) {
-        case EER_SPI_MODE_0:
-            // CPOL=0, CPHA=0 (default)
-            break;
-        case EER_SPI_MODE_1:
-            // CPOL=0, CPHA=1
-            spcr_value |= (1 << CPHA);
-            break;
-        case EER_SPI_MODE_2:
-            // CPOL=1, CPHA=0
-            spcr_value |= (1 << CPOL);
-            break;
-        case EER_SPI_MODE_3:
-            // CPOL=1, CPHA=1
-            spcr_value |= (1 << CPOL) | (1 << CPHA);
-            break;
-    }
-    
-    // Set clock rate
-    uint8_t spsr_value = 0;
-    
-    switch (config->prescaler) {
-        case EER_SPI_PRESCALER_2:
-            spsr_value |= (1 << SPI2X);
-            break;
-        case EER_SPI_PRESCALER_4:
-            // SPR1=0, SPR0=0, SPI2X=0 (default)
-            break;
-        case EER_SPI_PRESCALER_8:
-            spsr_value |= (1 << SPI2X);
-            spcr_value |= (1 << SPR0);
-            break;
-        case EER_SPI_PRESCALER_16:
-            spcr_value |= (1 << SPR0);
-            break;
-        case EER_SPI_PRESCALER_32:
-            spsr_value |= (1 << SPI2X);
-            spcr_value |= (1 << SPR1);
-            break;
-        case EER_SPI_PRESCALER_64:
-            spcr_value |= (1 << SPR1);
-            break;
-        case EER_SPI_PRESCALER_128:
-        default:
-            spcr_value |= (1 << SPR1) | (1 << SPR0);
-            break;
-    }
-    
     // Apply settings
-    *spi0.spcr = spcr_value;
-    *spi0.spsr = spsr_value;
+    *spi0.spcr = registers.spcr;
+    *spi0.spsr = registers.spsr;
     
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_spi_deinit(void) {
+eer_hal_status_t avr_spi_deinit(void) {
     // Disable SPI
     *spi0.spcr = 0;
     
+    eer_async_cancel(&spi_async, EER_HAL_ERROR);
+    
     // Clear callback handler
     spi_callback.handler = NULL;
     spi_callback.user_data = NULL;
@@ -127,17 +70,29 @@ static eer_hal_status_t avr_spi_deinit(void) {
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_spi_transfer(const uint8_t* tx_data, uint8_t* rx_data, uint16_t size, uint32_t timeout) {
+/**
+ * @brief Exchange bytes, sending from RAM or flash
+ *
+ * Always inlined, so the RAM variant keeps its plain loads.
+ */
+static inline __attribute__((always_inline))
+eer_hal_status_t spi_transfer(const uint8_t* tx_data, uint8_t* rx_data, uint16_t size, uint32_t timeout, bool flash) {
     if (size == 0 || (tx_data == NULL && rx_data == NULL)) {
         return EER_HAL_INVALID_PARAM;
     }
     
+    if (spi_async.head != NULL) {
+        return EER_HAL_BUSY;
+    }
+    
+    eer_trace(EER_TRACE_SPI_TRANSFER, size);
+    
     uint32_t start_time = 0; // In a real implementation, get current time
     
     for (uint16_t i = 0; i < size; i++) {
         // Load data into the SPI data register
         if (tx_data != NULL) {
-            *spi0.spdr = tx_data[i];
+            *spi0.spdr = avr_progmem_byte(tx_data, i, flash);
         } else {
             // If no TX data, send dummy byte
             *spi0.spdr = 0xFF;
@@ -178,15 +133,23 @@ static eer_hal_status_t avr_spi_transfer(const uint8_t* tx_data, uint8_t* rx_dat
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_spi_transmit(const uint8_t* data, uint16_t size, uint32_t timeout) {
+eer_hal_status_t avr_spi_transfer(const uint8_t* tx_data, uint8_t* rx_data, uint16_t size, uint32_t timeout) {
+    return spi_transfer(tx_data, rx_data, size, timeout, false);
+}
+
+eer_hal_status_t avr_spi_transmit(const uint8_t* data, uint16_t size, uint32_t timeout) {
     return avr_spi_transfer(data, NULL, size, timeout);
 }
 
-static eer_hal_status_t avr_spi_receive(uint8_t* data, uint16_t size, uint32_t timeout) {
+eer_hal_status_t avr_spi_transmit_P(const uint8_t* data, uint16_t size, uint32_t timeout) {
+    return spi_transfer(data, NULL, size, timeout, true);
+}
+
+eer_hal_status_t avr_spi_receive(uint8_t* data, uint16_t size, uint32_t timeout) {
     return avr_spi_transfer(NULL, data, size, timeout);
 }
 
-static eer_hal_status_t avr_spi_is_ready(bool* ready) {
+eer_hal_status_t avr_spi_is_ready(bool* ready) {
     if (ready == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
@@ -197,7 +160,7 @@ static eer_hal_status_t avr_spi_is_ready(bool* ready) {
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_spi_chip_select(void* pin, bool state) {
+eer_hal_status_t avr_spi_chip_select(void* pin, bool state) {
     if (pin == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
@@ -217,7 +180,30 @@ static eer_hal_status_t avr_spi_chip_select(void* pin, bool state) {
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_spi_register_callback(eer_spi_transfer_handler_t handler, void* user_data) {
+/**
+ * @brief Load the clock bits of a prescaler, keeping the rest of SPCR
+ */
+static void spi_set_rate(eer_spi_prescaler_t prescaler) {
+    eer_spi_config_t config = { .prescaler = prescaler };
+    avr_spi_registers_t registers = avr_spi_registers(&config);
+    uint8_t rate = (1 << SPR1) | (1 << SPR0);
+    
+    *spi0.spcr = (*spi0.spcr & ~rate) | (registers.spcr & rate);
+    *spi0.spsr = registers.spsr;
+}
+
+eer_hal_status_t avr_spi_set_prescaler(eer_spi_prescaler_t prescaler) {
+    // Not under a running request
+    if (spi_async.head != NULL) {
+        return EER_HAL_BUSY;
+    }
+    
+    spi_set_rate(prescaler);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t avr_spi_register_callback(eer_spi_transfer_handler_t handler, void* user_data) {
     if (handler == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
@@ -232,22 +218,112 @@ static eer_hal_status_t avr_spi_register_callback(eer_spi_transfer_handler_t han
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_spi_unregister_callback(void) {
+eer_hal_status_t avr_spi_unregister_callback(void) {
     // Clear the handler and user data
     spi_callback.handler = NULL;
     spi_callback.user_data = NULL;
     
-    // Disable SPI interrupt
-    *spi0.spcr &= ~(1 << SPIE);
+    // Disable SPI interrupt unless requests are running
+    if (spi_async.head == NULL) {
+        *spi0.spcr &= ~(1 << SPIE);
+    }
+    
+    return EER_HAL_OK;
+}
+
+/**
+ * @brief Number of bytes a request exchanges
+ */
+static uint16_t spi_async_size(const eer_async_request_t* request) {
+    return request->tx_size > request->rx_size ? request->tx_size : request->rx_size;
+}
+
+/**
+ * @brief Send the next byte of the running request
+ */
+static void spi_async_send(const eer_async_request_t* request) {
+    *spi0.spdr = request->index < request->tx_size ? avr_async_tx_byte(request, request->index) : 0xFF;
+}
+
+/**
+ * @brief Start the request at the head of the queue
+ *
+ * Called with interrupts disabled, from submit or from the interrupt that
+ * finished the previous request.
+ */
+static void spi_async_start(void) {
+    eer_async_request_t* request = spi_async.head;
+    
+    if (request == NULL) {
+        // Back to the callback's setting
+        if (spi_callback.handler == NULL) {
+            *spi0.spcr &= ~(1 << SPIE);
+        }
+        return;
+    }
+    
+    const eer_spi_device_t* device = (const eer_spi_device_t*)request->device;
+    if (device != NULL) {
+        spi_set_rate(device->prescaler);
+        avr_spi_chip_select(device->cs, true);
+    }
+    
+    *spi0.spcr |= (1 << SPIE);
+    spi_async_send(request);
+}
+
+/**
+ * @brief Take the byte received for the running request
+ */
+static void spi_async_isr(eer_async_request_t* request) {
+    uint8_t data = *spi0.spdr;
+    
+    if (request->index < request->rx_size) {
+        request->rx_data[request->index] = data;
+    }
+    request->index++;
+    
+    if (request->index < spi_async_size(request)) {
+        spi_async_send(request);
+        return;
+    }
+    
+    if (request->device != NULL) {
+        avr_spi_chip_select(((const eer_spi_device_t*)request->device)->cs, false);
+    }
+    
+    eer_async_dequeue(&spi_async);
+    spi_async_start();
+    eer_async_complete(request, EER_HAL_OK);
+}
+
+eer_hal_status_t avr_spi_submit(eer_async_request_t* request) {
+    eer_hal_status_t status = eer_async_prepare(request);
+    if (status != EER_HAL_OK) {
+        return status;
+    }
+    
+    eer_trace(EER_TRACE_SPI_TRANSFER, spi_async_size(request));
+    
+    uint8_t sreg = SREG;
+    cli();
+    if (eer_async_enqueue(&spi_async, request)) {
+        spi_async_start();
+    }
+    SREG = sreg;
     
     return EER_HAL_OK;
 }
 
 // SPI Transfer Complete ISR - dedicated to SPI module
 ISR(SPI_STC_vect) {
-    // This ISR is called when a SPI transfer is complete
-    // In interrupt-driven mode, we would handle the transfer here
-    // For now, we just call the callback if registered
+    eer_trace_isr(EER_TRACE_SPI_IRQ, SPDR);
+    
+    // Asynchronous requests take the interrupt while they run
+    if (spi_async.head != NULL) {
+        spi_async_isr(spi_async.head);
+        return;
+    }
     
     if (spi_callback.handler != NULL) {
         // Note: In a real implementation, we would need to track the transfer
@@ -273,6 +349,8 @@ eer_spi_handler_t eer_avr_spi = {
     .receive = avr_spi_receive,
     .is_ready = avr_spi_is_ready,
     .chip_select = avr_spi_chip_select,
+    .set_prescaler = avr_spi_set_prescaler,
     .register_callback = avr_spi_register_callback,
-    .unregister_callback = avr_spi_unregister_callback
+    .unregister_callback = avr_spi_unregister_callback,
+    .submit = avr_spi_submit
 };
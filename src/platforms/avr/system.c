@@ -8,7 +8,7 @@
 #include <util/delay.h>
 
 // System tick counter with atomic access protection
-static volatile uint32_t system_ticks = 0;
+volatile uint32_t avr_system_ticks = 0;
 
 // Flag to track if system is initialized
 static bool system_initialized = false;
@@ -27,16 +27,7 @@ typedef union {
     } bytes;
 } atomic_u32_t;
 
-// Use Timer2 for system ticks to avoid conflicts with Timer0/Timer1
-#define SYSTEM_TIMER_TCCRA TCCR2A
-#define SYSTEM_TIMER_TCCRB TCCR2B
-#define SYSTEM_TIMER_OCR   OCR2A
-#define SYSTEM_TIMER_TIMSK TIMSK2
-#define SYSTEM_TIMER_TIFR  TIFR2
-#define SYSTEM_TIMER_OCIE  OCIE2A
-#define SYSTEM_TIMER_OCF   OCF2A
-
-static eer_hal_status_t avr_system_init(void) {
+eer_hal_status_t avr_system_init(void) {
     if (system_initialized) {
         return EER_HAL_OK;
     }
@@ -44,29 +35,29 @@ static eer_hal_status_t avr_system_init(void) {
     // Reset system tick counter
     uint8_t sreg = SREG;
     cli();
-    system_ticks = 0;
+    avr_system_ticks = 0;
     SREG = sreg;
     
-    // Initialize system tick timer (Timer2)
-    // Configure Timer2 for 1ms overflow
-    SYSTEM_TIMER_TCCRA = (1 << WGM21);  // CTC mode
-    SYSTEM_TIMER_TCCRB = 0;  // Stop timer initially
+    // Initialize the system tick timer of the MCU descriptor
+    // Configure it for 1ms overflow
+    EER_AVR_TICK_TCCRA = EER_AVR_TICK_CTC;  // CTC mode
+    EER_AVR_TICK_TCCRB = 0;  // Stop timer initially
     
     // Calculate the compare value for 1ms period
     // F_CPU / (prescaler * 1000Hz) - 1
     uint8_t compare_value = (F_CPU / 64 / 1000) - 1;
     
     // Set compare value
-    SYSTEM_TIMER_OCR = compare_value;
+    EER_AVR_TICK_OCR = compare_value;
     
     // Clear any pending interrupts
-    SYSTEM_TIMER_TIFR = (1 << SYSTEM_TIMER_OCF);
+    EER_AVR_TICK_TIFR = (1 << EER_AVR_TICK_OCF);
     
     // Enable compare match interrupt
-    SYSTEM_TIMER_TIMSK = (1 << SYSTEM_TIMER_OCIE);
+    EER_AVR_TICK_TIMSK = (1 << EER_AVR_TICK_OCIE);
     
     // Start timer with prescaler 64
-    SYSTEM_TIMER_TCCRB = (1 << CS22);
+    EER_AVR_TICK_TCCRB = EER_AVR_TICK_CLK64;
     
     // Enable global interrupts
     sei();
@@ -75,25 +66,25 @@ static eer_hal_status_t avr_system_init(void) {
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_system_deinit(void) {
+eer_hal_status_t avr_system_deinit(void) {
     if (!system_initialized) {
         return EER_HAL_OK;
     }
     
     // Stop the timer
-    SYSTEM_TIMER_TCCRB = 0;
+    EER_AVR_TICK_TCCRB = 0;
     
-    // Disable Timer2 interrupt
-    SYSTEM_TIMER_TIMSK &= ~(1 << SYSTEM_TIMER_OCIE);
+    // Disable the tick interrupt
+    EER_AVR_TICK_TIMSK &= ~(1 << EER_AVR_TICK_OCIE);
     
     // Clear any pending interrupts
-    SYSTEM_TIMER_TIFR = (1 << SYSTEM_TIMER_OCF);
+    EER_AVR_TICK_TIFR = (1 << EER_AVR_TICK_OCF);
     
     system_initialized = false;
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_system_reset(eer_system_reset_type_t reset_type) {
+eer_hal_status_t avr_system_reset(eer_system_reset_type_t reset_type) {
     switch (reset_type) {
         case EER_SYSTEM_RESET_SOFT:
             // Jump to reset vector
@@ -122,32 +113,32 @@ static eer_hal_status_t avr_system_reset(eer_system_reset_type_t reset_type) {
     return EER_HAL_ERROR;
 }
 
-static eer_hal_status_t avr_system_disable_interrupts(void) {
+eer_hal_status_t avr_system_disable_interrupts(void) {
     cli();
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_system_enable_interrupts(void) {
+eer_hal_status_t avr_system_enable_interrupts(void) {
     sei();
     return EER_HAL_OK;
 }
 
 
-static eer_hal_status_t avr_system_delay_ms(uint32_t ms) {
+eer_hal_status_t avr_system_delay_ms(uint32_t ms) {
     while (ms--) {
         _delay_ms(1);
     }
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_system_delay_us(uint32_t us) {
+eer_hal_status_t avr_system_delay_us(uint32_t us) {
     while (us--) {
         _delay_us(1);
     }
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_system_get_tick(uint32_t* ticks) {
+eer_hal_status_t avr_system_get_tick(uint32_t* ticks) {
     if (ticks == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
@@ -160,7 +151,7 @@ static eer_hal_status_t avr_system_get_tick(uint32_t* ticks) {
     cli();
     
     // Copy the volatile counter to our local union
-    local_ticks.value = system_ticks;
+    local_ticks.value = avr_system_ticks;
     
     // Restore interrupt state
     SREG = sreg;
@@ -171,7 +162,7 @@ static eer_hal_status_t avr_system_get_tick(uint32_t* ticks) {
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_system_get_uptime_ms(uint32_t* uptime) {
+eer_hal_status_t avr_system_get_uptime_ms(uint32_t* uptime) {
     if (uptime == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
@@ -185,15 +176,15 @@ static eer_hal_status_t avr_system_get_uptime_ms(uint32_t* uptime) {
     return EER_HAL_OK;
 }
 
-// Timer2 Compare Match A ISR for system tick
-ISR(TIMER2_COMPA_vect) {
+// Compare match ISR of the system tick timer
+ISR(EER_AVR_TICK_vect) {
     // Increment the system tick counter
     // This is safe because the ISR cannot be interrupted
-    system_ticks++;
+    avr_system_ticks++;
     
     // If we need to perform additional operations on overflow,
     // we could check for it here
-    if (system_ticks == 0) {
+    if (avr_system_ticks == 0) {
         // Handle 32-bit overflow if needed
     }
 }
@@ -1,5 +1,7 @@
 #include "platforms/avr/timer.h"
+#include "platforms/avr/power.h"
 #include "macros.h"
+#include "eer_trace.h"
 #include <stddef.h>
 #include <avr/io.h>
 #include <avr/interrupt.h>
@@ -7,150 +9,170 @@
 // Default Timer instance for AVR
 static eer_timer_t timer1 = eer_hal_timer1();
 
-// Callback handlers and user data for different timer events
-static struct {
-    eer_timer_event_handler_t overflow_handler;
-    void* overflow_user_data;
-    eer_timer_event_handler_t compare_a_handler;
-    void* compare_a_user_data;
-    eer_timer_event_handler_t compare_b_handler;
-    void* compare_b_user_data;
-    eer_timer_event_handler_t capture_handler;
-    void* capture_user_data;
-} timer_callbacks = {0};
-
-// Current timer configuration
-static eer_timer_config_t current_config = {0};
-
-static eer_hal_status_t avr_timer_init(eer_timer_config_t* config) {
+// Initialized instance of each 16-bit timer, served by its interrupt vectors
+static eer_timer_t* timer_instances[EER_AVR_TIMERS] = { [1] = &timer1 };
+
+// Clock select bits, the same in every 16-bit timer
+#define TIMER_CLOCK_MASK ((1 << CS12) | (1 << CS11) | (1 << CS10))
+
+// Counter clock of the clk/8 prescaler set by avr_timer_registers(), in kHz
+#define TIMER_PRESCALER 8
+#define TIMER_KHZ (F_CPU / TIMER_PRESCALER / 1000)
+
+#if F_CPU % (TIMER_PRESCALER * 1000UL) != 0
+#error "F_CPU must be a multiple of 8 kHz for the timer tick conversions"
+#endif
+
+eer_hal_status_t avr_timer_instance_init(void* timer, eer_timer_config_t* config) {
     if (config == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
     
+    return avr_timer_instance_init_registers(timer, config, avr_timer_registers(config));
+}
+
+eer_hal_status_t avr_timer_instance_init_registers(void* timer, const eer_timer_config_t* config, avr_timer_registers_t registers) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL || config == NULL || instance->index >= EER_AVR_TIMERS) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
     // Store the configuration
-    current_config = *config;
+    instance->config = *config;
     
     // Reset timer registers
-    *timer1.tccra = 0;
-    *timer1.tccrb = 0;
-    *timer1.timsk = 0;
-    *timer1.tcnt = 0;
-    
-    // Configure timer mode
-    switch (config->mode) {
-        case EER_TIMER_MODE_ONE_SHOT:
-        case EER_TIMER_MODE_CONTINUOUS:
-            // Normal mode (0)
-            *timer1.tccra &= ~((1 << WGM11) | (1 << WGM10));
-            *timer1.tccrb &= ~((1 << WGM13) | (1 << WGM12));
-            break;
-            
-        case EER_TIMER_MODE_PWM:
-            // Fast PWM mode, TOP = ICR1 (14)
-            *timer1.tccra |= (1 << WGM11);
-            *timer1.tccra &= ~(1 << WGM10);
-            *timer1.tccrb |= ((1 << WGM13) | (1 << WGM12));
-            
-            // Set TOP value based on period
-            *timer1.icr = config->period;
-            
-            // Configure PWM outputs (non-inverting mode)
-            *timer1.tccra |= ((1 << COM1A1) | (1 << COM1B1));
-            *timer1.tccra &= ~((1 << COM1A0) | (1 << COM1B0));
-            break;
+    *instance->tccra = 0;
+    *instance->tccrb = 0;
+    *instance->timsk = 0;
+    *instance->tcnt = 0;
+    
+    // TOP before the waveform mode that uses it
+    if (registers.tccrb & (1 << WGM13)) {
+        *instance->icr = registers.icr;
     }
     
-    // Set prescaler based on desired frequency
-    // For simplicity, we'll use a fixed prescaler of 8
-    // A more complete implementation would calculate the best prescaler
-    *timer1.tccrb |= (1 << CS11);  // Prescaler = 8
+    // Mode, outputs and clock; the clock starts the timer
+    *instance->tccra = registers.tccra;
+    *instance->tccrb = registers.tccrb;
+    
+    // Route the interrupts of this timer to the instance
+    timer_instances[instance->index] = instance;
     
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_timer_deinit(void) {
+eer_hal_status_t avr_timer_instance_deinit(void* timer) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
     // Stop the timer
-    *timer1.tccrb &= ~((1 << CS12) | (1 << CS11) | (1 << CS10));
+    *instance->tccrb &= ~TIMER_CLOCK_MASK;
     
     // Disable all interrupts
-    *timer1.timsk = 0;
+    *instance->timsk = 0;
     
     // Clear all callback handlers
-    timer_callbacks.overflow_handler = NULL;
-    timer_callbacks.overflow_user_data = NULL;
-    timer_callbacks.compare_a_handler = NULL;
-    timer_callbacks.compare_a_user_data = NULL;
-    timer_callbacks.compare_b_handler = NULL;
-    timer_callbacks.compare_b_user_data = NULL;
-    timer_callbacks.capture_handler = NULL;
-    timer_callbacks.capture_user_data = NULL;
+    instance->overflow_handler = NULL;
+    instance->overflow_user_data = NULL;
+    instance->compare_handler[0] = NULL;
+    instance->compare_user_data[0] = NULL;
+    instance->compare_handler[1] = NULL;
+    instance->compare_user_data[1] = NULL;
+    instance->capture_handler = NULL;
+    instance->capture_user_data = NULL;
     
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_timer_start(void) {
+eer_hal_status_t avr_timer_instance_start(void* timer) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_trace(EER_TRACE_TIMER_START, instance->index);
+    
     // Reset counter
-    *timer1.tcnt = 0;
+    *instance->tcnt = 0;
     
     // Start timer with configured prescaler
     // For simplicity, we're using a fixed prescaler of 8
-    *timer1.tccrb |= (1 << CS11);
+    *instance->tccrb |= (1 << CS11);
     
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_timer_stop(void) {
+eer_hal_status_t avr_timer_instance_stop(void* timer) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_trace(EER_TRACE_TIMER_STOP, instance->index);
+    
     // Stop the timer by clearing the clock select bits
-    *timer1.tccrb &= ~((1 << CS12) | (1 << CS11) | (1 << CS10));
+    *instance->tccrb &= ~TIMER_CLOCK_MASK;
     
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_timer_set_period(uint32_t period) {
-    if (period > 0xFFFF) {
+eer_hal_status_t avr_timer_instance_set_period(void* timer, uint32_t period) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL || period > 0xFFFF) {
         // 16-bit timer can't handle periods larger than 0xFFFF
         return EER_HAL_INVALID_PARAM;
     }
     
-    if (current_config.mode == EER_TIMER_MODE_PWM) {
-        // In PWM mode, period is set via ICR1
-        *timer1.icr = period;
+    if (instance->config.mode == EER_TIMER_MODE_PWM) {
+        // In PWM mode, period is set via ICRn
+        *instance->icr = period;
     } else {
         // In other modes, we use the overflow interrupt
         // and reset the counter in the ISR if needed
-        if (timer_callbacks.overflow_handler != NULL) {
+        if (instance->overflow_handler != NULL) {
             // Enable overflow interrupt
-            *timer1.timsk |= (1 << TOIE1);
+            *instance->timsk |= (1 << TOIE1);
         }
     }
     
-    current_config.period = period;
+    instance->config.period = period;
     
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_timer_get_value(uint32_t* value) {
-    if (value == NULL) {
+eer_hal_status_t avr_timer_instance_get_value(void* timer, uint32_t* value) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL || value == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
     
-    *value = *timer1.tcnt;
+    *value = *instance->tcnt;
     
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_timer_set_compare(uint8_t channel, uint32_t value) {
-    if (value > 0xFFFF) {
+eer_hal_status_t avr_timer_instance_set_compare(void* timer, uint8_t channel, uint32_t value) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL || value > 0xFFFF) {
         // 16-bit timer can't handle values larger than 0xFFFF
         return EER_HAL_INVALID_PARAM;
     }
     
     switch (channel) {
         case 0:
-            *timer1.ocra = value;
+            *instance->ocra = value;
             break;
         case 1:
-            *timer1.ocrb = value;
+            *instance->ocrb = value;
             break;
         default:
             return EER_HAL_INVALID_PARAM;
@@ -159,20 +181,22 @@ static eer_hal_status_t avr_timer_set_compare(uint8_t channel, uint32_t value) {
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_timer_set_pwm_duty_cycle(uint8_t channel, uint8_t duty_cycle) {
-    if (duty_cycle > 100 || current_config.mode != EER_TIMER_MODE_PWM) {
+eer_hal_status_t avr_timer_instance_set_pwm_duty_cycle(void* timer, uint8_t channel, uint8_t duty_cycle) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL || duty_cycle > 100 || instance->config.mode != EER_TIMER_MODE_PWM) {
         return EER_HAL_INVALID_PARAM;
     }
     
     // Calculate the compare value based on duty cycle and period
-    uint16_t compare_value = (current_config.period * duty_cycle) / 100;
+    uint16_t compare_value = (instance->config.period * duty_cycle) / 100;
     
     switch (channel) {
         case 0:
-            *timer1.ocra = compare_value;
+            *instance->ocra = compare_value;
             break;
         case 1:
-            *timer1.ocrb = compare_value;
+            *instance->ocrb = compare_value;
             break;
         default:
             return EER_HAL_INVALID_PARAM;
@@ -181,51 +205,60 @@ static eer_hal_status_t avr_timer_set_pwm_duty_cycle(uint8_t channel, uint8_t du
     return EER_HAL_OK;
 }
 
-static uint32_t avr_timer_us_to_ticks(uint32_t us) {
-    // With a prescaler of 8 and assuming F_CPU = 16MHz,
-    // each tick is 0.5us, so multiply by 2
-    return us * 2;
+uint32_t avr_timer_instance_us_to_ticks(void* timer, uint32_t us) {
+    (void)timer;
+    
+#if TIMER_KHZ % 1000 == 0
+    // Whole ticks per microsecond, e.g. 2 at 16 MHz
+    return us * (TIMER_KHZ / 1000);
+#else
+    // Split at milliseconds so the product stays within 32 bits
+    return us / 1000 * TIMER_KHZ + us % 1000 * TIMER_KHZ / 1000;
+#endif
 }
 
-static uint32_t avr_timer_ticks_to_us(uint32_t ticks) {
-    // With a prescaler of 8 and assuming F_CPU = 16MHz,
-    // each tick is 0.5us, so divide by 2
-    return ticks / 2;
+uint32_t avr_timer_instance_ticks_to_us(void* timer, uint32_t ticks) {
+    (void)timer;
+    
+#if TIMER_KHZ % 1000 == 0
+    return ticks / (TIMER_KHZ / 1000);
+#else
+    return ticks / TIMER_KHZ * 1000 + ticks % TIMER_KHZ * 1000 / TIMER_KHZ;
+#endif
 }
 
-static eer_hal_status_t avr_timer_register_callback(eer_timer_event_t event, 
-                                                  uint8_t channel,
-                                                  eer_timer_event_handler_t handler, 
-                                                  void* user_data) {
-    if (handler == NULL) {
+eer_hal_status_t avr_timer_instance_register_callback(void* timer,
+                                                      eer_timer_event_t event,
+                                                      uint8_t channel,
+                                                      eer_timer_event_handler_t handler,
+                                                      void* user_data) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL || handler == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
     
     switch (event) {
         case EER_TIMER_EVENT_OVERFLOW:
-            timer_callbacks.overflow_handler = handler;
-            timer_callbacks.overflow_user_data = user_data;
-            *timer1.timsk |= (1 << TOIE1);  // Enable overflow interrupt
+            instance->overflow_handler = handler;
+            instance->overflow_user_data = user_data;
+            *instance->timsk |= (1 << TOIE1);  // Enable overflow interrupt
             break;
             
         case EER_TIMER_EVENT_COMPARE:
-            if (channel == 0) {
-                timer_callbacks.compare_a_handler = handler;
-                timer_callbacks.compare_a_user_data = user_data;
-                *timer1.timsk |= (1 << OCIE1A);  // Enable compare A interrupt
-            } else if (channel == 1) {
-                timer_callbacks.compare_b_handler = handler;
-                timer_callbacks.compare_b_user_data = user_data;
-                *timer1.timsk |= (1 << OCIE1B);  // Enable compare B interrupt
-            } else {
+            if (channel > 1) {
                 return EER_HAL_INVALID_PARAM;
             }
+            instance->compare_handler[channel] = handler;
+            instance->compare_user_data[channel] = user_data;
+            // Enable compare A or B interrupt
+            *instance->timsk |= (1 << (channel == 0 ? OCIE1A : OCIE1B));
             break;
             
         case EER_TIMER_EVENT_CAPTURE:
-            timer_callbacks.capture_handler = handler;
-            timer_callbacks.capture_user_data = user_data;
-            *timer1.timsk |= (1 << ICIE1);  // Enable input capture interrupt
+            instance->capture_handler = handler;
+            instance->capture_user_data = user_data;
+            *instance->timsk |= (1 << ICIE1);  // Enable input capture interrupt
             break;
             
         default:
@@ -235,32 +268,34 @@ static eer_hal_status_t avr_timer_register_callback(eer_timer_event_t event,
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_timer_unregister_callback(eer_timer_event_t event, uint8_t channel) {
+eer_hal_status_t avr_timer_instance_unregister_callback(void* timer, eer_timer_event_t event, uint8_t channel) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
     switch (event) {
         case EER_TIMER_EVENT_OVERFLOW:
-            timer_callbacks.overflow_handler = NULL;
-            timer_callbacks.overflow_user_data = NULL;
-            *timer1.timsk &= ~(1 << TOIE1);  // Disable overflow interrupt
+            instance->overflow_handler = NULL;
+            instance->overflow_user_data = NULL;
+            *instance->timsk &= ~(1 << TOIE1);  // Disable overflow interrupt
             break;
             
         case EER_TIMER_EVENT_COMPARE:
-            if (channel == 0) {
-                timer_callbacks.compare_a_handler = NULL;
-                timer_callbacks.compare_a_user_data = NULL;
-                *timer1.timsk &= ~(1 << OCIE1A);  // Disable compare A interrupt
-            } else if (channel == 1) {
-                timer_callbacks.compare_b_handler = NULL;
-                timer_callbacks.compare_b_user_data = NULL;
-                *timer1.timsk &= ~(1 << OCIE1B);  // Disable compare B interrupt
-            } else {
+            if (channel > 1) {
                 return EER_HAL_INVALID_PARAM;
             }
+            instance->compare_handler[channel] = NULL;
+            instance->compare_user_data[channel] = NULL;
+            // Disable compare A or B interrupt
+            *instance->timsk &= ~(1 << (channel == 0 ? OCIE1A : OCIE1B));
             break;
             
         case EER_TIMER_EVENT_CAPTURE:
-            timer_callbacks.capture_handler = NULL;
-            timer_callbacks.capture_user_data = NULL;
-            *timer1.timsk &= ~(1 << ICIE1);  // Disable input capture interrupt
+            instance->capture_handler = NULL;
+            instance->capture_user_data = NULL;
+            *instance->timsk &= ~(1 << ICIE1);  // Disable input capture interrupt
             break;
             
         default:
@@ -270,72 +305,195 @@ static eer_hal_status_t avr_timer_unregister_callback(eer_timer_event_t event, u
     return EER_HAL_OK;
 }
 
-// Timer1 Overflow ISR
-ISR(TIMER1_OVF_vect) {
-    if (timer_callbacks.overflow_handler != NULL) {
-        eer_timer_event_info_t event = {
-            .timer = &timer1,
-            .event = EER_TIMER_EVENT_OVERFLOW,
-            .value = 0,  // Overflow means the counter wrapped to 0
-            .user_data = timer_callbacks.overflow_user_data
-        };
-        
-        timer_callbacks.overflow_handler(&event);
+eer_hal_status_t avr_timer_instance_set_capture_edge(void* timer, bool rising) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL) {
+        return EER_HAL_INVALID_PARAM;
     }
     
-    // If in one-shot mode, stop the timer
-    if (current_config.mode == EER_TIMER_MODE_ONE_SHOT) {
-        *timer1.tccrb &= ~((1 << CS12) | (1 << CS11) | (1 << CS10));
+    if (rising) {
+        *instance->tccrb |= (1 << ICES1);
+    } else {
+        *instance->tccrb &= ~(1 << ICES1);
     }
+    
+    // Changing the edge may set the capture flag
+    *instance->tifr = (1 << ICF1);
+    
+    return EER_HAL_OK;
+}
+
+// Single-instance operations on Timer1
+eer_hal_status_t avr_timer_init(eer_timer_config_t* config) {
+    return avr_timer_instance_init(&timer1, config);
+}
+
+eer_hal_status_t avr_timer_init_registers(const eer_timer_config_t* config, avr_timer_registers_t registers) {
+    return avr_timer_instance_init_registers(&timer1, config, registers);
+}
+
+eer_hal_status_t avr_timer_deinit(void) {
+    return avr_timer_instance_deinit(&timer1);
+}
+
+eer_hal_status_t avr_timer_start(void) {
+    return avr_timer_instance_start(&timer1);
+}
+
+eer_hal_status_t avr_timer_stop(void) {
+    return avr_timer_instance_stop(&timer1);
+}
+
+eer_hal_status_t avr_timer_set_period(uint32_t period) {
+    return avr_timer_instance_set_period(&timer1, period);
+}
+
+eer_hal_status_t avr_timer_get_value(uint32_t* value) {
+    return avr_timer_instance_get_value(&timer1, value);
+}
+
+eer_hal_status_t avr_timer_set_compare(uint8_t channel, uint32_t value) {
+    return avr_timer_instance_set_compare(&timer1, channel, value);
+}
+
+eer_hal_status_t avr_timer_set_pwm_duty_cycle(uint8_t channel, uint8_t duty_cycle) {
+    return avr_timer_instance_set_pwm_duty_cycle(&timer1, channel, duty_cycle);
+}
+
+uint32_t avr_timer_us_to_ticks(uint32_t us) {
+    return avr_timer_instance_us_to_ticks(&timer1, us);
+}
+
+uint32_t avr_timer_ticks_to_us(uint32_t ticks) {
+    return avr_timer_instance_ticks_to_us(&timer1, ticks);
+}
+
+eer_hal_status_t avr_timer_register_callback(eer_timer_event_t event,
+                                                  uint8_t channel,
+                                                  eer_timer_event_handler_t handler,
+                                                  void* user_data) {
+    return avr_timer_instance_register_callback(&timer1, event, channel, handler, user_data);
+}
+
+eer_hal_status_t avr_timer_unregister_callback(eer_timer_event_t event, uint8_t channel) {
+    return avr_timer_instance_unregister_callback(&timer1, event, channel);
 }
 
-// Timer1 Compare A ISR
-ISR(TIMER1_COMPA_vect) {
-    if (timer_callbacks.compare_a_handler != NULL) {
+eer_hal_status_t avr_timer_set_capture_edge(bool rising) {
+    return avr_timer_instance_set_capture_edge(&timer1, rising);
+}
+
+/**
+ * @brief Overflow interrupt of a 16-bit timer
+ * @param index Timer number
+ */
+static inline void timer_overflow_isr(uint8_t index) {
+    eer_timer_t* instance = timer_instances[index];
+    
+    eer_trace_isr(EER_TRACE_TIMER_OVERFLOW, index);
+    
+    // The overflow interrupt may be enabled as a wakeup source only
+    avr_power_wakeup(EER_WAKEUP_TIMER, index);
+    
+    if (instance == NULL) {
+        return;
+    }
+    
+    if (instance->overflow_handler != NULL) {
         eer_timer_event_info_t event = {
-            .timer = &timer1,
-            .event = EER_TIMER_EVENT_COMPARE,
-            .value = *timer1.ocra,
-            .user_data = timer_callbacks.compare_a_user_data
+            .timer = instance,
+            .event = EER_TIMER_EVENT_OVERFLOW,
+            .value = 0,  // Overflow means the counter wrapped to 0
+            .user_data = instance->overflow_user_data
         };
         
-        timer_callbacks.compare_a_handler(&event);
+        instance->overflow_handler(&event);
     }
     
     // If in one-shot mode, stop the timer
-    if (current_config.mode == EER_TIMER_MODE_ONE_SHOT) {
-        *timer1.tccrb &= ~((1 << CS12) | (1 << CS11) | (1 << CS10));
+    if (instance->config.mode == EER_TIMER_MODE_ONE_SHOT) {
+        *instance->tccrb &= ~TIMER_CLOCK_MASK;
     }
 }
 
-// Timer1 Compare B ISR
-ISR(TIMER1_COMPB_vect) {
-    if (timer_callbacks.compare_b_handler != NULL) {
+/**
+ * @brief Compare match interrupt of a 16-bit timer
+ * @param index Timer number
+ * @param channel Compare channel, 0 for A and 1 for B
+ */
+static inline void timer_compare_isr(uint8_t index, uint8_t channel) {
+    eer_timer_t* instance = timer_instances[index];
+    
+    eer_trace_isr(EER_TRACE_TIMER_COMPARE, (uint16_t)index << 8 | channel);
+    
+    if (instance->compare_handler[channel] != NULL) {
         eer_timer_event_info_t event = {
-            .timer = &timer1,
+            .timer = instance,
             .event = EER_TIMER_EVENT_COMPARE,
-            .value = *timer1.ocrb,
-            .user_data = timer_callbacks.compare_b_user_data
+            .value = channel == 0 ? *instance->ocra : *instance->ocrb,
+            .user_data = instance->compare_user_data[channel]
         };
         
-        timer_callbacks.compare_b_handler(&event);
+        instance->compare_handler[channel](&event);
+    }
+    
+    // If in one-shot mode, compare A ends the shot
+    if (channel == 0 && instance->config.mode == EER_TIMER_MODE_ONE_SHOT) {
+        *instance->tccrb &= ~TIMER_CLOCK_MASK;
     }
 }
 
-// Timer1 Capture ISR
-ISR(TIMER1_CAPT_vect) {
-    if (timer_callbacks.capture_handler != NULL) {
+/**
+ * @brief Input capture interrupt of a 16-bit timer
+ * @param index Timer number
+ */
+static inline void timer_capture_isr(uint8_t index) {
+    eer_timer_t* instance = timer_instances[index];
+    
+    eer_trace_isr(EER_TRACE_TIMER_CAPTURE, *instance->icr);
+    
+    if (instance->capture_handler != NULL) {
         eer_timer_event_info_t event = {
-            .timer = &timer1,
+            .timer = instance,
             .event = EER_TIMER_EVENT_CAPTURE,
-            .value = *timer1.icr,
-            .user_data = timer_callbacks.capture_user_data
+            .value = *instance->icr,
+            .user_data = instance->capture_user_data
         };
         
-        timer_callbacks.capture_handler(&event);
+        instance->capture_handler(&event);
     }
 }
 
+// Interrupt vectors of each 16-bit timer
+#define TIMER_VECTORS(n)                                                       \
+    ISR(TIMER##n##_OVF_vect) {                                                 \
+        timer_overflow_isr(n);                                                 \
+    }                                                                          \
+    ISR(TIMER##n##_COMPA_vect) {                                               \
+        timer_compare_isr(n, 0);                                               \
+    }                                                                          \
+    ISR(TIMER##n##_COMPB_vect) {                                               \
+        timer_compare_isr(n, 1);                                               \
+    }                                                                          \
+    ISR(TIMER##n##_CAPT_vect) {                                                \
+        timer_capture_isr(n);                                                  \
+    }
+
+TIMER_VECTORS(1)
+
+#if EER_AVR_TIMER_MASK & (1 << 3)
+TIMER_VECTORS(3)
+#endif
+
+#if EER_AVR_TIMER_MASK & (1 << 4)
+TIMER_VECTORS(4)
+#endif
+
+#if EER_AVR_TIMER_MASK & (1 << 5)
+TIMER_VECTORS(5)
+#endif
+
 // Timer handler structure with function pointers
 eer_timer_handler_t eer_avr_timer = {
     .init = avr_timer_init,
@@ -349,5 +507,23 @@ eer_timer_handler_t eer_avr_timer = {
     .us_to_ticks = avr_timer_us_to_ticks,
     .ticks_to_us = avr_timer_ticks_to_us,
     .register_callback = avr_timer_register_callback,
-    .unregister_callback = avr_timer_unregister_callback
+    .unregister_callback = avr_timer_unregister_callback,
+    .set_capture_edge = avr_timer_set_capture_edge
+};
+
+// Timer instance handler structure with function pointers
+eer_timer_instance_handler_t eer_avr_timer_instance = {
+    .init = avr_timer_instance_init,
+    .deinit = avr_timer_instance_deinit,
+    .start = avr_timer_instance_start,
+    .stop = avr_timer_instance_stop,
+    .set_period = avr_timer_instance_set_period,
+    .get_value = avr_timer_instance_get_value,
+    .set_compare = avr_timer_instance_set_compare,
+    .set_pwm_duty_cycle = avr_timer_instance_set_pwm_duty_cycle,
+    .us_to_ticks = avr_timer_instance_us_to_ticks,
+    .ticks_to_us = avr_timer_instance_ticks_to_us,
+    .register_callback = avr_timer_instance_register_callback,
+    .unregister_callback = avr_timer_instance_unregister_callback,
+    .set_capture_edge = avr_timer_instance_set_capture_edge
 };
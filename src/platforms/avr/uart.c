@@ -1,280 +1,543 @@
 #include "platforms/avr/uart.h"
+#include "platforms/avr/progmem.h"
+#include "platforms/avr/system.h"
 #include "macros.h"
+#include "eer_trace.h"
 #include <stddef.h>
 #include <avr/io.h>
 #include <avr/interrupt.h>
 
 // Default UART instance for AVR
-static eer_uart_t uart0 = eer_hal_uart0();
+static eer_uart_t uart_default = eer_hal_uart_default();
 
-// Callback handlers and user data
-static struct {
-    eer_uart_rx_handler_t rx_handler;
-    void* rx_user_data;
-    eer_uart_tx_handler_t tx_handler;
-    void* tx_user_data;
-} uart_callbacks = {0};
+// Initialized instance of each USART, served by its interrupt vectors
+static eer_uart_t* uart_instances[EER_AVR_UARTS] = { [EER_AVR_UART_DEFAULT] = &uart_default };
 
-// Buffer for interrupt-driven reception
-static uint8_t rx_buffer[64];
-static volatile uint8_t rx_head = 0;
-static volatile uint8_t rx_tail = 0;
-
-/**
- * @brief Calculate UBRR value for the given baud rate
- * @param baudrate Desired baud rate
- * @return UBRR value
- */
-static uint16_t uart_calculate_ubrr(uint32_t baudrate) {
-    return (((F_CPU) + 4UL * (baudrate)) / (8UL * (baudrate)) - 1UL);
-}
-
-static eer_hal_status_t avr_uart_init(eer_uart_config_t* config) {
+eer_hal_status_t avr_uart_instance_init(void* uart, eer_uart_config_t* config) {
     if (config == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
     
-    // Calculate baud rate register value
-    uint16_t ubrr = uart_calculate_ubrr(config->baudrate);
+    return avr_uart_instance_init_registers(uart, avr_uart_registers(config));
+}
+
+eer_hal_status_t avr_uart_instance_init_registers(void* uart, avr_uart_registers_t registers) {
+    eer_uart_t* instance = (eer_uart_t*)uart;
+    
+    if (instance == NULL || instance->index >= EER_AVR_UARTS) {
+        return EER_HAL_INVALID_PARAM;
+    }
     
     // Set baud rate
-    *uart0.ubrrh = (uint8_t)(ubrr >> 8);
-    *uart0.ubrrl = (uint8_t)ubrr;
+    *instance->ubrrh = (uint8_t)(registers.ubrr >> 8);
+    *instance->ubrrl = (uint8_t)registers.ubrr;
     
     // Enable double speed mode
-    bit_set(*uart0.ucsra, U2X0);
+    bit_set(*instance->ucsra, U2X0);
     
     // Set frame format: data bits, parity, stop bits
-    uint8_t ucsrc_value = 0;
-    
-    // Set data bits
-    switch (config->data_bits) {
-        case EER_UART_DATA_BITS_5:
-            // 5 data bits (000)
-            break;
-        case EER_UART_DATA_BITS_6:
-            // 6 data bits (001)
-            ucsrc_value |= (1 << UCSZ00);
-            break;
-        case EER_UART_DATA_BITS_7:
-            // 7 data bits (010)
-            ucsrc_value |= (1 << UCSZ01);
-            break;
-        case EER_UART_DATA_BITS_9:
-            // 9 data bits (111)
-            ucsrc_value |= (1 << UCSZ02) | (1 << UCSZ01) | (1 << UCSZ00);
-            break;
-        case EER_UART_DATA_BITS_8:
-        default:
-            // 8 data bits (011)
-            ucsrc_value |= (1 << UCSZ01) | (1 << UCSZ00);
-            break;
-    }
-    
-    // Set parity
-    switch (config->parity) {
-        case EER_UART_PARITY_EVEN:
-            ucsrc_value |= (1 << UPM01);
-            break;
-        case EER_UART_PARITY_ODD:
-            ucsrc_value |= (1 << UPM01) | (1 << UPM00);
-            break;
-        case EER_UART_PARITY_NONE:
-        default:
-            // No parity is default
-            break;
-    }
-    
-    // Set stop bits
-    if (config->stop_bits == EER_UART_STOP_BITS_2) {
-        ucsrc_value |= (1 << USBS0);
-    }
-    
-    // Apply UCSRC settings
-    *uart0.ucsrc = ucsrc_value;
+    *instance->ucsrc = registers.ucsrc;
     
     // Enable receiver and transmitter
-    *uart0.ucsrb = (1 << RXEN0) | (1 << TXEN0);
+    *instance->ucsrb = (1 << RXEN0) | (1 << TXEN0);
     
     // Reset buffer indices
-    rx_head = 0;
-    rx_tail = 0;
+    instance->rx_head = 0;
+    instance->rx_tail = 0;
+    
+    // Route the interrupts of this USART to the instance
+    uart_instances[instance->index] = instance;
     
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_uart_deinit(void) {
+eer_hal_status_t avr_uart_instance_deinit(void* uart) {
+    eer_uart_t* instance = (eer_uart_t*)uart;
+    
+    if (instance == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
     // Disable receiver and transmitter
-    *uart0.ucsrb = 0;
+    *instance->ucsrb = 0;
+    
+    eer_async_cancel(&instance->async, EER_HAL_ERROR);
     
     // Clear callback handlers
-    uart_callbacks.rx_handler = NULL;
-    uart_callbacks.rx_user_data = NULL;
-    uart_callbacks.tx_handler = NULL;
-    uart_callbacks.tx_user_data = NULL;
+    instance->rx_handler = NULL;
+    instance->rx_user_data = NULL;
+    instance->tx_handler = NULL;
+    instance->tx_user_data = NULL;
     
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_uart_transmit(const uint8_t* data, uint16_t size, uint32_t timeout) {
-    if (data == NULL || size == 0) {
+/**
+ * @brief Wait for a flag of UCSRnA
+ *
+ * The timeout runs on the system tick, so it only expires once
+ * avr_system_init() has started it.
+ *
+ * @param start System tick at the start of the call
+ * @param timeout Milliseconds from start, 0 to not wait
+ * @return false if the flag did not set in time
+ */
+static bool uart_wait(const eer_uart_t* instance, uint8_t flag, uint32_t start, uint32_t timeout) {
+    while (!(*instance->ucsra & (1 << flag))) {
+        if (timeout == 0) {
+            return false;
+        }
+        
+        uint32_t now = 0;
+        avr_system_get_tick(&now);
+        if (now - start >= timeout) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+/**
+ * @brief Send bytes from RAM or flash, polling the data register
+ *
+ * Always inlined, so the RAM variant keeps its plain loads.
+ */
+static inline __attribute__((always_inline))
+eer_hal_status_t uart_transmit(eer_uart_t* instance, const uint8_t* data, uint16_t size, uint32_t timeout, bool flash) {
+    if (instance == NULL || data == NULL || size == 0) {
         return EER_HAL_INVALID_PARAM;
     }
     
-    uint32_t start_time = 0; // In a real implementation, get current time
+    if (instance->async.head != NULL) {
+        return EER_HAL_BUSY;
+    }
+    
+    eer_trace(EER_TRACE_UART_TRANSMIT, size);
+    
+    uint32_t start_time = 0;
+    avr_system_get_tick(&start_time);
     
     for (uint16_t i = 0; i < size; i++) {
-        // Wait for transmit buffer to be empty
-        while (!(*uart0.ucsra & (1 << UDRE0))) {
-            if (timeout > 0) {
-                uint32_t current_time = 0; // In a real implementation, get current time
-                if ((current_time - start_time) >= timeout) {
-                    return EER_HAL_TIMEOUT;
-                }
-            }
+        // Wait for transmit buffer to be empty; non-blocking sends only what fits
+        if (!uart_wait(instance, UDRE0, start_time, timeout)) {
+            return EER_HAL_TIMEOUT;
         }
         
-        // Send data
-        *uart0.udr = data[i];
+        // Clear TXC alone, so that it flags the end of this frame, then send data
+        *instance->ucsra = (*instance->ucsra & ((1 << U2X0) | (1 << MPCM0))) | (1 << TXC0);
+        *instance->udr = avr_progmem_byte(data, i, flash);
+        instance->tx_written = true;
     }
     
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_uart_receive(uint8_t* data, uint16_t size, uint32_t timeout) {
-    if (data == NULL || size == 0) {
+eer_hal_status_t avr_uart_instance_transmit(void* uart, const uint8_t* data, uint16_t size, uint32_t timeout) {
+    return uart_transmit((eer_uart_t*)uart, data, size, timeout, false);
+}
+
+eer_hal_status_t avr_uart_instance_transmit_P(void* uart, const uint8_t* data, uint16_t size, uint32_t timeout) {
+    return uart_transmit((eer_uart_t*)uart, data, size, timeout, true);
+}
+
+eer_hal_status_t avr_uart_instance_receive(void* uart, uint8_t* data, uint16_t size, uint32_t timeout) {
+    eer_uart_t* instance = (eer_uart_t*)uart;
+    
+    if (instance == NULL || data == NULL || size == 0) {
         return EER_HAL_INVALID_PARAM;
     }
     
-    uint32_t start_time = 0; // In a real implementation, get current time
+    if (instance->async.head != NULL) {
+        return EER_HAL_BUSY;
+    }
+    
+    eer_trace(EER_TRACE_UART_RECEIVE, size);
+    
+    uint32_t start_time = 0;
+    avr_system_get_tick(&start_time);
     
     for (uint16_t i = 0; i < size; i++) {
-        // Wait for data to be received
-        while (!(*uart0.ucsra & (1 << RXC0))) {
-            if (timeout > 0) {
-                uint32_t current_time = 0; // In a real implementation, get current time
-                if ((current_time - start_time) >= timeout) {
-                    return EER_HAL_TIMEOUT;
-                }
-            }
+        // Wait for data to be received; non-blocking reads only what arrived
+        if (!uart_wait(instance, RXC0, start_time, timeout)) {
+            return EER_HAL_TIMEOUT;
         }
         
         // Get received data
-        data[i] = *uart0.udr;
+        data[i] = *instance->udr;
     }
     
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_uart_is_tx_ready(bool* ready) {
-    if (ready == NULL) {
+eer_hal_status_t avr_uart_flush(void) {
+    // Nothing to wait for while the transmitter is off or was never used
+    if (!(*uart_default.ucsrb & (1 << TXEN0)) || !uart_default.tx_written) {
+        return EER_HAL_OK;
+    }
+    
+    // Wait for the data register to empty and the last frame to shift out
+    while (!(*uart_default.ucsra & (1 << UDRE0)) || !(*uart_default.ucsra & (1 << TXC0)));
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t avr_uart_instance_is_tx_ready(void* uart, bool* ready) {
+    eer_uart_t* instance = (eer_uart_t*)uart;
+    
+    if (instance == NULL || ready == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
     
-    *ready = (*uart0.ucsra & (1 << UDRE0)) != 0;
+    *ready = (*instance->ucsra & (1 << UDRE0)) != 0;
     
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_uart_is_rx_ready(bool* ready) {
-    if (ready == NULL) {
+eer_hal_status_t avr_uart_instance_is_rx_ready(void* uart, bool* ready) {
+    eer_uart_t* instance = (eer_uart_t*)uart;
+    
+    if (instance == NULL || ready == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
     
-    *ready = (*uart0.ucsra & (1 << RXC0)) != 0;
+    *ready = (*instance->ucsra & (1 << RXC0)) != 0;
     
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_uart_register_rx_callback(eer_uart_rx_handler_t handler, void* user_data) {
-    if (handler == NULL) {
+eer_hal_status_t avr_uart_instance_register_rx_callback(void* uart, eer_uart_rx_handler_t handler, void* user_data) {
+    eer_uart_t* instance = (eer_uart_t*)uart;
+    
+    if (instance == NULL || handler == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
     
     // Store the handler and user data
-    uart_callbacks.rx_handler = handler;
-    uart_callbacks.rx_user_data = user_data;
+    instance->rx_handler = handler;
+    instance->rx_user_data = user_data;
     
     // Enable receive complete interrupt
-    *uart0.ucsrb |= (1 << RXCIE0);
+    *instance->ucsrb |= (1 << RXCIE0);
     
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_uart_unregister_rx_callback(void) {
+eer_hal_status_t avr_uart_instance_unregister_rx_callback(void* uart) {
+    eer_uart_t* instance = (eer_uart_t*)uart;
+    
+    if (instance == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
     // Clear the handler and user data
-    uart_callbacks.rx_handler = NULL;
-    uart_callbacks.rx_user_data = NULL;
+    instance->rx_handler = NULL;
+    instance->rx_user_data = NULL;
     
-    // Disable receive complete interrupt
-    *uart0.ucsrb &= ~(1 << RXCIE0);
+    // Disable receive complete interrupt unless a request is receiving
+    if (instance->async.head == NULL) {
+        *instance->ucsrb &= ~(1 << RXCIE0);
+    }
     
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_uart_register_tx_callback(eer_uart_tx_handler_t handler, void* user_data) {
-    if (handler == NULL) {
+eer_hal_status_t avr_uart_instance_register_tx_callback(void* uart, eer_uart_tx_handler_t handler, void* user_data) {
+    eer_uart_t* instance = (eer_uart_t*)uart;
+    
+    if (instance == NULL || handler == NULL) {
         return EER_HAL_INVALID_PARAM;
     }
     
     // Store the handler and user data
-    uart_callbacks.tx_handler = handler;
-    uart_callbacks.tx_user_data = user_data;
+    instance->tx_handler = handler;
+    instance->tx_user_data = user_data;
     
     // Enable transmit complete interrupt
-    *uart0.ucsrb |= (1 << TXCIE0);
+    *instance->ucsrb |= (1 << TXCIE0);
     
     return EER_HAL_OK;
 }
 
-static eer_hal_status_t avr_uart_unregister_tx_callback(void) {
+eer_hal_status_t avr_uart_instance_unregister_tx_callback(void* uart) {
+    eer_uart_t* instance = (eer_uart_t*)uart;
+    
+    if (instance == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
     // Clear the handler and user data
-    uart_callbacks.tx_handler = NULL;
-    uart_callbacks.tx_user_data = NULL;
+    instance->tx_handler = NULL;
+    instance->tx_user_data = NULL;
     
     // Disable transmit complete interrupt
-    *uart0.ucsrb &= ~(1 << TXCIE0);
+    *instance->ucsrb &= ~(1 << TXCIE0);
+    
+    return EER_HAL_OK;
+}
+
+/**
+ * @brief Run the receive part of the running request
+ *
+ * Takes the bytes already buffered, then leaves the rest to the receive
+ * interrupt. Called with interrupts disabled.
+ *
+ * @return true if the request has all its bytes
+ */
+static bool uart_async_receive(eer_uart_t* instance, eer_async_request_t* request) {
+    while (request->index < request->tx_size + request->rx_size
+           && instance->rx_tail != instance->rx_head) {
+        request->rx_data[request->index++ - request->tx_size] = instance->rx_buffer[instance->rx_tail];
+        instance->rx_tail = (instance->rx_tail + 1) % EER_AVR_UART_RX_SIZE;
+    }
+    
+    if (request->index == request->tx_size + request->rx_size) {
+        return true;
+    }
+    
+    *instance->ucsrb |= (1 << RXCIE0);
+    
+    return false;
+}
+
+/**
+ * @brief Start requests until one is left running
+ *
+ * Called with interrupts disabled, from submit or from the interrupt that
+ * finished the previous request.
+ */
+static void uart_async_start(eer_uart_t* instance) {
+    eer_async_request_t* request;
+    
+    while ((request = instance->async.head) != NULL) {
+        // The data register empty interrupt sends the bytes
+        if (request->tx_size > 0) {
+            *instance->ucsrb |= (1 << UDRIE0);
+            return;
+        }
+        
+        if (!uart_async_receive(instance, request)) {
+            return;
+        }
+        
+        // Served from the buffer already
+        eer_async_dequeue(&instance->async);
+        eer_async_complete(request, EER_HAL_OK);
+    }
+}
+
+/**
+ * @brief Finish the running request and start the next one
+ */
+static void uart_async_finish(eer_uart_t* instance) {
+    eer_async_request_t* request = instance->async.head;
+    
+    eer_async_dequeue(&instance->async);
+    
+    // Received bytes go back to the buffer and the callback
+    if (instance->rx_handler == NULL) {
+        *instance->ucsrb &= ~(1 << RXCIE0);
+    }
+    
+    uart_async_start(instance);
+    eer_async_complete(request, EER_HAL_OK);
+}
+
+eer_hal_status_t avr_uart_submit(eer_async_request_t* request) {
+    eer_uart_t* instance = request != NULL && request->device != NULL ? (eer_uart_t*)request->device : &uart_default;
+    
+    eer_hal_status_t status = eer_async_prepare(request);
+    if (status != EER_HAL_OK) {
+        return status;
+    }
+    
+    eer_trace(request->tx_size > 0 ? EER_TRACE_UART_TRANSMIT : EER_TRACE_UART_RECEIVE,
+              request->tx_size > 0 ? request->tx_size : request->rx_size);
+              
+    uint8_t sreg = SREG;
+    cli();
+    if (eer_async_enqueue(&instance->async, request)) {
+        uart_async_start(instance);
+    }
+    SREG = sreg;
     
     return EER_HAL_OK;
 }
 
-// UART Receive Complete ISR - dedicated to UART module
-ISR(USART_RX_vect) {
-    uint8_t data = UDR0;
+// Single-instance operations on the default UART
+eer_hal_status_t avr_uart_init(eer_uart_config_t* config) {
+    return avr_uart_instance_init(&uart_default, config);
+}
+
+eer_hal_status_t avr_uart_init_registers(avr_uart_registers_t registers) {
+    return avr_uart_instance_init_registers(&uart_default, registers);
+}
+
+eer_hal_status_t avr_uart_deinit(void) {
+    return avr_uart_instance_deinit(&uart_default);
+}
+
+eer_hal_status_t avr_uart_transmit(const uint8_t* data, uint16_t size, uint32_t timeout) {
+    return avr_uart_instance_transmit(&uart_default, data, size, timeout);
+}
+
+eer_hal_status_t avr_uart_transmit_P(const uint8_t* data, uint16_t size, uint32_t timeout) {
+    return avr_uart_instance_transmit_P(&uart_default, data, size, timeout);
+}
+
+eer_hal_status_t avr_uart_receive(uint8_t* data, uint16_t size, uint32_t timeout) {
+    return avr_uart_instance_receive(&uart_default, data, size, timeout);
+}
+
+eer_hal_status_t avr_uart_is_tx_ready(bool* ready) {
+    return avr_uart_instance_is_tx_ready(&uart_default, ready);
+}
+
+eer_hal_status_t avr_uart_is_rx_ready(bool* ready) {
+    return avr_uart_instance_is_rx_ready(&uart_default, ready);
+}
+
+eer_hal_status_t avr_uart_register_rx_callback(eer_uart_rx_handler_t handler, void* user_data) {
+    return avr_uart_instance_register_rx_callback(&uart_default, handler, user_data);
+}
+
+eer_hal_status_t avr_uart_unregister_rx_callback(void) {
+    return avr_uart_instance_unregister_rx_callback(&uart_default);
+}
+
+eer_hal_status_t avr_uart_register_tx_callback(eer_uart_tx_handler_t handler, void* user_data) {
+    return avr_uart_instance_register_tx_callback(&uart_default, handler, user_data);
+}
+
+eer_hal_status_t avr_uart_unregister_tx_callback(void) {
+    return avr_uart_instance_unregister_tx_callback(&uart_default);
+}
+
+/**
+ * @brief Receive complete interrupt of a USART
+ * @param index USART number
+ */
+static inline void uart_rx_isr(uint8_t index) {
+    eer_uart_t* instance = uart_instances[index];
+    
+    // Status has to be read before the data register
+    uint8_t status = *instance->ucsra;
+    uint8_t data = *instance->udr;
+    
+    eer_trace_isr(EER_TRACE_UART_RX_IRQ, (uint16_t)index << 8 | data);
+    
+    // Drop frames with a framing error, such as the byte whose start bit
+    // woke the MCU from power-down before the USART was clocked again
+    if (status & (1 << FE0)) {
+        return;
+    }
+    
+    // A request past its transmit part takes the byte
+    eer_async_request_t* request = instance->async.head;
+    if (request != NULL && request->index >= request->tx_size) {
+        request->rx_data[request->index++ - request->tx_size] = data;
+        if (request->index == request->tx_size + request->rx_size) {
+            uart_async_finish(instance);
+        }
+        return;
+    }
     
     // Store received byte in buffer
-    uint8_t next_head = (rx_head + 1) % sizeof(rx_buffer);
-    if (next_head != rx_tail) {
-        rx_buffer[rx_head] = data;
-        rx_head = next_head;
+    uint8_t* stored = &data;
+    uint8_t next_head = (instance->rx_head + 1) % EER_AVR_UART_RX_SIZE;
+    if (next_head != instance->rx_tail) {
+        stored = &instance->rx_buffer[instance->rx_head];
+        *stored = data;
+        instance->rx_head = next_head;
     }
     
     // Call the handler if registered
-    if (uart_callbacks.rx_handler != NULL) {
+    if (instance->rx_handler != NULL) {
         eer_uart_rx_event_t event = {
-            .uart = &uart0,
-            .data = &rx_buffer[rx_head - 1],
+            .uart = instance,
+            .data = stored,
             .size = 1,
-            .user_data = uart_callbacks.rx_user_data
+            .user_data = instance->rx_user_data
         };
         
-        uart_callbacks.rx_handler(&event);
+        instance->rx_handler(&event);
     }
 }
 
-// UART Transmit Complete ISR - dedicated to UART module
-ISR(USART_TX_vect) {
+/**
+ * @brief Transmit complete interrupt of a USART
+ * @param index USART number
+ */
+static inline void uart_tx_isr(uint8_t index) {
+    eer_uart_t* instance = uart_instances[index];
+    
+    eer_trace_isr(EER_TRACE_UART_TX_IRQ, index);
+    
     // Call the handler if registered
-    if (uart_callbacks.tx_handler != NULL) {
+    if (instance->tx_handler != NULL) {
         eer_uart_tx_event_t event = {
-            .uart = &uart0,
-            .user_data = uart_callbacks.tx_user_data
+            .uart = instance,
+            .user_data = instance->tx_user_data
         };
         
-        uart_callbacks.tx_handler(&event);
+        instance->tx_handler(&event);
     }
 }
 
+/**
+ * @brief Data register empty interrupt of a USART, enabled while a request
+ *        transmits
+ * @param index USART number
+ */
+static inline void uart_udre_isr(uint8_t index) {
+    eer_uart_t* instance = uart_instances[index];
+    eer_async_request_t* request = instance->async.head;
+    
+    // Clear TXC alone, so that it flags the end of this frame, then send data
+    *instance->ucsra = (*instance->ucsra & ((1 << U2X0) | (1 << MPCM0))) | (1 << TXC0);
+    *instance->udr = avr_async_tx_byte(request, request->index++);
+    instance->tx_written = true;
+    
+    if (request->index < request->tx_size) {
+        return;
+    }
+    
+    // Last byte loaded, go on with the receive part
+    *instance->ucsrb &= ~(1 << UDRIE0);
+    
+    if (request->rx_size == 0 || uart_async_receive(instance, request)) {
+        uart_async_finish(instance);
+    }
+}
+
+// Interrupt vectors of each USART, named by the MCU descriptor
+#define UART_VECTORS(n)                                                        \
+    ISR(EER_AVR_UART##n##_RX_vect) {                                           \
+        uart_rx_isr(n);                                                        \
+    }                                                                          \
+    ISR(EER_AVR_UART##n##_TX_vect) {                                           \
+        uart_tx_isr(n);                                                        \
+    }                                                                          \
+    ISR(EER_AVR_UART##n##_UDRE_vect) {                                         \
+        uart_udre_isr(n);                                                      \
+    }
+
+#if EER_AVR_UART_MASK & (1 << 0)
+UART_VECTORS(0)
+#endif
+
+#if EER_AVR_UART_MASK & (1 << 1)
+UART_VECTORS(1)
+#endif
+
+#if EER_AVR_UART_MASK & (1 << 2)
+UART_VECTORS(2)
+#endif
+
+#if EER_AVR_UART_MASK & (1 << 3)
+UART_VECTORS(3)
+#endif
+
 // UART handler structure with function pointers
 eer_uart_handler_t eer_avr_uart = {
     .init = avr_uart_init,
@@ -286,5 +549,20 @@ eer_uart_handler_t eer_avr_uart = {
     .register_rx_callback = avr_uart_register_rx_callback,
     .unregister_rx_callback = avr_uart_unregister_rx_callback,
     .register_tx_callback = avr_uart_register_tx_callback,
-    .unregister_tx_callback = avr_uart_unregister_tx_callback
+    .unregister_tx_callback = avr_uart_unregister_tx_callback,
+    .submit = avr_uart_submit
+};
+
+// UART instance handler structure with function pointers
+eer_uart_instance_handler_t eer_avr_uart_instance = {
+    .init = avr_uart_instance_init,
+    .deinit = avr_uart_instance_deinit,
+    .transmit = avr_uart_instance_transmit,
+    .receive = avr_uart_instance_receive,
+    .is_tx_ready = avr_uart_instance_is_tx_ready,
+    .is_rx_ready = avr_uart_instance_is_rx_ready,
+    .register_rx_callback = avr_uart_instance_register_rx_callback,
+    .unregister_rx_callback = avr_uart_instance_unregister_rx_callback,
+    .register_tx_callback = avr_uart_instance_register_tx_callback,
+    .unregister_tx_callback = avr_uart_instance_unregister_tx_callback
 };
@@ -0,0 +1,216 @@
+#include "platforms/host/adc.h"
+#include "eer_trace.h"
+#include <stddef.h>
+
+// Raw values presented on each channel
+static uint16_t adc_values[EER_HOST_ADC_CHANNELS];
+
+// Array to store interrupt handlers and user data for each ADC channel
+static struct {
+    eer_adc_conversion_complete_handler_t handler;
+    void* user_data;
+} adc_irq_handlers[EER_HOST_ADC_CHANNELS] = {0};
+
+// Current configuration and conversion state
+static eer_adc_config_t current_config = {0};
+static uint8_t adc_channel = 0;
+static bool adc_converting = false;
+
+static uint16_t adc_max_value(void) {
+    switch (current_config.resolution) {
+        case EER_ADC_RESOLUTION_8BIT:
+            return 0xFF;
+        case EER_ADC_RESOLUTION_12BIT:
+            return 0x0FFF;
+        case EER_ADC_RESOLUTION_16BIT:
+            return 0xFFFF;
+        case EER_ADC_RESOLUTION_10BIT:
+        default:
+            return 0x03FF;
+    }
+}
+
+static uint16_t adc_result(uint8_t channel) {
+    uint16_t max = adc_max_value();
+    
+    return adc_values[channel] > max ? max : adc_values[channel];
+}
+
+void host_adc_set_value(uint8_t channel, uint16_t value) {
+    if (channel < EER_HOST_ADC_CHANNELS) {
+        adc_values[channel] = value;
+    }
+}
+
+void host_adc_poll(void) {
+    // A started conversion completes on the next dispatch
+    if (!adc_converting) {
+        return;
+    }
+    
+    adc_converting = false;
+    
+    eer_trace_isr(EER_TRACE_ADC_COMPLETE, adc_result(adc_channel));
+    
+    if (adc_irq_handlers[adc_channel].handler != NULL) {
+        eer_adc_conversion_t conversion = {
+            .channel = &(eer_adc_channel_t){adc_channel},
+            .value = adc_result(adc_channel),
+            .user_data = adc_irq_handlers[adc_channel].user_data
+        };
+        
+        adc_irq_handlers[adc_channel].handler(&conversion);
+        
+        // In continuous mode, start the next conversion
+        if (current_config.mode == EER_ADC_MODE_CONTINUOUS) {
+            adc_converting = true;
+        }
+    }
+}
+
+eer_hal_status_t host_adc_init(eer_adc_config_t* config) {
+    if (config == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    current_config = *config;
+    adc_converting = false;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_adc_deinit(void) {
+    adc_converting = false;
+    
+    for (int i = 0; i < EER_HOST_ADC_CHANNELS; i++) {
+        adc_irq_handlers[i].handler = NULL;
+        adc_irq_handlers[i].user_data = NULL;
+    }
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_adc_start_conversion(void* channel) {
+    if (channel == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_adc_channel_t* adc = (eer_adc_channel_t*)channel;
+    if (adc->channel >= EER_HOST_ADC_CHANNELS) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_trace(EER_TRACE_ADC_START, adc->channel);
+    
+    adc_channel = adc->channel;
+    adc_converting = true;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_adc_stop_conversion(void) {
+    adc_converting = false;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_adc_is_conversion_complete(void* channel, bool* complete) {
+    if (channel == NULL || complete == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    host_poll();
+    
+    *complete = !adc_converting;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_adc_read(void* channel, uint16_t* value) {
+    if (channel == NULL || value == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_adc_channel_t* adc = (eer_adc_channel_t*)channel;
+    if (adc->channel >= EER_HOST_ADC_CHANNELS) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_trace(EER_TRACE_ADC_START, adc->channel);
+    
+    // Blocking conversion
+    *value = adc_result(adc->channel);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_adc_read_voltage(void* channel, float* voltage) {
+    if (channel == NULL || voltage == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    uint16_t raw_value;
+    eer_hal_status_t status = host_adc_read(channel, &raw_value);
+    
+    if (status != EER_HAL_OK) {
+        return status;
+    }
+    
+    float reference_voltage = EER_HOST_VCC_MV / 1000.0f;
+    if (current_config.reference == EER_ADC_REF_INTERNAL) {
+        reference_voltage = 1.1f;
+    }
+    
+    *voltage = (raw_value * reference_voltage) / adc_max_value();
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_adc_register_callback(void* channel,
+                                                  eer_adc_conversion_complete_handler_t handler,
+                                                  void* user_data) {
+    if (channel == NULL || handler == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_adc_channel_t* adc = (eer_adc_channel_t*)channel;
+    if (adc->channel >= EER_HOST_ADC_CHANNELS) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Store the handler and user data
+    adc_irq_handlers[adc->channel].handler = handler;
+    adc_irq_handlers[adc->channel].user_data = user_data;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_adc_unregister_callback(void* channel) {
+    if (channel == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_adc_channel_t* adc = (eer_adc_channel_t*)channel;
+    if (adc->channel >= EER_HOST_ADC_CHANNELS) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Clear the handler and user data
+    adc_irq_handlers[adc->channel].handler = NULL;
+    adc_irq_handlers[adc->channel].user_data = NULL;
+    
+    return EER_HAL_OK;
+}
+
+// ADC handler structure with function pointers
+eer_adc_handler_t eer_host_adc = {
+    .init = host_adc_init,
+    .deinit = host_adc_deinit,
+    .start_conversion = host_adc_start_conversion,
+    .stop_conversion = host_adc_stop_conversion,
+    .is_conversion_complete = host_adc_is_conversion_complete,
+    .read = host_adc_read,
+    .read_voltage = host_adc_read_voltage,
+    .register_callback = host_adc_register_callback,
+    .unregister_callback = host_adc_unregister_callback
+};
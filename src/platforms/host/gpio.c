@@ -0,0 +1,241 @@
+#include "platforms/host/gpio.h"
+#include "eer_trace.h"
+#include <stddef.h>
+#include <string.h>
+
+// Simulated pin table
+static host_gpio_pin_state_t gpio_pins[EER_HOST_PORTS * 8];
+
+// Array to store interrupt handlers and user data for each pin
+static struct {
+    eer_gpio_irq_handler_t handler;
+    void* user_data;
+    eer_pin_t pin;
+} gpio_irq_handlers[EER_HOST_PORTS * 8] = {0};
+
+static int gpio_index(void* pin) {
+    eer_pin_t* host_pin = (eer_pin_t*)pin;
+    
+    if (host_pin == NULL || host_pin->port >= EER_HOST_PORTS || host_pin->number > 7) {
+        return -1;
+    }
+    
+    return host_pin->port * 8 + host_pin->number;
+}
+
+/**
+ * @brief Level seen on a pin
+ */
+static bool gpio_level(host_gpio_pin_state_t* state) {
+    switch (state->mode) {
+        case EER_GPIO_MODE_OUTPUT:
+        case EER_GPIO_MODE_ALTERNATE:
+            return state->output;
+            
+        case EER_GPIO_MODE_OUTPUT_OD:
+        case EER_GPIO_MODE_ALTERNATE_OD:
+            // Open drain only pulls low, anything may pull low as well
+            return state->output && (!state->driven || state->input);
+            
+        case EER_GPIO_MODE_INPUT_PULLUP:
+            return state->driven ? state->input : true;
+            
+        default:
+            return state->driven ? state->input : false;
+    }
+}
+
+/**
+ * @brief Latch an interrupt if a level change matches the trigger
+ */
+static void gpio_edge(host_gpio_pin_state_t* state, bool before) {
+    bool after = gpio_level(state);
+    
+    if (before == after || !state->irq_enabled) {
+        return;
+    }
+    
+    if (state->trigger == EER_GPIO_TRIGGER_BOTH
+        || (state->trigger == EER_GPIO_TRIGGER_RISING && after)
+        || (state->trigger == EER_GPIO_TRIGGER_FALLING && !after)) {
+        state->irq_pending = true;
+    }
+}
+
+host_gpio_pin_state_t* host_gpio_state(void* pin) {
+    int index = gpio_index(pin);
+    
+    return index < 0 ? NULL : &gpio_pins[index];
+}
+
+void host_gpio_drive(void* pin, bool level) {
+    host_gpio_pin_state_t* state = host_gpio_state(pin);
+    if (state == NULL) {
+        return;
+    }
+    
+    bool before = gpio_level(state);
+    state->driven = true;
+    state->input = level;
+    gpio_edge(state, before);
+}
+
+void host_gpio_release(void* pin) {
+    host_gpio_pin_state_t* state = host_gpio_state(pin);
+    if (state == NULL) {
+        return;
+    }
+    
+    bool before = gpio_level(state);
+    state->driven = false;
+    gpio_edge(state, before);
+}
+
+void host_gpio_poll(void) {
+    for (int index = 0; index < EER_HOST_PORTS * 8; index++) {
+        if (!gpio_pins[index].irq_pending) {
+            continue;
+        }
+        
+        gpio_pins[index].irq_pending = false;
+        
+        eer_trace_isr(EER_TRACE_GPIO_IRQ, (uint16_t)(index / 8) << 8 | 1 << (index % 8));
+        
+        if (gpio_irq_handlers[index].handler != NULL) {
+            eer_gpio_irq_t irq = {
+                .pin = &gpio_irq_handlers[index].pin,
+                .user_data = gpio_irq_handlers[index].user_data
+            };
+            
+            host_power_wakeup(EER_WAKEUP_PIN, (uint8_t)index);
+            gpio_irq_handlers[index].handler(&irq);
+        }
+    }
+}
+
+eer_hal_status_t host_gpio_init(void) {
+    // Every pin starts as a floating input
+    memset(gpio_pins, 0, sizeof(gpio_pins));
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_gpio_deinit(void) {
+    // Nothing to deinitialize
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_gpio_configure(void *pin, eer_gpio_config_t* config) {
+    host_gpio_pin_state_t* state = host_gpio_state(pin);
+    if (state == NULL || config == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    bool before = gpio_level(state);
+    state->mode = config->mode;
+    state->trigger = config->trigger;
+    gpio_edge(state, before);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_gpio_write(void *pin, bool value) {
+    host_gpio_pin_state_t* state = host_gpio_state(pin);
+    if (state == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    bool before = gpio_level(state);
+    state->output = value;
+    gpio_edge(state, before);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_gpio_read(void *pin, bool *value) {
+    host_gpio_pin_state_t* state = host_gpio_state(pin);
+    if (state == NULL || value == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    *value = gpio_level(state);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_gpio_toggle(void *pin) {
+    host_gpio_pin_state_t* state = host_gpio_state(pin);
+    if (state == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    return host_gpio_write(pin, !state->output);
+}
+
+eer_hal_status_t host_gpio_register_irq(void *pin,
+                                              eer_gpio_irq_handler_t handler,
+                                              void* user_data) {
+    int index = gpio_index(pin);
+    if (index < 0 || handler == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Store the handler and user data
+    gpio_irq_handlers[index].handler = handler;
+    gpio_irq_handlers[index].user_data = user_data;
+    gpio_irq_handlers[index].pin = *(eer_pin_t*)pin;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_gpio_unregister_irq(void *pin) {
+    int index = gpio_index(pin);
+    if (index < 0) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    gpio_pins[index].irq_enabled = false;
+    gpio_pins[index].irq_pending = false;
+    
+    // Clear the handler and user data
+    gpio_irq_handlers[index].handler = NULL;
+    gpio_irq_handlers[index].user_data = NULL;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_gpio_enable_irq(void *pin) {
+    host_gpio_pin_state_t* state = host_gpio_state(pin);
+    if (state == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    state->irq_enabled = true;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_gpio_disable_irq(void *pin) {
+    host_gpio_pin_state_t* state = host_gpio_state(pin);
+    if (state == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    state->irq_enabled = false;
+    state->irq_pending = false;
+    
+    return EER_HAL_OK;
+}
+
+// GPIO handler structure with function pointers
+eer_gpio_handler_t eer_host_gpio = {
+    .init = host_gpio_init,
+    .deinit = host_gpio_deinit,
+    .configure = host_gpio_configure,
+    .write = host_gpio_write,
+    .read = host_gpio_read,
+    .toggle = host_gpio_toggle,
+    .register_irq = host_gpio_register_irq,
+    .unregister_irq = host_gpio_unregister_irq,
+    .enable_irq = host_gpio_enable_irq,
+    .disable_irq = host_gpio_disable_irq
+};
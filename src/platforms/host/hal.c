@@ -0,0 +1,26 @@
+#include "eer_hal.h"
+#include "platforms/host/hal.h"
+#include "platforms/host/gpio.h"
+#include "platforms/host/adc.h"
+#include "platforms/host/uart.h"
+#include "platforms/host/spi.h"
+#include "platforms/host/i2c.h"
+#include "platforms/host/timer.h"
+#include "platforms/host/system.h"
+#include "platforms/host/power.h"
+#include "platforms/host/nvs.h"
+
+// Global HAL instance for the host platform
+eer_hal_t eer_hal = {
+    .gpio = &eer_host_gpio,
+    .adc = &eer_host_adc,
+    .uart = &eer_host_uart,
+    .spi = &eer_host_spi,
+    .i2c = &eer_host_i2c,
+    .timer = &eer_host_timer,
+    .system = &eer_host_system,
+    .power = &eer_host_power,
+    .nvs = &eer_host_nvs,
+    .uart_instance = &eer_host_uart_instance,
+    .timer_instance = &eer_host_timer_instance
+};
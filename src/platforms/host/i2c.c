@@ -0,0 +1,294 @@
+#include "platforms/host/i2c.h"
+#include "eer_trace.h"
+#include <stddef.h>
+
+// Default I2C instance for the host
+static eer_i2c_t i2c0 = eer_hal_i2c0();
+
+// Callback handler and user data
+static struct {
+    eer_i2c_transfer_handler_t handler;
+    void* user_data;
+} i2c_callback = {0};
+
+// Asynchronous requests, run by the poll
+static eer_async_queue_t i2c_async = {0};
+
+/**
+ * @brief Find the device acknowledging an address
+ */
+static host_i2c_device_t* i2c_device(uint16_t address) {
+    for (host_i2c_device_t* device = i2c0.devices; device != NULL; device = device->next) {
+        if (device->address == address) {
+            return device;
+        }
+    }
+    
+    return NULL;
+}
+
+static void i2c_notify(uint16_t address, const uint8_t* tx_data, uint8_t* rx_data, uint16_t size) {
+    // Call the callback if registered
+    if (i2c_callback.handler != NULL) {
+        eer_i2c_transfer_event_t event = {
+            .i2c = &i2c0,
+            .address = address,
+            .tx_data = (uint8_t*)tx_data,
+            .rx_data = rx_data,
+            .size = size,
+            .user_data = i2c_callback.user_data
+        };
+        
+        i2c_callback.handler(&event);
+    }
+}
+
+eer_hal_status_t host_i2c_attach(host_i2c_device_t* device) {
+    if (device == NULL || device->address > 0x7F || i2c_device(device->address) != NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    device->next = i2c0.devices;
+    i2c0.devices = device;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_i2c_detach(host_i2c_device_t* device) {
+    for (host_i2c_device_t** link = &i2c0.devices; *link != NULL; link = &(*link)->next) {
+        if (*link == device) {
+            *link = device->next;
+            return EER_HAL_OK;
+        }
+    }
+    
+    return EER_HAL_INVALID_PARAM;
+}
+
+eer_hal_status_t host_i2c_init(eer_i2c_config_t* config) {
+    if (config == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Store the configuration
+    i2c0.config = *config;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_i2c_deinit(void) {
+    eer_async_cancel(&i2c_async, EER_HAL_ERROR);
+    
+    // Clear callback handler
+    i2c_callback.handler = NULL;
+    i2c_callback.user_data = NULL;
+    
+    return EER_HAL_OK;
+}
+
+static eer_hal_status_t host_i2c_write(uint16_t address, const uint8_t* data, uint16_t size) {
+    // For now, only support 7-bit addressing
+    if (i2c0.config.addr_mode == EER_I2C_ADDR_10BIT) {
+        return EER_HAL_NOT_SUPPORTED;
+    }
+    
+    eer_trace(EER_TRACE_I2C_TRANSMIT, address);
+    
+    host_i2c_device_t* device = i2c_device(address);
+    if (device == NULL || device->write == NULL || device->write(device, data, size) != EER_HAL_OK) {
+        eer_trace(EER_TRACE_I2C_ERROR, address);
+        return EER_HAL_ERROR;
+    }
+    
+    return EER_HAL_OK;
+}
+
+static eer_hal_status_t host_i2c_read(uint16_t address, uint8_t* data, uint16_t size) {
+    // For now, only support 7-bit addressing
+    if (i2c0.config.addr_mode == EER_I2C_ADDR_10BIT) {
+        return EER_HAL_NOT_SUPPORTED;
+    }
+    
+    eer_trace(EER_TRACE_I2C_RECEIVE, address);
+    
+    host_i2c_device_t* device = i2c_device(address);
+    if (device == NULL || device->read == NULL || device->read(device, data, size) != EER_HAL_OK) {
+        eer_trace(EER_TRACE_I2C_ERROR, address);
+        return EER_HAL_ERROR;
+    }
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_i2c_master_transmit(uint16_t address, const uint8_t* data, uint16_t size, uint32_t timeout) {
+    (void)timeout;
+    
+    if (data == NULL || size == 0) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    if (i2c_async.head != NULL) {
+        return EER_HAL_BUSY;
+    }
+    
+    eer_hal_status_t status = host_i2c_write(address, data, size);
+    if (status != EER_HAL_OK) {
+        return status;
+    }
+    
+    i2c_notify(address, data, NULL, size);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_i2c_master_receive(uint16_t address, uint8_t* data, uint16_t size, uint32_t timeout) {
+    (void)timeout;
+    
+    if (data == NULL || size == 0) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    if (i2c_async.head != NULL) {
+        return EER_HAL_BUSY;
+    }
+    
+    eer_hal_status_t status = host_i2c_read(address, data, size);
+    if (status != EER_HAL_OK) {
+        return status;
+    }
+    
+    i2c_notify(address, NULL, data, size);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_i2c_master_transmit_receive(uint16_t address,
+                                                       const uint8_t* tx_data, uint16_t tx_size,
+                                                       uint8_t* rx_data, uint16_t rx_size,
+                                                       uint32_t timeout) {
+    (void)timeout;
+    
+    if ((tx_data == NULL || tx_size == 0) || (rx_data == NULL || rx_size == 0)) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    if (i2c_async.head != NULL) {
+        return EER_HAL_BUSY;
+    }
+    
+    // Write, repeated start, read
+    eer_hal_status_t status = host_i2c_write(address, tx_data, tx_size);
+    if (status != EER_HAL_OK) {
+        return status;
+    }
+    
+    status = host_i2c_read(address, rx_data, rx_size);
+    if (status != EER_HAL_OK) {
+        return status;
+    }
+    
+    i2c_notify(address, tx_data, rx_data, tx_size + rx_size);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_i2c_is_busy(bool* busy) {
+    if (busy == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Transfers complete within the call, requests within the poll
+    *busy = i2c_async.head != NULL;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_i2c_scan(uint16_t* devices, uint8_t max_devices, uint8_t* found_devices) {
+    if (devices == NULL || found_devices == NULL || max_devices == 0) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    uint8_t count = 0;
+    
+    // Scan all possible 7-bit addresses, skipping reserved ones
+    for (uint16_t addr = 8; addr < 0x78 && count < max_devices; addr++) {
+        if (i2c_device(addr) != NULL) {
+            devices[count++] = addr;
+        }
+    }
+    
+    *found_devices = count;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_i2c_register_callback(eer_i2c_transfer_handler_t handler, void* user_data) {
+    if (handler == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Store the handler and user data
+    i2c_callback.handler = handler;
+    i2c_callback.user_data = user_data;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_i2c_unregister_callback(void) {
+    // Clear the handler and user data
+    i2c_callback.handler = NULL;
+    i2c_callback.user_data = NULL;
+    
+    return EER_HAL_OK;
+}
+
+void host_i2c_poll(void) {
+    eer_async_request_t* request;
+    
+    while ((request = i2c_async.head) != NULL) {
+        eer_hal_status_t status = EER_HAL_OK;
+        
+        // Write, repeated start, read
+        if (request->tx_size > 0) {
+            status = host_i2c_write(request->address, request->tx_data, request->tx_size);
+        }
+        
+        if (status == EER_HAL_OK && request->rx_size > 0) {
+            status = host_i2c_read(request->address, request->rx_data, request->rx_size);
+        }
+        
+        if (status == EER_HAL_OK) {
+            request->index = request->tx_size + request->rx_size;
+        }
+        
+        eer_async_dequeue(&i2c_async);
+        eer_async_complete(request, status);
+    }
+}
+
+eer_hal_status_t host_i2c_submit(eer_async_request_t* request) {
+    eer_hal_status_t status = eer_async_prepare(request);
+    if (status != EER_HAL_OK) {
+        return status;
+    }
+    
+    // Run by the poll, like an interrupt
+    eer_async_enqueue(&i2c_async, request);
+    host_poll();
+    
+    return EER_HAL_OK;
+}
+
+// I2C handler structure with function pointers
+eer_i2c_handler_t eer_host_i2c = {
+    .init = host_i2c_init,
+    .deinit = host_i2c_deinit,
+    .master_transmit = host_i2c_master_transmit,
+    .master_receive = host_i2c_master_receive,
+    .master_transmit_receive = host_i2c_master_transmit_receive,
+    .is_busy = host_i2c_is_busy,
+    .scan = host_i2c_scan,
+    .register_callback = host_i2c_register_callback,
+    .unregister_callback = host_i2c_unregister_callback,
+    .submit = host_i2c_submit
+};
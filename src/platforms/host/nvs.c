@@ -0,0 +1,224 @@
+#include "platforms/host/nvs.h"
+#include "eer_trace.h"
+#include <stddef.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Storage array, erased before first use
+static uint8_t nvs_memory[EER_HOST_NVS_SIZE];
+static bool nvs_erased = false;
+
+// Backing file, -1 for RAM only
+static int nvs_fd = -1;
+
+// Write complete event latched and not yet dispatched
+static bool nvs_complete_pending = false;
+
+// Callback handler and user data
+static struct {
+    eer_nvs_write_handler_t handler;
+    void* user_data;
+} nvs_callback = {0};
+
+static void nvs_erase_memory(void) {
+    if (!nvs_erased) {
+        memset(nvs_memory, EER_NVS_ERASED_BYTE, sizeof(nvs_memory));
+        nvs_erased = true;
+    }
+}
+
+uint8_t* host_nvs_memory(void) {
+    nvs_erase_memory();
+    return nvs_memory;
+}
+
+eer_hal_status_t host_nvs_open(const char* path) {
+    if (path == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return EER_HAL_ERROR;
+    }
+    
+    if (nvs_fd >= 0) {
+        close(nvs_fd);
+    }
+    nvs_fd = fd;
+    
+    // A short or new file reads as erased beyond its end
+    nvs_erased = false;
+    nvs_erase_memory();
+    
+    ssize_t length = pread(nvs_fd, nvs_memory, sizeof(nvs_memory), 0);
+    if (length < 0) {
+        return EER_HAL_ERROR;
+    }
+    
+    if (pwrite(nvs_fd, nvs_memory, sizeof(nvs_memory), 0) != (ssize_t)sizeof(nvs_memory)) {
+        return EER_HAL_ERROR;
+    }
+    
+    return EER_HAL_OK;
+}
+
+void host_nvs_poll(void) {
+    if (!nvs_complete_pending) {
+        return;
+    }
+    
+    nvs_complete_pending = false;
+    
+    eer_trace_isr(EER_TRACE_NVS_READY, 0);
+    
+    if (nvs_callback.handler != NULL) {
+        eer_nvs_event_t event = {
+            .nvs = &eer_host_nvs,
+            .user_data = nvs_callback.user_data
+        };
+        
+        nvs_callback.handler(&event);
+    }
+}
+
+/**
+ * @brief Store bytes and latch the write complete event
+ * @param address Storage address of the first byte
+ * @param data Bytes to store, NULL to erase
+ * @param size Number of bytes
+ * @return Status code indicating success or failure
+ */
+static eer_hal_status_t nvs_store(uint32_t address, const uint8_t* data, uint16_t size) {
+    if (size == 0 || address + size > EER_HOST_NVS_SIZE) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_trace(EER_TRACE_NVS_WRITE, (uint16_t)address);
+    
+    nvs_erase_memory();
+    
+    if (data != NULL) {
+        memcpy(&nvs_memory[address], data, size);
+    } else {
+        memset(&nvs_memory[address], EER_NVS_ERASED_BYTE, size);
+    }
+    
+    if (nvs_fd >= 0 && pwrite(nvs_fd, &nvs_memory[address], size, address) != size) {
+        return EER_HAL_ERROR;
+    }
+    
+    nvs_complete_pending = true;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_nvs_init(void) {
+    nvs_erase_memory();
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_nvs_deinit(void) {
+    nvs_complete_pending = false;
+    
+    // Clear callback handler
+    nvs_callback.handler = NULL;
+    nvs_callback.user_data = NULL;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_nvs_read(uint32_t address, uint8_t* data, uint16_t size) {
+    if (data == NULL || size == 0 || address + size > EER_HOST_NVS_SIZE) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_trace(EER_TRACE_NVS_READ, (uint16_t)address);
+    
+    nvs_erase_memory();
+    memcpy(data, &nvs_memory[address], size);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_nvs_write(uint32_t address, const uint8_t* data, uint16_t size, uint32_t timeout) {
+    (void)timeout;
+    
+    if (data == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    return nvs_store(address, data, size);
+}
+
+eer_hal_status_t host_nvs_erase(uint32_t address, uint16_t size, uint32_t timeout) {
+    (void)timeout;
+    
+    return nvs_store(address, NULL, size);
+}
+
+eer_hal_status_t host_nvs_flush(uint32_t timeout) {
+    (void)timeout;
+    
+    // Programming finishes within the write call
+    if (nvs_fd >= 0 && fsync(nvs_fd) != 0) {
+        return EER_HAL_ERROR;
+    }
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_nvs_is_busy(bool* busy) {
+    if (busy == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    *busy = false;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_nvs_get_size(uint32_t* size) {
+    if (size == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    *size = EER_HOST_NVS_SIZE;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_nvs_register_callback(eer_nvs_write_handler_t handler, void* user_data) {
+    if (handler == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Store the handler and user data
+    nvs_callback.handler = handler;
+    nvs_callback.user_data = user_data;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_nvs_unregister_callback(void) {
+    // Clear the handler and user data
+    nvs_callback.handler = NULL;
+    nvs_callback.user_data = NULL;
+    
+    return EER_HAL_OK;
+}
+
+// NVS handler structure with function pointers
+eer_nvs_handler_t eer_host_nvs = {
+    .init = host_nvs_init,
+    .deinit = host_nvs_deinit,
+    .read = host_nvs_read,
+    .write = host_nvs_write,
+    .erase = host_nvs_erase,
+    .flush = host_nvs_flush,
+    .is_busy = host_nvs_is_busy,
+    .get_size = host_nvs_get_size,
+    .register_callback = host_nvs_register_callback,
+    .unregister_callback = host_nvs_unregister_callback
+};
@@ -0,0 +1,171 @@
+#include "platforms/host/power.h"
+#include "eer_trace.h"
+#include <stddef.h>
+
+// Current power mode
+static eer_power_mode_t current_power_mode = EER_POWER_MODE_RUN;
+
+// Last wakeup source
+static struct {
+    eer_wakeup_source_t source;
+    uint8_t pin_or_id;
+} last_wakeup = {0};
+
+// Enabled wakeup sources, one bit per eer_wakeup_source_t
+static uint8_t wakeup_sources = 0;
+
+// Set while sleeping, cleared by the event that ends the sleep
+static bool power_sleeping = false;
+static bool power_any_event = false;
+
+void host_power_wakeup(eer_wakeup_source_t source, uint8_t pin_or_id) {
+    if (!power_sleeping) {
+        return;
+    }
+    
+    if (!power_any_event && !(wakeup_sources & (1 << source))) {
+        return;
+    }
+    
+    last_wakeup.source = source;
+    last_wakeup.pin_or_id = pin_or_id;
+    power_sleeping = false;
+}
+
+/**
+ * @brief Block until a wakeup event
+ * @param any_event true if every event wakes, false for enabled sources only
+ * @return Status code indicating success or failure
+ */
+static eer_hal_status_t power_sleep(bool any_event) {
+    power_any_event = any_event;
+    power_sleeping = true;
+    
+    eer_trace(EER_TRACE_POWER_SLEEP, current_power_mode);
+    
+    while (power_sleeping) {
+        if (!host_interrupts_enabled()
+            || (host_timer_deadline() == HOST_TIME_NEVER && host_uart_wait_fds(NULL, 0) == 0)) {
+            // Nothing is left that could wake the device
+            power_sleeping = false;
+            return EER_HAL_ERROR;
+        }
+        
+        host_wait_until(HOST_TIME_NEVER);
+    }
+    
+    eer_trace(EER_TRACE_POWER_WAKEUP, (uint16_t)last_wakeup.source << 8 | last_wakeup.pin_or_id);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_power_init(void) {
+    current_power_mode = EER_POWER_MODE_RUN;
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_power_deinit(void) {
+    wakeup_sources = 0;
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_power_set_mode(eer_power_mode_t mode) {
+    eer_hal_status_t status = EER_HAL_OK;
+    
+    switch (mode) {
+        case EER_POWER_MODE_RUN:
+            // Already in run mode, nothing to do
+            break;
+            
+        case EER_POWER_MODE_SLEEP:
+            status = power_sleep(true);
+            break;
+            
+        case EER_POWER_MODE_DEEP_SLEEP:
+        case EER_POWER_MODE_STANDBY:
+            status = power_sleep(false);
+            break;
+            
+        default:
+            return EER_HAL_INVALID_PARAM;
+    }
+    
+    current_power_mode = mode;
+    return status;
+}
+
+eer_hal_status_t host_power_get_mode(eer_power_mode_t* mode) {
+    if (mode == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    *mode = current_power_mode;
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_power_enable_wakeup_source(eer_wakeup_source_t source, uint8_t pin_or_id) {
+    (void)pin_or_id;
+    
+    if (source > EER_WAKEUP_UART) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    wakeup_sources |= (1 << source);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_power_disable_wakeup_source(eer_wakeup_source_t source, uint8_t pin_or_id) {
+    (void)pin_or_id;
+    
+    if (source > EER_WAKEUP_UART) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    wakeup_sources &= ~(1 << source);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_power_get_wakeup_source(eer_wakeup_source_t* source, uint8_t* pin_or_id) {
+    if (source == NULL || pin_or_id == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    *source = last_wakeup.source;
+    *pin_or_id = last_wakeup.pin_or_id;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_power_get_voltage(uint16_t* voltage_mv) {
+    if (voltage_mv == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    *voltage_mv = EER_HOST_VCC_MV;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_power_get_power_consumption(uint16_t* power_mw) {
+    if (power_mw == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // There is nothing to measure on the host
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+// Power handler structure with function pointers
+eer_power_handler_t eer_host_power = {
+    .init = host_power_init,
+    .deinit = host_power_deinit,
+    .set_mode = host_power_set_mode,
+    .get_mode = host_power_get_mode,
+    .enable_wakeup_source = host_power_enable_wakeup_source,
+    .disable_wakeup_source = host_power_disable_wakeup_source,
+    .get_wakeup_source = host_power_get_wakeup_source,
+    .get_voltage = host_power_get_voltage,
+    .get_power_consumption = host_power_get_power_consumption
+};
@@ -0,0 +1,258 @@
+#include "platforms/host/spi.h"
+#include "eer_trace.h"
+#include <stddef.h>
+
+// Default SPI instance for the host
+static eer_spi_t spi0 = eer_hal_spi0();
+
+// Callback handler and user data
+static struct {
+    eer_spi_transfer_handler_t handler;
+    void* user_data;
+} spi_callback = {0};
+
+// Asynchronous requests, run by the poll
+static eer_async_queue_t spi_async = {0};
+
+eer_hal_status_t host_spi_attach(host_spi_device_t* device) {
+    if (device == NULL || device->exchange == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    device->next = spi0.devices;
+    spi0.devices = device;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_spi_detach(host_spi_device_t* device) {
+    for (host_spi_device_t** link = &spi0.devices; *link != NULL; link = &(*link)->next) {
+        if (*link == device) {
+            *link = device->next;
+            
+            if (spi0.selected == device) {
+                spi0.selected = NULL;
+            }
+            
+            return EER_HAL_OK;
+        }
+    }
+    
+    return EER_HAL_INVALID_PARAM;
+}
+
+eer_hal_status_t host_spi_init(eer_spi_config_t* config) {
+    if (config == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Store the configuration
+    spi0.config = *config;
+    
+    return EER_HAL_OK;
+}
+
+const eer_spi_config_t* host_spi_config(void) {
+    return &spi0.config;
+}
+
+eer_hal_status_t host_spi_deinit(void) {
+    spi0.selected = NULL;
+    
+    eer_async_cancel(&spi_async, EER_HAL_ERROR);
+    
+    // Clear callback handler
+    spi_callback.handler = NULL;
+    spi_callback.user_data = NULL;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_spi_transfer(const uint8_t* tx_data, uint8_t* rx_data, uint16_t size, uint32_t timeout) {
+    (void)timeout;
+    
+    if (size == 0 || (tx_data == NULL && rx_data == NULL)) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    if (spi_async.head != NULL) {
+        return EER_HAL_BUSY;
+    }
+    
+    eer_trace(EER_TRACE_SPI_TRANSFER, size);
+    
+    for (uint16_t i = 0; i < size; i++) {
+        // If no TX data, send dummy byte
+        uint8_t data = tx_data != NULL ? tx_data[i] : 0xFF;
+        
+        // MISO floats high without a selected device
+        uint8_t received = 0xFF;
+        if (spi0.selected != NULL) {
+            received = spi0.selected->exchange(spi0.selected, data);
+        }
+        
+        if (rx_data != NULL) {
+            rx_data[i] = received;
+        }
+    }
+    
+    // Call the callback if registered
+    if (spi_callback.handler != NULL) {
+        eer_spi_transfer_event_t event = {
+            .spi = &spi0,
+            .tx_data = (uint8_t*)tx_data,
+            .rx_data = rx_data,
+            .size = size,
+            .user_data = spi_callback.user_data
+        };
+        
+        spi_callback.handler(&event);
+    }
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_spi_transmit(const uint8_t* data, uint16_t size, uint32_t timeout) {
+    return host_spi_transfer(data, NULL, size, timeout);
+}
+
+eer_hal_status_t host_spi_receive(uint8_t* data, uint16_t size, uint32_t timeout) {
+    return host_spi_transfer(NULL, data, size, timeout);
+}
+
+eer_hal_status_t host_spi_is_ready(bool* ready) {
+    if (ready == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Transfers complete within transfer(), requests within the poll
+    *ready = spi_async.head == NULL;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_spi_chip_select(void* pin, bool state) {
+    host_gpio_pin_state_t* pin_state = host_gpio_state(pin);
+    if (pin_state == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_pin_t* cs = (eer_pin_t*)pin;
+    
+    // Set pin state (active low)
+    pin_state->output = !state;
+    
+    for (host_spi_device_t* device = spi0.devices; device != NULL; device = device->next) {
+        if (device->cs.port != cs->port || device->cs.number != cs->number) {
+            continue;
+        }
+        
+        if (state) {
+            spi0.selected = device;
+        } else if (spi0.selected == device) {
+            spi0.selected = NULL;
+        }
+        
+        if (device->select != NULL) {
+            device->select(device, state);
+        }
+    }
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_spi_set_prescaler(eer_spi_prescaler_t prescaler) {
+    // Not under a running request
+    if (spi_async.head != NULL) {
+        return EER_HAL_BUSY;
+    }
+    
+    spi0.config.prescaler = prescaler;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_spi_register_callback(eer_spi_transfer_handler_t handler, void* user_data) {
+    if (handler == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Store the handler and user data
+    spi_callback.handler = handler;
+    spi_callback.user_data = user_data;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_spi_unregister_callback(void) {
+    // Clear the handler and user data
+    spi_callback.handler = NULL;
+    spi_callback.user_data = NULL;
+    
+    return EER_HAL_OK;
+}
+
+void host_spi_poll(void) {
+    eer_async_request_t* request;
+    
+    while ((request = spi_async.head) != NULL) {
+        uint16_t size = request->tx_size > request->rx_size ? request->tx_size : request->rx_size;
+        const eer_spi_device_t* device = (const eer_spi_device_t*)request->device;
+        
+        if (device != NULL) {
+            spi0.config.prescaler = device->prescaler;
+            host_spi_chip_select(device->cs, true);
+        }
+        
+        for (; request->index < size; request->index++) {
+            uint8_t data = request->index < request->tx_size ? request->tx_data[request->index] : 0xFF;
+            
+            // MISO floats high without a selected device
+            uint8_t received = 0xFF;
+            if (spi0.selected != NULL) {
+                received = spi0.selected->exchange(spi0.selected, data);
+            }
+            
+            if (request->index < request->rx_size) {
+                request->rx_data[request->index] = received;
+            }
+        }
+        
+        if (device != NULL) {
+            host_spi_chip_select(device->cs, false);
+        }
+        
+        eer_async_dequeue(&spi_async);
+        eer_async_complete(request, EER_HAL_OK);
+    }
+}
+
+eer_hal_status_t host_spi_submit(eer_async_request_t* request) {
+    eer_hal_status_t status = eer_async_prepare(request);
+    if (status != EER_HAL_OK) {
+        return status;
+    }
+    
+    eer_trace(EER_TRACE_SPI_TRANSFER, request->tx_size > request->rx_size ? request->tx_size : request->rx_size);
+    
+    // Run by the poll, like an interrupt
+    eer_async_enqueue(&spi_async, request);
+    host_poll();
+    
+    return EER_HAL_OK;
+}
+
+// SPI handler structure with function pointers
+eer_spi_handler_t eer_host_spi = {
+    .init = host_spi_init,
+    .deinit = host_spi_deinit,
+    .transfer = host_spi_transfer,
+    .transmit = host_spi_transmit,
+    .receive = host_spi_receive,
+    .is_ready = host_spi_is_ready,
+    .chip_select = host_spi_chip_select,
+    .set_prescaler = host_spi_set_prescaler,
+    .register_callback = host_spi_register_callback,
+    .unregister_callback = host_spi_unregister_callback,
+    .submit = host_spi_submit
+};
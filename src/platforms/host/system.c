@@ -0,0 +1,246 @@
+#include "platforms/host/system.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <time.h>
+#include <poll.h>
+
+// Clock state, the virtual clock starts at zero
+static host_clock_t system_clock = HOST_CLOCK_VIRTUAL;
+static uint64_t system_virtual_us = 0;
+static uint64_t system_monotonic_start = 0;
+
+// Global interrupt enable and handler nesting, like the I bit on AVR
+static bool system_interrupts = true;
+static bool system_in_handler = false;
+
+// UART descriptors a wait blocks on at most
+#define SYSTEM_WAIT_FDS 8
+
+// Flag to track if system is initialized
+static bool system_initialized = false;
+
+// Handler run on reset instead of exiting
+static void (*system_reset_handler)(eer_system_reset_type_t type) = NULL;
+
+static uint64_t system_monotonic_us(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    
+    return (uint64_t)now.tv_sec * 1000000 + (uint64_t)now.tv_nsec / 1000;
+}
+
+void host_clock_select(host_clock_t clock) {
+    system_clock = clock;
+    system_virtual_us = 0;
+    system_monotonic_start = system_monotonic_us();
+}
+
+uint64_t host_time_us(void) {
+    if (system_clock == HOST_CLOCK_MONOTONIC) {
+        return system_monotonic_us() - system_monotonic_start;
+    }
+    
+    return system_virtual_us;
+}
+
+bool host_interrupts_enabled(void) {
+    return system_interrupts && !system_in_handler;
+}
+
+void host_poll(void) {
+    if (!host_interrupts_enabled()) {
+        return;
+    }
+    
+    // Handlers run with further events held back, as in an ISR
+    system_in_handler = true;
+    
+    host_uart_poll();
+    host_timer_poll();
+    host_gpio_poll();
+    host_adc_poll();
+    host_nvs_poll();
+    host_spi_poll();
+    host_i2c_poll();
+    
+    system_in_handler = false;
+}
+
+bool host_wait_until(uint64_t until) {
+    uint64_t now = host_time_us();
+    uint64_t target = until;
+    
+    // Timer events end the wait as well
+    if (host_interrupts_enabled()) {
+        uint64_t deadline = host_timer_deadline();
+        if (deadline < target) {
+            target = deadline;
+        }
+    }
+    
+    if (target > now) {
+        uint64_t remaining = target - now;
+        struct pollfd input[SYSTEM_WAIT_FDS];
+        int count = host_uart_wait_fds(input, SYSTEM_WAIT_FDS);
+        
+        if (count > SYSTEM_WAIT_FDS) {
+            count = SYSTEM_WAIT_FDS;
+        }
+        
+        if (count > 0) {
+            // Block on the UART inputs for at most the time to the target
+            int timeout_ms = -1;
+            if (target != HOST_TIME_NEVER) {
+                uint64_t ms = (remaining + 999) / 1000;
+                timeout_ms = ms > INT_MAX ? INT_MAX : (int)ms;
+            }
+            
+            uint64_t start = system_monotonic_us();
+            bool ready = poll(input, (nfds_t)count, timeout_ms) > 0;
+            
+            if (system_clock == HOST_CLOCK_VIRTUAL) {
+                uint64_t spent = system_monotonic_us() - start;
+                system_virtual_us += (ready && spent < remaining) ? spent : remaining;
+            }
+        } else if (target == HOST_TIME_NEVER) {
+            // Nothing could end the wait
+            host_poll();
+            return false;
+        } else if (system_clock == HOST_CLOCK_VIRTUAL) {
+            system_virtual_us = target;
+        } else {
+            struct timespec delay = {
+                .tv_sec = (time_t)(remaining / 1000000),
+                .tv_nsec = (long)(remaining % 1000000) * 1000
+            };
+            nanosleep(&delay, NULL);
+        }
+    }
+    
+    host_poll();
+    
+    return host_time_us() >= until;
+}
+
+void host_advance_us(uint64_t us) {
+    uint64_t until = host_time_us() + us;
+    
+    if (system_clock == HOST_CLOCK_MONOTONIC) {
+        while (!host_wait_until(until));
+        return;
+    }
+    
+    // Step from one timer event to the next so handlers run at their time
+    while (host_interrupts_enabled()) {
+        uint64_t deadline = host_timer_deadline();
+        if (deadline > until) {
+            break;
+        }
+        
+        if (deadline > system_virtual_us) {
+            system_virtual_us = deadline;
+        }
+        
+        host_poll();
+    }
+    
+    system_virtual_us = until;
+    host_poll();
+}
+
+void host_system_set_reset_handler(void (*handler)(eer_system_reset_type_t type)) {
+    system_reset_handler = handler;
+}
+
+eer_hal_status_t host_system_init(void) {
+    if (system_initialized) {
+        return EER_HAL_OK;
+    }
+    
+    // Interrupts are enabled after initialization, as on AVR
+    system_interrupts = true;
+    
+    system_initialized = true;
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_system_deinit(void) {
+    system_initialized = false;
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_system_reset(eer_system_reset_type_t reset_type) {
+    switch (reset_type) {
+        case EER_SYSTEM_RESET_SOFT:
+        case EER_SYSTEM_RESET_HARD:
+        case EER_SYSTEM_RESET_WATCHDOG:
+            break;
+            
+        default:
+            return EER_HAL_INVALID_PARAM;
+    }
+    
+    if (system_reset_handler != NULL) {
+        system_reset_handler(reset_type);
+    }
+    
+    // The process is the device: restarting it is up to the caller
+    fflush(stdout);
+    exit(EXIT_SUCCESS);
+}
+
+eer_hal_status_t host_system_disable_interrupts(void) {
+    system_interrupts = false;
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_system_enable_interrupts(void) {
+    system_interrupts = true;
+    
+    // Deliver events that were held back
+    host_poll();
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_system_delay_ms(uint32_t ms) {
+    host_advance_us((uint64_t)ms * 1000);
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_system_delay_us(uint32_t us) {
+    host_advance_us(us);
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_system_get_tick(uint32_t* ticks) {
+    if (ticks == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Events that fell due on the monotonic clock are delivered here
+    host_poll();
+    
+    // Each tick is 1ms
+    *ticks = (uint32_t)(host_time_us() / 1000);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_system_get_uptime_ms(uint32_t* uptime) {
+    return host_system_get_tick(uptime);
+}
+
+// System handler structure with function pointers
+eer_system_handler_t eer_host_system = {
+    .init = host_system_init,
+    .deinit = host_system_deinit,
+    .reset = host_system_reset,
+    .disable_interrupts = host_system_disable_interrupts,
+    .enable_interrupts = host_system_enable_interrupts,
+    .delay_ms = host_system_delay_ms,
+    .delay_us = host_system_delay_us,
+    .get_tick = host_system_get_tick,
+    .get_uptime_ms = host_system_get_uptime_ms
+};
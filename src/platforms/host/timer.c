@@ -0,0 +1,531 @@
+#include "platforms/host/timer.h"
+#include "eer_trace.h"
+#include <stddef.h>
+
+// Default timer instance for the host
+static eer_timer_t timer0 = eer_hal_timer0();
+
+// Instances polled for events, linked through next
+static eer_timer_t* timer_instances = &timer0;
+
+static void timer_link(eer_timer_t* instance) {
+    for (eer_timer_t* timer = timer_instances; timer != NULL; timer = timer->next) {
+        if (timer == instance) {
+            return;
+        }
+    }
+    
+    instance->next = timer_instances;
+    timer_instances = instance;
+}
+
+static void timer_unlink(eer_timer_t* instance) {
+    for (eer_timer_t** link = &timer_instances; *link != NULL; link = &(*link)->next) {
+        if (*link == instance) {
+            *link = instance->next;
+            return;
+        }
+    }
+}
+
+static uint64_t timer_top(eer_timer_t* instance) {
+    return instance->period != 0 ? instance->period : 0x10000;
+}
+
+/**
+ * @brief Ticks counted since initialization
+ */
+static uint64_t timer_ticks(eer_timer_t* instance) {
+    if (!instance->running) {
+        return instance->ticks;
+    }
+    
+    uint64_t elapsed = host_time_us() - instance->started;
+    
+    return instance->ticks + elapsed * instance->frequency / 1000000;
+}
+
+/**
+ * @brief Tick count of the first event after a tick count
+ * @return Tick count, UINT64_MAX if no event has a handler
+ */
+static uint64_t timer_next_event(eer_timer_t* instance, uint64_t after) {
+    uint64_t top = timer_top(instance);
+    uint64_t period_start = after - after % top;
+    uint64_t next = UINT64_MAX;
+    
+    if (instance->overflow_handler != NULL) {
+        next = period_start + top;
+    }
+    
+    for (uint8_t channel = 0; channel < 2; channel++) {
+        if (instance->compare_handler[channel] == NULL || instance->compare[channel] >= top) {
+            continue;
+        }
+        
+        uint64_t match = period_start + instance->compare[channel];
+        if (match <= after) {
+            match += top;
+        }
+        
+        if (match < next) {
+            next = match;
+        }
+    }
+    
+    return next;
+}
+
+static void timer_notify(eer_timer_t* instance, eer_timer_event_handler_t handler,
+                         eer_timer_event_t type, uint32_t value, void* user_data) {
+    host_power_wakeup(EER_WAKEUP_TIMER, 0);
+    
+    if (handler != NULL) {
+        eer_timer_event_info_t event = {
+            .timer = instance,
+            .event = type,
+            .value = value,
+            .user_data = user_data
+        };
+        
+        handler(&event);
+    }
+}
+
+/**
+ * @brief Clock time of the next event of one instance
+ */
+static uint64_t timer_deadline(eer_timer_t* instance) {
+    if (!instance->running) {
+        return HOST_TIME_NEVER;
+    }
+    
+    uint64_t next = timer_next_event(instance, instance->dispatched);
+    if (next == UINT64_MAX) {
+        return HOST_TIME_NEVER;
+    }
+    
+    // Round up so the counter has reached the event at the returned time
+    uint64_t ticks = next - instance->ticks;
+    
+    return instance->started + (ticks * 1000000 + instance->frequency - 1) / instance->frequency;
+}
+
+/**
+ * @brief Dispatch the pending events of one instance
+ */
+static void timer_poll(eer_timer_t* instance) {
+    if (instance->capture_pending) {
+        instance->capture_pending = false;
+        eer_trace_isr(EER_TRACE_TIMER_CAPTURE, (uint16_t)instance->capture);
+        timer_notify(instance, instance->capture_handler, EER_TIMER_EVENT_CAPTURE,
+                     instance->capture, instance->capture_user_data);
+    }
+    
+    uint64_t now = timer_ticks(instance);
+    uint64_t top = timer_top(instance);
+    
+    // Dispatch every event up to now in order, handlers may change the timer
+    while (instance->running) {
+        uint64_t next = timer_next_event(instance, instance->dispatched);
+        if (next > now) {
+            break;
+        }
+        
+        instance->dispatched = next;
+        
+        uint32_t value = (uint32_t)(next % top);
+        
+        for (uint8_t channel = 0; channel < 2; channel++) {
+            if (instance->compare_handler[channel] != NULL && instance->compare[channel] == value) {
+                eer_trace_isr(EER_TRACE_TIMER_COMPARE, channel);
+                timer_notify(instance, instance->compare_handler[channel], EER_TIMER_EVENT_COMPARE,
+                             value, instance->compare_user_data[channel]);
+            }
+        }
+        
+        if (value == 0 && instance->overflow_handler != NULL) {
+            // A one-shot timer stops at the end of its period
+            if (instance->mode == EER_TIMER_MODE_ONE_SHOT) {
+                instance->ticks = next;
+                instance->running = false;
+            }
+            
+            eer_trace_isr(EER_TRACE_TIMER_OVERFLOW, 0);
+            timer_notify(instance, instance->overflow_handler, EER_TIMER_EVENT_OVERFLOW,
+                         value, instance->overflow_user_data);
+        }
+    }
+    
+    // Events without handlers are not delivered later
+    if (instance->running) {
+        instance->dispatched = now;
+    }
+}
+
+const eer_timer_t* host_timer_state(void) {
+    return &timer0;
+}
+
+void host_timer_instance_capture(void* timer) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    instance->capture = (uint32_t)(timer_ticks(instance) % timer_top(instance));
+    instance->capture_pending = true;
+}
+
+void host_timer_capture(void) {
+    host_timer_instance_capture(&timer0);
+}
+
+void host_timer_instance_capture_input(void* timer, bool level) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance->capture_level == level) {
+        return;
+    }
+    
+    instance->capture_level = level;
+    if (level == instance->capture_rising) {
+        host_timer_instance_capture(instance);
+    }
+}
+
+uint64_t host_timer_deadline(void) {
+    uint64_t deadline = HOST_TIME_NEVER;
+    
+    for (eer_timer_t* timer = timer_instances; timer != NULL; timer = timer->next) {
+        uint64_t next = timer_deadline(timer);
+        if (next < deadline) {
+            deadline = next;
+        }
+    }
+    
+    return deadline;
+}
+
+void host_timer_poll(void) {
+    eer_timer_t* timer = timer_instances;
+    
+    // Handlers may deinitialize their own instance
+    while (timer != NULL) {
+        eer_timer_t* next = timer->next;
+        timer_poll(timer);
+        timer = next;
+    }
+}
+
+eer_hal_status_t host_timer_instance_init(void* timer, eer_timer_config_t* config) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL || config == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    instance->frequency = config->frequency != 0 ? config->frequency : EER_HOST_TIMER_FREQUENCY;
+    instance->period = config->period;
+    instance->mode = config->mode;
+    instance->running = false;
+    instance->ticks = 0;
+    instance->dispatched = 0;
+    timer_link(instance);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_timer_instance_deinit(void* timer) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Stop the timer
+    instance->running = false;
+    instance->capture_pending = false;
+    
+    // Clear all callback handlers
+    instance->overflow_handler = NULL;
+    instance->overflow_user_data = NULL;
+    for (uint8_t channel = 0; channel < 2; channel++) {
+        instance->compare_handler[channel] = NULL;
+        instance->compare_user_data[channel] = NULL;
+    }
+    instance->capture_handler = NULL;
+    instance->capture_user_data = NULL;
+    
+    // Instances may go out of scope once deinitialized
+    if (instance != &timer0) {
+        timer_unlink(instance);
+    }
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_timer_instance_start(void* timer) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_trace(EER_TRACE_TIMER_START, 0);
+    
+    if (!instance->running) {
+        instance->started = host_time_us();
+        instance->running = true;
+    }
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_timer_instance_stop(void* timer) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_trace(EER_TRACE_TIMER_STOP, 0);
+    
+    if (instance->running) {
+        instance->ticks = timer_ticks(instance);
+        instance->running = false;
+    }
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_timer_instance_set_period(void* timer, uint32_t period) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL || period > 0x10000) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    instance->period = period;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_timer_instance_get_value(void* timer, uint32_t* value) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL || value == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    *value = (uint32_t)(timer_ticks(instance) % timer_top(instance));
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_timer_instance_set_compare(void* timer, uint8_t channel, uint32_t value) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL || channel >= 2) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    instance->compare[channel] = value;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_timer_instance_set_pwm_duty_cycle(void* timer, uint8_t channel, uint8_t duty_cycle) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL || channel >= 2 || duty_cycle > 100) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Calculate compare value based on duty cycle and period
+    instance->compare[channel] = (uint32_t)(timer_top(instance) * duty_cycle / 100);
+    
+    return EER_HAL_OK;
+}
+
+uint32_t host_timer_instance_us_to_ticks(void* timer, uint32_t us) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    return (uint32_t)((uint64_t)us * instance->frequency / 1000000);
+}
+
+uint32_t host_timer_instance_ticks_to_us(void* timer, uint32_t ticks) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    return (uint32_t)((uint64_t)ticks * 1000000 / instance->frequency);
+}
+
+eer_hal_status_t host_timer_instance_register_callback(void* timer,
+                                                       eer_timer_event_t event,
+                                                       uint8_t channel,
+                                                       eer_timer_event_handler_t handler,
+                                                       void* user_data) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL || handler == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    switch (event) {
+        case EER_TIMER_EVENT_OVERFLOW:
+            instance->overflow_handler = handler;
+            instance->overflow_user_data = user_data;
+            break;
+            
+        case EER_TIMER_EVENT_COMPARE:
+            if (channel >= 2) {
+                return EER_HAL_INVALID_PARAM;
+            }
+            instance->compare_handler[channel] = handler;
+            instance->compare_user_data[channel] = user_data;
+            break;
+            
+        case EER_TIMER_EVENT_CAPTURE:
+            instance->capture_handler = handler;
+            instance->capture_user_data = user_data;
+            break;
+            
+        default:
+            return EER_HAL_INVALID_PARAM;
+    }
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_timer_instance_unregister_callback(void* timer, eer_timer_event_t event, uint8_t channel) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    switch (event) {
+        case EER_TIMER_EVENT_OVERFLOW:
+            instance->overflow_handler = NULL;
+            instance->overflow_user_data = NULL;
+            break;
+            
+        case EER_TIMER_EVENT_COMPARE:
+            if (channel >= 2) {
+                return EER_HAL_INVALID_PARAM;
+            }
+            instance->compare_handler[channel] = NULL;
+            instance->compare_user_data[channel] = NULL;
+            break;
+            
+        case EER_TIMER_EVENT_CAPTURE:
+            instance->capture_handler = NULL;
+            instance->capture_user_data = NULL;
+            break;
+            
+        default:
+            return EER_HAL_INVALID_PARAM;
+    }
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_timer_instance_set_capture_edge(void* timer, bool rising) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    instance->capture_rising = rising;
+    instance->capture_pending = false;
+    
+    return EER_HAL_OK;
+}
+
+// Single-instance operations on the default timer
+eer_hal_status_t host_timer_init(eer_timer_config_t* config) {
+    return host_timer_instance_init(&timer0, config);
+}
+
+eer_hal_status_t host_timer_deinit(void) {
+    return host_timer_instance_deinit(&timer0);
+}
+
+eer_hal_status_t host_timer_start(void) {
+    return host_timer_instance_start(&timer0);
+}
+
+eer_hal_status_t host_timer_stop(void) {
+    return host_timer_instance_stop(&timer0);
+}
+
+eer_hal_status_t host_timer_set_period(uint32_t period) {
+    return host_timer_instance_set_period(&timer0, period);
+}
+
+eer_hal_status_t host_timer_get_value(uint32_t* value) {
+    return host_timer_instance_get_value(&timer0, value);
+}
+
+eer_hal_status_t host_timer_set_compare(uint8_t channel, uint32_t value) {
+    return host_timer_instance_set_compare(&timer0, channel, value);
+}
+
+eer_hal_status_t host_timer_set_pwm_duty_cycle(uint8_t channel, uint8_t duty_cycle) {
+    return host_timer_instance_set_pwm_duty_cycle(&timer0, channel, duty_cycle);
+}
+
+uint32_t host_timer_us_to_ticks(uint32_t us) {
+    return host_timer_instance_us_to_ticks(&timer0, us);
+}
+
+uint32_t host_timer_ticks_to_us(uint32_t ticks) {
+    return host_timer_instance_ticks_to_us(&timer0, ticks);
+}
+
+eer_hal_status_t host_timer_register_callback(eer_timer_event_t event,
+                                                  uint8_t channel,
+                                                  eer_timer_event_handler_t handler,
+                                                  void* user_data) {
+    return host_timer_instance_register_callback(&timer0, event, channel, handler, user_data);
+}
+
+eer_hal_status_t host_timer_unregister_callback(eer_timer_event_t event, uint8_t channel) {
+    return host_timer_instance_unregister_callback(&timer0, event, channel);
+}
+
+eer_hal_status_t host_timer_set_capture_edge(bool rising) {
+    return host_timer_instance_set_capture_edge(&timer0, rising);
+}
+
+// Timer handler structure with function pointers
+eer_timer_handler_t eer_host_timer = {
+    .init = host_timer_init,
+    .deinit = host_timer_deinit,
+    .start = host_timer_start,
+    .stop = host_timer_stop,
+    .set_period = host_timer_set_period,
+    .get_value = host_timer_get_value,
+    .set_compare = host_timer_set_compare,
+    .set_pwm_duty_cycle = host_timer_set_pwm_duty_cycle,
+    .us_to_ticks = host_timer_us_to_ticks,
+    .ticks_to_us = host_timer_ticks_to_us,
+    .register_callback = host_timer_register_callback,
+    .unregister_callback = host_timer_unregister_callback,
+    .set_capture_edge = host_timer_set_capture_edge
+};
+
+// Timer instance handler structure with function pointers
+eer_timer_instance_handler_t eer_host_timer_instance = {
+    .init = host_timer_instance_init,
+    .deinit = host_timer_instance_deinit,
+    .start = host_timer_instance_start,
+    .stop = host_timer_instance_stop,
+    .set_period = host_timer_instance_set_period,
+    .get_value = host_timer_instance_get_value,
+    .set_compare = host_timer_instance_set_compare,
+    .set_pwm_duty_cycle = host_timer_instance_set_pwm_duty_cycle,
+    .us_to_ticks = host_timer_instance_us_to_ticks,
+    .ticks_to_us = host_timer_instance_ticks_to_us,
+    .register_callback = host_timer_instance_register_callback,
+    .unregister_callback = host_timer_instance_unregister_callback,
+    .set_capture_edge = host_timer_instance_set_capture_edge
+};
@@ -0,0 +1,557 @@
+#define _GNU_SOURCE
+#include "platforms/host/uart.h"
+#include "eer_trace.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+// Default UART instance for the host
+static eer_uart_t uart0 = eer_hal_uart0();
+
+// Instances polled for input and events, linked through next
+static eer_uart_t* uart_instances = &uart0;
+
+static uint16_t uart_rx_count(eer_uart_t* instance) {
+    return (uint16_t)((instance->rx_head + EER_HOST_UART_RX_SIZE - instance->rx_tail) % EER_HOST_UART_RX_SIZE);
+}
+
+/**
+ * @brief Add an instance to the polled list unless it is already there
+ */
+static void uart_link(eer_uart_t* instance) {
+    for (eer_uart_t* uart = uart_instances; uart != NULL; uart = uart->next) {
+        if (uart == instance) {
+            return;
+        }
+    }
+    
+    instance->next = uart_instances;
+    uart_instances = instance;
+}
+
+static void uart_unlink(eer_uart_t* instance) {
+    for (eer_uart_t** link = &uart_instances; *link != NULL; link = &(*link)->next) {
+        if (*link == instance) {
+            *link = instance->next;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Move available input into the receive buffer
+ */
+static void uart_fill(eer_uart_t* instance) {
+    while (instance->rx_fd >= 0 && !instance->rx_closed
+           && uart_rx_count(instance) < EER_HOST_UART_RX_SIZE - 1) {
+        uint8_t data;
+        ssize_t result = read(instance->rx_fd, &data, 1);
+        
+        if (result == 0 || (result < 0 && errno != EAGAIN && errno != EINTR)) {
+            instance->rx_closed = true;
+        }
+        
+        if (result != 1) {
+            return;
+        }
+        
+        instance->rx_buffer[instance->rx_head] = data;
+        instance->rx_head = (instance->rx_head + 1) % EER_HOST_UART_RX_SIZE;
+    }
+}
+
+static void uart_set_nonblocking(int fd) {
+    int flags = fcntl(fd, F_GETFL);
+    
+    if (flags >= 0) {
+        fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    }
+}
+
+eer_hal_status_t host_uart_instance_open_pty(void* uart, char* name, size_t size) {
+    if (uart == NULL || name == NULL || size == 0) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    int fd = posix_openpt(O_RDWR | O_NOCTTY);
+    if (fd < 0) {
+        return EER_HAL_ERROR;
+    }
+    
+    const char* slave = NULL;
+    if (grantpt(fd) != 0 || unlockpt(fd) != 0 || (slave = ptsname(fd)) == NULL || strlen(slave) >= size) {
+        close(fd);
+        return EER_HAL_ERROR;
+    }
+    
+    // Pass bytes through unchanged
+    struct termios attributes;
+    if (tcgetattr(fd, &attributes) == 0) {
+        cfmakeraw(&attributes);
+        tcsetattr(fd, TCSANOW, &attributes);
+    }
+    
+    strcpy(name, slave);
+    
+    return host_uart_instance_attach(uart, fd, fd);
+}
+
+eer_hal_status_t host_uart_instance_attach(void* uart, int rx_fd, int tx_fd) {
+    eer_uart_t* instance = (eer_uart_t*)uart;
+    
+    if (instance == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    if (rx_fd >= 0) {
+        uart_set_nonblocking(rx_fd);
+    }
+    
+    instance->rx_fd = rx_fd;
+    instance->tx_fd = tx_fd;
+    instance->rx_closed = false;
+    uart_link(instance);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_uart_open_pty(char* name, size_t size) {
+    return host_uart_instance_open_pty(&uart0, name, size);
+}
+
+eer_hal_status_t host_uart_attach(int rx_fd, int tx_fd) {
+    return host_uart_instance_attach(&uart0, rx_fd, tx_fd);
+}
+
+int host_uart_wait_fds(struct pollfd* fds, int size) {
+    int count = 0;
+    
+    for (eer_uart_t* uart = uart_instances; uart != NULL; uart = uart->next) {
+        if (uart->rx_fd < 0 || uart->rx_closed) {
+            continue;
+        }
+        
+        if (count < size) {
+            fds[count] = (struct pollfd){ .fd = uart->rx_fd, .events = POLLIN };
+        }
+        count++;
+    }
+    
+    return count;
+}
+
+/**
+ * @brief Write bytes to the transmit descriptor
+ */
+static eer_hal_status_t uart_write(eer_uart_t* instance, const uint8_t* data, uint16_t size, uint32_t timeout) {
+    // Without a descriptor the line is not connected
+    while (instance->tx_fd >= 0 && size > 0) {
+        ssize_t written = write(instance->tx_fd, data, size);
+        
+        if (written > 0) {
+            data += written;
+            size -= (uint16_t)written;
+            continue;
+        }
+        
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        
+        if (written < 0 && errno != EAGAIN) {
+            return EER_HAL_ERROR;
+        }
+        
+        // Nobody reads the other end: wait for room
+        struct pollfd output = { .fd = instance->tx_fd, .events = POLLOUT };
+        if (timeout == 0 || poll(&output, 1, (int)timeout) <= 0) {
+            return EER_HAL_TIMEOUT;
+        }
+    }
+    
+    instance->tx_pending = true;
+    
+    return EER_HAL_OK;
+}
+
+/**
+ * @brief Run the asynchronous requests of one instance
+ *
+ * A request sends its bytes at once, then takes received bytes from the
+ * buffer ahead of the receive callback until it has all of them.
+ */
+static void uart_async_poll(eer_uart_t* instance) {
+    eer_async_request_t* request;
+    
+    while ((request = instance->async.head) != NULL) {
+        eer_hal_status_t status = EER_HAL_OK;
+        uint16_t total = request->tx_size + request->rx_size;
+        
+        if (request->index < request->tx_size) {
+            status = uart_write(instance, request->tx_data, request->tx_size, 0);
+            request->index = request->tx_size;
+        }
+        
+        // Bytes already reported to the callback but not consumed
+        uint16_t reported = (uint16_t)((instance->rx_reported + EER_HOST_UART_RX_SIZE - instance->rx_tail) % EER_HOST_UART_RX_SIZE);
+        uint16_t taken = 0;
+        while (status == EER_HAL_OK && request->index < total && instance->rx_tail != instance->rx_head) {
+            request->rx_data[request->index++ - request->tx_size] = instance->rx_buffer[instance->rx_tail];
+            instance->rx_tail = (instance->rx_tail + 1) % EER_HOST_UART_RX_SIZE;
+            taken++;
+        }
+        
+        // Bytes taken by the request are not reported to the callback
+        if (reported < taken) {
+            instance->rx_reported = instance->rx_tail;
+        }
+        
+        if (status == EER_HAL_OK && request->index < total) {
+            return;
+        }
+        
+        eer_async_dequeue(&instance->async);
+        eer_async_complete(request, status);
+    }
+}
+
+/**
+ * @brief Dispatch the pending events of one instance
+ */
+static void uart_poll(eer_uart_t* instance) {
+    uart_fill(instance);
+    uart_async_poll(instance);
+    
+    // Receive complete, once per byte
+    while (instance->rx_reported != instance->rx_head) {
+        uint8_t* data = &instance->rx_buffer[instance->rx_reported];
+        instance->rx_reported = (instance->rx_reported + 1) % EER_HOST_UART_RX_SIZE;
+        
+        // UART 0 is the default instance, 1 any other
+        eer_trace_isr(EER_TRACE_UART_RX_IRQ, (uint16_t)(instance != &uart0) << 8 | *data);
+        
+        if (instance->rx_handler != NULL) {
+            eer_uart_rx_event_t event = {
+                .uart = instance,
+                .data = data,
+                .size = 1,
+                .user_data = instance->rx_user_data
+            };
+            
+            host_power_wakeup(EER_WAKEUP_UART, 0);
+            instance->rx_handler(&event);
+            
+            // The callback consumes the byte
+            instance->rx_tail = instance->rx_reported;
+        }
+    }
+    
+    // Transmit complete
+    if (instance->tx_pending) {
+        instance->tx_pending = false;
+        
+        eer_trace_isr(EER_TRACE_UART_TX_IRQ, instance != &uart0);
+        
+        if (instance->tx_handler != NULL) {
+            eer_uart_tx_event_t event = {
+                .uart = instance,
+                .user_data = instance->tx_user_data
+            };
+            
+            instance->tx_handler(&event);
+        }
+    }
+}
+
+void host_uart_poll(void) {
+    eer_uart_t* uart = uart_instances;
+    
+    // Handlers may deinitialize their own instance
+    while (uart != NULL) {
+        eer_uart_t* next = uart->next;
+        uart_poll(uart);
+        uart = next;
+    }
+}
+
+eer_hal_status_t host_uart_instance_init(void* uart, eer_uart_config_t* config) {
+    eer_uart_t* instance = (eer_uart_t*)uart;
+    
+    if (instance == NULL || config == NULL || config->baudrate == 0) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Reset buffer indices
+    instance->rx_head = 0;
+    instance->rx_tail = 0;
+    instance->rx_reported = 0;
+    instance->tx_pending = false;
+    uart_link(instance);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_uart_instance_deinit(void* uart) {
+    eer_uart_t* instance = (eer_uart_t*)uart;
+    
+    if (instance == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Clear callback handlers
+    instance->rx_handler = NULL;
+    instance->rx_user_data = NULL;
+    instance->tx_handler = NULL;
+    instance->tx_user_data = NULL;
+    
+    eer_async_cancel(&instance->async, EER_HAL_ERROR);
+    
+    // Instances may go out of scope once deinitialized
+    if (instance != &uart0) {
+        uart_unlink(instance);
+    }
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_uart_instance_transmit(void* uart, const uint8_t* data, uint16_t size, uint32_t timeout) {
+    eer_uart_t* instance = (eer_uart_t*)uart;
+    
+    if (instance == NULL || data == NULL || size == 0) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    if (instance->async.head != NULL) {
+        return EER_HAL_BUSY;
+    }
+    
+    eer_trace(EER_TRACE_UART_TRANSMIT, size);
+    
+    eer_hal_status_t status = uart_write(instance, data, size, timeout);
+    if (status != EER_HAL_OK) {
+        return status;
+    }
+    
+    host_poll();
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_uart_instance_receive(void* uart, uint8_t* data, uint16_t size, uint32_t timeout) {
+    eer_uart_t* instance = (eer_uart_t*)uart;
+    
+    if (instance == NULL || data == NULL || size == 0 || size >= EER_HOST_UART_RX_SIZE) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    if (instance->async.head != NULL) {
+        return EER_HAL_BUSY;
+    }
+    
+    eer_trace(EER_TRACE_UART_RECEIVE, size);
+    
+    uint64_t deadline = host_time_us() + (uint64_t)timeout * 1000;
+    
+    host_poll();
+    uart_fill(instance);
+    
+    // Non-blocking requests are served whole or not at all
+    while (uart_rx_count(instance) < size) {
+        if (timeout == 0) {
+            return EER_HAL_BUSY;
+        }
+        
+        bool expired = host_wait_until(deadline);
+        uart_fill(instance);
+        
+        if (expired && uart_rx_count(instance) < size) {
+            return EER_HAL_TIMEOUT;
+        }
+    }
+    
+    for (uint16_t i = 0; i < size; i++) {
+        data[i] = instance->rx_buffer[instance->rx_tail];
+        instance->rx_tail = (instance->rx_tail + 1) % EER_HOST_UART_RX_SIZE;
+    }
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_uart_instance_is_tx_ready(void* uart, bool* ready) {
+    if (uart == NULL || ready == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Transmission completes within transmit()
+    *ready = true;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_uart_instance_is_rx_ready(void* uart, bool* ready) {
+    eer_uart_t* instance = (eer_uart_t*)uart;
+    
+    if (instance == NULL || ready == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    host_poll();
+    uart_fill(instance);
+    
+    *ready = uart_rx_count(instance) > 0;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_uart_instance_register_rx_callback(void* uart, eer_uart_rx_handler_t handler, void* user_data) {
+    eer_uart_t* instance = (eer_uart_t*)uart;
+    
+    if (instance == NULL || handler == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Store the handler and user data
+    instance->rx_handler = handler;
+    instance->rx_user_data = user_data;
+    
+    // Report only bytes that arrive from now on
+    instance->rx_reported = instance->rx_head;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_uart_instance_unregister_rx_callback(void* uart) {
+    eer_uart_t* instance = (eer_uart_t*)uart;
+    
+    if (instance == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Clear the handler and user data
+    instance->rx_handler = NULL;
+    instance->rx_user_data = NULL;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_uart_instance_register_tx_callback(void* uart, eer_uart_tx_handler_t handler, void* user_data) {
+    eer_uart_t* instance = (eer_uart_t*)uart;
+    
+    if (instance == NULL || handler == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Store the handler and user data
+    instance->tx_handler = handler;
+    instance->tx_user_data = user_data;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t host_uart_instance_unregister_tx_callback(void* uart) {
+    eer_uart_t* instance = (eer_uart_t*)uart;
+    
+    if (instance == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Clear the handler and user data
+    instance->tx_handler = NULL;
+    instance->tx_user_data = NULL;
+    
+    return EER_HAL_OK;
+}
+
+// Single-instance operations on UART0
+eer_hal_status_t host_uart_init(eer_uart_config_t* config) {
+    return host_uart_instance_init(&uart0, config);
+}
+
+eer_hal_status_t host_uart_deinit(void) {
+    return host_uart_instance_deinit(&uart0);
+}
+
+eer_hal_status_t host_uart_transmit(const uint8_t* data, uint16_t size, uint32_t timeout) {
+    return host_uart_instance_transmit(&uart0, data, size, timeout);
+}
+
+eer_hal_status_t host_uart_receive(uint8_t* data, uint16_t size, uint32_t timeout) {
+    return host_uart_instance_receive(&uart0, data, size, timeout);
+}
+
+eer_hal_status_t host_uart_is_tx_ready(bool* ready) {
+    return host_uart_instance_is_tx_ready(&uart0, ready);
+}
+
+eer_hal_status_t host_uart_is_rx_ready(bool* ready) {
+    return host_uart_instance_is_rx_ready(&uart0, ready);
+}
+
+eer_hal_status_t host_uart_register_rx_callback(eer_uart_rx_handler_t handler, void* user_data) {
+    return host_uart_instance_register_rx_callback(&uart0, handler, user_data);
+}
+
+eer_hal_status_t host_uart_unregister_rx_callback(void) {
+    return host_uart_instance_unregister_rx_callback(&uart0);
+}
+
+eer_hal_status_t host_uart_register_tx_callback(eer_uart_tx_handler_t handler, void* user_data) {
+    return host_uart_instance_register_tx_callback(&uart0, handler, user_data);
+}
+
+eer_hal_status_t host_uart_unregister_tx_callback(void) {
+    return host_uart_instance_unregister_tx_callback(&uart0);
+}
+
+eer_hal_status_t host_uart_submit(eer_async_request_t* request) {
+    eer_uart_t* instance = request != NULL && request->device != NULL ? (eer_uart_t*)request->device : &uart0;
+    
+    eer_hal_status_t status = eer_async_prepare(request);
+    if (status != EER_HAL_OK) {
+        return status;
+    }
+    
+    eer_trace(request->tx_size > 0 ? EER_TRACE_UART_TRANSMIT : EER_TRACE_UART_RECEIVE,
+              request->tx_size > 0 ? request->tx_size : request->rx_size);
+              
+    // Run by the poll, like an interrupt
+    eer_async_enqueue(&instance->async, request);
+    uart_link(instance);
+    host_poll();
+    
+    return EER_HAL_OK;
+}
+
+// UART handler structure with function pointers
+eer_uart_handler_t eer_host_uart = {
+    .init = host_uart_init,
+    .deinit = host_uart_deinit,
+    .transmit = host_uart_transmit,
+    .receive = host_uart_receive,
+    .is_tx_ready = host_uart_is_tx_ready,
+    .is_rx_ready = host_uart_is_rx_ready,
+    .register_rx_callback = host_uart_register_rx_callback,
+    .unregister_rx_callback = host_uart_unregister_rx_callback,
+    .register_tx_callback = host_uart_register_tx_callback,
+    .unregister_tx_callback = host_uart_unregister_tx_callback,
+    .submit = host_uart_submit
+};
+
+// UART instance handler structure with function pointers
+eer_uart_instance_handler_t eer_host_uart_instance = {
+    .init = host_uart_instance_init,
+    .deinit = host_uart_instance_deinit,
+    .transmit = host_uart_instance_transmit,
+    .receive = host_uart_instance_receive,
+    .is_tx_ready = host_uart_instance_is_tx_ready,
+    .is_rx_ready = host_uart_instance_is_rx_ready,
+    .register_rx_callback = host_uart_instance_register_rx_callback,
+    .unregister_rx_callback = host_uart_instance_unregister_rx_callback,
+    .register_tx_callback = host_uart_instance_register_tx_callback,
+    .unregister_tx_callback = host_uart_instance_unregister_tx_callback
+};
@@ -0,0 +1,64 @@
+#include "platforms/riscv/adc.h"
+
+// The emulated machines have no ADC, every operation reports EER_HAL_NOT_SUPPORTED
+
+eer_hal_status_t riscv_adc_init(eer_adc_config_t* config) {
+    (void)config;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_adc_deinit(void) {
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_adc_start_conversion(void* channel) {
+    (void)channel;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_adc_stop_conversion(void) {
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_adc_is_conversion_complete(void* channel, bool* complete) {
+    (void)channel;
+    (void)complete;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_adc_read(void* channel, uint16_t* value) {
+    (void)channel;
+    (void)value;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_adc_read_voltage(void* channel, float* voltage) {
+    (void)channel;
+    (void)voltage;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_adc_register_callback(void* channel, eer_adc_conversion_complete_handler_t handler, void* user_data) {
+    (void)channel;
+    (void)handler;
+    (void)user_data;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_adc_unregister_callback(void* channel) {
+    (void)channel;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+// ADC handler structure with function pointers
+eer_adc_handler_t eer_riscv_adc = {
+    .init = riscv_adc_init,
+    .deinit = riscv_adc_deinit,
+    .start_conversion = riscv_adc_start_conversion,
+    .stop_conversion = riscv_adc_stop_conversion,
+    .is_conversion_complete = riscv_adc_is_conversion_complete,
+    .read = riscv_adc_read,
+    .read_voltage = riscv_adc_read_voltage,
+    .register_callback = riscv_adc_register_callback,
+    .unregister_callback = riscv_adc_unregister_callback
+};
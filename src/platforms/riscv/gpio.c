@@ -0,0 +1,320 @@
+#include "platforms/riscv/gpio.h"
+#include "platforms/riscv/power.h"
+#include <stddef.h>
+
+#if EER_RISCV_GPIO_PINS > 0
+/*
+ * SiFive GPIO: one bit per pin in each register
+ */
+#define GPIO_INPUT_VAL  0x00
+#define GPIO_INPUT_EN   0x04
+#define GPIO_OUTPUT_EN  0x08
+#define GPIO_OUTPUT_VAL 0x0C
+#define GPIO_PUE        0x10
+#define GPIO_RISE_IE    0x18
+#define GPIO_RISE_IP    0x1C
+#define GPIO_FALL_IE    0x20
+#define GPIO_FALL_IP    0x24
+#define GPIO_IOF_EN     0x38
+#define GPIO_IOF_SEL    0x3C
+
+#define GPIO_REG(offset) RISCV_REG32(EER_RISCV_GPIO_BASE, offset)
+
+// Interrupt configuration of each pin
+static struct {
+    void*                  pin;
+    eer_gpio_irq_handler_t handler;
+    void*                  user_data;
+    eer_gpio_trigger_t     trigger;
+} gpio_irq_handlers[EER_RISCV_GPIO_PINS];
+
+/**
+ * @brief Validate a pin
+ * @return Bit of the pin, 0 for an invalid pin
+ */
+static uint32_t gpio_bit(void* pin) {
+    if (pin == NULL || ((eer_pin_t*)pin)->number >= EER_RISCV_GPIO_PINS) {
+        return 0;
+    }
+    
+    return 1UL << ((eer_pin_t*)pin)->number;
+}
+
+/**
+ * @brief Set or clear the bits of a register shared with other pins
+ */
+static void gpio_modify(uint32_t offset, uint32_t bits, bool set) {
+    unsigned long mstatus = riscv_interrupts_lock();
+    
+    if (set) {
+        GPIO_REG(offset) |= bits;
+    } else {
+        GPIO_REG(offset) &= ~bits;
+    }
+    
+    riscv_interrupts_restore(mstatus);
+}
+
+eer_hal_status_t riscv_gpio_init(void) {
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_gpio_deinit(void) {
+    // Disable and clear all pin interrupts
+    GPIO_REG(GPIO_RISE_IE) = 0;
+    GPIO_REG(GPIO_FALL_IE) = 0;
+    GPIO_REG(GPIO_RISE_IP) = UINT32_MAX;
+    GPIO_REG(GPIO_FALL_IP) = UINT32_MAX;
+    
+    for (uint8_t i = 0; i < EER_RISCV_GPIO_PINS; i++) {
+        if (gpio_irq_handlers[i].handler != NULL) {
+            riscv_irq_detach(EER_RISCV_GPIO_IRQ + i);
+            gpio_irq_handlers[i].handler = NULL;
+        }
+    }
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_gpio_configure(void *pin, eer_gpio_config_t* config) {
+    uint32_t bit = gpio_bit(pin);
+    
+    if (bit == 0 || config == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    switch (config->mode) {
+        case EER_GPIO_MODE_INPUT:
+        case EER_GPIO_MODE_INPUT_PULLUP:
+            gpio_modify(GPIO_IOF_EN, bit, false);
+            gpio_modify(GPIO_OUTPUT_EN, bit, false);
+            gpio_modify(GPIO_PUE, bit, config->mode == EER_GPIO_MODE_INPUT_PULLUP);
+            gpio_modify(GPIO_INPUT_EN, bit, true);
+            break;
+            
+        case EER_GPIO_MODE_OUTPUT:
+            // The input stays enabled so reads return the pin level
+            gpio_modify(GPIO_IOF_EN, bit, false);
+            gpio_modify(GPIO_PUE, bit, false);
+            gpio_modify(GPIO_INPUT_EN, bit, true);
+            gpio_modify(GPIO_OUTPUT_EN, bit, true);
+            break;
+            
+        case EER_GPIO_MODE_ALTERNATE:
+            // IOF0 or IOF1 drives the pin
+            if (config->alternate > 1) {
+                return EER_HAL_INVALID_PARAM;
+            }
+            gpio_modify(GPIO_IOF_SEL, bit, config->alternate == 1);
+            gpio_modify(GPIO_IOF_EN, bit, true);
+            break;
+            
+        default:
+            // No pull-down, open-drain or analog function
+            return EER_HAL_NOT_SUPPORTED;
+    }
+    
+    gpio_irq_handlers[((eer_pin_t*)pin)->number].trigger = config->trigger;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_gpio_write(void *pin, bool value) {
+    uint32_t bit = gpio_bit(pin);
+    
+    if (bit == 0) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    gpio_modify(GPIO_OUTPUT_VAL, bit, value);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_gpio_read(void *pin, bool *value) {
+    uint32_t bit = gpio_bit(pin);
+    
+    if (bit == 0 || value == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    *value = (GPIO_REG(GPIO_INPUT_VAL) & bit) != 0;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_gpio_toggle(void *pin) {
+    uint32_t bit = gpio_bit(pin);
+    
+    if (bit == 0) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    unsigned long mstatus = riscv_interrupts_lock();
+    GPIO_REG(GPIO_OUTPUT_VAL) ^= bit;
+    riscv_interrupts_restore(mstatus);
+    
+    return EER_HAL_OK;
+}
+
+/**
+ * @brief Interrupt of one pin
+ * @param context Pin number
+ */
+static void gpio_isr(void* context) {
+    uint8_t number = (uint8_t)(uintptr_t)context;
+    uint32_t bit = 1UL << number;
+    
+    // Pending bits are cleared by writing one
+    GPIO_REG(GPIO_RISE_IP) = bit;
+    GPIO_REG(GPIO_FALL_IP) = bit;
+    
+    riscv_power_wakeup(EER_WAKEUP_PIN, number);
+    
+    if (gpio_irq_handlers[number].handler != NULL) {
+        eer_gpio_irq_t irq = {
+            .pin = gpio_irq_handlers[number].pin,
+            .user_data = gpio_irq_handlers[number].user_data
+        };
+        
+        gpio_irq_handlers[number].handler(&irq);
+    }
+}
+
+eer_hal_status_t riscv_gpio_register_irq(void *pin, eer_gpio_irq_handler_t handler, void* user_data) {
+    uint32_t bit = gpio_bit(pin);
+    
+    if (bit == 0 || handler == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    uint8_t number = ((eer_pin_t*)pin)->number;
+    
+    gpio_irq_handlers[number].pin = pin;
+    gpio_irq_handlers[number].handler = handler;
+    gpio_irq_handlers[number].user_data = user_data;
+    
+    return riscv_irq_attach(EER_RISCV_GPIO_IRQ + number, gpio_isr, (void*)(uintptr_t)number);
+}
+
+eer_hal_status_t riscv_gpio_unregister_irq(void *pin) {
+    uint32_t bit = gpio_bit(pin);
+    
+    if (bit == 0) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    uint8_t number = ((eer_pin_t*)pin)->number;
+    
+    riscv_gpio_disable_irq(pin);
+    riscv_irq_detach(EER_RISCV_GPIO_IRQ + number);
+    
+    gpio_irq_handlers[number].pin = NULL;
+    gpio_irq_handlers[number].handler = NULL;
+    gpio_irq_handlers[number].user_data = NULL;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_gpio_enable_irq(void *pin) {
+    uint32_t bit = gpio_bit(pin);
+    
+    if (bit == 0) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_gpio_trigger_t trigger = gpio_irq_handlers[((eer_pin_t*)pin)->number].trigger;
+    
+    // Drop edges seen before
+    GPIO_REG(GPIO_RISE_IP) = bit;
+    GPIO_REG(GPIO_FALL_IP) = bit;
+    
+    gpio_modify(GPIO_RISE_IE, bit, trigger == EER_GPIO_TRIGGER_RISING || trigger == EER_GPIO_TRIGGER_BOTH);
+    gpio_modify(GPIO_FALL_IE, bit, trigger == EER_GPIO_TRIGGER_FALLING || trigger == EER_GPIO_TRIGGER_BOTH);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_gpio_disable_irq(void *pin) {
+    uint32_t bit = gpio_bit(pin);
+    
+    if (bit == 0) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    gpio_modify(GPIO_RISE_IE, bit, false);
+    gpio_modify(GPIO_FALL_IE, bit, false);
+    
+    return EER_HAL_OK;
+}
+#else
+/*
+ * The machine has no GPIO block
+ */
+eer_hal_status_t riscv_gpio_init(void) {
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_gpio_deinit(void) {
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_gpio_configure(void *pin, eer_gpio_config_t* config) {
+    (void)pin;
+    (void)config;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_gpio_write(void *pin, bool value) {
+    (void)pin;
+    (void)value;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_gpio_read(void *pin, bool *value) {
+    (void)pin;
+    (void)value;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_gpio_toggle(void *pin) {
+    (void)pin;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_gpio_register_irq(void *pin, eer_gpio_irq_handler_t handler, void* user_data) {
+    (void)pin;
+    (void)handler;
+    (void)user_data;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_gpio_unregister_irq(void *pin) {
+    (void)pin;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_gpio_enable_irq(void *pin) {
+    (void)pin;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_gpio_disable_irq(void *pin) {
+    (void)pin;
+    return EER_HAL_NOT_SUPPORTED;
+}
+#endif
+
+// GPIO handler structure with function pointers
+eer_gpio_handler_t eer_riscv_gpio = {
+    .init = riscv_gpio_init,
+    .deinit = riscv_gpio_deinit,
+    .configure = riscv_gpio_configure,
+    .write = riscv_gpio_write,
+    .read = riscv_gpio_read,
+    .toggle = riscv_gpio_toggle,
+    .register_irq = riscv_gpio_register_irq,
+    .unregister_irq = riscv_gpio_unregister_irq,
+    .enable_irq = riscv_gpio_enable_irq,
+    .disable_irq = riscv_gpio_disable_irq
+};
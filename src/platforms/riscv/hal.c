@@ -0,0 +1,26 @@
+#include "eer_hal.h"
+#include "platforms/riscv/hal.h"
+#include "platforms/riscv/gpio.h"
+#include "platforms/riscv/adc.h"
+#include "platforms/riscv/uart.h"
+#include "platforms/riscv/spi.h"
+#include "platforms/riscv/i2c.h"
+#include "platforms/riscv/timer.h"
+#include "platforms/riscv/system.h"
+#include "platforms/riscv/power.h"
+#include "platforms/riscv/nvs.h"
+
+// Global HAL instance for the RISC-V platform
+eer_hal_t eer_hal = {
+    .gpio = &eer_riscv_gpio,
+    .adc = &eer_riscv_adc,
+    .uart = &eer_riscv_uart,
+    .spi = &eer_riscv_spi,
+    .i2c = &eer_riscv_i2c,
+    .timer = &eer_riscv_timer,
+    .system = &eer_riscv_system,
+    .power = &eer_riscv_power,
+    .nvs = &eer_riscv_nvs,
+    .uart_instance = &eer_riscv_uart_instance,
+    .timer_instance = &eer_riscv_timer_instance
+};
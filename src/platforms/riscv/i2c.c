@@ -0,0 +1,79 @@
+#include "platforms/riscv/i2c.h"
+
+// No I2C controller on the emulated machines, every operation reports EER_HAL_NOT_SUPPORTED
+
+eer_hal_status_t riscv_i2c_init(eer_i2c_config_t* config) {
+    (void)config;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_i2c_deinit(void) {
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_i2c_master_transmit(uint16_t address, const uint8_t* data, uint16_t size, uint32_t timeout) {
+    (void)address;
+    (void)data;
+    (void)size;
+    (void)timeout;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_i2c_master_receive(uint16_t address, uint8_t* data, uint16_t size, uint32_t timeout) {
+    (void)address;
+    (void)data;
+    (void)size;
+    (void)timeout;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_i2c_master_transmit_receive(uint16_t address, const uint8_t* tx_data, uint16_t tx_size, uint8_t* rx_data, uint16_t rx_size, uint32_t timeout) {
+    (void)address;
+    (void)tx_data;
+    (void)tx_size;
+    (void)rx_data;
+    (void)rx_size;
+    (void)timeout;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_i2c_is_busy(bool* busy) {
+    (void)busy;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_i2c_scan(uint16_t* devices, uint8_t max_devices, uint8_t* found_devices) {
+    (void)devices;
+    (void)max_devices;
+    (void)found_devices;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_i2c_register_callback(eer_i2c_transfer_handler_t handler, void* user_data) {
+    (void)handler;
+    (void)user_data;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_i2c_unregister_callback(void) {
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_i2c_submit(eer_async_request_t* request) {
+    (void)request;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+// I2C handler structure with function pointers
+eer_i2c_handler_t eer_riscv_i2c = {
+    .init = riscv_i2c_init,
+    .deinit = riscv_i2c_deinit,
+    .master_transmit = riscv_i2c_master_transmit,
+    .master_receive = riscv_i2c_master_receive,
+    .master_transmit_receive = riscv_i2c_master_transmit_receive,
+    .is_busy = riscv_i2c_is_busy,
+    .scan = riscv_i2c_scan,
+    .register_callback = riscv_i2c_register_callback,
+    .unregister_callback = riscv_i2c_unregister_callback,
+    .submit = riscv_i2c_submit
+};
@@ -0,0 +1,72 @@
+#include "platforms/riscv/nvs.h"
+
+// No non-volatile storage on the emulated machines, every operation reports EER_HAL_NOT_SUPPORTED
+
+eer_hal_status_t riscv_nvs_init(void) {
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_nvs_deinit(void) {
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_nvs_read(uint32_t address, uint8_t* data, uint16_t size) {
+    (void)address;
+    (void)data;
+    (void)size;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_nvs_write(uint32_t address, const uint8_t* data, uint16_t size, uint32_t timeout) {
+    (void)address;
+    (void)data;
+    (void)size;
+    (void)timeout;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_nvs_erase(uint32_t address, uint16_t size, uint32_t timeout) {
+    (void)address;
+    (void)size;
+    (void)timeout;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_nvs_flush(uint32_t timeout) {
+    (void)timeout;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_nvs_is_busy(bool* busy) {
+    (void)busy;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_nvs_get_size(uint32_t* size) {
+    (void)size;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_nvs_register_callback(eer_nvs_write_handler_t handler, void* user_data) {
+    (void)handler;
+    (void)user_data;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_nvs_unregister_callback(void) {
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+// NVS handler structure with function pointers
+eer_nvs_handler_t eer_riscv_nvs = {
+    .init = riscv_nvs_init,
+    .deinit = riscv_nvs_deinit,
+    .read = riscv_nvs_read,
+    .write = riscv_nvs_write,
+    .erase = riscv_nvs_erase,
+    .flush = riscv_nvs_flush,
+    .is_busy = riscv_nvs_is_busy,
+    .get_size = riscv_nvs_get_size,
+    .register_callback = riscv_nvs_register_callback,
+    .unregister_callback = riscv_nvs_unregister_callback
+};
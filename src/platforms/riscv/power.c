@@ -0,0 +1,174 @@
+#include "platforms/riscv/power.h"
+#include "eer_trace.h"
+#include <stddef.h>
+
+// Current power mode
+static eer_power_mode_t current_power_mode = EER_POWER_MODE_RUN;
+
+// Last wakeup source
+static volatile struct {
+    eer_wakeup_source_t source;
+    uint8_t pin_or_id;
+} last_wakeup = {0};
+
+// Enabled wakeup sources, one bit per eer_wakeup_source_t
+static uint8_t wakeup_sources = 0;
+
+// Set while sleeping, cleared by the interrupt that ends the sleep
+static volatile bool power_sleeping = false;
+static bool power_any_event = false;
+
+void riscv_power_wakeup(eer_wakeup_source_t source, uint8_t pin_or_id) {
+    if (!power_sleeping) {
+        return;
+    }
+    
+    if (!power_any_event && !(wakeup_sources & (1 << source))) {
+        return;
+    }
+    
+    last_wakeup.source = source;
+    last_wakeup.pin_or_id = pin_or_id;
+    power_sleeping = false;
+}
+
+/**
+ * @brief Wait for interrupts until a wakeup event
+ * @param any_event true if every event wakes, false for enabled sources only
+ * @return Status code indicating success or failure
+ */
+static eer_hal_status_t power_sleep(bool any_event) {
+    // Nothing could wake the hart without an enabled interrupt
+    if (!riscv_interrupts_enabled()
+        || !(riscv_csr_read(mie) & (RISCV_MIE_MTIE | RISCV_MIE_MEIE))) {
+        return EER_HAL_ERROR;
+    }
+    
+    power_any_event = any_event;
+    power_sleeping = true;
+    
+    eer_trace(EER_TRACE_POWER_SLEEP, current_power_mode);
+    
+    while (power_sleeping) {
+        // Pending interrupts end wfi while masked, the handler runs on restore
+        unsigned long mstatus = riscv_interrupts_lock();
+        if (power_sleeping) {
+            riscv_wfi();
+        }
+        riscv_interrupts_restore(mstatus);
+    }
+    
+    eer_trace(EER_TRACE_POWER_WAKEUP, (uint16_t)last_wakeup.source << 8 | last_wakeup.pin_or_id);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_power_init(void) {
+    current_power_mode = EER_POWER_MODE_RUN;
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_power_deinit(void) {
+    wakeup_sources = 0;
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_power_set_mode(eer_power_mode_t mode) {
+    eer_hal_status_t status = EER_HAL_OK;
+    
+    switch (mode) {
+        case EER_POWER_MODE_RUN:
+            // Already in run mode, nothing to do
+            break;
+            
+        case EER_POWER_MODE_SLEEP:
+            status = power_sleep(true);
+            break;
+            
+        case EER_POWER_MODE_DEEP_SLEEP:
+        case EER_POWER_MODE_STANDBY:
+            status = power_sleep(false);
+            break;
+            
+        default:
+            return EER_HAL_INVALID_PARAM;
+    }
+    
+    current_power_mode = mode;
+    return status;
+}
+
+eer_hal_status_t riscv_power_get_mode(eer_power_mode_t* mode) {
+    if (mode == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    *mode = current_power_mode;
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_power_enable_wakeup_source(eer_wakeup_source_t source, uint8_t pin_or_id) {
+    (void)pin_or_id;
+    
+    if (source > EER_WAKEUP_UART) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    wakeup_sources |= (1 << source);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_power_disable_wakeup_source(eer_wakeup_source_t source, uint8_t pin_or_id) {
+    (void)pin_or_id;
+    
+    if (source > EER_WAKEUP_UART) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    wakeup_sources &= ~(1 << source);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_power_get_wakeup_source(eer_wakeup_source_t* source, uint8_t* pin_or_id) {
+    if (source == NULL || pin_or_id == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    *source = last_wakeup.source;
+    *pin_or_id = last_wakeup.pin_or_id;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_power_get_voltage(uint16_t* voltage_mv) {
+    if (voltage_mv == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // No supply monitor on the emulated machines
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_power_get_power_consumption(uint16_t* power_mw) {
+    if (power_mw == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // No supply monitor on the emulated machines
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+// Power handler structure with function pointers
+eer_power_handler_t eer_riscv_power = {
+    .init = riscv_power_init,
+    .deinit = riscv_power_deinit,
+    .set_mode = riscv_power_set_mode,
+    .get_mode = riscv_power_get_mode,
+    .enable_wakeup_source = riscv_power_enable_wakeup_source,
+    .disable_wakeup_source = riscv_power_disable_wakeup_source,
+    .get_wakeup_source = riscv_power_get_wakeup_source,
+    .get_voltage = riscv_power_get_voltage,
+    .get_power_consumption = riscv_power_get_power_consumption
+};
@@ -0,0 +1,80 @@
+#include "platforms/riscv/spi.h"
+
+// No SPI controller on the emulated machines, every operation reports EER_HAL_NOT_SUPPORTED
+
+eer_hal_status_t riscv_spi_init(eer_spi_config_t* config) {
+    (void)config;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_spi_deinit(void) {
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_spi_transfer(const uint8_t* tx_data, uint8_t* rx_data, uint16_t size, uint32_t timeout) {
+    (void)tx_data;
+    (void)rx_data;
+    (void)size;
+    (void)timeout;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_spi_transmit(const uint8_t* data, uint16_t size, uint32_t timeout) {
+    (void)data;
+    (void)size;
+    (void)timeout;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_spi_receive(uint8_t* data, uint16_t size, uint32_t timeout) {
+    (void)data;
+    (void)size;
+    (void)timeout;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_spi_is_ready(bool* ready) {
+    (void)ready;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_spi_chip_select(void* pin, bool state) {
+    (void)pin;
+    (void)state;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_spi_set_prescaler(eer_spi_prescaler_t prescaler) {
+    (void)prescaler;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_spi_register_callback(eer_spi_transfer_handler_t handler, void* user_data) {
+    (void)handler;
+    (void)user_data;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_spi_unregister_callback(void) {
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+eer_hal_status_t riscv_spi_submit(eer_async_request_t* request) {
+    (void)request;
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+// SPI handler structure with function pointers
+eer_spi_handler_t eer_riscv_spi = {
+    .init = riscv_spi_init,
+    .deinit = riscv_spi_deinit,
+    .transfer = riscv_spi_transfer,
+    .transmit = riscv_spi_transmit,
+    .receive = riscv_spi_receive,
+    .is_ready = riscv_spi_is_ready,
+    .chip_select = riscv_spi_chip_select,
+    .set_prescaler = riscv_spi_set_prescaler,
+    .register_callback = riscv_spi_register_callback,
+    .unregister_callback = riscv_spi_unregister_callback,
+    .submit = riscv_spi_submit
+};
@@ -0,0 +1,119 @@
+#include "platforms/riscv/riscv.h"
+#include "platforms/riscv/uart.h"
+#include <stddef.h>
+#include <errno.h>
+#include <sys/stat.h>
+
+/*
+ * System calls of newlib: standard output and error go to the default
+ * UART, so printf() works as on the host platform; other files do not
+ * exist.
+ */
+
+// Test device commands
+#define TEST_PASS  0x5555
+#define TEST_FAIL  0x3333
+
+// Bounds of the heap, from the linker script
+extern char _end[];
+extern char __stack_bottom[];
+
+void riscv_exit(int code) {
+    riscv_interrupts_lock();
+    riscv_uart_flush();
+    
+#ifdef EER_RISCV_TEST_BASE
+    RISCV_REG32(EER_RISCV_TEST_BASE, 0) = code == 0 ? TEST_PASS : (uint32_t)code << 16 | TEST_FAIL;
+#else
+    (void)code;
+#endif
+
+    for (;;) {
+        riscv_wfi();
+    }
+}
+
+void _exit(int code) {
+    riscv_exit(code);
+}
+
+int _write(int fd, const void* data, size_t size) {
+    if (fd != 1 && fd != 2) {
+        errno = EBADF;
+        return -1;
+    }
+    
+    // newlib writes the rest of a short write again
+    uint16_t chunk = size > UINT16_MAX ? UINT16_MAX : (uint16_t)size;
+    
+    if (chunk > 0 && riscv_uart_transmit((const uint8_t*)data, chunk, 0) != EER_HAL_OK) {
+        errno = EIO;
+        return -1;
+    }
+    
+    return chunk;
+}
+
+int _read(int fd, void* data, size_t size) {
+    if (fd != 0) {
+        errno = EBADF;
+        return -1;
+    }
+    
+    // One byte at a time, like a terminal in raw mode
+    if (size > 0 && riscv_uart_receive((uint8_t*)data, 1, 0) != EER_HAL_OK) {
+        errno = EIO;
+        return -1;
+    }
+    
+    return size > 0 ? 1 : 0;
+}
+
+void* _sbrk(ptrdiff_t increment) {
+    static char* brk = _end;
+    char* previous = brk;
+    
+    if (increment > __stack_bottom - brk || increment < _end - brk) {
+        errno = ENOMEM;
+        return (void*)-1;
+    }
+    
+    brk += increment;
+    
+    return previous;
+}
+
+int _close(int fd) {
+    (void)fd;
+    errno = EBADF;
+    return -1;
+}
+
+int _fstat(int fd, struct stat* st) {
+    (void)fd;
+    st->st_mode = S_IFCHR;
+    return 0;
+}
+
+int _isatty(int fd) {
+    return fd >= 0 && fd <= 2;
+}
+
+int _lseek(int fd, int offset, int whence) {
+    (void)fd;
+    (void)offset;
+    (void)whence;
+    errno = ESPIPE;
+    return -1;
+}
+
+int _kill(int pid, int signal) {
+    (void)pid;
+    (void)signal;
+    errno = EINVAL;
+    return -1;
+}
+
+int _getpid(void) {
+    return 1;
+}
@@ -0,0 +1,183 @@
+#include "platforms/riscv/system.h"
+#include "platforms/riscv/timer.h"
+#include <stddef.h>
+
+// Test device command resetting the machine
+#define TEST_RESET 0x7777
+
+// mtime ticks per millisecond
+#define MTIME_PER_MS (EER_RISCV_MTIME_FREQUENCY / 1000)
+
+// Reset entry in start.S
+extern void _start(void);
+
+// mtime at initialization, time zero of get_tick()
+static uint64_t system_epoch = 0;
+
+// End of the running delay_ms(), UINT64_MAX if none
+static volatile uint64_t system_wakeup = UINT64_MAX;
+
+// Flag to track if system is initialized
+static bool system_initialized = false;
+
+void riscv_system_schedule(void) {
+    unsigned long mstatus = riscv_interrupts_lock();
+    
+    uint64_t deadline = riscv_timer_deadline();
+    if (system_wakeup < deadline) {
+        deadline = system_wakeup;
+    }
+    
+    // Disarm the machine timer while nothing is due
+    if (deadline == UINT64_MAX) {
+        riscv_csr_clear(mie, RISCV_MIE_MTIE);
+    } else {
+        riscv_mtimecmp_write(deadline);
+        riscv_csr_set(mie, RISCV_MIE_MTIE);
+    }
+    
+    riscv_interrupts_restore(mstatus);
+}
+
+void riscv_system_timer_isr(void) {
+    // A delay that ended is not waited for again
+    if (system_wakeup <= riscv_mtime()) {
+        system_wakeup = UINT64_MAX;
+    }
+    
+    riscv_timer_poll();
+    riscv_system_schedule();
+}
+
+eer_hal_status_t riscv_system_init(void) {
+    if (system_initialized) {
+        return EER_HAL_OK;
+    }
+    
+    system_epoch = riscv_mtime();
+    system_wakeup = UINT64_MAX;
+    
+    // Arm for the timers started before
+    riscv_system_schedule();
+    
+    // Enable global interrupts
+    riscv_csr_set(mstatus, RISCV_MSTATUS_MIE);
+    
+    system_initialized = true;
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_system_deinit(void) {
+    if (!system_initialized) {
+        return EER_HAL_OK;
+    }
+    
+    // Disable the machine timer interrupt
+    riscv_csr_clear(mie, RISCV_MIE_MTIE);
+    
+    system_initialized = false;
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_system_reset(eer_system_reset_type_t reset_type) {
+    switch (reset_type) {
+        case EER_SYSTEM_RESET_SOFT:
+            // Restart from the reset entry with interrupts off
+            riscv_interrupts_lock();
+            riscv_csr_write(mie, 0);
+            _start();
+            break;
+            
+        case EER_SYSTEM_RESET_HARD:
+#ifdef EER_RISCV_TEST_BASE
+            // The test device resets the whole machine
+            RISCV_REG32(EER_RISCV_TEST_BASE, 0) = TEST_RESET;
+            for (;;) {
+                riscv_wfi();
+            }
+#else
+            return EER_HAL_NOT_SUPPORTED;
+#endif
+
+        case EER_SYSTEM_RESET_WATCHDOG:
+            return EER_HAL_NOT_SUPPORTED;
+            
+        default:
+            return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Should never reach here
+    return EER_HAL_ERROR;
+}
+
+eer_hal_status_t riscv_system_disable_interrupts(void) {
+    riscv_csr_clear(mstatus, RISCV_MSTATUS_MIE);
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_system_enable_interrupts(void) {
+    riscv_csr_set(mstatus, RISCV_MSTATUS_MIE);
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_system_delay_ms(uint32_t ms) {
+    uint64_t deadline = riscv_mtime() + (uint64_t)ms * MTIME_PER_MS;
+    
+    // Sleep until the machine timer fires at the deadline; other
+    // interrupts wake the hart early and the wait goes on
+    while (riscv_mtime() < deadline) {
+        unsigned long mstatus = riscv_interrupts_lock();
+        
+        system_wakeup = deadline;
+        riscv_system_schedule();
+        
+        // Pending interrupts end wfi even while they are masked, so none
+        // is lost between the check and the sleep
+        if (riscv_mtime() < deadline) {
+            riscv_wfi();
+        }
+        
+        riscv_interrupts_restore(mstatus);
+    }
+    
+    system_wakeup = UINT64_MAX;
+    riscv_system_schedule();
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_system_delay_us(uint32_t us) {
+    uint64_t deadline = riscv_mtime() + riscv_us_to_mtime(us);
+    
+    while (riscv_mtime() < deadline);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_system_get_tick(uint32_t* ticks) {
+    if (ticks == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // One tick per millisecond, as on the other platforms
+    *ticks = (uint32_t)((riscv_mtime() - system_epoch) / MTIME_PER_MS);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_system_get_uptime_ms(uint32_t* uptime) {
+    return riscv_system_get_tick(uptime);
+}
+
+// System handler structure with function pointers
+eer_system_handler_t eer_riscv_system = {
+    .init = riscv_system_init,
+    .deinit = riscv_system_deinit,
+    .reset = riscv_system_reset,
+    .disable_interrupts = riscv_system_disable_interrupts,
+    .enable_interrupts = riscv_system_enable_interrupts,
+    .delay_ms = riscv_system_delay_ms,
+    .delay_us = riscv_system_delay_us,
+    .get_tick = riscv_system_get_tick,
+    .get_uptime_ms = riscv_system_get_uptime_ms
+};
@@ -0,0 +1,529 @@
+#include "platforms/riscv/timer.h"
+#include "platforms/riscv/system.h"
+#include "platforms/riscv/power.h"
+#include "eer_trace.h"
+#include <stddef.h>
+
+// Default timer instance for RISC-V
+static eer_timer_t timer0 = eer_hal_timer0();
+
+// Instances polled for events, linked through next
+static eer_timer_t* timer_instances = &timer0;
+
+static void timer_link(eer_timer_t* instance) {
+    for (eer_timer_t* timer = timer_instances; timer != NULL; timer = timer->next) {
+        if (timer == instance) {
+            return;
+        }
+    }
+    
+    instance->next = timer_instances;
+    timer_instances = instance;
+}
+
+static void timer_unlink(eer_timer_t* instance) {
+    for (eer_timer_t** link = &timer_instances; *link != NULL; link = &(*link)->next) {
+        if (*link == instance) {
+            *link = instance->next;
+            return;
+        }
+    }
+}
+
+static uint64_t timer_top(eer_timer_t* instance) {
+    return instance->period != 0 ? instance->period : 0x10000;
+}
+
+/**
+ * @brief Ticks counted since initialization
+ */
+static uint64_t timer_ticks(eer_timer_t* instance) {
+    if (!instance->running) {
+        return instance->ticks;
+    }
+    
+    // Split at whole seconds so the products cannot overflow
+    uint64_t elapsed = riscv_mtime() - instance->started;
+    
+    return instance->ticks + elapsed / EER_RISCV_MTIME_FREQUENCY * instance->frequency
+         + elapsed % EER_RISCV_MTIME_FREQUENCY * instance->frequency / EER_RISCV_MTIME_FREQUENCY;
+}
+
+/**
+ * @brief Tick count of the first event after a tick count
+ * @return Tick count, UINT64_MAX if no event has a handler
+ */
+static uint64_t timer_next_event(eer_timer_t* instance, uint64_t after) {
+    uint64_t top = timer_top(instance);
+    uint64_t period_start = after - after % top;
+    uint64_t next = UINT64_MAX;
+    
+    if (instance->overflow_handler != NULL) {
+        next = period_start + top;
+    }
+    
+    for (uint8_t channel = 0; channel < 2; channel++) {
+        if (instance->compare_handler[channel] == NULL || instance->compare[channel] >= top) {
+            continue;
+        }
+        
+        uint64_t match = period_start + instance->compare[channel];
+        if (match <= after) {
+            match += top;
+        }
+        
+        if (match < next) {
+            next = match;
+        }
+    }
+    
+    return next;
+}
+
+static void timer_notify(eer_timer_t* instance, eer_timer_event_handler_t handler,
+                         eer_timer_event_t type, uint32_t value, void* user_data) {
+    riscv_power_wakeup(EER_WAKEUP_TIMER, 0);
+    
+    if (handler != NULL) {
+        eer_timer_event_info_t event = {
+            .timer = instance,
+            .event = type,
+            .value = value,
+            .user_data = user_data
+        };
+        
+        handler(&event);
+    }
+}
+
+/**
+ * @brief mtime of the next event of one instance
+ */
+static uint64_t timer_deadline(eer_timer_t* instance) {
+    if (!instance->running) {
+        return UINT64_MAX;
+    }
+    
+    uint64_t next = timer_next_event(instance, instance->dispatched);
+    if (next == UINT64_MAX) {
+        return UINT64_MAX;
+    }
+    
+    // Round up so the counter has reached the event at the returned time
+    uint64_t ticks = next - instance->ticks;
+    
+    return instance->started + ticks / instance->frequency * EER_RISCV_MTIME_FREQUENCY
+         + (ticks % instance->frequency * EER_RISCV_MTIME_FREQUENCY + instance->frequency - 1) / instance->frequency;
+}
+
+/**
+ * @brief Dispatch the pending events of one instance
+ */
+static void timer_poll(eer_timer_t* instance) {
+    uint64_t now = timer_ticks(instance);
+    uint64_t top = timer_top(instance);
+    
+    // Dispatch every event up to now in order, handlers may change the timer
+    while (instance->running) {
+        uint64_t next = timer_next_event(instance, instance->dispatched);
+        if (next > now) {
+            break;
+        }
+        
+        instance->dispatched = next;
+        
+        uint32_t value = (uint32_t)(next % top);
+        
+        for (uint8_t channel = 0; channel < 2; channel++) {
+            if (instance->compare_handler[channel] != NULL && instance->compare[channel] == value) {
+                eer_trace_isr(EER_TRACE_TIMER_COMPARE, channel);
+                timer_notify(instance, instance->compare_handler[channel], EER_TIMER_EVENT_COMPARE,
+                             value, instance->compare_user_data[channel]);
+            }
+        }
+        
+        if (value == 0 && instance->overflow_handler != NULL) {
+            // A one-shot timer stops at the end of its period
+            if (instance->mode == EER_TIMER_MODE_ONE_SHOT) {
+                instance->ticks = next;
+                instance->running = false;
+            }
+            
+            eer_trace_isr(EER_TRACE_TIMER_OVERFLOW, 0);
+            timer_notify(instance, instance->overflow_handler, EER_TIMER_EVENT_OVERFLOW,
+                         value, instance->overflow_user_data);
+        }
+    }
+    
+    // Events without handlers are not delivered later
+    if (instance->running) {
+        instance->dispatched = now;
+    }
+}
+
+uint64_t riscv_timer_deadline(void) {
+    uint64_t deadline = UINT64_MAX;
+    
+    for (eer_timer_t* timer = timer_instances; timer != NULL; timer = timer->next) {
+        uint64_t next = timer_deadline(timer);
+        if (next < deadline) {
+            deadline = next;
+        }
+    }
+    
+    return deadline;
+}
+
+void riscv_timer_poll(void) {
+    eer_timer_t* timer = timer_instances;
+    
+    // Handlers may deinitialize their own instance
+    while (timer != NULL) {
+        eer_timer_t* next = timer->next;
+        timer_poll(timer);
+        timer = next;
+    }
+}
+
+eer_hal_status_t riscv_timer_instance_init(void* timer, eer_timer_config_t* config) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL || config == NULL || config->frequency > EER_RISCV_MTIME_FREQUENCY) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    instance->frequency = config->frequency != 0 ? config->frequency : EER_RISCV_TIMER_FREQUENCY;
+    instance->period = config->period;
+    instance->mode = config->mode;
+    instance->running = false;
+    instance->ticks = 0;
+    instance->dispatched = 0;
+    
+    unsigned long mstatus = riscv_interrupts_lock();
+    timer_link(instance);
+    riscv_interrupts_restore(mstatus);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_timer_instance_deinit(void* timer) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    unsigned long mstatus = riscv_interrupts_lock();
+    
+    // Stop the timer
+    instance->running = false;
+    
+    // Clear all callback handlers
+    instance->overflow_handler = NULL;
+    instance->overflow_user_data = NULL;
+    for (uint8_t channel = 0; channel < 2; channel++) {
+        instance->compare_handler[channel] = NULL;
+        instance->compare_user_data[channel] = NULL;
+    }
+    
+    // Instances may go out of scope once deinitialized
+    if (instance != &timer0) {
+        timer_unlink(instance);
+    }
+    
+    riscv_system_schedule();
+    riscv_interrupts_restore(mstatus);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_timer_instance_start(void* timer) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_trace(EER_TRACE_TIMER_START, 0);
+    
+    unsigned long mstatus = riscv_interrupts_lock();
+    if (!instance->running) {
+        instance->started = riscv_mtime();
+        instance->running = true;
+        riscv_system_schedule();
+    }
+    riscv_interrupts_restore(mstatus);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_timer_instance_stop(void* timer) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_trace(EER_TRACE_TIMER_STOP, 0);
+    
+    unsigned long mstatus = riscv_interrupts_lock();
+    if (instance->running) {
+        instance->ticks = timer_ticks(instance);
+        instance->running = false;
+        riscv_system_schedule();
+    }
+    riscv_interrupts_restore(mstatus);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_timer_instance_set_period(void* timer, uint32_t period) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL || period > 0x10000) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    unsigned long mstatus = riscv_interrupts_lock();
+    instance->period = period;
+    riscv_system_schedule();
+    riscv_interrupts_restore(mstatus);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_timer_instance_get_value(void* timer, uint32_t* value) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL || value == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    *value = (uint32_t)(timer_ticks(instance) % timer_top(instance));
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_timer_instance_set_compare(void* timer, uint8_t channel, uint32_t value) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL || channel >= 2) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    unsigned long mstatus = riscv_interrupts_lock();
+    instance->compare[channel] = value;
+    riscv_system_schedule();
+    riscv_interrupts_restore(mstatus);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_timer_instance_set_pwm_duty_cycle(void* timer, uint8_t channel, uint8_t duty_cycle) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL || channel >= 2 || duty_cycle > 100) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Calculate compare value based on duty cycle and period
+    return riscv_timer_instance_set_compare(instance, channel, (uint32_t)(timer_top(instance) * duty_cycle / 100));
+}
+
+uint32_t riscv_timer_instance_us_to_ticks(void* timer, uint32_t us) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    return (uint32_t)((uint64_t)us * instance->frequency / 1000000);
+}
+
+uint32_t riscv_timer_instance_ticks_to_us(void* timer, uint32_t ticks) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    return (uint32_t)((uint64_t)ticks * 1000000 / instance->frequency);
+}
+
+eer_hal_status_t riscv_timer_instance_register_callback(void* timer,
+                                                       eer_timer_event_t event,
+                                                       uint8_t channel,
+                                                       eer_timer_event_handler_t handler,
+                                                       void* user_data) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL || handler == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    unsigned long mstatus = riscv_interrupts_lock();
+    eer_hal_status_t status = EER_HAL_OK;
+    
+    switch (event) {
+        case EER_TIMER_EVENT_OVERFLOW:
+            instance->overflow_handler = handler;
+            instance->overflow_user_data = user_data;
+            break;
+            
+        case EER_TIMER_EVENT_COMPARE:
+            if (channel >= 2) {
+                status = EER_HAL_INVALID_PARAM;
+                break;
+            }
+            instance->compare_handler[channel] = handler;
+            instance->compare_user_data[channel] = user_data;
+            break;
+            
+        case EER_TIMER_EVENT_CAPTURE:
+            // No capture input
+            status = EER_HAL_NOT_SUPPORTED;
+            break;
+            
+        default:
+            status = EER_HAL_INVALID_PARAM;
+            break;
+    }
+    
+    riscv_system_schedule();
+    riscv_interrupts_restore(mstatus);
+    
+    return status;
+}
+
+eer_hal_status_t riscv_timer_instance_unregister_callback(void* timer, eer_timer_event_t event, uint8_t channel) {
+    eer_timer_t* instance = (eer_timer_t*)timer;
+    
+    if (instance == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    unsigned long mstatus = riscv_interrupts_lock();
+    eer_hal_status_t status = EER_HAL_OK;
+    
+    switch (event) {
+        case EER_TIMER_EVENT_OVERFLOW:
+            instance->overflow_handler = NULL;
+            instance->overflow_user_data = NULL;
+            break;
+            
+        case EER_TIMER_EVENT_COMPARE:
+            if (channel >= 2) {
+                status = EER_HAL_INVALID_PARAM;
+                break;
+            }
+            instance->compare_handler[channel] = NULL;
+            instance->compare_user_data[channel] = NULL;
+            break;
+            
+        case EER_TIMER_EVENT_CAPTURE:
+            status = EER_HAL_NOT_SUPPORTED;
+            break;
+            
+        default:
+            status = EER_HAL_INVALID_PARAM;
+            break;
+    }
+    
+    riscv_system_schedule();
+    riscv_interrupts_restore(mstatus);
+    
+    return status;
+}
+
+eer_hal_status_t riscv_timer_instance_set_capture_edge(void* timer, bool rising) {
+    (void)rising;
+    
+    if (timer == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // No capture input
+    return EER_HAL_NOT_SUPPORTED;
+}
+
+// Single-instance operations on the default timer
+eer_hal_status_t riscv_timer_init(eer_timer_config_t* config) {
+    return riscv_timer_instance_init(&timer0, config);
+}
+
+eer_hal_status_t riscv_timer_deinit(void) {
+    return riscv_timer_instance_deinit(&timer0);
+}
+
+eer_hal_status_t riscv_timer_start(void) {
+    return riscv_timer_instance_start(&timer0);
+}
+
+eer_hal_status_t riscv_timer_stop(void) {
+    return riscv_timer_instance_stop(&timer0);
+}
+
+eer_hal_status_t riscv_timer_set_period(uint32_t period) {
+    return riscv_timer_instance_set_period(&timer0, period);
+}
+
+eer_hal_status_t riscv_timer_get_value(uint32_t* value) {
+    return riscv_timer_instance_get_value(&timer0, value);
+}
+
+eer_hal_status_t riscv_timer_set_compare(uint8_t channel, uint32_t value) {
+    return riscv_timer_instance_set_compare(&timer0, channel, value);
+}
+
+eer_hal_status_t riscv_timer_set_pwm_duty_cycle(uint8_t channel, uint8_t duty_cycle) {
+    return riscv_timer_instance_set_pwm_duty_cycle(&timer0, channel, duty_cycle);
+}
+
+uint32_t riscv_timer_us_to_ticks(uint32_t us) {
+    return riscv_timer_instance_us_to_ticks(&timer0, us);
+}
+
+uint32_t riscv_timer_ticks_to_us(uint32_t ticks) {
+    return riscv_timer_instance_ticks_to_us(&timer0, ticks);
+}
+
+eer_hal_status_t riscv_timer_register_callback(eer_timer_event_t event,
+                                                  uint8_t channel,
+                                                  eer_timer_event_handler_t handler,
+                                                  void* user_data) {
+    return riscv_timer_instance_register_callback(&timer0, event, channel, handler, user_data);
+}
+
+eer_hal_status_t riscv_timer_unregister_callback(eer_timer_event_t event, uint8_t channel) {
+    return riscv_timer_instance_unregister_callback(&timer0, event, channel);
+}
+
+eer_hal_status_t riscv_timer_set_capture_edge(bool rising) {
+    return riscv_timer_instance_set_capture_edge(&timer0, rising);
+}
+
+// Timer handler structure with function pointers
+eer_timer_handler_t eer_riscv_timer = {
+    .init = riscv_timer_init,
+    .deinit = riscv_timer_deinit,
+    .start = riscv_timer_start,
+    .stop = riscv_timer_stop,
+    .set_period = riscv_timer_set_period,
+    .get_value = riscv_timer_get_value,
+    .set_compare = riscv_timer_set_compare,
+    .set_pwm_duty_cycle = riscv_timer_set_pwm_duty_cycle,
+    .us_to_ticks = riscv_timer_us_to_ticks,
+    .ticks_to_us = riscv_timer_ticks_to_us,
+    .register_callback = riscv_timer_register_callback,
+    .unregister_callback = riscv_timer_unregister_callback,
+    .set_capture_edge = riscv_timer_set_capture_edge
+};
+
+// Timer instance handler structure with function pointers
+eer_timer_instance_handler_t eer_riscv_timer_instance = {
+    .init = riscv_timer_instance_init,
+    .deinit = riscv_timer_instance_deinit,
+    .start = riscv_timer_instance_start,
+    .stop = riscv_timer_instance_stop,
+    .set_period = riscv_timer_instance_set_period,
+    .get_value = riscv_timer_instance_get_value,
+    .set_compare = riscv_timer_instance_set_compare,
+    .set_pwm_duty_cycle = riscv_timer_instance_set_pwm_duty_cycle,
+    .us_to_ticks = riscv_timer_instance_us_to_ticks,
+    .ticks_to_us = riscv_timer_instance_ticks_to_us,
+    .register_callback = riscv_timer_instance_register_callback,
+    .unregister_callback = riscv_timer_instance_unregister_callback,
+    .set_capture_edge = riscv_timer_instance_set_capture_edge
+};
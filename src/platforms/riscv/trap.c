@@ -0,0 +1,90 @@
+#include "platforms/riscv/riscv.h"
+#include <stddef.h>
+
+// PLIC registers of context 0, machine mode of hart 0
+#define PLIC_PRIORITY(source) (4 * (source))
+#define PLIC_ENABLE(source)   (0x2000 + 4 * ((source) / 32))
+#define PLIC_THRESHOLD        0x200000
+#define PLIC_CLAIM            0x200004
+
+// Exit status of a trap nothing handles: 128 + exception code
+#define TRAP_EXIT_STATUS 128
+
+// Handler and context of each interrupt source
+static struct {
+    riscv_irq_handler_t handler;
+    void* context;
+} irq_handlers[EER_RISCV_PLIC_SOURCES];
+
+eer_hal_status_t riscv_irq_attach(uint8_t source, riscv_irq_handler_t handler, void* context) {
+    if (source == 0 || source >= EER_RISCV_PLIC_SOURCES || handler == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    unsigned long mstatus = riscv_interrupts_lock();
+    
+    irq_handlers[source].handler = handler;
+    irq_handlers[source].context = context;
+    
+    // Any priority above the threshold of 0 lets the source through
+    RISCV_REG32(EER_RISCV_PLIC_BASE, PLIC_PRIORITY(source)) = 1;
+    RISCV_REG32(EER_RISCV_PLIC_BASE, PLIC_THRESHOLD) = 0;
+    RISCV_REG32(EER_RISCV_PLIC_BASE, PLIC_ENABLE(source)) |= 1UL << (source % 32);
+    riscv_csr_set(mie, RISCV_MIE_MEIE);
+    
+    riscv_interrupts_restore(mstatus);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_irq_detach(uint8_t source) {
+    if (source == 0 || source >= EER_RISCV_PLIC_SOURCES) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    unsigned long mstatus = riscv_interrupts_lock();
+    
+    RISCV_REG32(EER_RISCV_PLIC_BASE, PLIC_ENABLE(source)) &= ~(1UL << (source % 32));
+    RISCV_REG32(EER_RISCV_PLIC_BASE, PLIC_PRIORITY(source)) = 0;
+    irq_handlers[source].handler = NULL;
+    irq_handlers[source].context = NULL;
+    
+    riscv_interrupts_restore(mstatus);
+    
+    return EER_HAL_OK;
+}
+
+/**
+ * @brief Serve every pending external interrupt
+ */
+static void trap_external(void) {
+    uint32_t source;
+    
+    while ((source = RISCV_REG32(EER_RISCV_PLIC_BASE, PLIC_CLAIM)) != 0) {
+        if (source < EER_RISCV_PLIC_SOURCES && irq_handlers[source].handler != NULL) {
+            irq_handlers[source].handler(irq_handlers[source].context);
+        }
+        
+        RISCV_REG32(EER_RISCV_PLIC_BASE, PLIC_CLAIM) = source;
+    }
+}
+
+void riscv_trap(unsigned long mcause) {
+    if (!(mcause & RISCV_MCAUSE_INTERRUPT)) {
+        // Exceptions are programming errors, end the run with the cause
+        riscv_exit(TRAP_EXIT_STATUS + (int)mcause);
+    }
+    
+    switch (mcause & ~RISCV_MCAUSE_INTERRUPT) {
+        case RISCV_MCAUSE_TIMER:
+            riscv_system_timer_isr();
+            break;
+            
+        case RISCV_MCAUSE_EXTERNAL:
+            trap_external();
+            break;
+            
+        default:
+            break;
+    }
+}
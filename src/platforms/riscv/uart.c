@@ -0,0 +1,691 @@
+#include "platforms/riscv/uart.h"
+#include "platforms/riscv/power.h"
+#include "eer_trace.h"
+#include <stddef.h>
+
+// Default UART instance for RISC-V
+static eer_uart_t uart_default = eer_hal_uart0();
+
+#if EER_RISCV_UART_NS16550
+/*
+ * NS16550A: byte-wide registers, 16-byte FIFOs
+ */
+#define UART_RBR 0  /*!< Receive buffer, read */
+#define UART_THR 0  /*!< Transmit holding register, write */
+#define UART_DLL 0  /*!< Divisor latch low, with LCR_DLAB */
+#define UART_IER 1  /*!< Interrupt enable */
+#define UART_DLM 1  /*!< Divisor latch high, with LCR_DLAB */
+#define UART_FCR 2  /*!< FIFO control, write */
+#define UART_LCR 3  /*!< Line control */
+#define UART_MCR 4  /*!< Modem control */
+#define UART_LSR 5  /*!< Line status */
+
+#define IER_ERBFI 0x01  /*!< Received data available interrupt */
+#define IER_ETBEI 0x02  /*!< Transmit holding register empty interrupt */
+#define FCR_ENABLE 0x07 /*!< Enable and clear both FIFOs */
+#define LCR_STOP2  0x04
+#define LCR_PARITY 0x08
+#define LCR_EVEN   0x10
+#define LCR_DLAB   0x80
+#define MCR_OUT2   0x08 /*!< Routes the interrupt to the interrupt line */
+#define LSR_DR     0x01 /*!< Data ready */
+#define LSR_THRE   0x20 /*!< Transmit FIFO empty */
+
+#define UART_FIFO_SIZE 16
+
+static inline eer_hal_status_t uart_hw_init(uintptr_t base, const eer_uart_config_t* config) {
+    uint32_t divisor = (EER_RISCV_UART_CLOCK + 8UL * config->baudrate) / (16UL * config->baudrate);
+    
+    if (divisor == 0 || divisor > 0xFFFF) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Character size, 5 to 8 bits
+    if (config->data_bits > EER_UART_DATA_BITS_8) {
+        return EER_HAL_NOT_SUPPORTED;
+    }
+    uint8_t lcr = (uint8_t)(config->data_bits - EER_UART_DATA_BITS_5);
+    
+    if (config->stop_bits == EER_UART_STOP_BITS_2) {
+        lcr |= LCR_STOP2;
+    }
+    
+    switch (config->parity) {
+        case EER_UART_PARITY_EVEN: lcr |= LCR_PARITY | LCR_EVEN; break;
+        case EER_UART_PARITY_ODD:  lcr |= LCR_PARITY; break;
+        case EER_UART_PARITY_NONE:
+        default: break;
+    }
+    
+    RISCV_REG8(base, UART_IER) = 0;
+    RISCV_REG8(base, UART_LCR) = LCR_DLAB;
+    RISCV_REG8(base, UART_DLL) = (uint8_t)divisor;
+    RISCV_REG8(base, UART_DLM) = (uint8_t)(divisor >> 8);
+    RISCV_REG8(base, UART_LCR) = lcr;
+    RISCV_REG8(base, UART_FCR) = FCR_ENABLE;
+    RISCV_REG8(base, UART_MCR) = MCR_OUT2;
+    
+    return EER_HAL_OK;
+}
+
+static inline void uart_hw_deinit(uintptr_t base) {
+    RISCV_REG8(base, UART_IER) = 0;
+}
+
+/**
+ * @brief Number of bytes the transmitter takes without waiting
+ */
+static inline uint8_t uart_hw_tx_space(uintptr_t base) {
+    return (RISCV_REG8(base, UART_LSR) & LSR_THRE) ? UART_FIFO_SIZE : 0;
+}
+
+static inline void uart_hw_put(uintptr_t base, uint8_t data) {
+    RISCV_REG8(base, UART_THR) = data;
+}
+
+/**
+ * @brief Take a received byte
+ * @return Byte, -1 if none was received
+ */
+static inline int uart_hw_get(uintptr_t base) {
+    if (!(RISCV_REG8(base, UART_LSR) & LSR_DR)) {
+        return -1;
+    }
+    
+    return RISCV_REG8(base, UART_RBR);
+}
+
+static inline void uart_hw_irq(uintptr_t base, bool rx, bool tx) {
+    RISCV_REG8(base, UART_IER) = (rx ? IER_ERBFI : 0) | (tx ? IER_ETBEI : 0);
+}
+
+static inline bool uart_hw_tx_irq_enabled(uintptr_t base) {
+    return (RISCV_REG8(base, UART_IER) & IER_ETBEI) != 0;
+}
+
+static inline bool uart_hw_rx_irq_enabled(uintptr_t base) {
+    return (RISCV_REG8(base, UART_IER) & IER_ERBFI) != 0;
+}
+#elif EER_RISCV_UART_SIFIVE
+/*
+ * SiFive UART: word-wide registers, 8-entry FIFOs, 8N1 or 8N2 only
+ */
+#define UART_TXDATA 0x00  /*!< Transmit data, bit 31 set while the FIFO is full */
+#define UART_RXDATA 0x04  /*!< Receive data, bit 31 set while the FIFO is empty */
+#define UART_TXCTRL 0x08  /*!< Transmit control */
+#define UART_RXCTRL 0x0C  /*!< Receive control */
+#define UART_IE     0x10  /*!< Interrupt enable */
+#define UART_DIV    0x18  /*!< Baud rate divisor */
+
+#define DATA_FLAG   (1UL << 31)
+#define CTRL_ENABLE 0x01
+#define TXCTRL_NSTOP 0x02
+#define CTRL_CNT(n) ((uint32_t)(n) << 16)
+#define IE_TXWM     0x01  /*!< Transmit FIFO below its watermark */
+#define IE_RXWM     0x02  /*!< Receive FIFO above its watermark */
+
+static inline eer_hal_status_t uart_hw_init(uintptr_t base, const eer_uart_config_t* config) {
+    uint32_t divisor = (EER_RISCV_UART_CLOCK + config->baudrate / 2) / config->baudrate;
+    
+    if (divisor < 16 || divisor > 0x10000) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    if (config->data_bits != EER_UART_DATA_BITS_8 || config->parity != EER_UART_PARITY_NONE) {
+        return EER_HAL_NOT_SUPPORTED;
+    }
+    
+    RISCV_REG32(base, UART_IE) = 0;
+    RISCV_REG32(base, UART_DIV) = divisor - 1;
+    
+    // Transmit interrupt once the FIFO is empty, receive on any byte
+    RISCV_REG32(base, UART_TXCTRL) = CTRL_ENABLE | CTRL_CNT(1)
+                                   | (config->stop_bits == EER_UART_STOP_BITS_2 ? TXCTRL_NSTOP : 0);
+    RISCV_REG32(base, UART_RXCTRL) = CTRL_ENABLE | CTRL_CNT(0);
+    
+    return EER_HAL_OK;
+}
+
+static inline void uart_hw_deinit(uintptr_t base) {
+    RISCV_REG32(base, UART_IE) = 0;
+    RISCV_REG32(base, UART_RXCTRL) = 0;
+}
+
+/**
+ * @brief Number of bytes the transmitter takes without waiting
+ */
+static inline uint8_t uart_hw_tx_space(uintptr_t base) {
+    return (RISCV_REG32(base, UART_TXDATA) & DATA_FLAG) ? 0 : 1;
+}
+
+static inline void uart_hw_put(uintptr_t base, uint8_t data) {
+    RISCV_REG32(base, UART_TXDATA) = data;
+}
+
+/**
+ * @brief Take a received byte
+ * @return Byte, -1 if none was received
+ */
+static inline int uart_hw_get(uintptr_t base) {
+    uint32_t data = RISCV_REG32(base, UART_RXDATA);
+    
+    return (data & DATA_FLAG) ? -1 : (int)(data & 0xFF);
+}
+
+static inline void uart_hw_irq(uintptr_t base, bool rx, bool tx) {
+    RISCV_REG32(base, UART_IE) = (rx ? IE_RXWM : 0) | (tx ? IE_TXWM : 0);
+}
+
+static inline bool uart_hw_tx_irq_enabled(uintptr_t base) {
+    return (RISCV_REG32(base, UART_IE) & IE_TXWM) != 0;
+}
+
+static inline bool uart_hw_rx_irq_enabled(uintptr_t base) {
+    return (RISCV_REG32(base, UART_IE) & IE_RXWM) != 0;
+}
+#else
+#error "The machine descriptor names no UART type"
+#endif
+
+/**
+ * @brief mtime at which a blocking call gives up
+ * @param timeout Timeout in milliseconds, 0 to wait forever
+ */
+static uint64_t uart_deadline(uint32_t timeout) {
+    return timeout > 0 ? riscv_mtime() + (uint64_t)timeout * (EER_RISCV_MTIME_FREQUENCY / 1000) : UINT64_MAX;
+}
+
+static bool uart_async_receive(eer_uart_t* instance, eer_async_request_t* request);
+static void uart_async_finish(eer_uart_t* instance);
+
+/**
+ * @brief Next byte to send: buffered bytes first, then the running request
+ * @return Byte, -1 if nothing is left to send
+ */
+static int uart_tx_next(eer_uart_t* instance) {
+    if (instance->tx_tail != instance->tx_head) {
+        uint8_t data = instance->tx_buffer[instance->tx_tail];
+        instance->tx_tail = (instance->tx_tail + 1) % EER_RISCV_UART_TX_SIZE;
+        return data;
+    }
+    
+    eer_async_request_t* request = instance->async.head;
+    if (request == NULL || request->index >= request->tx_size) {
+        return -1;
+    }
+    
+    uint8_t data = request->tx_data[request->index++];
+    
+    // Last byte taken, go on with the receive part
+    if (request->index == request->tx_size
+        && (request->rx_size == 0 || uart_async_receive(instance, request))) {
+        uart_async_finish(instance);
+    }
+    
+    return data;
+}
+
+/**
+ * @brief Feed the transmitter, from its interrupt or a blocking wait
+ *
+ * Called with interrupts disabled. The transmit interrupt stays enabled
+ * while bytes wait for room in the transmitter.
+ */
+static void uart_tx_service(eer_uart_t* instance) {
+    for (;;) {
+        uint8_t space = uart_hw_tx_space(instance->base);
+        
+        if (space == 0) {
+            uart_hw_irq(instance->base, uart_hw_rx_irq_enabled(instance->base), true);
+            return;
+        }
+        
+        while (space-- > 0) {
+            int data = uart_tx_next(instance);
+            
+            if (data < 0) {
+                uart_hw_irq(instance->base, uart_hw_rx_irq_enabled(instance->base), false);
+                
+                // Report once per burst
+                if (instance->tx_active) {
+                    instance->tx_active = false;
+                    eer_trace_isr(EER_TRACE_UART_TX_IRQ, 0);
+                    
+                    if (instance->tx_handler != NULL) {
+                        eer_uart_tx_event_t event = {
+                            .uart = instance,
+                            .user_data = instance->tx_user_data
+                        };
+                        
+                        instance->tx_handler(&event);
+                    }
+                }
+                return;
+            }
+            
+            uart_hw_put(instance->base, (uint8_t)data);
+            instance->tx_active = true;
+        }
+    }
+}
+
+/**
+ * @brief Move received bytes to the running request or the buffer, from
+ *        the receive interrupt or a blocking wait
+ *
+ * Called with interrupts disabled.
+ */
+static void uart_rx_service(eer_uart_t* instance) {
+    int received;
+    
+    while ((received = uart_hw_get(instance->base)) >= 0) {
+        uint8_t data = (uint8_t)received;
+        
+        eer_trace_isr(EER_TRACE_UART_RX_IRQ, data);
+        riscv_power_wakeup(EER_WAKEUP_UART, 0);
+        
+        // A request past its transmit part takes the byte
+        eer_async_request_t* request = instance->async.head;
+        if (request != NULL && request->index >= request->tx_size) {
+            request->rx_data[request->index++ - request->tx_size] = data;
+            if (request->index == request->tx_size + request->rx_size) {
+                uart_async_finish(instance);
+            }
+            continue;
+        }
+        
+        // Store received byte in buffer
+        uint8_t* stored = &data;
+        uint16_t next_head = (instance->rx_head + 1) % EER_RISCV_UART_RX_SIZE;
+        if (next_head != instance->rx_tail) {
+            stored = &instance->rx_buffer[instance->rx_head];
+            *stored = data;
+            instance->rx_head = next_head;
+        }
+        
+        // Call the handler if registered
+        if (instance->rx_handler != NULL) {
+            eer_uart_rx_event_t event = {
+                .uart = instance,
+                .data = stored,
+                .size = 1,
+                .user_data = instance->rx_user_data
+            };
+            
+            instance->rx_handler(&event);
+        }
+    }
+}
+
+/**
+ * @brief Interrupt of a UART
+ * @param context UART instance
+ */
+static void uart_isr(void* context) {
+    eer_uart_t* instance = (eer_uart_t*)context;
+    
+    uart_rx_service(instance);
+    
+    if (uart_hw_tx_irq_enabled(instance->base)) {
+        uart_tx_service(instance);
+    }
+}
+
+eer_hal_status_t riscv_uart_instance_init(void* uart, eer_uart_config_t* config) {
+    eer_uart_t* instance = (eer_uart_t*)uart;
+    
+    if (instance == NULL || config == NULL || config->baudrate == 0) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_hal_status_t status = uart_hw_init(instance->base, config);
+    if (status != EER_HAL_OK) {
+        return status;
+    }
+    
+    // Reset buffer indices
+    instance->rx_head = 0;
+    instance->rx_tail = 0;
+    instance->tx_head = 0;
+    instance->tx_tail = 0;
+    instance->tx_active = false;
+    
+    // Receive into the buffer from now on
+    uart_hw_irq(instance->base, true, false);
+    
+    return riscv_irq_attach(instance->irq, uart_isr, instance);
+}
+
+eer_hal_status_t riscv_uart_instance_deinit(void* uart) {
+    eer_uart_t* instance = (eer_uart_t*)uart;
+    
+    if (instance == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    riscv_irq_detach(instance->irq);
+    uart_hw_deinit(instance->base);
+    
+    eer_async_cancel(&instance->async, EER_HAL_ERROR);
+    
+    // Clear callback handlers
+    instance->rx_handler = NULL;
+    instance->rx_user_data = NULL;
+    instance->tx_handler = NULL;
+    instance->tx_user_data = NULL;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_uart_instance_transmit(void* uart, const uint8_t* data, uint16_t size, uint32_t timeout) {
+    eer_uart_t* instance = (eer_uart_t*)uart;
+    
+    if (instance == NULL || data == NULL || size == 0) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    if (instance->async.head != NULL) {
+        return EER_HAL_BUSY;
+    }
+    
+    eer_trace(EER_TRACE_UART_TRANSMIT, size);
+    
+    uint64_t deadline = uart_deadline(timeout);
+    uint16_t i = 0;
+    
+    while (i < size) {
+        unsigned long mstatus = riscv_interrupts_lock();
+        
+        // Buffer what fits, then make room by feeding the transmitter
+        uint16_t next_head;
+        while (i < size && (next_head = (instance->tx_head + 1) % EER_RISCV_UART_TX_SIZE) != instance->tx_tail) {
+            instance->tx_buffer[instance->tx_head] = data[i++];
+            instance->tx_head = next_head;
+        }
+        uart_tx_service(instance);
+        
+        riscv_interrupts_restore(mstatus);
+        
+        if (i < size && riscv_mtime() >= deadline) {
+            return EER_HAL_TIMEOUT;
+        }
+    }
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_uart_instance_receive(void* uart, uint8_t* data, uint16_t size, uint32_t timeout) {
+    eer_uart_t* instance = (eer_uart_t*)uart;
+    
+    if (instance == NULL || data == NULL || size == 0) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    if (instance->async.head != NULL) {
+        return EER_HAL_BUSY;
+    }
+    
+    eer_trace(EER_TRACE_UART_RECEIVE, size);
+    
+    uint64_t deadline = uart_deadline(timeout);
+    uint16_t i = 0;
+    
+    while (i < size) {
+        unsigned long mstatus = riscv_interrupts_lock();
+        
+        uart_rx_service(instance);
+        while (i < size && instance->rx_tail != instance->rx_head) {
+            data[i++] = instance->rx_buffer[instance->rx_tail];
+            instance->rx_tail = (instance->rx_tail + 1) % EER_RISCV_UART_RX_SIZE;
+        }
+        
+        riscv_interrupts_restore(mstatus);
+        
+        if (i < size && riscv_mtime() >= deadline) {
+            return EER_HAL_TIMEOUT;
+        }
+    }
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_uart_instance_is_tx_ready(void* uart, bool* ready) {
+    eer_uart_t* instance = (eer_uart_t*)uart;
+    
+    if (instance == NULL || ready == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    *ready = (instance->tx_head + 1) % EER_RISCV_UART_TX_SIZE != instance->tx_tail;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_uart_instance_is_rx_ready(void* uart, bool* ready) {
+    eer_uart_t* instance = (eer_uart_t*)uart;
+    
+    if (instance == NULL || ready == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Reading the SiFive receive register takes the byte, so it goes
+    // through the buffer
+    unsigned long mstatus = riscv_interrupts_lock();
+    uart_rx_service(instance);
+    *ready = instance->rx_tail != instance->rx_head;
+    riscv_interrupts_restore(mstatus);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_uart_instance_register_rx_callback(void* uart, eer_uart_rx_handler_t handler, void* user_data) {
+    eer_uart_t* instance = (eer_uart_t*)uart;
+    
+    if (instance == NULL || handler == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Store the handler and user data
+    instance->rx_handler = handler;
+    instance->rx_user_data = user_data;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_uart_instance_unregister_rx_callback(void* uart) {
+    eer_uart_t* instance = (eer_uart_t*)uart;
+    
+    if (instance == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Clear the handler and user data
+    instance->rx_handler = NULL;
+    instance->rx_user_data = NULL;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_uart_instance_register_tx_callback(void* uart, eer_uart_tx_handler_t handler, void* user_data) {
+    eer_uart_t* instance = (eer_uart_t*)uart;
+    
+    if (instance == NULL || handler == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Store the handler and user data
+    instance->tx_handler = handler;
+    instance->tx_user_data = user_data;
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_uart_instance_unregister_tx_callback(void* uart) {
+    eer_uart_t* instance = (eer_uart_t*)uart;
+    
+    if (instance == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Clear the handler and user data
+    instance->tx_handler = NULL;
+    instance->tx_user_data = NULL;
+    
+    return EER_HAL_OK;
+}
+
+/**
+ * @brief Run the receive part of the running request
+ *
+ * Takes the bytes already buffered, the receive interrupt delivers the
+ * rest. Called with interrupts disabled.
+ *
+ * @return true if the request has all its bytes
+ */
+static bool uart_async_receive(eer_uart_t* instance, eer_async_request_t* request) {
+    while (request->index < request->tx_size + request->rx_size
+           && instance->rx_tail != instance->rx_head) {
+        request->rx_data[request->index++ - request->tx_size] = instance->rx_buffer[instance->rx_tail];
+        instance->rx_tail = (instance->rx_tail + 1) % EER_RISCV_UART_RX_SIZE;
+    }
+    
+    return request->index == request->tx_size + request->rx_size;
+}
+
+/**
+ * @brief Start requests until one is left running
+ *
+ * Called with interrupts disabled, from submit or from the interrupt that
+ * finished the previous request.
+ */
+static void uart_async_start(eer_uart_t* instance) {
+    eer_async_request_t* request;
+    
+    while ((request = instance->async.head) != NULL) {
+        // The transmit interrupt sends the bytes
+        if (request->tx_size > 0) {
+            uart_hw_irq(instance->base, uart_hw_rx_irq_enabled(instance->base), true);
+            return;
+        }
+        
+        if (!uart_async_receive(instance, request)) {
+            return;
+        }
+        
+        // Served from the buffer already
+        eer_async_dequeue(&instance->async);
+        eer_async_complete(request, EER_HAL_OK);
+    }
+}
+
+/**
+ * @brief Finish the running request and start the next one
+ */
+static void uart_async_finish(eer_uart_t* instance) {
+    eer_async_request_t* request = instance->async.head;
+    
+    eer_async_dequeue(&instance->async);
+    uart_async_start(instance);
+    eer_async_complete(request, EER_HAL_OK);
+}
+
+eer_hal_status_t riscv_uart_submit(eer_async_request_t* request) {
+    eer_uart_t* instance = request != NULL && request->device != NULL ? (eer_uart_t*)request->device : &uart_default;
+    
+    eer_hal_status_t status = eer_async_prepare(request);
+    if (status != EER_HAL_OK) {
+        return status;
+    }
+    
+    eer_trace(request->tx_size > 0 ? EER_TRACE_UART_TRANSMIT : EER_TRACE_UART_RECEIVE,
+              request->tx_size > 0 ? request->tx_size : request->rx_size);
+              
+    unsigned long mstatus = riscv_interrupts_lock();
+    if (eer_async_enqueue(&instance->async, request)) {
+        uart_async_start(instance);
+    }
+    riscv_interrupts_restore(mstatus);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t riscv_uart_flush(void) {
+    while (uart_default.tx_tail != uart_default.tx_head
+           || (uart_default.async.head != NULL && uart_default.async.head->index < uart_default.async.head->tx_size)) {
+        unsigned long mstatus = riscv_interrupts_lock();
+        uart_tx_service(&uart_default);
+        riscv_interrupts_restore(mstatus);
+    }
+    
+    return EER_HAL_OK;
+}
+
+// Single-instance operations on the default UART
+eer_hal_status_t riscv_uart_init(eer_uart_config_t* config) {
+    return riscv_uart_instance_init(&uart_default, config);
+}
+
+eer_hal_status_t riscv_uart_deinit(void) {
+    return riscv_uart_instance_deinit(&uart_default);
+}
+
+eer_hal_status_t riscv_uart_transmit(const uint8_t* data, uint16_t size, uint32_t timeout) {
+    return riscv_uart_instance_transmit(&uart_default, data, size, timeout);
+}
+
+eer_hal_status_t riscv_uart_receive(uint8_t* data, uint16_t size, uint32_t timeout) {
+    return riscv_uart_instance_receive(&uart_default, data, size, timeout);
+}
+
+eer_hal_status_t riscv_uart_is_tx_ready(bool* ready) {
+    return riscv_uart_instance_is_tx_ready(&uart_default, ready);
+}
+
+eer_hal_status_t riscv_uart_is_rx_ready(bool* ready) {
+    return riscv_uart_instance_is_rx_ready(&uart_default, ready);
+}
+
+eer_hal_status_t riscv_uart_register_rx_callback(eer_uart_rx_handler_t handler, void* user_data) {
+    return riscv_uart_instance_register_rx_callback(&uart_default, handler, user_data);
+}
+
+eer_hal_status_t riscv_uart_unregister_rx_callback(void) {
+    return riscv_uart_instance_unregister_rx_callback(&uart_default);
+}
+
+eer_hal_status_t riscv_uart_register_tx_callback(eer_uart_tx_handler_t handler, void* user_data) {
+    return riscv_uart_instance_register_tx_callback(&uart_default, handler, user_data);
+}
+
+eer_hal_status_t riscv_uart_unregister_tx_callback(void) {
+    return riscv_uart_instance_unregister_tx_callback(&uart_default);
+}
+
+// UART handler structure with function pointers
+eer_uart_handler_t eer_riscv_uart = {
+    .init = riscv_uart_init,
+    .deinit = riscv_uart_deinit,
+    .transmit = riscv_uart_transmit,
+    .receive = riscv_uart_receive,
+    .is_tx_ready = riscv_uart_is_tx_ready,
+    .is_rx_ready = riscv_uart_is_rx_ready,
+    .register_rx_callback = riscv_uart_register_rx_callback,
+    .unregister_rx_callback = riscv_uart_unregister_rx_callback,
+    .register_tx_callback = riscv_uart_register_tx_callback,
+    .unregister_tx_callback = riscv_uart_unregister_tx_callback,
+    .submit = riscv_uart_submit
+};
+
+// UART instance handler structure with function pointers
+eer_uart_instance_handler_t eer_riscv_uart_instance = {
+    .init = riscv_uart_instance_init,
+    .deinit = riscv_uart_instance_deinit,
+    .transmit = riscv_uart_instance_transmit,
+    .receive = riscv_uart_instance_receive,
+    .is_tx_ready = riscv_uart_instance_is_tx_ready,
+    .is_rx_ready = riscv_uart_instance_is_rx_ready,
+    .register_rx_callback = riscv_uart_instance_register_rx_callback,
+    .unregister_rx_callback = riscv_uart_instance_unregister_rx_callback,
+    .register_tx_callback = riscv_uart_instance_register_tx_callback,
+    .unregister_tx_callback = riscv_uart_instance_unregister_tx_callback
+};
@@ -0,0 +1,808 @@
+#include "eer_sd.h"
+#include "eer_spi_device.h"
+#include <stddef.h>
+
+// Commands
+#define SD_CMD0   0   /* GO_IDLE_STATE */
+#define SD_CMD8   8   /* SEND_IF_COND */
+#define SD_CMD12  12  /* STOP_TRANSMISSION */
+#define SD_CMD16  16  /* SET_BLOCKLEN */
+#define SD_CMD17  17  /* READ_SINGLE_BLOCK */
+#define SD_CMD18  18  /* READ_MULTIPLE_BLOCK */
+#define SD_CMD24  24  /* WRITE_BLOCK */
+#define SD_CMD25  25  /* WRITE_MULTIPLE_BLOCK */
+#define SD_CMD55  55  /* APP_CMD */
+#define SD_CMD58  58  /* READ_OCR */
+#define SD_ACMD23 23  /* SET_WR_BLK_ERASE_COUNT */
+#define SD_ACMD41 41  /* SD_SEND_OP_COND */
+
+// R1 bits
+#define SD_R1_IDLE    0x01
+#define SD_R1_ILLEGAL 0x04
+
+// Tokens
+#define SD_TOKEN_SINGLE 0xFE  /* Start of a block read, or of a single block write */
+#define SD_TOKEN_MULTI  0xFC  /* Start of a block of a multiple block write */
+#define SD_TOKEN_STOP   0xFD  /* End of a multiple block write */
+#define SD_DATA_MASK     0x1F
+#define SD_DATA_ACCEPTED 0x05
+
+// Bytes polled for R1 after a command
+#define SD_R1_POLLS 10
+
+// Bytes per poll while busy; only the last one is checked
+#define SD_BUSY_CHUNK 16
+
+// Steps of an asynchronous transfer, run by the SPI completion handler
+#define SD_STEP_SELECT   0   /* Clock with chip select high, the bus is ours after it */
+#define SD_STEP_APP      1   /* CMD55 sent, R1 polled, ACMD23 follows */
+#define SD_STEP_PRE      2   /* ACMD23 sent, the transfer command follows */
+#define SD_STEP_COMMAND  3   /* Transfer command sent, R1 polled */
+#define SD_STEP_TOKEN    4   /* Polling for the start token of a read block */
+#define SD_STEP_BLOCK    5   /* Block and CRC exchanged */
+#define SD_STEP_BUSY     6   /* Polling while the card programs a block */
+#define SD_STEP_STOP     7   /* CMD12 sent, R1 polled, or stop token sent */
+#define SD_STEP_END_BUSY 8   /* Polling while the card finishes the transfer */
+#define SD_STEP_RELEASE  9   /* Clocks after chip select release */
+
+static const uint8_t sd_stop_token[2] = { SD_TOKEN_STOP, 0xFF };
+static const uint8_t sd_crc[2] = { 0xFF, 0xFF };
+static const uint8_t sd_token_single[2] = { 0xFF, SD_TOKEN_SINGLE };
+static const uint8_t sd_token_multi[2] = { 0xFF, SD_TOKEN_MULTI };
+
+/**
+ * @brief Exchange bytes of a blocking transfer
+ *
+ * The first failed call, EER_HAL_BUSY while requests run on the bus, is
+ * kept in sd->result and skips the rest of the transfer.
+ */
+static void sd_spi(eer_sd_t* sd, const uint8_t* tx_data, uint8_t* rx_data, uint16_t size) {
+    if (sd->result == EER_HAL_OK) {
+        sd->result = eer_hal_call(spi, transfer, tx_data, rx_data, size, 0);
+    }
+}
+
+static uint8_t sd_byte(eer_sd_t* sd, uint8_t data) {
+    uint8_t received = 0xFF;
+    sd_spi(sd, &data, &received, 1);
+    return received;
+}
+
+static void sd_frame(eer_sd_t* sd, uint8_t command, uint32_t argument) {
+    sd->command[0] = 0x40 | command;
+    sd->command[1] = (uint8_t)(argument >> 24);
+    sd->command[2] = (uint8_t)(argument >> 16);
+    sd->command[3] = (uint8_t)(argument >> 8);
+    sd->command[4] = (uint8_t)argument;
+    
+    // The CRC is only checked before the card enters SPI mode and for CMD8
+    if (command == SD_CMD0) {
+        sd->command[5] = 0x95;
+    } else if (command == SD_CMD8) {
+        sd->command[5] = 0x87;
+    } else {
+        sd->command[5] = 0x01;
+    }
+}
+
+static bool sd_wait_ready(eer_sd_t* sd) {
+    for (uint32_t polls = 0; polls < EER_SD_BUSY_POLLS; polls++) {
+        if (sd_byte(sd, 0xFF) == 0xFF) {
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+/**
+ * @brief Send a command with chip select asserted and return its R1, 0xFF for none
+ */
+static uint8_t sd_command(eer_sd_t* sd, uint8_t command, uint32_t argument) {
+    if (command != SD_CMD12 && !sd_wait_ready(sd)) {
+        return 0xFF;
+    }
+    
+    sd_frame(sd, command, argument);
+    sd_spi(sd, sd->command, NULL, sizeof(sd->command));
+    
+    // A stuff byte follows CMD12
+    if (command == SD_CMD12) {
+        sd_byte(sd, 0xFF);
+    }
+    
+    uint8_t r1 = 0xFF;
+    for (uint8_t polls = 0; polls < SD_R1_POLLS && (r1 & 0x80); polls++) {
+        r1 = sd_byte(sd, 0xFF);
+    }
+    
+    return r1;
+}
+
+static uint8_t sd_app_command(eer_sd_t* sd, uint8_t command, uint32_t argument) {
+    uint8_t r1 = sd_command(sd, SD_CMD55, 0);
+    if (r1 > SD_R1_IDLE) {
+        return r1;
+    }
+    
+    return sd_command(sd, command, argument);
+}
+
+/**
+ * @brief Start a blocking transfer at the clock of device, which fails
+ *        while requests run on the bus
+ */
+static eer_hal_status_t sd_select(eer_sd_t* sd, const eer_spi_device_t* device) {
+    sd->result = eer_spi_device_select(device);
+    
+    return sd->result;
+}
+
+/**
+ * @brief End a blocking transfer
+ * @return status, or the failure of the bus that caused it
+ */
+static eer_hal_status_t sd_deselect(eer_sd_t* sd, eer_hal_status_t status) {
+    eer_spi_device_deselect(&sd->device);
+    
+    // The card releases MISO on the next clock
+    sd_byte(sd, 0xFF);
+    
+    return sd->result != EER_HAL_OK ? sd->result : status;
+}
+
+static uint32_t sd_address(eer_sd_t* sd, uint32_t sector) {
+    return sd->type == EER_SD_TYPE_HC ? sector : sector * EER_SD_SECTOR_SIZE;
+}
+
+static bool sd_overlaps(eer_sd_t* sd, uint32_t sector, uint16_t count) {
+    return sd->cache_valid && sd->cached >= sector && sd->cached - sector < count;
+}
+
+static eer_hal_status_t sd_identify(eer_sd_t* sd) {
+    uint8_t response[4] = { 0 };
+    
+    if (sd_command(sd, SD_CMD0, 0) != SD_R1_IDLE) {
+        return EER_HAL_TIMEOUT;
+    }
+    
+    // Version 2 cards echo the check pattern with the voltage accepted
+    uint32_t hcs = 0;
+    uint8_t r1 = sd_command(sd, SD_CMD8, 0x1AA);
+    
+    if (r1 == SD_R1_IDLE) {
+        sd_spi(sd, NULL, response, sizeof(response));
+        if (response[2] != 0x01 || response[3] != 0xAA) {
+            return EER_HAL_NOT_SUPPORTED;
+        }
+        sd->type = EER_SD_TYPE_V2;
+        hcs = 1UL << 30;
+    } else if (r1 != 0xFF && (r1 & SD_R1_ILLEGAL)) {
+        sd->type = EER_SD_TYPE_V1;
+    } else {
+        return EER_HAL_TIMEOUT;
+    }
+    
+    for (uint16_t ms = 0; ; ms++) {
+        r1 = sd_app_command(sd, SD_ACMD41, hcs);
+        if (r1 == 0) {
+            break;
+        }
+        
+        // MMC cards reject ACMD41
+        if (r1 != SD_R1_IDLE) {
+            return r1 == 0xFF ? EER_HAL_TIMEOUT : EER_HAL_NOT_SUPPORTED;
+        }
+        
+        if (ms >= EER_SD_INIT_TIMEOUT_MS) {
+            return EER_HAL_TIMEOUT;
+        }
+        eer_hal_call(system, delay_ms, 1);
+    }
+    
+    if (sd->type == EER_SD_TYPE_V2) {
+        if (sd_command(sd, SD_CMD58, 0) != 0) {
+            return EER_HAL_ERROR;
+        }
+        
+        // Card capacity status
+        sd_spi(sd, NULL, response, sizeof(response));
+        if (response[0] & 0x40) {
+            sd->type = EER_SD_TYPE_HC;
+        }
+    }
+    
+    if (sd->type != EER_SD_TYPE_HC && sd_command(sd, SD_CMD16, EER_SD_SECTOR_SIZE) != 0) {
+        return EER_HAL_ERROR;
+    }
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t eer_sd_init(eer_sd_t* sd) {
+    if (sd == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    sd->type = EER_SD_TYPE_NONE;
+    sd->cache_valid = false;
+    sd->cache_dirty = false;
+    sd->request = NULL;
+    
+    // Identified below 400 kHz, later transfers take the card's clock
+    eer_spi_device_t slow = { .cs = sd->device.cs, .prescaler = EER_SPI_PRESCALER_128 };
+    
+    eer_hal_status_t status = eer_spi_device_init(&slow);
+    if (status != EER_HAL_OK) {
+        return status;
+    }
+    
+    // At least 74 clocks with chip select high enter SPI mode
+    uint8_t clocks[10];
+    for (uint8_t i = 0; i < sizeof(clocks); i++) {
+        clocks[i] = 0xFF;
+    }
+    status = eer_hal_call(spi, transfer, clocks, NULL, sizeof(clocks), 0);
+    
+    if (status == EER_HAL_OK) {
+        status = sd_select(sd, &slow);
+    }
+    if (status == EER_HAL_OK) {
+        status = sd_deselect(sd, sd_identify(sd));
+    }
+    
+    if (status != EER_HAL_OK) {
+        sd->type = EER_SD_TYPE_NONE;
+    }
+    
+    return status;
+}
+
+static eer_hal_status_t sd_read_blocks(eer_sd_t* sd, uint32_t sector, uint8_t* data, uint16_t count) {
+    eer_hal_status_t status = EER_HAL_OK;
+    uint8_t crc[2];
+    
+    if (sd_command(sd, count > 1 ? SD_CMD18 : SD_CMD17, sd_address(sd, sector)) != 0) {
+        return EER_HAL_ERROR;
+    }
+    
+    for (uint16_t block = 0; block < count; block++) {
+        uint8_t token = 0xFF;
+        for (uint32_t polls = 0; polls < EER_SD_TOKEN_POLLS && token == 0xFF && sd->result == EER_HAL_OK; polls++) {
+            token = sd_byte(sd, 0xFF);
+        }
+        
+        if (token != SD_TOKEN_SINGLE) {
+            status = token == 0xFF ? EER_HAL_TIMEOUT : EER_HAL_ERROR;
+            break;
+        }
+        
+        sd_spi(sd, NULL, data, EER_SD_SECTOR_SIZE);
+        sd_spi(sd, NULL, crc, sizeof(crc));
+        data += EER_SD_SECTOR_SIZE;
+    }
+    
+    // CMD12 ends the run, after a failed block as well
+    if (count > 1) {
+        if (sd_command(sd, SD_CMD12, 0) != 0 && status == EER_HAL_OK) {
+            status = EER_HAL_ERROR;
+        }
+        if (!sd_wait_ready(sd) && status == EER_HAL_OK) {
+            status = EER_HAL_TIMEOUT;
+        }
+    }
+    
+    return status;
+}
+
+static eer_hal_status_t sd_write_blocks(eer_sd_t* sd, uint32_t sector, const uint8_t* data, uint16_t count) {
+    // Let the card pre-erase the run
+    if (count > 1 && sd_app_command(sd, SD_ACMD23, count) != 0) {
+        return EER_HAL_ERROR;
+    }
+    
+    if (sd_command(sd, count > 1 ? SD_CMD25 : SD_CMD24, sd_address(sd, sector)) != 0) {
+        return EER_HAL_ERROR;
+    }
+    
+    eer_hal_status_t status = EER_HAL_OK;
+    
+    for (uint16_t block = 0; block < count && status == EER_HAL_OK; block++) {
+        sd_spi(sd, count > 1 ? sd_token_multi : sd_token_single, NULL, 2);
+        sd_spi(sd, data, NULL, EER_SD_SECTOR_SIZE);
+        sd_spi(sd, sd_crc, NULL, sizeof(sd_crc));
+        data += EER_SD_SECTOR_SIZE;
+        
+        if ((sd_byte(sd, 0xFF) & SD_DATA_MASK) != SD_DATA_ACCEPTED) {
+            status = EER_HAL_ERROR;
+        }
+        
+        // A card still busy takes no stop token either
+        if (!sd_wait_ready(sd)) {
+            return EER_HAL_TIMEOUT;
+        }
+    }
+    
+    // The stop token ends the run, after a rejected block as well
+    if (count > 1) {
+        sd_spi(sd, sd_stop_token, NULL, sizeof(sd_stop_token));
+        if (!sd_wait_ready(sd) && status == EER_HAL_OK) {
+            status = EER_HAL_TIMEOUT;
+        }
+    }
+    
+    return status;
+}
+
+eer_hal_status_t eer_sd_read(eer_sd_t* sd, uint32_t sector, uint8_t* data, uint16_t count) {
+    if (sd == NULL || data == NULL || count == 0 || sd->type == EER_SD_TYPE_NONE) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    if (sd->request != NULL) {
+        return EER_HAL_BUSY;
+    }
+    
+    // The card must see a modified cached sector before it is read back
+    if (sd->cache_dirty && sd_overlaps(sd, sector, count)) {
+        eer_hal_status_t status = eer_sd_flush(sd);
+        if (status != EER_HAL_OK) {
+            return status;
+        }
+    }
+    
+    eer_hal_status_t status = sd_select(sd, &sd->device);
+    if (status == EER_HAL_OK) {
+        status = sd_deselect(sd, sd_read_blocks(sd, sector, data, count));
+    }
+    
+    return status;
+}
+
+eer_hal_status_t eer_sd_write(eer_sd_t* sd, uint32_t sector, const uint8_t* data, uint16_t count) {
+    if (sd == NULL || data == NULL || count == 0 || sd->type == EER_SD_TYPE_NONE) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    if (sd->request != NULL) {
+        return EER_HAL_BUSY;
+    }
+    
+    // The written data supersedes the cached copy
+    if (sd_overlaps(sd, sector, count)) {
+        sd->cache_valid = false;
+        sd->cache_dirty = false;
+    }
+    
+    eer_hal_status_t status = sd_select(sd, &sd->device);
+    if (status == EER_HAL_OK) {
+        status = sd_deselect(sd, sd_write_blocks(sd, sector, data, count));
+    }
+    
+    return status;
+}
+
+/*
+ * Asynchronous transfers. Every step ends by submitting the next SPI
+ * request from the completion handler of the last one; sd->spi carries
+ * commands and polls, and the block exchange is a chain of spi_data and
+ * spi_tail, preceded by spi_tail carrying the token and followed by sd->spi
+ * carrying the CRC and data response for a write.
+ */
+
+static void sd_async_complete(eer_sd_t* sd, eer_hal_status_t status) {
+    eer_sd_request_t* request = sd->request;
+    
+    sd->request = NULL;
+    request->status = status;
+    
+    // Requests of other devices held back meanwhile start now
+    eer_async_release(EER_ASYNC_SPI, sd);
+    
+    if (request->handler != NULL) {
+        request->handler(request, request->user_data);
+    }
+}
+
+static void sd_async_submit(eer_sd_t* sd, eer_async_request_t* request);
+
+/**
+ * @brief Release the card, completing the transfer with the first failure
+ *        it met, or status
+ */
+static void sd_async_finish(eer_sd_t* sd, eer_hal_status_t status) {
+    eer_spi_device_deselect(&sd->device);
+    
+    if (sd->result == EER_HAL_OK) {
+        sd->result = status;
+    }
+    sd->step = SD_STEP_RELEASE;
+    
+    sd->spi.tx_size = 0;
+    sd->spi.rx_data = sd->response;
+    sd->spi.rx_size = 1;
+    sd_async_submit(sd, &sd->spi);
+}
+
+static void sd_async_submit(eer_sd_t* sd, eer_async_request_t* request) {
+    if (eer_async_submit(request) == EER_HAL_OK) {
+        return;
+    }
+    
+    if (sd->step == SD_STEP_RELEASE) {
+        sd_async_complete(sd, EER_HAL_ERROR);
+    } else {
+        sd_async_finish(sd, EER_HAL_ERROR);
+    }
+}
+
+static void sd_async_poll(eer_sd_t* sd, uint8_t size) {
+    sd->spi.tx_size = 0;
+    sd->spi.rx_data = sd->response;
+    sd->spi.rx_size = size;
+    sd_async_submit(sd, &sd->spi);
+}
+
+static void sd_async_command(eer_sd_t* sd, uint8_t command, uint32_t argument, uint8_t step) {
+    sd_frame(sd, command, argument);
+    
+    sd->step = step;
+    sd->polls = 0;
+    sd->spi.tx_data = sd->command;
+    sd->spi.tx_size = sizeof(sd->command);
+    
+    // The stuff byte after CMD12 is clocked out with the command
+    sd->spi.rx_data = sd->response;
+    sd->spi.rx_size = command == SD_CMD12 ? sizeof(sd->command) + 1 : 0;
+    sd_async_submit(sd, &sd->spi);
+}
+
+static void sd_async_transfer(eer_sd_t* sd) {
+    eer_sd_request_t* request = sd->request;
+    
+    sd_async_command(sd, request->write
+        ? (request->count > 1 ? SD_CMD25 : SD_CMD24)
+        : (request->count > 1 ? SD_CMD18 : SD_CMD17),
+        sd_address(sd, request->sector), SD_STEP_COMMAND);
+}
+
+static void sd_async_block(eer_sd_t* sd) {
+    eer_sd_request_t* request = sd->request;
+    uint8_t* data = request->data + (uint32_t)sd->block * EER_SD_SECTOR_SIZE;
+    
+    sd->step = SD_STEP_BLOCK;
+    sd->polls = 0;
+    
+    sd->spi_data.tx_data = request->write ? data : NULL;
+    sd->spi_data.tx_size = request->write ? EER_SD_SECTOR_SIZE : 0;
+    sd->spi_data.rx_data = request->write ? NULL : data;
+    sd->spi_data.rx_size = request->write ? 0 : EER_SD_SECTOR_SIZE;
+    
+    if (request->write) {
+        // Token, block, then CRC and the data response
+        sd->spi_tail.tx_data = request->count > 1 ? sd_token_multi : sd_token_single;
+        sd->spi_tail.tx_size = 2;
+        sd->spi_tail.rx_size = 0;
+        sd->spi_tail.next = &sd->spi_data;
+        sd->spi_data.next = &sd->spi;
+        sd->spi.tx_data = sd_crc;
+        sd->spi.tx_size = sizeof(sd_crc);
+        sd->spi.rx_data = sd->response;
+        sd->spi.rx_size = 3;
+        sd_async_submit(sd, &sd->spi_tail);
+    } else {
+        // Block, then CRC
+        sd->spi_tail.tx_size = 0;
+        sd->spi_tail.rx_data = sd->response;
+        sd->spi_tail.rx_size = 2;
+        sd->spi_tail.next = NULL;
+        sd->spi_data.next = &sd->spi_tail;
+        sd_async_submit(sd, &sd->spi_data);
+    }
+}
+
+static void sd_async_end(eer_sd_t* sd) {
+    eer_sd_request_t* request = sd->request;
+    
+    if (request->count == 1) {
+        sd_async_finish(sd, EER_HAL_OK);
+    } else if (request->write) {
+        sd->step = SD_STEP_STOP;
+        sd->polls = 0;
+        sd->spi.tx_data = sd_stop_token;
+        sd->spi.tx_size = sizeof(sd_stop_token);
+        sd->spi.rx_size = 0;
+        sd_async_submit(sd, &sd->spi);
+    } else {
+        sd_async_command(sd, SD_CMD12, 0, SD_STEP_STOP);
+    }
+}
+
+/**
+ * @brief Fail a transfer, first ending a run of blocks started by CMD18 so
+ *        that the card takes commands again
+ */
+static void sd_async_abort(eer_sd_t* sd, eer_hal_status_t status) {
+    sd->result = status;
+    sd_async_end(sd);
+}
+
+/**
+ * @brief Check the last byte of a busy poll; true once the card is ready,
+ *        after polling again or failing the transfer if it is not
+ */
+static bool sd_async_ready(eer_sd_t* sd) {
+    if (sd->response[SD_BUSY_CHUNK - 1] == 0xFF) {
+        return true;
+    }
+    
+    sd->polls += SD_BUSY_CHUNK;
+    if (sd->polls >= EER_SD_BUSY_POLLS) {
+        sd_async_finish(sd, EER_HAL_TIMEOUT);
+    } else {
+        sd_async_poll(sd, SD_BUSY_CHUNK);
+    }
+    
+    return false;
+}
+
+/**
+ * @brief Check the R1 of a command; true if it is 0, after polling again
+ *        or failing the transfer if it is not
+ */
+static bool sd_async_r1(eer_sd_t* sd) {
+    // Polling starts after the command itself
+    if (sd->spi.tx_size > 0) {
+        sd_async_poll(sd, 1);
+        return false;
+    }
+    
+    uint8_t r1 = sd->response[0];
+    if (r1 == 0) {
+        return true;
+    }
+    
+    if ((r1 & 0x80) && ++sd->polls < SD_R1_POLLS) {
+        sd_async_poll(sd, 1);
+    } else {
+        sd_async_finish(sd, EER_HAL_ERROR);
+    }
+    
+    return false;
+}
+
+static void sd_async_handler(eer_async_request_t* request, void* user_data) {
+    eer_sd_t* sd = user_data;
+    
+    // Requests of a failed chain may be cancelled after the transfer ended
+    if (sd->request == NULL) {
+        return;
+    }
+    
+    if (sd->step == SD_STEP_RELEASE) {
+        if (request == &sd->spi) {
+            sd_async_complete(sd, request->status == EER_HAL_OK ? sd->result : EER_HAL_ERROR);
+        }
+        return;
+    }
+    
+    if (request->status != EER_HAL_OK) {
+        sd_async_finish(sd, request->status);
+        return;
+    }
+    
+    // The rest of a block chain follows by itself
+    if (request->next != NULL) {
+        return;
+    }
+    
+    eer_sd_request_t* transfer = sd->request;
+    
+    switch (sd->step) {
+        case SD_STEP_SELECT:
+            // Devices before on the bus left it at their clock
+            if (eer_spi_device_select(&sd->device) != EER_HAL_OK) {
+                sd_async_finish(sd, EER_HAL_BUSY);
+            } else if (transfer->write && transfer->count > 1) {
+                sd_async_command(sd, SD_CMD55, 0, SD_STEP_APP);
+            } else {
+                sd_async_transfer(sd);
+            }
+            break;
+            
+        case SD_STEP_APP:
+            if (sd_async_r1(sd)) {
+                sd_async_command(sd, SD_ACMD23, transfer->count, SD_STEP_PRE);
+            }
+            break;
+            
+        case SD_STEP_PRE:
+            if (sd_async_r1(sd)) {
+                sd_async_transfer(sd);
+            }
+            break;
+            
+        case SD_STEP_COMMAND:
+            if (!sd_async_r1(sd)) {
+                break;
+            }
+            
+            if (transfer->write) {
+                sd_async_block(sd);
+            } else {
+                sd->step = SD_STEP_TOKEN;
+                sd->polls = 0;
+                sd_async_poll(sd, 1);
+            }
+            break;
+            
+        case SD_STEP_TOKEN:
+            if (sd->response[0] == SD_TOKEN_SINGLE) {
+                sd_async_block(sd);
+            } else if (sd->response[0] != 0xFF) {
+                sd_async_abort(sd, EER_HAL_ERROR);
+            } else if (++sd->polls >= EER_SD_TOKEN_POLLS) {
+                sd_async_abort(sd, EER_HAL_TIMEOUT);
+            } else {
+                sd_async_poll(sd, 1);
+            }
+            break;
+            
+        case SD_STEP_BLOCK:
+            if (transfer->write) {
+                // A rejected block ends the run once the card is ready
+                if ((sd->response[2] & SD_DATA_MASK) != SD_DATA_ACCEPTED) {
+                    sd->result = EER_HAL_ERROR;
+                }
+                
+                sd->step = SD_STEP_BUSY;
+                sd->polls = 0;
+                sd_async_poll(sd, SD_BUSY_CHUNK);
+                break;
+            }
+            
+            if (++sd->block < transfer->count) {
+                sd->step = SD_STEP_TOKEN;
+                sd->polls = 0;
+                sd_async_poll(sd, 1);
+            } else {
+                sd_async_end(sd);
+            }
+            break;
+            
+        case SD_STEP_BUSY:
+            if (!sd_async_ready(sd)) {
+                break;
+            }
+            
+            if (sd->result == EER_HAL_OK && ++sd->block < transfer->count) {
+                sd_async_block(sd);
+            } else {
+                sd_async_end(sd);
+            }
+            break;
+            
+        case SD_STEP_STOP:
+            if (transfer->write || sd_async_r1(sd)) {
+                sd->step = SD_STEP_END_BUSY;
+                sd->polls = 0;
+                sd_async_poll(sd, SD_BUSY_CHUNK);
+            }
+            break;
+            
+        case SD_STEP_END_BUSY:
+            if (sd_async_ready(sd)) {
+                sd_async_finish(sd, EER_HAL_OK);
+            }
+            break;
+            
+        default:
+            break;
+    }
+}
+
+eer_hal_status_t eer_sd_submit(eer_sd_t* sd, eer_sd_request_t* request) {
+    if (sd == NULL || request == NULL || request->data == NULL || request->count == 0
+        || sd->type == EER_SD_TYPE_NONE) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    if (sd->request != NULL || request->status == EER_HAL_BUSY) {
+        return EER_HAL_BUSY;
+    }
+    
+    // Chip select stays asserted across the requests, so others wait
+    if (eer_async_reserve(EER_ASYNC_SPI, sd) != EER_HAL_OK) {
+        return EER_HAL_BUSY;
+    }
+    
+    if (sd_overlaps(sd, request->sector, request->count)) {
+        if (request->write) {
+            sd->cache_valid = false;
+            sd->cache_dirty = false;
+        } else if (sd->cache_dirty) {
+            eer_hal_status_t status = eer_sd_flush(sd);
+            if (status != EER_HAL_OK) {
+                eer_async_release(EER_ASYNC_SPI, sd);
+                return status;
+            }
+        }
+    }
+    
+    eer_async_request_t* spi[] = { &sd->spi, &sd->spi_data, &sd->spi_tail };
+    for (uint8_t i = 0; i < sizeof(spi) / sizeof(spi[0]); i++) {
+        spi[i]->bus = EER_ASYNC_SPI;
+        spi[i]->flags = 0;
+        spi[i]->device = NULL;
+        spi[i]->next = NULL;
+        spi[i]->handler = sd_async_handler;
+        spi[i]->user_data = sd;
+    }
+    
+    request->status = EER_HAL_BUSY;
+    sd->request = request;
+    sd->block = 0;
+    sd->result = EER_HAL_OK;
+    
+    // Requests already on the bus run before the card is selected
+    sd->step = SD_STEP_SELECT;
+    sd_async_poll(sd, 1);
+    
+    return EER_HAL_OK;
+}
+
+eer_hal_status_t eer_sd_cache(eer_sd_t* sd, uint32_t sector, uint8_t** data) {
+    if (sd == NULL || sd->cache == NULL || data == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    if (!sd->cache_valid || sd->cached != sector) {
+        eer_hal_status_t status = eer_sd_flush(sd);
+        if (status != EER_HAL_OK) {
+            return status;
+        }
+        
+        sd->cache_valid = false;
+        status = eer_sd_read(sd, sector, sd->cache, 1);
+        if (status != EER_HAL_OK) {
+            return status;
+        }
+        
+        sd->cached = sector;
+        sd->cache_valid = true;
+    }
+    
+    *data = sd->cache;
+    return EER_HAL_OK;
+}
+
+void eer_sd_cache_dirty(eer_sd_t* sd) {
+    if (sd != NULL && sd->cache_valid) {
+        sd->cache_dirty = true;
+    }
+}
+
+eer_hal_status_t eer_sd_flush(eer_sd_t* sd) {
+    if (sd == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    if (!sd->cache_dirty) {
+        return EER_HAL_OK;
+    }
+    
+    if (sd->request != NULL) {
+        return EER_HAL_BUSY;
+    }
+    
+    eer_hal_status_t status = sd_select(sd, &sd->device);
+    if (status == EER_HAL_OK) {
+        status = sd_deselect(sd, sd_write_blocks(sd, sd->cached, sd->cache, 1));
+    }
+    
+    if (status == EER_HAL_OK) {
+        sd->cache_dirty = false;
+    }
+    
+    return status;
+}
@@ -0,0 +1,40 @@
+#include "eer_spi_device.h"
+#include <stddef.h>
+
+eer_hal_status_t eer_spi_device_init(const eer_spi_device_t* device) {
+    if (device == NULL || device->cs == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_spi_config_t config = {
+        .mode = EER_SPI_MODE_0,
+        .bit_order = EER_SPI_BIT_ORDER_MSB,
+        .data_size = EER_SPI_DATA_SIZE_8BIT,
+        .prescaler = device->prescaler,
+        .master = true
+    };
+    
+    eer_hal_status_t status = eer_hal_call(spi, init, &config);
+    if (status != EER_HAL_OK) {
+        return status;
+    }
+    
+    // chip_select only sets the level
+    eer_gpio_config_t output = { .mode = EER_GPIO_MODE_OUTPUT };
+    eer_hal_call(gpio, configure, device->cs, &output);
+    
+    return eer_hal_call(spi, chip_select, device->cs, false);
+}
+
+eer_hal_status_t eer_spi_device_select(const eer_spi_device_t* device) {
+    eer_hal_status_t status = eer_hal_call(spi, set_prescaler, device->prescaler);
+    if (status != EER_HAL_OK) {
+        return status;
+    }
+    
+    return eer_hal_call(spi, chip_select, device->cs, true);
+}
+
+eer_hal_status_t eer_spi_device_deselect(const eer_spi_device_t* device) {
+    return eer_hal_call(spi, chip_select, device->cs, false);
+}
@@ -0,0 +1,435 @@
+#include "eer_tft.h"
+#include "eer_spi_device.h"
+#include <stddef.h>
+
+#ifdef __AVR__
+#include <avr/pgmspace.h>
+
+// Bitmaps stay in flash and are read with LPM
+#define tft_read(data, index) pgm_read_byte(&(data)[index])
+#else
+#define tft_read(data, index) ((data)[index])
+#endif
+
+// Power-up delays of the controller
+#define TFT_RESET_MS    120
+#define TFT_SWRESET_MS  150
+#define TFT_SLPOUT_MS   120
+#define TFT_DISPON_MS   10
+
+// 16 bits per pixel
+#define TFT_COLMOD_RGB565 0x05
+
+static void tft_wait(eer_async_request_t* request) {
+    while (request->status == EER_HAL_BUSY) {
+    }
+}
+
+/**
+ * @brief Queue the buffer being filled and switch to the other one
+ * @return Status code of the submission, also kept in tft->status if it is
+ *         the first failure of the primitive
+ */
+static eer_hal_status_t tft_submit(eer_tft_t* tft) {
+    if (tft->fill == 0) {
+        return EER_HAL_OK;
+    }
+    
+    eer_async_request_t* request = &tft->request[tft->chunk];
+    request->tx_data = tft->buffer[tft->chunk];
+    request->tx_size = tft->fill;
+    
+    // A chunk that was not queued is dropped, the primitive goes on
+    eer_hal_status_t status = eer_async_submit(request);
+    if (status != EER_HAL_OK && tft->status == EER_HAL_OK) {
+        tft->status = status;
+    }
+    
+    tft->chunk ^= 1;
+    tft->fill = 0;
+    
+    return status;
+}
+
+/**
+ * @brief Queue the last chunk of a primitive
+ * @return First failure of the primitive, EER_HAL_OK if there was none
+ */
+static eer_hal_status_t tft_end(eer_tft_t* tft) {
+    tft_submit(tft);
+    
+    return tft->status;
+}
+
+static inline void tft_push(eer_tft_t* tft, uint16_t color) {
+    // The buffer is reused once its last transmission is over
+    if (tft->fill == 0) {
+        tft_wait(&tft->request[tft->chunk]);
+    }
+    
+    uint8_t* buffer = tft->buffer[tft->chunk];
+    buffer[tft->fill++] = (uint8_t)(color >> 8);
+    buffer[tft->fill++] = (uint8_t)color;
+    
+    if (tft->fill == EER_TFT_CHUNK) {
+        tft_submit(tft);
+    }
+}
+
+static void tft_repeat(eer_tft_t* tft, uint16_t color, uint32_t count) {
+    while (count-- > 0) {
+        tft_push(tft, color);
+    }
+}
+
+/**
+ * @brief Intersect a rectangle with the clip region
+ * @return false if nothing of it is drawn
+ */
+static bool tft_clip(eer_tft_t* tft, uint16_t x, uint16_t y, uint32_t width, uint16_t height,
+                     uint16_t* x0, uint16_t* y0, uint16_t* x1, uint16_t* y1) {
+    uint32_t right = x + width;
+    uint32_t bottom = (uint32_t)y + height;
+    
+    *x0 = x > tft->clip_x0 ? x : tft->clip_x0;
+    *y0 = y > tft->clip_y0 ? y : tft->clip_y0;
+    *x1 = right < tft->clip_x1 ? (uint16_t)right : tft->clip_x1;
+    *y1 = bottom < tft->clip_y1 ? (uint16_t)bottom : tft->clip_y1;
+    
+    return *x0 < *x1 && *y0 < *y1;
+}
+
+/**
+ * @brief Start a primitive with its address window
+ */
+static void tft_window(eer_tft_t* tft, uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+    uint16_t column_start = x0 + tft->x_offset;
+    uint16_t column_end = x1 - 1 + tft->x_offset;
+    uint16_t row_start = y0 + tft->y_offset;
+    uint16_t row_end = y1 - 1 + tft->y_offset;
+    
+    uint8_t columns[4] = {
+        (uint8_t)(column_start >> 8), (uint8_t)column_start, (uint8_t)(column_end >> 8), (uint8_t)column_end
+    };
+    uint8_t rows[4] = {
+        (uint8_t)(row_start >> 8), (uint8_t)row_start, (uint8_t)(row_end >> 8), (uint8_t)row_end
+    };
+    
+    eer_hal_status_t status = eer_tft_command(tft, EER_TFT_CASET, columns, sizeof(columns));
+    if (status == EER_HAL_OK) {
+        status = eer_tft_command(tft, EER_TFT_RASET, rows, sizeof(rows));
+    }
+    if (status == EER_HAL_OK) {
+        status = eer_tft_command(tft, EER_TFT_RAMWR, NULL, 0);
+    }
+    
+    tft->status = status;
+}
+
+static void tft_reset_clip(eer_tft_t* tft) {
+    tft->clip_x0 = 0;
+    tft->clip_y0 = 0;
+    tft->clip_x1 = tft->width;
+    tft->clip_y1 = tft->height;
+}
+
+eer_hal_status_t eer_tft_init(eer_tft_t* tft) {
+    if (tft == NULL || tft->dc == NULL || tft->width == 0 || tft->height == 0) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    eer_hal_status_t status = eer_spi_device_init(&tft->device);
+    if (status != EER_HAL_OK) {
+        return status;
+    }
+    
+    for (uint8_t i = 0; i < 2; i++) {
+        eer_async_request_t* request = &tft->request[i];
+        request->bus = EER_ASYNC_SPI;
+        request->flags = 0;
+        request->device = &tft->device;
+        request->rx_data = NULL;
+        request->rx_size = 0;
+        request->handler = NULL;
+        request->next = NULL;
+        request->status = EER_HAL_OK;
+    }
+    
+    tft->chunk = 0;
+    tft->fill = 0;
+    tft->status = EER_HAL_OK;
+    tft->dirty = false;
+    tft_reset_clip(tft);
+    
+    eer_gpio_config_t output = { .mode = EER_GPIO_MODE_OUTPUT };
+    eer_hal_call(gpio, configure, tft->dc, &output);
+    eer_hal_call(gpio, write, tft->dc, true);
+    
+    if (tft->reset != NULL) {
+        eer_hal_call(gpio, configure, tft->reset, &output);
+        eer_hal_call(gpio, write, tft->reset, false);
+        eer_hal_call(system, delay_ms, 1);
+        eer_hal_call(gpio, write, tft->reset, true);
+        eer_hal_call(system, delay_ms, TFT_RESET_MS);
+    }
+    
+    static const uint8_t colmod = TFT_COLMOD_RGB565;
+    
+    eer_tft_command(tft, EER_TFT_SWRESET, NULL, 0);
+    eer_hal_call(system, delay_ms, TFT_SWRESET_MS);
+    eer_tft_command(tft, EER_TFT_SLPOUT, NULL, 0);
+    eer_hal_call(system, delay_ms, TFT_SLPOUT_MS);
+    eer_tft_command(tft, EER_TFT_COLMOD, &colmod, 1);
+    eer_tft_command(tft, EER_TFT_MADCTL, &tft->madctl, 1);
+    
+    status = eer_tft_command(tft, EER_TFT_DISPON, NULL, 0);
+    eer_hal_call(system, delay_ms, TFT_DISPON_MS);
+    
+    return status;
+}
+
+eer_hal_status_t eer_tft_command(eer_tft_t* tft, uint8_t command, const uint8_t* parameters, uint8_t size) {
+    if (tft == NULL || (size > 0 && parameters == NULL)) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    // Pixels still queued are data
+    eer_tft_flush(tft);
+    
+    eer_hal_status_t status = eer_spi_device_select(&tft->device);
+    if (status != EER_HAL_OK) {
+        return status;
+    }
+    
+    eer_hal_call(gpio, write, tft->dc, false);
+    status = eer_hal_call(spi, transfer, &command, NULL, 1, 0);
+    eer_hal_call(gpio, write, tft->dc, true);
+    
+    if (status == EER_HAL_OK && size > 0) {
+        status = eer_hal_call(spi, transfer, parameters, NULL, size, 0);
+    }
+    
+    eer_spi_device_deselect(&tft->device);
+    
+    return status;
+}
+
+eer_hal_status_t eer_tft_fill(eer_tft_t* tft, uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t color) {
+    uint16_t x0, y0, x1, y1;
+    
+    if (!tft_clip(tft, x, y, width, height, &x0, &y0, &x1, &y1)) {
+        return EER_HAL_OK;
+    }
+    
+    tft_window(tft, x0, y0, x1, y1);
+    tft_repeat(tft, color, (uint32_t)(x1 - x0) * (y1 - y0));
+    
+    return tft_end(tft);
+}
+
+eer_hal_status_t eer_tft_spans(eer_tft_t* tft, uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                               const eer_tft_span_t* spans, uint16_t count) {
+    uint16_t x0, y0, x1, y1;
+    
+    if (spans == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    if (!tft_clip(tft, x, y, width, height, &x0, &y0, &x1, &y1)) {
+        return EER_HAL_OK;
+    }
+    
+    tft_window(tft, x0, y0, x1, y1);
+    
+    // Visible columns and rows relative to the rectangle
+    uint16_t left = x0 - x;
+    uint16_t right = x1 - x;
+    uint16_t top = y0 - y;
+    uint16_t bottom = y1 - y;
+    
+    uint16_t column = 0;
+    uint16_t row = 0;
+    
+    for (uint16_t i = 0; i < count && row < bottom; i++) {
+        uint16_t remaining = spans[i].length;
+        
+        // Cut the span at row ends, sending the visible part of each piece
+        while (remaining > 0 && row < bottom) {
+            uint16_t piece = width - column;
+            if (piece > remaining) {
+                piece = remaining;
+            }
+            
+            if (row >= top) {
+                uint16_t start = column > left ? column : left;
+                uint16_t end = column + piece < right ? column + piece : right;
+                
+                if (start < end) {
+                    tft_repeat(tft, spans[i].color, end - start);
+                }
+            }
+            
+            remaining -= piece;
+            column += piece;
+            if (column == width) {
+                column = 0;
+                row++;
+            }
+        }
+    }
+    
+    return tft_end(tft);
+}
+
+eer_hal_status_t eer_tft_bitmap(eer_tft_t* tft, uint16_t x, uint16_t y, uint16_t width, uint16_t height,
+                                const uint8_t* bitmap, uint16_t foreground, uint16_t background) {
+    uint16_t x0, y0, x1, y1;
+    
+    if (bitmap == NULL) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    if (!tft_clip(tft, x, y, width, height, &x0, &y0, &x1, &y1)) {
+        return EER_HAL_OK;
+    }
+    
+    tft_window(tft, x0, y0, x1, y1);
+    
+    uint16_t stride = (width + 7) / 8;
+    
+    for (uint16_t row = y0 - y; row < y1 - y; row++) {
+        const uint8_t* line = bitmap + (uint32_t)row * stride;
+        uint16_t column = x0 - x;
+        uint8_t bits = tft_read(line, column >> 3) << (column & 7);
+        
+        for (; column < x1 - x; column++) {
+            if ((column & 7) == 0) {
+                bits = tft_read(line, column >> 3);
+            }
+            
+            tft_push(tft, bits & 0x80 ? foreground : background);
+            bits <<= 1;
+        }
+    }
+    
+    return tft_end(tft);
+}
+
+eer_hal_status_t eer_tft_text(eer_tft_t* tft, uint16_t x, uint16_t y, const char* text,
+                              const eer_tft_font_t* font, uint16_t foreground, uint16_t background) {
+    uint16_t x0, y0, x1, y1;
+    
+    if (text == NULL || font == NULL || font->width == 0) {
+        return EER_HAL_INVALID_PARAM;
+    }
+    
+    uint16_t length = 0;
+    while (text[length] != '\0') {
+        length++;
+    }
+    
+    if (!tft_clip(tft, x, y, (uint32_t)length * font->width, font->height, &x0, &y0, &x1, &y1)) {
+        return EER_HAL_OK;
+    }
+    
+    // One window for the whole string, swept row by row across the glyphs
+    tft_window(tft, x0, y0, x1, y1);
+    
+    uint8_t stride = (font->width + 7) / 8;
+    uint16_t glyph_size = (uint16_t)font->height * stride;
+    
+    for (uint16_t row = y0 - y; row < y1 - y; row++) {
+        uint16_t column = x0 - x;
+        
+        while (column < x1 - x) {
+            uint16_t index = column / font->width;
+            uint8_t glyph_column = column - index * font->width;
+            uint8_t character = (uint8_t)text[index] - font->first;
+            
+            const uint8_t* line = NULL;
+            if ((uint8_t)text[index] >= font->first && character < font->count) {
+                line = font->bitmaps + (uint32_t)character * glyph_size + (uint16_t)row * stride;
+            }
+            
+            uint8_t bits = line != NULL ? tft_read(line, glyph_column >> 3) << (glyph_column & 7) : 0;
+            
+            for (; glyph_column < font->width && column < x1 - x; glyph_column++, column++) {
+                if ((glyph_column & 7) == 0 && line != NULL) {
+                    bits = tft_read(line, glyph_column >> 3);
+                }
+                
+                tft_push(tft, bits & 0x80 ? foreground : background);
+                bits <<= 1;
+            }
+        }
+    }
+    
+    return tft_end(tft);
+}
+
+void eer_tft_invalidate(eer_tft_t* tft, uint16_t x, uint16_t y, uint16_t width, uint16_t height) {
+    uint32_t right = (uint32_t)x + width;
+    uint32_t bottom = (uint32_t)y + height;
+    
+    if (right > tft->width) {
+        right = tft->width;
+    }
+    if (bottom > tft->height) {
+        bottom = tft->height;
+    }
+    if (x >= right || y >= bottom) {
+        return;
+    }
+    
+    if (!tft->dirty) {
+        tft->dirty_x0 = x;
+        tft->dirty_y0 = y;
+        tft->dirty_x1 = (uint16_t)right;
+        tft->dirty_y1 = (uint16_t)bottom;
+        tft->dirty = true;
+        return;
+    }
+    
+    // Bounding box of the regions
+    if (x < tft->dirty_x0) {
+        tft->dirty_x0 = x;
+    }
+    if (y < tft->dirty_y0) {
+        tft->dirty_y0 = y;
+    }
+    if (right > tft->dirty_x1) {
+        tft->dirty_x1 = (uint16_t)right;
+    }
+    if (bottom > tft->dirty_y1) {
+        tft->dirty_y1 = (uint16_t)bottom;
+    }
+}
+
+void eer_tft_render(eer_tft_t* tft, eer_tft_draw_t draw, void* user_data) {
+    if (!tft->dirty || draw == NULL) {
+        return;
+    }
+    
+    tft->clip_x0 = tft->dirty_x0;
+    tft->clip_y0 = tft->dirty_y0;
+    tft->clip_x1 = tft->dirty_x1;
+    tft->clip_y1 = tft->dirty_y1;
+    
+    // Regions invalidated while drawing are left for the next render
+    tft->dirty = false;
+    
+    draw(tft, user_data);
+    
+    tft_reset_clip(tft);
+}
+
+eer_hal_status_t eer_tft_flush(eer_tft_t* tft) {
+    eer_hal_status_t status = tft_submit(tft);
+    
+    for (uint8_t i = 0; i < 2; i++) {
+        tft_wait(&tft->request[i]);
+        if (status == EER_HAL_OK) {
+            status = tft->request[i].status;
+        }
+    }
+    
+    return status;
+}
@@ -0,0 +1,121 @@
+#include "eer_hal.h"
+#include "eer_trace.h"
+
+#ifdef EER_HAL_TRACE
+
+// Dump format
+#define TRACE_VERSION     1
+#define TRACE_RECORD_SIZE 5
+#define TRACE_HEADER_SIZE 12
+
+// Records serialized per UART transmit
+#define TRACE_DUMP_BATCH  8
+
+uint16_t eer_trace_timestamps[EER_TRACE_SIZE];
+uint8_t eer_trace_events[EER_TRACE_SIZE];
+uint16_t eer_trace_arguments[EER_TRACE_SIZE];
+volatile uint8_t eer_trace_head = 0;
+volatile bool eer_trace_enabled = true;
+
+/**
+ * @brief Store a 16-bit value little-endian
+ */
+static void trace_put16(uint8_t* data, uint16_t value) {
+    data[0] = (uint8_t)value;
+    data[1] = (uint8_t)(value >> 8);
+}
+
+void eer_trace_start(void) {
+    eer_trace_enabled = true;
+}
+
+void eer_trace_stop(void) {
+    eer_trace_enabled = false;
+}
+
+void eer_trace_clear(void) {
+    eer_trace_lock_t lock = eer_trace_lock();
+    
+    for (uint16_t i = 0; i < EER_TRACE_SIZE; i++) {
+        eer_trace_events[i] = EER_TRACE_NONE;
+    }
+    eer_trace_head = 0;
+    
+    eer_trace_unlock(lock);
+}
+
+uint16_t eer_trace_read(eer_trace_record_t* records) {
+    uint16_t count = 0;
+    
+    eer_trace_lock_t lock = eer_trace_lock();
+    
+    // Slots are filled in order, the oldest record follows the head once
+    // the ring has wrapped; empty slots are skipped
+    uint8_t index = eer_trace_head;
+    for (uint16_t i = 0; i < EER_TRACE_SIZE; i++) {
+        if (eer_trace_events[index] != EER_TRACE_NONE) {
+            records[count].timestamp = eer_trace_timestamps[index];
+            records[count].event = eer_trace_events[index];
+            records[count].argument = eer_trace_arguments[index];
+            count++;
+        }
+        index = (index + 1) & (EER_TRACE_SIZE - 1);
+    }
+    
+    eer_trace_unlock(lock);
+    
+    return count;
+}
+
+eer_hal_status_t eer_trace_dump(uint32_t timeout) {
+    bool enabled = eer_trace_enabled;
+    eer_trace_enabled = false;
+    
+    // Count the records first, the header carries the number
+    uint16_t count = 0;
+    for (uint16_t i = 0; i < EER_TRACE_SIZE; i++) {
+        if (eer_trace_events[i] != EER_TRACE_NONE) {
+            count++;
+        }
+    }
+    
+    uint8_t header[TRACE_HEADER_SIZE] = { 'E', 'E', 'R', 'T', TRACE_VERSION, TRACE_RECORD_SIZE };
+    trace_put16(&header[6], count);
+    trace_put16(&header[8], EER_TRACE_TICK_US);
+    trace_put16(&header[10], EER_TRACE_SUB_PER_TICK);
+    
+    eer_hal_status_t status = eer_hal_call(uart, transmit, header, sizeof(header), timeout);
+    
+    // Records oldest first, in batches
+    uint8_t batch[TRACE_DUMP_BATCH * TRACE_RECORD_SIZE];
+    uint16_t size = 0;
+    uint8_t index = eer_trace_head;
+    for (uint16_t i = 0; i < EER_TRACE_SIZE && status == EER_HAL_OK; i++) {
+        uint8_t slot = index;
+        index = (index + 1) & (EER_TRACE_SIZE - 1);
+        
+        if (eer_trace_events[slot] == EER_TRACE_NONE) {
+            continue;
+        }
+        
+        trace_put16(&batch[size], eer_trace_timestamps[slot]);
+        batch[size + 2] = eer_trace_events[slot];
+        trace_put16(&batch[size + 3], eer_trace_arguments[slot]);
+        size += TRACE_RECORD_SIZE;
+        
+        if (size == sizeof(batch)) {
+            status = eer_hal_call(uart, transmit, batch, size, timeout);
+            size = 0;
+        }
+    }
+    
+    if (size > 0 && status == EER_HAL_OK) {
+        status = eer_hal_call(uart, transmit, batch, size, timeout);
+    }
+    
+    eer_trace_enabled = enabled;
+    
+    return status;
+}
+
+#endif
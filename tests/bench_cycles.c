@@ -0,0 +1,208 @@
+/**
+ * @file bench_cycles.c
+ * @brief CPU cycles of the AVR hot paths, run under simavr
+ *
+ * Times each operation with Timer1 counting the CPU clock and prints one
+ * line per result over USART0:
+ *
+ *     bench <name> <cycles> <call|byte>
+ *
+ * then halts by sleeping with interrupts disabled, which ends a simavr run.
+ * Each result is the minimum of BENCH_SAMPLES runs with the cost of an
+ * empty measurement subtracted, so it counts the call, argument setup and
+ * the function itself. bench_cycles.cmake compares the results against
+ * bench_cycles_baseline.txt.
+ */
+#include "eer_hal.h"
+#include "gpio.h"
+#include "uart.h"
+#include "spi.h"
+#include "system.h"
+#include "eer_trace.h"
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define BENCH_SAMPLES 8
+
+// Bytes of the long SPI transfer, the per-byte cost is taken between a
+// transfer of 1 and 1 + BENCH_SPI_BYTES bytes
+#define BENCH_SPI_BYTES 16
+
+// Wait for room in the transmitter when printing a result; a timeout of 0
+// would only send what fits without waiting
+#define BENCH_UART_TIMEOUT_MS 1000
+
+// Receive vector of the USART of the single-instance operations, from the
+// MCU descriptor
+#define BENCH_UART_VECTOR(n) EER_AVR_UART##n##_RX_vect
+#define BENCH_UART_RX_VECTOR(n) BENCH_UART_VECTOR(n)
+#define BENCH_UART_RX_vect BENCH_UART_RX_VECTOR(EER_AVR_UART_DEFAULT)
+
+/**
+ * @brief Time a statement in CPU cycles
+ * @param result uint16_t receiving the minimum over BENCH_SAMPLES runs,
+ *               less bench_overhead
+ * @param statement Statement to time
+ */
+#define BENCH_MEASURE(result, statement) do { \
+    result = UINT16_MAX; \
+    for (uint8_t sample = 0; sample < BENCH_SAMPLES; sample++) { \
+        TCNT1 = 0; \
+        statement; \
+        uint16_t cycles = TCNT1 - bench_overhead; \
+        if (cycles < result) { \
+            result = cycles; \
+        } \
+    } \
+} while (0)
+
+static const eer_pin_t bench_pin = eer_hal_pin(B, 5);
+
+// Cycles of an empty measurement, zero while it is being measured
+static uint16_t bench_overhead = 0;
+
+// Minimal receive callback, the cost of reaching a handler from the ISR
+static void bench_rx_handler(eer_uart_rx_event_t* event) {
+    (void)event;
+}
+
+/**
+ * @brief Send a string over USART0
+ */
+static void bench_print(const char* text) {
+    uint16_t length = 0;
+    while (text[length] != '\0') {
+        length++;
+    }
+    avr_uart_transmit((const uint8_t*)text, length, BENCH_UART_TIMEOUT_MS);
+}
+
+/**
+ * @brief Send a decimal number over USART0
+ */
+static void bench_print_number(uint16_t value) {
+    char digits[6];
+    uint8_t position = sizeof(digits) - 1;
+
+    digits[position] = '\0';
+    do {
+        digits[--position] = '0' + value % 10;
+        value /= 10;
+    } while (value > 0);
+
+    bench_print(&digits[position]);
+}
+
+/**
+ * @brief Print one result line
+ * @param name Operation name
+ * @param cycles Measured cycles
+ * @param divisor Number of units the cycles cover
+ * @param unit "call" or "byte"
+ */
+static void bench_report(const char* name, uint16_t cycles, uint8_t divisor, const char* unit) {
+    bench_print("bench ");
+    bench_print(name);
+    bench_print(" ");
+    bench_print_number(cycles / divisor);
+    bench_print(" ");
+    bench_print(unit);
+    bench_print("\n");
+}
+
+int main(void) {
+    static uint8_t spi_buffer[1 + BENCH_SPI_BYTES];
+    uint16_t cycles;
+    uint32_t ticks;
+    bool state;
+
+    eer_uart_config_t uart_config = {
+        .baudrate = 38400,
+        .data_bits = EER_UART_DATA_BITS_8,
+        .parity = EER_UART_PARITY_NONE,
+        .stop_bits = EER_UART_STOP_BITS_1,
+        .flow_control = false
+    };
+    avr_uart_init(&uart_config);
+
+    eer_spi_config_t spi_config = {
+        .mode = EER_SPI_MODE_0,
+        .bit_order = EER_SPI_BIT_ORDER_MSB,
+        .data_size = EER_SPI_DATA_SIZE_8BIT,
+        .prescaler = EER_SPI_PRESCALER_2,
+        .master = true
+    };
+    avr_spi_init(&spi_config);
+
+    eer_gpio_config_t gpio_config = {
+        .mode = EER_GPIO_MODE_OUTPUT,
+        .speed = EER_GPIO_SPEED_HIGH,
+        .trigger = EER_GPIO_TRIGGER_NONE
+    };
+    avr_gpio_configure((void*)&bench_pin, &gpio_config);
+
+    // Timer1 in normal mode counting the CPU clock; measurements run with
+    // interrupts disabled so the system tick does not land in them
+    cli();
+    TCCR1A = 0;
+    TCCR1B = (1 << CS10);
+
+    BENCH_MEASURE(bench_overhead, (void)0);
+
+    // GPIO, direct and through the handler table
+    BENCH_MEASURE(cycles, avr_gpio_write((void*)&bench_pin, true));
+    bench_report("gpio_write", cycles, 1, "call");
+
+    BENCH_MEASURE(cycles, eer_hal.gpio->write((void*)&bench_pin, false));
+    bench_report("gpio_write_table", cycles, 1, "call");
+
+    BENCH_MEASURE(cycles, avr_gpio_toggle((void*)&bench_pin));
+    bench_report("gpio_toggle", cycles, 1, "call");
+
+    BENCH_MEASURE(cycles, avr_gpio_read((void*)&bench_pin, &state));
+    bench_report("gpio_read", cycles, 1, "call");
+
+    // SPI: fixed cost of a call and cost of each further byte
+    uint16_t single;
+    BENCH_MEASURE(single, avr_spi_transfer(spi_buffer, spi_buffer, 1, 0));
+    bench_report("spi_transfer", single, 1, "call");
+
+    BENCH_MEASURE(cycles, avr_spi_transfer(spi_buffer, spi_buffer, sizeof(spi_buffer), 0));
+    bench_report("spi_transfer", cycles - single, BENCH_SPI_BYTES, "byte");
+
+    // Receive ISR entered by a call; its RETI enables interrupts again
+    void BENCH_UART_RX_vect(void);
+    BENCH_MEASURE(cycles, { BENCH_UART_RX_vect(); cli(); });
+    bench_report("uart_rx_isr", cycles, 1, "call");
+
+    avr_uart_register_rx_callback(bench_rx_handler, NULL);
+    BENCH_MEASURE(cycles, { BENCH_UART_RX_vect(); cli(); });
+    bench_report("uart_rx_isr_callback", cycles, 1, "call");
+    avr_uart_unregister_rx_callback();
+
+    // System tick read, which saves and restores SREG around the copy
+    BENCH_MEASURE(cycles, avr_system_get_tick(&ticks));
+    bench_report("system_get_tick", cycles, 1, "call");
+
+#ifdef EER_HAL_TRACE
+    // Trace records, inlined at every trace point of a traced build
+    BENCH_MEASURE(cycles, eer_trace_isr(EER_TRACE_USER, cycles));
+    bench_report("trace_record_isr", cycles, 1, "call");
+
+    BENCH_MEASURE(cycles, eer_trace(EER_TRACE_USER, cycles));
+    bench_report("trace_record", cycles, 1, "call");
+#endif
+
+    bench_print("bench done\n");
+    avr_uart_flush();
+
+    // Sleeping with interrupts disabled ends the simulation
+    sleep_enable();
+    sleep_cpu();
+
+    for (;;) {
+    }
+}
@@ -0,0 +1,111 @@
+# Runs the bench_cycles firmware under simavr and checks the results against
+# a stored baseline. Invoked with cmake -P by the bench_cycles test and the
+# bench_cycles_baseline target:
+#
+#   SIMAVR     simavr executable
+#   FIRMWARE   bench_cycles ELF
+#   MCU        MCU name as simavr knows it, e.g. atmega328p
+#   FREQUENCY  CPU clock in Hz
+#   BASELINE   baseline file, lines of "<name> <unit> <cycles>"
+#   TOLERANCE  cycles a result may exceed its baseline by, default 0 as the
+#              simulation is cycle-exact
+#   UPDATE     write the results to BASELINE instead of checking them
+#
+# Every result needs a baseline entry and every entry a result: a hot path
+# without a baseline fails the check, and so does one the firmware stopped
+# reporting, e.g. the trace records of a build without EER_HAL_TRACE.
+
+foreach(variable SIMAVR FIRMWARE MCU FREQUENCY BASELINE)
+    if(NOT DEFINED ${variable})
+        message(FATAL_ERROR "bench_cycles: ${variable} not set")
+    endif()
+endforeach()
+
+if(NOT DEFINED TOLERANCE)
+    set(TOLERANCE 0)
+endif()
+
+# The firmware halts by sleeping with interrupts disabled, the timeout only
+# catches a hang
+execute_process(
+    COMMAND ${SIMAVR} -m ${MCU} -f ${FREQUENCY} ${FIRMWARE}
+    OUTPUT_VARIABLE output
+    ERROR_VARIABLE output
+    TIMEOUT 120)
+
+# simavr prints each line the firmware sends on USART0, possibly wrapped in
+# colour escapes
+string(REGEX MATCHALL "bench [a-z0-9_]+ [0-9]+ (call|byte)" lines "${output}")
+if(NOT output MATCHES "bench done" OR NOT lines)
+    message(FATAL_ERROR "bench_cycles: no results from simavr\n${output}")
+endif()
+
+if(UPDATE)
+    set(content "# Cycles of the AVR hot paths on ${MCU}, written by the bench_cycles_baseline target\n")
+    foreach(line IN LISTS lines)
+        string(REGEX REPLACE "bench ([a-z0-9_]+) ([0-9]+) ([a-z]+)" "\\1 \\3 \\2" entry "${line}")
+        string(APPEND content "${entry}\n")
+    endforeach()
+    file(WRITE ${BASELINE} "${content}")
+    message(STATUS "bench_cycles: baseline written to ${BASELINE}")
+    return()
+endif()
+
+if(EXISTS ${BASELINE})
+    file(STRINGS ${BASELINE} baseline REGEX "^[a-z0-9_]+ [a-z]+ [0-9]+$")
+endif()
+
+set(regressions 0)
+set(missing 0)
+foreach(line IN LISTS lines)
+    string(REGEX REPLACE "bench ([a-z0-9_]+) ([0-9]+) ([a-z]+)" "\\1;\\2;\\3" result "${line}")
+    list(GET result 0 name)
+    list(GET result 1 cycles)
+    list(GET result 2 unit)
+
+    set(stored "")
+    foreach(entry IN LISTS baseline)
+        if(entry MATCHES "^${name} ${unit} ([0-9]+)$")
+            set(stored ${CMAKE_MATCH_1})
+        endif()
+    endforeach()
+
+    if(stored STREQUAL "")
+        message(STATUS "${name}: ${cycles} cycles/${unit} - NO BASELINE")
+        math(EXPR missing "${missing} + 1")
+    else()
+        math(EXPR limit "${stored} + ${TOLERANCE}")
+        if(cycles GREATER limit)
+            message(STATUS "${name}: ${cycles} cycles/${unit}, baseline ${stored} - REGRESSION")
+            math(EXPR regressions "${regressions} + 1")
+        else()
+            message(STATUS "${name}: ${cycles} cycles/${unit}, baseline ${stored}")
+        endif()
+    endif()
+endforeach()
+
+if(regressions GREATER 0)
+    message(FATAL_ERROR "bench_cycles: ${regressions} hot path(s) slower than the baseline")
+endif()
+
+# Baseline entries the firmware did not report
+set(unmeasured 0)
+foreach(entry IN LISTS baseline)
+    string(REGEX REPLACE " [0-9]+$" "" key "${entry}")
+    string(REPLACE " " ";" key "${key}")
+    list(GET key 0 name)
+    list(GET key 1 unit)
+    if(NOT output MATCHES "bench ${name} [0-9]+ ${unit}")
+        message(STATUS "${name}: in the baseline but not measured (${unit})")
+        math(EXPR unmeasured "${unmeasured} + 1")
+    endif()
+endforeach()
+
+if(unmeasured GREATER 0)
+    message(FATAL_ERROR "bench_cycles: ${unmeasured} hot path(s) of the baseline not measured")
+endif()
+
+if(missing GREATER 0)
+    message(FATAL_ERROR "bench_cycles: ${missing} hot path(s) without a baseline, "
+                        "record it with the bench_cycles_baseline target")
+endif()
@@ -0,0 +1,106 @@
+/**
+ * @file bench_dispatch.c
+ * @brief Call overhead of table and static HAL dispatch
+ *
+ * Runs each kernel of bench_dispatch_kernel.c and prints the time per HAL
+ * call. Build targets bench_dispatch_table and bench_dispatch_static run
+ * the same kernels in each mode; the bench_dispatch_size target prints the
+ * code size of both kernel objects.
+ */
+#include "eer_hal.h"
+#include "gpio.h"
+#include "bench_dispatch.h"
+#include <stdio.h>
+#include <stdint.h>
+
+#ifdef __AVR__
+#define BENCH_LOOPS 10000
+#elif defined(__riscv)
+#define BENCH_LOOPS 10000
+#define BENCH_ROUNDS 10
+#else
+#define BENCH_LOOPS 50000
+#define BENCH_ROUNDS 100
+#include <time.h>
+#endif
+
+static const eer_pin_t bench_pin = eer_hal_pin(B, 5);
+
+/**
+ * @brief Current time in nanoseconds
+ */
+static uint64_t bench_now_ns(void) {
+#ifdef __AVR__
+    uint32_t ticks;
+    eer_hal.system->get_tick(&ticks);
+    return (uint64_t)ticks * 1000000;
+#elif defined(__riscv)
+    return riscv_mtime_to_us(riscv_mtime()) * 1000;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000 + (uint64_t)now.tv_nsec;
+#endif
+}
+
+/**
+ * @brief Run a kernel and print the time per call
+ * @param name Kernel name
+ * @param kernel Kernel function
+ * @param calls HAL calls per loop
+ */
+static void bench_run(const char* name, void (*kernel)(uint16_t loops), uint8_t calls) {
+    uint64_t start = bench_now_ns();
+    
+#ifdef BENCH_ROUNDS
+    for (uint16_t round = 0; round < BENCH_ROUNDS; round++) {
+        kernel(BENCH_LOOPS);
+    }
+    uint32_t total = (uint32_t)BENCH_LOOPS * BENCH_ROUNDS * calls;
+#else
+    kernel(BENCH_LOOPS);
+    uint32_t total = (uint32_t)BENCH_LOOPS * calls;
+#endif
+
+    uint64_t elapsed = bench_now_ns() - start;
+    
+    printf("%-8s %-12s %6lu.%02lu ns/call\n", BENCH_MODE, name,
+           (unsigned long)(elapsed / total),
+           (unsigned long)(elapsed * 100 / total % 100));
+}
+
+static void bench_gpio_read_kernel(uint16_t loops) {
+    volatile uint16_t high = bench_gpio_read(loops);
+    (void)high;
+}
+
+int main(void) {
+    eer_hal.system->init();
+    eer_hal.gpio->init();
+    
+    eer_gpio_config_t output_config = {
+        .mode = EER_GPIO_MODE_OUTPUT,
+        .speed = EER_GPIO_SPEED_HIGH,
+        .trigger = EER_GPIO_TRIGGER_NONE
+    };
+    eer_hal.gpio->configure((void*)&bench_pin, &output_config);
+    
+    eer_timer_config_t timer_config = {
+        .frequency = 2000000,
+        .mode = EER_TIMER_MODE_CONTINUOUS,
+        .period = 0,
+        .channel = 0
+    };
+    eer_hal.timer->init(&timer_config);
+    eer_hal.timer->start();
+    
+    bench_run("gpio_write", bench_gpio_write, 2);
+    bench_run("gpio_toggle", bench_gpio_toggle, 1);
+    bench_run("gpio_read", bench_gpio_read_kernel, 1);
+    bench_run("timer_value", bench_timer_value, 1);
+    
+    eer_hal.timer->deinit();
+    eer_hal.system->deinit();
+    
+    return 0;
+}
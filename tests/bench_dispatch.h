@@ -0,0 +1,39 @@
+/**
+ * @file bench_dispatch.h
+ * @brief Kernels of the dispatch benchmark, each making two HAL calls per loop
+ *        at most
+ */
+#pragma once
+
+#include <stdint.h>
+
+#ifdef EER_HAL_STATIC
+#define BENCH_MODE "static"
+#else
+#define BENCH_MODE "table"
+#endif
+
+/**
+ * @brief Drive a pin high then low
+ * @param loops Number of iterations, two calls each
+ */
+void bench_gpio_write(uint16_t loops);
+
+/**
+ * @brief Toggle a pin
+ * @param loops Number of iterations, one call each
+ */
+void bench_gpio_toggle(uint16_t loops);
+
+/**
+ * @brief Sample a pin
+ * @param loops Number of iterations, one call each
+ * @return Number of samples that read high
+ */
+uint16_t bench_gpio_read(uint16_t loops);
+
+/**
+ * @brief Read the timer counter
+ * @param loops Number of iterations, one call each
+ */
+void bench_timer_value(uint16_t loops);
@@ -0,0 +1,47 @@
+/**
+ * @file bench_dispatch_kernel.c
+ * @brief HAL call sequences measured by bench_dispatch
+ *
+ * Compiled twice: through the eer_hal table and with EER_HAL_STATIC. The
+ * size of this object in each mode is the code size of the calls.
+ */
+#include "eer_hal.h"
+#include "gpio.h"
+#include "bench_dispatch.h"
+
+// Pin structures are const so static dispatch can fold their registers
+static const eer_pin_t bench_pin = eer_hal_pin(B, 5);
+
+void bench_gpio_write(uint16_t loops) {
+    while (loops--) {
+        eer_hal_call(gpio, write, (void*)&bench_pin, true);
+        eer_hal_call(gpio, write, (void*)&bench_pin, false);
+    }
+}
+
+void bench_gpio_toggle(uint16_t loops) {
+    while (loops--) {
+        eer_hal_call(gpio, toggle, (void*)&bench_pin);
+    }
+}
+
+uint16_t bench_gpio_read(uint16_t loops) {
+    uint16_t high = 0;
+    bool state;
+    
+    while (loops--) {
+        if (eer_hal_call(gpio, read, (void*)&bench_pin, &state) == EER_HAL_OK && state) {
+            high++;
+        }
+    }
+    
+    return high;
+}
+
+void bench_timer_value(uint16_t loops) {
+    uint32_t value;
+    
+    while (loops--) {
+        eer_hal_call(timer, get_value, &value);
+    }
+}
@@ -0,0 +1,243 @@
+# Flash and RAM footprint of each HAL module and of a linked application,
+# checked against a budget file. Invoked with cmake -P by the footprint
+# target:
+#
+#   SIZE_TOOL      size of the toolchain, run as size -A
+#   NM_TOOL        nm of the toolchain
+#   OBJECTS        object files of the eer_hal library, comma separated
+#   TABLE_APP      footprint_app linked with table dispatch
+#   STATIC_APP     footprint_app linked with EER_HAL_STATIC
+#   RODATA_IN_RAM  ON where read-only data is copied to RAM (AVR)
+#   BUDGET         optional budget file, lines of "<module> <flash> <ram>"
+#                  with sizes in bytes or - for no limit; module is an
+#                  object such as uart.c, library for the sum of them or
+#                  application for footprint_table
+#   REQUIRE_BUDGET ON to fail for a module without a budget entry, so the
+#                  check never passes on an empty budget file
+#   UPDATE         write the measurements to BUDGET instead of checking
+#                  them, HEADROOM percent above each; the entries of the
+#                  linked application are kept if present
+#
+# Flash counts code, PROGMEM and initial data; RAM counts data and bss,
+# static buffers included, but not the stack or heap.
+
+cmake_minimum_required(VERSION 3.12)
+
+foreach(variable SIZE_TOOL NM_TOOL OBJECTS TABLE_APP STATIC_APP)
+    if(NOT DEFINED ${variable})
+        message(FATAL_ERROR "footprint: ${variable} not set")
+    endif()
+endforeach()
+
+# Sum the sections of an object or executable into flash and RAM bytes
+function(footprint_measure file flash_variable ram_variable)
+    execute_process(COMMAND ${SIZE_TOOL} -A ${file} OUTPUT_VARIABLE output RESULT_VARIABLE result)
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "footprint: ${SIZE_TOOL} failed on ${file}")
+    endif()
+
+    set(flash 0)
+    set(ram 0)
+    string(REPLACE "\n" ";" lines "${output}")
+    foreach(line IN LISTS lines)
+        if(NOT line MATCHES "^(\\.[^ ]+) +([0-9]+) +[0-9]+")
+            continue()
+        endif()
+        set(section ${CMAKE_MATCH_1})
+        set(size ${CMAKE_MATCH_2})
+
+        if(section MATCHES "^\\.(text|progmem|vectors|init|fini|bootloader)")
+            math(EXPR flash "${flash} + ${size}")
+        elseif(section MATCHES "^\\.rodata")
+            math(EXPR flash "${flash} + ${size}")
+            if(RODATA_IN_RAM)
+                math(EXPR ram "${ram} + ${size}")
+            endif()
+        elseif(section MATCHES "^\\.data")
+            math(EXPR flash "${flash} + ${size}")
+            math(EXPR ram "${ram} + ${size}")
+        elseif(section MATCHES "^\\.(bss|noinit)")
+            math(EXPR ram "${ram} + ${size}")
+        endif()
+    endforeach()
+
+    set(${flash_variable} ${flash} PARENT_SCOPE)
+    set(${ram_variable} ${ram} PARENT_SCOPE)
+endfunction()
+
+# Sized symbols of a file as "<size> <type> <name>" entries, largest first
+function(footprint_symbols file types variable)
+    execute_process(COMMAND ${NM_TOOL} -S --size-sort --radix=d ${file} OUTPUT_VARIABLE output)
+    string(REPLACE "\n" ";" lines "${output}")
+    set(symbols "")
+    foreach(line IN LISTS lines)
+        if(line MATCHES "^[0-9]+ 0*([0-9]+) ([${types}]) (.+)$")
+            list(APPEND symbols "${CMAKE_MATCH_1} ${CMAKE_MATCH_2} ${CMAKE_MATCH_3}")
+        endif()
+    endforeach()
+    list(REVERSE symbols)
+    set(${variable} ${symbols} PARENT_SCOPE)
+endfunction()
+
+# Right-align a value in a column
+function(footprint_pad value width variable)
+    string(LENGTH "${value}" length)
+    set(padded "${value}")
+    while(length LESS width)
+        set(padded " ${padded}")
+        math(EXPR length "${length} + 1")
+    endwhile()
+    set(${variable} "${padded}" PARENT_SCOPE)
+endfunction()
+
+if(NOT DEFINED HEADROOM)
+    set(HEADROOM 0)
+endif()
+
+# Read the budgets
+set(budget_modules "")
+if(DEFINED BUDGET AND EXISTS ${BUDGET})
+    file(STRINGS ${BUDGET} budget_lines REGEX "^[A-Za-z0-9_.]+ +[-0-9]+ +[-0-9]+ *$")
+    foreach(line IN LISTS budget_lines)
+        string(REGEX REPLACE " +" ";" fields "${line}")
+        list(GET fields 0 module)
+        list(GET fields 1 budget_flash_${module})
+        list(GET fields 2 budget_ram_${module})
+        list(APPEND budget_modules ${module})
+    endforeach()
+endif()
+
+set(violations "")
+set(measurements "")
+
+# Record a measurement and check it against its budget
+function(footprint_check module flash ram)
+    list(APPEND measurements "${module} ${flash} ${ram}")
+    set(measurements ${measurements} PARENT_SCOPE)
+
+    footprint_pad(${flash} 7 flash_column)
+    footprint_pad(${ram} 6 ram_column)
+    set(line "  ${module}")
+    string(LENGTH "${module}" length)
+    while(length LESS 20)
+        string(APPEND line " ")
+        math(EXPR length "${length} + 1")
+    endwhile()
+    string(APPEND line "${flash_column} ${ram_column}")
+
+    if(module IN_LIST budget_modules)
+        set(limit_flash ${budget_flash_${module}})
+        set(limit_ram ${budget_ram_${module}})
+        string(APPEND line "   budget ${limit_flash} / ${limit_ram}")
+        if(NOT limit_flash STREQUAL "-" AND flash GREATER limit_flash)
+            list(APPEND violations "${module} flash ${flash} > ${limit_flash}")
+            string(APPEND line "  OVER")
+        endif()
+        if(NOT limit_ram STREQUAL "-" AND ram GREATER limit_ram)
+            list(APPEND violations "${module} RAM ${ram} > ${limit_ram}")
+            string(APPEND line "  OVER")
+        endif()
+    elseif(REQUIRE_BUDGET AND NOT UPDATE)
+        list(APPEND violations "${module} has no budget")
+        string(APPEND line "   NO BUDGET")
+    endif()
+
+    message("${line}")
+    set(violations ${violations} PARENT_SCOPE)
+endfunction()
+
+# Per-module footprint of the library objects, before linking
+message("Module                 Flash    RAM")
+string(REPLACE "," ";" objects "${OBJECTS}")
+set(library_flash 0)
+set(library_ram 0)
+set(buffers "")
+foreach(object IN LISTS objects)
+    get_filename_component(module ${object} NAME)
+    string(REGEX REPLACE "\\.(o|obj)$" "" module ${module})
+
+    footprint_measure(${object} flash ram)
+    footprint_check(${module} ${flash} ${ram})
+    math(EXPR library_flash "${library_flash} + ${flash}")
+    math(EXPR library_ram "${library_ram} + ${ram}")
+
+    # Static buffers and other RAM objects of the module
+    if(RODATA_IN_RAM)
+        footprint_symbols(${object} "bBdDrR" symbols)
+    else()
+        footprint_symbols(${object} "bBdD" symbols)
+    endif()
+    foreach(symbol IN LISTS symbols)
+        string(REGEX REPLACE "^([0-9]+) . (.+)$" "\\1;\\2" fields "${symbol}")
+        list(GET fields 0 size)
+        list(GET fields 1 name)
+        footprint_pad(${size} 6 size_column)
+        list(APPEND buffers "  ${size_column}  ${module}: ${name}")
+    endforeach()
+endforeach()
+footprint_check(library ${library_flash} ${library_ram})
+
+message("\nRAM objects of the modules, bytes")
+foreach(buffer IN LISTS buffers)
+    message("${buffer}")
+endforeach()
+
+# Linked application in both dispatch modes
+footprint_measure(${TABLE_APP} table_flash table_ram)
+footprint_measure(${STATIC_APP} static_flash static_ram)
+math(EXPR table_cost_flash "${table_flash} - ${static_flash}")
+math(EXPR table_cost_ram "${table_ram} - ${static_ram}")
+
+message("\nLinked footprint_app          Flash    RAM")
+footprint_check(application ${table_flash} ${table_ram})
+footprint_check(application_static ${static_flash} ${static_ram})
+message("  The eer_hal table pulls in ${table_cost_flash} bytes of flash and ${table_cost_ram} bytes of RAM")
+
+# Functions and objects only the table build links: the handlers the
+# application never calls
+footprint_symbols(${TABLE_APP} "tTdDbBrR" table_symbols)
+footprint_symbols(${STATIC_APP} "tTdDbBrR" static_symbols)
+set(static_names "")
+foreach(symbol IN LISTS static_symbols)
+    string(REGEX REPLACE "^[0-9]+ . " "" name "${symbol}")
+    list(APPEND static_names ${name})
+endforeach()
+message("\nPulled in through the eer_hal table, bytes")
+foreach(symbol IN LISTS table_symbols)
+    string(REGEX REPLACE "^([0-9]+) . (.+)$" "\\1;\\2" fields "${symbol}")
+    list(GET fields 0 size)
+    list(GET fields 1 name)
+    if(NOT name IN_LIST static_names)
+        footprint_pad(${size} 6 size_column)
+        message("  ${size_column}  ${name}")
+    endif()
+endforeach()
+
+if(UPDATE)
+    set(content "# Footprint budgets in bytes, written by the footprint_budget target with\n")
+    string(APPEND content "# ${HEADROOM}% headroom over the measured sizes\n")
+    string(APPEND content "# Format: <module> <flash> <ram>, - for no limit\n")
+    foreach(measurement IN LISTS measurements)
+        string(REPLACE " " ";" fields "${measurement}")
+        list(GET fields 0 module)
+        list(GET fields 1 flash)
+        list(GET fields 2 ram)
+        if(module MATCHES "^application" AND module IN_LIST budget_modules)
+            set(flash ${budget_flash_${module}})
+            set(ram ${budget_ram_${module}})
+        else()
+            math(EXPR flash "(${flash} * (100 + ${HEADROOM}) + 99) / 100")
+            math(EXPR ram "(${ram} * (100 + ${HEADROOM}) + 99) / 100")
+        endif()
+        string(APPEND content "${module} ${flash} ${ram}\n")
+    endforeach()
+    file(WRITE ${BUDGET} "${content}")
+    message(STATUS "footprint: budgets written to ${BUDGET}")
+    return()
+endif()
+
+if(violations)
+    string(REPLACE ";" "\n  " violations "${violations}")
+    message(FATAL_ERROR "footprint: over budget or without one, record missing "
+                        "budgets with the footprint_budget target\n  ${violations}")
+endif()
@@ -0,0 +1,43 @@
+/**
+ * @file footprint_app.c
+ * @brief Typical small application measured by the footprint target
+ *
+ * Blinks a pin and reports over the UART with the system tick. Linked
+ * twice with --gc-sections: footprint_table calls through the eer_hal
+ * table, which keeps every handler of every peripheral in the image;
+ * footprint_static is built with EER_HAL_STATIC and keeps only what the
+ * application calls. The difference is the cost of the table.
+ */
+#include "eer_hal.h"
+#include "gpio.h"
+
+static const eer_pin_t led_pin = eer_hal_pin(B, 5);
+
+int main(void) {
+    eer_gpio_config_t led_config = {
+        .mode = EER_GPIO_MODE_OUTPUT,
+        .speed = EER_GPIO_SPEED_LOW,
+        .trigger = EER_GPIO_TRIGGER_NONE
+    };
+
+    eer_uart_config_t uart_config = {
+        .baudrate = BAUD,
+        .data_bits = EER_UART_DATA_BITS_8,
+        .parity = EER_UART_PARITY_NONE,
+        .stop_bits = EER_UART_STOP_BITS_1,
+        .flow_control = false
+    };
+
+    eer_hal_call(system, init);
+    eer_hal_call(gpio, configure, (void*)&led_pin, &led_config);
+    eer_hal_call(uart, init, &uart_config);
+
+    for (;;) {
+        uint32_t ticks;
+
+        eer_hal_call(gpio, toggle, (void*)&led_pin);
+        eer_hal_call(system, get_tick, &ticks);
+        eer_hal_call(uart, transmit, (const uint8_t*)&ticks, sizeof(ticks), 0);
+        eer_hal_call(system, delay_ms, 500);
+    }
+}
@@ -0,0 +1,31 @@
+/**
+ * @file boot.h
+ * @brief Host mock of <avr/boot.h>
+ *
+ * Self-programming operates in place on the program memory objects, which
+ * the mock <avr/pgmspace.h> keeps writable, with the real page-buffer
+ * semantics: fill loads the temporary buffer, erase sets a page to 0xFF and
+ * write ANDs the buffer into the page. Addresses are host pointers.
+ */
+#pragma once
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+
+void eer_mock_boot_page_fill(uintptr_t address, uint16_t data);
+void eer_mock_boot_page_erase(uintptr_t address);
+void eer_mock_boot_page_write(uintptr_t address);
+
+#define BOOTLOADER_SECTION __attribute__((section(".text.bootloader")))
+
+#define boot_spm_busy()           ((SPMCSR & (1 << SPMEN)) != 0)
+#define boot_spm_busy_wait()      do { } while (boot_spm_busy())
+#define boot_rww_busy()           ((SPMCSR & (1 << RWWSB)) != 0)
+#define boot_rww_enable()         (SPMCSR &= (uint8_t)~(1 << RWWSB))
+#define boot_page_fill(addr, w)   eer_mock_boot_page_fill((addr), (w))
+#define boot_page_erase(addr)     eer_mock_boot_page_erase(addr)
+#define boot_page_write(addr)     eer_mock_boot_page_write(addr)
+#define boot_page_fill_safe(a, w)  do { boot_spm_busy_wait(); boot_page_fill(a, w); } while (0)
+#define boot_page_erase_safe(a)    do { boot_spm_busy_wait(); boot_page_erase(a); } while (0)
+#define boot_page_write_safe(a)    do { boot_spm_busy_wait(); boot_page_write(a); } while (0)
+#define boot_rww_enable_safe()     do { boot_spm_busy_wait(); boot_rww_enable(); } while (0)
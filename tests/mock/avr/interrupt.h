@@ -0,0 +1,28 @@
+/**
+ * @file interrupt.h
+ * @brief Host mock of <avr/interrupt.h>
+ *
+ * ISR() defines an ordinary function named after the vector so tests can
+ * inject an interrupt by calling it (see eer_mock_irq() in mock.h).
+ */
+#pragma once
+
+#include <avr/io.h>
+
+#define sei() (SREG |= (1 << SREG_I))
+#define cli() (SREG &= (uint8_t)~(1 << SREG_I))
+
+#define ISR_BLOCK
+#define ISR_NOBLOCK
+#define ISR_NAKED
+#define ISR_ALIASOF(v)
+
+#define ISR(vector, ...) \
+    void vector(void); \
+    void vector(void)
+
+#define EMPTY_INTERRUPT(vector) \
+    void vector(void); \
+    void vector(void) {}
+
+#define reti() return
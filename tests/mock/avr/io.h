@@ -0,0 +1,544 @@
+/**
+ * @file io.h
+ * @brief Host mock of <avr/io.h> for the ATmega328P
+ *
+ * Special function registers are plain bytes in eer_mock_sfr, addressed by
+ * their data-space address, so driver code compiles and runs unmodified on
+ * the host. See mock.h for access tracing and peripheral models.
+ *
+ * With __AVR_ATmega2560__, __AVR_ATmega1284P__ or __AVR_ATmega32U4__
+ * defined, the registers, vectors and memory layout those devices add are
+ * declared on top, enough to compile the drivers against their MCU
+ * descriptors. The peripheral models stay those of the ATmega328P.
+ */
+#pragma once
+
+#include <stdint.h>
+
+#if !defined(__AVR_ATmega2560__) && !defined(__AVR_ATmega1284P__) && !defined(__AVR_ATmega32U4__)
+#ifndef __AVR_ATmega328P__
+#define __AVR_ATmega328P__ 1
+#endif
+#endif
+
+extern volatile uint8_t eer_mock_sfr[4096];
+
+#define _SFR_MEM8(addr)  (*(volatile uint8_t*)(eer_mock_sfr + (addr)))
+#define _SFR_MEM16(addr) (*(volatile uint16_t*)(eer_mock_sfr + (addr)))
+#define _SFR_IO8(addr)   _SFR_MEM8((addr) + 0x20)
+#define _SFR_IO16(addr)  _SFR_MEM16((addr) + 0x20)
+#define _SFR_ADDR(sfr)   ((uint16_t)((volatile uint8_t*)&(sfr) - eer_mock_sfr))
+#define _SFR_MEM_ADDR(sfr) _SFR_ADDR(sfr)
+#define _SFR_IO_ADDR(sfr)  (_SFR_ADDR(sfr) - 0x20)
+#define _BV(bit) (1 << (bit))
+#define _VECTOR(n) __vector_ ## n
+
+/* Ports */
+#define PINB   _SFR_IO8(0x03)
+#define DDRB   _SFR_IO8(0x04)
+#define PORTB  _SFR_IO8(0x05)
+#define PINC   _SFR_IO8(0x06)
+#define DDRC   _SFR_IO8(0x07)
+#define PORTC  _SFR_IO8(0x08)
+#define PIND   _SFR_IO8(0x09)
+#define DDRD   _SFR_IO8(0x0A)
+#define PORTD  _SFR_IO8(0x0B)
+
+#define PORTB0 0
+#define PORTB1 1
+#define PORTB2 2
+#define PORTB3 3
+#define PORTB4 4
+#define PORTB5 5
+#define PORTB6 6
+#define PORTB7 7
+#define PORTC0 0
+#define PORTC1 1
+#define PORTC2 2
+#define PORTC3 3
+#define PORTC4 4
+#define PORTC5 5
+#define PORTC6 6
+#define PORTD0 0
+#define PORTD1 1
+#define PORTD2 2
+#define PORTD3 3
+#define PORTD4 4
+#define PORTD5 5
+#define PORTD6 6
+#define PORTD7 7
+#define PB0 0
+#define PB1 1
+#define PB2 2
+#define PB3 3
+#define PB4 4
+#define PB5 5
+#define PB6 6
+#define PB7 7
+#define PC0 0
+#define PC1 1
+#define PC2 2
+#define PC3 3
+#define PC4 4
+#define PC5 5
+#define PC6 6
+#define PD0 0
+#define PD1 1
+#define PD2 2
+#define PD3 3
+#define PD4 4
+#define PD5 5
+#define PD6 6
+#define PD7 7
+
+/* Interrupt flags and masks */
+#define TIFR0  _SFR_IO8(0x15)
+#define TOV0   0
+#define OCF0A  1
+#define OCF0B  2
+#define TIFR1  _SFR_IO8(0x16)
+#define TOV1   0
+#define OCF1A  1
+#define OCF1B  2
+#define ICF1   5
+#define TIFR2  _SFR_IO8(0x17)
+#define TOV2   0
+#define OCF2A  1
+#define OCF2B  2
+#define PCIFR  _SFR_IO8(0x1B)
+#define PCIF0  0
+#define PCIF1  1
+#define PCIF2  2
+#define EIFR   _SFR_IO8(0x1C)
+#define INTF0  0
+#define INTF1  1
+#define EIMSK  _SFR_IO8(0x1D)
+#define INT0   0
+#define INT1   1
+#define GPIOR0 _SFR_IO8(0x1E)
+
+/* EEPROM */
+#define EECR   _SFR_IO8(0x1F)
+#define EERE   0
+#define EEPE   1
+#define EEMPE  2
+#define EERIE  3
+#define EEPM0  4
+#define EEPM1  5
+#define EEDR   _SFR_IO8(0x20)
+#define EEAR   _SFR_IO16(0x21)
+#define EEARL  _SFR_IO8(0x21)
+#define EEARH  _SFR_IO8(0x22)
+
+#define GTCCR  _SFR_IO8(0x23)
+#define TCCR0A _SFR_IO8(0x24)
+#define WGM00  0
+#define WGM01  1
+#define COM0B0 4
+#define COM0B1 5
+#define COM0A0 6
+#define COM0A1 7
+#define TCCR0B _SFR_IO8(0x25)
+#define CS00   0
+#define CS01   1
+#define CS02   2
+#define WGM02  3
+#define TCNT0  _SFR_IO8(0x26)
+#define OCR0A  _SFR_IO8(0x27)
+#define OCR0B  _SFR_IO8(0x28)
+#define GPIOR1 _SFR_IO8(0x2A)
+#define GPIOR2 _SFR_IO8(0x2B)
+
+/* SPI */
+#define SPCR   _SFR_IO8(0x2C)
+#define SPR0   0
+#define SPR1   1
+#define CPHA   2
+#define CPOL   3
+#define MSTR   4
+#define DORD   5
+#define SPE    6
+#define SPIE   7
+#define SPSR   _SFR_IO8(0x2D)
+#define SPI2X  0
+#define WCOL   6
+#define SPIF   7
+#define SPDR   _SFR_IO8(0x2E)
+
+#define ACSR   _SFR_IO8(0x30)
+#define SMCR   _SFR_IO8(0x33)
+#define SE     0
+#define SM0    1
+#define SM1    2
+#define SM2    3
+#define MCUSR  _SFR_IO8(0x34)
+#define PORF   0
+#define EXTRF  1
+#define BORF   2
+#define WDRF   3
+#define MCUCR  _SFR_IO8(0x35)
+#define IVCE   0
+#define IVSEL  1
+#define PUD    4
+#define BODSE  5
+#define BODS   6
+#define SPMCSR _SFR_IO8(0x37)
+#define SPMEN  0
+#define SELFPRGEN 0
+#define PGERS  1
+#define PGWRT  2
+#define BLBSET 3
+#define RWWSRE 4
+#define SIGRD  5
+#define RWWSB  6
+#define SPMIE  7
+#define SPL    _SFR_IO8(0x3D)
+#define SPH    _SFR_IO8(0x3E)
+#define SREG   _SFR_IO8(0x3F)
+#define SREG_I 7
+
+/* Memory mapped registers */
+#define WDTCSR _SFR_MEM8(0x60)
+#define WDP0   0
+#define WDP1   1
+#define WDP2   2
+#define WDE    3
+#define WDCE   4
+#define WDP3   5
+#define WDIE   6
+#define WDIF   7
+#define CLKPR  _SFR_MEM8(0x61)
+#define PRR    _SFR_MEM8(0x64)
+#define PRADC    0
+#define PRUSART0 1
+#define PRSPI    2
+#define PRTIM1   3
+#define PRTIM0   5
+#define PRTIM2   6
+#define PRTWI    7
+#define OSCCAL _SFR_MEM8(0x66)
+#define PCICR  _SFR_MEM8(0x68)
+#define PCIE0  0
+#define PCIE1  1
+#define PCIE2  2
+#define EICRA  _SFR_MEM8(0x69)
+#define ISC00  0
+#define ISC01  1
+#define ISC10  2
+#define ISC11  3
+#define PCMSK0 _SFR_MEM8(0x6B)
+#define PCMSK1 _SFR_MEM8(0x6C)
+#define PCMSK2 _SFR_MEM8(0x6D)
+#define PCINT16 0
+#define TIMSK0 _SFR_MEM8(0x6E)
+#define TOIE0  0
+#define OCIE0A 1
+#define OCIE0B 2
+#define TIMSK1 _SFR_MEM8(0x6F)
+#define TOIE1  0
+#define OCIE1A 1
+#define OCIE1B 2
+#define ICIE1  5
+#define TIMSK2 _SFR_MEM8(0x70)
+#define TOIE2  0
+#define OCIE2A 1
+#define OCIE2B 2
+
+/* ADC */
+#define ADC    _SFR_MEM16(0x78)
+#define ADCW   _SFR_MEM16(0x78)
+#define ADCL   _SFR_MEM8(0x78)
+#define ADCH   _SFR_MEM8(0x79)
+#define ADCSRA _SFR_MEM8(0x7A)
+#define ADPS0  0
+#define ADPS1  1
+#define ADPS2  2
+#define ADIE   3
+#define ADIF   4
+#define ADATE  5
+#define ADSC   6
+#define ADEN   7
+#define ADCSRB _SFR_MEM8(0x7B)
+#define ADTS0  0
+#define ADTS1  1
+#define ADTS2  2
+#define ACME   6
+#define ADMUX  _SFR_MEM8(0x7C)
+#define MUX0   0
+#define MUX1   1
+#define MUX2   2
+#define MUX3   3
+#define ADLAR  5
+#define REFS0  6
+#define REFS1  7
+#define DIDR0  _SFR_MEM8(0x7E)
+#define DIDR1  _SFR_MEM8(0x7F)
+
+/* Timer/Counter1 */
+#define TCCR1A _SFR_MEM8(0x80)
+#define WGM10  0
+#define WGM11  1
+#define COM1B0 4
+#define COM1B1 5
+#define COM1A0 6
+#define COM1A1 7
+#define TCCR1B _SFR_MEM8(0x81)
+#define CS10   0
+#define CS11   1
+#define CS12   2
+#define WGM12  3
+#define WGM13  4
+#define ICES1  6
+#define ICNC1  7
+#define TCCR1C _SFR_MEM8(0x82)
+#define TCNT1  _SFR_MEM16(0x84)
+#define TCNT1L _SFR_MEM8(0x84)
+#define TCNT1H _SFR_MEM8(0x85)
+#define ICR1   _SFR_MEM16(0x86)
+#define OCR1A  _SFR_MEM16(0x88)
+#define OCR1B  _SFR_MEM16(0x8A)
+
+/* Timer/Counter2 */
+#define TCCR2A _SFR_MEM8(0xB0)
+#define WGM20  0
+#define WGM21  1
+#define TCCR2B _SFR_MEM8(0xB1)
+#define CS20   0
+#define CS21   1
+#define CS22   2
+#define WGM22  3
+#define TCNT2  _SFR_MEM8(0xB2)
+#define OCR2A  _SFR_MEM8(0xB3)
+#define OCR2B  _SFR_MEM8(0xB4)
+#define ASSR   _SFR_MEM8(0xB6)
+
+/* TWI */
+#define TWBR   _SFR_MEM8(0xB8)
+#define TWSR   _SFR_MEM8(0xB9)
+#define TWPS0  0
+#define TWPS1  1
+#define TWAR   _SFR_MEM8(0xBA)
+#define TWDR   _SFR_MEM8(0xBB)
+#define TWCR   _SFR_MEM8(0xBC)
+#define TWIE   0
+#define TWEN   2
+#define TWWC   3
+#define TWSTO  4
+#define TWSTA  5
+#define TWEA   6
+#define TWINT  7
+#define TWAMR  _SFR_MEM8(0xBD)
+
+/* USART0 */
+#define UCSR0A _SFR_MEM8(0xC0)
+#define UCSR0B _SFR_MEM8(0xC1)
+#define UCSR0C _SFR_MEM8(0xC2)
+#define UBRR0  _SFR_MEM16(0xC4)
+#define UBRR0L _SFR_MEM8(0xC4)
+#define UBRR0H _SFR_MEM8(0xC5)
+#define UDR0   _SFR_MEM8(0xC6)
+
+/*
+ * The ATmega32U4 has no USART0: its descriptor maps these names to the
+ * USART1 ones defined further down, as with the real headers.
+ */
+#ifndef __AVR_ATmega32U4__
+#define MPCM0  0
+#define U2X0   1
+#define UPE0   2
+#define DOR0   3
+#define FE0    4
+#define UDRE0  5
+#define TXC0   6
+#define RXC0   7
+#define TXB80  0
+#define RXB80  1
+#define UCSZ02 2
+#define TXEN0  3
+#define RXEN0  4
+#define UDRIE0 5
+#define TXCIE0 6
+#define RXCIE0 7
+#define UCPOL0  0
+#define UCSZ00  1
+#define UCSZ01  2
+#define USBS0   3
+#define UPM00   4
+#define UPM01   5
+#define UMSEL00 6
+#define UMSEL01 7
+#endif
+
+/* Interrupt vectors */
+#define INT0_vect          _VECTOR(1)
+#define INT1_vect          _VECTOR(2)
+#define PCINT0_vect        _VECTOR(3)
+#define PCINT1_vect        _VECTOR(4)
+#define PCINT2_vect        _VECTOR(5)
+#define WDT_vect           _VECTOR(6)
+#define TIMER2_COMPA_vect  _VECTOR(7)
+#define TIMER2_COMPB_vect  _VECTOR(8)
+#define TIMER2_OVF_vect    _VECTOR(9)
+#define TIMER1_CAPT_vect   _VECTOR(10)
+#define TIMER1_COMPA_vect  _VECTOR(11)
+#define TIMER1_COMPB_vect  _VECTOR(12)
+#define TIMER1_OVF_vect    _VECTOR(13)
+#define TIMER0_COMPA_vect  _VECTOR(14)
+#define TIMER0_COMPB_vect  _VECTOR(15)
+#define TIMER0_OVF_vect    _VECTOR(16)
+#define SPI_STC_vect       _VECTOR(17)
+#define USART_RX_vect      _VECTOR(18)
+#define USART_UDRE_vect    _VECTOR(19)
+#define USART_TX_vect      _VECTOR(20)
+#define ADC_vect           _VECTOR(21)
+#define EE_READY_vect      _VECTOR(22)
+#define ANALOG_COMP_vect   _VECTOR(23)
+#define TWI_vect           _VECTOR(24)
+#define SPM_READY_vect     _VECTOR(25)
+
+/* Memory layout */
+#define SPM_PAGESIZE 128
+#define RAMSTART     0x100
+#define RAMEND       0x8FF
+#define E2END        0x3FF
+#define E2PAGESIZE   4
+#define FLASHEND     0x7FFF
+
+#ifndef __AVR_ATmega328P__
+
+/*
+ * Other devices. Vector numbers follow those above: only distinct names
+ * matter to a compile check.
+ */
+
+#define MUX5   3
+
+#if defined(__AVR_ATmega2560__) || defined(__AVR_ATmega1284P__)
+#define PINA   _SFR_IO8(0x00)
+#define DDRA   _SFR_IO8(0x01)
+#define PORTA  _SFR_IO8(0x02)
+#endif
+
+#if defined(__AVR_ATmega2560__) || defined(__AVR_ATmega32U4__)
+#define PINE   _SFR_IO8(0x0C)
+#define DDRE   _SFR_IO8(0x0D)
+#define PORTE  _SFR_IO8(0x0E)
+#define PINF   _SFR_IO8(0x0F)
+#define DDRF   _SFR_IO8(0x10)
+#define PORTF  _SFR_IO8(0x11)
+#endif
+
+#ifdef __AVR_ATmega2560__
+#define PING   _SFR_IO8(0x12)
+#define DDRG   _SFR_IO8(0x13)
+#define PORTG  _SFR_IO8(0x14)
+#define PINH   _SFR_MEM8(0x100)
+#define DDRH   _SFR_MEM8(0x101)
+#define PORTH  _SFR_MEM8(0x102)
+#define PINJ   _SFR_MEM8(0x103)
+#define DDRJ   _SFR_MEM8(0x104)
+#define PORTJ  _SFR_MEM8(0x105)
+#define PINK   _SFR_MEM8(0x106)
+#define DDRK   _SFR_MEM8(0x107)
+#define PORTK  _SFR_MEM8(0x108)
+#define PINL   _SFR_MEM8(0x109)
+#define DDRL   _SFR_MEM8(0x10A)
+#define PORTL  _SFR_MEM8(0x10B)
+#endif
+
+#ifdef __AVR_ATmega1284P__
+#define PCMSK3 _SFR_MEM8(0x73)
+#define PCIE3  3
+#define PCIF3  3
+#define PCINT3_vect        _VECTOR(26)
+#endif
+
+/* USART1 to USART3 */
+#define UCSR1A _SFR_MEM8(0xC8)
+#define UCSR1B _SFR_MEM8(0xC9)
+#define UCSR1C _SFR_MEM8(0xCA)
+#define UBRR1L _SFR_MEM8(0xCC)
+#define UBRR1H _SFR_MEM8(0xCD)
+#define UDR1   _SFR_MEM8(0xCE)
+#define USART1_RX_vect     _VECTOR(27)
+#define USART1_UDRE_vect   _VECTOR(28)
+#define USART1_TX_vect     _VECTOR(29)
+
+#ifdef __AVR_ATmega32U4__
+#define MPCM1  0
+#define U2X1   1
+#define UPE1   2
+#define DOR1   3
+#define FE1    4
+#define UDRE1  5
+#define TXC1   6
+#define RXC1   7
+#define TXB81  0
+#define RXB81  1
+#define UCSZ12 2
+#define TXEN1  3
+#define RXEN1  4
+#define UDRIE1 5
+#define TXCIE1 6
+#define RXCIE1 7
+#define UCPOL1  0
+#define UCSZ10  1
+#define UCSZ11  2
+#define USBS1   3
+#define UPM10   4
+#define UPM11   5
+#define UMSEL10 6
+#define UMSEL11 7
+#endif
+
+#ifndef __AVR_ATmega32U4__
+#define USART0_RX_vect     _VECTOR(30)
+#define USART0_UDRE_vect   _VECTOR(31)
+#define USART0_TX_vect     _VECTOR(32)
+#endif
+
+#ifdef __AVR_ATmega2560__
+#define UCSR2A _SFR_MEM8(0xD0)
+#define UCSR2B _SFR_MEM8(0xD1)
+#define UCSR2C _SFR_MEM8(0xD2)
+#define UBRR2L _SFR_MEM8(0xD4)
+#define UBRR2H _SFR_MEM8(0xD5)
+#define UDR2   _SFR_MEM8(0xD6)
+#define UCSR3A _SFR_MEM8(0x130)
+#define UCSR3B _SFR_MEM8(0x131)
+#define UCSR3C _SFR_MEM8(0x132)
+#define UBRR3L _SFR_MEM8(0x134)
+#define UBRR3H _SFR_MEM8(0x135)
+#define UDR3   _SFR_MEM8(0x136)
+#define USART2_RX_vect     _VECTOR(33)
+#define USART2_UDRE_vect   _VECTOR(34)
+#define USART2_TX_vect     _VECTOR(35)
+#define USART3_RX_vect     _VECTOR(36)
+#define USART3_UDRE_vect   _VECTOR(37)
+#define USART3_TX_vect     _VECTOR(38)
+#endif
+
+/* Memory layout */
+#undef SPM_PAGESIZE
+#undef RAMEND
+#undef E2END
+#undef FLASHEND
+
+#if defined(__AVR_ATmega2560__)
+#define SPM_PAGESIZE 256
+#define RAMEND       0x21FF
+#define E2END        0xFFF
+#define FLASHEND     0x3FFFF
+#elif defined(__AVR_ATmega1284P__)
+#define SPM_PAGESIZE 256
+#define RAMEND       0x40FF
+#define E2END        0xFFF
+#define FLASHEND     0x1FFFF
+#else
+#define SPM_PAGESIZE 128
+#define RAMEND       0xAFF
+#define E2END        0x3FF
+#define FLASHEND     0x7FFF
+#endif
+
+#endif
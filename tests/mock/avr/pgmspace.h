@@ -0,0 +1,30 @@
+/**
+ * @file pgmspace.h
+ * @brief Host mock of <avr/pgmspace.h>
+ *
+ * Program memory is ordinary memory on the host. PROGMEM objects go to a
+ * writable section, so that <avr/boot.h> programs them in place, and the
+ * near readers take plain pointers; eer_mock_flash backs the far readers.
+ * eer_mock_pgm_reads counts the bytes read with pgm_read_byte(), so tests
+ * see that a driver reads from flash.
+ */
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+extern uint8_t eer_mock_flash[];
+extern volatile uint32_t eer_mock_pgm_reads;
+
+#define PROGMEM __attribute__((section(".data.progmem")))
+#define PGM_P const char*
+#define PSTR(s) (s)
+
+#define pgm_read_byte(addr)       (eer_mock_pgm_reads++, *(const uint8_t*)(addr))
+#define pgm_read_word(addr)       (*(const uint16_t*)(addr))
+#define pgm_read_dword(addr)      (*(const uint32_t*)(addr))
+#define pgm_read_byte_near(addr)  pgm_read_byte(addr)
+#define pgm_read_byte_far(addr)   (eer_mock_flash[(uint32_t)(addr)])
+#define pgm_get_far_address(var)  ((uint32_t)(uintptr_t)&(var))
+#define memcpy_P(dst, src, n)     memcpy((dst), (src), (n))
+#define strlen_P(s)               strlen(s)
@@ -0,0 +1,26 @@
+/**
+ * @file sleep.h
+ * @brief Host mock of <avr/sleep.h>
+ *
+ * sleep_cpu() calls the hook installed with eer_mock_on_sleep() so a test
+ * can play the wake-up interrupt.
+ */
+#pragma once
+
+#include <avr/io.h>
+
+#define SLEEP_MODE_IDLE         (0x00 << 1)
+#define SLEEP_MODE_ADC          (0x01 << 1)
+#define SLEEP_MODE_PWR_DOWN     (0x02 << 1)
+#define SLEEP_MODE_PWR_SAVE     (0x03 << 1)
+#define SLEEP_MODE_STANDBY      (0x06 << 1)
+#define SLEEP_MODE_EXT_STANDBY  (0x07 << 1)
+
+void eer_mock_sleep(void);
+
+#define set_sleep_mode(mode) (SMCR = (uint8_t)((SMCR & ~((1 << SM0) | (1 << SM1) | (1 << SM2))) | (mode)))
+#define sleep_enable()       (SMCR |= (1 << SE))
+#define sleep_disable()      (SMCR &= (uint8_t)~(1 << SE))
+#define sleep_cpu()          eer_mock_sleep()
+#define sleep_mode()         do { sleep_enable(); sleep_cpu(); sleep_disable(); } while (0)
+#define sleep_bod_disable()  ((void)0)
@@ -0,0 +1,654 @@
+/**
+ * @file mock.c
+ * @brief Register trapping and peripheral models of the AVR test harness
+ *
+ * eer_mock_sfr is remapped onto a memory file that is mapped a second time
+ * as eer_mock_shadow. The eer_mock_sfr view is kept PROT_NONE, so every
+ * register access by driver code raises SIGSEGV. The handler records the
+ * access, runs the read hook, opens the page and sets the trap flag; after
+ * the one instruction has executed SIGTRAP records the written value, runs
+ * the write hook and closes the page again.
+ */
+#define _GNU_SOURCE
+#include "mock.h"
+#include <util/twi.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ucontext.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#if !defined(__linux__) || !defined(__x86_64__)
+#error "The AVR register mock traps accesses on x86-64 Linux only"
+#endif
+
+#define MOCK_PAGE_SIZE 4096
+
+// x86 trap flag in EFLAGS, single-steps one instruction
+#define MOCK_TRAP_FLAG 0x100
+
+// Write bit of the x86 page fault error code
+#define MOCK_FAULT_WRITE 0x2
+
+volatile uint8_t eer_mock_sfr[MOCK_PAGE_SIZE] __attribute__((aligned(MOCK_PAGE_SIZE)));
+volatile uint8_t* eer_mock_shadow = eer_mock_sfr;
+uint8_t eer_mock_eeprom[E2END + 1];
+uint8_t eer_mock_flash[FLASHEND + 1];
+volatile uint32_t eer_mock_delay_us = 0;
+volatile uint32_t eer_mock_pgm_reads = 0;
+uint8_t* eer_mock_spm_page = NULL;
+uint8_t eer_mock_spm_sreg = 0;
+uint32_t eer_mock_spm_writes = 0;
+
+// Page view setup has been done
+static bool mock_mapped = false;
+
+// Access trapped and waiting for its instruction to complete
+static struct {
+    bool active;
+    eer_mock_access_t access;
+} mock_pending;
+
+static eer_mock_access_t mock_trace[EER_MOCK_TRACE_SIZE];
+static size_t mock_trace_size = 0;
+
+static struct {
+    eer_mock_hook_t hook;
+    void* context;
+} mock_hooks[MOCK_PAGE_SIZE];
+
+static struct {
+    void (*hook)(void* context);
+    void* context;
+} mock_sleep;
+
+/**
+ * @brief Byte queue of a peripheral model
+ */
+typedef struct {
+    uint8_t data[EER_MOCK_QUEUE_SIZE];
+    size_t  head;
+    size_t  tail;
+} mock_queue_t;
+
+static mock_queue_t mock_uart_rx;
+static mock_queue_t mock_uart_tx;
+static mock_queue_t mock_spi_miso;
+static mock_queue_t mock_spi_mosi;
+static uint16_t mock_adc[16];
+static uint16_t mock_page_buffer[SPM_PAGESIZE / 2];
+
+// TWI bus state
+static struct {
+    enum { TWI_IDLE, TWI_ADDRESS, TWI_TRANSMIT, TWI_RECEIVE } phase;
+    eer_mock_twi_slave_t* slaves;
+    eer_mock_twi_slave_t* selected;
+    bool     pointer_set;
+    uint16_t starts;
+    uint16_t stops;
+} mock_twi;
+
+static void mock_queue_push(mock_queue_t* queue, uint8_t data) {
+    size_t next = (queue->head + 1) % EER_MOCK_QUEUE_SIZE;
+    
+    // Full queues drop the byte like an overrun
+    if (next != queue->tail) {
+        queue->data[queue->head] = data;
+        queue->head = next;
+    }
+}
+
+static bool mock_queue_pop(mock_queue_t* queue, uint8_t* data) {
+    if (queue->tail == queue->head) {
+        return false;
+    }
+    
+    *data = queue->data[queue->tail];
+    queue->tail = (queue->tail + 1) % EER_MOCK_QUEUE_SIZE;
+    
+    return true;
+}
+
+static size_t mock_queue_take(mock_queue_t* queue, uint8_t* data, size_t size) {
+    size_t count = 0;
+    
+    while (count < size && mock_queue_pop(queue, &data[count])) {
+        count++;
+    }
+    
+    return count;
+}
+
+static uint16_t mock_load(uint16_t address, uint8_t size) {
+    if (size == 2) {
+        return (uint16_t)(eer_mock_shadow[address] | (eer_mock_shadow[address + 1] << 8));
+    }
+    
+    return eer_mock_shadow[address];
+}
+
+/**
+ * @brief Operand size of the instruction making an access
+ *
+ * Drivers access registers with 8-bit and 16-bit loads, stores and
+ * read-modify-write operations; the operand-size prefix or a 16-bit
+ * zero/sign extension marks the 16-bit ones.
+ */
+static uint8_t mock_access_size(const uint8_t* code) {
+    bool operand16 = false;
+    
+    for (;; code++) {
+        if (*code == 0x66) {
+            operand16 = true;
+        } else if (*code != 0x67 && *code != 0xF0 && *code != 0xF2 && *code != 0xF3
+                   && *code != 0x2E && *code != 0x3E && *code != 0x26 && *code != 0x36
+                   && *code != 0x64 && *code != 0x65) {
+            break;
+        }
+    }
+    
+    // REX prefix
+    if ((*code & 0xF0) == 0x40) {
+        code++;
+    }
+    
+    if (code[0] == 0x0F && (code[1] == 0xB7 || code[1] == 0xBF)) {
+        return 2;
+    }
+    
+    return operand16 ? 2 : 1;
+}
+
+static void mock_run_hook(const eer_mock_access_t* access) {
+    if (mock_hooks[access->address].hook != NULL) {
+        mock_hooks[access->address].hook(access, mock_hooks[access->address].context);
+    }
+}
+
+static void mock_protect(int protection) {
+    if (mprotect((void*)eer_mock_sfr, MOCK_PAGE_SIZE, protection) != 0) {
+        perror("mock: mprotect");
+        abort();
+    }
+}
+
+static void mock_segv_handler(int signal_number, siginfo_t* info, void* context) {
+    ucontext_t* ucontext = (ucontext_t*)context;
+    uintptr_t offset = (uintptr_t)info->si_addr - (uintptr_t)eer_mock_sfr;
+    
+    // A genuine fault: let it crash with the default action
+    if (offset >= MOCK_PAGE_SIZE || mock_pending.active) {
+        signal(signal_number, SIG_DFL);
+        return;
+    }
+    
+    eer_mock_access_t* access = &mock_pending.access;
+    access->address = (uint16_t)offset;
+    access->size = mock_access_size((const uint8_t*)ucontext->uc_mcontext.gregs[REG_RIP]);
+    access->write = (ucontext->uc_mcontext.gregs[REG_ERR] & MOCK_FAULT_WRITE) != 0;
+    access->previous = mock_load(access->address, access->size);
+    
+    // Models provide the value a read returns
+    if (!access->write) {
+        access->value = access->previous;
+        mock_run_hook(access);
+        access->value = mock_load(access->address, access->size);
+    }
+    
+    mock_pending.active = true;
+    mock_protect(PROT_READ | PROT_WRITE);
+    ucontext->uc_mcontext.gregs[REG_EFL] |= MOCK_TRAP_FLAG;
+}
+
+static void mock_trap_handler(int signal_number, siginfo_t* info, void* context) {
+    ucontext_t* ucontext = (ucontext_t*)context;
+    (void)info;
+    
+    // Breakpoints of a debugger or the program itself
+    if (!mock_pending.active) {
+        signal(signal_number, SIG_DFL);
+        raise(signal_number);
+        return;
+    }
+    
+    ucontext->uc_mcontext.gregs[REG_EFL] &= ~MOCK_TRAP_FLAG;
+    mock_protect(PROT_NONE);
+    mock_pending.active = false;
+    
+    eer_mock_access_t* access = &mock_pending.access;
+    if (access->write) {
+        access->value = mock_load(access->address, access->size);
+    }
+    
+    if (mock_trace_size < EER_MOCK_TRACE_SIZE) {
+        mock_trace[mock_trace_size++] = *access;
+    }
+    
+    if (access->write) {
+        mock_run_hook(access);
+    }
+}
+
+/**
+ * @brief Back eer_mock_sfr with a memory file mapped twice
+ */
+static void mock_map(void) {
+    int fd = memfd_create("eer_mock_sfr", 0);
+    if (fd < 0 || ftruncate(fd, MOCK_PAGE_SIZE) != 0) {
+        perror("mock: memfd");
+        abort();
+    }
+    
+    void* shadow = mmap(NULL, MOCK_PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    void* view = mmap((void*)eer_mock_sfr, MOCK_PAGE_SIZE, PROT_NONE, MAP_SHARED | MAP_FIXED, fd, 0);
+    if (shadow == MAP_FAILED || view != (void*)eer_mock_sfr) {
+        perror("mock: mmap");
+        abort();
+    }
+    
+    close(fd);
+    eer_mock_shadow = shadow;
+    
+    struct sigaction action = {0};
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_SIGINFO;
+    action.sa_sigaction = mock_segv_handler;
+    sigaction(SIGSEGV, &action, NULL);
+    action.sa_sigaction = mock_trap_handler;
+    sigaction(SIGTRAP, &action, NULL);
+    
+    mock_mapped = true;
+}
+
+/*
+ * Default models of the ATmega328P peripherals
+ */
+
+static void mock_gpio_pin(const eer_mock_access_t* access, void* context) {
+    volatile uint8_t* port = &eer_mock_shadow[access->address + 2];
+    (void)context;
+    
+    if (!access->write) {
+        return;
+    }
+    
+    // Writing 1 to PINx toggles PORTx, the input level stays
+    *port ^= (uint8_t)access->value;
+    eer_mock_shadow[access->address] = (uint8_t)access->previous;
+}
+
+static void mock_uart_status(const eer_mock_access_t* access, void* context) {
+    const uint8_t writable = (1 << U2X0) | (1 << MPCM0);
+    uint8_t status = (uint8_t)((access->previous & ~writable) | (access->value & writable));
+    (void)context;
+    
+    if (!access->write) {
+        return;
+    }
+    
+    // TXC0 is cleared by writing one
+    if (access->value & (1 << TXC0)) {
+        status &= (uint8_t)~(1 << TXC0);
+    }
+    
+    EER_MOCK_REG(UCSR0A) = status;
+}
+
+static void mock_uart_data(const eer_mock_access_t* access, void* context) {
+    (void)context;
+    
+    if (access->write) {
+        // The frame leaves at once
+        mock_queue_push(&mock_uart_tx, (uint8_t)access->value);
+        EER_MOCK_REG(UCSR0A) |= (1 << TXC0) | (1 << UDRE0);
+        return;
+    }
+    
+    uint8_t data;
+    if (mock_queue_pop(&mock_uart_rx, &data)) {
+        EER_MOCK_REG(UDR0) = data;
+    }
+    
+    if (mock_uart_rx.tail == mock_uart_rx.head) {
+        EER_MOCK_REG(UCSR0A) &= (uint8_t)~(1 << RXC0);
+    }
+}
+
+static void mock_spi_data(const eer_mock_access_t* access, void* context) {
+    (void)context;
+    
+    if (access->write) {
+        uint8_t data = 0xFF;
+        
+        // Full-duplex exchange completes at once
+        mock_queue_push(&mock_spi_mosi, (uint8_t)access->value);
+        mock_queue_pop(&mock_spi_miso, &data);
+        EER_MOCK_REG(SPDR) = data;
+        EER_MOCK_REG(SPSR) |= (1 << SPIF);
+    } else {
+        EER_MOCK_REG(SPSR) &= (uint8_t)~(1 << SPIF);
+    }
+}
+
+static void mock_adc_control(const eer_mock_access_t* access, void* context) {
+    uint8_t control = (uint8_t)access->value;
+    (void)context;
+    
+    if (!access->write) {
+        return;
+    }
+    
+    // ADIF is cleared by writing one
+    if (control & (1 << ADIF)) {
+        control &= (uint8_t)~(1 << ADIF);
+    }
+    
+    // A started conversion completes at once
+    if ((control & (1 << ADSC)) && (control & (1 << ADEN))) {
+        uint8_t admux = EER_MOCK_REG(ADMUX);
+        uint16_t result = mock_adc[admux & 0x0F] & 0x3FF;
+        
+        EER_MOCK_REG16(ADC) = (admux & (1 << ADLAR)) ? (uint16_t)(result << 6) : result;
+        control = (uint8_t)((control & ~(1 << ADSC)) | (1 << ADIF));
+    }
+    
+    EER_MOCK_REG(ADCSRA) = control;
+}
+
+static void mock_eeprom_control(const eer_mock_access_t* access, void* context) {
+    uint8_t control = (uint8_t)access->value;
+    uint16_t address = EER_MOCK_REG16(EEAR) & E2END;
+    (void)context;
+    
+    if (!access->write) {
+        return;
+    }
+    
+    if (control & (1 << EERE)) {
+        EER_MOCK_REG(EEDR) = eer_mock_eeprom[address];
+        control &= (uint8_t)~(1 << EERE);
+    }
+    
+    // EEPE starts programming only with EEMPE set by the previous write
+    if ((control & (1 << EEPE)) && (access->previous & (1 << EEMPE))) {
+        switch ((control >> EEPM0) & 0x03) {
+            case 0:  // Erase and write
+                eer_mock_eeprom[address] = EER_MOCK_REG(EEDR);
+                break;
+            case 1:  // Erase only
+                eer_mock_eeprom[address] = 0xFF;
+                break;
+            case 2:  // Write only
+                eer_mock_eeprom[address] &= EER_MOCK_REG(EEDR);
+                break;
+            default:
+                break;
+        }
+    }
+    
+    // Programming completes at once; EEMPE holds for the next write only,
+    // standing in for its four cycles
+    control &= (uint8_t)~(1 << EEPE);
+    if (access->previous & (1 << EEMPE)) {
+        control &= (uint8_t)~(1 << EEMPE);
+    }
+    EER_MOCK_REG(EECR) = control;
+}
+
+static eer_mock_twi_slave_t* mock_twi_slave(uint8_t address) {
+    for (eer_mock_twi_slave_t* slave = mock_twi.slaves; slave != NULL; slave = slave->next) {
+        if (slave->address == address) {
+            return slave;
+        }
+    }
+    
+    return NULL;
+}
+
+static void mock_twi_control(const eer_mock_access_t* access, void* context) {
+    uint8_t control = (uint8_t)access->value;
+    eer_mock_twi_slave_t* slave = mock_twi.selected;
+    uint8_t status;
+    (void)context;
+    
+    if (!access->write) {
+        return;
+    }
+    
+    // Without TWINT written the bus does not move
+    if (!(control & (1 << TWINT)) || !(control & (1 << TWEN))) {
+        return;
+    }
+    
+    if (control & (1 << TWSTO)) {
+        // STOP does not set TWINT, TWSTO clears when it has been sent
+        mock_twi.stops++;
+        mock_twi.phase = TWI_IDLE;
+        mock_twi.selected = NULL;
+        EER_MOCK_REG(TWCR) = (uint8_t)(control & ~((1 << TWSTO) | (1 << TWINT)));
+        return;
+    }
+    
+    if (control & (1 << TWSTA)) {
+        status = mock_twi.phase == TWI_IDLE ? TW_START : TW_REP_START;
+        mock_twi.starts++;
+        mock_twi.phase = TWI_ADDRESS;
+    } else if (mock_twi.phase == TWI_ADDRESS) {
+        uint8_t sla = EER_MOCK_REG(TWDR);
+        bool read = (sla & TW_READ) != 0;
+        
+        slave = mock_twi_slave(sla >> 1);
+        mock_twi.selected = slave;
+        mock_twi.pointer_set = false;
+        mock_twi.phase = read ? TWI_RECEIVE : TWI_TRANSMIT;
+        
+        if (read) {
+            status = slave != NULL ? TW_MR_SLA_ACK : TW_MR_SLA_NACK;
+        } else {
+            status = slave != NULL ? TW_MT_SLA_ACK : TW_MT_SLA_NACK;
+        }
+    } else if (mock_twi.phase == TWI_TRANSMIT) {
+        uint8_t data = EER_MOCK_REG(TWDR);
+        
+        if (slave == NULL || slave->nack_data) {
+            status = TW_MT_DATA_NACK;
+        } else {
+            if (!mock_twi.pointer_set) {
+                slave->pointer = data % slave->size;
+                mock_twi.pointer_set = true;
+            } else {
+                slave->memory[slave->pointer] = data;
+                slave->pointer = (slave->pointer + 1) % slave->size;
+            }
+            status = TW_MT_DATA_ACK;
+        }
+    } else if (mock_twi.phase == TWI_RECEIVE) {
+        uint8_t data = 0xFF;
+        
+        if (slave != NULL) {
+            data = slave->memory[slave->pointer];
+            slave->pointer = (slave->pointer + 1) % slave->size;
+        }
+        
+        EER_MOCK_REG(TWDR) = data;
+        status = (control & (1 << TWEA)) ? TW_MR_DATA_ACK : TW_MR_DATA_NACK;
+    } else {
+        status = TW_BUS_ERROR;
+    }
+    
+    EER_MOCK_REG(TWSR) = (uint8_t)((EER_MOCK_REG(TWSR) & ~TW_STATUS_MASK) | status);
+    EER_MOCK_REG(TWCR) = control | (1 << TWINT);
+}
+
+void eer_mock_reset(void) {
+    if (!mock_mapped) {
+        mock_map();
+    }
+    
+    memset((void*)eer_mock_shadow, 0, MOCK_PAGE_SIZE);
+    memset(mock_hooks, 0, sizeof(mock_hooks));
+    memset(&mock_uart_rx, 0, sizeof(mock_uart_rx));
+    memset(&mock_uart_tx, 0, sizeof(mock_uart_tx));
+    memset(&mock_spi_miso, 0, sizeof(mock_spi_miso));
+    memset(&mock_spi_mosi, 0, sizeof(mock_spi_mosi));
+    memset(mock_adc, 0, sizeof(mock_adc));
+    memset(&mock_twi, 0, sizeof(mock_twi));
+    memset(mock_page_buffer, 0xFF, sizeof(mock_page_buffer));
+    memset(eer_mock_eeprom, 0xFF, sizeof(eer_mock_eeprom));
+    memset(eer_mock_flash, 0xFF, sizeof(eer_mock_flash));
+    mock_sleep.hook = NULL;
+    mock_sleep.context = NULL;
+    mock_trace_size = 0;
+    eer_mock_delay_us = 0;
+    eer_mock_pgm_reads = 0;
+    eer_mock_spm_page = NULL;
+    eer_mock_spm_sreg = 0;
+    eer_mock_spm_writes = 0;
+    
+    // Non-zero reset values
+    EER_MOCK_REG(UCSR0A) = (1 << UDRE0);
+    EER_MOCK_REG(UCSR0C) = (1 << UCSZ01) | (1 << UCSZ00);
+    EER_MOCK_REG(TWSR) = TW_NO_INFO;
+    EER_MOCK_REG(TWDR) = 0xFF;
+    
+    eer_mock_on_access(EER_MOCK_ADDR(PINB), mock_gpio_pin, NULL);
+    eer_mock_on_access(EER_MOCK_ADDR(PINC), mock_gpio_pin, NULL);
+    eer_mock_on_access(EER_MOCK_ADDR(PIND), mock_gpio_pin, NULL);
+    eer_mock_on_access(EER_MOCK_ADDR(UCSR0A), mock_uart_status, NULL);
+    eer_mock_on_access(EER_MOCK_ADDR(UDR0), mock_uart_data, NULL);
+    eer_mock_on_access(EER_MOCK_ADDR(SPDR), mock_spi_data, NULL);
+    eer_mock_on_access(EER_MOCK_ADDR(ADCSRA), mock_adc_control, NULL);
+    eer_mock_on_access(EER_MOCK_ADDR(EECR), mock_eeprom_control, NULL);
+    eer_mock_on_access(EER_MOCK_ADDR(TWCR), mock_twi_control, NULL);
+}
+
+void eer_mock_on_access(uint16_t address, eer_mock_hook_t hook, void* context) {
+    if (address < MOCK_PAGE_SIZE) {
+        mock_hooks[address].hook = hook;
+        mock_hooks[address].context = context;
+    }
+}
+
+void eer_mock_on_sleep(void (*hook)(void* context), void* context) {
+    mock_sleep.hook = hook;
+    mock_sleep.context = context;
+}
+
+size_t eer_mock_trace_count(void) {
+    return mock_trace_size;
+}
+
+const eer_mock_access_t* eer_mock_trace_get(size_t index) {
+    return index < mock_trace_size ? &mock_trace[index] : NULL;
+}
+
+void eer_mock_trace_clear(void) {
+    mock_trace_size = 0;
+}
+
+bool eer_mock_expect_write(size_t* cursor, uint16_t address, uint16_t value) {
+    for (size_t i = *cursor; i < mock_trace_size; i++) {
+        if (mock_trace[i].write && mock_trace[i].address == address && mock_trace[i].value == value) {
+            *cursor = i + 1;
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+size_t eer_mock_count(uint16_t address, bool write) {
+    size_t count = 0;
+    
+    for (size_t i = 0; i < mock_trace_size; i++) {
+        if (mock_trace[i].address == address && mock_trace[i].write == write) {
+            count++;
+        }
+    }
+    
+    return count;
+}
+
+void eer_mock_trace_dump(void) {
+    for (size_t i = 0; i < mock_trace_size; i++) {
+        const eer_mock_access_t* access = &mock_trace[i];
+        
+        printf("%4zu %s 0x%02X %s 0x%0*X (was 0x%0*X)\n", i,
+               access->write ? "W" : "R", access->address, access->write ? "<-" : "->",
+               access->size * 2, access->value, access->size * 2, access->previous);
+    }
+}
+
+void eer_mock_uart_rx(const uint8_t* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        mock_queue_push(&mock_uart_rx, data[i]);
+    }
+    
+    if (size > 0) {
+        EER_MOCK_REG(UCSR0A) |= (1 << RXC0);
+    }
+}
+
+size_t eer_mock_uart_tx(uint8_t* data, size_t size) {
+    return mock_queue_take(&mock_uart_tx, data, size);
+}
+
+void eer_mock_spi_miso(const uint8_t* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        mock_queue_push(&mock_spi_miso, data[i]);
+    }
+}
+
+size_t eer_mock_spi_mosi(uint8_t* data, size_t size) {
+    return mock_queue_take(&mock_spi_mosi, data, size);
+}
+
+void eer_mock_adc_value(uint8_t channel, uint16_t value) {
+    mock_adc[channel & 0x0F] = value;
+}
+
+void eer_mock_twi_attach(eer_mock_twi_slave_t* slave) {
+    slave->next = mock_twi.slaves;
+    mock_twi.slaves = slave;
+}
+
+void eer_mock_twi_conditions(uint16_t* starts, uint16_t* stops) {
+    *starts = mock_twi.starts;
+    *stops = mock_twi.stops;
+}
+
+/*
+ * Functions behind the macros of <avr/sleep.h> and <avr/boot.h>
+ */
+
+void eer_mock_sleep(void) {
+    if (mock_sleep.hook != NULL) {
+        mock_sleep.hook(mock_sleep.context);
+    }
+}
+
+void eer_mock_boot_page_fill(uintptr_t address, uint16_t data) {
+    mock_page_buffer[(address % SPM_PAGESIZE) / 2] = data;
+}
+
+void eer_mock_boot_page_erase(uintptr_t address) {
+    memset((uint8_t*)(address - address % SPM_PAGESIZE), 0xFF, SPM_PAGESIZE);
+}
+
+void eer_mock_boot_page_write(uintptr_t address) {
+    uint8_t* page = (uint8_t*)(address - address % SPM_PAGESIZE);
+    
+    eer_mock_spm_page = page;
+    eer_mock_spm_sreg = EER_MOCK_REG(SREG);
+    eer_mock_spm_writes++;
+    
+    // Programming clears bits only
+    for (uint16_t i = 0; i < SPM_PAGESIZE / 2; i++) {
+        page[2 * i] &= (uint8_t)mock_page_buffer[i];
+        page[2 * i + 1] &= (uint8_t)(mock_page_buffer[i] >> 8);
+    }
+    
+    memset(mock_page_buffer, 0xFF, sizeof(mock_page_buffer));
+}
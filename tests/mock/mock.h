@@ -0,0 +1,243 @@
+/**
+ * @file mock.h
+ * @brief Register-level test harness for the AVR drivers on the host
+ *
+ * The AVR sources are compiled unmodified against the mock <avr/io.h> in
+ * this directory, where every special function register is a byte of
+ * eer_mock_sfr. The page holding them is kept inaccessible: each access by
+ * driver code traps, is recorded in the trace and run past the peripheral
+ * models, so tests can assert the exact register sequence of an operation
+ * and drivers polling a status bit see the hardware answer.
+ *
+ * ISR() defines a plain function, eer_mock_irq() calls it to inject an
+ * interrupt. Trapping uses single-stepping and needs x86-64 Linux.
+ *
+ * A test calls eer_mock_reset() first, which brings the registers to their
+ * reset values and installs the default ATmega328P models:
+ * - GPIO: writing 1 to a PINx bit toggles the PORTx bit
+ * - USART0: UDRE0 is always set, a byte written to UDR0 is sent at once
+ *   (TXC0 set) and logged, received bytes are queued with eer_mock_uart_rx()
+ * - SPI: a byte written to SPDR completes at once (SPIF set), SPDR then
+ *   holds the next byte queued with eer_mock_spi_miso() or 0xFF
+ * - ADC: a conversion started with ADSC completes at once with the value
+ *   set with eer_mock_adc_value()
+ * - EEPROM: EERE and EEPE operate on eer_mock_eeprom at once
+ * - TWI: a bus with the slaves attached by eer_mock_twi_attach()
+ */
+#pragma once
+
+#include <avr/io.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Number of accesses the trace holds, later accesses are dropped
+ */
+#ifndef EER_MOCK_TRACE_SIZE
+#define EER_MOCK_TRACE_SIZE 4096
+#endif
+
+/**
+ * @brief Size of the logs and queues of the peripheral models in bytes
+ */
+#ifndef EER_MOCK_QUEUE_SIZE
+#define EER_MOCK_QUEUE_SIZE 256
+#endif
+
+/**
+ * @brief One register access by driver code
+ */
+typedef struct {
+    uint16_t address;   /*!< Data-space address of the register */
+    uint16_t value;     /*!< Value read or written */
+    uint16_t previous;  /*!< Register content before the access */
+    uint8_t  size;      /*!< Access width in bytes, 1 or 2 */
+    bool     write;     /*!< Write access (read-modify-write included) */
+} eer_mock_access_t;
+
+/**
+ * @brief Peripheral model hook
+ * @param access Access being made; read hooks run before the value is
+ *               read, write hooks after it was stored
+ * @param context Context given at installation
+ *
+ * Hooks see the registers through EER_MOCK_REG() and may change them.
+ */
+typedef void (*eer_mock_hook_t)(const eer_mock_access_t* access, void* context);
+
+/**
+ * @brief Register content without trapping, for tests and models
+ * @param sfr Register name from <avr/io.h>, e.g. UCSR0A
+ */
+#define EER_MOCK_REG(sfr) \
+    (*(volatile uint8_t*)(eer_mock_shadow + _SFR_ADDR(sfr)))
+
+/**
+ * @brief 16-bit register content without trapping
+ * @param sfr Register name from <avr/io.h>, e.g. TCNT1
+ */
+#define EER_MOCK_REG16(sfr) \
+    (*(volatile uint16_t*)(eer_mock_shadow + _SFR_ADDR(sfr)))
+
+/**
+ * @brief Data-space address of a register
+ */
+#define EER_MOCK_ADDR(sfr) _SFR_ADDR(sfr)
+
+/**
+ * @brief Inject an interrupt by running its handler
+ * @param vector Vector name from <avr/io.h>, e.g. USART_RX_vect
+ */
+#define eer_mock_irq(vector) \
+    do { void vector(void); vector(); } while (0)
+
+/**
+ * @brief Untrapped view of the register page
+ */
+extern volatile uint8_t* eer_mock_shadow;
+
+/**
+ * @brief EEPROM content behind the EEPROM model
+ */
+extern uint8_t eer_mock_eeprom[E2END + 1];
+
+/**
+ * @brief Reset registers, trace and models and start trapping
+ */
+void eer_mock_reset(void);
+
+/**
+ * @brief Install a model hook on one register
+ * @param address Data-space address, see EER_MOCK_ADDR()
+ * @param hook Hook, replaces a default model of the register; NULL removes
+ * @param context Passed to the hook
+ */
+void eer_mock_on_access(uint16_t address, eer_mock_hook_t hook, void* context);
+
+/**
+ * @brief Install the function sleep_cpu() calls
+ * @param hook Function playing the wake-up, e.g. with eer_mock_irq(); NULL
+ *             lets sleep_cpu() return at once
+ * @param context Passed to the hook
+ */
+void eer_mock_on_sleep(void (*hook)(void* context), void* context);
+
+/**
+ * @brief Number of accesses recorded since the last reset or clear
+ */
+size_t eer_mock_trace_count(void);
+
+/**
+ * @brief Get a recorded access
+ * @param index Position in the trace
+ * @return Access, NULL past the end
+ */
+const eer_mock_access_t* eer_mock_trace_get(size_t index);
+
+/**
+ * @brief Drop the recorded accesses
+ */
+void eer_mock_trace_clear(void);
+
+/**
+ * @brief Find the next write of a value to a register
+ * @param[in,out] cursor Trace position to search from, set past the match
+ * @param address Data-space address, see EER_MOCK_ADDR()
+ * @param value Value written
+ * @return true if found; successive calls assert a write sequence
+ */
+bool eer_mock_expect_write(size_t* cursor, uint16_t address, uint16_t value);
+
+/**
+ * @brief Count the recorded accesses to a register
+ * @param address Data-space address, see EER_MOCK_ADDR()
+ * @param write true to count writes, false to count reads
+ */
+size_t eer_mock_count(uint16_t address, bool write);
+
+/**
+ * @brief Print the trace to stdout, for debugging a failing test
+ */
+void eer_mock_trace_dump(void);
+
+/**
+ * @brief Queue bytes for the USART0 receiver
+ *
+ * RXC0 stays set while bytes are queued; reading UDR0 takes the next one.
+ */
+void eer_mock_uart_rx(const uint8_t* data, size_t size);
+
+/**
+ * @brief Take the bytes sent by USART0 since the last call
+ * @param[out] data Buffer for the bytes
+ * @param size Size of the buffer
+ * @return Number of bytes copied
+ */
+size_t eer_mock_uart_tx(uint8_t* data, size_t size);
+
+/**
+ * @brief Queue bytes the SPI slave returns
+ */
+void eer_mock_spi_miso(const uint8_t* data, size_t size);
+
+/**
+ * @brief Take the bytes sent on MOSI since the last call
+ * @return Number of bytes copied
+ */
+size_t eer_mock_spi_mosi(uint8_t* data, size_t size);
+
+/**
+ * @brief Set the conversion result of an ADC channel
+ * @param channel MUX channel, 0-15
+ * @param value 10-bit result
+ */
+void eer_mock_adc_value(uint8_t channel, uint16_t value);
+
+/**
+ * @brief TWI slave with a register pointer
+ *
+ * The first byte of a write sets pointer, further bytes are stored at
+ * pointer++; reads return memory[pointer++]. The pointer wraps at size.
+ */
+typedef struct eer_mock_twi_slave {
+    uint8_t  address;  /*!< 7-bit address */
+    uint8_t* memory;   /*!< Register file */
+    uint16_t size;     /*!< Size of memory */
+    uint16_t pointer;  /*!< Current register */
+    bool     nack_data;  /*!< NACK every data byte written */
+    struct eer_mock_twi_slave* next;  /*!< Managed by eer_mock_twi_attach() */
+} eer_mock_twi_slave_t;
+
+/**
+ * @brief Attach a slave to the TWI bus until the next reset
+ */
+void eer_mock_twi_attach(eer_mock_twi_slave_t* slave);
+
+/**
+ * @brief Number of START and STOP conditions seen on the TWI bus
+ */
+void eer_mock_twi_conditions(uint16_t* starts, uint16_t* stops);
+
+/**
+ * @brief Time requested through <util/delay.h> in microseconds
+ */
+extern volatile uint32_t eer_mock_delay_us;
+
+/**
+ * @brief Bytes read from program memory with pgm_read_byte()
+ */
+extern volatile uint32_t eer_mock_pgm_reads;
+
+/**
+ * @brief Page last programmed through <avr/boot.h>, SREG at the time and
+ *        the number of pages programmed since eer_mock_reset()
+ */
+extern uint8_t* eer_mock_spm_page;
+extern uint8_t eer_mock_spm_sreg;
+extern uint32_t eer_mock_spm_writes;
+
+/**
+ * @brief Flash image behind pgm_read_byte_far()
+ */
+extern uint8_t eer_mock_flash[FLASHEND + 1];
@@ -0,0 +1,15 @@
+/**
+ * @file delay.h
+ * @brief Host mock of <util/delay.h>
+ *
+ * Busy-wait delays return immediately; eer_mock_delay_us accumulates the
+ * requested time so tests can assert on it.
+ */
+#pragma once
+
+#include <stdint.h>
+
+extern volatile uint32_t eer_mock_delay_us;
+
+#define _delay_us(us) (eer_mock_delay_us += (uint32_t)(us))
+#define _delay_ms(ms) (eer_mock_delay_us += (uint32_t)(ms) * 1000UL)
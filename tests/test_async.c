@@ -0,0 +1,217 @@
+/**
+ * @file test_async.c
+ * @brief Test of the asynchronous request pipelines on the host platform
+ */
+#include "eer_hal.h"
+#include "eer_hal_async.h"
+#include "platforms/host/i2c.h"
+#include "platforms/host/spi.h"
+#include "platforms/host/uart.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+// Temperature sensor model: register pointer, then two bytes from it
+static uint8_t sensor_registers[4] = { 0x19, 0x80, 0x00, 0x00 };
+static uint8_t sensor_pointer = 0;
+
+static eer_hal_status_t sensor_write(host_i2c_device_t* device, const uint8_t* data, uint16_t size) {
+    (void)device;
+    sensor_pointer = size > 0 ? data[0] & 0x03 : sensor_pointer;
+    return EER_HAL_OK;
+}
+
+static eer_hal_status_t sensor_read(host_i2c_device_t* device, uint8_t* data, uint16_t size) {
+    (void)device;
+    for (uint16_t i = 0; i < size; i++) {
+        data[i] = sensor_registers[(sensor_pointer + i) & 0x03];
+    }
+    return EER_HAL_OK;
+}
+
+static host_i2c_device_t sensor = { 0x48, sensor_write, sensor_read, NULL, NULL };
+
+// SPI device echoing the previous byte
+static uint8_t echo_last = 0x00;
+
+static uint8_t echo_exchange(host_spi_device_t* device, uint8_t data) {
+    (void)device;
+    uint8_t previous = echo_last;
+    echo_last = data;
+    return previous;
+}
+
+static eer_pin_t echo_cs = eer_hal_pin(B, 2);
+static host_spi_device_t echo = { 0 };
+
+// Completion order
+static eer_async_request_t* completed[4];
+static uint8_t completed_count = 0;
+
+static void async_done(eer_async_request_t* request, void* user_data) {
+    (void)user_data;
+    if (completed_count < 4) {
+        completed[completed_count++] = request;
+    }
+}
+
+// Test an I2C measurement reported over the UART without the main loop
+static bool test_async_pipeline(void) {
+    const uint8_t command[] = { 0x00 };
+    uint8_t sample[2] = {0};
+    uint8_t output[4];
+    int fds[2];
+    
+    eer_async_request_t report = {
+        .bus = EER_ASYNC_UART,
+        .tx_data = sample, .tx_size = sizeof(sample),
+        .handler = async_done
+    };
+    eer_async_request_t measure = {
+        .bus = EER_ASYNC_I2C, .address = 0x48,
+        .tx_data = command, .tx_size = sizeof(command),
+        .rx_data = sample, .rx_size = sizeof(sample),
+        .handler = async_done,
+        .next = &report
+    };
+    
+    if (pipe(fds) != 0) {
+        printf("Async Pipeline: FAIL\n");
+        return false;
+    }
+    host_uart_attach(-1, fds[1]);
+    host_i2c_attach(&sensor);
+    completed_count = 0;
+    
+    bool success = eer_async_submit(&measure) == EER_HAL_OK;
+    host_poll();
+    
+    host_uart_attach(-1, -1);
+    close(fds[1]);
+    ssize_t size = read(fds[0], output, sizeof(output));
+    close(fds[0]);
+    host_i2c_detach(&sensor);
+    
+    success &= measure.status == EER_HAL_OK && report.status == EER_HAL_OK;
+    success &= size == 2 && output[0] == 0x19 && output[1] == 0x80;
+    success &= completed_count == 2 && completed[0] == &measure && completed[1] == &report;
+    
+    printf("Async Pipeline: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test that a failed request cancels the rest of its pipeline
+static bool test_async_cancel(void) {
+    const uint8_t command[] = { 0x00 };
+    uint8_t sample[2];
+    
+    eer_async_request_t report = {
+        .bus = EER_ASYNC_UART,
+        .tx_data = sample, .tx_size = sizeof(sample),
+        .handler = async_done
+    };
+    eer_async_request_t measure = {
+        .bus = EER_ASYNC_I2C, .address = 0x49,
+        .tx_data = command, .tx_size = sizeof(command),
+        .rx_data = sample, .rx_size = sizeof(sample),
+        .handler = async_done,
+        .next = &report
+    };
+    
+    completed_count = 0;
+    
+    // Nothing acknowledges 0x49
+    bool success = eer_async_submit(&measure) == EER_HAL_OK;
+    host_poll();
+    
+    success &= measure.status != EER_HAL_OK && measure.status != EER_HAL_BUSY;
+    success &= report.status == measure.status;
+    success &= completed_count == 2 && completed[1] == &report;
+    
+    printf("Async Cancel: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test a full-duplex SPI request longer on the receive side
+static bool test_async_spi(void) {
+    const uint8_t command[] = { 0x9F, 0x01 };
+    uint8_t answer[4] = {0};
+    
+    eer_spi_device_t echo_spi = { .cs = &echo_cs, .prescaler = EER_SPI_PRESCALER_8 };
+    eer_async_request_t request = {
+        .bus = EER_ASYNC_SPI, .device = &echo_spi,
+        .tx_data = command, .tx_size = sizeof(command),
+        .rx_data = answer, .rx_size = sizeof(answer)
+    };
+    
+    echo.cs = echo_cs;
+    echo.exchange = echo_exchange;
+    echo_last = 0x00;
+    host_spi_attach(&echo);
+    
+    bool success = eer_async_submit(&request) == EER_HAL_OK;
+    host_poll();
+    host_spi_detach(&echo);
+    
+    // 0xFF is sent past the command, at the device's clock
+    success &= request.status == EER_HAL_OK && host_spi_config()->prescaler == EER_SPI_PRESCALER_8;
+    success &= answer[0] == 0x00 && answer[1] == 0x9F && answer[2] == 0x01 && answer[3] == 0xFF;
+    
+    // A request without bytes is rejected
+    eer_async_request_t empty = { .bus = EER_ASYNC_SPI };
+    success &= eer_async_submit(&empty) == EER_HAL_INVALID_PARAM;
+    
+    printf("Async SPI: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test a UART request receiving a reply, with blocking calls held off
+static bool test_async_uart_receive(void) {
+    const uint8_t reply[] = "OK\r\n";
+    uint8_t line[4] = {0};
+    int fds[2];
+    
+    eer_async_request_t request = {
+        .bus = EER_ASYNC_UART,
+        .rx_data = line, .rx_size = sizeof(line)
+    };
+    
+    if (pipe(fds) != 0) {
+        printf("Async UART Receive: FAIL\n");
+        return false;
+    }
+    host_uart_attach(fds[0], -1);
+    
+    bool success = eer_async_submit(&request) == EER_HAL_OK;
+    success &= request.status == EER_HAL_BUSY;
+    success &= eer_hal_call(uart, receive, line, 1, 0) == EER_HAL_BUSY;
+    
+    success &= write(fds[1], reply, 4) == 4;
+    host_poll();
+    
+    success &= request.status == EER_HAL_OK && memcmp(line, reply, 4) == 0;
+    
+    host_uart_attach(-1, -1);
+    close(fds[0]);
+    close(fds[1]);
+    
+    printf("Async UART Receive: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+int main(void) {
+    bool success = true;
+    
+    printf("Starting asynchronous request tests...\n");
+    
+    success &= test_async_pipeline();
+    success &= test_async_cancel();
+    success &= test_async_spi();
+    success &= test_async_uart_receive();
+    
+    printf("\nAsynchronous request tests %s\n", success ? "PASSED" : "FAILED");
+    
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
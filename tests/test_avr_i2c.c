@@ -0,0 +1,256 @@
+/**
+ * @file test_avr_i2c.c
+ * @brief Register-level test of the AVR I2C driver on the mock <avr/io.h>
+ */
+#include "mock.h"
+#include "i2c.h"
+#include "eer_hal_async.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+// EEPROM-like device with a register pointer
+static uint8_t device_memory[16];
+static eer_mock_twi_slave_t device = {
+    .address = 0x50,
+    .memory = device_memory,
+    .size = sizeof(device_memory)
+};
+
+static eer_i2c_config_t i2c_config = {
+    .addr_mode = EER_I2C_ADDR_7BIT,
+    .speed = EER_I2C_SPEED_STANDARD,
+    .clock_hz = 0,
+    .duty_cycle = false
+};
+
+static void i2c_setup(void) {
+    eer_mock_reset();
+    memset(device_memory, 0, sizeof(device_memory));
+    device.pointer = 0;
+    device.nack_data = false;
+    eer_mock_twi_attach(&device);
+    eer_avr_i2c.init(&i2c_config);
+    eer_mock_trace_clear();
+}
+
+// Test the bit rate and the TWCR sequence of a write transfer
+static bool test_i2c_transmit(void) {
+    const uint8_t frame[] = { 0x04, 0xDE, 0xAD };
+    
+    i2c_setup();
+    
+    // (16 MHz / 100 kHz - 16) / 2
+    bool success = EER_MOCK_REG(TWBR) == 72;
+    success &= eer_avr_i2c.master_transmit(0x50, frame, sizeof(frame), 10) == EER_HAL_OK;
+    
+    const uint8_t go = (1 << TWINT) | (1 << TWEN);
+    size_t cursor = 0;
+    success &= eer_mock_expect_write(&cursor, EER_MOCK_ADDR(TWCR), go | (1 << TWSTA));
+    success &= eer_mock_expect_write(&cursor, EER_MOCK_ADDR(TWDR), 0x50 << 1);
+    success &= eer_mock_expect_write(&cursor, EER_MOCK_ADDR(TWCR), go);
+    for (uint8_t i = 0; i < sizeof(frame); i++) {
+        success &= eer_mock_expect_write(&cursor, EER_MOCK_ADDR(TWDR), frame[i]);
+        success &= eer_mock_expect_write(&cursor, EER_MOCK_ADDR(TWCR), go);
+    }
+    success &= eer_mock_expect_write(&cursor, EER_MOCK_ADDR(TWCR), go | (1 << TWSTO));
+    
+    success &= device_memory[4] == 0xDE && device_memory[5] == 0xAD;
+    
+    printf("I2C Transmit Sequence: %s\n", success ? "PASS" : "FAIL");
+    if (!success) {
+        eer_mock_trace_dump();
+    }
+    return success;
+}
+
+// Test a register read with repeated start and NACK on the last byte
+static bool test_i2c_transmit_receive(void) {
+    const uint8_t reg = 0x08;
+    uint8_t data[3] = {0};
+    
+    i2c_setup();
+    device_memory[8] = 0x11;
+    device_memory[9] = 0x22;
+    device_memory[10] = 0x33;
+    
+    bool success = eer_avr_i2c.master_transmit_receive(0x50, &reg, 1, data, sizeof(data), 10) == EER_HAL_OK;
+    success &= data[0] == 0x11 && data[1] == 0x22 && data[2] == 0x33;
+    
+    const uint8_t go = (1 << TWINT) | (1 << TWEN);
+    size_t cursor = 0;
+    success &= eer_mock_expect_write(&cursor, EER_MOCK_ADDR(TWCR), go | (1 << TWSTA));
+    success &= eer_mock_expect_write(&cursor, EER_MOCK_ADDR(TWCR), go | (1 << TWSTA));
+    success &= eer_mock_expect_write(&cursor, EER_MOCK_ADDR(TWDR), (0x50 << 1) | 1);
+    success &= eer_mock_expect_write(&cursor, EER_MOCK_ADDR(TWCR), go | (1 << TWEA));
+    success &= eer_mock_expect_write(&cursor, EER_MOCK_ADDR(TWCR), go | (1 << TWEA));
+    success &= eer_mock_expect_write(&cursor, EER_MOCK_ADDR(TWCR), go);
+    success &= eer_mock_expect_write(&cursor, EER_MOCK_ADDR(TWCR), go | (1 << TWSTO));
+    
+    uint16_t starts, stops;
+    eer_mock_twi_conditions(&starts, &stops);
+    success &= starts == 2 && stops == 1;
+    
+    printf("I2C Repeated Start Read: %s\n", success ? "PASS" : "FAIL");
+    if (!success) {
+        eer_mock_trace_dump();
+    }
+    return success;
+}
+
+// Test that NACKs end the transfer with a STOP
+static bool test_i2c_nack(void) {
+    const uint8_t frame[] = { 0x00, 0x01 };
+    
+    i2c_setup();
+    
+    // Nobody answers at 0x51
+    bool success = eer_avr_i2c.master_transmit(0x51, frame, sizeof(frame), 10) == EER_HAL_ERROR;
+    
+    // The device refuses data
+    device.nack_data = true;
+    success &= eer_avr_i2c.master_transmit(0x50, frame, sizeof(frame), 10) == EER_HAL_ERROR;
+    
+    uint16_t starts, stops;
+    eer_mock_twi_conditions(&starts, &stops);
+    success &= starts == 2 && stops == 2;
+    
+    printf("I2C NACK Handling: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test the bus scan
+static bool test_i2c_scan(void) {
+    uint8_t other_memory[1];
+    eer_mock_twi_slave_t other = {
+        .address = 0x68,
+        .memory = other_memory,
+        .size = sizeof(other_memory)
+    };
+    uint16_t devices[4];
+    uint8_t found = 0;
+    
+    i2c_setup();
+    eer_mock_twi_attach(&other);
+    
+    bool success = eer_avr_i2c.scan(devices, 4, &found) == EER_HAL_OK;
+    success &= found == 2 && devices[0] == 0x50 && devices[1] == 0x68;
+    
+    printf("I2C Scan: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Order in which requests completed
+static eer_async_request_t* completed[4];
+static uint8_t completed_count = 0;
+
+static void i2c_async_done(eer_async_request_t* request, void* user_data) {
+    (void)user_data;
+    if (completed_count < 4) {
+        completed[completed_count++] = request;
+    }
+}
+
+// Run the TWI interrupt while it is enabled and pending
+static void i2c_run_irq(void) {
+    const uint8_t pending = (1 << TWIE) | (1 << TWINT);
+    
+    for (uint8_t i = 0; i < 64 && (EER_MOCK_REG(TWCR) & pending) == pending; i++) {
+        eer_mock_irq(TWI_vect);
+    }
+}
+
+// Test a register read chained to a write, run by the TWI interrupt
+static bool test_i2c_async(void) {
+    const uint8_t reg = 0x08;
+    const uint8_t write[] = { 0x00, 0xAB };
+    uint8_t data[3] = {0};
+    
+    eer_async_request_t store = {
+        .bus = EER_ASYNC_I2C, .address = 0x50,
+        .tx_data = write, .tx_size = sizeof(write),
+        .handler = i2c_async_done
+    };
+    eer_async_request_t read = {
+        .bus = EER_ASYNC_I2C, .address = 0x50,
+        .tx_data = &reg, .tx_size = 1,
+        .rx_data = data, .rx_size = sizeof(data),
+        .handler = i2c_async_done,
+        .next = &store
+    };
+    
+    i2c_setup();
+    device_memory[8] = 0x11;
+    device_memory[9] = 0x22;
+    device_memory[10] = 0x33;
+    completed_count = 0;
+    
+    bool success = eer_async_submit(&read) == EER_HAL_OK;
+    success &= eer_avr_i2c.master_transmit(0x50, write, sizeof(write), 10) == EER_HAL_BUSY;
+    i2c_run_irq();
+    
+    success &= read.status == EER_HAL_OK && store.status == EER_HAL_OK;
+    success &= data[0] == 0x11 && data[1] == 0x22 && data[2] == 0x33;
+    success &= device_memory[0] == 0xAB;
+    success &= completed_count == 2 && completed[0] == &read && completed[1] == &store;
+    
+    // START, repeated START, START of the chained write
+    uint16_t starts, stops;
+    eer_mock_twi_conditions(&starts, &stops);
+    success &= starts == 3 && stops == 2;
+    success &= (EER_MOCK_REG(TWCR) & (1 << TWIE)) == 0;
+    
+    printf("I2C Asynchronous Pipeline: %s\n", success ? "PASS" : "FAIL");
+    if (!success) {
+        eer_mock_trace_dump();
+    }
+    return success;
+}
+
+// Test that a NACK fails the request and cancels the rest of the pipeline
+static bool test_i2c_async_nack(void) {
+    const uint8_t frame[] = { 0x00, 0x01 };
+    
+    eer_async_request_t second = {
+        .bus = EER_ASYNC_I2C, .address = 0x50,
+        .tx_data = frame, .tx_size = sizeof(frame)
+    };
+    eer_async_request_t first = {
+        .bus = EER_ASYNC_I2C, .address = 0x51,
+        .tx_data = frame, .tx_size = sizeof(frame),
+        .next = &second
+    };
+    
+    i2c_setup();
+    
+    bool success = eer_async_submit(&first) == EER_HAL_OK;
+    i2c_run_irq();
+    
+    success &= first.status == EER_HAL_ERROR && second.status == EER_HAL_ERROR;
+    
+    // The cancelled request never reached the bus
+    uint16_t starts, stops;
+    eer_mock_twi_conditions(&starts, &stops);
+    success &= starts == 1 && stops == 1;
+    
+    printf("I2C Asynchronous NACK: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+int main(void) {
+    bool success = true;
+    
+    printf("Starting AVR I2C register tests...\n");
+    
+    success &= test_i2c_transmit();
+    success &= test_i2c_transmit_receive();
+    success &= test_i2c_nack();
+    success &= test_i2c_scan();
+    success &= test_i2c_async();
+    success &= test_i2c_async_nack();
+    
+    printf("\nAVR I2C tests %s\n", success ? "PASSED" : "FAILED");
+    
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
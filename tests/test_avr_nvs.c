@@ -0,0 +1,145 @@
+/**
+ * @file test_avr_nvs.c
+ * @brief Register-level test of the AVR EEPROM driver on the mock <avr/io.h>
+ */
+#include "mock.h"
+#include "nvs.h"
+#include "system.h"
+#include <avr/interrupt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+// Let a millisecond pass on every read of SREG, as the waiting loops do
+static void clock_hook(const eer_mock_access_t* access, void* context) {
+    (void)context;
+    
+    if (!access->write) {
+        avr_system_ticks++;
+    }
+}
+
+static void nvs_setup(void) {
+    eer_mock_reset();
+    memset(eer_mock_eeprom, 0xFF, sizeof(eer_mock_eeprom));
+    avr_system_ticks = 0;
+    avr_nvs_init();
+    eer_mock_trace_clear();
+}
+
+// Programming modes of the EECR writes that armed EEPE, in order
+static uint8_t programmed_modes(uint8_t* modes, uint8_t max) {
+    uint8_t count = 0;
+    
+    for (size_t i = 0; i < eer_mock_trace_count(); i++) {
+        const eer_mock_access_t* access = eer_mock_trace_get(i);
+        if (access->write && access->address == EER_MOCK_ADDR(EECR) &&
+            (access->value & (1 << EEPE)) && (access->previous & (1 << EEMPE)) && count < max) {
+            modes[count++] = access->value & ((1 << EEPM1) | (1 << EEPM0));
+        }
+    }
+    
+    return count;
+}
+
+// Test that each byte is programmed with the cheapest mode, or not at all
+static bool test_nvs_modes(void) {
+    const uint8_t data[] = { 0x5A, 0xFF, 0x12, 0xF0 };
+    uint8_t modes[8];
+    
+    nvs_setup();
+    eer_mock_eeprom[0] = 0x5A;  // Identical: skipped
+    eer_mock_eeprom[1] = 0x00;  // Only ones to set: erase only
+    eer_mock_eeprom[2] = 0xFF;  // Only zeros to clear: write only
+    eer_mock_eeprom[3] = 0x0F;  // Both: erase and write
+    
+    // With interrupts disabled the waiting caller programs the queue itself
+    cli();
+    bool success = avr_nvs_write(0, data, sizeof(data), 10) == EER_HAL_OK;
+    success &= avr_nvs_flush(10) == EER_HAL_OK;
+    
+    uint8_t count = programmed_modes(modes, sizeof(modes));
+    success &= count == 3;
+    success &= modes[0] == (1 << EEPM0);
+    success &= modes[1] == (1 << EEPM1);
+    success &= modes[2] == 0;
+    success &= memcmp(eer_mock_eeprom, data, sizeof(data)) == 0;
+    
+    printf("NVS Programming Modes: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test programming from the EE_READY interrupt and reads of queued bytes
+static bool test_nvs_interrupt(void) {
+    const uint8_t data[] = { 0x11, 0x22, 0x33 };
+    uint8_t read[3];
+    
+    nvs_setup();
+    sei();
+    
+    bool success = avr_nvs_write(16, data, sizeof(data), 0) == EER_HAL_OK;
+    success &= (EER_MOCK_REG(EECR) & (1 << EERIE)) != 0;
+    
+    // Queued bytes are read back before they are programmed
+    success &= eer_mock_eeprom[16] == 0xFF;
+    success &= avr_nvs_read(16, read, sizeof(read)) == EER_HAL_OK && memcmp(read, data, 3) == 0;
+    
+    for (uint8_t i = 0; i < 4; i++) {
+        eer_mock_irq(EE_READY_vect);
+    }
+    success &= memcmp(&eer_mock_eeprom[16], data, sizeof(data)) == 0;
+    success &= (EER_MOCK_REG(EECR) & (1 << EERIE)) == 0;
+    success &= avr_nvs_flush(0) == EER_HAL_OK;
+    
+    printf("NVS Interrupt Programming: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test a full queue: rejected when non-blocking, timing out when blocking
+static bool test_nvs_queue_full(void) {
+    uint8_t data[EER_AVR_NVS_QUEUE_SIZE + 4];
+    
+    for (uint8_t i = 0; i < sizeof(data); i++) {
+        data[i] = i;
+    }
+    
+    nvs_setup();
+    eer_mock_on_access(EER_MOCK_ADDR(SREG), clock_hook, NULL);
+    sei();
+    
+    // The queue keeps one entry free
+    bool success = avr_nvs_write(0, data, EER_AVR_NVS_QUEUE_SIZE, 0) == EER_HAL_BUSY;
+    success &= avr_nvs_write(0, data, EER_AVR_NVS_QUEUE_SIZE - 1, 0) == EER_HAL_OK;
+    success &= avr_nvs_write(64, data, 1, 0) == EER_HAL_BUSY;
+    
+    // No interrupt drains the queue, so a blocking write gives up
+    uint32_t start = avr_system_ticks;
+    success &= avr_nvs_write(64, data, 1, 5) == EER_HAL_TIMEOUT;
+    success &= avr_system_ticks - start >= 5 && avr_system_ticks - start < 20;
+    success &= avr_nvs_flush(5) == EER_HAL_TIMEOUT;
+    
+    // Once the interrupt has run the queue drains within the timeout
+    for (uint8_t i = 0; i < EER_AVR_NVS_QUEUE_SIZE; i++) {
+        eer_mock_irq(EE_READY_vect);
+    }
+    success &= avr_nvs_flush(5) == EER_HAL_OK;
+    success &= memcmp(eer_mock_eeprom, data, EER_AVR_NVS_QUEUE_SIZE - 1) == 0;
+    
+    printf("NVS Full Queue Timeout: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+int main(void) {
+    bool success = true;
+    
+    printf("Starting AVR NVS register tests...\n");
+    
+    success &= test_nvs_modes();
+    success &= test_nvs_interrupt();
+    success &= test_nvs_queue_full();
+    
+    printf("\nAVR NVS tests %s\n", success ? "PASSED" : "FAILED");
+    
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
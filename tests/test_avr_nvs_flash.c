@@ -0,0 +1,138 @@
+/**
+ * @file test_avr_nvs_flash.c
+ * @brief Test of the AVR flash storage handler on the mock <avr/boot.h>
+ *
+ * The mock programs the storage region in place with the page buffer
+ * semantics of SPM, so a reset during programming is modeled by erasing
+ * part of the page programmed last before mounting again.
+ */
+#include "mock.h"
+#include "nvs.h"
+#include <avr/interrupt.h>
+#include <avr/boot.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+// Usable bytes of each logical page, ahead of the trailer
+#define PAGE_DATA (SPM_PAGESIZE - 4)
+
+static bool bytes_are(uint32_t address, const uint8_t* expected, uint16_t size) {
+    uint8_t data[16];
+    
+    return avr_flash_nvs_read(address, data, size) == EER_HAL_OK && memcmp(data, expected, size) == 0;
+}
+
+// Test that writes stay in RAM until flushed, with interrupts off while programming
+static bool test_flash_nvs_store(void) {
+    const uint8_t data[] = { 0x12, 0x34, 0x56, 0x78 };
+    const uint8_t erased[] = { 0xFF, 0xFF, 0xFF, 0xFF };
+    uint32_t size = 0;
+    uint32_t count = 0;
+    bool busy = false;
+    
+    eer_mock_reset();
+    sei();
+    
+    bool success = avr_flash_nvs_init() == EER_HAL_OK;
+    success &= avr_flash_nvs_get_size(&size) == EER_HAL_OK;
+    success &= size == EER_AVR_FLASH_NVS_SIZE / (2 * SPM_PAGESIZE) * PAGE_DATA;
+    success &= bytes_are(10, erased, sizeof(erased));
+    
+    // Within one page a non-blocking write only merges into the RAM image
+    success &= avr_flash_nvs_write(10, data, sizeof(data), 0) == EER_HAL_OK;
+    success &= eer_mock_spm_writes == 0 && bytes_are(10, data, sizeof(data));
+    success &= avr_flash_nvs_is_busy(&busy) == EER_HAL_OK && busy;
+    success &= avr_flash_nvs_write(PAGE_DATA - 2, data, sizeof(data), 0) == EER_HAL_BUSY;
+    success &= avr_flash_nvs_flush(0) == EER_HAL_BUSY;
+    
+    success &= avr_flash_nvs_flush(1) == EER_HAL_OK;
+    success &= eer_mock_spm_writes == 1;
+    success &= (eer_mock_spm_sreg & (1 << SREG_I)) == 0 && (EER_MOCK_REG(SREG) & (1 << SREG_I)) != 0;
+    success &= avr_flash_nvs_is_busy(&busy) == EER_HAL_OK && !busy;
+    
+    // Mounted again after a reset
+    success &= avr_flash_nvs_init() == EER_HAL_OK;
+    success &= bytes_are(10, data, sizeof(data)) && bytes_are(14, erased, sizeof(erased));
+    success &= avr_flash_nvs_get_erase_count(10, &count) == EER_HAL_OK && count == 1;
+    
+    printf("Flash NVS Store: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test that commits alternate between the two copies of a page, and that
+// writing another page programs the one being modified
+static bool test_flash_nvs_copies(void) {
+    const uint8_t first[] = { 0xA1, 0xA2 };
+    const uint8_t second[] = { 0xB1, 0xB2 };
+    uint32_t count = 0;
+    
+    eer_mock_reset();
+    avr_flash_nvs_init();
+    
+    bool success = avr_flash_nvs_write(PAGE_DATA, first, sizeof(first), 1) == EER_HAL_OK;
+    success &= avr_flash_nvs_flush(1) == EER_HAL_OK;
+    uint8_t* copy = eer_mock_spm_page;
+    
+    success &= avr_flash_nvs_write(PAGE_DATA, second, sizeof(second), 1) == EER_HAL_OK;
+    success &= avr_flash_nvs_write(2 * PAGE_DATA, first, sizeof(first), 1) == EER_HAL_OK;
+    success &= eer_mock_spm_writes == 2;
+    success &= eer_mock_spm_page == copy - SPM_PAGESIZE || eer_mock_spm_page == copy + SPM_PAGESIZE;
+    
+    // The previous copy keeps its contents until it is programmed again
+    success &= memcmp(copy, first, sizeof(first)) == 0;
+    
+    success &= avr_flash_nvs_flush(1) == EER_HAL_OK;
+    success &= avr_flash_nvs_init() == EER_HAL_OK;
+    success &= bytes_are(PAGE_DATA, second, sizeof(second)) && bytes_are(2 * PAGE_DATA, first, sizeof(first));
+    success &= avr_flash_nvs_get_erase_count(PAGE_DATA, &count) == EER_HAL_OK && count == 2;
+    
+    printf("Flash NVS Copies: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test that a reset during programming leaves the previous contents current
+static bool test_flash_nvs_power_loss(void) {
+    const uint8_t old[] = { 0x01, 0x02, 0x03 };
+    const uint8_t new[] = { 0x04, 0x05, 0x06 };
+    uint32_t count = 0;
+    
+    eer_mock_reset();
+    avr_flash_nvs_init();
+    
+    bool success = avr_flash_nvs_write(3 * PAGE_DATA, old, sizeof(old), 1) == EER_HAL_OK;
+    success &= avr_flash_nvs_flush(1) == EER_HAL_OK;
+    success &= avr_flash_nvs_write(3 * PAGE_DATA, new, sizeof(new), 1) == EER_HAL_OK;
+    success &= avr_flash_nvs_flush(1) == EER_HAL_OK;
+    
+    // The second half of the page, with the trailer, was never written
+    memset(eer_mock_spm_page + SPM_PAGESIZE / 2, 0xFF, SPM_PAGESIZE / 2);
+    
+    success &= avr_flash_nvs_init() == EER_HAL_OK;
+    success &= bytes_are(3 * PAGE_DATA, old, sizeof(old));
+    success &= avr_flash_nvs_get_erase_count(3 * PAGE_DATA, &count) == EER_HAL_OK && count == 1;
+    
+    // The torn copy is the next one programmed
+    uint8_t* torn = eer_mock_spm_page;
+    success &= avr_flash_nvs_write(3 * PAGE_DATA, new, sizeof(new), 1) == EER_HAL_OK;
+    success &= avr_flash_nvs_flush(1) == EER_HAL_OK && eer_mock_spm_page == torn;
+    success &= avr_flash_nvs_init() == EER_HAL_OK && bytes_are(3 * PAGE_DATA, new, sizeof(new));
+    
+    printf("Flash NVS Power Loss: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+int main(void) {
+    bool success = true;
+    
+    printf("Starting AVR flash NVS tests...\n");
+    
+    success &= test_flash_nvs_store();
+    success &= test_flash_nvs_copies();
+    success &= test_flash_nvs_power_loss();
+    
+    printf("\nAVR flash NVS tests %s\n", success ? "PASSED" : "FAILED");
+    
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
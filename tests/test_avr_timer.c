@@ -0,0 +1,184 @@
+/**
+ * @file test_avr_timer.c
+ * @brief Register-level test of the AVR timer driver on the mock <avr/io.h>
+ */
+#include "mock.h"
+#include "timer.h"
+#include "power.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+static uint8_t overflow_count = 0;
+static uint32_t compare_value = 0;
+static uint32_t capture_value = 0;
+
+// Timer overflow callback function
+static void timer_overflow_handler(eer_timer_event_info_t* event) {
+    (void)event;
+    overflow_count++;
+}
+
+// Timer compare callback function
+static void timer_compare_handler(eer_timer_event_info_t* event) {
+    compare_value = event->value;
+}
+
+// Timer capture callback function
+static void timer_capture_handler(eer_timer_event_info_t* event) {
+    capture_value = event->value;
+}
+
+// Test the register sequence of PWM initialization
+static bool test_timer_pwm_init(void) {
+    eer_timer_config_t config = {
+        .frequency = 0,
+        .mode = EER_TIMER_MODE_PWM,
+        .period = 40000,
+        .channel = 0
+    };
+    
+    eer_mock_reset();
+    
+    eer_hal_status_t status = eer_avr_timer.init(&config);
+    
+    // Fast PWM with TOP in ICR1 (mode 14), non-inverting outputs, clk/8
+    size_t cursor = 0;
+    bool success = status == EER_HAL_OK
+        && eer_mock_expect_write(&cursor, EER_MOCK_ADDR(TCCR1A), 0)
+        && eer_mock_expect_write(&cursor, EER_MOCK_ADDR(TCCR1B), 0)
+        && eer_mock_expect_write(&cursor, EER_MOCK_ADDR(TIMSK1), 0)
+        && eer_mock_expect_write(&cursor, EER_MOCK_ADDR(TCNT1), 0)
+        && eer_mock_expect_write(&cursor, EER_MOCK_ADDR(ICR1), 40000);
+    success &= EER_MOCK_REG(TCCR1A) == ((1 << COM1A1) | (1 << COM1B1) | (1 << WGM11));
+    success &= EER_MOCK_REG(TCCR1B) == ((1 << WGM13) | (1 << WGM12) | (1 << CS11));
+    
+    // 25% of the period
+    success &= eer_avr_timer.set_pwm_duty_cycle(1, 25) == EER_HAL_OK;
+    success &= EER_MOCK_REG16(OCR1B) == 10000;
+    success &= eer_avr_timer.set_pwm_duty_cycle(1, 101) == EER_HAL_INVALID_PARAM;
+    
+    printf("Timer PWM Init Sequence: %s\n", success ? "PASS" : "FAIL");
+    if (!success) {
+        eer_mock_trace_dump();
+    }
+    return success;
+}
+
+// Test that a one-shot timer stops itself in the overflow interrupt
+static bool test_timer_one_shot(void) {
+    eer_timer_config_t config = {
+        .frequency = 0,
+        .mode = EER_TIMER_MODE_ONE_SHOT,
+        .period = 0,
+        .channel = 0
+    };
+    
+    eer_mock_reset();
+    overflow_count = 0;
+    
+    bool success = eer_avr_timer.init(&config) == EER_HAL_OK;
+    success &= eer_avr_timer.register_callback(EER_TIMER_EVENT_OVERFLOW, 0, timer_overflow_handler, NULL) == EER_HAL_OK;
+    success &= (EER_MOCK_REG(TIMSK1) & (1 << TOIE1)) != 0;
+    success &= eer_avr_timer.start() == EER_HAL_OK;
+    success &= (EER_MOCK_REG(TCCR1B) & (1 << CS11)) != 0;
+    
+    eer_mock_irq(TIMER1_OVF_vect);
+    
+    success &= overflow_count == 1;
+    success &= (EER_MOCK_REG(TCCR1B) & ((1 << CS12) | (1 << CS11) | (1 << CS10))) == 0;
+    
+    // The overflow also reports a wakeup to the power driver
+    eer_wakeup_source_t source;
+    uint8_t id;
+    success &= eer_avr_power.get_wakeup_source(&source, &id) == EER_HAL_OK;
+    success &= source == EER_WAKEUP_TIMER && id == 1;
+    
+    printf("Timer One-Shot Overflow: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test compare events and tick conversion
+static bool test_timer_compare(void) {
+    eer_timer_config_t config = {
+        .frequency = 0,
+        .mode = EER_TIMER_MODE_CONTINUOUS,
+        .period = 0,
+        .channel = 0
+    };
+    
+    eer_mock_reset();
+    compare_value = 0;
+    
+    uint32_t ticks = eer_avr_timer.us_to_ticks(1500);
+    
+    bool success = eer_avr_timer.init(&config) == EER_HAL_OK;
+    success &= ticks == 3000 && eer_avr_timer.ticks_to_us(ticks) == 1500;
+    success &= eer_avr_timer.set_compare(0, ticks) == EER_HAL_OK;
+    success &= eer_avr_timer.set_compare(2, ticks) == EER_HAL_INVALID_PARAM;
+    success &= eer_avr_timer.register_callback(EER_TIMER_EVENT_COMPARE, 0, timer_compare_handler, NULL) == EER_HAL_OK;
+    success &= (EER_MOCK_REG(TIMSK1) & (1 << OCIE1A)) != 0;
+    
+    eer_mock_irq(TIMER1_COMPA_vect);
+    success &= compare_value == 3000;
+    
+    // A continuous timer keeps running
+    success &= (EER_MOCK_REG(TCCR1B) & (1 << CS11)) != 0;
+    
+    // Reading the counter is a single 16-bit access
+    EER_MOCK_REG16(TCNT1) = 1234;
+    eer_mock_trace_clear();
+    uint32_t value = 0;
+    success &= eer_avr_timer.get_value(&value) == EER_HAL_OK && value == 1234;
+    success &= eer_mock_trace_count() == 1 && eer_mock_trace_get(0)->size == 2;
+    
+    printf("Timer Compare Event: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test capture events and the capture edge select
+static bool test_timer_capture(void) {
+    eer_timer_config_t config = {
+        .frequency = 0,
+        .mode = EER_TIMER_MODE_CONTINUOUS,
+        .period = 0,
+        .channel = 0
+    };
+    
+    eer_mock_reset();
+    capture_value = 0;
+    
+    bool success = eer_avr_timer.init(&config) == EER_HAL_OK;
+    success &= eer_avr_timer.register_callback(EER_TIMER_EVENT_CAPTURE, 0, timer_capture_handler, NULL) == EER_HAL_OK;
+    success &= (EER_MOCK_REG(TIMSK1) & (1 << ICIE1)) != 0;
+    
+    // Selecting an edge clears the flag it may have raised
+    success &= eer_avr_timer.set_capture_edge(true) == EER_HAL_OK;
+    success &= (EER_MOCK_REG(TCCR1B) & (1 << ICES1)) != 0 && (EER_MOCK_REG(TCCR1B) & (1 << CS11)) != 0;
+    success &= EER_MOCK_REG(TIFR1) == (1 << ICF1);
+    
+    EER_MOCK_REG16(ICR1) = 4321;
+    eer_mock_irq(TIMER1_CAPT_vect);
+    success &= capture_value == 4321;
+    
+    success &= eer_avr_timer.set_capture_edge(false) == EER_HAL_OK;
+    success &= (EER_MOCK_REG(TCCR1B) & (1 << ICES1)) == 0 && (EER_MOCK_REG(TCCR1B) & (1 << CS11)) != 0;
+    
+    printf("Timer Capture Event: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+int main(void) {
+    bool success = true;
+    
+    printf("Starting AVR timer register tests...\n");
+    
+    success &= test_timer_pwm_init();
+    success &= test_timer_one_shot();
+    success &= test_timer_compare();
+    success &= test_timer_capture();
+    
+    printf("\nAVR timer tests %s\n", success ? "PASSED" : "FAILED");
+    
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,290 @@
+/**
+ * @file test_avr_uart.c
+ * @brief Register-level test of the AVR UART driver on the mock <avr/io.h>
+ */
+#include "mock.h"
+#include "uart.h"
+#include "system.h"
+#include "eer_hal_async.h"
+#include <avr/pgmspace.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+static uint8_t received[8];
+static uint8_t received_count = 0;
+
+// UART receive callback function
+static void uart_rx_handler(eer_uart_rx_event_t* event) {
+    if (received_count < sizeof(received)) {
+        received[received_count++] = event->data[0];
+    }
+}
+
+// Let a millisecond pass on every read of SREG, as reading the tick does
+static void clock_hook(const eer_mock_access_t* access, void* context) {
+    (void)context;
+    
+    if (!access->write) {
+        avr_system_ticks++;
+    }
+}
+
+static eer_uart_config_t uart_config = {
+    .baudrate = 9600,
+    .data_bits = EER_UART_DATA_BITS_8,
+    .parity = EER_UART_PARITY_EVEN,
+    .stop_bits = EER_UART_STOP_BITS_2,
+    .flow_control = false
+};
+
+// Test the register sequence of initialization
+static bool test_uart_init(void) {
+    eer_mock_reset();
+    
+    eer_hal_status_t status = eer_avr_uart.init(&uart_config);
+    
+    // U2X0 baud divisor 16 MHz / (8 * 9600) - 1 = 207, rounded
+    size_t cursor = 0;
+    bool success = status == EER_HAL_OK
+        && eer_mock_expect_write(&cursor, EER_MOCK_ADDR(UBRR0H), 0)
+        && eer_mock_expect_write(&cursor, EER_MOCK_ADDR(UBRR0L), 207)
+        && eer_mock_expect_write(&cursor, EER_MOCK_ADDR(UCSR0A), (1 << UDRE0) | (1 << U2X0))
+        && eer_mock_expect_write(&cursor, EER_MOCK_ADDR(UCSR0C),
+                                 (1 << UPM01) | (1 << USBS0) | (1 << UCSZ01) | (1 << UCSZ00))
+        && eer_mock_expect_write(&cursor, EER_MOCK_ADDR(UCSR0B), (1 << RXEN0) | (1 << TXEN0));
+        
+    printf("UART Init Sequence: %s\n", success ? "PASS" : "FAIL");
+    if (!success) {
+        eer_mock_trace_dump();
+    }
+    return success;
+}
+
+// Test that a decoded configuration gives the same registers as init
+static bool test_uart_registers(void) {
+    avr_uart_registers_t registers = avr_uart_registers(&uart_config);
+    
+    bool success = registers.ubrr == 207;
+    success &= registers.ucsrc == ((1 << UPM01) | (1 << USBS0) | (1 << UCSZ01) | (1 << UCSZ00));
+    
+    eer_mock_reset();
+    success &= avr_uart_init_registers(registers) == EER_HAL_OK;
+    success &= EER_MOCK_REG(UBRR0L) == 207 && EER_MOCK_REG(UCSR0C) == registers.ucsrc;
+    success &= EER_MOCK_REG(UCSR0B) == ((1 << RXEN0) | (1 << TXEN0));
+    
+    printf("UART Register Table: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test that each byte clears TXC0 before it is loaded into UDR0
+static bool test_uart_transmit(void) {
+    const uint8_t message[] = "AT\r";
+    uint8_t sent[8];
+    
+    eer_mock_reset();
+    eer_avr_uart.init(&uart_config);
+    eer_mock_trace_clear();
+    
+    eer_hal_status_t status = eer_avr_uart.transmit(message, 3, 0);
+    
+    size_t cursor = 0;
+    bool success = status == EER_HAL_OK;
+    for (uint8_t i = 0; i < 3; i++) {
+        success &= eer_mock_expect_write(&cursor, EER_MOCK_ADDR(UCSR0A), (1 << U2X0) | (1 << TXC0));
+        success &= eer_mock_expect_write(&cursor, EER_MOCK_ADDR(UDR0), message[i]);
+    }
+    success &= eer_mock_uart_tx(sent, sizeof(sent)) == 3 && memcmp(sent, message, 3) == 0;
+    
+    // The last frame has shifted out once TXC0 is set again
+    success &= avr_uart_flush() == EER_HAL_OK;
+    
+    // Multiprocessor mode survives clearing TXC0
+    EER_MOCK_REG(UCSR0A) |= (1 << MPCM0);
+    success &= eer_avr_uart.transmit(message, 1, 0) == EER_HAL_OK;
+    success &= (EER_MOCK_REG(UCSR0A) & ((1 << MPCM0) | (1 << U2X0))) == ((1 << MPCM0) | (1 << U2X0));
+    
+    printf("UART Transmit Sequence: %s\n", success ? "PASS" : "FAIL");
+    if (!success) {
+        eer_mock_trace_dump();
+    }
+    return success;
+}
+
+// Test the receive ring buffer fed by injected interrupts
+static bool test_uart_rx_interrupt(void) {
+    const uint8_t line[] = { 'O', 'K', '\r', '\n' };
+    
+    eer_mock_reset();
+    eer_avr_uart.init(&uart_config);
+    received_count = 0;
+    
+    bool success = eer_avr_uart.register_rx_callback(uart_rx_handler, NULL) == EER_HAL_OK;
+    success &= (EER_MOCK_REG(UCSR0B) & (1 << RXCIE0)) != 0;
+    
+    // One interrupt per received frame
+    for (uint8_t i = 0; i < sizeof(line); i++) {
+        eer_mock_uart_rx(&line[i], 1);
+        eer_mock_irq(USART_RX_vect);
+    }
+    
+    success &= received_count == sizeof(line) && memcmp(received, line, sizeof(line)) == 0;
+    success &= (EER_MOCK_REG(UCSR0A) & (1 << RXC0)) == 0;
+    
+    printf("UART Receive Interrupt: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test polled reception
+static bool test_uart_receive(void) {
+    const uint8_t reply[] = { 0x55, 0xAA };
+    uint8_t data[2] = {0};
+    
+    eer_mock_reset();
+    eer_avr_uart.init(&uart_config);
+    eer_mock_uart_rx(reply, sizeof(reply));
+    
+    bool ready = false;
+    bool success = eer_avr_uart.is_rx_ready(&ready) == EER_HAL_OK && ready;
+    success &= eer_avr_uart.receive(data, sizeof(data), 0) == EER_HAL_OK;
+    success &= memcmp(data, reply, sizeof(reply)) == 0;
+    success &= eer_mock_count(EER_MOCK_ADDR(UDR0), false) == 2;
+    
+    // Non-blocking with nothing received returns at once
+    success &= eer_avr_uart.receive(data, 1, 0) == EER_HAL_TIMEOUT;
+    success &= eer_mock_count(EER_MOCK_ADDR(UDR0), false) == 2;
+    
+    // A blocking call gives up after its timeout on the system tick
+    eer_mock_on_access(EER_MOCK_ADDR(SREG), clock_hook, NULL);
+    avr_system_ticks = 0;
+    success &= eer_avr_uart.receive(data, 1, 5) == EER_HAL_TIMEOUT;
+    success &= avr_system_ticks >= 5 && avr_system_ticks < 20;
+    eer_mock_on_access(EER_MOCK_ADDR(SREG), NULL, NULL);
+    
+    printf("UART Receive Polled: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test an asynchronous request sent by the data register empty interrupt
+// and completed by the receive interrupt
+static bool test_uart_async(void) {
+    const uint8_t command[] = { 'A', 'T', '\r' };
+    const uint8_t reply[] = { 'O', 'K' };
+    uint8_t answer[2] = {0};
+    uint8_t sent[8];
+    
+    eer_async_request_t request = {
+        .bus = EER_ASYNC_UART,
+        .tx_data = command,
+        .tx_size = sizeof(command),
+        .rx_data = answer,
+        .rx_size = sizeof(answer)
+    };
+    
+    // Without a receive callback left from the other tests
+    eer_avr_uart.deinit();
+    eer_mock_reset();
+    eer_avr_uart.init(&uart_config);
+    
+    bool success = eer_async_submit(&request) == EER_HAL_OK && request.status == EER_HAL_BUSY;
+    success &= (EER_MOCK_REG(UCSR0B) & (1 << UDRIE0)) != 0;
+    
+    // Blocking calls wait for the bus
+    success &= eer_avr_uart.transmit(command, 1, 0) == EER_HAL_BUSY;
+    
+    // One interrupt per byte while UDRIE0 is set
+    for (uint8_t i = 0; i < 8 && (EER_MOCK_REG(UCSR0B) & (1 << UDRIE0)); i++) {
+        eer_mock_irq(USART_UDRE_vect);
+    }
+    success &= eer_mock_uart_tx(sent, sizeof(sent)) == sizeof(command) && memcmp(sent, command, sizeof(command)) == 0;
+    
+    // The receive part enables the receive interrupt
+    success &= request.status == EER_HAL_BUSY && (EER_MOCK_REG(UCSR0B) & (1 << RXCIE0)) != 0;
+    for (uint8_t i = 0; i < sizeof(reply); i++) {
+        eer_mock_uart_rx(&reply[i], 1);
+        eer_mock_irq(USART_RX_vect);
+    }
+    
+    success &= request.status == EER_HAL_OK && memcmp(answer, reply, sizeof(reply)) == 0;
+    success &= (EER_MOCK_REG(UCSR0B) & ((1 << UDRIE0) | (1 << RXCIE0))) == 0;
+    
+    printf("UART Asynchronous Request: %s\n", success ? "PASS" : "FAIL");
+    if (!success) {
+        eer_mock_trace_dump();
+    }
+    return success;
+}
+
+// Test that flash payloads are read with pgm_read_byte(), blocking and
+// by the data register empty interrupt
+static bool test_uart_transmit_flash(void) {
+    static const uint8_t banner[] PROGMEM = "OK\r\n";
+    uint8_t sent[8];
+    
+    eer_avr_uart.deinit();
+    eer_mock_reset();
+    eer_avr_uart.init(&uart_config);
+    
+    bool success = avr_uart_transmit_P(banner, 4, 0) == EER_HAL_OK;
+    success &= eer_mock_pgm_reads == 4;
+    success &= eer_mock_uart_tx(sent, sizeof(sent)) == 4 && memcmp(sent, banner, 4) == 0;
+    
+    eer_async_request_t request = {
+        .bus = EER_ASYNC_UART,
+        .flags = EER_ASYNC_TX_FLASH,
+        .tx_data = banner,
+        .tx_size = 4
+    };
+    
+    success &= eer_async_submit(&request) == EER_HAL_OK;
+    for (uint8_t i = 0; i < 8 && (EER_MOCK_REG(UCSR0B) & (1 << UDRIE0)); i++) {
+        eer_mock_irq(USART_UDRE_vect);
+    }
+    success &= request.status == EER_HAL_OK && eer_mock_pgm_reads == 8;
+    success &= eer_mock_uart_tx(sent, sizeof(sent)) == 4 && memcmp(sent, banner, 4) == 0;
+    
+    // RAM payloads stay plain loads
+    success &= eer_avr_uart.transmit(sent, 4, 0) == EER_HAL_OK && eer_mock_pgm_reads == 8;
+    
+    printf("UART Transmit From Flash: %s\n", success ? "PASS" : "FAIL");
+    if (!success) {
+        eer_mock_trace_dump();
+    }
+    return success;
+}
+
+// Test that deinitialization only turns the USART off
+static bool test_uart_deinit(void) {
+    eer_mock_reset();
+    eer_avr_uart.init(&uart_config);
+    eer_mock_trace_clear();
+    
+    bool success = eer_avr_uart.deinit() == EER_HAL_OK;
+    
+    size_t cursor = 0;
+    success &= eer_mock_expect_write(&cursor, EER_MOCK_ADDR(UCSR0B), 0);
+    success &= eer_mock_trace_count() == 1;
+    
+    printf("UART Deinit Sequence: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+int main(void) {
+    bool success = true;
+    
+    printf("Starting AVR UART register tests...\n");
+    
+    success &= test_uart_init();
+    success &= test_uart_registers();
+    success &= test_uart_transmit();
+    success &= test_uart_rx_interrupt();
+    success &= test_uart_receive();
+    success &= test_uart_async();
+    success &= test_uart_transmit_flash();
+    success &= test_uart_deinit();
+    
+    printf("\nAVR UART tests %s\n", success ? "PASSED" : "FAILED");
+    
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,90 @@
+/**
+ * @file test_crc.c
+ * @brief Test of the CRC algorithms against their check values
+ *
+ * Built once per implementation (EER_CRC_METHOD), so the bitwise, nibble
+ * and table variants give the same results.
+ */
+#include "eer_crc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+// The check input of the CRC catalogue
+static const uint8_t check[] = "123456789";
+#define CHECK_SIZE 9
+
+// Test the catalogue check value of each algorithm
+static bool test_crc_check(void) {
+    bool success = true;
+    
+    success &= eer_crc8_dallas(EER_CRC8_DALLAS_INIT, check, CHECK_SIZE) == 0xA1;
+    success &= eer_crc8_smbus(EER_CRC8_SMBUS_INIT, check, CHECK_SIZE) == 0xF4;
+    success &= eer_crc16_ccitt(EER_CRC16_CCITT_INIT, check, CHECK_SIZE) == 0x29B1;
+    success &= eer_crc16_modbus(EER_CRC16_MODBUS_INIT, check, CHECK_SIZE) == 0x4B37;
+    success &= eer_crc32(EER_CRC32_INIT, check, CHECK_SIZE) == 0xCBF43926UL;
+    
+    printf("CRC Check Values: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test that byte updates and split blocks give the result of one block
+static bool test_crc_incremental(void) {
+    bool success = true;
+    uint8_t crc8 = EER_CRC8_DALLAS_INIT;
+    uint16_t crc16 = EER_CRC16_MODBUS_INIT;
+    uint32_t crc32 = EER_CRC32_INIT;
+    
+    for (uint8_t i = 0; i < CHECK_SIZE; i++) {
+        crc8 = eer_crc8_dallas_update(crc8, check[i]);
+        crc16 = eer_crc16_modbus_update(crc16, check[i]);
+        crc32 = eer_crc32_update(crc32, check[i]);
+    }
+    success &= crc8 == 0xA1 && crc16 == 0x4B37 && crc32 == 0xCBF43926UL;
+    
+    uint16_t ccitt = eer_crc16_ccitt(EER_CRC16_CCITT_INIT, check, 4);
+    success &= eer_crc16_ccitt(ccitt, check + 4, CHECK_SIZE - 4) == 0x29B1;
+    
+    uint8_t smbus = eer_crc8_smbus(EER_CRC8_SMBUS_INIT, check, 0);
+    success &= smbus == EER_CRC8_SMBUS_INIT;
+    success &= eer_crc8_smbus(eer_crc8_smbus(smbus, check, 5), check + 5, CHECK_SIZE - 5) == 0xF4;
+    
+    crc32 = eer_crc32(EER_CRC32_INIT, check, 1);
+    success &= eer_crc32(crc32, check + 1, CHECK_SIZE - 1) == 0xCBF43926UL;
+    
+    printf("CRC Incremental: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test the residue of frames carrying their own CRC
+static bool test_crc_frames(void) {
+    bool success = true;
+    
+    // DS18B20 ROM code: family, serial, CRC
+    uint8_t rom[8] = { 0x28, 0xFF, 0x4C, 0x5E, 0x91, 0x16, 0x04 };
+    rom[7] = eer_crc8_dallas(EER_CRC8_DALLAS_INIT, rom, 7);
+    success &= eer_crc8_dallas(EER_CRC8_DALLAS_INIT, rom, sizeof(rom)) == 0;
+    
+    // Modbus RTU read holding registers request, CRC low byte first
+    const uint8_t request[] = { 0x01, 0x03, 0x00, 0x00, 0x00, 0x0A, 0xC5, 0xCD };
+    success &= eer_crc16_modbus(EER_CRC16_MODBUS_INIT, request, 6) == 0xCDC5;
+    success &= eer_crc16_modbus(EER_CRC16_MODBUS_INIT, request, sizeof(request)) == 0;
+    
+    printf("CRC Frames: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+int main(void) {
+    bool success = true;
+    
+    printf("Starting CRC tests (method %d)...\n", EER_CRC_METHOD);
+    
+    success &= test_crc_check();
+    success &= test_crc_incremental();
+    success &= test_crc_frames();
+    
+    printf("\nCRC tests %s\n", success ? "PASSED" : "FAILED");
+    
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
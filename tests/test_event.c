@@ -0,0 +1,151 @@
+/**
+ * @file test_event.c
+ * @brief Test of the priority event dispatcher on the host platform
+ */
+#include "eer_hal.h"
+#include "eer_event.h"
+#include "platforms/host/uart.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+// Events seen by the handlers, in dispatch order
+static eer_event_t seen[32];
+static uint8_t seen_count = 0;
+
+static void record(const eer_event_t* event, void* user_data) {
+    (void)user_data;
+    if (seen_count < 32) {
+        seen[seen_count++] = *event;
+    }
+}
+
+static eer_event_subscription_t all = eer_event_subscription(EER_EVENT_ANY, record, NULL);
+
+static void post(eer_event_priority_t priority, uint8_t type, uint16_t value) {
+    eer_event_t event = { .type = type, .value = value };
+    eer_event_post(priority, &event);
+}
+
+// Test that higher priorities are dispatched first, in order within one
+static bool test_event_priority(void) {
+    eer_event_subscribe(&all);
+    seen_count = 0;
+    
+    post(EER_EVENT_LOW, EER_EVENT_USER, 1);
+    post(EER_EVENT_NORMAL, EER_EVENT_USER, 2);
+    post(EER_EVENT_HIGH, EER_EVENT_USER, 3);
+    post(EER_EVENT_NORMAL, EER_EVENT_USER, 4);
+    
+    bool success = eer_event_pending();
+    success &= eer_event_dispatch(0) == 4 && !eer_event_pending();
+    success &= seen_count == 4
+        && seen[0].value == 3 && seen[1].value == 2
+        && seen[2].value == 4 && seen[3].value == 1;
+        
+    printf("Event Priority Order: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Handler posting a high priority event while a low one is dispatched
+static void escalate(const eer_event_t* event, void* user_data) {
+    (void)user_data;
+    if (event->value == 10) {
+        post(EER_EVENT_HIGH, EER_EVENT_USER + 1, 11);
+    }
+}
+
+static eer_event_subscription_t escalation = eer_event_subscription(EER_EVENT_USER, escalate, NULL);
+
+// Test the budget and that a new high priority event overtakes queued ones
+static bool test_event_budget(void) {
+    eer_event_subscribe(&escalation);
+    seen_count = 0;
+    
+    post(EER_EVENT_LOW, EER_EVENT_USER, 10);
+    post(EER_EVENT_LOW, EER_EVENT_USER, 12);
+    
+    bool success = eer_event_dispatch(2) == 2;
+    success &= seen_count == 2 && seen[0].value == 10 && seen[1].value == 11;
+    success &= eer_event_pending();
+    
+    success &= eer_event_dispatch(2) == 1 && seen_count == 3 && seen[2].value == 12;
+    
+    eer_event_unsubscribe(&escalation);
+    
+    printf("Event Budget: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test that a full queue drops events and counts them
+static bool test_event_overflow(void) {
+    seen_count = 0;
+    
+    // One slot of the ring stays free
+    uint8_t accepted = 0;
+    for (uint8_t i = 0; i < EER_EVENT_QUEUE_SIZE + 2; i++) {
+        eer_event_t event = { .type = EER_EVENT_USER, .value = i };
+        accepted += eer_event_post(EER_EVENT_NORMAL, &event) == EER_HAL_OK;
+    }
+    
+    bool success = accepted == EER_EVENT_QUEUE_SIZE - 1;
+    success &= eer_event_dropped(EER_EVENT_NORMAL) == 3 && eer_event_dropped(EER_EVENT_NORMAL) == 0;
+    success &= eer_event_dispatch(0) == accepted && seen[accepted - 1].value == (uint32_t)(accepted - 1);
+    
+    printf("Event Queue Overflow: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test the UART bridge: bytes received in the emulated interrupt reach the
+// subscriber from the dispatcher only
+static bool test_event_uart_bridge(void) {
+    static eer_event_subscription_t bytes = eer_event_subscription(EER_EVENT_UART_RX, record, NULL);
+    int fds[2];
+    
+    eer_event_unsubscribe(&all);
+    eer_event_subscribe(&bytes);
+    seen_count = 0;
+    
+    if (pipe(fds) != 0) {
+        printf("Event UART Bridge: FAIL\n");
+        return false;
+    }
+    host_uart_attach(fds[0], -1);
+    eer_hal.uart->register_rx_callback(eer_event_uart_rx, eer_event_route(EER_EVENT_HIGH, 7));
+    
+    post(EER_EVENT_NORMAL, EER_EVENT_USER, 0);
+    bool success = write(fds[1], "hi", 2) == 2;
+    host_poll();
+    
+    success &= seen_count == 0;
+    success &= eer_event_dispatch(0) == 3;
+    success &= seen_count == 2
+        && seen[0].value == 'h' && seen[1].value == 'i'
+        && seen[0].source == 7 && seen[0].type == EER_EVENT_UART_RX;
+        
+    eer_hal.uart->unregister_rx_callback();
+    host_uart_attach(-1, -1);
+    close(fds[0]);
+    close(fds[1]);
+    eer_event_unsubscribe(&bytes);
+    
+    printf("Event UART Bridge: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+int main(void) {
+    bool success = true;
+    
+    printf("Starting event dispatcher tests...\n");
+    
+    success &= test_event_priority();
+    success &= test_event_budget();
+    success &= test_event_overflow();
+    success &= test_event_uart_bridge();
+    
+    printf("\nEvent dispatcher tests %s\n", success ? "PASSED" : "FAILED");
+    
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -3,7 +3,7 @@
  * @brief Test for GPIO HAL implementation
  */
 #include "eer_hal.h"
-#include "platforms/avr/gpio.h"
+#include "gpio.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
@@ -108,8 +108,8 @@ static bool test_gpio_toggle(void) {
 
 // Test GPIO interrupt registration
 static bool test_gpio_interrupt(void) {
-    // Note: This test may not be fully functional on all AVR platforms
-    // as the implementation in avr_gpio.c returns EER_HAL_NOT_SUPPORTED
+    // Note: On AVR this uses the pin change interrupt of the pin's port,
+    // platforms without pin interrupts return EER_HAL_NOT_SUPPORTED
     
     eer_gpio_config_t interrupt_config = {
         .mode = EER_GPIO_MODE_INPUT_PULLUP,
@@ -0,0 +1,246 @@
+/**
+ * @file test_ir.c
+ * @brief Test of the infrared remote decoder against simulated remotes
+ *
+ * The remotes drive the capture input of a host timer the way a
+ * demodulating receiver would, low during each burst of carrier, and let
+ * the virtual clock run for the length of every mark and space. Lengths
+ * can be stretched by a percentage to play remotes with a drifting clock.
+ */
+#include "eer_hal.h"
+#include "eer_ir.h"
+#include "eer_event.h"
+#include "platforms/host/host.h"
+#include "platforms/host/timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+#define SOURCE 3
+
+static eer_timer_t ir_timer = eer_hal_timer0();
+static eer_ir_t remote = { .timer = &ir_timer, .priority = EER_EVENT_NORMAL, .source = SOURCE };
+
+static eer_event_t events[8];
+static uint8_t event_count = 0;
+
+static void on_event(const eer_event_t* event, void* user_data) {
+    (void)user_data;
+    
+    if ((event->type == EER_EVENT_IR || event->type == EER_EVENT_IR_REPEAT) && event_count < 8) {
+        events[event_count++] = *event;
+    }
+}
+
+static eer_event_subscription_t subscription = eer_event_subscription(EER_EVENT_ANY, on_event, NULL);
+
+// Stretch of every length in percent
+static int stretch = 0;
+
+static void line(bool mark, uint32_t us) {
+    host_timer_instance_capture_input(&ir_timer, !mark);
+    host_advance_us(us * (100 + stretch) / 100);
+}
+
+static void idle(uint32_t us) {
+    host_timer_instance_capture_input(&ir_timer, true);
+    host_advance_us(us);
+}
+
+static void collect(void) {
+    event_count = 0;
+    eer_event_dispatch(16);
+}
+
+static bool received(uint8_t index, uint8_t type, uint32_t value) {
+    return index < event_count && events[index].type == type && events[index].value == value &&
+           events[index].source == SOURCE && events[index].data == &remote;
+}
+
+static void nec_frame(uint32_t data) {
+    line(true, 9000);
+    line(false, 4500);
+    
+    for (uint8_t bit = 0; bit < 32; bit++) {
+        line(true, 562);
+        line(false, (data >> bit) & 1 ? 1687 : 562);
+    }
+    
+    // Stop mark, then the rest of the 108 ms frame period
+    line(true, 562);
+    idle(40000);
+}
+
+static void nec_repeat(void) {
+    line(true, 9000);
+    line(false, 2250);
+    line(true, 562);
+    idle(96000);
+}
+
+static uint32_t nec_code(uint8_t address, uint8_t command) {
+    return address | (uint32_t)(uint8_t)~address << 8 | (uint32_t)command << 16 | (uint32_t)(uint8_t)~command << 24;
+}
+
+static void rc5_frame(bool toggle, uint8_t address, uint8_t command) {
+    uint16_t data = 1u << 13 | (command & 0x40 ? 0 : 1u << 12) | (uint16_t)toggle << 11 |
+                    (uint16_t)(address & 0x1F) << 6 | (command & 0x3F);
+    
+    // A 1 is a space then a mark, a 0 a mark then a space
+    for (int8_t bit = 13; bit >= 0; bit--) {
+        bool one = (data >> bit) & 1;
+        line(!one, 889);
+        line(one, 889);
+    }
+    
+    idle(89000);
+}
+
+static bool test_ir_init(void) {
+    // The receiver output idles high
+    host_timer_instance_capture_input(&ir_timer, true);
+    eer_event_subscribe(&subscription);
+    
+    bool success = eer_ir_init(&remote) == EER_HAL_OK;
+    
+    success &= ir_timer.running && ir_timer.capture_handler != NULL && !ir_timer.capture_rising;
+    
+    // Only edges interrupt; an idle line costs nothing
+    success &= ir_timer.overflow_handler == NULL;
+    success &= ir_timer.compare_handler[0] == NULL && ir_timer.compare_handler[1] == NULL;
+    
+    idle(100000);
+    collect();
+    success &= event_count == 0;
+    
+    printf("IR Init: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test NEC frames, extended addresses and a remote running slow
+static bool test_ir_nec(void) {
+    nec_frame(nec_code(0x04, 0x08));
+    collect();
+    
+    bool success = event_count == 1 && received(0, EER_EVENT_IR, 0x0408);
+    success &= remote.protocol == EER_IR_NEC && remote.address == 0x04 && remote.command == 0x08;
+    
+    // Extended NEC: the second byte is the high byte of the address
+    nec_frame(0x12 | 0x34 << 8 | (nec_code(0, 0x55) & 0xFFFF0000UL));
+    collect();
+    success &= event_count == 1 && received(0, EER_EVENT_IR, 0x341255);
+    success &= remote.address == 0x3412;
+    
+    stretch = 15;
+    nec_frame(nec_code(0xA0, 0x01));
+    stretch = 0;
+    collect();
+    success &= event_count == 1 && received(0, EER_EVENT_IR, 0xA001);
+    
+    printf("IR NEC: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test repeat codes of a held key, and stray ones without a frame before
+static bool test_ir_nec_repeat(void) {
+    nec_frame(nec_code(0x04, 0x16));
+    nec_repeat();
+    nec_repeat();
+    collect();
+    
+    bool success = event_count == 3 && received(0, EER_EVENT_IR, 0x0416);
+    success &= received(1, EER_EVENT_IR_REPEAT, 0x0416) && received(2, EER_EVENT_IR_REPEAT, 0x0416);
+    
+    idle(300000);
+    nec_repeat();
+    collect();
+    success &= event_count == 0;
+    
+    printf("IR NEC Repeat: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test RC5 frames, the toggle bit and RC5X commands
+static bool test_ir_rc5(void) {
+    rc5_frame(false, 5, 0x35);
+    rc5_frame(false, 5, 0x35);
+    collect();
+    
+    bool success = event_count == 2 && received(0, EER_EVENT_IR, 0x0535);
+    success &= received(1, EER_EVENT_IR_REPEAT, 0x0535);
+    success &= remote.protocol == EER_IR_RC5 && !remote.toggle;
+    
+    // Released and pressed again: the toggle bit flips
+    idle(200000);
+    rc5_frame(true, 5, 0x35);
+    collect();
+    success &= event_count == 1 && received(0, EER_EVENT_IR, 0x0535) && remote.toggle;
+    
+    // Another key right after
+    rc5_frame(false, 0, 0x35);
+    collect();
+    success &= event_count == 1 && received(0, EER_EVENT_IR, 0x0035);
+    
+    stretch = -15;
+    rc5_frame(true, 31, 0x7A);
+    stretch = 0;
+    collect();
+    success &= event_count == 1 && received(0, EER_EVENT_IR, 0x1F7A);
+    
+    printf("IR RC5: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test frames rejected by the checks and pulses out of tolerance
+static bool test_ir_errors(void) {
+    uint8_t errors = remote.errors;
+    
+    nec_frame(nec_code(0x04, 0x08) ^ 0x80000000UL);
+    collect();
+    
+    bool success = event_count == 0 && remote.errors == errors + 1;
+    
+    stretch = 40;
+    nec_frame(nec_code(0x04, 0x08));
+    rc5_frame(false, 5, 0x35);
+    stretch = 0;
+    collect();
+    success &= event_count == 0;
+    
+    // A frame cut short is dropped, the next one decodes
+    line(true, 9000);
+    line(false, 4500);
+    line(true, 562);
+    line(false, 3000);
+    idle(40000);
+    success &= remote.errors > errors + 1;
+    
+    nec_frame(nec_code(0x04, 0x08));
+    collect();
+    success &= event_count == 1 && received(0, EER_EVENT_IR, 0x0408);
+    
+    // Decoding stops with the timer
+    success &= eer_ir_deinit(&remote) == EER_HAL_OK;
+    nec_frame(nec_code(0x04, 0x08));
+    collect();
+    success &= event_count == 0;
+    
+    printf("IR Errors: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+int main(void) {
+    bool success = true;
+    
+    printf("Starting IR tests...\n");
+    
+    success &= test_ir_init();
+    success &= test_ir_nec();
+    success &= test_ir_nec_repeat();
+    success &= test_ir_rc5();
+    success &= test_ir_errors();
+    
+    printf("\nIR tests %s\n", success ? "PASSED" : "FAILED");
+    
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
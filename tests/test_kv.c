@@ -0,0 +1,228 @@
+/**
+ * @file test_kv.c
+ * @brief Test of the key-value store on the host NVS
+ *
+ * Power loss is modeled by editing the storage array between a write and
+ * the next eer_kv_init(), which mounts the store the way a restart would.
+ * Writes go through a counting wrapper of the host handler to check that
+ * every slot of the region takes its share of them.
+ */
+#include "eer_hal.h"
+#include "eer_kv.h"
+#include "eer_crc.h"
+#include "platforms/host/nvs.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#define BASE  64
+#define SLOTS 24
+
+static uint16_t slot_writes[SLOTS];
+static eer_nvs_handler_t counting_nvs;
+
+static eer_hal_status_t counting_write(uint32_t address, const uint8_t* data, uint16_t size, uint32_t timeout) {
+    if (address >= BASE && address < BASE + SLOTS * EER_KV_SLOT_SIZE) {
+        slot_writes[(address - BASE) / EER_KV_SLOT_SIZE]++;
+    }
+    
+    return host_nvs_write(address, data, size, timeout);
+}
+
+static void storage_erase(void) {
+    memset(host_nvs_memory(), EER_NVS_ERASED_BYTE, EER_HOST_NVS_SIZE);
+    memset(slot_writes, 0, sizeof(slot_writes));
+    
+    counting_nvs = eer_host_nvs;
+    counting_nvs.write = counting_write;
+    counting_nvs.init();
+}
+
+static uint8_t* slot_memory(uint16_t slot) {
+    return host_nvs_memory() + BASE + slot * EER_KV_SLOT_SIZE;
+}
+
+// Store a record as the driver lays it out, with any sequence number
+static void record_store(uint16_t slot, uint8_t key, uint16_t seq, const char* value) {
+    uint8_t* record = slot_memory(slot);
+    uint8_t length = (uint8_t)strlen(value);
+    
+    memset(record, EER_NVS_ERASED_BYTE, EER_KV_SLOT_SIZE);
+    record[0] = key;
+    record[1] = length;
+    record[2] = (uint8_t)seq;
+    record[3] = (uint8_t)(seq >> 8);
+    memcpy(&record[EER_KV_HEADER_SIZE], value, length);
+    
+    uint16_t crc = eer_crc16_ccitt(EER_CRC16_CCITT_INIT, record, EER_KV_SLOT_SIZE - 2);
+    record[EER_KV_SLOT_SIZE - 2] = (uint8_t)crc;
+    record[EER_KV_SLOT_SIZE - 1] = (uint8_t)(crc >> 8);
+}
+
+static bool value_is(eer_kv_t* kv, uint8_t key, const char* expected) {
+    uint8_t data[EER_KV_VALUE_MAX];
+    uint8_t length = 0;
+    
+    if (eer_kv_get(kv, key, data, sizeof(data), &length) != EER_HAL_OK) {
+        return false;
+    }
+    
+    return length == strlen(expected) && memcmp(data, expected, length) == 0;
+}
+
+static eer_hal_status_t value_set(eer_kv_t* kv, uint8_t key, const char* value) {
+    return eer_kv_set(kv, key, (const uint8_t*)value, (uint8_t)strlen(value));
+}
+
+// Test that a fresh mount finds every key, and the log continues where it stopped
+static bool test_kv_rebuild(void) {
+    eer_kv_t kv;
+    eer_kv_t mounted;
+    uint8_t length = 0;
+    
+    storage_erase();
+    
+    bool success = eer_kv_init(&kv, &counting_nvs, BASE, SLOTS * EER_KV_SLOT_SIZE) == EER_HAL_OK;
+    success &= kv.head == 0 && kv.free == SLOTS;
+    success &= eer_kv_get(&kv, 0, NULL, 0, &length) == EER_HAL_ERROR;
+    
+    success &= value_set(&kv, 0, "zero") == EER_HAL_OK;
+    success &= value_set(&kv, 3, "three") == EER_HAL_OK;
+    success &= value_set(&kv, 0, "nil") == EER_HAL_OK;
+    success &= value_set(&kv, EER_KV_MAX_KEYS - 1, "last") == EER_HAL_OK;
+    
+    // An unchanged value takes no slot
+    uint16_t head = kv.head;
+    success &= value_set(&kv, 3, "three") == EER_HAL_OK && kv.head == head;
+    
+    success &= eer_kv_init(&mounted, &counting_nvs, BASE, SLOTS * EER_KV_SLOT_SIZE) == EER_HAL_OK;
+    success &= memcmp(mounted.index, kv.index, sizeof(kv.index)) == 0;
+    success &= mounted.head == kv.head && mounted.seq == kv.seq;
+    success &= value_is(&mounted, 0, "nil") && value_is(&mounted, 3, "three");
+    success &= value_is(&mounted, EER_KV_MAX_KEYS - 1, "last");
+    success &= eer_kv_get(&mounted, 1, NULL, 0, &length) == EER_HAL_ERROR;
+    
+    printf("KV Index Rebuild: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test that a torn or corrupt last record falls back to the previous value
+static bool test_kv_power_loss(void) {
+    eer_kv_t kv;
+    
+    storage_erase();
+    eer_kv_init(&kv, &counting_nvs, BASE, SLOTS * EER_KV_SLOT_SIZE);
+    
+    bool success = value_set(&kv, 2, "old") == EER_HAL_OK;
+    success &= value_set(&kv, 2, "new") == EER_HAL_OK;
+    
+    // Power lost halfway through the record: the rest is still erased
+    uint16_t torn = kv.index[2];
+    memset(slot_memory(torn) + EER_KV_SLOT_SIZE / 2, EER_NVS_ERASED_BYTE, EER_KV_SLOT_SIZE / 2);
+    
+    success &= eer_kv_init(&kv, &counting_nvs, BASE, SLOTS * EER_KV_SLOT_SIZE) == EER_HAL_OK;
+    success &= value_is(&kv, 2, "old");
+    
+    // The torn slot is reused, and the next value survives a restart
+    success &= kv.head == torn;
+    success &= value_set(&kv, 2, "newer") == EER_HAL_OK;
+    
+    // A bit flipped in storage fails the CRC the same way
+    slot_memory(kv.index[2])[EER_KV_HEADER_SIZE] ^= 0x01;
+    success &= eer_kv_init(&kv, &counting_nvs, BASE, SLOTS * EER_KV_SLOT_SIZE) == EER_HAL_OK;
+    success &= value_is(&kv, 2, "old");
+    
+    printf("KV Torn Record: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test that sequence numbers order records across their wrap to zero
+static bool test_kv_seq_wrap(void) {
+    eer_kv_t kv;
+    
+    storage_erase();
+    record_store(0, 5, 0xFFFE, "a");
+    record_store(1, 5, 0xFFFF, "b");
+    record_store(2, 6, 0xFFFD, "c");
+    
+    bool success = eer_kv_init(&kv, &counting_nvs, BASE, SLOTS * EER_KV_SLOT_SIZE) == EER_HAL_OK;
+    success &= value_is(&kv, 5, "b") && value_is(&kv, 6, "c");
+    success &= kv.head == 2 + 1 && kv.seq == 0;
+    
+    // Records written after the wrap are newer than those before it
+    success &= value_set(&kv, 5, "d") == EER_HAL_OK;
+    success &= value_set(&kv, 6, "e") == EER_HAL_OK;
+    
+    success &= eer_kv_init(&kv, &counting_nvs, BASE, SLOTS * EER_KV_SLOT_SIZE) == EER_HAL_OK;
+    success &= value_is(&kv, 5, "d") && value_is(&kv, 6, "e");
+    success &= kv.seq == 2;
+    
+    printf("KV Sequence Wrap: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test compaction with every key live in the smallest region, updated for many laps
+static bool test_kv_compaction(void) {
+    const uint16_t slots = EER_KV_MAX_KEYS + 2;
+    eer_kv_t kv;
+    char value[8];
+    
+    storage_erase();
+    
+    bool success = eer_kv_init(&kv, &counting_nvs, BASE, slots * EER_KV_SLOT_SIZE) == EER_HAL_OK;
+    
+    for (uint8_t key = 0; key < EER_KV_MAX_KEYS; key++) {
+        snprintf(value, sizeof(value), "k%u", key);
+        success &= value_set(&kv, key, value) == EER_HAL_OK;
+    }
+    
+    // The region is full of live records: each update has to compact
+    for (uint16_t round = 0; round < 20 * slots; round++) {
+        snprintf(value, sizeof(value), "u%u", round);
+        success &= value_set(&kv, (uint8_t)(round % 3), value) == EER_HAL_OK;
+    }
+    
+    for (uint8_t key = 3; key < EER_KV_MAX_KEYS; key++) {
+        snprintf(value, sizeof(value), "k%u", key);
+        success &= value_is(&kv, key, value);
+    }
+    snprintf(value, sizeof(value), "u%u", 20 * slots - 1);
+    success &= value_is(&kv, (uint8_t)((20 * slots - 1) % 3), value);
+    
+    // Idle compaction cannot reach the reserve here, and only moves records
+    success &= eer_kv_compact(&kv, 8) == EER_HAL_OK && kv.free >= 1;
+    
+    // Copying live records forward spreads the writes over every slot
+    uint16_t fewest = UINT16_MAX;
+    uint16_t most = 0;
+    for (uint16_t slot = 0; slot < slots; slot++) {
+        fewest = slot_writes[slot] < fewest ? slot_writes[slot] : fewest;
+        most = slot_writes[slot] > most ? slot_writes[slot] : most;
+    }
+    success &= fewest > 0 && most - fewest <= 2;
+    
+    eer_kv_t mounted;
+    success &= eer_kv_init(&mounted, &counting_nvs, BASE, slots * EER_KV_SLOT_SIZE) == EER_HAL_OK;
+    success &= memcmp(mounted.index, kv.index, sizeof(kv.index)) == 0;
+    success &= mounted.head == kv.head && mounted.free == kv.free;
+    success &= value_is(&mounted, 3, "k3") && value_is(&mounted, EER_KV_MAX_KEYS - 1, "k15");
+    
+    printf("KV Compaction: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+int main(void) {
+    bool success = true;
+    
+    printf("Starting key-value store tests...\n");
+    
+    success &= test_kv_rebuild();
+    success &= test_kv_power_loss();
+    success &= test_kv_seq_wrap();
+    success &= test_kv_compaction();
+    
+    printf("\nKey-value store tests %s\n", success ? "PASSED" : "FAILED");
+    
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
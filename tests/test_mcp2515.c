@@ -0,0 +1,475 @@
+/**
+ * @file test_mcp2515.c
+ * @brief Test of the MCP2515 driver against a simulated controller
+ *
+ * The controller model decodes the SPI instructions into its register file
+ * and drives the INT pin low while an enabled interrupt flag is set. Frames
+ * are put on its side of the bus by inject(), which applies the masks,
+ * filters and rollover as the chip does, and bus_run() sends the loaded
+ * transmit buffers in priority order.
+ */
+#include "eer_hal.h"
+#include "eer_mcp2515.h"
+#include "platforms/host/host.h"
+#include "platforms/host/gpio.h"
+#include "platforms/host/spi.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#define REG_CANSTAT  0x0E
+#define REG_CANCTRL  0x0F
+#define REG_CNF3     0x28
+#define REG_CNF2     0x29
+#define REG_CNF1     0x2A
+#define REG_CANINTE  0x2B
+#define REG_CANINTF  0x2C
+#define REG_RXB0CTRL 0x60
+#define REG_RXB1CTRL 0x70
+
+typedef struct {
+    uint8_t  registers[128];
+    uint8_t  instruction;
+    uint8_t  count;
+    uint8_t  address;
+    uint8_t  mask;
+    eer_can_frame_t sent[8];
+    uint8_t  sent_count;
+    uint8_t  overflows;
+} chip_t;
+
+static chip_t chip;
+
+static eer_pin_t can_cs = eer_hal_pin(B, 2);
+static eer_pin_t can_int = eer_hal_pin(D, 2);
+
+static void chip_update_int(void) {
+    bool active = chip.registers[REG_CANINTF] & chip.registers[REG_CANINTE];
+    host_gpio_drive(&can_int, !active);
+}
+
+static void chip_reset(void) {
+    memset(chip.registers, 0, sizeof(chip.registers));
+    chip.registers[REG_CANSTAT] = 0x80;
+    chip.registers[REG_CANCTRL] = 0x87;
+}
+
+static void chip_write(uint8_t address, uint8_t data) {
+    if (address == REG_CANCTRL) {
+        chip.registers[REG_CANSTAT] = (chip.registers[REG_CANSTAT] & 0x1F) | (data & 0xE0);
+    }
+    chip.registers[address & 0x7F] = data;
+}
+
+static uint8_t chip_status(void) {
+    uint8_t flags = chip.registers[REG_CANINTF];
+    
+    return (flags & 0x03) | (flags & 0x04 ? 0x08 : 0) | (flags & 0x08 ? 0x20 : 0) | (flags & 0x10 ? 0x80 : 0);
+}
+
+static void chip_select(host_spi_device_t* device, bool selected) {
+    (void)device;
+    
+    if (selected) {
+        chip.count = 0;
+        return;
+    }
+    
+    // READ RX BUFFER clears the flag of its buffer on release
+    if (chip.count > 0 && (chip.instruction & 0xF9) == 0x90) {
+        chip.registers[REG_CANINTF] &= (uint8_t)~(chip.instruction & 0x04 ? 0x02 : 0x01);
+    }
+    chip_update_int();
+}
+
+static uint8_t chip_exchange(host_spi_device_t* device, uint8_t data) {
+    (void)device;
+    
+    uint8_t index = chip.count++;
+    
+    if (index == 0) {
+        chip.instruction = data;
+        if (data == 0xC0) {
+            chip_reset();
+        } else if ((data & 0xF9) == 0x90) {
+            chip.address = data & 0x04 ? 0x71 : 0x61;
+        } else if ((data & 0xF9) == 0x40) {
+            chip.address = 0x31 + 0x10 * ((data >> 1) & 0x03);
+        }
+        return 0xFF;
+    }
+    
+    switch (chip.instruction) {
+        case 0x03:
+            if (index == 1) {
+                chip.address = data;
+                return 0xFF;
+            }
+            return chip.registers[chip.address++ & 0x7F];
+            
+        case 0x02:
+            if (index == 1) {
+                chip.address = data;
+            } else {
+                chip_write(chip.address++, data);
+            }
+            return 0xFF;
+            
+        case 0x05:
+            if (index == 1) {
+                chip.address = data;
+            } else if (index == 2) {
+                chip.mask = data;
+            } else if (index == 3) {
+                uint8_t value = chip.registers[chip.address & 0x7F];
+                chip_write(chip.address, (value & ~chip.mask) | (data & chip.mask));
+            }
+            return 0xFF;
+            
+        case 0xA0:
+            return chip_status();
+            
+        default:
+            if ((chip.instruction & 0xF9) == 0x90) {
+                return chip.registers[chip.address++ & 0x7F];
+            }
+            if ((chip.instruction & 0xF9) == 0x40) {
+                chip.registers[chip.address++ & 0x7F] = data;
+            }
+            return 0xFF;
+    }
+}
+
+static host_spi_device_t chip_device = {
+    .select = chip_select,
+    .exchange = chip_exchange
+};
+
+/**
+ * @brief Identifier of a mask or filter register group
+ */
+static uint32_t chip_id(uint8_t address, bool extended) {
+    const uint8_t* r = &chip.registers[address];
+    
+    if (extended) {
+        return (uint32_t)r[0] << 21 | (uint32_t)(r[1] & 0xE0) << 13 | (uint32_t)(r[1] & 0x03) << 16
+            | (uint32_t)r[2] << 8 | r[3];
+    }
+    return (uint32_t)r[0] << 3 | r[1] >> 5;
+}
+
+static bool chip_accepts(uint8_t buffer, const eer_can_frame_t* frame) {
+    static const uint8_t filters[2][4] = { { 0x00, 0x04 }, { 0x08, 0x10, 0x14, 0x18 } };
+    bool extended = frame->flags & EER_CAN_EXTENDED;
+    
+    if ((chip.registers[buffer ? REG_RXB1CTRL : REG_RXB0CTRL] & 0x60) == 0x60) {
+        return true;
+    }
+    
+    uint32_t mask = chip_id(buffer ? 0x24 : 0x20, extended);
+    for (uint8_t i = 0; i < (buffer ? 4 : 2); i++) {
+        uint8_t address = filters[buffer][i];
+        bool filter_extended = chip.registers[address + 1] & 0x08;
+        
+        if (filter_extended == extended && ((chip_id(address, extended) ^ frame->id) & mask) == 0) {
+            return true;
+        }
+    }
+    
+    return false;
+}
+
+static void chip_store(uint8_t buffer, const eer_can_frame_t* frame) {
+    uint8_t* r = &chip.registers[buffer ? 0x71 : 0x61];
+    
+    if (frame->flags & EER_CAN_EXTENDED) {
+        r[0] = (uint8_t)(frame->id >> 21);
+        r[1] = (uint8_t)(((frame->id >> 13) & 0xE0) | 0x08 | ((frame->id >> 16) & 0x03));
+        r[2] = (uint8_t)(frame->id >> 8);
+        r[3] = (uint8_t)frame->id;
+        r[4] = frame->dlc | (frame->flags & EER_CAN_RTR ? 0x40 : 0);
+    } else {
+        r[0] = (uint8_t)(frame->id >> 3);
+        r[1] = (uint8_t)((frame->id & 0x07) << 5) | (frame->flags & EER_CAN_RTR ? 0x10 : 0);
+        r[2] = 0;
+        r[3] = 0;
+        r[4] = frame->dlc;
+    }
+    memcpy(&r[5], frame->data, 8);
+    
+    chip.registers[REG_CANINTF] |= buffer ? 0x02 : 0x01;
+}
+
+/**
+ * @brief Receive a frame from the bus into the controller
+ */
+static void inject(uint32_t id, uint8_t flags, uint8_t dlc, uint8_t first) {
+    eer_can_frame_t frame = { .id = id, .flags = flags, .dlc = dlc };
+    
+    for (uint8_t i = 0; i < dlc; i++) {
+        frame.data[i] = first + i;
+    }
+    
+    bool full0 = chip.registers[REG_CANINTF] & 0x01;
+    bool full1 = chip.registers[REG_CANINTF] & 0x02;
+    
+    if (chip_accepts(0, &frame)) {
+        if (!full0) {
+            chip_store(0, &frame);
+        } else if ((chip.registers[REG_RXB0CTRL] & 0x04) && !full1) {
+            chip_store(1, &frame);
+        } else {
+            chip.overflows++;
+        }
+    } else if (chip_accepts(1, &frame)) {
+        if (!full1) {
+            chip_store(1, &frame);
+        } else {
+            chip.overflows++;
+        }
+    }
+    
+    chip_update_int();
+}
+
+/**
+ * @brief Send every loaded transmit buffer, highest priority first
+ */
+static void bus_run(void) {
+    for (;;) {
+        int8_t best = -1;
+        
+        // Among equal priorities the higher buffer goes first
+        for (uint8_t n = 0; n < 3; n++) {
+            uint8_t control = chip.registers[0x30 + 0x10 * n];
+            if ((control & 0x08) && (best < 0 || (control & 0x03) >= (chip.registers[0x30 + 0x10 * best] & 0x03))) {
+                best = (int8_t)n;
+            }
+        }
+        if (best < 0) {
+            break;
+        }
+        
+        uint8_t base = 0x31 + 0x10 * best;
+        const uint8_t* r = &chip.registers[base];
+        eer_can_frame_t* frame = &chip.sent[chip.sent_count++ & 7];
+        
+        frame->flags = r[1] & 0x08 ? EER_CAN_EXTENDED : 0;
+        frame->id = chip_id(base, r[1] & 0x08);
+        frame->flags |= r[4] & 0x40 ? EER_CAN_RTR : 0;
+        frame->dlc = r[4] & 0x0F;
+        memcpy(frame->data, &r[5], 8);
+        
+        chip.registers[0x30 + 0x10 * best] &= (uint8_t)~0x08;
+        chip.registers[REG_CANINTF] |= (uint8_t)(0x04 << best);
+    }
+    
+    chip_update_int();
+}
+
+static void settle(void) {
+    for (uint8_t i = 0; i < 4; i++) {
+        host_poll();
+    }
+}
+
+static uint8_t received;
+static bool inject_in_handler;
+
+static void on_receive(eer_mcp2515_t* can, void* user_data) {
+    (void)can;
+    (void)user_data;
+    received++;
+    
+    // A frame arriving while the interrupt chain runs
+    if (inject_in_handler) {
+        inject_in_handler = false;
+        inject(0x300, 0, 1, 0x30);
+    }
+}
+
+static eer_mcp2515_t can = {
+    .device = { .cs = &can_cs },
+    .interrupt = &can_int,
+    .config = {
+        .oscillator = 8000000UL,
+        .bitrate = 300000UL,
+        .mode = EER_MCP2515_NORMAL
+    },
+    .on_receive = on_receive
+};
+
+// Test bit timing, reset and configuration
+static bool test_mcp2515_init(void) {
+    chip_device.cs = can_cs;
+    host_spi_attach(&chip_device);
+    
+    // 8 MHz does not divide into 300 kbit/s
+    bool success = eer_mcp2515_init(&can) == EER_HAL_NOT_SUPPORTED;
+    
+    can.config.bitrate = 500000UL;
+    success &= eer_mcp2515_init(&can) == EER_HAL_OK;
+    
+    // 8 quanta: sync, propagation 2, phase 1 of 3, phase 2 of 2
+    success &= chip.registers[REG_CNF1] == 0x00 && chip.registers[REG_CNF2] == 0x91;
+    success &= chip.registers[REG_CNF3] == 0x01;
+    success &= chip.registers[REG_CANINTE] == 0x1F && (chip.registers[REG_CANSTAT] & 0xE0) == 0x00;
+    success &= (chip.registers[REG_RXB0CTRL] & 0x64) == 0x64;
+    
+    host_gpio_pin_state_t* pin = host_gpio_state(&can_int);
+    success &= pin->irq_enabled && pin->trigger == EER_GPIO_TRIGGER_FALLING;
+    success &= host_gpio_state(&can_cs)->output;
+    
+    printf("MCP2515 Init: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test frames decoded from the receive buffers, and acceptance filtering
+static bool test_mcp2515_receive(void) {
+    eer_can_frame_t frame;
+    
+    inject(0x1ABCDEF, EER_CAN_EXTENDED | EER_CAN_RTR, 0, 0);
+    settle();
+    
+    bool success = eer_mcp2515_receive(&can, &frame);
+    success &= frame.id == 0x1ABCDEF && frame.flags == (EER_CAN_EXTENDED | EER_CAN_RTR) && frame.dlc == 0;
+    success &= !eer_mcp2515_receive(&can, &frame);
+    
+    static const eer_mcp2515_filter_t masks[2] = { { 0x7F0, false }, { 0x7FF, false } };
+    static const eer_mcp2515_filter_t filters[6] = {
+        { 0x120, false }, { 0x120, false }, { 0x7DF, false }, { 0x7DF, false }, { 0x7DF, false }, { 0x7DF, false }
+    };
+    success &= eer_mcp2515_set_filters(&can, true, masks, filters) == EER_HAL_OK;
+    success &= (chip.registers[REG_CANSTAT] & 0xE0) == 0x00;
+    
+    received = 0;
+    inject(0x123, 0, 3, 0x10);
+    settle();
+    inject(0x200, 0, 1, 0x20);
+    settle();
+    inject(0x123, EER_CAN_EXTENDED, 1, 0x20);
+    settle();
+    inject(0x7DF, 0, 8, 0x40);
+    settle();
+    
+    success &= received == 2;
+    success &= eer_mcp2515_receive(&can, &frame);
+    success &= frame.id == 0x123 && frame.flags == 0 && frame.dlc == 3;
+    success &= frame.data[0] == 0x10 && frame.data[2] == 0x12;
+    success &= eer_mcp2515_receive(&can, &frame);
+    success &= frame.id == 0x7DF && frame.dlc == 8 && frame.data[7] == 0x47;
+    success &= !eer_mcp2515_receive(&can, &frame);
+    
+    printf("MCP2515 Receive: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test a burst filling both buffers, and a frame arriving mid-chain
+static bool test_mcp2515_rollover(void) {
+    static const eer_mcp2515_filter_t masks[2] = { { 0 } };
+    static const eer_mcp2515_filter_t filters[6] = { { 0 } };
+    eer_can_frame_t frame;
+    
+    bool success = eer_mcp2515_set_filters(&can, false, masks, filters) == EER_HAL_OK;
+    
+    // The third frame finds both buffers full and is lost in the chip
+    chip.overflows = 0;
+    inject(0x101, 0, 1, 1);
+    inject(0x102, 0, 1, 2);
+    inject(0x103, 0, 1, 3);
+    settle();
+    
+    success &= chip.overflows == 1;
+    success &= eer_mcp2515_receive(&can, &frame) && frame.id == 0x101;
+    success &= eer_mcp2515_receive(&can, &frame) && frame.id == 0x102;
+    success &= !eer_mcp2515_receive(&can, &frame);
+    
+    received = 0;
+    inject_in_handler = true;
+    inject(0x104, 0, 1, 4);
+    settle();
+    
+    success &= received == 2 && !can.servicing;
+    success &= eer_mcp2515_receive(&can, &frame) && frame.id == 0x104;
+    success &= eer_mcp2515_receive(&can, &frame) && frame.id == 0x300 && frame.data[0] == 0x30;
+    success &= chip.registers[REG_CANINTF] == 0 && host_gpio_state(&can_int)->input;
+    
+    printf("MCP2515 Rollover: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test the three transmit buffers and their priorities
+static bool test_mcp2515_send(void) {
+    eer_can_frame_t frame = { .id = 0x10, .dlc = 2, .data = { 0xAA, 0xBB } };
+    
+    chip.sent_count = 0;
+    bool success = eer_mcp2515_send(&can, &frame, 1) == EER_HAL_OK;
+    frame.id = 0x1234567;
+    frame.flags = EER_CAN_EXTENDED;
+    success &= eer_mcp2515_send(&can, &frame, 3) == EER_HAL_OK;
+    frame.id = 0x30;
+    frame.flags = EER_CAN_RTR;
+    success &= eer_mcp2515_send(&can, &frame, 2) == EER_HAL_OK;
+    
+    // All three buffers are loaded
+    success &= eer_mcp2515_send(&can, &frame, 0) == EER_HAL_BUSY;
+    success &= eer_mcp2515_send(&can, &frame, 4) == EER_HAL_INVALID_PARAM;
+    success &= chip.sent_count == 0;
+    
+    bus_run();
+    settle();
+    
+    success &= chip.sent_count == 3;
+    success &= chip.sent[0].id == 0x1234567 && chip.sent[0].flags == EER_CAN_EXTENDED;
+    success &= chip.sent[1].id == 0x30 && chip.sent[1].flags == EER_CAN_RTR;
+    success &= chip.sent[2].id == 0x10 && chip.sent[2].dlc == 2 && chip.sent[2].data[1] == 0xBB;
+    
+    // The transmit interrupts free the buffers
+    success &= can.tx_busy == 0 && chip.registers[REG_CANINTF] == 0;
+    success &= eer_mcp2515_send(&can, &frame, 0) == EER_HAL_OK;
+    bus_run();
+    settle();
+    success &= chip.sent_count == 4 && can.tx_busy == 0;
+    
+    printf("MCP2515 Send: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test frames counted as dropped once the ring is full
+static bool test_mcp2515_overflow(void) {
+    eer_can_frame_t frame;
+    
+    // The ring keeps one slot free
+    for (uint8_t i = 0; i < EER_MCP2515_RX_QUEUE_SIZE + 1; i++) {
+        inject(0x400 + i, 0, 1, i);
+        settle();
+    }
+    
+    bool success = can.dropped == 2;
+    
+    for (uint8_t i = 0; i < EER_MCP2515_RX_QUEUE_SIZE - 1; i++) {
+        success &= eer_mcp2515_receive(&can, &frame) && frame.id == 0x400u + i;
+    }
+    success &= !eer_mcp2515_receive(&can, &frame);
+    success &= eer_mcp2515_deinit(&can) == EER_HAL_OK && (chip.registers[REG_CANSTAT] & 0xE0) == 0x80;
+    
+    printf("MCP2515 Overflow: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+int main(void) {
+    bool success = true;
+    
+    printf("Starting MCP2515 tests...\n");
+    
+    success &= test_mcp2515_init();
+    success &= test_mcp2515_receive();
+    success &= test_mcp2515_rollover();
+    success &= test_mcp2515_send();
+    success &= test_mcp2515_overflow();
+    
+    printf("\nMCP2515 tests %s\n", success ? "PASSED" : "FAILED");
+    
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,297 @@
+/**
+ * @file test_modbus.c
+ * @brief Test of the Modbus RTU slave on the host UART and timer
+ */
+#include "eer_hal.h"
+#include "eer_crc.h"
+#include "eer_modbus.h"
+#include "platforms/host/host.h"
+#include "platforms/host/uart.h"
+#include "platforms/host/timer.h"
+#include "platforms/host/gpio.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Master side of the line: requests go into to_slave, responses come out of from_slave
+static int to_slave[2];
+static int from_slave[2];
+
+static eer_uart_t line = eer_hal_uart0();
+static eer_timer_t frame_timer = eer_hal_timer0();
+static eer_pin_t driver_enable = eer_hal_pin(C, 4);
+
+static uint16_t registers[8];
+static const uint16_t inputs[4] = { 0x1111, 0x2222, 0x3333, 0x4444 };
+static uint8_t coils[2];
+
+// Last write reported by the slave
+static uint8_t written_function = 0;
+static uint16_t written_address = 0;
+static uint16_t written_count = 0;
+
+static void on_write(eer_modbus_t* modbus, uint8_t function, uint16_t address, uint16_t count, void* user_data) {
+    (void)modbus;
+    (void)user_data;
+    written_function = function;
+    written_address = address;
+    written_count = count;
+}
+
+static eer_modbus_t slave = {
+    .address = 17,
+    .uart = &line,
+    .timer = &frame_timer,
+    .de_pin = &driver_enable,
+    .coils = coils,
+    .coil_count = 16,
+    .holding_registers = registers,
+    .holding_register_count = 8,
+    .input_registers = inputs,
+    .input_register_count = 4,
+    .on_write = on_write
+};
+
+/**
+ * @brief Send a request, with its CRC appended unless it is already there,
+ *        and collect the response after the frame silence
+ * @return Length of the response, 0 for none
+ */
+static int transact(const uint8_t* request, uint16_t size, bool add_crc, uint8_t* response) {
+    uint8_t frame[EER_MODBUS_FRAME_SIZE + 2];
+    memcpy(frame, request, size);
+    
+    if (add_crc) {
+        uint16_t crc = eer_crc16_modbus(EER_CRC16_MODBUS_INIT, request, size);
+        frame[size++] = (uint8_t)crc;
+        frame[size++] = (uint8_t)(crc >> 8);
+    }
+    
+    if (write(to_slave[1], frame, size) != size) {
+        return 0;
+    }
+    
+    // Bytes arrive, then 3.5 characters of silence end the frame
+    host_poll();
+    host_advance_us(10000);
+    host_poll();
+    
+    int length = (int)read(from_slave[0], response, EER_MODBUS_FRAME_SIZE);
+    return length > 0 ? length : 0;
+}
+
+/**
+ * @brief Check a response against the expected bytes and its CRC
+ */
+static bool response_is(const uint8_t* response, int length, const uint8_t* expected, int size) {
+    return length == size + 2
+        && memcmp(response, expected, size) == 0
+        && eer_crc16_modbus(EER_CRC16_MODBUS_INIT, response, (uint16_t)length) == 0;
+}
+
+// Test reading holding registers, and the reference CRC of the specification
+static bool test_modbus_read_holding(void) {
+    static const uint8_t request[] = { 0x11, 0x03, 0x00, 0x01, 0x00, 0x02 };
+    static const uint8_t expected[] = { 0x11, 0x03, 0x04, 0x12, 0x34, 0xAB, 0xCD };
+    uint8_t response[EER_MODBUS_FRAME_SIZE];
+    
+    registers[1] = 0x1234;
+    registers[2] = 0xABCD;
+    
+    int length = transact(request, sizeof(request), true, response);
+    bool success = response_is(response, length, expected, sizeof(expected));
+    
+    // Known CRC of a read request, low byte first
+    static const uint8_t reference[] = { 0x01, 0x03, 0x00, 0x00, 0x00, 0x0A, 0xC5, 0xCD };
+    success &= eer_crc16_modbus(EER_CRC16_MODBUS_INIT, reference, sizeof(reference)) == 0;
+    
+    printf("Modbus Read Holding Registers: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test reading input registers and coils
+static bool test_modbus_read_inputs_and_coils(void) {
+    static const uint8_t read_inputs[] = { 0x11, 0x04, 0x00, 0x02, 0x00, 0x02 };
+    static const uint8_t inputs_expected[] = { 0x11, 0x04, 0x04, 0x33, 0x33, 0x44, 0x44 };
+    static const uint8_t read_coils[] = { 0x11, 0x01, 0x00, 0x02, 0x00, 0x0A };
+    static const uint8_t coils_expected[] = { 0x11, 0x01, 0x02, 0xC1, 0x00 };
+    uint8_t response[EER_MODBUS_FRAME_SIZE];
+    
+    int length = transact(read_inputs, sizeof(read_inputs), true, response);
+    bool success = response_is(response, length, inputs_expected, sizeof(inputs_expected));
+    
+    // Coils 2, 8 and 9 set: bits 0, 6 and 7 of the first byte
+    coils[0] = 0x04;
+    coils[1] = 0x03;
+    length = transact(read_coils, sizeof(read_coils), true, response);
+    success &= response_is(response, length, coils_expected, sizeof(coils_expected));
+    
+    printf("Modbus Read Inputs and Coils: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test single and multiple writes, echoed and reported
+static bool test_modbus_write(void) {
+    static const uint8_t write_register[] = { 0x11, 0x06, 0x00, 0x03, 0xBE, 0xEF };
+    static const uint8_t write_registers[] = { 0x11, 0x10, 0x00, 0x05, 0x00, 0x02, 0x04, 0x01, 0x02, 0x03, 0x04 };
+    static const uint8_t registers_expected[] = { 0x11, 0x10, 0x00, 0x05, 0x00, 0x02 };
+    static const uint8_t write_coil[] = { 0x11, 0x05, 0x00, 0x0F, 0xFF, 0x00 };
+    static const uint8_t write_coils[] = { 0x11, 0x0F, 0x00, 0x00, 0x00, 0x03, 0x01, 0x05 };
+    uint8_t response[EER_MODBUS_FRAME_SIZE];
+    
+    int length = transact(write_register, sizeof(write_register), true, response);
+    bool success = response_is(response, length, write_register, sizeof(write_register));
+    success &= registers[3] == 0xBEEF;
+    success &= written_function == 0x06 && written_address == 3 && written_count == 1;
+    
+    length = transact(write_registers, sizeof(write_registers), true, response);
+    success &= response_is(response, length, registers_expected, sizeof(registers_expected));
+    success &= registers[5] == 0x0102 && registers[6] == 0x0304;
+    success &= written_function == 0x10 && written_address == 5 && written_count == 2;
+    
+    coils[0] = 0xFF;
+    coils[1] = 0x00;
+    length = transact(write_coil, sizeof(write_coil), true, response);
+    success &= response_is(response, length, write_coil, sizeof(write_coil));
+    success &= coils[1] == 0x80;
+    
+    // Coils 0 to 2 become 1, 0, 1; the others keep their state
+    length = transact(write_coils, sizeof(write_coils), true, response);
+    success &= length == 8 && coils[0] == 0xFD;
+    
+    printf("Modbus Write: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test exception responses
+static bool test_modbus_exceptions(void) {
+    static const uint8_t unknown[] = { 0x11, 0x2B, 0x0E, 0x01, 0x00, 0x00 };
+    static const uint8_t unknown_expected[] = { 0x11, 0xAB, 0x01 };
+    static const uint8_t outside[] = { 0x11, 0x03, 0x00, 0x07, 0x00, 0x02 };
+    static const uint8_t outside_expected[] = { 0x11, 0x83, 0x02 };
+    static const uint8_t bad_coil[] = { 0x11, 0x05, 0x00, 0x00, 0x12, 0x34 };
+    static const uint8_t bad_coil_expected[] = { 0x11, 0x85, 0x03 };
+    uint8_t response[EER_MODBUS_FRAME_SIZE];
+    
+    int length = transact(unknown, sizeof(unknown), true, response);
+    bool success = response_is(response, length, unknown_expected, sizeof(unknown_expected));
+    
+    length = transact(outside, sizeof(outside), true, response);
+    success &= response_is(response, length, outside_expected, sizeof(outside_expected));
+    
+    length = transact(bad_coil, sizeof(bad_coil), true, response);
+    success &= response_is(response, length, bad_coil_expected, sizeof(bad_coil_expected));
+    
+    printf("Modbus Exceptions: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test that bad CRCs, other slaves and broadcasts get no response
+static bool test_modbus_silent(void) {
+    static const uint8_t corrupt[] = { 0x11, 0x03, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00 };
+    static const uint8_t other[] = { 0x12, 0x03, 0x00, 0x00, 0x00, 0x01 };
+    static const uint8_t broadcast[] = { 0x00, 0x06, 0x00, 0x00, 0x55, 0xAA };
+    static const uint8_t read[] = { 0x11, 0x03, 0x00, 0x00, 0x00, 0x01 };
+    static const uint8_t read_expected[] = { 0x11, 0x03, 0x02, 0x55, 0xAA };
+    uint8_t response[EER_MODBUS_FRAME_SIZE];
+    
+    uint16_t crc_errors = slave.crc_errors;
+    uint16_t frames = slave.frames;
+    
+    bool success = transact(corrupt, sizeof(corrupt), false, response) == 0;
+    success &= slave.crc_errors == crc_errors + 1;
+    
+    success &= transact(other, sizeof(other), true, response) == 0;
+    success &= slave.frames == frames;
+    
+    // Broadcast writes are executed
+    success &= transact(broadcast, sizeof(broadcast), true, response) == 0;
+    success &= registers[0] == 0x55AA && slave.frames == frames + 1;
+    
+    // The slave is back in sync for the next request
+    int length = transact(read, sizeof(read), true, response);
+    success &= response_is(response, length, read_expected, sizeof(read_expected));
+    
+    printf("Modbus Silent Frames: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test that the driver stays enabled until the last byte of the response is out
+static bool test_modbus_driver_enable(void) {
+    static const uint8_t request[] = { 0x11, 0x03, 0x00, 0x00, 0x00, 0x01, 0x86, 0x9A };
+    uint8_t response[EER_MODBUS_FRAME_SIZE];
+    
+    uint8_t byte = 0;
+    eer_async_request_t waiting = {
+        .bus = EER_ASYNC_UART,
+        .device = &line,
+        .rx_data = &byte,
+        .rx_size = 1
+    };
+    
+    bool success = write(to_slave[1], request, sizeof(request)) == sizeof(request);
+    host_poll();
+    success &= !host_gpio_state(&driver_enable)->output;
+    
+    // A request waiting for a byte holds the response in the queue
+    success &= eer_async_submit(&waiting) == EER_HAL_OK;
+    host_advance_us(10000);
+    success &= host_gpio_state(&driver_enable)->output;
+    
+    // Transmit complete before the response has queued its bytes keeps the driver on
+    eer_uart_tx_event_t early = { .uart = &line, .user_data = line.tx_user_data };
+    line.tx_handler(&early);
+    success &= host_gpio_state(&driver_enable)->output;
+    
+    success &= write(to_slave[1], &byte, 1) == 1;
+    host_poll();
+    success &= waiting.status == EER_HAL_OK;
+    success &= !host_gpio_state(&driver_enable)->output;
+    success &= read(from_slave[0], response, sizeof(response)) == 7;
+    
+    printf("Modbus Driver Enable: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+int main(void) {
+    bool success = true;
+    
+    printf("Starting Modbus tests...\n");
+    
+    if (pipe(to_slave) != 0 || pipe(from_slave) != 0) {
+        printf("Failed to create pipes\n");
+        return EXIT_FAILURE;
+    }
+    
+    // Responses are read without waiting when there is none
+    fcntl(from_slave[0], F_SETFL, O_NONBLOCK);
+    host_uart_instance_attach(&line, to_slave[0], from_slave[1]);
+    
+    eer_uart_config_t config = {
+        .baudrate = 9600,
+        .parity = EER_UART_PARITY_NONE,
+        .stop_bits = EER_UART_STOP_BITS_1,
+        .data_bits = EER_UART_DATA_BITS_8
+    };
+    
+    if (eer_modbus_init(&slave, &config) != EER_HAL_OK) {
+        printf("Failed to start the slave\n");
+        return EXIT_FAILURE;
+    }
+    
+    success &= test_modbus_read_holding();
+    success &= test_modbus_read_inputs_and_coils();
+    success &= test_modbus_write();
+    success &= test_modbus_exceptions();
+    success &= test_modbus_silent();
+    success &= test_modbus_driver_enable();
+    
+    eer_modbus_deinit(&slave);
+    
+    printf("\nModbus tests %s\n", success ? "PASSED" : "FAILED");
+    
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,463 @@
+/**
+ * @file test_nrf24.c
+ * @brief Test of the nRF24L01+ driver against a simulated radio
+ *
+ * The radio model decodes the SPI commands into its registers and FIFOs,
+ * returns STATUS as the first byte of every command, and drives IRQ low
+ * while an interrupt flag is set. air_send() plays the air side of the
+ * packets in the transmit FIFO, acknowledged or not, and air_receive()
+ * delivers a packet to a pipe of a listening radio.
+ */
+#include "eer_hal.h"
+#include "eer_nrf24.h"
+#include "platforms/host/host.h"
+#include "platforms/host/gpio.h"
+#include "platforms/host/spi.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#define REG_CONFIG      0x00
+#define REG_EN_AA       0x01
+#define REG_EN_RXADDR   0x02
+#define REG_SETUP_RETR  0x04
+#define REG_RF_CH       0x05
+#define REG_RF_SETUP    0x06
+#define REG_STATUS      0x07
+#define REG_FIFO_STATUS 0x17
+#define REG_DYNPD       0x1C
+#define REG_FEATURE     0x1D
+
+typedef struct {
+    uint8_t size;
+    uint8_t pipe;
+    bool    no_ack;
+    uint8_t data[32];
+} fifo_entry_t;
+
+typedef struct {
+    uint8_t      registers[32];
+    uint8_t      addresses[7][5];   /* RX_ADDR_P0 to P5, TX_ADDR in 6 */
+    fifo_entry_t tx[3];
+    uint8_t      tx_count;
+    fifo_entry_t rx[3];
+    uint8_t      rx_count;
+    fifo_entry_t pending;           /* Payload being written */
+    uint8_t      command;
+    uint8_t      count;
+    uint8_t      longest;           /* Most bytes in one assertion */
+    uint8_t      power_downs;
+    fifo_entry_t sent[8];
+    uint8_t      sent_count;
+} radio_model_t;
+
+static radio_model_t model;
+
+static eer_pin_t radio_cs = eer_hal_pin(B, 2);
+static eer_pin_t radio_ce = eer_hal_pin(B, 1);
+static eer_pin_t radio_irq = eer_hal_pin(D, 2);
+
+static void model_update_irq(void) {
+    host_gpio_drive(&radio_irq, !(model.registers[REG_STATUS] & 0x70));
+}
+
+static uint8_t model_status(void) {
+    uint8_t pipe = model.rx_count > 0 ? model.rx[0].pipe : 7;
+    
+    return (model.registers[REG_STATUS] & 0x70) | (uint8_t)(pipe << 1) | (model.tx_count == 3 ? 0x01 : 0);
+}
+
+static uint8_t* model_address(uint8_t reg) {
+    if (reg >= 0x0A && reg <= 0x0F) {
+        return model.addresses[reg - 0x0A];
+    }
+    if (reg == 0x10) {
+        return model.addresses[6];
+    }
+    return NULL;
+}
+
+static uint8_t model_read(uint8_t reg, uint8_t index) {
+    uint8_t* address = model_address(reg);
+    
+    if (address != NULL && (reg <= 0x0B || reg == 0x10)) {
+        return address[index % 5];
+    }
+    if (address != NULL) {
+        return address[0];
+    }
+    if (reg == REG_FIFO_STATUS) {
+        return (model.tx_count == 3 ? 0x20 : 0) | (model.tx_count == 0 ? 0x10 : 0)
+            | (model.rx_count == 3 ? 0x02 : 0) | (model.rx_count == 0 ? 0x01 : 0);
+    }
+    return model.registers[reg];
+}
+
+static void model_write(uint8_t reg, uint8_t index, uint8_t data) {
+    uint8_t* address = model_address(reg);
+    
+    if (address != NULL) {
+        if (index < 5) {
+            address[index] = data;
+        }
+        return;
+    }
+    if (reg == REG_STATUS) {
+        model.registers[REG_STATUS] &= (uint8_t)~(data & 0x70);
+        return;
+    }
+    if (reg == REG_CONFIG && (model.registers[REG_CONFIG] & 0x02) && !(data & 0x02)) {
+        model.power_downs++;
+    }
+    model.registers[reg] = data;
+}
+
+static void model_select(host_spi_device_t* device, bool selected) {
+    (void)device;
+    
+    if (selected) {
+        model.count = 0;
+        return;
+    }
+    
+    if (model.count > model.longest) {
+        model.longest = model.count;
+    }
+    
+    // Payloads are taken or stored when the command ends
+    if (model.count > 0) {
+        if (model.command == 0x61 && model.rx_count > 0) {
+            memmove(&model.rx[0], &model.rx[1], sizeof(model.rx[0]) * --model.rx_count);
+        } else if ((model.command == 0xA0 || model.command == 0xB0) && model.count > 1 && model.tx_count < 3) {
+            model.pending.no_ack = model.command == 0xB0;
+            model.pending.size = model.count - 1;
+            model.tx[model.tx_count++] = model.pending;
+        }
+    }
+    model_update_irq();
+}
+
+static uint8_t model_exchange(host_spi_device_t* device, uint8_t data) {
+    (void)device;
+    
+    uint8_t index = model.count++;
+    
+    if (index == 0) {
+        model.command = data;
+        if (data == 0xE1) {
+            model.tx_count = 0;
+        } else if (data == 0xE2) {
+            model.rx_count = 0;
+        }
+        return model_status();
+    }
+    
+    uint8_t command = model.command;
+    uint8_t offset = index - 1;
+    
+    if (command < 0x20) {
+        return model_read(command & 0x1F, offset);
+    }
+    if (command < 0x40) {
+        model_write(command & 0x1F, offset, data);
+        return 0x0E;
+    }
+    if (command == 0x60) {
+        return model.rx_count > 0 ? model.rx[0].size : 0;
+    }
+    if (command == 0x61) {
+        return model.rx_count > 0 && offset < 32 ? model.rx[0].data[offset] : 0;
+    }
+    if ((command == 0xA0 || command == 0xB0) && offset < 32) {
+        model.pending.data[offset] = data;
+    }
+    return 0x0E;
+}
+
+static host_spi_device_t model_device = {
+    .select = model_select,
+    .exchange = model_exchange
+};
+
+static bool model_transmitting(void) {
+    return (model.registers[REG_CONFIG] & 0x03) == 0x02 && host_gpio_state(&radio_ce)->output;
+}
+
+static bool model_listening(void) {
+    return (model.registers[REG_CONFIG] & 0x03) == 0x03 && host_gpio_state(&radio_ce)->output;
+}
+
+/**
+ * @brief Send the transmit FIFO; the first unacknowledged packet raises MAX_RT
+ * @param acked Packets acknowledged before the link fails, 255 for all
+ * @param ack_payload Size of a payload returned with each acknowledgement, 0 for none
+ */
+static void air_send(uint8_t acked, uint8_t ack_payload) {
+    while (model_transmitting() && model.tx_count > 0 && !(model.registers[REG_STATUS] & 0x10)) {
+        fifo_entry_t* entry = &model.tx[0];
+        
+        if (!entry->no_ack && acked == 0) {
+            model.registers[REG_STATUS] |= 0x10;
+            break;
+        }
+        if (!entry->no_ack && acked != 255) {
+            acked--;
+        }
+        
+        model.sent[model.sent_count++ & 7] = *entry;
+        memmove(&model.tx[0], &model.tx[1], sizeof(model.tx[0]) * --model.tx_count);
+        model.registers[REG_STATUS] |= 0x20;
+        
+        if (ack_payload > 0 && model.rx_count < 3) {
+            fifo_entry_t* reply = &model.rx[model.rx_count++];
+            reply->pipe = 0;
+            reply->size = ack_payload;
+            memset(reply->data, 0xA5, ack_payload);
+            model.registers[REG_STATUS] |= 0x40;
+        }
+    }
+    
+    model_update_irq();
+}
+
+static bool air_receive(uint8_t pipe, uint8_t size, uint8_t first) {
+    if (!model_listening() || !(model.registers[REG_EN_RXADDR] & (1 << pipe)) || model.rx_count == 3) {
+        return false;
+    }
+    
+    fifo_entry_t* entry = &model.rx[model.rx_count++];
+    entry->pipe = pipe;
+    entry->size = size;
+    for (uint8_t i = 0; i < size; i++) {
+        entry->data[i] = first + i;
+    }
+    
+    model.registers[REG_STATUS] |= 0x40;
+    model_update_irq();
+    return true;
+}
+
+static void settle(void) {
+    for (uint8_t i = 0; i < 4; i++) {
+        host_poll();
+    }
+}
+
+static uint8_t received;
+
+static void on_receive(eer_nrf24_t* radio, void* user_data) {
+    (void)radio;
+    (void)user_data;
+    received++;
+}
+
+static eer_nrf24_t radio = {
+    .device = { .cs = &radio_cs },
+    .ce = &radio_ce,
+    .irq = &radio_irq,
+    .config = {
+        .channel = 76,
+        .rate = EER_NRF24_250KBPS,
+        .power = EER_NRF24_M6DBM,
+        .retries = 5,
+        .retry_delay = 2,
+        .address = { 0xC1, 0xE7, 0xE7, 0xE7, 0xE7 },
+        .pipes = 0x0A,
+        .pipe1 = { 0xC2, 0xC2, 0xC2, 0xC2, 0xC2 },
+        .pipe_lsb = { 0xC3, 0xC4, 0xC5, 0xC6 }
+    },
+    .on_receive = on_receive
+};
+
+// Test the register setup and the start in standby-I
+static bool test_nrf24_init(void) {
+    model_device.cs = radio_cs;
+    host_spi_attach(&model_device);
+    
+    bool success = eer_nrf24_init(&radio) == EER_HAL_OK;
+    
+    success &= model.registers[REG_CONFIG] == 0x0E;
+    success &= model.registers[REG_RF_CH] == 76 && model.registers[REG_RF_SETUP] == 0x24;
+    success &= model.registers[REG_SETUP_RETR] == 0x25;
+    success &= model.registers[REG_EN_AA] == 0x3F && model.registers[REG_EN_RXADDR] == 0x0B;
+    success &= model.registers[REG_DYNPD] == 0x3F && model.registers[REG_FEATURE] == 0x07;
+    success &= memcmp(model.addresses[6], radio.config.address, 5) == 0;
+    success &= memcmp(model.addresses[0], radio.config.address, 5) == 0;
+    success &= memcmp(model.addresses[1], radio.config.pipe1, 5) == 0 && model.addresses[3][0] == 0xC4;
+    
+    // Each address goes out in one assertion with its command
+    success &= model.longest == 6;
+    
+    success &= !host_gpio_state(&radio_ce)->output && host_gpio_state(&radio_cs)->output;
+    success &= host_gpio_state(&radio_irq)->irq_enabled;
+    
+    printf("nRF24 Init: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test the queue feeding the transmit FIFO as packets are acknowledged
+static bool test_nrf24_send(void) {
+    uint8_t payload[32];
+    
+    for (uint8_t i = 0; i < sizeof(payload); i++) {
+        payload[i] = i;
+    }
+    
+    // Three go into the FIFO at once, four wait in the queue
+    bool success = true;
+    for (uint8_t i = 0; i < 7; i++) {
+        payload[0] = i;
+        success &= eer_nrf24_send(&radio, payload, 4 + i, i == 5 ? EER_NRF24_NO_ACK : 0) == EER_HAL_OK;
+    }
+    success &= eer_nrf24_send(&radio, payload, 33, 0) == EER_HAL_INVALID_PARAM;
+    success &= model.tx_count == 3 && host_gpio_state(&radio_ce)->output;
+    success &= !eer_nrf24_idle(&radio);
+    
+    // The queue holds seven, counting those in the FIFO
+    payload[0] = 7;
+    success &= eer_nrf24_send(&radio, payload, 4, 0) == EER_HAL_BUSY;
+    
+    air_send(255, 0);
+    settle();
+    success &= model.sent_count == 3 && model.tx_count == 3;
+    
+    // Slots are released as their packets go out
+    success &= eer_nrf24_send(&radio, payload, 4, 0) == EER_HAL_OK;
+    
+    air_send(255, 0);
+    settle();
+    success &= model.sent_count == 6 && model.tx_count == 2;
+    
+    air_send(255, 0);
+    settle();
+    
+    success &= model.sent_count == 8 && model.tx_count == 0;
+    for (uint8_t i = 0; i < 7; i++) {
+        success &= model.sent[i].data[0] == i && model.sent[i].size == 4 + i;
+    }
+    success &= model.sent[7].data[0] == 7 && model.sent[7].size == 4;
+    success &= model.sent[5].no_ack && !model.sent[4].no_ack && model.sent[5].data[8] == 8;
+    
+    // Back in standby-I
+    success &= eer_nrf24_idle(&radio) && !host_gpio_state(&radio_ce)->output;
+    success &= (model.registers[REG_STATUS] & 0x70) == 0 && radio.failures == 0;
+    
+    printf("nRF24 Send: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test a packet out of retries, and payloads returned with acknowledgements
+static bool test_nrf24_retries(void) {
+    uint8_t payload[] = { 0, 2, 3 };
+    eer_nrf24_packet_t packet;
+    
+    model.sent_count = 0;
+    bool success = true;
+    for (uint8_t i = 0; i < 4; i++) {
+        payload[0] = i;
+        success &= eer_nrf24_send(&radio, payload, sizeof(payload), 0) == EER_HAL_OK;
+    }
+    
+    // The second packet fails; the FIFO is flushed, the third is loaded
+    // again and the fourth joins it
+    air_send(1, 0);
+    settle();
+    success &= model.sent_count == 1 && radio.failures == 1;
+    success &= model.tx_count == 2 && !eer_nrf24_idle(&radio);
+    
+    received = 0;
+    air_send(255, 2);
+    settle();
+    success &= model.sent_count == 3 && eer_nrf24_idle(&radio);
+    success &= model.sent[0].data[0] == 0 && model.sent[1].data[0] == 2 && model.sent[2].data[0] == 3;
+    
+    success &= received == 2 && eer_nrf24_receive(&radio, &packet);
+    success &= packet.pipe == 0 && packet.size == 2 && packet.data[1] == 0xA5;
+    success &= eer_nrf24_receive(&radio, &packet) && packet.pipe == 0;
+    success &= !eer_nrf24_receive(&radio, &packet);
+    
+    printf("nRF24 Retries: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test receiving on several pipes, the ring limit, and sending while listening
+static bool test_nrf24_listen(void) {
+    eer_nrf24_packet_t packet;
+    
+    bool success = eer_nrf24_listen(&radio, true) == EER_HAL_OK;
+    success &= model_listening();
+    
+    // Pipe 2 is not enabled
+    received = 0;
+    success &= air_receive(1, 5, 0x10) && air_receive(3, 32, 0x20) && !air_receive(2, 1, 0);
+    settle();
+    
+    success &= received == 2 && (model.registers[REG_STATUS] & 0x70) == 0;
+    success &= eer_nrf24_receive(&radio, &packet) && packet.pipe == 1 && packet.size == 5;
+    success &= packet.data[0] == 0x10 && packet.data[4] == 0x14;
+    success &= eer_nrf24_receive(&radio, &packet) && packet.pipe == 3 && packet.size == 32;
+    success &= packet.data[31] == 0x20 + 31;
+    
+    // The ring keeps one slot free
+    for (uint8_t i = 0; i < EER_NRF24_RX_QUEUE_SIZE + 1; i++) {
+        success &= air_receive(1, 1, i);
+        settle();
+    }
+    success &= radio.dropped == 2;
+    for (uint8_t i = 0; i < EER_NRF24_RX_QUEUE_SIZE - 1; i++) {
+        success &= eer_nrf24_receive(&radio, &packet) && packet.data[0] == i;
+    }
+    
+    // A packet switches to TX mode and back
+    static const uint8_t reply[] = { 0x55 };
+    success &= eer_nrf24_send(&radio, reply, sizeof(reply), 0) == EER_HAL_OK;
+    success &= model_transmitting() && !model_listening();
+    air_send(255, 0);
+    settle();
+    success &= model_listening() && eer_nrf24_idle(&radio);
+    
+    printf("nRF24 Listen: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test the radio powered down around a sleep of the MCU
+static bool test_nrf24_power(void) {
+    static const uint8_t payload[] = { 9 };
+    
+    bool success = eer_nrf24_listen(&radio, false) == EER_HAL_OK;
+    success &= (model.registers[REG_CONFIG] & 0x01) == 0 && !host_gpio_state(&radio_ce)->output;
+    
+    // Not while a packet is in flight
+    success &= eer_nrf24_send(&radio, payload, sizeof(payload), 0) == EER_HAL_OK;
+    success &= eer_nrf24_power_down(&radio) == EER_HAL_BUSY;
+    air_send(255, 0);
+    settle();
+    
+    // Nothing can wake the host, so the sleep returns at once
+    uint8_t power_downs = model.power_downs;
+    eer_nrf24_sleep(&radio, EER_POWER_MODE_STANDBY);
+    success &= model.power_downs == power_downs + 1 && (model.registers[REG_CONFIG] & 0x02);
+    
+    success &= eer_nrf24_deinit(&radio) == EER_HAL_OK;
+    success &= (model.registers[REG_CONFIG] & 0x02) == 0 && !host_gpio_state(&radio_irq)->irq_enabled;
+    
+    printf("nRF24 Power: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+int main(void) {
+    bool success = true;
+    
+    printf("Starting nRF24 tests...\n");
+    
+    success &= test_nrf24_init();
+    success &= test_nrf24_send();
+    success &= test_nrf24_retries();
+    success &= test_nrf24_listen();
+    success &= test_nrf24_power();
+    
+    printf("\nnRF24 tests %s\n", success ? "PASSED" : "FAILED");
+    
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,436 @@
+/**
+ * @file test_onewire.c
+ * @brief Test of the 1-Wire master against simulated DS18B20 sensors
+ *
+ * A second timer ticks every microsecond and runs the sensors: each one
+ * watches the master pull the line, answers resets with a presence pulse,
+ * takes part in ROM searches and returns its scratchpad, holding the line
+ * low as a real device would.
+ */
+#include "eer_hal.h"
+#include "eer_crc.h"
+#include "eer_onewire.h"
+#include "platforms/host/host.h"
+#include "platforms/host/gpio.h"
+#include "platforms/host/timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#define SENSORS 3
+
+// Sensor states
+#define SENSOR_ROM_COMMAND 0  /* Receiving the ROM command */
+#define SENSOR_MATCH       1  /* Comparing Match ROM bits with its code */
+#define SENSOR_SEARCH      2  /* Taking part in a search */
+#define SENSOR_FUNCTION    3  /* Receiving the function command */
+#define SENSOR_SEND        4  /* Sending the scratchpad */
+#define SENSOR_IDLE        5  /* Left out until the next reset */
+
+typedef struct {
+    uint8_t  rom[8];
+    int16_t  temperature;
+    bool     present;
+    uint8_t  scratchpad[9];
+    uint8_t  state;
+    uint8_t  command;
+    uint8_t  bits;
+    uint8_t  triplet;
+    uint16_t position;
+    uint64_t low_from;
+    uint64_t low_until;
+} sensor_t;
+
+static sensor_t sensors[SENSORS];
+
+static eer_pin_t line = eer_hal_pin(C, 4);
+static eer_timer_t slot_timer = eer_hal_timer0();
+static eer_timer_t sensor_clock = eer_hal_timer0();
+
+static eer_onewire_t bus = { .pin = &line, .timer = &slot_timer };
+
+// Master side of the line as the sensors saw it
+static bool master_low = false;
+static uint64_t master_fell = 0;
+static bool line_low = false;
+static uint8_t strong_pullup_seen = 0;
+
+static bool rom_bit(const uint8_t* data, uint16_t position) {
+    return (data[position / 8] >> (position % 8)) & 1;
+}
+
+static void sensor_reset(sensor_t* sensor, uint64_t now) {
+    sensor->state = SENSOR_ROM_COMMAND;
+    sensor->command = 0;
+    sensor->bits = 0;
+    sensor->triplet = 0;
+    sensor->position = 0;
+    
+    // Presence pulse
+    sensor->low_from = now + 20;
+    sensor->low_until = now + 140;
+}
+
+/**
+ * @brief Master pulled the line low: a read slot is answered by holding it low for a 0
+ */
+static void sensor_fall(sensor_t* sensor, uint64_t now) {
+    bool bit = true;
+    
+    if (sensor->state == SENSOR_SEARCH && sensor->triplet < 2) {
+        bit = rom_bit(sensor->rom, sensor->position) ^ (sensor->triplet == 1);
+    } else if (sensor->state == SENSOR_SEND) {
+        bit = rom_bit(sensor->scratchpad, sensor->position);
+    }
+    
+    if (!bit) {
+        sensor->low_from = now;
+        sensor->low_until = now + 30;
+    }
+}
+
+/**
+ * @brief Receive a command byte bit by bit
+ * @return true once the byte is complete
+ */
+static bool sensor_receive(sensor_t* sensor, bool bit) {
+    sensor->command |= (uint8_t)(bit << sensor->bits);
+    
+    return ++sensor->bits == 8;
+}
+
+/**
+ * @brief Master released the line at the end of a slot
+ */
+static void sensor_rise(sensor_t* sensor, bool bit) {
+    switch (sensor->state) {
+        case SENSOR_ROM_COMMAND:
+            if (sensor_receive(sensor, bit)) {
+                sensor->state = sensor->command == EER_ONEWIRE_SEARCH_ROM ? SENSOR_SEARCH
+                              : sensor->command == EER_ONEWIRE_MATCH_ROM ? SENSOR_MATCH
+                              : sensor->command == EER_ONEWIRE_SKIP_ROM ? SENSOR_FUNCTION
+                              : SENSOR_IDLE;
+                sensor->command = 0;
+                sensor->bits = 0;
+            }
+            break;
+            
+        case SENSOR_MATCH:
+            if (bit != rom_bit(sensor->rom, sensor->position)) {
+                sensor->state = SENSOR_IDLE;
+            } else if (++sensor->position == 64) {
+                sensor->state = SENSOR_FUNCTION;
+            }
+            break;
+            
+        case SENSOR_SEARCH:
+            if (sensor->triplet < 2) {
+                sensor->triplet++;
+            } else if (bit != rom_bit(sensor->rom, sensor->position)) {
+                sensor->state = SENSOR_IDLE;
+            } else {
+                sensor->triplet = 0;
+                if (++sensor->position == 64) {
+                    sensor->state = SENSOR_IDLE;
+                }
+            }
+            break;
+            
+        case SENSOR_FUNCTION:
+            if (sensor_receive(sensor, bit)) {
+                if (sensor->command == EER_DS18B20_CONVERT_T) {
+                    sensor->scratchpad[0] = (uint8_t)sensor->temperature;
+                    sensor->scratchpad[1] = (uint8_t)((uint16_t)sensor->temperature >> 8);
+                    sensor->scratchpad[8] = eer_crc8_dallas(EER_CRC8_DALLAS_INIT, sensor->scratchpad, 8);
+                    sensor->state = SENSOR_IDLE;
+                } else if (sensor->command == EER_DS18B20_READ_SCRATCHPAD) {
+                    sensor->position = 0;
+                    sensor->state = SENSOR_SEND;
+                } else {
+                    sensor->state = SENSOR_IDLE;
+                }
+            }
+            break;
+            
+        case SENSOR_SEND:
+            if (++sensor->position == 72) {
+                sensor->state = SENSOR_IDLE;
+            }
+            break;
+            
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief Microsecond tick of the sensors
+ */
+static void sensor_tick(eer_timer_event_info_t* event) {
+    (void)event;
+    uint64_t now = host_time_us();
+    host_gpio_pin_state_t* state = host_gpio_state(&line);
+    bool low = state->mode == EER_GPIO_MODE_OUTPUT && !state->output;
+    
+    if (state->mode == EER_GPIO_MODE_OUTPUT && state->output && strong_pullup_seen < 255) {
+        strong_pullup_seen++;
+    }
+    
+    if (low && !master_low) {
+        master_fell = now;
+        for (uint8_t i = 0; i < SENSORS; i++) {
+            if (sensors[i].present) {
+                sensor_fall(&sensors[i], now);
+            }
+        }
+    } else if (!low && master_low) {
+        uint64_t duration = now - master_fell;
+        for (uint8_t i = 0; i < SENSORS; i++) {
+            if (!sensors[i].present) {
+                continue;
+            }
+            if (duration >= 400) {
+                sensor_reset(&sensors[i], now);
+            } else {
+                // A 1 is released within 15 µs, a 0 is held past it
+                sensor_rise(&sensors[i], duration < 15);
+            }
+        }
+    }
+    master_low = low;
+    
+    // Wired-AND of the sensors against the pull-up
+    bool pulled = false;
+    for (uint8_t i = 0; i < SENSORS; i++) {
+        pulled |= sensors[i].present && sensors[i].low_from <= now && now < sensors[i].low_until;
+    }
+    
+    if (pulled != line_low) {
+        line_low = pulled;
+        host_gpio_drive(&line, !pulled);
+    }
+}
+
+static void sensor_add(uint8_t index, uint64_t serial, int16_t temperature) {
+    sensor_t* sensor = &sensors[index];
+    
+    sensor->rom[0] = 0x28;
+    for (uint8_t i = 1; i < 7; i++) {
+        sensor->rom[i] = (uint8_t)(serial >> (8 * (i - 1)));
+    }
+    sensor->rom[7] = eer_crc8_dallas(EER_CRC8_DALLAS_INIT, sensor->rom, 7);
+    
+    static const uint8_t power_on[9] = { 0x50, 0x05, 0x4B, 0x46, 0x7F, 0xFF, 0x0C, 0x10, 0x1C };
+    memcpy(sensor->scratchpad, power_on, sizeof(power_on));
+    
+    sensor->temperature = temperature;
+    sensor->present = true;
+    sensor->state = SENSOR_IDLE;
+}
+
+/**
+ * @brief Let the bus run until a request completes
+ */
+static bool run_until_done(volatile eer_hal_status_t* status) {
+    for (uint32_t ms = 0; ms < 2000 && *status == EER_HAL_BUSY; ms++) {
+        host_advance_us(1000);
+    }
+    
+    return *status != EER_HAL_BUSY;
+}
+
+// Test that a reset without any device fails
+static bool test_onewire_no_presence(void) {
+    eer_onewire_request_t reset = { .flags = EER_ONEWIRE_RESET };
+    
+    for (uint8_t i = 0; i < SENSORS; i++) {
+        sensors[i].present = false;
+    }
+    
+    bool success = eer_onewire_submit(&bus, &reset) == EER_HAL_OK;
+    success &= run_until_done(&reset.status) && reset.status == EER_HAL_ERROR;
+    
+    for (uint8_t i = 0; i < SENSORS; i++) {
+        sensors[i].present = true;
+    }
+    
+    success &= eer_onewire_submit(&bus, &reset) == EER_HAL_OK;
+    success &= run_until_done(&reset.status) && reset.status == EER_HAL_OK;
+    
+    printf("1-Wire Presence: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+static uint8_t found[SENSORS + 1][8];
+
+// Test that a search finds every device, once each
+static bool test_onewire_search(void) {
+    eer_onewire_search_t search = { 0 };
+    uint8_t count = 0;
+    bool success = true;
+    
+    while (count <= SENSORS) {
+        success &= eer_onewire_search(&bus, &search) == EER_HAL_OK;
+        success &= run_until_done(&search.request.status) && search.request.status == EER_HAL_OK;
+        if (!success) {
+            break;
+        }
+        
+        memcpy(found[count++], search.rom, 8);
+        if (search.done) {
+            break;
+        }
+    }
+    
+    success &= count == SENSORS;
+    
+    // Every sensor was found exactly once
+    for (uint8_t i = 0; i < SENSORS && success; i++) {
+        uint8_t matches = 0;
+        for (uint8_t j = 0; j < count; j++) {
+            matches += memcmp(found[j], sensors[i].rom, 8) == 0;
+        }
+        success &= matches == 1;
+    }
+    
+    printf("1-Wire ROM Search: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+static volatile bool converted = false;
+
+static void on_converted(eer_onewire_convert_t* convert) {
+    (void)convert;
+    converted = true;
+}
+
+// Test one conversion for all sensors, collected one by one, with a missing sensor
+static bool test_onewire_convert(void) {
+    int16_t temperatures[SENSORS + 1];
+    
+    // A sensor that is not on the bus
+    memcpy(found[SENSORS], found[0], 8);
+    found[SENSORS][6] ^= 0x01;
+    
+    eer_onewire_convert_t convert = {
+        .roms = (const uint8_t (*)[8])found,
+        .count = SENSORS + 1,
+        .temperatures = temperatures,
+        .conversion_ms = 10,
+        .parasite = true,
+        .handler = on_converted
+    };
+    
+    strong_pullup_seen = 0;
+    bool success = eer_onewire_convert(&bus, &convert) == EER_HAL_OK;
+    success &= eer_onewire_convert(&bus, &convert) == EER_HAL_BUSY;
+    
+    for (uint32_t ms = 0; ms < 2000 && convert.busy; ms++) {
+        host_advance_us(1000);
+    }
+    
+    success &= converted && !convert.busy;
+    
+    // The line was held high for the conversion
+    success &= strong_pullup_seen == 255;
+    
+    for (uint8_t i = 0; i < SENSORS && success; i++) {
+        for (uint8_t j = 0; j < SENSORS; j++) {
+            if (memcmp(found[i], sensors[j].rom, 8) == 0) {
+                success &= temperatures[i] == sensors[j].temperature;
+            }
+        }
+    }
+    success &= temperatures[SENSORS] == EER_ONEWIRE_NO_TEMPERATURE;
+    
+    printf("1-Wire Conversion: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test that requests queue behind each other and pipelines stop at a failure
+static bool test_onewire_pipeline(void) {
+    static const uint8_t skip_convert[] = { EER_ONEWIRE_SKIP_ROM, EER_DS18B20_CONVERT_T };
+    static uint8_t scratchpad[9];
+    static uint8_t read_command[10];
+    
+    read_command[0] = EER_ONEWIRE_MATCH_ROM;
+    memcpy(&read_command[1], sensors[1].rom, 8);
+    read_command[9] = EER_DS18B20_READ_SCRATCHPAD;
+    
+    eer_onewire_request_t read = {
+        .flags = EER_ONEWIRE_RESET,
+        .tx_data = read_command, .tx_size = sizeof(read_command),
+        .rx_data = scratchpad, .rx_size = sizeof(scratchpad)
+    };
+    eer_onewire_request_t convert = {
+        .flags = EER_ONEWIRE_RESET,
+        .tx_data = skip_convert, .tx_size = sizeof(skip_convert),
+        .wait_ms = 1,
+        .next = &read
+    };
+    eer_onewire_request_t queued = { .flags = EER_ONEWIRE_RESET };
+    
+    sensors[1].temperature = -10 * 16;
+    
+    bool success = eer_onewire_submit(&bus, &convert) == EER_HAL_OK;
+    success &= eer_onewire_submit(&bus, &queued) == EER_HAL_OK;
+    success &= eer_onewire_submit(&bus, &convert) == EER_HAL_BUSY;
+    
+    // The read is submitted by the conversion, behind the queued reset
+    success &= run_until_done(&convert.status) && convert.status == EER_HAL_OK;
+    success &= run_until_done(&read.status) && read.status == EER_HAL_OK;
+    success &= queued.status == EER_HAL_OK;
+    success &= eer_crc8_dallas(EER_CRC8_DALLAS_INIT, scratchpad, 9) == 0;
+    success &= (int16_t)(scratchpad[1] << 8 | scratchpad[0]) == -10 * 16;
+    
+    // Without devices the reset fails and the read is cancelled
+    for (uint8_t i = 0; i < SENSORS; i++) {
+        sensors[i].present = false;
+    }
+    success &= eer_onewire_submit(&bus, &convert) == EER_HAL_OK;
+    success &= run_until_done(&convert.status);
+    success &= convert.status == EER_HAL_ERROR && read.status == EER_HAL_ERROR;
+    
+    for (uint8_t i = 0; i < SENSORS; i++) {
+        sensors[i].present = true;
+    }
+    
+    printf("1-Wire Pipeline: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+int main(void) {
+    bool success = true;
+    
+    printf("Starting 1-Wire tests...\n");
+    
+    // Serials differing in low bits, so the search branches early and late
+    sensor_add(0, 0x000000001234, 21 * 16 + 8);
+    sensor_add(1, 0x000000001235, -3 * 16);
+    sensor_add(2, 0x800000001234, 85 * 16);
+    
+    // Pull-up on the idle line
+    host_gpio_drive(&line, true);
+    
+    eer_timer_config_t clock_config = { .frequency = 1000000, .mode = EER_TIMER_MODE_CONTINUOUS, .period = 1 };
+    eer_hal_call(timer_instance, init, &sensor_clock, &clock_config);
+    eer_hal_call(timer_instance, register_callback, &sensor_clock, EER_TIMER_EVENT_OVERFLOW, 0, sensor_tick, NULL);
+    eer_hal_call(timer_instance, start, &sensor_clock);
+    
+    if (eer_onewire_init(&bus) != EER_HAL_OK) {
+        printf("Failed to start the bus\n");
+        return EXIT_FAILURE;
+    }
+    
+    success &= test_onewire_no_presence();
+    success &= test_onewire_search();
+    success &= test_onewire_convert();
+    success &= test_onewire_pipeline();
+    
+    eer_onewire_deinit(&bus);
+    
+    printf("\n1-Wire tests %s\n", success ? "PASSED" : "FAILED");
+    
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
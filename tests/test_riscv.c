@@ -0,0 +1,101 @@
+/**
+ * @file test_riscv.c
+ * @brief Test of the RISC-V platform on QEMU
+ *
+ * Runs bare-metal on the emulated machine: output goes to UART0, and the
+ * exit code reaches QEMU through the test device, see syscalls.c.
+ */
+#include "eer_hal.h"
+#include "platforms/riscv/uart.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+// Overflows seen by the timer callback
+static volatile uint8_t overflows = 0;
+
+static void count_overflow(eer_timer_event_info_t* event) {
+    (void)event;
+    overflows++;
+}
+
+// Test that the uptime follows mtime across a delay
+static bool test_riscv_uptime(void) {
+    bool success = true;
+    uint32_t before, after;
+    
+    success &= eer_hal.system->get_uptime_ms(&before) == EER_HAL_OK;
+    success &= eer_hal.system->delay_ms(20) == EER_HAL_OK;
+    success &= eer_hal.system->get_uptime_ms(&after) == EER_HAL_OK;
+    success &= after - before >= 20 && after - before < 40;
+    
+    printf("RISC-V Uptime: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test that a continuous timer wakes the hart at each period
+static bool test_riscv_timer(void) {
+    bool success = true;
+    eer_timer_config_t config = {
+        .frequency = 1000000,
+        .mode = EER_TIMER_MODE_CONTINUOUS,
+        .period = 5000
+    };
+    
+    overflows = 0;
+    success &= eer_hal.timer->init(&config) == EER_HAL_OK;
+    success &= eer_hal.timer->register_callback(EER_TIMER_EVENT_OVERFLOW, 0, count_overflow, NULL) == EER_HAL_OK;
+    success &= eer_hal.timer->start() == EER_HAL_OK;
+    
+    // Four periods; the last one may still be due
+    eer_hal.system->delay_ms(22);
+    success &= overflows >= 3 && overflows <= 5;
+    
+    success &= eer_hal.timer->stop() == EER_HAL_OK;
+    uint8_t stopped = overflows;
+    eer_hal.system->delay_ms(10);
+    success &= overflows == stopped;
+    
+    eer_hal.timer->unregister_callback(EER_TIMER_EVENT_OVERFLOW, 0);
+    eer_hal.timer->deinit();
+    
+    printf("RISC-V Timer: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test that buffered transmission drains and reports ready
+static bool test_riscv_uart(void) {
+    bool success = true;
+    const char* message = "RISC-V UART transmit\n";
+    bool ready = false;
+    
+    success &= eer_hal.uart->transmit((const uint8_t*)message, (uint16_t)strlen(message), 100) == EER_HAL_OK;
+    success &= riscv_uart_flush() == EER_HAL_OK;
+    success &= eer_hal.uart->is_tx_ready(&ready) == EER_HAL_OK && ready;
+    
+    // No controller behind these on the emulated machines
+    success &= eer_hal.spi->init(NULL) == EER_HAL_NOT_SUPPORTED;
+    success &= eer_hal.i2c->init(NULL) == EER_HAL_NOT_SUPPORTED;
+    
+    printf("RISC-V UART: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+int main(void) {
+    bool success = true;
+    eer_uart_config_t uart_config = { .baudrate = 115200 };
+    
+    eer_hal.uart->init(&uart_config);
+    eer_hal.system->init();
+    
+    printf("Starting RISC-V platform tests...\n");
+    
+    success &= test_riscv_uptime();
+    success &= test_riscv_timer();
+    success &= test_riscv_uart();
+    
+    printf("\nRISC-V platform tests %s\n", success ? "PASSED" : "FAILED");
+    
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,557 @@
+/**
+ * @file test_sd.c
+ * @brief Test of the SD card driver against a simulated SDHC card
+ *
+ * The card model sits on the host SPI bus and answers byte by byte as a
+ * card in SPI mode does: R1 one byte after a command, a start token ahead
+ * of each read block, a data response after each written block followed by
+ * a few busy bytes, and blocks streamed until CMD12 or the stop token.
+ */
+#include "eer_hal.h"
+#include "eer_sd.h"
+#include "platforms/host/host.h"
+#include "platforms/host/gpio.h"
+#include "platforms/host/spi.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#define CARD_SECTORS 64
+#define CARD_BUSY    20   /* Busy bytes after a block or a stop */
+#define CARD_IDLE    3    /* ACMD41 answered idle before the card is ready */
+
+// Card states
+#define CARD_COMMAND    0  /* Receiving commands */
+#define CARD_READ       1  /* Streaming blocks */
+#define CARD_WRITE      2  /* Waiting for a start token */
+#define CARD_WRITE_DATA 3  /* Receiving a block */
+
+typedef struct {
+    uint8_t  sectors[CARD_SECTORS][EER_SD_SECTOR_SIZE];
+    uint8_t  state;
+    bool     idle;
+    bool     app;
+    bool     multiple;
+    uint8_t  idle_left;
+    uint8_t  command[6];
+    uint8_t  command_size;
+    uint8_t  out[EER_SD_SECTOR_SIZE + 4];
+    uint16_t out_head;
+    uint16_t out_size;
+    uint8_t  busy;
+    uint32_t sector;
+    uint16_t received;
+    uint8_t  block[EER_SD_SECTOR_SIZE + 2];
+    uint16_t counts[128]; /* Commands received, by index; ACMDs at 64 + index */
+    uint16_t stops;       /* Stop tokens received */
+    eer_spi_prescaler_t clock; /* Clock of the last byte */
+    bool     fast;        /* Clocked above 400 kHz while idle */
+} card_t;
+
+static card_t card;
+
+static eer_pin_t card_cs = eer_hal_pin(B, 2);
+
+static uint8_t card_buffer[EER_SD_SECTOR_SIZE];
+
+static eer_sd_t sd = {
+    .device = { .cs = &card_cs },
+    .cache = card_buffer
+};
+
+static void card_queue(const uint8_t* data, uint16_t size) {
+    memcpy(&card.out[card.out_size], data, size);
+    card.out_size += size;
+}
+
+static void card_r1(uint8_t r1) {
+    card_queue(&r1, 1);
+}
+
+static void card_queue_block(void) {
+    static const uint8_t header[] = { 0xFF, 0xFE };
+    static const uint8_t crc[] = { 0x12, 0x34 };
+    
+    card.out_head = 0;
+    card.out_size = 0;
+    card_queue(header, sizeof(header));
+    card_queue(card.sectors[card.sector], EER_SD_SECTOR_SIZE);
+    card_queue(crc, sizeof(crc));
+}
+
+static void card_execute(void) {
+    uint8_t index = card.command[0] & 0x3F;
+    uint32_t argument = (uint32_t)card.command[1] << 24 | (uint32_t)card.command[2] << 16
+        | (uint32_t)card.command[3] << 8 | card.command[4];
+    uint8_t idle = card.idle ? 0x01 : 0x00;
+    bool app = card.app;
+    
+    card.app = false;
+    card.counts[app ? 64 + index : index]++;
+    
+    // CRC of the commands checked in SPI mode
+    if ((index == 0 && card.command[5] != 0x95) || (index == 8 && card.command[5] != 0x87)) {
+        card_r1(idle | 0x08);
+        return;
+    }
+    
+    if (app) {
+        switch (index) {
+            case 41:
+                if (card.idle_left > 0 && --card.idle_left == 0) {
+                    card.idle = false;
+                }
+                card_r1(card.idle ? 0x01 : 0x00);
+                return;
+            case 23:
+                card_r1(idle);
+                return;
+            default:
+                break;
+        }
+    }
+    
+    switch (index) {
+        case 0:
+            card.idle = true;
+            card.idle_left = CARD_IDLE;
+            card_r1(0x01);
+            break;
+            
+        case 8: {
+            uint8_t r7[] = { idle, 0x00, 0x00, (uint8_t)(argument >> 8), (uint8_t)argument };
+            card_queue(r7, sizeof(r7));
+            break;
+        }
+        
+        case 55:
+            card.app = true;
+            card_r1(idle);
+            break;
+            
+        case 58: {
+            // Powered up, high capacity
+            uint8_t r3[] = { idle, 0xC0, 0xFF, 0x80, 0x00 };
+            card_queue(r3, sizeof(r3));
+            break;
+        }
+        
+        case 16:
+            card_r1(idle);
+            break;
+            
+        case 12:
+            // Stuff byte, R1, then busy
+            card.out_head = 0;
+            card.out_size = 0;
+            card_r1(0xFF);
+            card_r1(0x00);
+            card.busy = CARD_BUSY;
+            card.state = CARD_COMMAND;
+            break;
+            
+        case 17:
+        case 18:
+        case 24:
+        case 25:
+            if (card.idle || argument >= CARD_SECTORS) {
+                card_r1(idle | 0x40);
+                break;
+            }
+            
+            card_r1(0x00);
+            card.sector = argument;
+            card.multiple = index == 18 || index == 25;
+            
+            if (index == 17 || index == 18) {
+                card.state = CARD_READ;
+            } else {
+                card.state = CARD_WRITE;
+            }
+            break;
+            
+        default:
+            card_r1(idle | 0x04);
+            break;
+    }
+}
+
+static void card_receive(uint8_t data) {
+    switch (card.state) {
+        case CARD_READ:
+            // Only CMD12 is taken while streaming
+            if (card.command_size == 0 && data != 0x4C) {
+                return;
+            }
+            break;
+            
+        case CARD_WRITE:
+            if (card.busy > 0 || data == 0xFF) {
+                return;
+            }
+            
+            if (data == 0xFD && card.multiple) {
+                card.stops++;
+                card.busy = CARD_BUSY;
+                card.state = CARD_COMMAND;
+            } else if (data == (card.multiple ? 0xFC : 0xFE)) {
+                card.received = 0;
+                card.state = CARD_WRITE_DATA;
+            }
+            return;
+            
+        case CARD_WRITE_DATA:
+            card.block[card.received++] = data;
+            if (card.received < sizeof(card.block)) {
+                return;
+            }
+            
+            // A run goes on taking blocks until the stop token
+            if (card.sector >= CARD_SECTORS) {
+                card_r1(0xED);  /* Write error */
+                card.state = card.multiple ? CARD_WRITE : CARD_COMMAND;
+                return;
+            }
+            
+            memcpy(card.sectors[card.sector++], card.block, EER_SD_SECTOR_SIZE);
+            card_r1(0xE5);
+            card.busy = CARD_BUSY;
+            card.state = card.multiple ? CARD_WRITE : CARD_COMMAND;
+            return;
+            
+        default:
+            break;
+    }
+    
+    if (card.command_size == 0 && (data & 0xC0) != 0x40) {
+        return;
+    }
+    
+    card.command[card.command_size++] = data;
+    if (card.command_size == sizeof(card.command)) {
+        card.command_size = 0;
+        card_execute();
+    }
+}
+
+static uint8_t card_exchange(host_spi_device_t* device, uint8_t data) {
+    (void)device;
+    uint8_t out = 0xFF;
+    
+    card.clock = host_spi_config()->prescaler;
+    if (card.idle && card.clock != EER_SPI_PRESCALER_128) {
+        card.fast = true;
+    }
+    
+    if (card.out_head < card.out_size) {
+        out = card.out[card.out_head++];
+    } else if (card.busy > 0) {
+        out = 0x00;
+        card.busy--;
+    } else if (card.state == CARD_READ && card.sector < CARD_SECTORS) {
+        card_queue_block();
+        card.sector++;
+        out = card.out[card.out_head++];
+        
+        if (!card.multiple) {
+            card.state = CARD_COMMAND;
+        }
+    }
+    
+    if (card.out_head == card.out_size && card.busy == 0) {
+        card.out_head = 0;
+        card.out_size = 0;
+    }
+    
+    card_receive(data);
+    return out;
+}
+
+static void card_select(host_spi_device_t* device, bool selected) {
+    (void)device;
+    (void)selected;
+    card.command_size = 0;
+}
+
+static host_spi_device_t card_device = {
+    .select = card_select,
+    .exchange = card_exchange
+};
+
+// Another device sharing the bus at its own clock, recording whether the card was selected
+static eer_pin_t other_cs = eer_hal_pin(B, 3);
+static eer_spi_device_t other_spi = { .cs = &other_cs, .prescaler = EER_SPI_PRESCALER_64 };
+static bool other_overlapped = false;
+
+static uint8_t other_exchange(host_spi_device_t* device, uint8_t data) {
+    (void)device;
+    
+    if (!host_gpio_state(&card_cs)->output || host_spi_config()->prescaler != other_spi.prescaler) {
+        other_overlapped = true;
+    }
+    
+    return data;
+}
+
+static host_spi_device_t other_device = {
+    .exchange = other_exchange
+};
+
+
+static void fill(uint8_t* data, uint16_t sectors, uint8_t seed) {
+    for (uint32_t i = 0; i < (uint32_t)sectors * EER_SD_SECTOR_SIZE; i++) {
+        data[i] = (uint8_t)(seed + i * 7 + i / EER_SD_SECTOR_SIZE);
+    }
+}
+
+static int request_completions = 0;
+
+static void on_request(eer_sd_request_t* request, void* user_data) {
+    (void)request;
+    (void)user_data;
+    request_completions++;
+}
+
+// Test the power-up sequence and card detection
+static bool test_sd_init(void) {
+    // Without a card nothing answers CMD0
+    bool success = eer_sd_init(&sd) == EER_HAL_TIMEOUT && sd.type == EER_SD_TYPE_NONE;
+    
+    card_device.cs = card_cs;
+    host_spi_attach(&card_device);
+    
+    success &= eer_sd_init(&sd) == EER_HAL_OK;
+    success &= sd.type == EER_SD_TYPE_HC;
+    success &= card.counts[0] == 1 && card.counts[8] == 1 && card.counts[58] == 1;
+    success &= card.counts[64 + 41] == CARD_IDLE;
+    
+    // High capacity cards have fixed 512-byte blocks
+    success &= card.counts[16] == 0;
+    
+    // Identified at the low clock
+    success &= !card.fast;
+    
+    // Chip select is an output, left released
+    host_gpio_pin_state_t* cs = host_gpio_state(&card_cs);
+    success &= cs->mode == EER_GPIO_MODE_OUTPUT && cs->output;
+    
+    printf("SD Init: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test single and multiple block transfers, blocking
+static bool test_sd_blocking(void) {
+    static uint8_t data[3 * EER_SD_SECTOR_SIZE];
+    static uint8_t back[3 * EER_SD_SECTOR_SIZE];
+    
+    fill(data, 3, 0x10);
+    memset(card.counts, 0, sizeof(card.counts));
+    
+    // One CMD25 announced by ACMD23 for the run
+    bool success = eer_sd_write(&sd, 10, data, 3) == EER_HAL_OK;
+    success &= card.counts[25] == 1 && card.counts[64 + 23] == 1 && card.counts[24] == 0;
+    success &= memcmp(card.sectors[10], data, sizeof(data)) == 0;
+    
+    // One CMD18 ended by CMD12
+    success &= eer_sd_read(&sd, 10, back, 3) == EER_HAL_OK;
+    success &= card.counts[18] == 1 && card.counts[12] == 1 && card.counts[17] == 0;
+    success &= memcmp(back, data, sizeof(data)) == 0;
+    
+    fill(data, 1, 0x80);
+    success &= eer_sd_write(&sd, 20, data, 1) == EER_HAL_OK;
+    success &= eer_sd_read(&sd, 20, back, 1) == EER_HAL_OK;
+    success &= card.counts[24] == 1 && card.counts[17] == 1;
+    success &= memcmp(back, data, EER_SD_SECTOR_SIZE) == 0;
+    
+    // Sectors past the end of the card are refused
+    success &= eer_sd_read(&sd, CARD_SECTORS, back, 1) == EER_HAL_ERROR;
+    success &= eer_sd_read(&sd, 11, back, 1) == EER_HAL_OK;
+    success &= memcmp(back, card.sectors[11], EER_SD_SECTOR_SIZE) == 0;
+    
+    printf("SD Blocking Transfers: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test transfers run from the SPI completion handler
+static bool test_sd_async(void) {
+    static uint8_t data[4 * EER_SD_SECTOR_SIZE];
+    static uint8_t back[4 * EER_SD_SECTOR_SIZE];
+    
+    fill(data, 4, 0x33);
+    memset(card.counts, 0, sizeof(card.counts));
+    request_completions = 0;
+    
+    eer_sd_request_t write = {
+        .sector = 30, .count = 4, .data = data, .write = true, .handler = on_request
+    };
+    eer_sd_request_t read = {
+        .sector = 30, .count = 4, .data = back, .handler = on_request
+    };
+    
+    // The host runs the requests as soon as they are submitted
+    bool success = eer_sd_submit(&sd, &write) == EER_HAL_OK;
+    success &= write.status == EER_HAL_OK && request_completions == 1;
+    success &= card.counts[25] == 1 && card.counts[64 + 23] == 1;
+    success &= memcmp(card.sectors[30], data, sizeof(data)) == 0;
+    
+    success &= eer_sd_submit(&sd, &read) == EER_HAL_OK;
+    success &= read.status == EER_HAL_OK && request_completions == 2;
+    success &= card.counts[18] == 1 && card.counts[12] == 1;
+    success &= memcmp(back, data, sizeof(data)) == 0;
+    
+    // Single sectors, and a failure the driver recovers from
+    eer_sd_request_t single = { .sector = 31, .count = 1, .data = back };
+    success &= eer_sd_submit(&sd, &single) == EER_HAL_OK && single.status == EER_HAL_OK;
+    success &= card.counts[17] == 1 && memcmp(back, &data[EER_SD_SECTOR_SIZE], EER_SD_SECTOR_SIZE) == 0;
+    
+    eer_sd_request_t outside = { .sector = CARD_SECTORS, .count = 1, .data = back };
+    success &= eer_sd_submit(&sd, &outside) == EER_HAL_OK && outside.status == EER_HAL_ERROR;
+    success &= sd.request == NULL;
+    
+    // Chip select is released after the transfer
+    success &= host_gpio_state(&card_cs)->output;
+    
+    success &= eer_sd_read(&sd, 33, back, 1) == EER_HAL_OK;
+    success &= memcmp(back, &data[3 * EER_SD_SECTOR_SIZE], EER_SD_SECTOR_SIZE) == 0;
+    
+    printf("SD Asynchronous Transfers: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test that runs of blocks failing midway are still ended, so the card takes commands again
+static bool test_sd_failed_runs(void) {
+    static uint8_t data[2 * EER_SD_SECTOR_SIZE];
+    static uint8_t back[2 * EER_SD_SECTOR_SIZE];
+    
+    fill(data, 2, 0x44);
+    memset(card.counts, 0, sizeof(card.counts));
+    card.stops = 0;
+    
+    // The second block is past the end of the card
+    bool success = eer_sd_read(&sd, CARD_SECTORS - 1, back, 2) == EER_HAL_TIMEOUT;
+    success &= card.counts[18] == 1 && card.counts[12] == 1;
+    
+    success &= eer_sd_write(&sd, CARD_SECTORS - 1, data, 2) == EER_HAL_ERROR;
+    success &= card.counts[25] == 1 && card.stops == 1;
+    success &= memcmp(card.sectors[CARD_SECTORS - 1], data, EER_SD_SECTOR_SIZE) == 0;
+    
+    eer_sd_request_t read = { .sector = CARD_SECTORS - 1, .count = 2, .data = back };
+    success &= eer_sd_submit(&sd, &read) == EER_HAL_OK && read.status == EER_HAL_TIMEOUT;
+    success &= card.counts[18] == 2 && card.counts[12] == 2;
+    
+    eer_sd_request_t write = { .sector = CARD_SECTORS - 1, .count = 2, .data = data, .write = true };
+    success &= eer_sd_submit(&sd, &write) == EER_HAL_OK && write.status == EER_HAL_ERROR;
+    success &= card.counts[25] == 2 && card.stops == 2;
+    
+    success &= eer_sd_read(&sd, 31, back, 1) == EER_HAL_OK && card.counts[17] == 1;
+    
+    printf("SD Failed Runs: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test that the card holds the bus for a transfer, and other devices wait their turn
+static bool test_sd_bus_sharing(void) {
+    static uint8_t back[2 * EER_SD_SECTOR_SIZE];
+    static const uint8_t message[4] = { 1, 2, 3, 4 };
+    
+    other_device.cs = other_cs;
+    host_spi_attach(&other_device);
+    other_overlapped = false;
+    
+    eer_async_request_t other = {
+        .bus = EER_ASYNC_SPI, .device = &other_spi, .tx_data = message, .tx_size = sizeof(message)
+    };
+    eer_sd_request_t read = { .sector = 30, .count = 2, .data = back };
+    
+    // Submitted during the transfer, the other request is held back
+    eer_hal_call(system, disable_interrupts);
+    bool success = eer_sd_submit(&sd, &read) == EER_HAL_OK;
+    success &= eer_async_submit(&other) == EER_HAL_OK && other.status == EER_HAL_BUSY;
+    success &= eer_sd_read(&sd, 30, back, 1) == EER_HAL_BUSY;
+    eer_hal_call(system, enable_interrupts);
+    host_poll();
+    
+    success &= read.status == EER_HAL_OK && other.status == EER_HAL_OK && !other_overlapped;
+    success &= memcmp(back, card.sectors[30], sizeof(back)) == 0;
+    
+    // Each device runs at its own clock
+    success &= card.clock == sd.device.prescaler;
+    success &= eer_async_submit(&other) == EER_HAL_OK && !other_overlapped;
+    success &= eer_sd_read(&sd, 30, back, 1) == EER_HAL_OK && card.clock == sd.device.prescaler;
+    
+    // Queued before, it runs before the card is selected
+    eer_hal_call(system, disable_interrupts);
+    success &= eer_async_submit(&other) == EER_HAL_OK;
+    success &= eer_sd_read(&sd, 30, back, 1) == EER_HAL_BUSY;
+    success &= eer_sd_submit(&sd, &read) == EER_HAL_OK;
+    success &= host_gpio_state(&card_cs)->output;
+    eer_hal_call(system, enable_interrupts);
+    host_poll();
+    
+    success &= read.status == EER_HAL_OK && other.status == EER_HAL_OK && !other_overlapped;
+    
+    host_spi_detach(&other_device);
+    
+    printf("SD Bus Sharing: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test the sector cache and its write-back
+static bool test_sd_cache(void) {
+    uint8_t* sector = NULL;
+    static uint8_t back[2 * EER_SD_SECTOR_SIZE];
+    
+    memset(card.sectors[5], 0x55, EER_SD_SECTOR_SIZE);
+    memset(card.sectors[6], 0x66, EER_SD_SECTOR_SIZE);
+    memset(card.counts, 0, sizeof(card.counts));
+    
+    bool success = eer_sd_cache(&sd, 5, &sector) == EER_HAL_OK && sector[0] == 0x55;
+    
+    // Hits are served from RAM
+    success &= eer_sd_cache(&sd, 5, &sector) == EER_HAL_OK && card.counts[17] == 1;
+    
+    sector[0] = 0xA5;
+    eer_sd_cache_dirty(&sd);
+    success &= card.sectors[5][0] == 0x55;
+    
+    // A read of the sector sees the modification
+    success &= eer_sd_read(&sd, 4, back, 2) == EER_HAL_OK;
+    success &= back[EER_SD_SECTOR_SIZE] == 0xA5 && card.sectors[5][0] == 0xA5;
+    
+    // Loading another sector writes back the modified one
+    sector[1] = 0x5A;
+    eer_sd_cache_dirty(&sd);
+    success &= eer_sd_cache(&sd, 6, &sector) == EER_HAL_OK && sector[0] == 0x66;
+    success &= card.sectors[5][1] == 0x5A;
+    
+    // A write over the cached sector drops it
+    memset(back, 0x77, EER_SD_SECTOR_SIZE);
+    success &= eer_sd_write(&sd, 6, back, 1) == EER_HAL_OK;
+    success &= eer_sd_cache(&sd, 6, &sector) == EER_HAL_OK && sector[0] == 0x77;
+    
+    sector[2] = 0x01;
+    eer_sd_cache_dirty(&sd);
+    success &= eer_sd_flush(&sd) == EER_HAL_OK && card.sectors[6][2] == 0x01;
+    success &= !sd.cache_dirty;
+    
+    printf("SD Sector Cache: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+int main(void) {
+    bool success = true;
+    
+    printf("Starting SD card tests...\n");
+    
+    success &= test_sd_init();
+    success &= test_sd_blocking();
+    success &= test_sd_async();
+    success &= test_sd_failed_runs();
+    success &= test_sd_bus_sharing();
+    success &= test_sd_cache();
+    
+    printf("\nSD card tests %s\n", success ? "PASSED" : "FAILED");
+    
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,317 @@
+/**
+ * @file test_tft.c
+ * @brief Test of the TFT streaming pipeline against a simulated panel
+ *
+ * The panel model decodes the bytes on the host SPI bus as an ST7735 does,
+ * telling commands from data by the level of the data/command pin, and
+ * writes the pixels of RAMWR into its own frame memory through the address
+ * window set by CASET and RASET.
+ */
+#include "eer_hal.h"
+#include "eer_tft.h"
+#include "platforms/host/host.h"
+#include "platforms/host/gpio.h"
+#include "platforms/host/spi.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#define PANEL_WIDTH  160
+#define PANEL_HEIGHT 128
+
+typedef struct {
+    uint16_t frame[PANEL_HEIGHT][PANEL_WIDTH];
+    uint8_t  command;
+    uint8_t  parameters[4];
+    uint8_t  count;
+    uint16_t x0, x1, y0, y1;
+    uint16_t x, y;
+    uint8_t  high;
+    uint8_t  colmod;
+    uint16_t commands[256];
+    uint32_t pixels;
+} panel_t;
+
+static panel_t panel;
+
+static eer_pin_t panel_cs = eer_hal_pin(B, 2);
+static eer_pin_t panel_dc = eer_hal_pin(B, 1);
+static eer_pin_t panel_reset = eer_hal_pin(B, 0);
+
+static void panel_pixel(uint16_t color) {
+    if (panel.y > panel.y1) {
+        return;
+    }
+    
+    if (panel.x < PANEL_WIDTH && panel.y < PANEL_HEIGHT) {
+        panel.frame[panel.y][panel.x] = color;
+    }
+    panel.pixels++;
+    
+    if (++panel.x > panel.x1) {
+        panel.x = panel.x0;
+        panel.y++;
+    }
+}
+
+static uint8_t panel_exchange(host_spi_device_t* device, uint8_t data) {
+    (void)device;
+    
+    if (!host_gpio_state(&panel_dc)->output) {
+        panel.command = data;
+        panel.count = 0;
+        panel.commands[data]++;
+        
+        if (data == EER_TFT_RAMWR) {
+            panel.x = panel.x0;
+            panel.y = panel.y0;
+        }
+        return 0xFF;
+    }
+    
+    switch (panel.command) {
+        case EER_TFT_CASET:
+        case EER_TFT_RASET:
+            if (panel.count < 4) {
+                panel.parameters[panel.count++] = data;
+            }
+            if (panel.count == 4) {
+                uint16_t start = (uint16_t)panel.parameters[0] << 8 | panel.parameters[1];
+                uint16_t end = (uint16_t)panel.parameters[2] << 8 | panel.parameters[3];
+                
+                if (panel.command == EER_TFT_CASET) {
+                    panel.x0 = start;
+                    panel.x1 = end;
+                } else {
+                    panel.y0 = start;
+                    panel.y1 = end;
+                }
+            }
+            break;
+            
+        case EER_TFT_RAMWR:
+            // Pixels arrive high byte first
+            if (panel.count++ & 1) {
+                panel_pixel((uint16_t)panel.high << 8 | data);
+            } else {
+                panel.high = data;
+            }
+            break;
+            
+        case EER_TFT_COLMOD:
+            panel.colmod = data;
+            break;
+            
+        default:
+            break;
+    }
+    
+    return 0xFF;
+}
+
+static host_spi_device_t panel_device = {
+    .exchange = panel_exchange
+};
+
+static eer_tft_t tft = {
+    .device = { .cs = &panel_cs },
+    .dc = &panel_dc,
+    .reset = &panel_reset,
+    .width = PANEL_WIDTH,
+    .height = PANEL_HEIGHT,
+    .madctl = 0x60
+};
+
+// Glyphs 'A' and 'B', 4 pixels wide with one of spacing, 5 rows
+static const uint8_t font_bitmaps[] = {
+    0x40, 0xA0, 0xE0, 0xA0, 0xA0,
+    0xC0, 0xA0, 0xC0, 0xA0, 0xC0
+};
+
+static const eer_tft_font_t font = {
+    .bitmaps = font_bitmaps, .width = 4, .height = 5, .first = 'A', .count = 2
+};
+
+/**
+ * @brief Check that a rectangle of the panel has one color
+ */
+static bool panel_is(uint16_t x, uint16_t y, uint16_t width, uint16_t height, uint16_t color) {
+    for (uint16_t row = y; row < y + height; row++) {
+        for (uint16_t column = x; column < x + width; column++) {
+            if (panel.frame[row][column] != color) {
+                return false;
+            }
+        }
+    }
+    
+    return true;
+}
+
+static void panel_clear(uint16_t color) {
+    for (uint16_t row = 0; row < PANEL_HEIGHT; row++) {
+        for (uint16_t column = 0; column < PANEL_WIDTH; column++) {
+            panel.frame[row][column] = color;
+        }
+    }
+    memset(panel.commands, 0, sizeof(panel.commands));
+    panel.pixels = 0;
+}
+
+// Test the power-up sequence
+static bool test_tft_init(void) {
+    panel_device.cs = panel_cs;
+    host_spi_attach(&panel_device);
+    
+    bool success = eer_tft_init(&tft) == EER_HAL_OK;
+    success &= panel.commands[EER_TFT_SWRESET] == 1 && panel.commands[EER_TFT_SLPOUT] == 1;
+    success &= panel.commands[EER_TFT_COLMOD] == 1 && panel.colmod == 0x05;
+    success &= panel.commands[EER_TFT_MADCTL] == 1 && panel.commands[EER_TFT_DISPON] == 1;
+    
+    // Out of reset, deselected, data selected
+    success &= host_gpio_state(&panel_reset)->output;
+    success &= host_gpio_state(&panel_cs)->output && host_gpio_state(&panel_dc)->output;
+    
+    printf("TFT Init: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test rectangles streamed through one window, and clipping at the edges
+static bool test_tft_fill(void) {
+    panel_clear(EER_TFT_BLACK);
+    
+    // Larger than both chunk buffers together
+    bool success = eer_tft_fill(&tft, 10, 20, 30, 40, EER_TFT_RED) == EER_HAL_OK;
+    success &= eer_tft_flush(&tft) == EER_HAL_OK;
+    
+    success &= panel_is(10, 20, 30, 40, EER_TFT_RED);
+    success &= panel_is(0, 0, 10, 128, EER_TFT_BLACK) && panel_is(40, 0, 120, 128, EER_TFT_BLACK);
+    success &= panel_is(10, 0, 30, 20, EER_TFT_BLACK) && panel_is(10, 60, 30, 68, EER_TFT_BLACK);
+    success &= panel.commands[EER_TFT_CASET] == 1 && panel.commands[EER_TFT_RAMWR] == 1;
+    success &= panel.pixels == 30 * 40;
+    
+    // Only the part on the screen is sent
+    panel.pixels = 0;
+    eer_tft_fill(&tft, 150, 120, 20, 20, EER_TFT_GREEN);
+    eer_tft_flush(&tft);
+    success &= panel.pixels == 10 * 8 && panel_is(150, 120, 10, 8, EER_TFT_GREEN);
+    
+    // Nothing at all off the screen
+    success &= eer_tft_fill(&tft, 200, 0, 10, 10, EER_TFT_GREEN) == EER_HAL_OK;
+    success &= panel.commands[EER_TFT_CASET] == 2;
+    
+    // Chunks the bus refuses are reported, and the next primitive starts clean
+    panel.pixels = 0;
+    tft.request[0].bus = tft.request[1].bus = (eer_async_bus_t)0xFF;
+    success &= eer_tft_fill(&tft, 0, 0, 10, 10, EER_TFT_RED) == EER_HAL_INVALID_PARAM;
+    success &= eer_tft_flush(&tft) == EER_HAL_OK && panel.pixels == 0;
+    tft.request[0].bus = tft.request[1].bus = EER_ASYNC_SPI;
+    success &= eer_tft_fill(&tft, 0, 0, 10, 10, EER_TFT_RED) == EER_HAL_OK;
+    success &= eer_tft_flush(&tft) == EER_HAL_OK && panel.pixels == 10 * 10;
+    
+    printf("TFT Fill: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test run-length spans across rows
+static bool test_tft_spans(void) {
+    static const eer_tft_span_t spans[] = {
+        { EER_TFT_RED, 7 }, { EER_TFT_GREEN, 3 }, { EER_TFT_BLUE, 5 }, { EER_TFT_WHITE, 100 }
+    };
+    
+    panel_clear(EER_TFT_BLACK);
+    
+    eer_tft_spans(&tft, 50, 60, 5, 3, spans, sizeof(spans) / sizeof(spans[0]));
+    eer_tft_flush(&tft);
+    
+    bool success = panel_is(50, 60, 5, 1, EER_TFT_RED) && panel_is(50, 61, 2, 1, EER_TFT_RED);
+    success &= panel_is(52, 61, 3, 1, EER_TFT_GREEN) && panel_is(50, 62, 5, 1, EER_TFT_BLUE);
+    
+    // The last span is cut at the end of the rectangle
+    success &= panel.pixels == 15 && panel_is(50, 63, 5, 1, EER_TFT_BLACK);
+    
+    // Spans of a rectangle past the right edge keep their rows
+    panel.pixels = 0;
+    eer_tft_spans(&tft, 157, 0, 5, 3, spans, sizeof(spans) / sizeof(spans[0]));
+    eer_tft_flush(&tft);
+    success &= panel.pixels == 9 && panel_is(157, 0, 3, 1, EER_TFT_RED);
+    success &= panel_is(157, 1, 2, 1, EER_TFT_RED) && panel_is(159, 1, 1, 1, EER_TFT_GREEN);
+    success &= panel_is(157, 2, 3, 1, EER_TFT_BLUE);
+    
+    printf("TFT Spans: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test glyphs expanded from their bitmaps
+static bool test_tft_text(void) {
+    panel_clear(EER_TFT_RED);
+    
+    eer_tft_text(&tft, 2, 3, "AB?", &font, EER_TFT_WHITE, EER_TFT_BLACK);
+    eer_tft_flush(&tft);
+    
+    bool success = panel.commands[EER_TFT_RAMWR] == 1 && panel.pixels == 12 * 5;
+    
+    for (uint8_t row = 0; row < 5; row++) {
+        for (uint8_t column = 0; column < 8; column++) {
+            uint8_t bits = font_bitmaps[(column / 4) * 5 + row] << (column % 4);
+            uint16_t expected = bits & 0x80 ? EER_TFT_WHITE : EER_TFT_BLACK;
+            success &= panel.frame[3 + row][2 + column] == expected;
+        }
+    }
+    
+    // No glyph for '?'
+    success &= panel_is(10, 3, 4, 5, EER_TFT_BLACK) && panel_is(14, 3, 1, 5, EER_TFT_RED);
+    
+    printf("TFT Text: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+static void draw_screen(eer_tft_t* display, void* user_data) {
+    (void)user_data;
+    eer_tft_fill(display, 0, 0, PANEL_WIDTH, PANEL_HEIGHT, EER_TFT_BLUE);
+    eer_tft_text(display, 100, 100, "AB", &font, EER_TFT_WHITE, EER_TFT_BLACK);
+}
+
+// Test that a render only sends the invalidated region
+static bool test_tft_render(void) {
+    panel_clear(EER_TFT_BLACK);
+    
+    eer_tft_invalidate(&tft, 20, 30, 8, 4);
+    eer_tft_invalidate(&tft, 40, 50, 4, 4);
+    eer_tft_render(&tft, draw_screen, NULL);
+    eer_tft_flush(&tft);
+    
+    // Bounding box from (20, 30) to (44, 54); the text is outside it
+    bool success = panel.pixels == 24 * 24 && panel.commands[EER_TFT_RAMWR] == 1;
+    success &= panel_is(20, 30, 24, 24, EER_TFT_BLUE);
+    success &= panel_is(0, 0, 160, 30, EER_TFT_BLACK) && panel_is(0, 54, 160, 74, EER_TFT_BLACK);
+    success &= panel_is(0, 30, 20, 24, EER_TFT_BLACK) && panel_is(44, 30, 116, 24, EER_TFT_BLACK);
+    
+    // Nothing is drawn without a change
+    eer_tft_render(&tft, draw_screen, NULL);
+    success &= panel.commands[EER_TFT_RAMWR] == 1;
+    
+    // Clipping ends with the render
+    eer_tft_fill(&tft, 0, 0, 2, 2, EER_TFT_GREEN);
+    eer_tft_flush(&tft);
+    success &= panel_is(0, 0, 2, 2, EER_TFT_GREEN);
+    
+    printf("TFT Render: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+int main(void) {
+    bool success = true;
+    
+    printf("Starting TFT tests...\n");
+    
+    success &= test_tft_init();
+    success &= test_tft_fill();
+    success &= test_tft_spans();
+    success &= test_tft_text();
+    success &= test_tft_render();
+    
+    printf("\nTFT tests %s\n", success ? "PASSED" : "FAILED");
+    
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
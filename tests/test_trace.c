@@ -0,0 +1,144 @@
+/**
+ * @file test_trace.c
+ * @brief Test of the driver event trace on the host platform
+ *
+ * Given a file name, the dump of the last test is also written there for
+ * the viewer test.
+ */
+#include "eer_hal.h"
+#include "eer_trace.h"
+#include "platforms/host/uart.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+static uint16_t get16(const uint8_t* data) {
+    return (uint16_t)(data[0] | data[1] << 8);
+}
+
+// Test that driver calls are recorded in order with their arguments
+static bool test_trace_drivers(void) {
+    const uint8_t message[] = "ping";
+    uint8_t rx[3];
+    eer_trace_record_t records[EER_TRACE_SIZE];
+    
+    eer_trace_clear();
+    eer_hal_call(uart, transmit, message, 4, 0);
+    host_advance_us(2500);
+    eer_hal_call(spi, transfer, NULL, rx, sizeof(rx), 0);
+    
+    uint16_t count = eer_trace_read(records);
+    
+    // The transmit complete interrupt follows the transmit call
+    bool success = count == 3
+        && records[0].event == EER_TRACE_UART_TRANSMIT && records[0].argument == 4
+        && records[1].event == EER_TRACE_UART_TX_IRQ && records[1].argument == 0
+        && records[2].event == EER_TRACE_SPI_TRANSFER && records[2].argument == 3;
+        
+    // 2.5 ms later: two ticks and 500 us, 125 steps of 4 us, on
+    success &= count == 3 && (uint16_t)(records[2].timestamp - records[0].timestamp) == (2 << 8 | 125);
+    
+    printf("Trace Driver Events: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test that the ring keeps the newest records once it wraps
+static bool test_trace_wrap(void) {
+    eer_trace_record_t records[EER_TRACE_SIZE];
+    
+    eer_trace_clear();
+    for (uint16_t i = 0; i < EER_TRACE_SIZE + 10; i++) {
+        eer_trace(EER_TRACE_USER, i);
+    }
+    
+    uint16_t count = eer_trace_read(records);
+    
+    bool success = count == EER_TRACE_SIZE;
+    for (uint16_t i = 0; i < count; i++) {
+        success &= records[i].argument == i + 10;
+    }
+    
+    printf("Trace Ring Wrap: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test that a stopped trace keeps its records
+static bool test_trace_stop(void) {
+    eer_trace_record_t records[EER_TRACE_SIZE];
+    
+    eer_trace_clear();
+    eer_trace(EER_TRACE_USER, 1);
+    eer_trace_stop();
+    eer_trace(EER_TRACE_USER, 2);
+    eer_trace_start();
+    eer_trace(EER_TRACE_USER + 1, 3);
+    
+    uint16_t count = eer_trace_read(records);
+    bool success = count == 2 && records[0].argument == 1 && records[1].argument == 3;
+    
+    printf("Trace Stop and Start: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+// Test the dump format sent over the UART
+static bool test_trace_dump(const char* path) {
+    int fds[2];
+    uint8_t dump[12 + 3 * 5 + 1];
+    
+    if (pipe(fds) != 0) {
+        printf("Trace Dump: FAIL\n");
+        return false;
+    }
+    host_uart_attach(-1, fds[1]);
+    
+    eer_trace_clear();
+    eer_trace(EER_TRACE_USER, 0x1234);
+    host_advance_us(200000);
+    eer_trace(EER_TRACE_USER, 0x5678);
+    eer_trace(EER_TRACE_NVS_WRITE, 0x0010);
+    
+    bool success = eer_trace_dump(0) == EER_HAL_OK;
+    
+    host_uart_attach(-1, -1);
+    close(fds[1]);
+    ssize_t size = read(fds[0], dump, sizeof(dump));
+    close(fds[0]);
+    
+    success &= size == 12 + 3 * 5;
+    success &= memcmp(dump, "EERT", 4) == 0 && dump[4] == 1 && dump[5] == 5;
+    success &= get16(&dump[6]) == 3 && get16(&dump[8]) == 1000 && get16(&dump[10]) == 250;
+    success &= dump[12 + 2] == EER_TRACE_USER && get16(&dump[12 + 3]) == 0x1234;
+    success &= dump[22 + 2] == EER_TRACE_NVS_WRITE && get16(&dump[22 + 3]) == 0x0010;
+    
+    // The dump itself is not recorded
+    eer_trace_record_t records[EER_TRACE_SIZE];
+    success &= eer_trace_read(records) == 3;
+    
+    if (success && path != NULL) {
+        FILE* file = fopen(path, "wb");
+        success = file != NULL && fwrite(dump, 1, (size_t)size, file) == (size_t)size;
+        if (file != NULL) {
+            fclose(file);
+        }
+    }
+    
+    printf("Trace Dump: %s\n", success ? "PASS" : "FAIL");
+    return success;
+}
+
+int main(int argc, char* argv[]) {
+    bool success = true;
+    
+    printf("Starting trace tests...\n");
+    
+    success &= test_trace_drivers();
+    success &= test_trace_wrap();
+    success &= test_trace_stop();
+    success &= test_trace_dump(argc > 1 ? argv[1] : NULL);
+    
+    printf("\nTrace tests %s\n", success ? "PASSED" : "FAILED");
+    
+    return success ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -16,7 +16,7 @@ set(CMAKE_SYSTEM_PROCESSOR avr)
 set(CMAKE_C_COMPILER ${AVR_CC})
 set(CMAKE_CXX_COMPILER ${AVR_CXX})
 set(CMAKE_ASM_COMPILER ${AVR_CC})
-set(CMAKE_NM ${AVR_NN})
+set(CMAKE_NM ${AVR_NM})
 
  # Prevent host system flags from being added
 # Empty out all macOS-specific settings
@@ -81,6 +81,19 @@ add_definitions(
     -DF_CPU=${F_CPU}
     -DBAUD=${BAUD}
 )
+# Start of the boot section selected by the BOOTSZ fuses (bits 2:1 of
+# H_FUSE), from the flash and smallest boot section sizes in the MCU
+# descriptor. The flash storage handler links its self-programming routine
+# there, see EER_AVR_NVS_FLASH in CMakeLists.txt.
+file(STRINGS ${CMAKE_CURRENT_LIST_DIR}/../include/platforms/avr/mcu/${MCU}.h AVR_BOOT_DEFINES
+     REGEX "^#define EER_AVR_(FLASH_SIZE|BOOT_SIZE_MIN) ")
+string(REGEX REPLACE ".*EER_AVR_FLASH_SIZE +([0-9]+).*" "\\1" AVR_FLASH_SIZE "${AVR_BOOT_DEFINES}")
+string(REGEX REPLACE ".*EER_AVR_BOOT_SIZE_MIN +([0-9]+).*" "\\1" AVR_BOOT_SIZE_MIN "${AVR_BOOT_DEFINES}")
+math(EXPR BOOT_SPM_ADDRESS "${AVR_FLASH_SIZE} - (${AVR_BOOT_SIZE_MIN} << (3 - ((${H_FUSE} >> 1) & 3)))")
+
+# BOOTRST (bit 0 of H_FUSE) programmed: reset starts in the boot section
+math(EXPR AVR_BOOT_RESET "~${H_FUSE} & 1")
+
 # mmcu MUST be passed to both the compiler and linker
 set(CMAKE_EXE_LINKER_FLAGS "-mmcu=${MCU}")
 
@@ -0,0 +1,29 @@
+# Host platform: the HAL runs as a normal process with simulated
+# peripherals, built by the system compiler selected by project()
+##########################################################################
+set(HOST 1)
+
+# Builds compiler options
+if(CMAKE_BUILD_TYPE MATCHES Release)
+   set(CMAKE_C_FLAGS_RELEASE "-O2")
+endif(CMAKE_BUILD_TYPE MATCHES Release)
+
+if(CMAKE_BUILD_TYPE MATCHES Debug)
+   set(CMAKE_C_FLAGS_DEBUG "-O0 -g")
+endif(CMAKE_BUILD_TYPE MATCHES Debug)
+
+# Microcontroller build settings the platform code expects
+set(F_CPU 16000000UL CACHE STRING "Simulated CPU frequency")
+set(BAUD 9600 CACHE STRING "Baudrate for UART")
+
+# Pass defines to compiler
+add_definitions(
+    -DF_CPU=${F_CPU}
+    -DBAUD=${BAUD}
+)
+
+add_compile_options(
+    -std=gnu99 # C99 standard
+    -Wall
+    -Wextra
+)
@@ -35,7 +35,10 @@ elseif(CMAKE_BUILD_TYPE MATCHES Debug)
     set(CMAKE_C_FLAGS_DEBUG "-O0 -save-temps -g -gdwarf-3 -gstrict-dwarf")
 endif()
 
-#set(MCU ch573 CACHE STRING "RISCV family MCU")
+# Chips: ch573, ch32v003; machines emulated by QEMU: virt, sifive_e
+set(MCU virt CACHE STRING "RISCV family MCU or QEMU machine")
+# Baudrate of the UART, ignored by QEMU
+set(BAUD 9600 CACHE STRING "Baudrate for UART")
 
 # The programmer to use, read avrdude manual for list
 set(PROG_TYPE openocd CACHE STRING "RISCV programmer")
@@ -43,7 +46,37 @@ set(HAL ${MCU})
 
 set(CMAKE_EXE_LINKER_FLAGS "-nostartfiles -Xlinker --gc-sections -Xlinker --print-memory-usage")
 
-if(MCU MATCHES "ch573")
+if(MCU STREQUAL "virt" OR MCU STREQUAL "sifive_e")
+    # EER_PLATFORM riscv: start.S, trap.c and syscalls.c replace the vendor
+    # startup, the linker script places the image for QEMU -kernel
+    string(TOUPPER ${MCU} machine)
+    set(RISCV_QEMU_MACHINE ON)
+    add_compile_options(
+        -std=gnu99
+        -march=rv32imac
+        -mabi=ilp32
+        -mcmodel=medany
+        )
+
+    add_definitions(
+        -DEER_RISCV_MACHINE=${MCU}
+        -DEER_RISCV_MACHINE_${machine}
+        -DBAUD=${BAUD}
+        )
+
+    add_link_options(
+        -march=rv32imac
+        -mabi=ilp32
+        -mcmodel=medany
+        -T${CMAKE_CURRENT_LIST_DIR}/riscv/${MCU}.ld
+        --specs=nano.specs
+        )
+
+    enable_language(ASM)
+
+    # Runs the tests on the emulated machine when installed
+    find_program(QEMU_RISCV32 qemu-system-riscv32)
+elseif(MCU MATCHES "ch573")
     add_compile_options(
         -std=gnu99
         -march=rv32imac
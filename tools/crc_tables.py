@@ -0,0 +1,61 @@
+#!/usr/bin/env python3
+"""Print the lookup tables of src/crc.c.
+
+Each table entry is the bitwise CRC update of its index, over 4 bits for
+the nibble tables (16 entries) and over 8 bits for the byte tables (256
+entries). Paste the output over the tables in src/crc.c after changing an
+algorithm there.
+
+    tools/crc_tables.py > tables.c
+"""
+
+# name, width, polynomial (reversed for reflected algorithms), reflected
+ALGORITHMS = [
+    ("crc8_dallas", 8, 0x8C, True),
+    ("crc8_smbus", 8, 0x07, False),
+    ("crc16_ccitt", 16, 0x1021, False),
+    ("crc16_modbus", 16, 0xA001, True),
+    ("crc32", 32, 0xEDB88320, True),
+]
+
+TYPES = {8: "uint8_t", 16: "uint16_t", 32: "uint32_t"}
+
+
+def entry(index, bits, width, poly, reflected):
+    mask = (1 << width) - 1
+    if reflected:
+        crc = index
+        for _ in range(bits):
+            crc = (crc >> 1) ^ poly if crc & 1 else crc >> 1
+    else:
+        crc = index << (width - bits)
+        for _ in range(bits):
+            top = crc & (1 << (width - 1))
+            crc = ((crc << 1) ^ poly) & mask if top else (crc << 1) & mask
+    return crc
+
+
+def table(name, width, poly, reflected, bits):
+    digits = width // 4
+    per_line = 8
+    values = ["0x%0*X" % (digits, entry(i, bits, width, poly, reflected))
+              for i in range(1 << bits)]
+    suffix = "nibble" if bits == 4 else "table"
+    lines = ["static const %s %s_%s[%d] CRC_TABLE = {" % (TYPES[width], name, suffix, 1 << bits)]
+    for start in range(0, len(values), per_line):
+        chunk = values[start:start + per_line]
+        last = start + per_line >= len(values)
+        lines.append("    " + ", ".join(chunk) + ("" if last else ","))
+    lines.append("};")
+    return "\n".join(lines)
+
+
+def main():
+    for name, width, poly, reflected in ALGORITHMS:
+        for bits in (4, 8):
+            print(table(name, width, poly, reflected, bits))
+            print()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,146 @@
+#!/usr/bin/env python3
+"""Convert an EER HAL trace dump into a timeline.
+
+Reads the binary output of eer_trace_dump() from a file, a serial device
+or stdin, skipping any text the firmware printed before it, and prints one
+line per event. With --chrome it writes the Trace Event format instead, to
+open in chrome://tracing or ui.perfetto.dev with one row per peripheral.
+
+    stty -F /dev/ttyUSB0 9600 raw
+    tools/eer_trace.py /dev/ttyUSB0
+    tools/eer_trace.py dump.bin --chrome trace.json
+
+Event names are read from include/eer_trace.h, so events added there show
+up without changes here.
+"""
+import argparse
+import json
+import os
+import re
+import struct
+import sys
+
+MAGIC = b"EERT"
+HEADER = struct.Struct("<4sBBHHH")
+RECORD = struct.Struct("<HBH")
+USER = 0x80
+
+DEFAULT_HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)),
+                              "..", "include", "eer_trace.h")
+
+
+def load_events(path):
+    """Map event IDs to names from the eer_trace_event_t enum."""
+    events = {}
+    with open(path) as header:
+        for name, value in re.findall(r"EER_TRACE_(\w+)\s*=\s*(0x[0-9A-Fa-f]+|\d+)", header.read()):
+            events[int(value, 0)] = name
+    return events
+
+
+def read_dump(stream):
+    """Read one dump, returning the header fields and the raw records."""
+    data = b""
+    while MAGIC not in data:
+        chunk = stream.read(1)
+        if not chunk:
+            raise ValueError("no trace dump found")
+        # Keep only what may be the start of the magic
+        data = (data + chunk)[-len(MAGIC):]
+
+    rest = stream.read(HEADER.size - len(MAGIC))
+    _, version, record_size, count, tick_us, sub_per_tick = HEADER.unpack(MAGIC + rest)
+    if version != 1 or record_size != RECORD.size:
+        raise ValueError("unsupported dump version %d, record size %d" % (version, record_size))
+
+    records = b""
+    while len(records) < count * RECORD.size:
+        chunk = stream.read(count * RECORD.size - len(records))
+        if not chunk:
+            raise ValueError("dump truncated after %d of %d records" % (len(records) // RECORD.size, count))
+        records += chunk
+
+    return tick_us, sub_per_tick, [RECORD.unpack_from(records, i * RECORD.size) for i in range(count)]
+
+
+def timeline(tick_us, sub_per_tick, records):
+    """Unwrap the timestamps into microseconds since the first record."""
+    events = []
+    tick = None
+    for timestamp, event, argument in records:
+        high = timestamp >> 8
+        if tick is None:
+            tick = high
+        else:
+            # Ticks count modulo 256, records are less than 256 ticks apart
+            tick += (high - tick) % 256
+        time = tick * tick_us + (timestamp & 0xFF) * tick_us / sub_per_tick
+        events.append((time, event, argument))
+
+    start = events[0][0] if events else 0
+    return [(time - start, event, argument) for time, event, argument in events]
+
+
+def event_name(events, event):
+    if event in events:
+        return events[event]
+    if event >= USER:
+        return "USER+%d" % (event - USER)
+    return "0x%02X" % event
+
+
+def print_text(events, timeline_events, output):
+    previous = None
+    output.write("%12s %10s  %-16s %s\n" % ("time (ms)", "delta (us)", "event", "argument"))
+    for time, event, argument in timeline_events:
+        delta = "-" if previous is None else "%.0f" % (time - previous)
+        output.write("%12.3f %10s  %-16s 0x%04X (%d)\n"
+                     % (time / 1000, delta, event_name(events, event), argument, argument))
+        previous = time
+
+
+def chrome_trace(events, timeline_events):
+    trace = []
+    rows = {}
+    for time, event, argument in timeline_events:
+        name = event_name(events, event)
+        # One row per peripheral: UART_RX_IRQ goes to the UART row
+        row = name.split("_")[0] if event < USER else "USER"
+        if row not in rows:
+            rows[row] = len(rows)
+            trace.append({"name": "thread_name", "ph": "M", "pid": 0, "tid": rows[row],
+                          "args": {"name": row}})
+        trace.append({"name": name, "ph": "i", "s": "t", "ts": time, "pid": 0,
+                      "tid": rows[row], "args": {"argument": argument}})
+    return {"traceEvents": trace, "displayTimeUnit": "ms"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("input", help="dump file or serial device, - for stdin")
+    parser.add_argument("--chrome", metavar="FILE", help="write a Trace Event JSON file")
+    parser.add_argument("--header", default=DEFAULT_HEADER, help="eer_trace.h with the event IDs")
+    arguments = parser.parse_args()
+
+    events = load_events(arguments.header)
+
+    if arguments.input == "-":
+        tick_us, sub_per_tick, records = read_dump(sys.stdin.buffer)
+    else:
+        with open(arguments.input, "rb", buffering=0) as stream:
+            tick_us, sub_per_tick, records = read_dump(stream)
+
+    timeline_events = timeline(tick_us, sub_per_tick, records)
+
+    if arguments.chrome:
+        with open(arguments.chrome, "w") as output:
+            json.dump(chrome_trace(events, timeline_events), output, indent=1)
+    else:
+        print_text(events, timeline_events, sys.stdout)
+
+
+if __name__ == "__main__":
+    try:
+        main()
+    except ValueError as error:
+        sys.exit("eer_trace: %s" % error)